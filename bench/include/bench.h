@@ -0,0 +1,77 @@
+/**
+ * @file bench.h
+ * @brief Benchmark runner for core flecs operations.
+ */
+
+#ifndef FLECS_BENCH_H
+#define FLECS_BENCH_H
+
+#include <flecs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* State passed to a benchmark function. A benchmark runs its setup, calls
+ * bench_start, performs b->count operations, calls bench_stop and then runs
+ * its teardown. The runner increases the count until a run takes at least the
+ * configured minimum time. */
+typedef struct bench_t {
+    int32_t count;             /* Number of operations to perform */
+    int32_t param;             /* Benchmark parameter (archetypes, threads) */
+    uint64_t start;            /* Start of the measured section */
+    uint64_t elapsed;          /* Duration of the measured section (ns) */
+} bench_t;
+
+typedef void (*bench_action_t)(
+    bench_t *b);
+
+/* Benchmark descriptor. The name of a parameterized benchmark is the group
+ * name followed by the parameter, e.g. "query_each/archetypes:10". */
+typedef struct bench_desc_t {
+    const char *group;         /* Name of the benchmark group */
+    const char *name;          /* Name of the benchmark */
+    const char *param_name;    /* Name of parameter (optional) */
+    int32_t param;             /* Parameter value */
+    int32_t max_count;         /* Max operations per run (0 = no limit) */
+    bench_action_t action;     /* Benchmark function */
+} bench_desc_t;
+
+/* Start measuring */
+void bench_start(
+    bench_t *b);
+
+/* Stop measuring */
+void bench_stop(
+    bench_t *b);
+
+/* Prevent the compiler from optimizing away a computed value */
+void bench_use(
+    const void *ptr);
+
+/* Benchmark groups. Each group returns a NULL terminated list of
+ * benchmarks. */
+const bench_desc_t* bench_entity(void);
+const bench_desc_t* bench_query(void);
+const bench_desc_t* bench_observer(void);
+const bench_desc_t* bench_name(void);
+const bench_desc_t* bench_map(void);
+const bench_desc_t* bench_worker(void);
+
+/* Components shared by benchmarks */
+typedef struct {
+    float x, y;
+} Position, Velocity;
+
+/* Register the benchmark components with a world */
+void bench_components(
+    ecs_world_t *world);
+
+extern ECS_COMPONENT_DECLARE(Position);
+extern ECS_COMPONENT_DECLARE(Velocity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ * @file entity.c
+ * @brief Entity and component operation benchmarks.
+ */
+
+#include <bench.h>
+
+/* Number of entities that get/set benchmarks cycle through */
+#define BENCH_ENTITY_COUNT (1024)
+
+static
+void bench_new(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        bench_use((void*)(uintptr_t)ecs_new_id(world));
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+void bench_new_w_component(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        bench_use((void*)(uintptr_t)ecs_new(world, Position));
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+void bench_new_bulk(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    bench_start(b);
+    bench_use(ecs_bulk_new(world, Position, b->count));
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+void bench_delete(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    ecs_entity_t *entities = ecs_os_memdup_n(
+        ecs_bulk_new(world, Position, b->count), ecs_entity_t, b->count);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_delete(world, entities[i]);
+    }
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+/* Add and remove a tag. The parameter is the number of tags the entity cycles
+ * through, which is the number of archetypes the entity moves between. */
+static
+void bench_add_remove_tag(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    int32_t i, tag_count = b->param;
+    ecs_entity_t *tags = ecs_os_malloc_n(ecs_entity_t, tag_count);
+    for (i = 0; i < tag_count; i ++) {
+        tags[i] = ecs_new_id(world);
+    }
+
+    ecs_entity_t e = ecs_new(world, Position);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_entity_t tag = tags[i % tag_count];
+        ecs_add_id(world, e, tag);
+        ecs_remove_id(world, e, tag);
+    }
+    bench_stop(b);
+
+    ecs_os_free(tags);
+    ecs_fini(world);
+}
+
+/* Add and remove a tag for all entities in a table with ecs_add_id_n and
+ * ecs_remove_id_n. The parameter is the number of entities, an operation is
+ * adding and removing the tag for one entity. */
+static
+void bench_add_remove_tag_n(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    ecs_entity_t tag = ecs_new_id(world);
+    int32_t i, count = b->param;
+    ecs_entity_t *entities = ecs_os_malloc_n(ecs_entity_t, count);
+    ecs_os_memcpy_n(entities, ecs_bulk_new(world, Position, count), 
+        ecs_entity_t, count);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i += count) {
+        ecs_add_id_n(world, entities, count, tag);
+        ecs_remove_id_n(world, entities, count, tag);
+    }
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+static
+void bench_add_remove_component(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_add(world, e, Velocity);
+        ecs_remove(world, e, Velocity);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+ecs_entity_t* bench_entities(
+    ecs_world_t *world)
+{
+    return ecs_os_memdup_n(ecs_bulk_new(world, Position, BENCH_ENTITY_COUNT),
+        ecs_entity_t, BENCH_ENTITY_COUNT);
+}
+
+static
+void bench_get(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    ecs_entity_t *entities = bench_entities(world);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        bench_use(ecs_get(world, entities[i % BENCH_ENTITY_COUNT], Position));
+    }
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+/* Get a pair component. The entities have (Position, target) pairs with
+ * targets from a set of b->param entities, which stresses the pair index. */
+static
+void bench_get_pair(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    ecs_entity_t *entities = ecs_os_malloc_n(ecs_entity_t, BENCH_ENTITY_COUNT);
+    ecs_entity_t *targets = ecs_os_malloc_n(ecs_entity_t, BENCH_ENTITY_COUNT);
+    int32_t i;
+
+    for (i = 0; i < BENCH_ENTITY_COUNT; i ++) {
+        if (i < b->param) {
+            targets[i] = ecs_new_id(world);
+        } else {
+            targets[i] = targets[i % b->param];
+        }
+
+        entities[i] = ecs_new_id(world);
+        ecs_set_pair(world, entities[i], Position, targets[i], {0, 0});
+    }
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        int32_t index = i % BENCH_ENTITY_COUNT;
+        bench_use(ecs_get_pair(world, entities[index], Position, 
+            targets[index]));
+    }
+    bench_stop(b);
+
+    ecs_os_free(targets);
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+static
+void bench_get_mut(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    ecs_entity_t *entities = bench_entities(world);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        bench_use(ecs_get_mut(world, entities[i % BENCH_ENTITY_COUNT],
+            Position));
+    }
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+static
+void bench_set(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    ecs_entity_t *entities = bench_entities(world);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_set(world, entities[i % BENCH_ENTITY_COUNT], Position,
+            {(float)i, (float)i});
+    }
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+static
+void bench_set_new_component(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    ecs_entity_t *entities = bench_entities(world);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_entity_t e = entities[i % BENCH_ENTITY_COUNT];
+        ecs_set(world, e, Velocity, {(float)i, (float)i});
+        ecs_remove(world, e, Velocity);
+    }
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+static const bench_desc_t benchmarks[] = {
+    { "entity", "new", .max_count = 10 * 1000 * 1000,
+        .action = bench_new },
+    { "entity", "new_w_component", .max_count = 10 * 1000 * 1000,
+        .action = bench_new_w_component },
+    { "entity", "new_bulk", .max_count = 10 * 1000 * 1000,
+        .action = bench_new_bulk },
+    { "entity", "delete", .max_count = 10 * 1000 * 1000,
+        .action = bench_delete },
+    { "entity", "add_remove_tag", "archetypes", 1,
+        .action = bench_add_remove_tag },
+    { "entity", "add_remove_tag", "archetypes", 16,
+        .action = bench_add_remove_tag },
+    { "entity", "add_remove_tag_n", "entities", 1000,
+        .action = bench_add_remove_tag_n },
+    { "entity", "add_remove_tag_n", "entities", 100 * 1000,
+        .action = bench_add_remove_tag_n },
+    { "entity", "add_remove_component", .action = bench_add_remove_component },
+    { "entity", "get", .action = bench_get },
+    { "entity", "get_pair", "targets", 10, .action = bench_get_pair },
+    { "entity", "get_pair", "targets", 1000, .action = bench_get_pair },
+    { "entity", "get_mut", .action = bench_get_mut },
+    { "entity", "set", .action = bench_set },
+    { "entity", "set_remove_new_component",
+        .action = bench_set_new_component },
+    {0}
+};
+
+const bench_desc_t* bench_entity(void) {
+    return benchmarks;
+}
@@ -0,0 +1,358 @@
+/**
+ * @file main.c
+ * @brief Benchmark runner.
+ *
+ * Usage: flecs_bench [--format text|json|csv] [--min-time sec] [--reps n]
+ *                    [--list] [filter...]
+ *
+ * Filters select benchmarks whose full name contains one of the filters. The
+ * results are written to stdout, progress is written to stderr.
+ */
+
+#include <bench.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ECS_COMPONENT_DECLARE(Position);
+ECS_COMPONENT_DECLARE(Velocity);
+
+typedef enum bench_format_t {
+    BenchText,
+    BenchJson,
+    BenchCsv
+} bench_format_t;
+
+typedef struct bench_result_t {
+    char name[128];
+    int32_t count;
+    double min;
+    double median;
+    double mean;
+} bench_result_t;
+
+static volatile uintptr_t bench_sink;
+
+void bench_start(
+    bench_t *b)
+{
+    b->start = ecs_os_now();
+}
+
+void bench_stop(
+    bench_t *b)
+{
+    b->elapsed = ecs_os_now() - b->start;
+}
+
+void bench_use(
+    const void *ptr)
+{
+    bench_sink = (uintptr_t)ptr;
+}
+
+void bench_components(
+    ecs_world_t *world)
+{
+    /* Ids are reassigned for each benchmark world */
+    ecs_id(Position) = 0;
+    ecs_id(Velocity) = 0;
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+#ifdef FLECS_META
+    /* Worlds created with ecs_mini don't import the meta module */
+    if (!ecs_lookup_fullpath(world, "flecs.meta")) {
+        return;
+    }
+
+    ecs_struct(world, {
+        .entity = ecs_id(Position),
+        .members = {
+            { .name = "x", .type = ecs_id(ecs_f32_t) },
+            { .name = "y", .type = ecs_id(ecs_f32_t) }
+        }
+    });
+    ecs_struct(world, {
+        .entity = ecs_id(Velocity),
+        .members = {
+            { .name = "x", .type = ecs_id(ecs_f32_t) },
+            { .name = "y", .type = ecs_id(ecs_f32_t) }
+        }
+    });
+#endif
+}
+
+static
+uint64_t bench_run(
+    const bench_desc_t *desc,
+    int32_t count)
+{
+    bench_t b = { .count = count, .param = desc->param };
+    desc->action(&b);
+    return b.elapsed;
+}
+
+/* Find the number of operations for which a run takes at least min_time */
+static
+int32_t bench_calibrate(
+    const bench_desc_t *desc,
+    uint64_t min_time)
+{
+    int32_t count = 1, max_count = desc->max_count;
+    if (!max_count) {
+        max_count = INT32_MAX / 2;
+    }
+
+    for (;;) {
+        uint64_t elapsed = bench_run(desc, count);
+        if (elapsed >= min_time || count >= max_count) {
+            break;
+        }
+
+        double next = (double)count * 1.4 * (double)min_time;
+        if (elapsed) {
+            next /= (double)elapsed;
+        } else {
+            next = (double)count * 100;
+        }
+        if (next > (double)count * 100) {
+            next = (double)count * 100;
+        }
+        if (next < (double)count + 1) {
+            next = (double)count + 1;
+        }
+        if (next > (double)max_count) {
+            next = (double)max_count;
+        }
+        count = (int32_t)next;
+    }
+
+    return count;
+}
+
+static
+int bench_compare_double(
+    const void *p1,
+    const void *p2)
+{
+    double d1 = *(const double*)p1, d2 = *(const double*)p2;
+    return (d1 > d2) - (d1 < d2);
+}
+
+static
+void bench_name_of(
+    const bench_desc_t *desc,
+    char *buf,
+    size_t size)
+{
+    if (desc->param_name) {
+        snprintf(buf, size, "%s/%s/%s:%d", desc->group, desc->name,
+            desc->param_name, desc->param);
+    } else {
+        snprintf(buf, size, "%s/%s", desc->group, desc->name);
+    }
+}
+
+static
+bool bench_match(
+    const char *name,
+    int filter_count,
+    char **filters)
+{
+    if (!filter_count) {
+        return true;
+    }
+
+    int i;
+    for (i = 0; i < filter_count; i ++) {
+        if (strstr(name, filters[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static
+void bench_measure(
+    const bench_desc_t *desc,
+    bench_result_t *result,
+    uint64_t min_time,
+    int32_t reps)
+{
+    double *samples = ecs_os_malloc_n(double, reps);
+    int32_t i, count = bench_calibrate(desc, min_time);
+
+    result->count = count;
+    result->mean = 0;
+    for (i = 0; i < reps; i ++) {
+        samples[i] = (double)bench_run(desc, count) / (double)count;
+        result->mean += samples[i];
+    }
+    result->mean /= reps;
+
+    qsort(samples, (size_t)reps, sizeof(double), bench_compare_double);
+    result->min = samples[0];
+    if (reps % 2) {
+        result->median = samples[reps / 2];
+    } else {
+        result->median = (samples[reps / 2 - 1] + samples[reps / 2]) / 2;
+    }
+
+    ecs_os_free(samples);
+}
+
+static
+void bench_print_header(
+    bench_format_t format,
+    int32_t reps)
+{
+    if (format == BenchJson) {
+        printf("{\n");
+#ifdef FLECS_NDEBUG
+        printf("  \"debug\": false,\n");
+#else
+        printf("  \"debug\": true,\n");
+#endif
+#ifdef FLECS_MAP_SWISS
+        printf("  \"map\": \"swiss\",\n");
+#else
+        printf("  \"map\": \"chained\",\n");
+#endif
+        printf("  \"reps\": %d,\n", reps);
+        printf("  \"unit\": \"ns/op\",\n");
+        printf("  \"results\": [");
+    } else if (format == BenchCsv) {
+        printf("name,count,min_ns,median_ns,mean_ns\n");
+    } else {
+        printf("%-56s %12s %12s %12s\n", "benchmark", "count",
+            "min ns/op", "median ns/op");
+    }
+}
+
+static
+void bench_print_result(
+    bench_format_t format,
+    const bench_result_t *r,
+    bool first)
+{
+    if (format == BenchJson) {
+        printf("%s\n    {\"name\": \"%s\", \"count\": %d, \"min\": %.3f, "
+            "\"median\": %.3f, \"mean\": %.3f}", first ? "" : ",",
+                r->name, r->count, r->min, r->median, r->mean);
+    } else if (format == BenchCsv) {
+        printf("%s,%d,%.3f,%.3f,%.3f\n",
+            r->name, r->count, r->min, r->median, r->mean);
+    } else {
+        printf("%-56s %12d %12.2f %12.2f\n",
+            r->name, r->count, r->min, r->median);
+    }
+    fflush(stdout);
+}
+
+static
+void bench_print_footer(
+    bench_format_t format)
+{
+    if (format == BenchJson) {
+        printf("\n  ]\n}\n");
+    }
+}
+
+static
+int bench_usage(void) {
+    fprintf(stderr,
+        "Usage: flecs_bench [options] [filter...]\n"
+        "  --format text|json|csv  Output format (default text)\n"
+        "  --min-time <sec>        Minimum duration of a run (default 0.1)\n"
+        "  --reps <n>              Measured runs per benchmark (default 5)\n"
+        "  --list                  List benchmarks\n");
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    bench_format_t format = BenchText;
+    double min_time = 0.1;
+    int32_t reps = 5;
+    bool list = false;
+    int i, filter_count = 0;
+
+    ecs_os_set_api_defaults();
+    char **filters = ecs_os_calloc_n(char*, argc);
+
+    for (i = 1; i < argc; i ++) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "--format") && (i + 1) < argc) {
+            const char *fmt = argv[++ i];
+            if (!strcmp(fmt, "json")) {
+                format = BenchJson;
+            } else if (!strcmp(fmt, "csv")) {
+                format = BenchCsv;
+            } else if (!strcmp(fmt, "text")) {
+                format = BenchText;
+            } else {
+                return bench_usage();
+            }
+        } else if (!strcmp(arg, "--min-time") && (i + 1) < argc) {
+            min_time = atof(argv[++ i]);
+        } else if (!strcmp(arg, "--reps") && (i + 1) < argc) {
+            reps = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--list")) {
+            list = true;
+        } else if (arg[0] == '-') {
+            return bench_usage();
+        } else {
+            filters[filter_count ++] = argv[i];
+        }
+    }
+
+    if (reps < 1) {
+        reps = 1;
+    }
+
+    const bench_desc_t* (*groups[])(void) = {
+        bench_entity,
+        bench_query,
+        bench_observer,
+        bench_name,
+        bench_map,
+        bench_worker
+    };
+
+    if (!list) {
+        bench_print_header(format, reps);
+    }
+
+    bool first = true;
+    int32_t g;
+    for (g = 0; g < (int32_t)(sizeof(groups) / sizeof(groups[0])); g ++) {
+        const bench_desc_t *desc = groups[g]();
+        for (; desc->action; desc ++) {
+            bench_result_t result;
+            bench_name_of(desc, result.name, sizeof(result.name));
+            if (!bench_match(result.name, filter_count, filters)) {
+                continue;
+            }
+
+            if (list) {
+                printf("%s\n", result.name);
+                continue;
+            }
+
+            fprintf(stderr, "running %s\n", result.name);
+            bench_measure(desc, &result, (uint64_t)(min_time * 1e9), reps);
+            bench_print_result(format, &result, first);
+            first = false;
+        }
+    }
+
+    if (!list) {
+        bench_print_footer(format);
+    }
+
+    ecs_os_free(filters);
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file map.c
+ * @brief Map benchmarks.
+ *
+ * Keys are pseudo random 64bit values, which is representative for maps that
+ * are indexed by (pair) ids. The parameter is the number of keys in the map.
+ */
+
+#include <bench.h>
+
+static
+uint64_t* bench_map_keys(
+    int32_t count,
+    uint64_t seed)
+{
+    uint64_t *keys = ecs_os_malloc_n(uint64_t, count);
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        /* splitmix64 */
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        keys[i] = (z ^ (z >> 31)) | 1;
+    }
+    return keys;
+}
+
+static
+void bench_map_fill(
+    ecs_map_t *map,
+    const uint64_t *keys,
+    int32_t count)
+{
+    int32_t i;
+    ecs_map_init(map, NULL);
+    for (i = 0; i < count; i ++) {
+        ecs_map_insert(map, keys[i], (ecs_map_val_t)i);
+    }
+}
+
+/* Insert keys into an empty map. An operation is one insert. */
+static
+void bench_map_insert(
+    bench_t *b)
+{
+    uint64_t *keys = bench_map_keys(b->count, 0);
+    ecs_map_t map;
+
+    bench_start(b);
+    bench_map_fill(&map, keys, b->count);
+    bench_stop(b);
+
+    ecs_map_fini(&map);
+    ecs_os_free(keys);
+}
+
+static
+void bench_map_get(
+    bench_t *b)
+{
+    int32_t i, key_count = b->param;
+    uint64_t *keys = bench_map_keys(key_count, 0);
+    ecs_map_t map;
+    bench_map_fill(&map, keys, key_count);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        bench_use(ecs_map_get(&map, keys[i % key_count]));
+    }
+    bench_stop(b);
+
+    ecs_map_fini(&map);
+    ecs_os_free(keys);
+}
+
+static
+void bench_map_get_miss(
+    bench_t *b)
+{
+    int32_t i, key_count = b->param;
+    uint64_t *keys = bench_map_keys(key_count, 0);
+    uint64_t *missing = bench_map_keys(key_count, 1);
+    ecs_map_t map;
+    bench_map_fill(&map, keys, key_count);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        bench_use(ecs_map_get(&map, missing[i % key_count]));
+    }
+    bench_stop(b);
+
+    ecs_map_fini(&map);
+    ecs_os_free(missing);
+    ecs_os_free(keys);
+}
+
+/* Remove and reinsert a key. An operation is one remove and one insert. */
+static
+void bench_map_remove_insert(
+    bench_t *b)
+{
+    int32_t i, key_count = b->param;
+    uint64_t *keys = bench_map_keys(key_count, 0);
+    ecs_map_t map;
+    bench_map_fill(&map, keys, key_count);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        uint64_t key = keys[i % key_count];
+        ecs_map_insert(&map, key, ecs_map_remove(&map, key));
+    }
+    bench_stop(b);
+
+    ecs_map_fini(&map);
+    ecs_os_free(keys);
+}
+
+/* Iterate a map. An operation is one visited element. */
+static
+void bench_map_iter(
+    bench_t *b)
+{
+    int32_t i = 0, key_count = b->param;
+    uint64_t *keys = bench_map_keys(key_count, 0);
+    ecs_map_t map;
+    bench_map_fill(&map, keys, key_count);
+    ecs_map_val_t sum = 0;
+
+    bench_start(b);
+    while (i < b->count) {
+        ecs_map_iter_t it = ecs_map_iter(&map);
+        while (ecs_map_next(&it) && (i < b->count)) {
+            sum += ecs_map_key(&it);
+            i ++;
+        }
+    }
+    bench_stop(b);
+
+    bench_use((void*)(uintptr_t)sum);
+    ecs_map_fini(&map);
+    ecs_os_free(keys);
+}
+
+static const bench_desc_t benchmarks[] = {
+    { "map", "insert", .max_count = 10 * 1000 * 1000,
+        .action = bench_map_insert },
+    { "map", "get", "keys", 1000, .action = bench_map_get },
+    { "map", "get", "keys", 1000 * 1000, .action = bench_map_get },
+    { "map", "get_miss", "keys", 1000, .action = bench_map_get_miss },
+    { "map", "get_miss", "keys", 1000 * 1000, .action = bench_map_get_miss },
+    { "map", "remove_insert", "keys", 1000,
+        .action = bench_map_remove_insert },
+    { "map", "remove_insert", "keys", 1000 * 1000,
+        .action = bench_map_remove_insert },
+    { "map", "iter", "keys", 1000, .action = bench_map_iter },
+    { "map", "iter", "keys", 1000 * 1000, .action = bench_map_iter },
+    {0}
+};
+
+const bench_desc_t* bench_map(void) {
+    return benchmarks;
+}
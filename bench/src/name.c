@@ -0,0 +1,156 @@
+/**
+ * @file name.c
+ * @brief Name lookup and serialization benchmarks.
+ */
+
+#include <bench.h>
+#include <stdio.h>
+
+/* Number of children per parent in the lookup hierarchy */
+#define BENCH_LOOKUP_CHILD_COUNT (100)
+
+/* Number of entities serialized by the iterator serialization benchmark */
+#define BENCH_JSON_ENTITY_COUNT (100)
+
+static
+ecs_entity_t bench_child(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const char *name)
+{
+    ecs_entity_t e;
+    if (parent) {
+        e = ecs_new_w_pair(world, EcsChildOf, parent);
+    } else {
+        e = ecs_new_id(world);
+    }
+    return ecs_set_name(world, e, name);
+}
+
+/* Look up a path. The parameter is the depth of the looked up entity. Each
+ * level in the hierarchy has BENCH_LOOKUP_CHILD_COUNT siblings. */
+static
+void bench_lookup_path(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    ecs_entity_t parent = 0;
+    int32_t i, depth, depth_count = b->param;
+    char name[32];
+
+    for (depth = 0; depth < depth_count; depth ++) {
+        ecs_entity_t child = 0;
+        for (i = 0; i < BENCH_LOOKUP_CHILD_COUNT; i ++) {
+            ecs_os_sprintf(name, "e%d", i);
+            child = bench_child(world, parent, name);
+        }
+        parent = child;
+    }
+
+    char *path = ecs_get_fullpath(world, parent);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        bench_use((void*)(uintptr_t)ecs_lookup_path(world, 0, path));
+    }
+    bench_stop(b);
+
+    ecs_os_free(path);
+    ecs_fini(world);
+}
+
+static
+void bench_get_path(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    ecs_entity_t parent = 0;
+    int32_t i, depth_count = b->param;
+
+    for (i = 0; i < depth_count; i ++) {
+        parent = bench_child(world, parent, "e");
+    }
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        char *path = ecs_get_fullpath(world, parent);
+        bench_use(path);
+        ecs_os_free(path);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+#ifdef FLECS_JSON
+static
+void bench_entity_to_json(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_init();
+    bench_components(world);
+
+    ecs_entity_t e = ecs_entity(world, { .name = "e" });
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        char *json = ecs_entity_to_json(world, e, NULL);
+        bench_use(json);
+        ecs_os_free(json);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+void bench_iter_to_json(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_init();
+    bench_components(world);
+
+    int32_t i;
+    for (i = 0; i < BENCH_JSON_ENTITY_COUNT; i ++) {
+        ecs_entity_t e = ecs_new_id(world);
+        ecs_set(world, e, Position, {(float)i, (float)i});
+        ecs_set(world, e, Velocity, {1, 2});
+    }
+
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {{ ecs_id(Position) }, { ecs_id(Velocity) }}
+    });
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_iter_t it = ecs_filter_iter(world, f);
+        char *json = ecs_iter_to_json(world, &it, NULL);
+        bench_use(json);
+        ecs_os_free(json);
+    }
+    bench_stop(b);
+
+    ecs_filter_fini(f);
+    ecs_fini(world);
+}
+#endif
+
+static const bench_desc_t benchmarks[] = {
+    { "name", "lookup_path", "depth", 1, .action = bench_lookup_path },
+    { "name", "lookup_path", "depth", 3, .action = bench_lookup_path },
+    { "name", "get_path", "depth", 1, .action = bench_get_path },
+    { "name", "get_path", "depth", 3, .action = bench_get_path },
+#ifdef FLECS_JSON
+    { "json", "entity_to_json", .action = bench_entity_to_json },
+    { "json", "iter_to_json", "entities", BENCH_JSON_ENTITY_COUNT,
+        .action = bench_iter_to_json },
+#endif
+    {0}
+};
+
+const bench_desc_t* bench_name(void) {
+    return benchmarks;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file observer.c
+ * @brief Observer dispatch and command merge benchmarks.
+ */
+
+#include <bench.h>
+
+/* Number of entities that command benchmarks cycle through */
+#define BENCH_CMD_ENTITY_COUNT (1024)
+
+static
+void bench_observer_callback(
+    ecs_iter_t *it)
+{
+    bench_use(it->ptrs);
+}
+
+static
+void bench_observer_init(
+    ecs_world_t *world,
+    ecs_entity_t event,
+    int32_t count)
+{
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        ecs_observer(world, {
+            .filter.terms = {{ ecs_id(Position) }},
+            .events = { event },
+            .callback = bench_observer_callback
+        });
+    }
+}
+
+/* Set a component that has one or more OnSet observers */
+static
+void bench_on_set(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    bench_observer_init(world, EcsOnSet, b->param);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_set(world, e, Position, {(float)i, (float)i});
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+/* Add and remove a component that has OnAdd and OnRemove observers */
+static
+void bench_on_add_remove(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    bench_observer_init(world, EcsOnAdd, b->param);
+    bench_observer_init(world, EcsOnRemove, b->param);
+
+    ecs_entity_t e = ecs_new(world, Velocity);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_add(world, e, Position);
+        ecs_remove(world, e, Position);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+/* Emit a custom event for an entity */
+static
+void bench_emit(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    ecs_entity_t event = ecs_new_id(world);
+    bench_observer_init(world, event, b->param);
+
+    ecs_entity_t e = ecs_new(world, Position);
+    ecs_id_t id = ecs_id(Position);
+    ecs_type_t type = { .array = &id, .count = 1 };
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_emit(world, &(ecs_event_desc_t){
+            .event = event,
+            .ids = &type,
+            .entity = e
+        });
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+ecs_entity_t* bench_cmd_entities(
+    ecs_world_t *world)
+{
+    return ecs_os_memdup_n(
+        ecs_bulk_new(world, Position, BENCH_CMD_ENTITY_COUNT),
+            ecs_entity_t, BENCH_CMD_ENTITY_COUNT);
+}
+
+/* Enqueue and merge set commands. An operation is one command. */
+static
+void bench_cmd_set(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    ecs_entity_t *entities = bench_cmd_entities(world);
+    int32_t i;
+
+    bench_start(b);
+    ecs_defer_begin(world);
+    for (i = 0; i < b->count; i ++) {
+        ecs_set(world, entities[i % BENCH_CMD_ENTITY_COUNT], Position,
+            {(float)i, (float)i});
+    }
+    ecs_defer_end(world);
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+/* Merge add/remove commands. Only the merge is measured. */
+static
+void bench_cmd_merge(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+    ecs_entity_t *entities = bench_cmd_entities(world);
+    int32_t i;
+
+    ecs_defer_begin(world);
+    for (i = 0; i < b->count; i ++) {
+        ecs_entity_t e = entities[i % BENCH_CMD_ENTITY_COUNT];
+        if ((i / BENCH_CMD_ENTITY_COUNT) % 2) {
+            ecs_remove(world, e, Velocity);
+        } else {
+            ecs_add(world, e, Velocity);
+        }
+    }
+
+    bench_start(b);
+    ecs_defer_end(world);
+    bench_stop(b);
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
+
+static const bench_desc_t benchmarks[] = {
+    { "observer", "on_set", "observers", 1, .action = bench_on_set },
+    { "observer", "on_set", "observers", 10, .action = bench_on_set },
+    { "observer", "on_add_remove", "observers", 1,
+        .action = bench_on_add_remove },
+    { "observer", "on_add_remove", "observers", 10,
+        .action = bench_on_add_remove },
+    { "observer", "emit", "observers", 1, .action = bench_emit },
+    { "observer", "emit", "observers", 10, .action = bench_emit },
+    { "commands", "set", .max_count = 10 * 1000 * 1000,
+        .action = bench_cmd_set },
+    { "commands", "merge_add_remove", .max_count = 10 * 1000 * 1000,
+        .action = bench_cmd_merge },
+    {0}
+};
+
+const bench_desc_t* bench_observer(void) {
+    return benchmarks;
+}
@@ -0,0 +1,344 @@
+/**
+ * @file query.c
+ * @brief Query iteration benchmarks.
+ *
+ * An operation is one iteration over all matched entities. The parameter is
+ * the number of archetypes the entities are spread over. The each_changed
+ * benchmark iterates while change detection is enabled for the components, so
+ * that iteration marks columns dirty. The prefetch
+ * benchmark iterates many medium sized archetypes with prefetching disabled (0)
+ * or enabled (1). The reparent benchmark measures rematching a cascade query
+ * after a hierarchy change. The rule_join benchmark iterates a rule that joins
+ * entities on two relationship targets. The rule_transitive benchmark iterates
+ * a rule that traverses a transitive relationship.
+ */
+
+#include <bench.h>
+
+/* Total number of entities matched by query benchmarks */
+#define BENCH_QUERY_ENTITY_COUNT (1000)
+
+static
+ecs_world_t* bench_query_world(
+    int32_t archetype_count)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    int32_t i;
+    ecs_entity_t *tags = ecs_os_malloc_n(ecs_entity_t, archetype_count);
+    for (i = 0; i < archetype_count; i ++) {
+        tags[i] = ecs_new_id(world);
+    }
+
+    for (i = 0; i < BENCH_QUERY_ENTITY_COUNT; i ++) {
+        ecs_entity_t e = ecs_new_w_id(world, tags[i % archetype_count]);
+        ecs_set(world, e, Position, {0, 0});
+        ecs_set(world, e, Velocity, {1, 1});
+    }
+
+    ecs_os_free(tags);
+    return world;
+}
+
+static
+void bench_progress(
+    ecs_iter_t *it)
+{
+    Position *p = ecs_field(it, Position, 1);
+    const Velocity *v = ecs_field(it, Velocity, 2);
+    int32_t i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x += v[i].x;
+        p[i].y += v[i].y;
+    }
+}
+
+static
+void bench_query_each(
+    bench_t *b)
+{
+    ecs_world_t *world = bench_query_world(b->param);
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity), .inout = EcsIn }}
+    });
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            bench_progress(&it);
+        }
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+void bench_query_each_changed(
+    bench_t *b)
+{
+    ecs_world_t *world = bench_query_world(b->param);
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity), .inout = EcsIn }}
+    });
+
+    /* Change detection query, which makes iterating q mark columns dirty */
+    ecs_query_t *q_changed = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position), .inout = EcsIn }}
+    });
+    ecs_query_changed(q_changed, NULL);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            bench_progress(&it);
+        }
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+void bench_filter_each(
+    bench_t *b)
+{
+    ecs_world_t *world = bench_query_world(b->param);
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {{ ecs_id(Position) }, { ecs_id(Velocity), .inout = EcsIn }}
+    });
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_iter_t it = ecs_filter_iter(world, f);
+        while (ecs_filter_next(&it)) {
+            bench_progress(&it);
+        }
+    }
+    bench_stop(b);
+
+    ecs_filter_fini(f);
+    ecs_fini(world);
+}
+
+/* Number of archetypes and entities per archetype for the prefetch benchmark.
+ * The data does not fit in the cache, so the first accesses to each table are
+ * cache misses unless they are prefetched. */
+#define BENCH_PREFETCH_ARCHETYPE_COUNT (2048)
+#define BENCH_PREFETCH_ENTITY_COUNT (64)
+
+static
+void bench_query_prefetch(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    int32_t i, j;
+    for (i = 0; i < BENCH_PREFETCH_ARCHETYPE_COUNT; i ++) {
+        ecs_entity_t tag = ecs_new_id(world);
+        for (j = 0; j < BENCH_PREFETCH_ENTITY_COUNT; j ++) {
+            ecs_entity_t e = ecs_new_w_id(world, tag);
+            ecs_set(world, e, Position, {0, 0});
+            ecs_set(world, e, Velocity, {1, 1});
+        }
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity), .inout = EcsIn }},
+        .prefetch = b->param != 0
+    });
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_iter_t it = ecs_query_iter(world, q);
+        while (ecs_query_next(&it)) {
+            bench_progress(&it);
+        }
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+static
+void bench_query_new(
+    bench_t *b)
+{
+    ecs_world_t *world = bench_query_world(b->param);
+    int32_t i;
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_query_t *q = ecs_query(world, {
+            .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity) }}
+        });
+        ecs_query_fini(q);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+/* Reparent a subtree and rematch a cascade query. The parameter is the number
+ * of subtrees in the hierarchy, each of which has its own tables. An operation
+ * is one reparent followed by the rematch. */
+static
+void bench_query_reparent(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    bench_components(world);
+
+    int32_t i, j, tree_count = b->param;
+    ecs_entity_t parents[2] = {0}, child = 0;
+    for (i = 0; i < tree_count; i ++) {
+        ecs_entity_t root = ecs_new_id(world);
+        ecs_set(world, root, Position, {0, 0});
+        ecs_entity_t c = ecs_new_w_pair(world, EcsChildOf, root);
+        ecs_set(world, c, Position, {0, 0});
+        for (j = 0; j < 10; j ++) {
+            ecs_entity_t gc = ecs_new_w_pair(world, EcsChildOf, c);
+            ecs_set(world, gc, Position, {0, 0});
+        }
+        if (i < 2) {
+            parents[i] = root;
+        }
+        if (!i) {
+            child = c;
+        }
+    }
+
+    ecs_query_t *q = ecs_query_new(world, "Position, ?Position(parent|cascade)");
+    ecs_iter_t it = ecs_query_iter(world, q);
+    ecs_iter_fini(&it);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_add_pair(world, child, EcsChildOf, parents[(i + 1) % 2]);
+        it = ecs_query_iter(world, q);
+        ecs_iter_fini(&it);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+#ifdef FLECS_RULES
+/* Iterate a rule that finds pairs of entities with the same Likes and Owns
+ * targets. The parameter is the number of Likes targets. */
+static
+void bench_rule_join(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    ecs_entity_t Likes = ecs_new_entity(world, "Likes");
+    ecs_entity_t Owns = ecs_new_entity(world, "Owns");
+
+    int32_t i, target_count = b->param;
+    ecs_entity_t *targets = ecs_os_malloc_n(ecs_entity_t, target_count);
+    for (i = 0; i < target_count; i ++) {
+        targets[i] = ecs_new_id(world);
+    }
+
+    for (i = 0; i < BENCH_QUERY_ENTITY_COUNT; i ++) {
+        ecs_entity_t e = ecs_new_id(world);
+        ecs_add_pair(world, e, Likes, targets[i % target_count]);
+        ecs_add_pair(world, e, Owns, targets[(i / 3) % target_count]);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Likes($this, $x), Owns($this, $y), Likes($z, $x), Owns($z, $y)"
+    });
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        while (ecs_rule_next(&it)) {
+            bench_use(it.entities);
+        }
+    }
+    bench_stop(b);
+
+    ecs_rule_fini(r);
+    ecs_os_free(targets);
+    ecs_fini(world);
+}
+
+/* Iterate a rule that finds all entities that are transitively located in the
+ * root of a tree. The parameter is the depth of the tree. */
+static
+void bench_rule_transitive(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_mini();
+    ecs_entity_t LocatedIn = ecs_new_entity(world, "LocatedIn");
+    ecs_add_id(world, LocatedIn, EcsTransitive);
+    ecs_entity_t root = ecs_new_entity(world, "root");
+
+    /* Each level has 4 locations that are located in a random location of the
+     * level above it, and each location contains a few entities. */
+    int32_t i, j, depth = b->param;
+    ecs_entity_t prev[4] = { root, root, root, root };
+    for (i = 0; i < depth; i ++) {
+        ecs_entity_t cur[4];
+        for (j = 0; j < 4; j ++) {
+            cur[j] = ecs_new_w_pair(world, LocatedIn, prev[(i + j) % 4]);
+            ecs_bulk_new_w_id(world, ecs_pair(LocatedIn, cur[j]), 10);
+        }
+        ecs_os_memcpy_n(prev, cur, ecs_entity_t, 4);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, root)"
+    });
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        while (ecs_rule_next(&it)) {
+            bench_use(it.entities);
+        }
+    }
+    bench_stop(b);
+
+    ecs_rule_fini(r);
+    ecs_fini(world);
+}
+#endif
+
+static const bench_desc_t benchmarks[] = {
+    { "query", "each", "archetypes", 1, .action = bench_query_each },
+    { "query", "each", "archetypes", 10, .action = bench_query_each },
+    { "query", "each", "archetypes", 100, .action = bench_query_each },
+    { "query", "each", "archetypes", 1000, .action = bench_query_each },
+    { "query", "each_changed", "archetypes", 1, .action = bench_query_each_changed },
+    { "query", "each_changed", "archetypes", 1000, .action = bench_query_each_changed },
+    { "query", "filter_each", "archetypes", 1, .action = bench_filter_each },
+    { "query", "filter_each", "archetypes", 10, .action = bench_filter_each },
+    { "query", "filter_each", "archetypes", 100, .action = bench_filter_each },
+    { "query", "filter_each", "archetypes", 1000, .action = bench_filter_each },
+    { "query", "prefetch", "enabled", 0, .action = bench_query_prefetch },
+    { "query", "prefetch", "enabled", 1, .action = bench_query_prefetch },
+    { "query", "new_fini", "archetypes", 1, .action = bench_query_new },
+    { "query", "new_fini", "archetypes", 100, .action = bench_query_new },
+    { "query", "reparent", "trees", 10, .action = bench_query_reparent },
+    { "query", "reparent", "trees", 1000, .action = bench_query_reparent },
+#ifdef FLECS_RULES
+    { "query", "rule_join", "targets", 10, .action = bench_rule_join },
+    { "query", "rule_join", "targets", 100, .action = bench_rule_join },
+    { "query", "rule_transitive", "depth", 4, .action = bench_rule_transitive },
+    { "query", "rule_transitive", "depth", 32, .action = bench_rule_transitive },
+#endif
+    {0}
+};
+
+const bench_desc_t* bench_query(void) {
+    return benchmarks;
+}
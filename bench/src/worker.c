@@ -0,0 +1,319 @@
+/**
+ * @file worker.c
+ * @brief Worker synchronization benchmarks.
+ *
+ * Runs a pipeline that alternates between multithreaded and single threaded
+ * systems, so that each frame has BENCH_SYNC_POINTS points where the main
+ * thread signals the workers and waits for them to finish. An operation is one
+ * frame. The futex and condvar variants compare the two worker synchronization
+ * mechanisms for the same number of threads.
+ */
+
+#include <bench.h>
+
+#ifdef FLECS_PIPELINE
+
+/* Number of multithreaded systems (and sync points) per frame */
+#define BENCH_SYNC_POINTS (8)
+
+/* Number of entities matched by the multithreaded systems */
+#define BENCH_WORKER_ENTITY_COUNT (1000)
+
+static
+void bench_worker_move(
+    ecs_iter_t *it)
+{
+    Position *p = ecs_field(it, Position, 1);
+    int32_t i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+static
+void bench_worker_main(
+    ecs_iter_t *it)
+{
+    bench_use(it);
+}
+
+static
+void bench_worker_sync(
+    bench_t *b,
+    bool use_futex)
+{
+    ecs_world_t *world = ecs_init();
+    bench_components(world);
+    ecs_bulk_new(world, Position, BENCH_WORKER_ENTITY_COUNT);
+
+    int32_t i;
+    for (i = 0; i < BENCH_SYNC_POINTS; i ++) {
+        ecs_system(world, {
+            .entity = ecs_entity(world, {
+                .add = { ecs_dependson(EcsOnUpdate) }
+            }),
+            .query.filter.terms = {{ ecs_id(Position) }},
+            .callback = bench_worker_move,
+            .multi_threaded = true
+        });
+        ecs_system(world, {
+            .entity = ecs_entity(world, {
+                .add = { ecs_dependson(EcsOnUpdate) }
+            }),
+            .callback = bench_worker_main
+        });
+    }
+
+    /* Workers select the sync mechanism when they are created */
+    ecs_os_api_futex_wait_t futex_wait = ecs_os_api.futex_wait_;
+    ecs_os_api_futex_wake_t futex_wake = ecs_os_api.futex_wake_;
+    if (!use_futex) {
+        ecs_os_api.futex_wait_ = NULL;
+        ecs_os_api.futex_wake_ = NULL;
+    }
+
+    ecs_set_threads(world, b->param);
+
+    /* Warm up */
+    ecs_progress(world, 0);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_progress(world, 0);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+
+    ecs_os_api.futex_wait_ = futex_wait;
+    ecs_os_api.futex_wake_ = futex_wake;
+}
+
+/* Number of entities spawned per frame by the spawn benchmark */
+#define BENCH_SPAWN_COUNT (10000)
+
+static
+void bench_worker_spawn_system(
+    ecs_iter_t *it)
+{
+    int32_t i, j, count = BENCH_SPAWN_COUNT / it->count;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < count; j ++) {
+            ecs_set(it->world, 0, Velocity, {1, 1});
+        }
+    }
+}
+
+/* Create entities from a multithreaded system. An operation is one frame that
+ * spawns BENCH_SPAWN_COUNT entities, including the merge. */
+static
+void bench_worker_spawn(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_init();
+    bench_components(world);
+    ecs_bulk_new(world, Position, 100);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .add = { ecs_dependson(EcsOnUpdate) }
+        }),
+        .query.filter.terms = {{ ecs_id(Position) }},
+        .callback = bench_worker_spawn_system,
+        .multi_threaded = true
+    });
+
+    ecs_set_threads(world, b->param);
+
+    int32_t i;
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_progress(world, 0);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+/* Table sizes for the par_each benchmark. Tables vary a lot in size, so an
+ * even split per table would leave threads idle. */
+static const int32_t bench_par_each_tables[] = { 10, 50000, 100, 20000, 1 };
+
+static
+void bench_worker_par_each_move(
+    ecs_iter_t *it)
+{
+    Position *p = ecs_field(it, Position, 1);
+    const Velocity *v = ecs_field(it, Velocity, 2);
+    int32_t i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x += v[i].x;
+        p[i].y += v[i].y;
+    }
+}
+
+/* Iterate a query with ecs_query_par_each. An operation is one iteration over
+ * all matched entities. */
+static
+void bench_worker_par_each(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_init();
+    bench_components(world);
+
+    int32_t i, j, table_count = (int32_t)(sizeof(bench_par_each_tables) / 
+        sizeof(bench_par_each_tables[0]));
+    for (i = 0; i < table_count; i ++) {
+        ecs_entity_t tag = ecs_new_id(world);
+        for (j = 0; j < bench_par_each_tables[i]; j ++) {
+            ecs_entity_t e = ecs_new_w_id(world, tag);
+            ecs_set(world, e, Position, {0, 0});
+            ecs_set(world, e, Velocity, {1, 1});
+        }
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity), .inout = EcsIn }}
+    });
+
+    ecs_set_threads(world, b->param);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_query_par_each(world, q, bench_worker_par_each_move, NULL, 0);
+    }
+    bench_stop(b);
+
+    ecs_fini(world);
+}
+
+#ifdef FLECS_RULES
+/* Number of tables and relationship targets for the rule_par_each benchmark */
+#define BENCH_RULE_PAR_EACH_TABLES (64)
+#define BENCH_RULE_PAR_EACH_TARGETS (256)
+
+static
+void bench_worker_rule_par_each_count(
+    ecs_iter_t *it)
+{
+    bench_use(it->entities);
+}
+
+/* Evaluate a rule with ecs_rule_par_each. An operation is one evaluation of
+ * the rule. */
+static
+void bench_worker_rule_par_each(
+    bench_t *b)
+{
+    ecs_world_t *world = ecs_init();
+    bench_components(world);
+    ecs_entity_t Likes = ecs_new_entity(world, "Likes");
+
+    int32_t i;
+    ecs_entity_t targets[BENCH_RULE_PAR_EACH_TARGETS];
+    for (i = 0; i < BENCH_RULE_PAR_EACH_TARGETS; i ++) {
+        targets[i] = ecs_new_id(world);
+        if (i % 2) {
+            ecs_set(world, targets[i], Velocity, {1, 1});
+        }
+    }
+
+    ecs_entity_t tags[BENCH_RULE_PAR_EACH_TABLES];
+    for (i = 0; i < BENCH_RULE_PAR_EACH_TABLES; i ++) {
+        tags[i] = ecs_new_id(world);
+    }
+
+    for (i = 0; i < BENCH_WORKER_ENTITY_COUNT * 10; i ++) {
+        ecs_entity_t e = ecs_new_w_id(world, tags[i % BENCH_RULE_PAR_EACH_TABLES]);
+        ecs_set(world, e, Position, {0, 0});
+        ecs_add_pair(world, e, Likes, targets[i % BENCH_RULE_PAR_EACH_TARGETS]);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position, Likes($this, $x), Velocity($x)"
+    });
+
+    ecs_set_threads(world, b->param);
+
+    bench_start(b);
+    for (i = 0; i < b->count; i ++) {
+        ecs_rule_par_each(world, r, bench_worker_rule_par_each_count, NULL);
+    }
+    bench_stop(b);
+
+    ecs_rule_fini(r);
+    ecs_fini(world);
+}
+#endif
+
+static
+void bench_worker_sync_futex(
+    bench_t *b)
+{
+    bench_worker_sync(b, true);
+}
+
+static
+void bench_worker_sync_condvar(
+    bench_t *b)
+{
+    bench_worker_sync(b, false);
+}
+
+#define BENCH_WORKER(threads)\
+    { "worker_sync", "futex", "threads", threads,\
+        .action = bench_worker_sync_futex },\
+    { "worker_sync", "condvar", "threads", threads,\
+        .action = bench_worker_sync_condvar }
+
+static const bench_desc_t benchmarks[] = {
+    BENCH_WORKER(2),
+    BENCH_WORKER(4),
+    BENCH_WORKER(8),
+    { "worker_spawn", "entities", "threads", 1, .max_count = 100,
+        .action = bench_worker_spawn },
+    { "worker_spawn", "entities", "threads", 2, .max_count = 100,
+        .action = bench_worker_spawn },
+    { "worker_spawn", "entities", "threads", 4, .max_count = 100,
+        .action = bench_worker_spawn },
+    { "worker_par_each", "skewed", "threads", 1,
+        .action = bench_worker_par_each },
+    { "worker_par_each", "skewed", "threads", 2,
+        .action = bench_worker_par_each },
+    { "worker_par_each", "skewed", "threads", 4,
+        .action = bench_worker_par_each },
+#ifdef FLECS_RULES
+    { "worker_rule_par_each", "join", "threads", 1,
+        .action = bench_worker_rule_par_each },
+    { "worker_rule_par_each", "join", "threads", 2,
+        .action = bench_worker_rule_par_each },
+    { "worker_rule_par_each", "join", "threads", 4,
+        .action = bench_worker_rule_par_each },
+#endif
+    {0}
+};
+
+static const bench_desc_t no_benchmarks[] = {
+    {0}
+};
+
+const bench_desc_t* bench_worker(void) {
+    /* The futex variants would measure the condvar path when the OS API has
+     * no futex functions, so skip the comparison. */
+    if (!ecs_os_has_threading() || !ecs_os_has_futex()) {
+        return no_benchmarks;
+    }
+    return benchmarks;
+}
+
+#else
+
+static const bench_desc_t benchmarks[] = {
+    {0}
+};
+
+const bench_desc_t* bench_worker(void) {
+    return benchmarks;
+}
+
+#endif
@@ -142,6 +142,28 @@ uint64_t* flecs_entity_index_new_ids(
     ecs_entity_index_t *index,
     int32_t count);
 
+/* Set table and row for entities that were appended to consecutive rows of
+ * the same table, and store their records in records. */
+void flecs_entity_index_set_table(
+    ecs_entity_index_t *index,
+    const uint64_t *ids,
+    int32_t count,
+    ecs_table_t *table,
+    int32_t row,
+    ecs_record_t **records);
+
+/* Reserve a range of new entity ids. Thread safe, ids in the range are not
+ * alive until they are ensured. Returns the first id of the range. */
+uint64_t flecs_entity_index_reserve_ids(
+    ecs_entity_index_t *index,
+    int32_t count);
+
+/* Make reserved ids that were not used available for recycling */
+void flecs_entity_index_release_ids(
+    ecs_entity_index_t *index,
+    uint64_t first,
+    int32_t count);
+
 /* Set size of index */
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
@@ -190,6 +212,9 @@ void flecs_entity_index_restore(
 #define flecs_entities_exists(world, entity) flecs_entity_index_exists(ecs_eis(world), entity)
 #define flecs_entities_new_id(world) flecs_entity_index_new_id(ecs_eis(world))
 #define flecs_entities_new_ids(world, count) flecs_entity_index_new_ids(ecs_eis(world), count)
+#define flecs_entities_set_table(world, ids, count, table, row, records) flecs_entity_index_set_table(ecs_eis(world), ids, count, table, row, records)
+#define flecs_entities_reserve_ids(world, count) flecs_entity_index_reserve_ids(ecs_eis(world), count)
+#define flecs_entities_release_ids(world, first, count) flecs_entity_index_release_ids(ecs_eis(world), first, count)
 #define flecs_entities_max_id(world) (ecs_eis(world)->max_id)
 #define flecs_entities_set_size(world, size) flecs_entity_index_set_size(ecs_eis(world), size)
 #define flecs_entities_count(world) flecs_entity_index_count(ecs_eis(world))
@@ -523,8 +548,12 @@ typedef struct ecs_table_diff_builder_t {
 typedef struct ecs_table_diff_t {
     ecs_type_t added;                /* Components added between tables */
     ecs_type_t removed;              /* Components removed between tables */
+    struct ecs_graph_edge_t *edge;   /* Edge diff was obtained from, if any */
 } ecs_table_diff_t;
 
+/** Precomputed column mapping for moving entities between tables */
+typedef struct ecs_table_move_plan_t ecs_table_move_plan_t;
+
 /** Edge linked list (used to keep track of incoming edges) */
 typedef struct ecs_graph_edge_hdr_t {
     struct ecs_graph_edge_hdr_t *prev;
@@ -538,6 +567,7 @@ typedef struct ecs_graph_edge_t {
     ecs_table_t *to;                 /* Edge destination table */
     ecs_table_diff_t *diff;          /* Index into diff vector, if non trivial edge */
     ecs_id_t id;                     /* Id associated with edge */
+    ecs_table_move_plan_t *plan;     /* Move plan, created on first move */
 } ecs_graph_edge_t;
 
 /* Edges to other tables. */
@@ -570,6 +600,12 @@ ecs_table_t *flecs_table_traverse_remove(
     ecs_id_t *id_ptr,
     ecs_table_diff_t *diff);
 
+/* Get move plan for the tables of an edge. The plan is created on first use
+ * and is deleted together with the edge. */
+ecs_table_move_plan_t* flecs_table_edge_move_plan(
+    ecs_world_t *world,
+    ecs_graph_edge_t *edge);
+
 /* Cleanup incoming and outgoing edges for table */
 void flecs_table_clear_edges(
     ecs_world_t *world,
@@ -648,8 +684,25 @@ typedef struct ecs_table__t {
     int16_t bs_count;
     int16_t bs_offset;
     int16_t ft_offset;
+    int32_t min_size;                /* Minimum storage size (in elements) */
 } ecs_table__t;
 
+/** Column operation of a move plan. A column index of -1 means that the column
+ * only exists in the other table, in which case hooks are invoked instead of
+ * moving the component. */
+typedef struct ecs_table_move_op_t {
+    int16_t dst;                     /* Column in destination table */
+    int16_t src;                     /* Column in source table */
+} ecs_table_move_op_t;
+
+/** Column operations for moving a row between two tables, in the order in
+ * which the columns would be matched by flecs_table_move. */
+struct ecs_table_move_plan_t {
+    ecs_table_move_op_t *ops;
+    int32_t count;
+    int32_t size;                    /* Number of allocated ops */
+};
+
 /** Table column */
 typedef struct ecs_column_t {
     ecs_vec_t data;                  /* Vector with component data */
@@ -758,7 +811,8 @@ void flecs_table_delete(
 bool flecs_table_records_update_empty(
     ecs_table_t *table);
 
-/* Move a row from one table to another */
+/* Move a row from one table to another. If plan is not NULL it must have been
+ * created for the same destination and source table. */
 void flecs_table_move(
     ecs_world_t *world,
     ecs_entity_t dst_entity,
@@ -767,7 +821,19 @@ void flecs_table_move(
     int32_t new_index,
     ecs_table_t *old_table,
     int32_t old_index,
-    bool construct);
+    bool construct,
+    const ecs_table_move_plan_t *plan);
+
+/* Create move plan for moving rows from the src to the dst table */
+ecs_table_move_plan_t* flecs_table_move_plan_init(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table);
+
+/* Free move plan */
+void flecs_table_move_plan_fini(
+    ecs_world_t *world,
+    ecs_table_move_plan_t *plan);
 
 /* Grow table with specified number of records. Populate table with entities,
  * starting from specified entity id. */
@@ -828,6 +894,13 @@ void flecs_table_merge(
     ecs_data_t *new_data,
     ecs_data_t *old_data);
 
+/* Move all entities of one table to another table, invoking hooks for added
+ * and removed components. Returns the row of the first moved entity. */
+int32_t flecs_table_move_all(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table);
+
 void flecs_table_swap(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -852,8 +925,9 @@ int32_t flecs_table_column_to_union_index(
     const ecs_table_t *table,
     int32_t column);
 
-/* Increase observer count of table */
+/* Increase traversable entity count of table */
 void flecs_table_traversable_add(
+    ecs_world_t *world,
     ecs_table_t *table,
     int32_t value);
 
@@ -1047,6 +1121,16 @@ typedef struct ecs_query_allocators_t {
     ecs_block_allocator_t monitors;
 } ecs_query_allocators_t;
 
+/** Compiled iteration plan. Trivial queries with only And terms have the same
+ * data and written fields for each matched table, so these are resolved once 
+ * when the query is created. */
+typedef struct ecs_query_plan_t {
+    int8_t data_fields[FLECS_TERM_DESC_MAX]; /* Fields with component data */
+    int8_t out_fields[FLECS_TERM_DESC_MAX];  /* Fields written by query */
+    int8_t data_count;
+    int8_t out_count;
+} ecs_query_plan_t;
+
 /** Query that is automatically matched against tables */
 struct ecs_query_t {
     ecs_header_t hdr;
@@ -1085,6 +1169,9 @@ struct ecs_query_t {
     /* Flags for query properties */
     ecs_flags32_t flags;
 
+    /* Iteration plan, valid if query has EcsQueryCompiledIter */
+    ecs_query_plan_t plan;
+
     /* Monitor generation */
     int32_t monitor_generation;
 
@@ -1232,6 +1319,12 @@ struct ecs_stage_t {
     ecs_entity_t base;               /* Currently instantiated top-level base */
     const ecs_entity_t *lookup_path; /* Search path used by lookup operations */
 
+    /* Entity ids reserved for creating entities while multithreaded */
+    ecs_entity_t id_next;            /* Next reserved id */
+    ecs_entity_t id_end;             /* End of reserved id range */
+    int32_t id_block_size;           /* Number of ids to reserve next */
+    ecs_vec_t id_ranges;             /* Reserved [first, end) ranges, not yet merged */
+
     /* Properties */
     bool auto_merge;                 /* Should this stage automatically merge? */
     bool async;                      /* Is stage asynchronous? (write only) */
@@ -1254,6 +1347,9 @@ typedef struct ecs_monitor_t {
 /* Component monitors */
 typedef struct ecs_monitor_set_t {
     ecs_map_t monitors;              /* map<id, ecs_monitor_t> */
+    ecs_vec_t entities;              /* vector<ecs_entity_t>, changed entities */
+    ecs_vec_t tables;                /* vector<ecs_table_t*>, tables to rematch */
+    bool rematch_all;                /* Should queries rematch all tables? */
     bool is_dirty;                   /* Should monitors be evaluated? */
 } ecs_monitor_set_t;
 
@@ -1296,6 +1392,58 @@ typedef struct ecs_action_elem_t {
 } ecs_action_elem_t;
 
 typedef struct ecs_pipeline_state_t ecs_pipeline_state_t;
+typedef struct ecs_worker_job_t ecs_worker_job_t;
+
+/* Function that the main thread and workers run for a worker job */
+typedef void (*ecs_worker_action_t)(
+    ecs_stage_t *stage,
+    void *ctx);
+
+/* Component value that a merge copies to storage. The destination is looked
+ * up when the value is copied, as the row of the entity can change when other
+ * entities are moved in or out of its table. */
+typedef struct ecs_merge_write_t {
+    ecs_record_t *record;
+    int32_t column;
+    ecs_size_t size;
+    void *src;
+} ecs_merge_write_t;
+
+/* Component values collected while merging stages. Writes don't run hooks or
+ * observers, so they can be applied by multiple threads. Writes are sharded by
+ * entity id range, so that writes for the same entity are applied in order by
+ * the same thread. */
+typedef struct ecs_merge_writes_t {
+    ecs_vec_t *shards;               /* vec<ecs_merge_write_t>[shard_count] */
+    int32_t shard_count;             /* Number of shards (one per stage) */
+    int32_t count;                   /* Number of writes in all shards */
+    bool collect;                    /* Collect writes (set while merging) */
+} ecs_merge_writes_t;
+
+/* Pair id records are stored in a two level index, by relationship and then by
+ * target. Both levels are arrays of pages that are allocated on demand, and
+ * freed when they no longer contain id records. */
+#define FLECS_PAIR_INDEX_PAGE_BITS (8)
+#define FLECS_PAIR_INDEX_PAGE_SIZE (1 << FLECS_PAIR_INDEX_PAGE_BITS)
+#define FLECS_PAIR_INDEX_PAGE_MASK (FLECS_PAIR_INDEX_PAGE_SIZE - 1)
+
+/* Id records for pairs with the same relationship */
+typedef struct ecs_pair_index_t {
+    ecs_vec_t pages;                 /* vec<ecs_pair_index_page_t*> */
+    int32_t count;                   /* Number of allocated pages */
+} ecs_pair_index_t;
+
+/* Page with id records for targets of a relationship */
+typedef struct ecs_pair_index_page_t {
+    ecs_id_record_t *records[FLECS_PAIR_INDEX_PAGE_SIZE];
+    int32_t count;                   /* Number of id records in page */
+} ecs_pair_index_page_t;
+
+/* Page with relationships */
+typedef struct ecs_pair_index_rel_page_t {
+    ecs_pair_index_t rels[FLECS_PAIR_INDEX_PAGE_SIZE];
+    int32_t count;                   /* Number of relationships with pages */
+} ecs_pair_index_rel_page_t;
 
 /** The world stores and manages all ECS data. An application can have more than
  * one world, but data is not shared between worlds. */
@@ -1305,6 +1453,7 @@ struct ecs_world_t {
     /* --  Type metadata -- */
     ecs_id_record_t *id_index_lo;
     ecs_map_t id_index_hi;           /* map<id, ecs_id_record_t*> */
+    ecs_vec_t id_index_pairs;        /* vec<ecs_pair_index_rel_page_t*> */
     ecs_sparse_t type_info;          /* sparse<type_id, type_info_t> */
 
     /* -- Cached handle to id records -- */
@@ -1337,6 +1486,10 @@ struct ecs_world_t {
     /* Used to track when cache needs to be updated */
     ecs_monitor_set_t monitors;      /* map<id, ecs_monitor_t> */
 
+    /* -- Traversal cache -- */
+    ecs_map_t trav_cache;            /* map<relationship, ecs_trav_rel_cache_t*> (rules) */
+    int32_t trav_generation;         /* Last generation assigned to (R, *) record */
+
     /* -- Systems -- */
     ecs_entity_t pipeline;           /* Current pipeline */
 
@@ -1347,6 +1500,8 @@ struct ecs_world_t {
     /* -- Staging -- */
     ecs_stage_t *stages;             /* Stages */
     int32_t stage_count;             /* Number of stages */
+    ecs_block_allocator_depot_t *stage_depot; /* Shared by stage allocators */
+    ecs_merge_writes_t merge_writes; /* Writes collected by stage merge */
 
     /* -- Multithreading -- */
     ecs_os_cond_t worker_cond;       /* Signal that worker threads can start */
@@ -1354,8 +1509,15 @@ struct ecs_world_t {
     ecs_os_mutex_t sync_mutex;       /* Mutex for job_cond */
     int32_t workers_running;         /* Number of threads running */
     int32_t workers_waiting;         /* Number of workers waiting on sync */
+    int32_t workers_signal;          /* Incremented when workers can resume (futex) */
+    int32_t workers_pending;         /* Workers that haven't reached sync (futex) */
+    int32_t workers_synced;          /* Set when all workers reached sync (futex) */
+    bool workers_use_futex;          /* Sync workers with futex instead of cond */
     ecs_pipeline_state_t* pq;        /* Pointer to the pipeline for the workers to execute */
     bool workers_use_task_api;       /* Workers are short-lived tasks, not long-running threads */
+    int32_t worker_chunk_size;       /* Rows per chunk claimed by workers (0 = even split) */
+    ecs_worker_job_t *worker_job;    /* Job that workers run instead of pipeline */
+    bool parallel_systems;           /* Run independent systems in parallel */
 
     /* -- Time management -- */
     ecs_time_t world_start_time;     /* Timestamp of simulation start */
@@ -1524,6 +1686,10 @@ struct ecs_id_record_t {
 
     /* Cache invalidation counter */
     ecs_reachable_cache_t reachable;
+
+    /* Changes when entities are added to or removed from the graph of a 
+     * traversable relationship. Only used by (R, *) records. */
+    int32_t trav_generation;
 };
 
 /* Get id record for id */
@@ -1538,6 +1704,11 @@ ecs_id_record_t* flecs_query_id_record_get(
     const ecs_world_t *world,
     ecs_id_t id);
 
+/* Signal that graph of traversable relationship has changed */
+void flecs_id_record_trav_changed(
+    ecs_world_t *world,
+    ecs_entity_t rel);
+
 /* Ensure id record for id */
 ecs_id_record_t* flecs_id_record_ensure(
     ecs_world_t *world,
@@ -1839,6 +2010,40 @@ void flecs_stage_merge_post_frame(
     ecs_world_t *world,
     ecs_stage_t *stage);  
 
+/* Create new entity id from range reserved by stage (thread safe) */
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* Test if id was reserved by stage and its commands have not been merged */
+bool flecs_stage_owns_id(
+    const ecs_stage_t *stage,
+    ecs_entity_t id);
+
+/* Make unused ids reserved by stage available for recycling */
+void flecs_stage_release_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* Collect component value that is copied to storage when writes are flushed */
+void flecs_merge_writes_append(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_record_t *record,
+    int32_t column,
+    void *src,
+    ecs_size_t size);
+
+/* Copy collected component values to storage. Must be called before running
+ * code that can read component values, and before moving entities with
+ * collected writes to another table. */
+void flecs_merge_writes_flush(
+    ecs_world_t *world);
+
+/* Free storage for collected component values */
+void flecs_merge_writes_fini(
+    ecs_world_t *world);
+
 bool flecs_defer_cmd(
     ecs_stage_t *stage);
 
@@ -1968,6 +2173,7 @@ void flecs_eval_component_monitors(
 
 void flecs_monitor_mark_dirty(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_entity_t id);
 
 void flecs_monitor_register(
@@ -2169,6 +2375,7 @@ void flecs_add_flag(
     uint32_t flag);
 
 void flecs_record_add_flag(
+    ecs_world_t *world,
     ecs_record_t *record,
     uint32_t flag);
 
@@ -2176,6 +2383,12 @@ ecs_entity_t flecs_get_oneof(
     const ecs_world_t *world,
     ecs_entity_t e);
 
+/* Create new id for operation on stage. While the world is multithreaded the
+ * id is taken from the range reserved by the stage. */
+ecs_entity_t flecs_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
 void flecs_notify_on_remove(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -2223,6 +2436,16 @@ void flecs_invoke_hook(
     ecs_entity_t event,
     ecs_iter_action_t hook);
 
+#ifdef FLECS_PIPELINE
+/* Run action on the main thread and on the worker threads, and wait until all
+ * threads are done. Returns false if there are no worker threads to run the
+ * action on, in which case the action isn't ran. */
+bool flecs_workers_run(
+    ecs_world_t *world,
+    ecs_worker_action_t action,
+    void *ctx);
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Query API
 ////////////////////////////////////////////////////////////////////////////////
@@ -2332,6 +2555,16 @@ uint64_t flecs_ito_(
 #define flecs_itoi16(value) flecs_ito(int16_t, (value))
 #define flecs_itoi32(value) flecs_ito(int32_t, (value))
 
+/* Hint to the CPU that memory at ptr will be read soon */
+#if defined(__GNUC__) || defined(__clang__)
+#define flecs_prefetch(ptr) __builtin_prefetch(ptr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define flecs_prefetch(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#else
+#define flecs_prefetch(ptr) (void)(ptr)
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Entity filter
 ////////////////////////////////////////////////////////////////////////////////
@@ -4028,9 +4261,16 @@ void flecs_move_entity(
     flecs_notify_on_remove(
         world, src_table, dst_table, src_row, 1, &diff->removed);
 
-    /* Copy entity & components from src_table to dst_table */
+    /* Copy entity & components from src_table to dst_table. If the tables
+     * were found by traversing a single edge, use the edge's move plan. */
+    ecs_table_move_plan_t *plan = NULL;
+    ecs_graph_edge_t *edge = diff->edge;
+    if (edge && (edge->from == src_table) && (edge->to == dst_table)) {
+        plan = flecs_table_edge_move_plan(world, edge);
+    }
+
     flecs_table_move(world, entity, entity, dst_table, dst_row, 
-        src_table, src_row, ctor);
+        src_table, src_row, ctor, plan);
 
     /* Update entity index & delete old data after running remove actions */
     record->table = dst_table;
@@ -4069,6 +4309,7 @@ void flecs_delete_entity(
 static
 void flecs_update_component_monitor_w_array(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_type_t *ids)
 {
     if (!ids) {
@@ -4079,22 +4320,24 @@ void flecs_update_component_monitor_w_array(
     for (i = 0; i < ids->count; i ++) {
         ecs_entity_t id = ids->array[i];
         if (ECS_HAS_ID_FLAG(id, PAIR)) {
-            flecs_monitor_mark_dirty(world, 
+            flecs_monitor_mark_dirty(world, entity,
                 ecs_pair(ECS_PAIR_FIRST(id), EcsWildcard));
+            flecs_id_record_trav_changed(world, ECS_PAIR_FIRST(id));
         }
 
-        flecs_monitor_mark_dirty(world, id);
+        flecs_monitor_mark_dirty(world, entity, id);
     }
 }
 
 static
 void flecs_update_component_monitors(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_type_t *added,
     ecs_type_t *removed)
 {
-    flecs_update_component_monitor_w_array(world, added);
-    flecs_update_component_monitor_w_array(world, removed);
+    flecs_update_component_monitor_w_array(world, entity, added);
+    flecs_update_component_monitor_w_array(world, entity, removed);
 }
 
 static
@@ -4132,7 +4375,7 @@ void flecs_commit(
 
     if (src_table) {
         ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecs_table_traversable_add(dst_table, is_trav);
+        flecs_table_traversable_add(world, dst_table, is_trav);
 
         if (dst_table->type.count) { 
             flecs_move_entity(world, entity, record, dst_table, diff, 
@@ -4142,9 +4385,9 @@ void flecs_commit(
             record->table = NULL;
         }
 
-        flecs_table_traversable_add(src_table, -is_trav);
+        flecs_table_traversable_add(world, src_table, -is_trav);
     } else {        
-        flecs_table_traversable_add(dst_table, is_trav);
+        flecs_table_traversable_add(world, dst_table, is_trav);
         if (dst_table->type.count) {
             flecs_new_entity(world, entity, record, dst_table, diff, 
                 construct, evt_flags);
@@ -4157,7 +4400,8 @@ void flecs_commit(
      * update the matched tables when the application adds or removes a 
      * component from, for example, a container. */
     if (is_trav) {
-        flecs_update_component_monitors(world, &diff->added, &diff->removed);
+        flecs_update_component_monitors(world, entity, 
+            &diff->added, &diff->removed);
     }
 
     if ((!src_table || !src_table->type.count) && world->range_check_enabled) {
@@ -4210,14 +4454,8 @@ const ecs_entity_t* flecs_bulk_new(
     int32_t row = flecs_table_appendn(world, table, data, count, entities);
 
     /* Update entity index. */
-    int i;
-    ecs_record_t **records = ecs_vec_first(&data->records);
-    for (i = 0; i < count; i ++) {
-        ecs_record_t *r = flecs_entities_get(world, entities[i]);
-        r->table = table;
-        r->row = ECS_ROW_TO_RECORD(row + i, 0);
-        records[row + i] = r;
-    }
+    ecs_record_t **records = ecs_vec_get_t(&data->records, ecs_record_t*, row);
+    flecs_entities_set_table(world, entities, count, table, row, records);
 
     flecs_defer_begin(world, &world->stages[0]);
     flecs_notify_on_add(world, table, NULL, row, count, &diff->added, 
@@ -4481,6 +4719,7 @@ void flecs_notify_on_set(
 }
 
 void flecs_record_add_flag(
+    ecs_world_t *world,
     ecs_record_t *record,
     uint32_t flag)
 {
@@ -4488,7 +4727,7 @@ void flecs_record_add_flag(
         if (!(record->row & flag)) {
             ecs_table_t *table = record->table;
             if (table) {
-                flecs_table_traversable_add(table, 1);
+                flecs_table_traversable_add(world, table, 1);
             }
         }
     }
@@ -4502,7 +4741,7 @@ void flecs_add_flag(
 {
     ecs_record_t *record = flecs_entities_get_any(world, entity);
     ecs_assert(record != NULL, ECS_INTERNAL_ERROR, NULL);
-    flecs_record_add_flag(record, flag);
+    flecs_record_add_flag(world, record, flag);
 }
 
 /* -- Public functions -- */
@@ -4585,11 +4824,10 @@ ecs_entity_t ecs_new_id(
          * sure OS API has threading functions initialized */
         ecs_assert(ecs_os_has_threading(), ECS_INVALID_OPERATION, NULL);
 
-        /* Can't atomically increase number above max int */
-        ecs_assert(flecs_entities_max_id(unsafe_world) < UINT_MAX, 
-            ECS_INVALID_OPERATION, NULL);
-        entity = (ecs_entity_t)ecs_os_ainc(
-            (int32_t*)&flecs_entities_max_id(unsafe_world));
+        /* Stages create ids from a reserved range, so that the merge can
+         * tell them apart from ids that were never created */
+        entity = flecs_stage_new_id(unsafe_world, 
+            ECS_CONST_CAST(ecs_stage_t*, stage));
     } else {
         entity = flecs_entities_new_id(unsafe_world);
     }
@@ -4605,6 +4843,16 @@ error:
     return 0;
 }
 
+ecs_entity_t flecs_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (world->flags & EcsWorldMultiThreaded) {
+        return ecs_new_id((ecs_world_t*)stage);
+    }
+    return ecs_new_id(world);
+}
+
 ecs_entity_t ecs_new_low_id(
     ecs_world_t *world)
 {
@@ -4651,7 +4899,7 @@ ecs_entity_t ecs_new_w_id(
     ecs_check(!id || ecs_id_is_valid(world, id), ECS_INVALID_PARAMETER, NULL);
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);    
-    ecs_entity_t entity = ecs_new_id(world);
+    ecs_entity_t entity = flecs_new_id(world, stage);
 
     ecs_id_t ids[3];
     ecs_type_t to_add = { .array = ids, .count = 0 };
@@ -4715,8 +4963,8 @@ ecs_entity_t ecs_new_w_table(
 {
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    flecs_stage_from_world(&world);    
-    ecs_entity_t entity = ecs_new_id(world);
+    ecs_stage_t *stage = flecs_stage_from_world(&world);    
+    ecs_entity_t entity = flecs_new_id(world, stage);
     ecs_record_t *r = flecs_entities_get(world, entity);
 
     ecs_table_diff_t table_diff = { .added = table->type };
@@ -5112,7 +5360,7 @@ ecs_entity_t ecs_entity_init(
             if (desc->use_low_id) {
                 result = ecs_new_low_id(world);
             } else {
-                result = ecs_new_id(world);
+                result = flecs_new_id(world, stage);
             }
             flecs_new_entity = true;
             ecs_assert(ecs_get_type(world, result) == NULL,
@@ -5274,6 +5522,8 @@ ecs_entity_t ecs_component_init(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_check(desc->_canary == 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(desc->type.alignment & (desc->type.alignment - 1)),
+        ECS_INVALID_COMPONENT_ALIGNMENT, "alignment must be a power of 2");
 
     /* If existing entity is provided, check if it is already registered as a
      * component and matches the size/alignment. This can prevent having to
@@ -5402,7 +5652,7 @@ void ecs_clear(
         r->table = NULL;
 
         if (r->row & EcsEntityIsTraversable) {
-            flecs_table_traversable_add(table, -1);
+            flecs_table_traversable_add(world, table, -1);
         }
     }    
 
@@ -5558,7 +5808,7 @@ void flecs_update_monitors_for_delete(
     ecs_world_t *world,
     ecs_id_t id)
 {
-    flecs_update_component_monitors(world, NULL, &(ecs_type_t){
+    flecs_update_component_monitors(world, 0, NULL, &(ecs_type_t){
         .array = (ecs_id_t[]){id},
         .count = 1
     });
@@ -5954,7 +6204,7 @@ void ecs_delete(
             if (row_flags & EcsEntityIsTraversable) {
                 table = r->table;
                 if (table) {
-                    flecs_table_traversable_add(table, -1);
+                    flecs_table_traversable_add(world, table, -1);
                 }
             }
             /* Merge operations before deleting entity */
@@ -6012,6 +6262,278 @@ error:
     return;
 }
 
+/* Move entities that are all stored in src_table to dst_table. OnAdd observers
+ * are notified once for the range of rows the entities are moved to. */
+static
+void flecs_commit_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_table_t *src_table,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff)
+{
+    ecs_assert(!(world->flags & EcsWorldReadonly), ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t dst_row = ecs_table_count(dst_table);
+    int32_t src_count = ecs_table_count(src_table);
+    bool is_trav = false;
+    int32_t i;
+
+    if (!src_table->type.count && world->range_check_enabled) {
+        /* Entities get their first components, check that they're in range */
+        for (i = 0; i < count; i ++) {
+            ecs_check(!world->info.max_id || 
+                entities[i] <= world->info.max_id, ECS_OUT_OF_RANGE, 0);
+            ecs_check(entities[i] >= world->info.min_id, 
+                ECS_OUT_OF_RANGE, 0);
+        }
+    }
+
+    if ((count == src_count) && !ecs_os_memcmp(entities, 
+        ecs_vec_first(&src_table->data.entities), 
+            ECS_SIZEOF(ecs_entity_t) * count))
+    {
+        /* Entities are all entities in the table, move storage of the entire
+         * table at once. */
+        for (i = 0; i < count; i ++) {
+            flecs_journal(world, EcsJournalMove, entities[i], 
+                &diff->added, &diff->removed);
+        }
+
+        flecs_notify_on_remove(
+            world, src_table, dst_table, 0, count, &diff->removed);
+        is_trav = src_table->_->traversable_count != 0;
+        flecs_table_move_all(world, dst_table, src_table);
+    } else {
+        ecs_table_move_plan_t *plan = NULL;
+        ecs_graph_edge_t *edge = diff->edge;
+        if (edge && (edge->from == src_table) && (edge->to == dst_table)) {
+            plan = flecs_table_edge_move_plan(world, edge);
+        }
+
+        flecs_table_set_size(world, dst_table, &dst_table->data, 
+            dst_row + count);
+
+        for (i = 0; i < count; i ++) {
+            ecs_entity_t e = entities[i];
+            ecs_record_t *r = flecs_entities_get(world, e);
+            if (r->table != src_table) {
+                /* Entity was already moved (it's in the array twice) */
+                continue;
+            }
+
+            flecs_journal(world, EcsJournalMove, e, 
+                &diff->added, &diff->removed);
+
+            int32_t src_row = ECS_RECORD_TO_ROW(r->row);
+            int32_t trav = (r->row & EcsEntityIsTraversable) != 0;
+            flecs_table_traversable_add(world, dst_table, trav);
+            is_trav |= trav;
+
+            int32_t row = flecs_table_append(world, dst_table, e, r, 
+                false, false);
+            flecs_notify_on_remove(
+                world, src_table, dst_table, src_row, 1, &diff->removed);
+            flecs_table_move(world, e, e, dst_table, row, 
+                src_table, src_row, true, plan);
+
+            r->table = dst_table;
+            r->row = ECS_ROW_TO_RECORD(row, r->row & ECS_ROW_FLAGS_MASK);
+            flecs_table_delete(world, src_table, src_row, false);
+            flecs_table_traversable_add(world, src_table, -trav);
+        }
+    }
+
+    /* Moved entities are stored in consecutive rows of the destination */
+    int32_t moved = ecs_table_count(dst_table) - dst_row;
+    if (moved) {
+        flecs_notify_on_add(world, dst_table, src_table, dst_row, moved, 
+            &diff->added, 0);
+        flecs_update_name_index(world, src_table, dst_table, dst_row, moved);
+    }
+
+    if (is_trav) {
+        /* Pass each traversable entity so that queries only rematch tables
+         * that traverse the moved entities. Observers may have modified the
+         * entities, so look up records instead of reading the moved rows. */
+        for (i = 0; i < count; i ++) {
+            ecs_record_t *r = flecs_entities_try(world, entities[i]);
+            if (r && (r->row & EcsEntityIsTraversable)) {
+                flecs_update_component_monitors(world, entities[i], 
+                    &diff->added, &diff->removed);
+            }
+        }
+    }
+error:
+    return;
+}
+
+/* Add or remove id for multiple entities. Entities are grouped by consecutive
+ * runs that are stored in the same table, which are moved together. */
+static
+void flecs_add_remove_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id,
+    bool add)
+{
+    int32_t i = 0;
+    while (i < count) {
+        ecs_record_t *r = flecs_entities_get(world, entities[i]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_table_t *src_table = r->table;
+
+        int32_t end = i + 1;
+        while ((end < count) && 
+            (flecs_entities_get(world, entities[end])->table == src_table))
+        {
+            end ++;
+        }
+
+        ecs_table_diff_t diff = ECS_TABLE_DIFF_INIT;
+        ecs_table_t *dst_table;
+        if (add) {
+            dst_table = flecs_table_traverse_add(world, src_table, &id, &diff);
+        } else {
+            dst_table = flecs_table_traverse_remove(
+                world, src_table, &id, &diff);
+        }
+
+        if (src_table && dst_table->type.count && (src_table != dst_table)) {
+            flecs_commit_n(world, &entities[i], end - i, src_table, 
+                dst_table, &diff);
+        } else if (!src_table || (src_table != dst_table) ||
+            (src_table->flags & EcsTableHasUnion))
+        {
+            /* Entities that don't have a table yet, lose all their components
+             * or for which a union relationship could have changed use the
+             * regular commit, which handles these cases. */
+            int32_t j;
+            for (j = i; j < end; j ++) {
+                ecs_entity_t e = entities[j];
+                r = flecs_entities_get(world, e);
+                ecs_table_diff_t e_diff = ECS_TABLE_DIFF_INIT;
+                if (add) {
+                    dst_table = flecs_table_traverse_add(
+                        world, r->table, &id, &e_diff);
+                } else {
+                    dst_table = flecs_table_traverse_remove(
+                        world, r->table, &id, &e_diff);
+                }
+                flecs_commit(world, e, r, dst_table, &e_diff, true, 0);
+            }
+        }
+
+        i = end;
+    }
+}
+
+static
+void flecs_add_remove_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id,
+    bool add)
+{
+    ecs_allocator_t *a = &it->real_world->allocator;
+
+    /* Collect entities first, as moving entities while iterating could cause
+     * the iterator to skip or revisit entities. */
+    ecs_vec_t entities;
+    ecs_vec_init_t(a, &entities, ecs_entity_t, 0);
+
+    while (ecs_iter_next(it)) {
+        if (it->count) {
+            ecs_os_memcpy_n(ecs_vec_grow_t(a, &entities, ecs_entity_t, 
+                it->count), it->entities, ecs_entity_t, it->count);
+        }
+    }
+
+    if (add) {
+        ecs_add_id_n(it->world, ecs_vec_first(&entities), 
+            ecs_vec_count(&entities), id);
+    } else {
+        ecs_remove_id_n(it->world, ecs_vec_first(&entities), 
+            ecs_vec_count(&entities), id);
+    }
+
+    ecs_vec_fini_t(a, &entities, ecs_entity_t);
+}
+
+void ecs_add_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || entities != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_id_is_valid(world, id), ECS_INVALID_PARAMETER, NULL);
+
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    if (flecs_defer_cmd(stage)) {
+        int32_t i;
+        for (i = 0; i < count; i ++) {
+            flecs_defer_add(stage, entities[i], id);
+        }
+        return;
+    }
+
+    flecs_add_remove_id_n(world, entities, count, id, true);
+    flecs_defer_end(world, stage);
+error:
+    return;
+}
+
+void ecs_remove_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || entities != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_id_is_valid(world, id) || ecs_id_is_wildcard(id), 
+        ECS_INVALID_PARAMETER, NULL);
+
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    if (flecs_defer_cmd(stage)) {
+        int32_t i;
+        for (i = 0; i < count; i ++) {
+            flecs_defer_remove(stage, entities[i], id);
+        }
+        return;
+    }
+
+    flecs_add_remove_id_n(world, entities, count, id, false);
+    flecs_defer_end(world, stage);
+error:
+    return;
+}
+
+void ecs_add_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_add_remove_id_w_iter(it, id, true);
+error:
+    return;
+}
+
+void ecs_remove_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_add_remove_id_w_iter(it, id, false);
+error:
+    return;
+}
+
 void ecs_override_id(
     ecs_world_t *world,
     ecs_entity_t entity,
@@ -6036,7 +6558,7 @@ ecs_entity_t ecs_clone(
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);
     if (!dst) {
-        dst = ecs_new_id(world);
+        dst = flecs_new_id(world, stage);
     }
 
     if (flecs_defer_clone(stage, dst, src, copy_value)) {
@@ -6058,7 +6580,7 @@ ecs_entity_t ecs_clone(
 
     if (copy_value) {
         flecs_table_move(world, dst, src, src_table,
-            row, src_table, ECS_RECORD_TO_ROW(src_r->row), true);
+            row, src_table, ECS_RECORD_TO_ROW(src_r->row), true, NULL);
         int32_t i, count = src_table->column_count;
         for (i = 0; i < count; i ++) {
             ecs_type_t type = {
@@ -6577,7 +7099,7 @@ ecs_entity_t ecs_set_id(
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
     if (!entity) {
-        entity = ecs_new_id(world);
+        entity = flecs_new_id(world, stage);
         ecs_entity_t scope = stage->scope;
         if (scope) {
             ecs_add_pair(world, entity, EcsChildOf, scope);
@@ -7876,6 +8398,118 @@ bool flecs_remove_invalid(
     return true;
 }
 
+/* Collect value of set command if it only writes a component that the entity
+ * already has, without running hooks or observers. The value is copied when
+ * the collected writes are flushed. */
+static
+bool flecs_cmd_collect_write(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    ecs_record_t *r = flecs_entities_get(world, cmd->entity);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_table_t *table = r->table;
+    if (!table) {
+        return false;
+    }
+
+    bool is_set = cmd->kind == EcsOpSet;
+    if (is_set && (table->flags & EcsTableHasOnSet)) {
+        return false;
+    }
+
+    const ecs_table_record_t *tr = flecs_table_record_get(
+        world, table, cmd->id);
+    if (!tr || (tr->column == -1)) {
+        return false;
+    }
+
+    const ecs_column_t *column = &table->data.columns[tr->column];
+    const ecs_type_info_t *ti = column->ti;
+    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (ti->hooks.move_dtor || (is_set && ti->hooks.on_set)) {
+        return false;
+    }
+
+    ecs_assert(cmd->is._1.size == column->size, ECS_INTERNAL_ERROR, NULL);
+    flecs_table_mark_dirty(world, table, cmd->id);
+    flecs_merge_writes_append(world, cmd->entity, r, tr->column, 
+        cmd->is._1.value, column->size);
+
+    return true;
+}
+
+/* Test if command runs without invoking hooks or observers, and without moving
+ * entities, so that collected writes don't have to be copied before it runs */
+static
+bool flecs_cmd_is_quiet(
+    ecs_world_t *world,
+    const ecs_cmd_t *cmd,
+    bool is_alive)
+{
+    switch(cmd->kind) {
+    case EcsOpSkip:
+        /* Discarded value could have a destructor */
+        return cmd->is._1.value == NULL;
+    case EcsOpModified: {
+        if (!is_alive) {
+            return true;
+        }
+
+        ecs_record_t *r = flecs_entities_get(world, cmd->entity);
+        ecs_table_t *table = r->table;
+        if (!table || (table->flags & EcsTableHasOnSet)) {
+            return false;
+        }
+
+        const ecs_table_record_t *tr = flecs_table_record_get(
+            world, table, cmd->id);
+        if (!tr || (tr->column == -1)) {
+            return false;
+        }
+
+        return table->data.columns[tr->column].ti->hooks.on_set == NULL;
+    }
+    case EcsOpAdd:
+    case EcsOpRemove:
+    case EcsOpSet:
+    case EcsOpEmplace:
+    case EcsOpMut:
+    case EcsOpAddModified:
+    case EcsOpClone:
+    case EcsOpBulkNew:
+    case EcsOpPath:
+    case EcsOpDelete:
+    case EcsOpClear:
+    case EcsOpOnDeleteAction:
+    case EcsOpEnable:
+    case EcsOpDisable:
+        break;
+    }
+
+    return false;
+}
+
+/* Test if moving an entity between tables runs hooks or observers */
+static
+bool flecs_cmd_move_has_actions(
+    const ecs_record_t *r,
+    const ecs_table_t *src,
+    const ecs_table_t *dst)
+{
+    ecs_flags32_t actions = EcsTableHasAddActions | EcsTableHasRemoveActions |
+        EcsTableHasMove;
+    if (src && (src->flags & actions)) {
+        return true;
+    }
+    if (dst && (dst->flags & actions)) {
+        return true;
+    }
+
+    /* Entity is used by relationships, moving it can update queries */
+    return r && ECS_RECORD_TO_ROW_FLAGS(r->row);
+}
+
 static
 void flecs_cmd_batch_for_entity(
     ecs_world_t *world,
@@ -7922,6 +8556,7 @@ void flecs_cmd_batch_for_entity(
             } else {
                 /* Id was no longer valid and had a Delete policy */
                 cmd->kind = EcsOpSkip;
+                flecs_merge_writes_flush(world);
                 ecs_delete(world, entity);
                 flecs_table_diff_builder_clear(diff);
                 return;
@@ -7955,6 +8590,7 @@ void flecs_cmd_batch_for_entity(
                     const ecs_type_info_t *ti = ptr.ti;
                     ecs_iter_action_t on_set;
                     if ((on_set = ti->hooks.on_set)) {
+                        flecs_merge_writes_flush(world);
                         flecs_invoke_hook(world, start_table, 1, row, &entity,
                             ptr.ptr, cmd->id, ptr.ti, EcsOnSet, on_set);
                     }
@@ -8003,6 +8639,12 @@ void flecs_cmd_batch_for_entity(
         }
     } while ((cur = next_for_entity));
 
+    /* Values of collected writes must be copied before running code that
+     * could read them */
+    if (flecs_cmd_move_has_actions(r, start_table, table)) {
+        flecs_merge_writes_flush(world);
+    }
+
     /* Move entity to destination table in single operation */
     flecs_table_diff_build_noalloc(diff, &table_diff);
     flecs_defer_begin(world, &world->stages[0]);
@@ -8099,10 +8741,24 @@ bool flecs_defer_end(
             flecs_table_diff_builder_init(world, &diff);
             flecs_sparse_clear(&stage->cmd_entries);
 
+            /* Collect plain component writes while stages are merged */
+            bool collect_writes = merge_to_world && 
+                world->merge_writes.collect;
+
             for (i = 0; i < count; i ++) {
                 ecs_cmd_t *cmd = &cmds[i];
                 ecs_entity_t e = cmd->entity;
                 bool is_alive = flecs_entities_is_alive(world, e);
+                if (!is_alive && e && !flecs_entities_exists(world, e) &&
+                    flecs_stage_owns_id(stage, e)) 
+                {
+                    /* Entity was created by this stage while multithreaded.
+                     * The id is reserved but the entity doesn't have a record 
+                     * yet, so publish it before applying its commands. Other
+                     * ids that were never created are discarded. */
+                    flecs_entities_ensure(world, e);
+                    is_alive = true;
+                }
 
                 /* A negative index indicates the first command for an entity */
                 if (merge_to_world && (cmd->next_for_entity < 0)) {
@@ -8114,10 +8770,29 @@ bool flecs_defer_end(
                     }
                 }
 
+                ecs_cmd_kind_t kind = cmd->kind;
+                if (collect_writes) {
+                    if ((kind == EcsOpSet || kind == EcsOpMut) && is_alive &&
+                        flecs_cmd_collect_write(world, cmd))
+                    {
+                        if (kind == EcsOpSet) {
+                            world->info.cmd.set_count ++;
+                        } else {
+                            world->info.cmd.get_mut_count ++;
+                        }
+                        continue;
+                    }
+
+                    /* Other commands can run hooks and observers, or move
+                     * entities with collected writes to another table */
+                    if (!flecs_cmd_is_quiet(world, cmd, is_alive)) {
+                        flecs_merge_writes_flush(world);
+                    }
+                }
+
                 /* If entity is no longer alive, this could be because the queue
                  * contained both a delete and a subsequent add/remove/set which
                  * should be ignored. */
-                ecs_cmd_kind_t kind = cmd->kind;
                 if ((kind != EcsOpPath) && ((kind == EcsOpSkip) || (e && !is_alive))) {
                     world->info.cmd.discard_count ++;
                     flecs_discard_cmd(world, cmd);
@@ -8224,6 +8899,11 @@ bool flecs_defer_end(
                 }
             }
 
+            /* Values of collected writes are stored in the defer stack */
+            if (collect_writes) {
+                flecs_merge_writes_flush(world);
+            }
+
             ecs_vec_fini_t(&stage->allocator, &stage->commands, ecs_cmd_t);
 
             /* Restore defer queue */
@@ -13727,6 +14407,151 @@ error:
     return false;
 }
 
+static
+void flecs_worker_chunk_iter_fini(
+    ecs_iter_t *it)
+{
+    ecs_worker_chunk_iter_t *iter = &it->priv.iter.worker_chunk;
+    if (iter->ptrs) {
+        ecs_os_free(iter->ptrs);
+        iter->ptrs = NULL;
+        it->ptrs = NULL;
+    }
+
+    if (it->chain_it) {
+        ecs_chained_iter_fini(it);
+    }
+}
+
+ecs_iter_t ecs_worker_chunk_iter(
+    const ecs_iter_t *it,
+    int32_t *claimed,
+    int32_t chunk_size)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(claimed != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunk_size > 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_os_has_threading(), ECS_MISSING_OS_API, NULL);
+
+    ecs_iter_t result = *it;
+    result.priv.cache.stack_cursor = NULL; /* Don't copy allocator cursor */
+
+    result.priv.iter.worker_chunk = (ecs_worker_chunk_iter_t){
+        .claimed = claimed,
+        .chunk_size = chunk_size
+    };
+    result.next = ecs_worker_chunk_next;
+    result.fini = flecs_worker_chunk_iter_fini;
+    result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
+
+    return result;
+error:
+    return (ecs_iter_t){ 0 };
+}
+
+static
+bool ecs_worker_chunk_next_instanced(
+    ecs_iter_t *it)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_worker_chunk_next, ECS_INVALID_PARAMETER, NULL);
+
+    bool instanced = ECS_BIT_IS_SET(it->flags, EcsIterIsInstanced);
+
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_chunk_iter_t *iter = &it->priv.iter.worker_chunk;
+    int32_t chunk_size = iter->chunk_size;
+
+    /* Claim the next chunk. Claims only ever increase, so chunks that were
+     * claimed by other workers can be skipped by moving forward through the
+     * results of the chained iterator. */
+    int32_t claim = ecs_os_ainc(iter->claimed) - 1;
+
+    while (claim >= (iter->first_chunk + iter->chunk_count)) {
+        iter->first_chunk += iter->chunk_count;
+        iter->chunk_count = 0;
+
+        if (!ecs_iter_next(chain_it)) {
+            if (iter->ptrs) {
+                ecs_os_free(iter->ptrs);
+                iter->ptrs = NULL;
+                it->ptrs = NULL;
+            }
+            return false;
+        }
+
+        if (!chain_it->table) {
+            /* Results without a table can't be split */
+            iter->chunk_count = 1;
+        } else {
+            iter->chunk_count = (chain_it->count + chunk_size - 1) / chunk_size;
+        }
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv));
+
+    /* Keep instancing setting from original iterator */
+    ECS_BIT_COND(it->flags, EcsIterIsInstanced, instanced);
+
+    if (!it->table) {
+        return true;
+    }
+
+    int32_t first = (claim - iter->first_chunk) * chunk_size;
+    int32_t count = it->count - first;
+    if (count > chunk_size) {
+        count = chunk_size;
+    }
+
+    it->frame_offset += first;
+
+    /* Field pointers are advanced in place while iterating the rows of a 
+     * non-instanced result, so each chunk gets its own copy of the pointers 
+     * of the chained iterator before offsetting them. */
+    if (chain_it->ptrs && it->field_count) {
+        if (!iter->ptrs) {
+            iter->ptrs = ecs_os_malloc_n(void*, it->field_count);
+        }
+        ecs_os_memcpy_n(iter->ptrs, chain_it->ptrs, void*, it->field_count);
+        it->ptrs = iter->ptrs;
+    }
+
+    flecs_offset_iter(it, it->offset + first);
+    it->count = count;
+
+    if (ECS_BIT_IS_SET(it->flags, EcsIterIsInstanced)) {
+        it->offset += first;
+    } else {
+        it->offset = 0;
+    }
+
+    return true;
+error:
+    return false;
+}
+
+bool ecs_worker_chunk_next(
+    ecs_iter_t *it)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_worker_chunk_next, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ECS_BIT_SET(it->chain_it->flags, EcsIterIsInstanced);
+
+    if (flecs_iter_next_row(it)) {
+        return true;
+    }
+
+    return flecs_iter_next_instanced(it, 
+        ecs_worker_chunk_next_instanced(it));
+error:
+    return false;
+}
+
 /**
  * @file misc.c
  * @brief Miscallaneous functions.
@@ -16832,6 +17657,13 @@ bool ecs_os_has_heap(void) {
         (ecs_os_api.free_ != NULL);
 }
 
+bool ecs_os_has_page_alloc(void) {
+    return
+        (ecs_os_api.page_alloc_ != NULL) &&
+        (ecs_os_api.page_realloc_ != NULL) &&
+        (ecs_os_api.page_free_ != NULL);
+}
+
 bool ecs_os_has_threading(void) {
     return
         (ecs_os_api.mutex_new_ != NULL) &&
@@ -16863,6 +17695,14 @@ bool ecs_os_has_task_support(void) {
         (ecs_os_api.task_join_ != NULL);
 }
 
+bool ecs_os_has_futex(void) {
+    return
+        (ecs_os_api.ainc_ != NULL) &&
+        (ecs_os_api.adec_ != NULL) &&
+        (ecs_os_api.futex_wait_ != NULL) &&
+        (ecs_os_api.futex_wake_ != NULL);
+}
+
 bool ecs_os_has_time(void) {
     return 
         (ecs_os_api.get_time_ != NULL) &&
@@ -18044,10 +18884,10 @@ void flecs_query_set_table_match(
             table, qm->ids, qm->columns);
 
         if (qm->entity_filter) {
-            query->flags &= ~EcsQueryTrivialIter;
+            query->flags &= ~(EcsQueryTrivialIter|EcsQueryCompiledIter);
         }
         if (table->flags & EcsTableHasUnion) {
-            query->flags &= ~EcsQueryTrivialIter;
+            query->flags &= ~(EcsQueryTrivialIter|EcsQueryCompiledIter);
         }
     }
 
@@ -18729,6 +19569,95 @@ void flecs_query_unmatch_table(
     }
 }
 
+/* Rematch a single table. Existing matches are updated in place, so that
+ * matches that don't change keep their position in the iteration list. */
+static
+void flecs_query_rematch_table(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_table_t *table,
+    int32_t var_id,
+    int32_t rematch_count)
+{
+    ecs_query_table_t *qt = ecs_table_cache_get(&query->cache, table);
+    ecs_query_table_match_t *qm = NULL;
+
+    ecs_iter_t it = flecs_filter_iter_w_flags(world, &query->filter, 
+        EcsIterMatchVar|EcsIterIsInstanced|EcsIterNoData|
+        EcsIterEntityOptional);
+    ecs_iter_set_var_as_table(&it, var_id, table);
+
+    while (ecs_filter_next(&it)) {
+        ecs_assert(it.table == table, ECS_INTERNAL_ERROR, NULL);
+        if (!qt) {
+            qt = flecs_query_table_insert(world, query, table);
+        }
+
+        if (!qm) {
+            qm = qt->first;
+        } else {
+            qm = qm->next_match;
+        }
+        if (!qm) {
+            qm = flecs_query_add_table_match(query, qt, table);
+        }
+
+        flecs_query_set_table_match(world, query, qm, table, &it);
+
+        if (ecs_table_count(table) && query->group_by) {
+            if (flecs_query_get_group_id(query, table) != qm->group_id) {
+                /* Update table group */
+                flecs_query_remove_table_node(query, qm);
+                flecs_query_insert_table_node(query, qm);
+            }
+        }
+    }
+
+    if (!qm) {
+        /* Table no longer matches */
+        if (qt) {
+            flecs_query_unmatch_table(query, table, qt);
+        }
+        return;
+    }
+
+    if (qm->next_match) {
+        flecs_query_table_match_free(query, qt, qm->next_match);
+        qm->next_match = NULL;
+    }
+
+    qt->rematch_count = rematch_count;
+}
+
+/* Test whether query can be rematched for the tables collected by the 
+ * component monitors, instead of with all tables. This requires that all terms
+ * match the This variable, as changes to other sources aren't tracked. */
+static
+int32_t flecs_query_rematch_var(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_query_t *parent_query)
+{
+    if (parent_query || world->monitors.rematch_all) {
+        return -1;
+    }
+
+    ecs_filter_t *filter = &query->filter;
+    int32_t var_id = ecs_filter_find_this_var(filter);
+    if (var_id == -1) {
+        return -1;
+    }
+
+    int32_t i, count = filter->term_count;
+    for (i = 0; i < count; i ++) {
+        if (!ecs_term_match_this(&filter->terms[i])) {
+            return -1;
+        }
+    }
+
+    return var_id;
+}
+
 /* Rematch system with tables after a change happened to a watched entity */
 static
 void flecs_query_rematch_tables(
@@ -18747,6 +19676,26 @@ void flecs_query_rematch_tables(
 
     query->monitor_generation = world->monitor_generation;
 
+    world->info.rematch_count_total ++;
+    int32_t rematch_count = ++ query->rematch_count;
+
+    ecs_time_t t = {0};
+    if (world->flags & EcsWorldMeasureFrameTime) {
+        ecs_time_measure(&t);
+    }
+
+    int32_t var_id = flecs_query_rematch_var(world, query, parent_query);
+    if (var_id != -1) {
+        /* Only rematch tables that traverse one of the changed entities */
+        int32_t i, count = ecs_vec_count(&world->monitors.tables);
+        ecs_table_t **tables = ecs_vec_first(&world->monitors.tables);
+        for (i = 0; i < count; i ++) {
+            flecs_query_rematch_table(
+                world, query, tables[i], var_id, rematch_count);
+        }
+        goto done;
+    }
+
     if (parent_query) {
         parent_it = ecs_query_iter(world, parent_query);
         it = ecs_filter_chain_iter(&parent_it, &query->filter);
@@ -18758,14 +19707,6 @@ void flecs_query_rematch_tables(
     ECS_BIT_SET(it.flags, EcsIterNoData);
     ECS_BIT_SET(it.flags, EcsIterEntityOptional);
 
-    world->info.rematch_count_total ++;
-    int32_t rematch_count = ++ query->rematch_count;
-
-    ecs_time_t t = {0};
-    if (world->flags & EcsWorldMeasureFrameTime) {
-        ecs_time_measure(&t);
-    }
-
     while (ecs_filter_next(&it)) {
         if ((table != it.table) || (!it.table && !qt)) {
             if (qm && qm->next_match) {
@@ -18819,6 +19760,7 @@ void flecs_query_rematch_tables(
         }
     }
 
+done:
     if (world->flags & EcsWorldMeasureFrameTime) {
         world->info.rematch_time_total += (ecs_ftime_t)ecs_time_measure(&t);
     }
@@ -18929,7 +19871,7 @@ void flecs_query_order_by(
         flecs_query_build_sorted_tables(query);
     }
 
-    query->flags &= ~EcsQueryTrivialIter;
+    query->flags &= ~(EcsQueryTrivialIter|EcsQueryCompiledIter);
 error:
     return;
 }
@@ -19139,6 +20081,47 @@ void flecs_query_fini(
     ecs_poly_free(query, ecs_query_t);
 }
 
+/* Compile iteration plan for trivial queries with only And terms. For matches
+ * without refs all fields are owned by the table, so iteration can go straight
+ * to the table columns of the fields that have data or are written. */
+static
+void flecs_query_compile(
+    ecs_query_t *query)
+{
+    ecs_filter_t *filter = &query->filter;
+    ecs_query_plan_t *plan = &query->plan;
+    int32_t i, count = filter->term_count;
+
+    if (!(query->flags & EcsQueryTrivialIter)) {
+        return;
+    }
+    if (count != filter->field_count || count > FLECS_TERM_DESC_MAX) {
+        return;
+    }
+
+    plan->data_count = 0;
+    plan->out_count = 0;
+
+    for (i = 0; i < count; i ++) {
+        ecs_term_t *term = &filter->terms[i];
+        if (term->oper != EcsAnd || ecs_id_is_wildcard(term->id)) {
+            return;
+        }
+
+        ecs_inout_kind_t inout = term->inout;
+        if (!filter->sizes[i] || inout == EcsInOutNone) {
+            continue;
+        }
+
+        plan->data_fields[plan->data_count ++] = flecs_ito(int8_t, i);
+        if (inout != EcsIn) {
+            plan->out_fields[plan->out_count ++] = flecs_ito(int8_t, i);
+        }
+    }
+
+    query->flags |= EcsQueryCompiledIter;
+}
+
 /* -- Public API -- */
 
 ecs_query_t* ecs_query_init(
@@ -19164,6 +20147,8 @@ ecs_query_t* ecs_query_init(
 
     ECS_BIT_COND(result->flags, EcsQueryTrivialIter, 
         !!(result->filter.flags & EcsFilterMatchOnlyThis));
+    ECS_BIT_COND(result->flags, EcsQueryPrefetch, desc->prefetch);
+    flecs_query_compile(result);
 
     flecs_query_allocators_init(result);
 
@@ -19509,6 +20494,24 @@ void flecs_query_mark_columns_dirty(
 {
     ecs_table_t *table = qm->table;
     ecs_filter_t *filter = &query->filter;
+
+    if ((query->flags & EcsQueryCompiledIter) && !ecs_vec_count(&qm->refs)) {
+        /* All written fields are owned by the table, mark their columns dirty
+         * without looking up the column for each term. */
+        int32_t *dirty_state = table->dirty_state;
+        if (dirty_state) {
+            const ecs_query_plan_t *plan = &query->plan;
+            const int32_t *storage_columns = qm->storage_columns;
+            int32_t i, count = plan->out_count;
+            for (i = 0; i < count; i ++) {
+                int32_t column = storage_columns[plan->out_fields[i]];
+                ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+                dirty_state[column + 1] ++;
+            }
+        }
+        return;
+    }
+
     if ((table && table->dirty_state) || (query->flags & EcsQueryHasNonThisOutTerms)) {
         ecs_term_t *terms = filter->terms;
         int32_t i, count = filter->term_count;
@@ -19589,6 +20592,7 @@ error:
 static
 void flecs_query_populate_trivial(
     ecs_iter_t *it,
+    const ecs_query_t *query,
     ecs_query_table_match_t *match)
 {;
     ecs_table_t *table = match->table;
@@ -19609,8 +20613,29 @@ void flecs_query_populate_trivial(
     it->references = ecs_vec_first(&match->refs);
 
     if (!it->references) {
+        /* All fields are owned by the table. Clear the flag in case it was set
+         * by a previous match with shared fields, so that the table isn't
+         * iterated one entity at a time. */
+        ECS_BIT_CLEAR(it->flags, EcsIterHasShared);
+
         ecs_data_t *data = &table->data;
-        if (!(it->flags & EcsIterNoData)) {
+        if (it->flags & EcsIterNoData) {
+            /* No component data requested */
+        } else if (query->flags & EcsQueryCompiledIter) {
+            /* Only visit fields with data. Fields without data never get a
+             * pointer assigned, so they remain NULL. */
+            const ecs_query_plan_t *plan = &query->plan;
+            const int32_t *storage_columns = match->storage_columns;
+            ecs_column_t *columns = data->columns;
+            int32_t i, data_count = plan->data_count;
+            for (i = 0; i < data_count; i ++) {
+                int8_t field = plan->data_fields[i];
+                int32_t column = storage_columns[field];
+                ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+                it->ptrs[field] = ECS_ELEM(columns[column].data.array,
+                    it->sizes[field], offset);
+            }
+        } else {
             int32_t i;
             for (i = 0; i < it->field_count; i ++) {
                 int32_t column = match->storage_columns[i];
@@ -19632,13 +20657,45 @@ void flecs_query_populate_trivial(
 
         it->frame_offset += it->table ? ecs_table_count(it->table) : 0;
         it->table = table;
-        it->entities = ecs_vec_get_t(&data->entities, ecs_entity_t, offset);
+        it->entities = ECS_ELEM_T(data->entities.array, ecs_entity_t, offset);
     } else {
         flecs_iter_populate_data(
             it->real_world, it, table, offset, count, it->ptrs);
     }
 }
 
+/* Prefetch the entity array and columns of the next match, so that they are
+ * (partially) loaded by the time the application finishes the current table. */
+static
+void flecs_query_prefetch(
+    const ecs_iter_t *it,
+    const ecs_query_table_match_t *next,
+    const ecs_query_table_match_t *last)
+{
+    if (next == last) {
+        return;
+    }
+
+    flecs_prefetch(next->next);
+
+    ecs_table_t *table = next->table;
+    flecs_prefetch(table->data.entities.array);
+
+    if (it->flags & EcsIterNoData) {
+        return;
+    }
+
+    const int32_t *storage_columns = next->storage_columns;
+    ecs_column_t *columns = table->data.columns;
+    int32_t i, count = it->field_count;
+    for (i = 0; i < count; i ++) {
+        int32_t column = storage_columns[i];
+        if (column >= 0) {
+            flecs_prefetch(columns[column].data.array);
+        }
+    }
+}
+
 int ecs_query_populate(
     ecs_iter_t *it,
     bool when_changed)
@@ -19653,7 +20710,7 @@ int ecs_query_populate(
     ecs_query_table_match_t *match = iter->prev;
     ecs_assert(match != NULL, ECS_INVALID_OPERATION, NULL);
     if (query->flags & EcsQueryTrivialIter) {
-        flecs_query_populate_trivial(it, match);
+        flecs_query_populate_trivial(it, query, match);
         return EcsIterNextYield;
     }
 
@@ -19777,7 +20834,10 @@ bool ecs_query_next_instanced(
         }
         iter->node = cur->next;
         iter->prev = cur;
-        flecs_query_populate_trivial(it, cur);
+        if (flags & EcsQueryPrefetch) {
+            flecs_query_prefetch(it, cur->next, last);
+        }
+        flecs_query_populate_trivial(it, query, cur);
         return true;
     }
 
@@ -20336,6 +21396,16 @@ int32_t flecs_relation_depth(
  */
 
 
+/* Min and max number of entity ids a stage reserves at a time */
+#define FLECS_STAGE_ID_BLOCK_MIN (64)
+#define FLECS_STAGE_ID_BLOCK_MAX (4096)
+
+/* Min number of collected writes for which worker threads are used */
+#define FLECS_MERGE_WRITES_PAR_MIN (1024)
+
+/* Number of consecutive entity ids (as bits) assigned to the same shard */
+#define FLECS_MERGE_WRITES_SHARD_BITS (6)
+
 static
 ecs_cmd_t* flecs_cmd_alloc(
     ecs_stage_t *stage)
@@ -20393,6 +21463,133 @@ ecs_cmd_t* flecs_cmd_new(
     return flecs_cmd_alloc(stage);
 }
 
+void flecs_merge_writes_append(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_record_t *record,
+    int32_t column,
+    void *src,
+    ecs_size_t size)
+{
+    ecs_merge_writes_t *writes = &world->merge_writes;
+    int32_t i, shard_count = world->stage_count;
+    if (writes->shard_count != shard_count) {
+        ecs_assert(!writes->count, ECS_INTERNAL_ERROR, NULL);
+        flecs_merge_writes_fini(world);
+        writes->shards = flecs_alloc_n(
+            &world->allocator, ecs_vec_t, shard_count);
+        for (i = 0; i < shard_count; i ++) {
+            ecs_vec_init_t(NULL, &writes->shards[i], ecs_merge_write_t, 0);
+        }
+        writes->shard_count = shard_count;
+    }
+
+    uint32_t shard = (uint32_t)entity >> FLECS_MERGE_WRITES_SHARD_BITS;
+    shard %= flecs_ito(uint32_t, shard_count);
+
+    ecs_merge_write_t *w = ecs_vec_append_t(&world->allocator, 
+        &writes->shards[shard], ecs_merge_write_t);
+    w->record = record;
+    w->column = column;
+    w->size = size;
+    w->src = src;
+    writes->count ++;
+}
+
+static
+void flecs_merge_writes_apply(
+    ecs_vec_t *shard)
+{
+    ecs_merge_write_t *writes = ecs_vec_first_t(shard, ecs_merge_write_t);
+    int32_t i, count = ecs_vec_count(shard);
+    for (i = 0; i < count; i ++) {
+        ecs_merge_write_t *w = &writes[i];
+        ecs_table_t *table = w->record->table;
+        ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(w->column < table->column_count, ECS_INTERNAL_ERROR, NULL);
+        void *dst = ecs_vec_get(&table->data.columns[w->column].data, 
+            w->size, ECS_RECORD_TO_ROW(w->record->row));
+        ecs_os_memcpy(dst, w->src, w->size);
+    }
+}
+
+#ifdef FLECS_PIPELINE
+/* Each thread applies the writes of the shard with the same index as its stage.
+ * Shards don't share entities, so threads never write the same component. The
+ * storage isn't modified while writes are applied, so looking up destinations
+ * from multiple threads is safe. */
+static
+void flecs_merge_writes_run(
+    ecs_stage_t *stage,
+    void *ctx)
+{
+    ecs_merge_writes_t *writes = ctx;
+    ecs_assert(stage->id < writes->shard_count, ECS_INTERNAL_ERROR, NULL);
+    flecs_merge_writes_apply(&writes->shards[stage->id]);
+}
+#endif
+
+void flecs_merge_writes_flush(
+    ecs_world_t *world)
+{
+    ecs_merge_writes_t *writes = &world->merge_writes;
+    if (!writes->count) {
+        return;
+    }
+
+    ecs_assert(writes->shard_count == world->stage_count, 
+        ECS_INTERNAL_ERROR, NULL);
+
+    bool applied = false;
+#ifdef FLECS_PIPELINE
+    if (writes->count >= FLECS_MERGE_WRITES_PAR_MIN) {
+        applied = flecs_workers_run(world, flecs_merge_writes_run, writes);
+        if (applied) {
+            world->info.cmd.parallel_set_count += writes->count;
+        }
+    }
+#endif
+
+    int32_t i, s;
+    for (s = 0; s < writes->shard_count; s ++) {
+        ecs_vec_t *shard = &writes->shards[s];
+        if (!applied) {
+            flecs_merge_writes_apply(shard);
+        }
+
+        ecs_merge_write_t *w = ecs_vec_first_t(shard, ecs_merge_write_t);
+        int32_t count = ecs_vec_count(shard);
+        for (i = 0; i < count; i ++) {
+            flecs_stack_free(w[i].src, w[i].size);
+        }
+
+        ecs_vec_clear(shard);
+    }
+
+    writes->count = 0;
+}
+
+void flecs_merge_writes_fini(
+    ecs_world_t *world)
+{
+    ecs_merge_writes_t *writes = &world->merge_writes;
+    ecs_assert(!writes->count, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t i;
+    for (i = 0; i < writes->shard_count; i ++) {
+        ecs_vec_fini_t(&world->allocator, &writes->shards[i], 
+            ecs_merge_write_t);
+    }
+
+    if (writes->shards) {
+        flecs_free_n(&world->allocator, ecs_vec_t, writes->shard_count, 
+            writes->shards);
+    }
+
+    writes->shards = NULL;
+    writes->shard_count = 0;
+}
+
 static
 void flecs_stages_merge(
     ecs_world_t *world,
@@ -20420,18 +21617,34 @@ void flecs_stages_merge(
             ecs_assert(stage->defer == 1, ECS_INVALID_OPERATION, 
                 "mismatching defer_begin/defer_end detected");
             flecs_defer_end(world, stage);
+            ecs_vec_clear(&stage->id_ranges);
         }
     } else {
-        /* Merge stages. Only merge if the stage has auto_merging turned on, or 
-         * if this is a forced merge (like when ecs_merge is called) */
+        /* Merge stages. Only merge if the stage has auto_merging turned on, or
+         * if this is a forced merge (like when ecs_merge is called)
+         *
+         * Stages are merged one after another, in stage order. Applying a
+         * command can run hooks and observers, create tables and graph edges,
+         * and enqueue new commands, so those commands are applied serially.
+         * Set commands that only write the value of a component the entity
+         * already has are collected instead, and copied by the worker threads
+         * before anything that could observe the values runs, or before the
+         * entity is moved. This keeps the result the same as that of a serial
+         * merge. */
         int32_t i, count = ecs_get_stage_count(world);
+        world->merge_writes.collect = count > 1;
         for (i = 0; i < count; i ++) {
             ecs_stage_t *s = (ecs_stage_t*)ecs_get_stage(world, i);
             ecs_poly_assert(s, ecs_stage_t);
             if (force_merge || s->auto_merge) {
                 flecs_defer_end(world, s);
+
+                /* Ids reserved by the stage that weren't published by its
+                 * commands are no longer treated as created */
+                ecs_vec_clear(&s->id_ranges);
             }
         }
+        world->merge_writes.collect = false;
     }
 
     flecs_eval_component_monitors(world);
@@ -20614,10 +21827,10 @@ bool flecs_defer_bulk_new(
     if (flecs_defer_cmd(stage)) {
         ecs_entity_t *ids = ecs_os_malloc(count * ECS_SIZEOF(ecs_entity_t));
 
-        /* Use ecs_new_id as this is thread safe */
+        /* Use flecs_new_id as this is thread safe */
         int i;
         for (i = 0; i < count; i ++) {
-            ids[i] = ecs_new_id(world);
+            ids[i] = flecs_new_id(world, stage);
         }
 
         *ids_out = ids;
@@ -20731,10 +21944,11 @@ void* flecs_defer_set(
     void *existing = NULL;
     ecs_table_t *table = NULL;
     if (idr) {
-        /* Entity can only have existing component if id record exists */
-        ecs_record_t *r = flecs_entities_get(world, entity);
-        table = r->table;
-        if (r && table) {
+        /* Entity can only have existing component if id record exists. The
+         * entity may not exist yet if it was created while multithreaded. */
+        ecs_record_t *r = flecs_entities_try(world, entity);
+        table = r ? r->table : NULL;
+        if (table) {
             const ecs_table_record_t *tr = flecs_id_record_get_table(
                 idr, table);
             if (tr) {
@@ -20852,6 +22066,93 @@ error:
     return NULL;
 }
 
+/* Add range to ids reserved by stage. Ranges are added in increasing order, as
+ * the max id of the entity index only increases. */
+static
+void flecs_stage_add_id_range(
+    ecs_stage_t *stage,
+    ecs_entity_t first,
+    ecs_entity_t end)
+{
+    ecs_vec_t *ranges = &stage->id_ranges;
+    if (ecs_vec_count(ranges)) {
+        ecs_entity_t *last_end = ecs_vec_last_t(ranges, ecs_entity_t);
+        if (last_end[0] == first) {
+            last_end[0] = end;
+            return;
+        }
+    }
+
+    ecs_entity_t *range = ecs_vec_grow_t(
+        &stage->allocator, ranges, ecs_entity_t, 2);
+    range[0] = first;
+    range[1] = end;
+}
+
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (stage->async || !ecs_os_api.aadd_) {
+        /* Can't atomically increase number above max int */
+        ecs_assert(flecs_entities_max_id(world) < UINT_MAX, 
+            ECS_INVALID_OPERATION, NULL);
+        ecs_entity_t entity = (ecs_entity_t)ecs_os_ainc(
+            (int32_t*)&flecs_entities_max_id(world));
+        flecs_stage_add_id_range(stage, entity, entity + 1);
+        return entity;
+    }
+
+    if (stage->id_next == stage->id_end) {
+        /* Reserve ids in blocks so threads don't contend on the max id for
+         * each new entity. Double the block size while the stage keeps creating
+         * entities, until the ids are released at the end of readonly mode. */
+        int32_t count = stage->id_block_size;
+        stage->id_next = flecs_entities_reserve_ids(world, count);
+        stage->id_end = stage->id_next + (uint64_t)count;
+        flecs_stage_add_id_range(stage, stage->id_next, stage->id_end);
+        if (count < FLECS_STAGE_ID_BLOCK_MAX) {
+            stage->id_block_size = count * 2;
+        }
+    }
+
+    return stage->id_next ++;
+}
+
+bool flecs_stage_owns_id(
+    const ecs_stage_t *stage,
+    ecs_entity_t id)
+{
+    const ecs_entity_t *ranges = ecs_vec_first_t(
+        &stage->id_ranges, ecs_entity_t);
+    int32_t lo = 0, hi = ecs_vec_count(&stage->id_ranges) / 2;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (id < ranges[mid * 2]) {
+            hi = mid;
+        } else if (id >= ranges[mid * 2 + 1]) {
+            lo = mid + 1;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+void flecs_stage_release_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (stage->id_next != stage->id_end) {
+        flecs_entities_release_ids(world, stage->id_next, 
+            (int32_t)(stage->id_end - stage->id_next));
+    }
+
+    stage->id_next = 0;
+    stage->id_end = 0;
+    stage->id_block_size = FLECS_STAGE_ID_BLOCK_MIN;
+}
+
 void flecs_stage_merge_post_frame(
     ecs_world_t *world,
     ecs_stage_t *stage)
@@ -20877,6 +22178,7 @@ void flecs_stage_init(
     stage->thread_ctx = world;
     stage->auto_merge = true;
     stage->async = false;
+    stage->id_block_size = FLECS_STAGE_ID_BLOCK_MIN;
 
     flecs_stack_init(&stage->defer_stack);
     flecs_stack_init(&stage->allocators.iter_stack);
@@ -20885,6 +22187,10 @@ void flecs_stage_init(
     flecs_ballocator_init_n(&stage->allocators.cmd_entry_chunk, ecs_cmd_entry_t,
         FLECS_SPARSE_PAGE_SIZE);
 
+    /* Allocators of stages used by different threads share free memory */
+    stage->allocator.depot = world->stage_depot;
+    stage->allocators.cmd_entry_chunk.depot = world->stage_depot;
+
     ecs_allocator_t *a = &stage->allocator;
     ecs_vec_init_t(a, &stage->commands, ecs_cmd_t, 0);
     ecs_vec_init_t(a, &stage->post_frame_actions, ecs_action_elem_t, 0);
@@ -20910,6 +22216,7 @@ void flecs_stage_fini(
     ecs_allocator_t *a = &stage->allocator;
     ecs_vec_fini_t(a, &stage->commands, ecs_cmd_t);
     ecs_vec_fini_t(a, &stage->post_frame_actions, ecs_action_elem_t);
+    ecs_vec_fini_t(a, &stage->id_ranges, ecs_entity_t);
     ecs_vec_fini(NULL, &stage->variables, 0);
     ecs_vec_fini(NULL, &stage->operations, 0);
     flecs_stack_fini(&stage->defer_stack);
@@ -20954,6 +22261,21 @@ void ecs_set_stage_count(
         }
 
         ecs_os_free(world->stages);
+
+        /* Release blocks of finalized stage allocators that are no longer in
+         * use by any other allocator */
+        if (world->stage_depot) {
+            flecs_ballocator_depot_trim(world->stage_depot);
+        }
+    }
+
+    if (!stage_count && world->stage_depot) {
+        flecs_ballocator_depot_free(world->stage_depot);
+        world->stage_depot = NULL;
+    } else if (stage_count > 1 && !world->stage_depot && 
+        ecs_os_has_threading()) 
+    {
+        world->stage_depot = flecs_ballocator_depot_new();
     }
 
     if (stage_count) {
@@ -21072,6 +22394,12 @@ void ecs_readonly_end(
     ECS_BIT_CLEAR(world->flags, EcsWorldReadonly);
     ECS_BIT_CLEAR(world->flags, EcsWorldMultiThreaded);
 
+    /* Return ids that stages reserved but didn't use */
+    int32_t i, count = ecs_get_stage_count(world);
+    for (i = 0; i < count; i ++) {
+        flecs_stage_release_ids(world, &world->stages[i]);
+    }
+
     ecs_log_pop_3();
 
     flecs_stage_auto_merge(world);
@@ -21162,7 +22490,11 @@ void ecs_async_stage_free(
     ecs_poly_assert(world, ecs_stage_t);
     ecs_stage_t *stage = (ecs_stage_t*)world;
     ecs_check(stage->async == true, ECS_INVALID_PARAMETER, NULL);
+    ecs_block_allocator_depot_t *depot = stage->world->stage_depot;
     flecs_stage_fini(stage->world, stage);
+    if (depot) {
+        flecs_ballocator_depot_trim(depot);
+    }
     ecs_os_free(stage);
 error:
     return;
@@ -21845,6 +23177,81 @@ void flecs_resume_readonly(
     }
 }
 
+/* Collect tables that (transitively) traverse one of the changed entities. A
+ * table can only get a different match for a query with up traversal if one of
+ * the entities on its traversal path changed, so queries only need to rematch
+ * these tables. Tables are found by walking the (*, entity) records of
+ * traversable relationships, which also yields the traversable entities in the
+ * next level of the hierarchy. */
+static
+void flecs_monitor_collect_tables(
+    ecs_world_t *world)
+{
+    ecs_monitor_set_t *ms = &world->monitors;
+    ecs_vec_clear(&ms->tables);
+    if (ms->rematch_all) {
+        return;
+    }
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_map_t visited;
+    ecs_map_init(&visited, a);
+    ecs_vec_t stack;
+    ecs_vec_init_t(a, &stack, ecs_id_record_t*, 0);
+
+    int32_t i, count = ecs_vec_count(&ms->entities);
+    ecs_entity_t *entities = ecs_vec_first(&ms->entities);
+    for (i = 0; i < count; i ++) {
+        ecs_id_record_t *idr = flecs_id_record_get(world, 
+            ecs_pair(EcsWildcard, entities[i]));
+        if (idr) {
+            ecs_vec_append_t(a, &stack, ecs_id_record_t*)[0] = idr;
+        }
+    }
+
+    while ((count = ecs_vec_count(&stack))) {
+        ecs_id_record_t *cur = ecs_vec_get_t(
+            &stack, ecs_id_record_t*, count - 1)[0];
+        ecs_vec_remove_last(&stack);
+
+        while ((cur = cur->trav.next)) {
+            ecs_table_cache_iter_t it;
+            if (!flecs_table_cache_all_iter(&cur->cache, &it)) {
+                continue;
+            }
+
+            const ecs_table_record_t *tr;
+            while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+                ecs_table_t *table = tr->hdr.table;
+                ecs_map_val_t *v = ecs_map_ensure(&visited, table->id);
+                if (v[0]) {
+                    continue;
+                }
+
+                v[0] = 1;
+                ecs_vec_append_t(a, &ms->tables, ecs_table_t*)[0] = table;
+
+                if (!table->_->traversable_count) {
+                    continue;
+                }
+
+                int32_t e, entity_count = ecs_table_count(table);
+                ecs_record_t **records = ecs_vec_first(&table->data.records);
+                for (e = 0; e < entity_count; e ++) {
+                    ecs_record_t *r = records[e];
+                    if ((r->row & EcsEntityIsTraversable) && r->idr) {
+                        ecs_vec_append_t(a, &stack, ecs_id_record_t*)[0] = 
+                            r->idr;
+                    }
+                }
+            }
+        }
+    }
+
+    ecs_vec_fini_t(a, &stack, ecs_id_record_t*);
+    ecs_map_fini(&visited);
+}
+
 /* Evaluate component monitor. If a monitored entity changed it will have set a
  * flag in one of the world's component monitors. Queries can register 
  * themselves with component monitors to determine whether they need to rematch
@@ -21861,6 +23268,8 @@ void flecs_eval_component_monitor(
 
     world->monitors.is_dirty = false;
 
+    flecs_monitor_collect_tables(world);
+
     ecs_map_iter_t it = ecs_map_iter(&world->monitors.monitors);
     while (ecs_map_next(&it)) {
         ecs_monitor_t *m = ecs_map_ptr(&it);
@@ -21879,10 +23288,38 @@ void flecs_eval_component_monitor(
             });
         }
     }
+
+    ecs_vec_clear(&world->monitors.tables);
+}
+
+/* Add changed entity. An entity of 0 means that the change can't be attributed
+ * to a single entity, in which case queries rematch all tables. */
+static
+void flecs_monitor_add_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_monitor_set_t *ms = &world->monitors;
+    if (!entity) {
+        ms->rematch_all = true;
+        return;
+    }
+
+    /* Entity is typically marked for multiple (monitored) ids in a row */
+    int32_t count = ecs_vec_count(&ms->entities);
+    if (count && ecs_vec_get_t(
+        &ms->entities, ecs_entity_t, count - 1)[0] == entity) 
+    {
+        return;
+    }
+
+    ecs_vec_append_t(&world->allocator, &ms->entities, ecs_entity_t)[0] = 
+        entity;
 }
 
 void flecs_monitor_mark_dirty(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_entity_t id)
 {
     ecs_map_t *monitors = &world->monitors.monitors;
@@ -21894,9 +23331,12 @@ void flecs_monitor_mark_dirty(
         if (m) {
             if (!world->monitors.is_dirty) {
                 world->monitor_generation ++;
+                world->monitors.rematch_all = false;
+                ecs_vec_clear(&world->monitors.entities);
             }
             m->is_dirty = true;
             world->monitors.is_dirty = true;
+            flecs_monitor_add_entity(world, entity);
         }
     }
 }
@@ -22331,6 +23771,9 @@ ecs_world_t *ecs_mini(void) {
         &world->allocators.sparse_chunk, ecs_type_info_t);
     ecs_map_init_w_params(&world->id_index_hi, &world->allocators.ptr);
     world->id_index_lo = ecs_os_calloc_n(ecs_id_record_t, FLECS_HI_ID_RECORD_ID);
+    ecs_vec_init_t(a, &world->id_index_pairs, ecs_pair_index_rel_page_t*, 0);
+    ecs_vec_init_t(a, &world->monitors.entities, ecs_entity_t, 0);
+    ecs_vec_init_t(a, &world->monitors.tables, ecs_table_t*, 0);
     flecs_observable_init(&world->observable);
     world->iterable.init = flecs_world_iter_init;
 
@@ -22836,6 +24279,8 @@ int ecs_fini(
     /* All queries are cleaned up, so monitors should've been cleaned up too */
     ecs_assert(!ecs_map_is_init(&world->monitors.monitors), 
         ECS_INTERNAL_ERROR, NULL);
+    ecs_vec_fini_t(&world->allocator, &world->monitors.entities, ecs_entity_t);
+    ecs_vec_fini_t(&world->allocator, &world->monitors.tables, ecs_table_t*);
 
     /* Cleanup world ctx and binding_ctx */
     if (world->ctx_free) {
@@ -22860,6 +24305,7 @@ int ecs_fini(
     flecs_name_index_fini(&world->aliases);
     flecs_name_index_fini(&world->symbols);
     ecs_set_stage_count(world, 0);
+    flecs_merge_writes_fini(world);
     ecs_log_pop_1();
 
     flecs_world_allocators_fini(world);
@@ -34201,6 +35647,8 @@ void flecs_world_stats_to_json(
     ECS_COUNTER_APPEND(reply, stats, memory.stack_alloc_count, "Pages allocated by stack allocators");
     ECS_COUNTER_APPEND(reply, stats, memory.stack_free_count, "Pages freed by stack allocators");
     ECS_GAUGE_APPEND(reply, stats, memory.stack_outstanding_alloc_count, "Outstanding page allocations");
+    ECS_GAUGE_APPEND(reply, stats, memory.page_bytes, "Bytes of world storage mapped with OS page allocation");
+    ECS_GAUGE_APPEND(reply, stats, memory.huge_page_advised_bytes, "Bytes of world storage advised to use huge pages");
 
     ECS_COUNTER_APPEND(reply, stats, rest.request_count, "Received requests");
     ECS_COUNTER_APPEND(reply, stats, rest.entity_count, "Received entity/ requests");
@@ -35144,6 +36592,7 @@ typedef struct ecs_system_t {
     ecs_ftime_t time_spent;         /* Time spent on running system */
     ecs_ftime_t time_passed;        /* Time passed since last invocation */
     int64_t last_frame;             /* Last frame for which the system was considered */
+    int32_t worker_claimed;         /* Chunks claimed by workers in current run */
 
     void *ctx;                      /* Userdata for system */
     void *binding_ctx;              /* Optional language binding context */
@@ -35172,6 +36621,7 @@ ecs_entity_t ecs_run_intern(
     ecs_system_t *system_data,
     int32_t stage_current,
     int32_t stage_count,
+    int32_t chunk_size,
     ecs_ftime_t delta_time,
     int32_t offset,
     int32_t limit,
@@ -35202,6 +36652,8 @@ typedef struct ecs_pipeline_op_t {
     int64_t commands_enqueued;  /* Number of commands enqueued for sync point */
     bool multi_threaded;        /* Whether systems can be ran multi threaded */
     bool no_readonly;           /* Whether systems are staged or not */
+    bool parallel;              /* Whether systems run in parallel with each other */
+    bool no_merge;              /* Sync after op without merging commands */
 } ecs_pipeline_op_t;
 
 struct ecs_pipeline_state_t {
@@ -35213,6 +36665,7 @@ struct ecs_pipeline_state_t {
     ecs_id_record_t *idr_inactive; /* Cached record for quick inactive test */
     int32_t match_count;        /* Used to track of rebuild is necessary */
     int32_t rebuild_count;      /* Number of pipeline rebuilds */
+    bool parallel_systems;      /* Was pipeline built for parallel systems */
     ecs_iter_t *iters;          /* Iterator for worker(s) */
     int32_t iter_count;
 
@@ -35223,6 +36676,18 @@ struct ecs_pipeline_state_t {
     bool no_readonly;           /* Is pipeline in readonly mode */
 };
 
+/** Job that is ran by the main thread and workers instead of the pipeline.
+ * Used by ecs_query_par_each, ecs_rule_par_each and stage merges. */
+struct ecs_worker_job_t {
+    ecs_query_t *query;         /* Query to iterate */
+    const ecs_rule_t *rule;     /* Rule to evaluate (if no query) */
+    ecs_worker_action_t action; /* Action to run (if no query or rule) */
+    ecs_iter_action_t callback; /* Function invoked for each chunk */
+    void *ctx;                  /* Context passed to callback */
+    int32_t chunk_size;         /* Max number of rows per chunk */
+    int32_t claimed;            /* Chunk/table counter shared between threads */
+};
+
 typedef struct EcsPipeline {
     /* Stable ptr so threads can safely access while entity/components move */
     ecs_pipeline_state_t *state;
@@ -35593,6 +37058,10 @@ void ecs_world_stats_get(
     ECS_COUNTER_RECORD(&s->memory.stack_free_count, t, ecs_stack_allocator_free_count);
     ECS_GAUGE_RECORD(&s->memory.stack_outstanding_alloc_count, t, outstanding_allocs);
 
+    ecs_allocator_t *a = (ecs_allocator_t*)&world->allocator;
+    ECS_GAUGE_RECORD(&s->memory.page_bytes, t, flecs_allocator_page_bytes(a, false));
+    ECS_GAUGE_RECORD(&s->memory.huge_page_advised_bytes, t, flecs_allocator_page_bytes(a, true));
+
 #ifdef FLECS_REST
     ECS_COUNTER_RECORD(&s->rest.request_count, t, ecs_rest_request_count);
     ECS_COUNTER_RECORD(&s->rest.entity_count, t, ecs_rest_entity_count);
@@ -37457,6 +38926,7 @@ void flecs_allocator_init(
     flecs_ballocator_init_n(&a->chunks, ecs_block_allocator_t,
         FLECS_SPARSE_PAGE_SIZE);
     flecs_sparse_init_t(&a->sizes, NULL, &a->chunks, ecs_block_allocator_t);
+    a->depot = NULL;
 }
 
 void flecs_allocator_fini(
@@ -37492,6 +38962,7 @@ ecs_block_allocator_t* flecs_allocator_get(
         result = flecs_sparse_ensure_fast_t(&a->sizes, 
             ecs_block_allocator_t, (uint32_t)hash);
         flecs_ballocator_init(result, size);
+        result->depot = a->depot;
     }
 
     ecs_assert(result->data_size == size, ECS_INTERNAL_ERROR, NULL);
@@ -37499,6 +38970,21 @@ ecs_block_allocator_t* flecs_allocator_get(
     return result;
 }
 
+int64_t flecs_allocator_page_bytes(
+    ecs_allocator_t *a,
+    bool huge)
+{
+    int64_t result = 0;
+    int32_t i, count = flecs_sparse_count(&a->sizes);
+    for (i = 0; i < count; i ++) {
+        ecs_block_allocator_t *ba = flecs_sparse_get_dense_t(
+            &a->sizes, ecs_block_allocator_t, i);
+        int32_t page_count = huge ? ba->huge_page_advised_count : ba->page_count;
+        result += (int64_t)page_count * ba->data_size;
+    }
+    return result;
+}
+
 char* flecs_strdup(
     ecs_allocator_t *a, 
     const char* str)
@@ -37669,6 +39155,37 @@ error:
 int64_t ecs_block_allocator_alloc_count = 0;
 int64_t ecs_block_allocator_free_count = 0;
 
+/* Alignment of the first chunk in a block. Since all chunks in a block are 
+ * chunk_size apart, this is also the alignment of all other chunks. This makes
+ * it possible to get aligned memory by requesting a multiple of the alignment,
+ * which is used by table columns for over-aligned components. */
+static
+ecs_size_t flecs_balloc_align(
+    ecs_block_allocator_t *allocator)
+{
+    ecs_size_t align = allocator->chunk_size & -allocator->chunk_size;
+    return ECS_MIN(align, FLECS_BALLOC_MAX_ALIGN);
+}
+
+#ifdef FLECS_SANITIZE
+/* Size of the header that stores the chunk size in sanitized builds. Aligned 
+ * allocations (like table columns of over-aligned components) store at least
+ * two elements, so if the data is at least twice the alignment the header is as
+ * large as the alignment, which gives the data the same alignment as in regular
+ * builds. */
+static
+ecs_size_t flecs_balloc_header(
+    ecs_size_t data_size)
+{
+    ecs_size_t size = ECS_ALIGN(data_size, 16);
+    ecs_size_t align = ECS_MIN(size & -size, FLECS_BALLOC_MAX_ALIGN);
+    if (size >= (align * 2)) {
+        return align;
+    }
+    return 16;
+}
+#endif
+
 static
 ecs_block_allocator_chunk_header_t* flecs_balloc_block(
     ecs_block_allocator_t *allocator)
@@ -37677,11 +39194,22 @@ ecs_block_allocator_chunk_header_t* flecs_balloc_block(
         return NULL;
     }
 
+    ecs_size_t align = flecs_balloc_align(allocator);
+    ecs_size_t padding = 0;
+    if (align > 16) {
+        padding = align;
+    }
+
     ecs_block_allocator_block_t *block = 
         ecs_os_malloc(ECS_SIZEOF(ecs_block_allocator_block_t) +
-            allocator->block_size);
+            allocator->block_size + padding);
     ecs_block_allocator_chunk_header_t *first_chunk = ECS_OFFSET(block, 
         ECS_SIZEOF(ecs_block_allocator_block_t));
+    if (padding) {
+        uintptr_t addr = (uintptr_t)first_chunk;
+        addr = (addr + (uintptr_t)(align - 1)) & ~(uintptr_t)(align - 1);
+        first_chunk = (ecs_block_allocator_chunk_header_t*)addr;
+    }
 
     block->memory = first_chunk;
     if (!allocator->block_tail) {
@@ -37708,6 +39236,383 @@ ecs_block_allocator_chunk_header_t* flecs_balloc_block(
     return first_chunk;
 }
 
+/* Chunks of FLECS_BALLOC_LARGE_SIZE or larger are allocated individually with
+ * the OS allocator, or with the OS page allocation functions if the chunk is
+ * larger than FLECS_BALLOC_PAGE_ALLOC_SIZE. The chunk is aligned the same way 
+ * chunks in a block are. The distance between the chunk and the start of the 
+ * allocation is stored in the byte that precedes the chunk, and the byte before
+ * that stores how the chunk was allocated. */
+#define FLECS_BALLOC_PAGES (1)
+#define FLECS_BALLOC_HUGE_PAGES_ADVISED (2)
+
+static
+bool flecs_balloc_is_large(
+    ecs_block_allocator_t *allocator)
+{
+    return allocator->chunk_size >= FLECS_BALLOC_LARGE_SIZE;
+}
+
+static
+bool flecs_balloc_use_pages(
+    ecs_block_allocator_t *allocator)
+{
+    return (allocator->chunk_size >= FLECS_BALLOC_PAGE_ALLOC_SIZE) &&
+        ecs_os_has_page_alloc();
+}
+
+static
+ecs_size_t flecs_balloc_large_size(
+    ecs_block_allocator_t *allocator)
+{
+    return allocator->chunk_size + flecs_balloc_align(allocator);
+}
+
+static
+void flecs_balloc_large_count(
+    ecs_block_allocator_t *allocator,
+    uint8_t flags,
+    int32_t count)
+{
+    if (flags & FLECS_BALLOC_PAGES) {
+        allocator->page_count += count;
+    }
+    if (flags & FLECS_BALLOC_HUGE_PAGES_ADVISED) {
+        allocator->huge_page_advised_count += count;
+    }
+}
+
+static
+void flecs_bfree_large(
+    ecs_block_allocator_t *allocator,
+    void *chunk)
+{
+    ecs_size_t offset = ((uint8_t*)chunk)[-1];
+    uint8_t flags = ((uint8_t*)chunk)[-2];
+    void *memory = ECS_OFFSET(chunk, -offset);
+    if (flags & FLECS_BALLOC_PAGES) {
+        ecs_os_page_free(memory, flecs_balloc_large_size(allocator));
+    } else {
+        ecs_os_free(memory);
+    }
+    flecs_balloc_large_count(allocator, flags, -1);
+    ecs_os_linc(&ecs_block_allocator_free_count);
+}
+
+static
+void* flecs_balloc_large(
+    ecs_block_allocator_t *dst,
+    ecs_block_allocator_t *src,
+    void *chunk)
+{
+    ecs_size_t align = flecs_balloc_align(dst);
+    ecs_size_t size = flecs_balloc_large_size(dst);
+    bool use_pages = flecs_balloc_use_pages(dst);
+    ecs_size_t offset = 0;
+    uint8_t flags = 0;
+    void *memory = NULL;
+
+    if (chunk) {
+        offset = ((uint8_t*)chunk)[-1];
+        flags = ((uint8_t*)chunk)[-2];
+        memory = ECS_OFFSET(chunk, -offset);
+
+        if (use_pages != ((flags & FLECS_BALLOC_PAGES) != 0)) {
+            /* Memory can't be resized across allocation functions */
+            void *result = flecs_balloc_large(dst, NULL, NULL);
+            ecs_os_memcpy(result, chunk, 
+                ECS_MIN(src->chunk_size, dst->chunk_size));
+            flecs_bfree_large(src, chunk);
+            return result;
+        }
+
+        flecs_balloc_large_count(src, flags, -1);
+    } else {
+        ecs_os_linc(&ecs_block_allocator_alloc_count);
+    }
+
+    if (use_pages) {
+        bool huge = false;
+        if (memory) {
+            memory = ecs_os_page_realloc(
+                memory, flecs_balloc_large_size(src), size, &huge);
+        } else {
+            memory = ecs_os_page_alloc(size, &huge);
+        }
+        ecs_assert(memory != NULL, ECS_OUT_OF_MEMORY, NULL);
+        flags = FLECS_BALLOC_PAGES;
+        if (huge) {
+            flags |= FLECS_BALLOC_HUGE_PAGES_ADVISED;
+        }
+    } else {
+        memory = ecs_os_realloc(memory, size);
+        flags = 0;
+    }
+
+    flecs_balloc_large_count(dst, flags, 1);
+
+    uintptr_t addr = (uintptr_t)memory + 2;
+    addr = (addr + (uintptr_t)(align - 1)) & ~(uintptr_t)(align - 1);
+    void *result = (void*)addr;
+    ecs_size_t new_offset = (ecs_size_t)(addr - (uintptr_t)memory);
+
+    /* If the OS allocator moved the memory to an address with a different
+     * alignment, move the chunk to its new aligned position */
+    if (chunk && (new_offset != offset)) {
+        ecs_os_memmove(result, ECS_OFFSET(memory, offset), 
+            ECS_MIN(src->chunk_size, dst->chunk_size));
+    }
+
+    ((uint8_t*)result)[-1] = (uint8_t)new_offset;
+    ((uint8_t*)result)[-2] = flags;
+    return result;
+}
+
+/* Free chunks are exchanged with the depot in magazines, which are lists of 
+ * chunks. Magazines are linked to each other through the first chunk, which is
+ * large enough to store two pointers since chunks are at least 16 bytes. */
+typedef struct ecs_block_allocator_magazine_t {
+    ecs_block_allocator_chunk_header_t chunks;
+    struct ecs_block_allocator_magazine_t *next;
+} ecs_block_allocator_magazine_t;
+
+/* Free chunks and blocks of finalized allocators for a single chunk size */
+typedef struct ecs_block_allocator_depot_size_t {
+    ecs_block_allocator_magazine_t *magazines;
+    ecs_block_allocator_block_t *blocks; /* Blocks of finalized allocators */
+    int32_t chunk_size;
+    int32_t chunks_per_block;
+} ecs_block_allocator_depot_size_t;
+
+struct ecs_block_allocator_depot_t {
+    ecs_os_mutex_t lock;
+    ecs_map_t sizes;    /* <chunk size, ecs_block_allocator_depot_size_t*> */
+};
+
+ecs_block_allocator_depot_t* flecs_ballocator_depot_new(void) {
+    ecs_block_allocator_depot_t *result = 
+        ecs_os_calloc_t(ecs_block_allocator_depot_t);
+    result->lock = ecs_os_mutex_new();
+    ecs_map_init(&result->sizes, NULL);
+    return result;
+}
+
+static
+void flecs_balloc_depot_free_blocks(
+    ecs_block_allocator_block_t *block)
+{
+    while (block) {
+        ecs_block_allocator_block_t *next = block->next;
+        ecs_os_free(block);
+        ecs_os_linc(&ecs_block_allocator_free_count);
+        block = next;
+    }
+}
+
+void flecs_ballocator_depot_free(
+    ecs_block_allocator_depot_t *depot)
+{
+    ecs_map_iter_t it = ecs_map_iter(&depot->sizes);
+    while (ecs_map_next(&it)) {
+        ecs_block_allocator_depot_size_t *ds = ecs_map_ptr(&it);
+        flecs_balloc_depot_free_blocks(ds->blocks);
+        ecs_os_free(ds);
+    }
+    ecs_map_fini(&depot->sizes);
+    ecs_os_mutex_free(depot->lock);
+    ecs_os_free(depot);
+}
+
+/* Must be called while the depot is locked */
+static
+ecs_block_allocator_depot_size_t* flecs_balloc_depot_ensure(
+    ecs_block_allocator_t *ba)
+{
+    ecs_block_allocator_depot_size_t **ref = ecs_map_ensure_ref(
+        &ba->depot->sizes, ecs_block_allocator_depot_size_t, 
+            (ecs_map_key_t)ba->chunk_size);
+    if (!*ref) {
+        *ref = ecs_os_calloc_t(ecs_block_allocator_depot_size_t);
+        (*ref)->chunk_size = ba->chunk_size;
+        (*ref)->chunks_per_block = ba->chunks_per_block;
+    }
+    return *ref;
+}
+
+static
+void flecs_balloc_depot_put(
+    ecs_block_allocator_t *ba,
+    ecs_block_allocator_chunk_header_t *chunks)
+{
+    ecs_block_allocator_depot_t *depot = ba->depot;
+    ecs_block_allocator_magazine_t *magazine = 
+        (ecs_block_allocator_magazine_t*)chunks;
+
+    ecs_os_mutex_lock(depot->lock);
+    ecs_block_allocator_depot_size_t *ds = flecs_balloc_depot_ensure(ba);
+    magazine->next = ds->magazines;
+    ds->magazines = magazine;
+    ecs_os_mutex_unlock(depot->lock);
+}
+
+static
+ecs_block_allocator_chunk_header_t* flecs_balloc_depot_get(
+    ecs_block_allocator_t *ba)
+{
+    ecs_block_allocator_depot_t *depot = ba->depot;
+    ecs_block_allocator_magazine_t *magazine = NULL;
+
+    ecs_os_mutex_lock(depot->lock);
+    ecs_block_allocator_depot_size_t *ds = ecs_map_get_deref(
+        &depot->sizes, ecs_block_allocator_depot_size_t, 
+            (ecs_map_key_t)ba->chunk_size);
+    if (ds && ds->magazines) {
+        magazine = ds->magazines;
+        ds->magazines = magazine->next;
+    }
+    ecs_os_mutex_unlock(depot->lock);
+
+    if (!magazine) {
+        return NULL;
+    }
+
+    ecs_block_allocator_chunk_header_t *chunk;
+    for (chunk = &magazine->chunks; chunk; chunk = chunk->next) {
+        ba->free_count ++;
+    }
+
+    return &magazine->chunks;
+}
+
+/* Returns whether all chunks of a block are in the set of free chunks */
+static
+bool flecs_balloc_block_is_free(
+    ecs_block_allocator_depot_size_t *ds,
+    ecs_block_allocator_block_t *block,
+    ecs_map_t *free_chunks)
+{
+    int32_t i;
+    for (i = 0; i < ds->chunks_per_block; i ++) {
+        void *chunk = ECS_OFFSET(block->memory, i * ds->chunk_size);
+        if (!ecs_map_get(free_chunks, (ecs_map_key_t)(uintptr_t)chunk)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Free blocks of finalized allocators of which all chunks are in the depot. 
+ * The remaining free chunks are redistributed over new magazines. */
+static
+void flecs_balloc_depot_trim_size(
+    ecs_block_allocator_depot_size_t *ds)
+{
+    if (!ds->blocks) {
+        return;
+    }
+
+    ecs_map_t free_chunks;
+    ecs_map_init(&free_chunks, NULL);
+
+    ecs_block_allocator_magazine_t *magazine;
+    ecs_block_allocator_chunk_header_t *chunk;
+    for (magazine = ds->magazines; magazine; magazine = magazine->next) {
+        for (chunk = &magazine->chunks; chunk; chunk = chunk->next) {
+            ecs_map_insert(&free_chunks, (ecs_map_key_t)(uintptr_t)chunk, 1);
+        }
+    }
+
+    /* Unlink blocks of which all chunks are free. Chunks of unlinked blocks
+     * are marked so they can be removed from the magazines. */
+    ecs_block_allocator_block_t *block, *freed = NULL, **prev = &ds->blocks;
+    int32_t i;
+    for (block = ds->blocks; block; block = *prev) {
+        if (!flecs_balloc_block_is_free(ds, block, &free_chunks)) {
+            prev = &block->next;
+            continue;
+        }
+
+        for (i = 0; i < ds->chunks_per_block; i ++) {
+            void *ptr = ECS_OFFSET(block->memory, i * ds->chunk_size);
+            ecs_map_ensure(&free_chunks, (ecs_map_key_t)(uintptr_t)ptr)[0] = 0;
+        }
+
+        *prev = block->next;
+        block->next = freed;
+        freed = block;
+    }
+
+    if (freed) {
+        /* Rebuild magazines from chunks that remain. The next pointer of a 
+         * chunk is read before the chunk is relinked. */
+        ecs_block_allocator_magazine_t *magazines = ds->magazines;
+        ecs_block_allocator_chunk_header_t *last = NULL;
+        int32_t count = 0;
+        ds->magazines = NULL;
+        while (magazines) {
+            ecs_block_allocator_magazine_t *next_magazine = magazines->next;
+            for (chunk = &magazines->chunks; chunk;) {
+                ecs_block_allocator_chunk_header_t *next = chunk->next;
+                if (ecs_map_get(&free_chunks, 
+                    (ecs_map_key_t)(uintptr_t)chunk)[0]) 
+                {
+                    if (!count) {
+                        magazine = (ecs_block_allocator_magazine_t*)chunk;
+                        chunk->next = NULL;
+                        magazine->next = ds->magazines;
+                        ds->magazines = magazine;
+                    } else {
+                        chunk->next = NULL;
+                        last->next = chunk;
+                    }
+                    last = chunk;
+                    count = (count + 1) % ds->chunks_per_block;
+                }
+                chunk = next;
+            }
+            magazines = next_magazine;
+        }
+
+        flecs_balloc_depot_free_blocks(freed);
+    }
+
+    ecs_map_fini(&free_chunks);
+}
+
+void flecs_ballocator_depot_trim(
+    ecs_block_allocator_depot_t *depot)
+{
+    ecs_os_mutex_lock(depot->lock);
+    ecs_map_iter_t it = ecs_map_iter(&depot->sizes);
+    while (ecs_map_next(&it)) {
+        flecs_balloc_depot_trim_size(ecs_map_ptr(&it));
+    }
+    ecs_os_mutex_unlock(depot->lock);
+}
+
+/* Return a magazine to the depot when an allocator has more than two 
+ * magazines worth of free chunks, so that chunks freed by one thread can be 
+ * reused by others. */
+static
+void flecs_bfree_to_depot(
+    ecs_block_allocator_t *ba)
+{
+    int32_t i, count = ba->chunks_per_block;
+    if (ba->free_count < (count * 2)) {
+        return;
+    }
+
+    ecs_block_allocator_chunk_header_t *first = ba->head, *last = first;
+    for (i = 1; i < count; i ++) {
+        last = last->next;
+    }
+
+    ba->head = last->next;
+    ba->free_count -= count;
+    last->next = NULL;
+
+    flecs_balloc_depot_put(ba, first);
+}
+
 void flecs_ballocator_init(
     ecs_block_allocator_t *ba,
     ecs_size_t size)
@@ -37716,7 +39621,7 @@ void flecs_ballocator_init(
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
     ba->data_size = size;
 #ifdef FLECS_SANITIZE
-    size += ECS_SIZEOF(int64_t);
+    size += flecs_balloc_header(size);
 #endif
     ba->chunk_size = ECS_ALIGN(size, 16);
     ba->chunks_per_block = ECS_MAX(4096 / ba->chunk_size, 1);
@@ -37724,6 +39629,11 @@ void flecs_ballocator_init(
     ba->head = NULL;
     ba->block_head = NULL;
     ba->block_tail = NULL;
+    ba->alloc_count = 0;
+    ba->page_count = 0;
+    ba->huge_page_advised_count = 0;
+    ba->free_count = 0;
+    ba->depot = NULL;
 }
 
 ecs_block_allocator_t* flecs_ballocator_new(
@@ -37744,14 +39654,29 @@ void flecs_ballocator_fini(
         "(size = %u)", (uint32_t)ba->data_size);
 #endif
 
-    ecs_block_allocator_block_t *block;
-    for (block = ba->block_head; block;) {
-        ecs_block_allocator_block_t *next = block->next;
-        ecs_os_free(block);
-        ecs_os_linc(&ecs_block_allocator_free_count);
-        block = next;
+    ecs_block_allocator_depot_t *depot = ba->depot;
+    if (depot) {
+        /* Chunks of this allocator may be in use by other allocators of the
+         * depot, so transfer ownership of blocks & free chunks to the depot */
+        if (ba->head) {
+            flecs_balloc_depot_put(ba, ba->head);
+        }
+        if (ba->block_head) {
+            ecs_os_mutex_lock(depot->lock);
+            ecs_block_allocator_depot_size_t *ds = 
+                flecs_balloc_depot_ensure(ba);
+            ba->block_tail->next = ds->blocks;
+            ds->blocks = ba->block_head;
+            ecs_os_mutex_unlock(depot->lock);
+        }
+    } else {
+        flecs_balloc_depot_free_blocks(ba->block_head);
     }
+
+    ba->head = NULL;
     ba->block_head = NULL;
+    ba->block_tail = NULL;
+    ba->free_count = 0;
 }
 
 void flecs_ballocator_free(
@@ -37771,18 +39696,29 @@ void* flecs_balloc(
 
     if (!ba) return NULL;
 
-    if (!ba->head) {
-        ba->head = flecs_balloc_block(ba);
-    }
+    if (flecs_balloc_is_large(ba)) {
+        result = flecs_balloc_large(ba, NULL, NULL);
+    } else {
+        if (!ba->head) {
+            if (ba->depot) {
+                ba->head = flecs_balloc_depot_get(ba);
+            }
+            if (!ba->head) {
+                ba->head = flecs_balloc_block(ba);
+                ba->free_count += ba->chunks_per_block;
+            }
+        }
 
-    result = ba->head;
-    ba->head = ba->head->next;
+        result = ba->head;
+        ba->head = ba->head->next;
+        ba->free_count --;
+    }
 
 #ifdef FLECS_SANITIZE
     ecs_assert(ba->alloc_count >= 0, ECS_INTERNAL_ERROR, "corrupted allocator");
     ba->alloc_count ++;
     *(int64_t*)result = ba->chunk_size;
-    result = ECS_OFFSET(result, ECS_SIZEOF(int64_t));
+    result = ECS_OFFSET(result, flecs_balloc_header(ba->data_size));
 #endif
 #endif
 
@@ -37824,7 +39760,7 @@ void flecs_bfree(
     }
 
 #ifdef FLECS_SANITIZE
-    memory = ECS_OFFSET(memory, -ECS_SIZEOF(int64_t));
+    memory = ECS_OFFSET(memory, -flecs_balloc_header(ba->data_size));
     if (*(int64_t*)memory != ba->chunk_size) {
         ecs_err("chunk %p returned to wrong allocator "
             "(chunk = %ub, allocator = %ub)",
@@ -37835,9 +39771,19 @@ void flecs_bfree(
     ba->alloc_count --;
 #endif
 
+    if (flecs_balloc_is_large(ba)) {
+        flecs_bfree_large(ba, memory);
+        return;
+    }
+
     ecs_block_allocator_chunk_header_t *chunk = memory;
     chunk->next = ba->head;
     ba->head = chunk;
+    ba->free_count ++;
+
+    if (ba->depot) {
+        flecs_bfree_to_depot(ba);
+    }
     ecs_assert(ba->alloc_count >= 0, ECS_INTERNAL_ERROR, "corrupted allocator");
 }
 
@@ -37854,6 +39800,32 @@ void* flecs_brealloc(
         return memory;
     }
 
+    if (memory && dst && src && 
+        flecs_balloc_is_large(dst) && flecs_balloc_is_large(src)) 
+    {
+        /* Let the OS allocator resize the chunk, which can avoid a copy */
+#ifdef FLECS_SANITIZE
+        memory = ECS_OFFSET(memory, -flecs_balloc_header(src->data_size));
+        ecs_assert(*(int64_t*)memory == src->chunk_size, 
+            ECS_INTERNAL_ERROR, NULL);
+        src->alloc_count --;
+        dst->alloc_count ++;
+#endif
+        result = flecs_balloc_large(dst, src, memory);
+#ifdef FLECS_SANITIZE
+        *(int64_t*)result = dst->chunk_size;
+        ecs_size_t src_header = flecs_balloc_header(src->data_size);
+        ecs_size_t dst_header = flecs_balloc_header(dst->data_size);
+        if (src_header != dst_header) {
+            ecs_os_memmove(ECS_OFFSET(result, dst_header), 
+                ECS_OFFSET(result, src_header), 
+                    ECS_MIN(src->data_size, dst->data_size));
+        }
+        result = ECS_OFFSET(result, dst_header);
+#endif
+        return result;
+    }
+
     result = flecs_balloc(dst);
     if (result && src) {
         ecs_size_t size = src->data_size;
@@ -38320,11 +40292,6 @@ void* flecs_hashmap_next_(
  */
 
 
-/* The ratio used to determine whether the map should flecs_map_rehash. If
- * (element_count * ECS_LOAD_FACTOR) > bucket_count, bucket count is increased. */
-#define ECS_LOAD_FACTOR (12)
-#define ECS_BUCKET_END(b, c) ECS_ELEM_T(b, ecs_bucket_t, c)
-
 static
 uint8_t flecs_log2(uint32_t v) {
     static const uint8_t log2table[32] = 
@@ -38339,6 +40306,475 @@ uint8_t flecs_log2(uint32_t v) {
     return log2table[(uint32_t)(v * 0x07C4ACDDU) >> 27];
 }
 
+#ifdef FLECS_MAP_SWISS
+
+/* Open addressing map. The control bytes of a map are probed a group of
+ * FLECS_MAP_GROUP_SIZE slots at a time. A control byte is either empty, deleted
+ * or contains 7 bits of the hash of the key in the slot. Only keys of slots
+ * with a matching control byte are compared, so that most lookups only load a
+ * single key. A probe sequence ends at the first group with an empty slot.
+ *
+ * The group index is determined by the upper bits of the key hash (fibonacci
+ * hashing), the control byte by the bits below it. Maps with less slots than
+ * the group size pad the control bytes with empty slots. */
+
+#define FLECS_MAP_GROUP_SIZE (16)
+#define FLECS_MAP_MIN_CAPACITY (4)
+#define FLECS_MAP_EMPTY ((int8_t)-128)
+#define FLECS_MAP_DELETED ((int8_t)-2)
+
+/* Max number of used (full or deleted) slots before the map is rehashed */
+#define FLECS_MAP_MAX_LOAD(capacity) ((capacity) - ((capacity) >> 3))
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLECS_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Get bitmask of slots in group with control byte equal to h */
+static
+uint32_t flecs_map_match(
+    const int8_t *ctrl,
+    int8_t h)
+{
+#ifdef FLECS_MAP_SSE2
+    __m128i group = _mm_loadu_si128((const __m128i*)(const void*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(group, _mm_set1_epi8(h)));
+#else
+    uint32_t result = 0;
+    int32_t i;
+    for (i = 0; i < FLECS_MAP_GROUP_SIZE; i ++) {
+        result |= (uint32_t)(ctrl[i] == h) << i;
+    }
+    return result;
+#endif
+}
+
+/* Get bitmask of empty or deleted slots in group */
+static
+uint32_t flecs_map_match_free(
+    const int8_t *ctrl)
+{
+#ifdef FLECS_MAP_SSE2
+    /* Empty and deleted are the only control bytes with the sign bit set */
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_loadu_si128((const __m128i*)(const void*)ctrl));
+#else
+    uint32_t result = 0;
+    int32_t i;
+    for (i = 0; i < FLECS_MAP_GROUP_SIZE; i ++) {
+        result |= (uint32_t)(ctrl[i] < 0) << i;
+    }
+    return result;
+#endif
+}
+
+/* Index of lowest set bit in group mask */
+static
+int32_t flecs_map_ctz(
+    uint32_t mask)
+{
+    ecs_assert(mask != 0, ECS_INTERNAL_ERROR, NULL);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int32_t result = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        result ++;
+    }
+    return result;
+#endif
+}
+
+static
+uint64_t flecs_map_hash(
+    ecs_map_key_t key)
+{
+    return 11400714819323198485ull * key;
+}
+
+/* Get index of first group in probe sequence. The shift is 64 for maps with a
+ * single group, so shift in two steps to avoid undefined behavior. */
+static
+int32_t flecs_map_get_group(
+    uint8_t bucket_shift,
+    uint64_t hash)
+{
+    return (int32_t)((hash >> (bucket_shift - 1)) >> 1);
+}
+
+/* Get control byte for hash */
+static
+int8_t flecs_map_get_h2(
+    uint8_t bucket_shift,
+    uint64_t hash)
+{
+    return (int8_t)((hash >> (bucket_shift - 8)) & 0x7F);
+}
+
+/* Control bytes of maps without slots, so lookups don't have to test for it */
+static const int8_t flecs_map_empty_group[FLECS_MAP_GROUP_SIZE] = {
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY,
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY,
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY,
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY
+};
+
+static
+int32_t flecs_map_group_count(
+    int32_t capacity)
+{
+    return ECS_MAX(1, capacity / FLECS_MAP_GROUP_SIZE);
+}
+
+/* Storage of a map contains the slots, followed by the control bytes, followed
+ * by the number of deleted slots. The storage is kept in the buckets member, so
+ * that ecs_map_t has the same layout as without FLECS_MAP_SWISS. */
+static
+ecs_size_t flecs_map_storage_size(
+    int32_t capacity)
+{
+    return capacity * 2 * ECS_SIZEOF(ecs_map_data_t) +
+        ECS_MAX(capacity, FLECS_MAP_GROUP_SIZE) + ECS_SIZEOF(int32_t);
+}
+
+static
+ecs_map_data_t* flecs_map_slots(
+    const ecs_map_t *map)
+{
+    return (ecs_map_data_t*)(void*)map->buckets;
+}
+
+static
+int8_t* flecs_map_ctrl(
+    const ecs_map_t *map)
+{
+    if (!map->buckets) {
+        return ECS_CONST_CAST(int8_t*, flecs_map_empty_group);
+    }
+    return ECS_OFFSET(map->buckets, 
+        map->bucket_count * 2 * ECS_SIZEOF(ecs_map_data_t));
+}
+
+/* Only valid for maps with storage */
+static
+int32_t* flecs_map_deleted(
+    const ecs_map_t *map)
+{
+    ecs_assert(map->buckets != NULL, ECS_INTERNAL_ERROR, NULL);
+    return ECS_OFFSET(flecs_map_ctrl(map), 
+        ECS_MAX(map->bucket_count, FLECS_MAP_GROUP_SIZE));
+}
+
+/* Find slot with key, return pointer to key/value pair */
+static
+ecs_map_data_t* flecs_map_find(
+    const ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_assert(map != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(map->bucket_shift != 0, ECS_INVALID_PARAMETER, NULL);
+
+    uint64_t hash = flecs_map_hash(key);
+    uint8_t shift = map->bucket_shift;
+    int8_t h2 = flecs_map_get_h2(shift, hash);
+    int32_t group = flecs_map_get_group(shift, hash);
+    int32_t probe = 0, mask = 0;
+    const int8_t *map_ctrl = flecs_map_ctrl(map);
+    ecs_map_data_t *slots = flecs_map_slots(map);
+
+    for (;;) {
+        int32_t first = group * FLECS_MAP_GROUP_SIZE;
+        const int8_t *ctrl = &map_ctrl[first];
+        uint32_t match = flecs_map_match(ctrl, h2);
+        while (match) {
+            ecs_map_data_t *kv = &slots[
+                (first + flecs_map_ctz(match)) * 2];
+            if (kv[0] == key) {
+                return kv;
+            }
+            match &= match - 1;
+        }
+
+        if (flecs_map_match(ctrl, FLECS_MAP_EMPTY)) {
+            return NULL;
+        }
+
+        if (!probe) {
+            mask = flecs_map_group_count(map->bucket_count) - 1;
+        }
+        if (++ probe > mask) {
+            return NULL;
+        }
+
+        /* Triangular probing visits all groups for power of 2 counts */
+        group = (group + probe) & mask;
+    }
+}
+
+/* Find empty or deleted slot for hash */
+static
+int32_t flecs_map_find_free(
+    const ecs_map_t *map,
+    uint64_t hash)
+{
+    int32_t capacity = map->bucket_count;
+    int32_t group = flecs_map_get_group(map->bucket_shift, hash);
+    int32_t probe, mask = flecs_map_group_count(capacity) - 1;
+    uint32_t valid = 0xFFFF;
+    if (capacity < FLECS_MAP_GROUP_SIZE) {
+        valid = (1u << capacity) - 1;
+    }
+
+    const int8_t *ctrl = flecs_map_ctrl(map);
+    for (probe = 0; probe <= mask; probe ++) {
+        int32_t first = group * FLECS_MAP_GROUP_SIZE;
+        uint32_t match = flecs_map_match_free(&ctrl[first]) & valid;
+        if (match) {
+            return first + flecs_map_ctz(match);
+        }
+        group = (group + probe + 1) & mask;
+    }
+
+    ecs_abort(ECS_INTERNAL_ERROR, NULL);
+}
+
+/* Reallocate slots, reinsert elements & drop deleted slots */
+static
+void flecs_map_rehash(
+    ecs_map_t *map,
+    int32_t capacity)
+{
+    ecs_assert(capacity >= map->count, ECS_INTERNAL_ERROR, NULL);
+    ecs_allocator_t *a = map->allocator;
+    int32_t i, old_capacity = map->bucket_count;
+    ecs_map_data_t *old_slots = flecs_map_slots(map);
+    int8_t *old_ctrl = flecs_map_ctrl(map);
+
+    ecs_size_t size = flecs_map_storage_size(capacity);
+    if (a) {
+        map->buckets = flecs_alloc(a, size);
+    } else {
+        map->buckets = ecs_os_malloc(size);
+    }
+    map->bucket_count = capacity;
+    map->bucket_shift = (uint8_t)(64u - flecs_log2(
+        (uint32_t)flecs_map_group_count(capacity)));
+
+    ecs_map_data_t *slots = flecs_map_slots(map);
+    int8_t *ctrl = flecs_map_ctrl(map);
+    ecs_os_memset(ctrl, FLECS_MAP_EMPTY,
+        ECS_MAX(capacity, FLECS_MAP_GROUP_SIZE));
+    flecs_map_deleted(map)[0] = 0;
+
+    for (i = 0; i < old_capacity; i ++) {
+        if (old_ctrl[i] < 0) {
+            continue;
+        }
+
+        ecs_map_data_t *kv = &old_slots[i * 2];
+        uint64_t hash = flecs_map_hash(kv[0]);
+        int32_t slot = flecs_map_find_free(map, hash);
+        ctrl[slot] = flecs_map_get_h2(map->bucket_shift, hash);
+        slots[slot * 2] = kv[0];
+        slots[slot * 2 + 1] = kv[1];
+    }
+
+    if (old_slots) {
+        if (a) {
+            flecs_free(a, flecs_map_storage_size(old_capacity), old_slots);
+        } else {
+            ecs_os_free(old_slots);
+        }
+    }
+}
+
+/* Add slot for key that is not yet in the map */
+static
+ecs_map_data_t* flecs_map_add(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    int32_t capacity = map->bucket_count;
+    int32_t deleted = map->buckets ? flecs_map_deleted(map)[0] : 0;
+    if ((map->count + deleted + 1) > FLECS_MAP_MAX_LOAD(capacity)) {
+        /* Grow if the map is more than half full, otherwise only clean up
+         * deleted slots */
+        capacity = ECS_MAX(capacity, FLECS_MAP_MIN_CAPACITY);
+        if (((map->count + 1) * 2) > FLECS_MAP_MAX_LOAD(capacity)) {
+            capacity *= 2;
+        }
+        flecs_map_rehash(map, capacity);
+    }
+
+    uint64_t hash = flecs_map_hash(key);
+    int32_t slot = flecs_map_find_free(map, hash);
+    int8_t *ctrl = flecs_map_ctrl(map);
+    if (ctrl[slot] == FLECS_MAP_DELETED) {
+        flecs_map_deleted(map)[0] --;
+    }
+    ctrl[slot] = flecs_map_get_h2(map->bucket_shift, hash);
+    map->count ++;
+
+    ecs_map_data_t *kv = &flecs_map_slots(map)[slot * 2];
+    kv[0] = key;
+    return kv;
+}
+
+static
+void flecs_map_free_slots(
+    ecs_map_t *map)
+{
+    if (!map->buckets) {
+        return;
+    }
+
+    if (map->allocator) {
+        flecs_free(map->allocator,
+            flecs_map_storage_size(map->bucket_count), map->buckets);
+    } else {
+        ecs_os_free(map->buckets);
+    }
+
+    map->buckets = NULL;
+    map->bucket_count = 0;
+    map->bucket_shift = 64;
+    map->count = 0;
+}
+
+void ecs_map_init_w_params(
+    ecs_map_t *result,
+    ecs_map_params_t *params)
+{
+    /* Slots are allocated on the first insert */
+    *result = (ecs_map_t){
+        .bucket_shift = 64,
+        .allocator = params->allocator
+    };
+}
+
+void ecs_map_fini(
+    ecs_map_t *map)
+{
+    if (!ecs_map_is_init(map)) {
+        return;
+    }
+
+    flecs_map_free_slots(map);
+    map->bucket_shift = 0;
+}
+
+ecs_map_val_t* ecs_map_get(
+    const ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_data_t *kv = flecs_map_find(map, key);
+    if (kv) {
+        return &kv[1];
+    }
+    return NULL;
+}
+
+void ecs_map_insert(
+    ecs_map_t *map,
+    ecs_map_key_t key,
+    ecs_map_val_t value)
+{
+    ecs_assert(ecs_map_get(map, key) == NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_map_add(map, key)[1] = value;
+}
+
+ecs_map_val_t* ecs_map_ensure(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_data_t *kv = flecs_map_find(map, key);
+    if (!kv) {
+        kv = flecs_map_add(map, key);
+        kv[1] = 0;
+    }
+    return &kv[1];
+}
+
+ecs_map_val_t ecs_map_remove(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_data_t *kv = flecs_map_find(map, key);
+    if (!kv) {
+        return 0;
+    }
+
+    int32_t slot = (int32_t)(kv - flecs_map_slots(map)) / 2;
+    int32_t first = slot - (slot % FLECS_MAP_GROUP_SIZE);
+    int8_t *ctrl = flecs_map_ctrl(map);
+
+    /* If the group has an empty slot no probe sequence continues past it, so
+     * the slot can be marked empty instead of deleted. */
+    if (flecs_map_match(&ctrl[first], FLECS_MAP_EMPTY)) {
+        ctrl[slot] = FLECS_MAP_EMPTY;
+    } else {
+        ctrl[slot] = FLECS_MAP_DELETED;
+        flecs_map_deleted(map)[0] ++;
+    }
+
+    map->count --;
+    return kv[1];
+}
+
+void ecs_map_clear(
+    ecs_map_t *map)
+{
+    ecs_assert(map != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_map_free_slots(map);
+}
+
+ecs_map_iter_t ecs_map_iter(
+    const ecs_map_t *map)
+{
+    if (ecs_map_is_init(map)) {
+        return (ecs_map_iter_t){
+            .map = map
+        };
+    } else {
+        return (ecs_map_iter_t){ 0 };
+    }
+}
+
+bool ecs_map_next(
+    ecs_map_iter_t *iter)
+{
+    const ecs_map_t *map = iter->map;
+    if (!map) {
+        return false;
+    }
+
+    /* Continue after the slot of the last returned element */
+    const int8_t *ctrl = flecs_map_ctrl(map);
+    ecs_map_data_t *slots = flecs_map_slots(map);
+    int32_t i, count = map->bucket_count;
+    i = iter->res ? (int32_t)(iter->res - slots) / 2 + 1 : 0;
+    for (; i < count; i ++) {
+        if (ctrl[i] >= 0) {
+            iter->res = &slots[i * 2];
+            return true;
+        }
+    }
+
+    iter->map = NULL;
+    return false;
+}
+
+#else
+
+/* The ratio used to determine whether the map should flecs_map_rehash. If
+ * (element_count * ECS_LOAD_FACTOR) > bucket_count, bucket count is increased. */
+#define ECS_LOAD_FACTOR (12)
+#define ECS_BUCKET_END(b, c) ECS_ELEM_T(b, ecs_bucket_t, c)
+
 /* Get bucket count for number of elements */
 static
 int32_t flecs_map_get_bucket_count(
@@ -38489,20 +40925,6 @@ void flecs_map_rehash(
     }
 }
 
-void ecs_map_params_init(
-    ecs_map_params_t *params,
-    ecs_allocator_t *allocator)
-{
-    params->allocator = allocator;
-    flecs_ballocator_init_t(&params->entry_allocator, ecs_bucket_entry_t);
-}
-
-void ecs_map_params_fini(
-    ecs_map_params_t *params)
-{
-    flecs_ballocator_fini(&params->entry_allocator);
-}
-
 void ecs_map_init_w_params(
     ecs_map_t *result,
     ecs_map_params_t *params)
@@ -38521,33 +40943,6 @@ void ecs_map_init_w_params(
     flecs_map_rehash(result, 0);
 }
 
-void ecs_map_init_w_params_if(
-    ecs_map_t *result,
-    ecs_map_params_t *params)
-{
-    if (!ecs_map_is_init(result)) {
-        ecs_map_init_w_params(result, params);
-    }
-}
-
-void ecs_map_init(
-    ecs_map_t *result,
-    ecs_allocator_t *allocator)
-{
-    ecs_map_init_w_params(result, &(ecs_map_params_t) {
-        .allocator = allocator
-    });
-}
-
-void ecs_map_init_if(
-    ecs_map_t *result,
-    ecs_allocator_t *allocator)
-{
-    if (!ecs_map_is_init(result)) {
-        ecs_map_init(result, allocator);
-    }   
-}
-
 void ecs_map_fini(
     ecs_map_t *map)
 {
@@ -38592,18 +40987,6 @@ ecs_map_val_t* ecs_map_get(
     return flecs_map_bucket_get(flecs_map_get_bucket(map, key), key);
 }
 
-void* ecs_map_get_deref_(
-    const ecs_map_t *map,
-    ecs_map_key_t key)
-{
-    ecs_map_val_t* ptr = flecs_map_bucket_get(
-        flecs_map_get_bucket(map, key), key);
-    if (ptr) {
-        return (void*)(uintptr_t)ptr[0];
-    }
-    return NULL;
-}
-
 void ecs_map_insert(
     ecs_map_t *map,
     ecs_map_key_t key,
@@ -38621,16 +41004,6 @@ void ecs_map_insert(
     flecs_map_bucket_add(map->entry_allocator, bucket, key)[0] = value;
 }
 
-void* ecs_map_insert_alloc(
-    ecs_map_t *map,
-    ecs_size_t elem_size,
-    ecs_map_key_t key)
-{
-    void *elem = ecs_os_calloc(elem_size);
-    ecs_map_insert_ptr(map, key, (uintptr_t)elem);
-    return elem;
-}
-
 ecs_map_val_t* ecs_map_ensure(
     ecs_map_t *map,
     ecs_map_key_t key)
@@ -38654,21 +41027,6 @@ ecs_map_val_t* ecs_map_ensure(
     return v;
 }
 
-void* ecs_map_ensure_alloc(
-    ecs_map_t *map,
-    ecs_size_t elem_size,
-    ecs_map_key_t key)
-{
-    ecs_map_val_t *val = ecs_map_ensure(map, key);
-    if (!*val) {
-        void *elem = ecs_os_calloc(elem_size);
-        *val = (ecs_map_val_t)(uintptr_t)elem;
-        return elem;
-    } else {
-        return (void*)(uintptr_t)*val;
-    }
-}
-
 ecs_map_val_t ecs_map_remove(
     ecs_map_t *map,
     ecs_map_key_t key)
@@ -38676,16 +41034,6 @@ ecs_map_val_t ecs_map_remove(
     return flecs_map_bucket_remove(map, flecs_map_get_bucket(map, key), key);
 }
 
-void ecs_map_remove_free(
-    ecs_map_t *map,
-    ecs_map_key_t key)
-{
-    ecs_map_val_t val = ecs_map_remove(map, key);
-    if (val) {
-        ecs_os_free((void*)(uintptr_t)val);
-    }
-}
-
 void ecs_map_clear(
     ecs_map_t *map)
 {
@@ -38759,6 +41107,95 @@ bool ecs_map_next(
     return true;
 }
 
+#endif
+
+void ecs_map_params_init(
+    ecs_map_params_t *params,
+    ecs_allocator_t *allocator)
+{
+    params->allocator = allocator;
+    flecs_ballocator_init_t(&params->entry_allocator, ecs_bucket_entry_t);
+}
+
+void ecs_map_params_fini(
+    ecs_map_params_t *params)
+{
+    flecs_ballocator_fini(&params->entry_allocator);
+}
+
+void ecs_map_init_w_params_if(
+    ecs_map_t *result,
+    ecs_map_params_t *params)
+{
+    if (!ecs_map_is_init(result)) {
+        ecs_map_init_w_params(result, params);
+    }
+}
+
+void ecs_map_init(
+    ecs_map_t *result,
+    ecs_allocator_t *allocator)
+{
+    ecs_map_init_w_params(result, &(ecs_map_params_t) {
+        .allocator = allocator
+    });
+}
+
+void ecs_map_init_if(
+    ecs_map_t *result,
+    ecs_allocator_t *allocator)
+{
+    if (!ecs_map_is_init(result)) {
+        ecs_map_init(result, allocator);
+    }   
+}
+
+void* ecs_map_get_deref_(
+    const ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_val_t* ptr = ecs_map_get(map, key);
+    if (ptr) {
+        return (void*)(uintptr_t)ptr[0];
+    }
+    return NULL;
+}
+
+void* ecs_map_insert_alloc(
+    ecs_map_t *map,
+    ecs_size_t elem_size,
+    ecs_map_key_t key)
+{
+    void *elem = ecs_os_calloc(elem_size);
+    ecs_map_insert_ptr(map, key, (uintptr_t)elem);
+    return elem;
+}
+
+void* ecs_map_ensure_alloc(
+    ecs_map_t *map,
+    ecs_size_t elem_size,
+    ecs_map_key_t key)
+{
+    ecs_map_val_t *val = ecs_map_ensure(map, key);
+    if (!*val) {
+        void *elem = ecs_os_calloc(elem_size);
+        *val = (ecs_map_val_t)(uintptr_t)elem;
+        return elem;
+    } else {
+        return (void*)(uintptr_t)*val;
+    }
+}
+
+void ecs_map_remove_free(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_val_t val = ecs_map_remove(map, key);
+    if (val) {
+        ecs_os_free((void*)(uintptr_t)val);
+    }
+}
+
 void ecs_map_copy(
     ecs_map_t *dst,
     const ecs_map_t *src)
@@ -41461,13 +43898,14 @@ void flecs_entity_index_fini(
     ecs_entity_index_t *index)
 {
     ecs_vec_fini_t(index->allocator, &index->dense, uint64_t);
-#if defined(FLECS_SANITIZE) || defined(FLECS_USE_OS_ALLOC)
+
+    /* Pages can be larger than FLECS_BALLOC_LARGE_SIZE, in which case they are
+     * not part of a block and aren't freed by flecs_ballocator_fini. */
     int32_t i, count = ecs_vec_count(&index->pages);
     ecs_entity_index_page_t **pages = ecs_vec_first(&index->pages);
     for (i = 0; i < count; i ++) {
         flecs_bfree(&index->page_allocator, pages[i]);
     }
-#endif
     ecs_vec_fini_t(index->allocator, &index->pages, ecs_entity_index_page_t*);
     flecs_ballocator_fini(&index->page_allocator);
 }
@@ -41696,23 +44134,100 @@ uint64_t* flecs_entity_index_new_ids(
         return ecs_vec_get_t(&index->dense, uint64_t, alive_count);
     }
 
-    /* Allocate new ids */
+    /* Allocate new ids. New ids are consecutive, so records can be initialized
+     * a page at a time. */
     ecs_vec_set_count_t(index->allocator, &index->dense, uint64_t, new_count);
-    int32_t i, to_add = new_count - dense_count;
-    for (i = 0; i < to_add; i ++) {
-        uint32_t id = (uint32_t)++ index->max_id;
-        int32_t dense = dense_count + i;
-        ecs_vec_get_t(&index->dense, uint64_t, dense)[0] = id;
+    uint64_t *ids = ecs_vec_first_t(&index->dense, uint64_t);
+    int32_t dense = dense_count;
+    while (dense < new_count) {
+        uint32_t id = (uint32_t)index->max_id + 1;
         ecs_entity_index_page_t *page = flecs_entity_index_ensure_page(index, id);
         ecs_assert(page != NULL, ECS_INTERNAL_ERROR, NULL);
-        ecs_record_t *r = &page->records[id & FLECS_ENTITY_PAGE_MASK];
-        r->dense = dense;
+
+        int32_t offset = (int32_t)(id & FLECS_ENTITY_PAGE_MASK);
+        int32_t i, to_add = FLECS_ENTITY_PAGE_SIZE - offset;
+        if (to_add > (new_count - dense)) {
+            to_add = new_count - dense;
+        }
+
+        ecs_record_t *r = &page->records[offset];
+        for (i = 0; i < to_add; i ++) {
+            ids[dense + i] = id + (uint32_t)i;
+            r[i].dense = dense + i;
+        }
+
+        index->max_id += (uint32_t)to_add;
+        dense += to_add;
     }
 
     index->alive_count = new_count;
     return ecs_vec_get_t(&index->dense, uint64_t, alive_count);
 }
 
+void flecs_entity_index_set_table(
+    ecs_entity_index_t *index,
+    const uint64_t *ids,
+    int32_t count,
+    ecs_table_t *table,
+    int32_t row,
+    ecs_record_t **records)
+{
+    int32_t i = 0;
+    while (i < count) {
+        uint32_t id = (uint32_t)ids[i];
+        int32_t page_index = (int32_t)(id >> FLECS_ENTITY_PAGE_BITS);
+        ecs_entity_index_page_t *page = ecs_vec_get_t(&index->pages, 
+            ecs_entity_index_page_t*, page_index)[0];
+        int32_t offset = (int32_t)(id & FLECS_ENTITY_PAGE_MASK);
+
+        /* Ids created in bulk are consecutive, so don't look up the page again
+         * until the ids are no longer consecutive or the page ends. */
+        do {
+            ecs_record_t *r = &page->records[offset];
+            ecs_assert(flecs_entity_index_is_alive(index, ids[i]), 
+                ECS_INVALID_PARAMETER, NULL);
+            r->table = table;
+            r->row = ECS_ROW_TO_RECORD(row + i, 0);
+            records[i] = r;
+            i ++;
+            offset ++;
+        } while ((i < count) && (offset < FLECS_ENTITY_PAGE_SIZE) && 
+            ((uint32_t)ids[i] == ((uint32_t)ids[i - 1] + 1)));
+    }
+}
+
+uint64_t flecs_entity_index_reserve_ids(
+    ecs_entity_index_t *index,
+    int32_t count)
+{
+    /* Can't atomically increase number above max int */
+    ecs_assert(index->max_id < (UINT_MAX - (uint32_t)count), 
+        ECS_INVALID_OPERATION, NULL);
+    uint32_t last = (uint32_t)ecs_os_aadd((int32_t*)&index->max_id, count);
+    return last - (uint32_t)count + 1;
+}
+
+void flecs_entity_index_release_ids(
+    ecs_entity_index_t *index,
+    uint64_t first,
+    int32_t count)
+{
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        uint32_t id = (uint32_t)first + (uint32_t)i;
+        ecs_entity_index_page_t *page = flecs_entity_index_ensure_page(index, id);
+        ecs_record_t *r = &page->records[id & FLECS_ENTITY_PAGE_MASK];
+        if (r->dense) {
+            /* Id was explicitly created by the application */
+            continue;
+        }
+
+        /* Add id to the not alive part of the dense array so it's recycled */
+        ecs_vec_append_t(index->allocator, &index->dense, uint64_t)[0] = id;
+        r->dense = ecs_vec_count(&index->dense) - 1;
+    }
+}
+
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
     int32_t size)
@@ -41938,6 +44453,167 @@ ecs_id_t flecs_id_record_hash(
     return id;
 }
 
+/* Get page of pair index for relationship or target, or NULL if the page has
+ * not been allocated yet. */
+static
+void* flecs_pair_index_get_page(
+    const ecs_vec_t *pages,
+    uint32_t index)
+{
+    int32_t page_index = (int32_t)(index >> FLECS_PAIR_INDEX_PAGE_BITS);
+    if (page_index >= ecs_vec_count(pages)) {
+        return NULL;
+    }
+    return ecs_vec_get_t(pages, void*, page_index)[0];
+}
+
+static
+void* flecs_pair_index_ensure_page(
+    ecs_world_t *world,
+    ecs_vec_t *pages,
+    uint32_t index,
+    ecs_size_t page_size,
+    bool *created)
+{
+    int32_t page_index = (int32_t)(index >> FLECS_PAIR_INDEX_PAGE_BITS);
+    if (page_index >= ecs_vec_count(pages)) {
+        ecs_vec_init_if_t(pages, void*);
+        ecs_vec_set_min_count_zeromem_t(&world->allocator, pages, void*,
+            page_index + 1);
+    }
+
+    void **page_ptr = ecs_vec_get_t(pages, void*, page_index);
+    if (!page_ptr[0]) {
+        page_ptr[0] = flecs_calloc(&world->allocator, page_size);
+        *created = true;
+    }
+
+    return page_ptr[0];
+}
+
+static
+void flecs_pair_index_free_page(
+    ecs_world_t *world,
+    ecs_vec_t *pages,
+    uint32_t index,
+    ecs_size_t page_size)
+{
+    int32_t page_index = (int32_t)(index >> FLECS_PAIR_INDEX_PAGE_BITS);
+    void **page_ptr = ecs_vec_get_t(pages, void*, page_index);
+    flecs_free(&world->allocator, page_size, page_ptr[0]);
+    page_ptr[0] = NULL;
+}
+
+/* Pairs without id flags other than ECS_PAIR are stored in the pair index if
+ * both the relationship and target are in the range of the index. */
+static
+bool flecs_id_record_is_indexed_pair(
+    ecs_id_t hash)
+{
+    return ((hash & ECS_ID_FLAGS_MASK) == ECS_PAIR) &&
+        (ECS_PAIR_FIRST(hash) < FLECS_HI_PAIR_INDEX_ID) &&
+        (ECS_PAIR_SECOND(hash) < FLECS_HI_PAIR_INDEX_ID);
+}
+
+/* Get element in pair index for pair id. Pair lookups don't hash the id, but
+ * index the relationship and target pages. */
+static
+ecs_id_record_t** flecs_pair_index_get(
+    const ecs_world_t *world,
+    ecs_id_t pair)
+{
+    uint32_t rel = (uint32_t)ECS_PAIR_FIRST(pair);
+    uint32_t tgt = (uint32_t)ECS_PAIR_SECOND(pair);
+
+    ecs_pair_index_rel_page_t *rels = flecs_pair_index_get_page(
+        &world->id_index_pairs, rel);
+    if (!rels) {
+        return NULL;
+    }
+
+    ecs_pair_index_page_t *tgts = flecs_pair_index_get_page(
+        &rels->rels[rel & FLECS_PAIR_INDEX_PAGE_MASK].pages, tgt);
+    if (!tgts) {
+        return NULL;
+    }
+
+    return &tgts->records[tgt & FLECS_PAIR_INDEX_PAGE_MASK];
+}
+
+static
+void flecs_pair_index_insert(
+    ecs_world_t *world,
+    ecs_id_t pair,
+    ecs_id_record_t *idr)
+{
+    uint32_t rel = (uint32_t)ECS_PAIR_FIRST(pair);
+    uint32_t tgt = (uint32_t)ECS_PAIR_SECOND(pair);
+    bool rels_created = false, tgts_created = false;
+
+    ecs_pair_index_rel_page_t *rels = flecs_pair_index_ensure_page(world,
+        &world->id_index_pairs, rel, ECS_SIZEOF(ecs_pair_index_rel_page_t),
+        &rels_created);
+    ecs_pair_index_t *index = &rels->rels[rel & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_pair_index_page_t *tgts = flecs_pair_index_ensure_page(world,
+        &index->pages, tgt, ECS_SIZEOF(ecs_pair_index_page_t), 
+        &tgts_created);
+
+    if (tgts_created) {
+        if (!index->count) {
+            rels->count ++;
+        }
+        index->count ++;
+    }
+
+    ecs_id_record_t **ptr = &tgts->records[tgt & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_assert(ptr[0] == NULL, ECS_INTERNAL_ERROR, NULL);
+    ptr[0] = idr;
+    tgts->count ++;
+}
+
+/* Remove id record from pair index. Pages that no longer contain id records
+ * are freed, except during world cleanup which frees the index at the end. */
+static
+void flecs_pair_index_remove(
+    ecs_world_t *world,
+    ecs_id_t pair,
+    ecs_id_record_t *idr)
+{
+    uint32_t rel = (uint32_t)ECS_PAIR_FIRST(pair);
+    uint32_t tgt = (uint32_t)ECS_PAIR_SECOND(pair);
+
+    ecs_pair_index_rel_page_t *rels = flecs_pair_index_get_page(
+        &world->id_index_pairs, rel);
+    ecs_assert(rels != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_pair_index_t *index = &rels->rels[rel & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_pair_index_page_t *tgts = flecs_pair_index_get_page(
+        &index->pages, tgt);
+    ecs_assert(tgts != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_id_record_t **ptr = &tgts->records[tgt & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_assert(ptr[0] == idr, ECS_INTERNAL_ERROR, NULL);
+    (void)idr;
+    ptr[0] = NULL;
+
+    if (-- tgts->count || (world->flags & EcsWorldFini)) {
+        return;
+    }
+
+    flecs_pair_index_free_page(world, &index->pages, tgt, 
+        ECS_SIZEOF(ecs_pair_index_page_t));
+    if (-- index->count) {
+        return;
+    }
+
+    ecs_vec_fini_t(&world->allocator, &index->pages, ecs_pair_index_page_t*);
+    if (-- rels->count) {
+        return;
+    }
+
+    flecs_pair_index_free_page(world, &world->id_index_pairs, rel, 
+        ECS_SIZEOF(ecs_pair_index_rel_page_t));
+}
+
 static
 ecs_id_record_t* flecs_id_record_new(
     ecs_world_t *world,
@@ -41945,7 +44621,10 @@ ecs_id_record_t* flecs_id_record_new(
 {
     ecs_id_record_t *idr, *idr_t = NULL;
     ecs_id_t hash = flecs_id_record_hash(id);
-    if (hash >= FLECS_HI_ID_RECORD_ID) {
+    if (flecs_id_record_is_indexed_pair(hash)) {
+        idr = flecs_bcalloc(&world->allocators.id_record);
+        flecs_pair_index_insert(world, hash, idr);
+    } else if (hash >= FLECS_HI_ID_RECORD_ID) {
         idr = flecs_bcalloc(&world->allocators.id_record);
         ecs_map_insert_ptr(&world->id_index_hi, hash, idr);
     } else {
@@ -41972,6 +44651,12 @@ ecs_id_record_t* flecs_id_record_new(
          * relationship are added to the (ChildOf, 0) id record */
         tgt = ECS_PAIR_SECOND(id);
 
+        /* Generations are unique for the world, so that a cache can't confuse
+         * a recreated (R, *) record with the record it was built for */
+        if (tgt == EcsWildcard) {
+            idr->trav_generation = ++ world->trav_generation;
+        }
+
 #ifdef FLECS_DEBUG
         /* Check constraints */
         if (tgt) {
@@ -42013,6 +44698,11 @@ ecs_id_record_t* flecs_id_record_new(
             if (rel == EcsUnion) {
                 idr->flags |= EcsIdUnion;
             }
+
+            /* Entities that were not a target can now be traversed */
+            if (idr->flags & EcsIdTraversable) {
+                idr_r->trav_generation = ++ world->trav_generation;
+            }
         }
     } else {
         rel = id & ECS_COMPONENT_MASK;
@@ -42040,11 +44730,11 @@ ecs_id_record_t* flecs_id_record_new(
         /* Flag for OnDeleteTarget policies */
         ecs_record_t *tgt_r = flecs_entities_get_any(world, tgt);
         ecs_assert(tgt_r != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecs_record_add_flag(tgt_r, EcsEntityIsTarget);
+        flecs_record_add_flag(world, tgt_r, EcsEntityIsTarget);
         if (idr->flags & EcsIdTraversable) {
             /* Flag used to determine if object should be traversed when
              * propagating events or with super/subset queries */
-            flecs_record_add_flag(tgt_r, EcsEntityIsTraversable);
+            flecs_record_add_flag(world, tgt_r, EcsEntityIsTraversable);
 
             /* Add reference to (*, tgt) id record to entity record */
             tgt_r->idr = idr_t;
@@ -42124,6 +44814,10 @@ void flecs_id_record_free(
         ecs_entity_t tgt = ECS_PAIR_SECOND(id);
         if (!ecs_id_is_wildcard(id)) {
             if (ECS_PAIR_FIRST(id) != EcsFlag) {
+                if (idr->flags & EcsIdTraversable) {
+                    flecs_id_record_trav_changed(world, rel);
+                }
+
                 /* If id is not a wildcard, remove it from the wildcard lists */
                 flecs_remove_id_elem(idr, ecs_pair(rel, EcsWildcard));
                 flecs_remove_id_elem(idr, ecs_pair(EcsWildcard, tgt));
@@ -42182,7 +44876,10 @@ void flecs_id_record_free(
     ecs_vec_fini_t(&world->allocator, &idr->reachable.ids, ecs_reachable_elem_t);
 
     ecs_id_t hash = flecs_id_record_hash(id);
-    if (hash >= FLECS_HI_ID_RECORD_ID) {
+    if (flecs_id_record_is_indexed_pair(hash)) {
+        flecs_pair_index_remove(world, hash, idr);
+        flecs_bfree(&world->allocators.id_record, idr);
+    } else if (hash >= FLECS_HI_ID_RECORD_ID) {
         ecs_map_remove(&world->id_index_hi, hash);
         flecs_bfree(&world->allocators.id_record, idr);
     } else {
@@ -42196,6 +44893,17 @@ void flecs_id_record_free(
     }
 }
 
+void flecs_id_record_trav_changed(
+    ecs_world_t *world,
+    ecs_entity_t rel)
+{
+    ecs_id_record_t *idr = flecs_id_record_get(world, 
+        ecs_pair(rel, EcsWildcard));
+    if (idr && (idr->flags & EcsIdTraversable)) {
+        idr->trav_generation = ++ world->trav_generation;
+    }
+}
+
 ecs_id_record_t* flecs_id_record_ensure(
     ecs_world_t *world,
     ecs_id_t id)
@@ -42222,7 +44930,12 @@ ecs_id_record_t* flecs_id_record_get(
 
     ecs_id_t hash = flecs_id_record_hash(id);
     ecs_id_record_t *idr = NULL;
-    if (hash >= FLECS_HI_ID_RECORD_ID) {
+    if (flecs_id_record_is_indexed_pair(hash)) {
+        ecs_id_record_t **ptr = flecs_pair_index_get(world, hash);
+        if (ptr) {
+            idr = ptr[0];
+        }
+    } else if (hash >= FLECS_HI_ID_RECORD_ID) {
         idr = ecs_map_get_deref(&world->id_index_hi, ecs_id_record_t, hash);
     } else {
         idr = &world->id_index_lo[hash];
@@ -42396,9 +45109,76 @@ void flecs_init_id_records(
         ecs_pair(EcsIsA, EcsWildcard));
 }
 
+/* Release pair id records & free the pages of the pair index */
+static
+void flecs_fini_pair_id_records(
+    ecs_world_t *world)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_t *rel_pages = &world->id_index_pairs;
+    int32_t p, r, t, i, count = ecs_vec_count(rel_pages);
+
+    /* Releasing an id record can release other id records, which clears their
+     * element in the index. Pages are not freed while the world is being
+     * deleted, so the index can be iterated while it's modified. */
+    for (p = 0; p < count; p ++) {
+        ecs_pair_index_rel_page_t *rels = ecs_vec_get_t(
+            rel_pages, ecs_pair_index_rel_page_t*, p)[0];
+        if (!rels) {
+            continue;
+        }
+
+        for (r = 0; r < FLECS_PAIR_INDEX_PAGE_SIZE; r ++) {
+            ecs_vec_t *tgt_pages = &rels->rels[r].pages;
+            int32_t tgt_count = ecs_vec_count(tgt_pages);
+            for (t = 0; t < tgt_count; t ++) {
+                ecs_pair_index_page_t *tgts = ecs_vec_get_t(
+                    tgt_pages, ecs_pair_index_page_t*, t)[0];
+                if (!tgts) {
+                    continue;
+                }
+
+                for (i = 0; i < FLECS_PAIR_INDEX_PAGE_SIZE; i ++) {
+                    ecs_id_record_t *idr;
+                    while ((idr = tgts->records[i])) {
+                        flecs_id_record_release(world, idr);
+                    }
+                }
+            }
+        }
+    }
+
+    for (p = 0; p < count; p ++) {
+        ecs_pair_index_rel_page_t *rels = ecs_vec_get_t(
+            rel_pages, ecs_pair_index_rel_page_t*, p)[0];
+        if (!rels) {
+            continue;
+        }
+
+        for (r = 0; r < FLECS_PAIR_INDEX_PAGE_SIZE; r ++) {
+            ecs_vec_t *tgt_pages = &rels->rels[r].pages;
+            int32_t tgt_count = ecs_vec_count(tgt_pages);
+            for (t = 0; t < tgt_count; t ++) {
+                ecs_pair_index_page_t *tgts = ecs_vec_get_t(
+                    tgt_pages, ecs_pair_index_page_t*, t)[0];
+                if (tgts) {
+                    flecs_free_t(a, ecs_pair_index_page_t, tgts);
+                }
+            }
+            ecs_vec_fini_t(a, tgt_pages, ecs_pair_index_page_t*);
+        }
+
+        flecs_free_t(a, ecs_pair_index_rel_page_t, rels);
+    }
+
+    ecs_vec_fini_t(a, rel_pages, ecs_pair_index_rel_page_t*);
+}
+
 void flecs_fini_id_records(
     ecs_world_t *world)
 {
+    flecs_fini_pair_id_records(world);
+
     /* Loop & delete first element until there are no elements left. Id records
      * can recursively delete each other, this ensures we always have a
      * valid iterator. */
@@ -42555,12 +45335,34 @@ ecs_flags32_t flecs_type_info_flags(
     return flags;  
 }
 
+/* Number of elements for which the storage size of a column is a multiple of
+ * the component alignment. The block allocator aligns chunks to the largest 
+ * power of two that divides the chunk size, so if a column is allocated in 
+ * multiples of this number, its storage starts on an aligned address and is 
+ * padded to a whole number of SIMD lanes. The number is doubled so that column
+ * storage is never smaller than twice the alignment, which sanitized builds of
+ * the block allocator rely on to keep chunks aligned. */
+static
+int32_t flecs_table_column_lane(
+    const ecs_type_info_t *ti)
+{
+    ecs_size_t align = ECS_MIN(ti->alignment, FLECS_BALLOC_MAX_ALIGN);
+    if (align <= 16) {
+        /* Allocator already guarantees 16 byte alignment */
+        return 1;
+    }
+
+    ecs_size_t size_align = ti->size & -ti->size;
+    return 2 * align / ECS_MIN(size_align, align);
+}
+
 static
 void flecs_table_init_columns(
     ecs_world_t *world,
     ecs_table_t *table,
     int32_t column_count)
 {
+    table->_->min_size = 1;
     if (!column_count) {
         return;
     }
@@ -42590,6 +45392,8 @@ void flecs_table_init_columns(
         columns[cur].ti = ECS_CONST_CAST(ecs_type_info_t*, ti);
         columns[cur].id = ids[i];
         columns[cur].size = ti->size;
+        table->_->min_size = ECS_MAX(table->_->min_size, 
+            flecs_table_column_lane(ti));
 
         if (ECS_IS_PAIR(ids[i])) {
             ecs_table_record_t *wc_tr = flecs_id_record_get_table(
@@ -43014,6 +45818,8 @@ void flecs_table_init(
     }
 
     if (table->flags & EcsTableHasOnTableCreate) {
+        /* Observers could read values of writes collected by a merge */
+        flecs_merge_writes_flush(world);
         flecs_emit(world, world, &(ecs_event_desc_t) {
             .ids = &table->type,
             .event = EcsOnTableCreate,
@@ -43298,6 +46104,35 @@ void flecs_table_dtor_all(
     }
 }
 
+/* Invalidate the traversal caches of the relationships in a table. Called when
+ * traversable entities are added to or removed from the table, as that changes
+ * which entities can be reached through the table's pairs. */
+static
+void flecs_table_traversable_changed(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    if (!(table->flags & EcsTableHasPairs)) {
+        return;
+    }
+
+    int32_t i, count = table->_->record_count;
+    ecs_table_record_t *records = table->_->records;
+    for (i = 0; i < count; i ++) {
+        ecs_id_record_t *idr = (ecs_id_record_t*)records[i].hdr.cache;
+        if (!(idr->flags & EcsIdTraversable)) {
+            continue;
+        }
+
+        ecs_id_t id = idr->id;
+        if (ECS_IS_PAIR(id) && (ECS_PAIR_SECOND(id) == EcsWildcard) &&
+            (ECS_PAIR_FIRST(id) != EcsWildcard))
+        {
+            idr->trav_generation = ++ world->trav_generation;
+        }
+    }
+}
+
 /* Cleanup table storage */
 static
 void flecs_table_fini_data(
@@ -43371,6 +46206,10 @@ void flecs_table_fini_data(
         flecs_table_set_empty(world, table);
     }
 
+    if (table->_->traversable_count) {
+        flecs_table_traversable_changed(world, table);
+    }
+
     table->_->traversable_count = 0;
     table->flags &= ~EcsTableHasTraversable;
 }
@@ -43518,9 +46357,14 @@ void flecs_table_reset(
  * traversable count and flag are used by code to early out of mechanisms like
  * event propagation and recursive cleanup. */
 void flecs_table_traversable_add(
+    ecs_world_t *world,
     ecs_table_t *table,
     int32_t value)
 {
+    if (value) {
+        flecs_table_traversable_changed(world, table);
+    }
+
     int32_t result = table->_->traversable_count += value;
     ecs_assert(result >= 0, ECS_INTERNAL_ERROR, NULL);
     if (result == 0) {
@@ -43779,7 +46623,7 @@ void flecs_table_grow_column(
         /* Move (and construct) existing elements to new vector */
         move_ctor(dst_buffer, src_buffer, count, ti);
 
-        if (construct) {
+        if (construct && to_add) {
             /* Construct new element(s) */
             result = ECS_ELEM(dst_buffer, size, count);
             ctor(result, to_add, ti);
@@ -43795,19 +46639,54 @@ void flecs_table_grow_column(
             ecs_vec_set_size(&world->allocator, &column->data, size, dst_size);
         }
 
-        result = ecs_vec_grow(&world->allocator, &column->data, size, to_add);
+        if (to_add) {
+            result = ecs_vec_grow(
+                &world->allocator, &column->data, size, to_add);
 
-        ecs_xtor_t ctor;
-        if (construct && (ctor = ti->hooks.ctor)) {
-            /* If new elements need to be constructed and component has a
-             * constructor, construct */
-            ctor(result, to_add, ti);
+            ecs_xtor_t ctor;
+            if (construct && (ctor = ti->hooks.ctor)) {
+                /* If new elements need to be constructed and component has a
+                 * constructor, construct */
+                ctor(result, to_add, ti);
+            }
         }
     }
 
     ecs_assert(column->data.size == dst_size, ECS_INTERNAL_ERROR, NULL);
 }
 
+/* Make sure table storage is large enough for the columns of over-aligned
+ * components to be aligned (see flecs_table_column_lane). */
+static
+void flecs_table_ensure_min_size(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_data_t *data)
+{
+    int32_t min_size = table->_->min_size;
+    if (min_size <= 1) {
+        return;
+    }
+
+    int32_t i, size = data->entities.size;
+    if (size < min_size || (size % min_size)) {
+        /* Vectors grow to the next power of two, which for sizes that aren't
+         * a multiple of min_size (also a power of two) is a multiple. */
+        ecs_allocator_t *a = &world->allocator;
+        size = ECS_MAX(size + 1, min_size);
+        ecs_vec_set_size_t(a, &data->entities, ecs_entity_t, size);
+        ecs_vec_set_size_t(a, &data->records, ecs_record_t*, size);
+        size = data->entities.size;
+    }
+
+    for (i = 0; i < table->column_count; i ++) {
+        ecs_column_t *column = &data->columns[i];
+        if (column->data.size != size) {
+            flecs_table_grow_column(world, column, 0, size, false);
+        }
+    }
+}
+
 /* Grow all data structures in a table */
 static
 int32_t flecs_table_grow_data(
@@ -43824,6 +46703,10 @@ int32_t flecs_table_grow_data(
     int32_t cur_count = flecs_table_data_count(data);
     int32_t column_count = table->column_count;
 
+    if (size < table->_->min_size) {
+        size = table->_->min_size;
+    }
+
     /* Add record to record ptr array */
     ecs_vec_set_size_t(&world->allocator, &data->records, ecs_record_t*, size);
     ecs_record_t **r = ecs_vec_last_t(&data->records, ecs_record_t*) + 1;
@@ -43923,6 +46806,10 @@ int32_t flecs_table_append(
     int32_t column_count = table->column_count;
     ecs_column_t *columns = table->data.columns;
 
+    if (data->entities.size < table->_->min_size) {
+        flecs_table_ensure_min_size(world, table, data);
+    }
+
     /* Grow buffer with entity ids, set new element to new entity */
     ecs_entity_t *e = ecs_vec_append_t(&world->allocator, 
         &data->entities, ecs_entity_t);
@@ -44196,6 +47083,92 @@ void flecs_table_fast_move(
     }
 }
 
+/* Move operation for tables that don't have any complex logic, with columns
+ * that were matched in advance */
+static
+void flecs_table_fast_move_w_plan(
+    ecs_table_t *dst_table,
+    int32_t dst_index,
+    ecs_table_t *src_table,
+    int32_t src_index,
+    const ecs_table_move_plan_t *plan)
+{
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+    const ecs_table_move_op_t *ops = plan->ops;
+
+    int32_t i, count = plan->count;
+    for (i = 0; i < count; i ++) {
+        const ecs_table_move_op_t *op = &ops[i];
+        if ((op->dst != -1) && (op->src != -1)) {
+            ecs_column_t *dst_column = &dst_columns[op->dst];
+            ecs_column_t *src_column = &src_columns[op->src];
+            int32_t size = dst_column->size;
+            void *dst = ecs_vec_get(&dst_column->data, size, dst_index);
+            void *src = ecs_vec_get(&src_column->data, size, src_index);
+            ecs_os_memcpy(dst, src, size);
+        }
+    }
+}
+
+/* Move component in a column that exists in both tables, or invoke hooks for
+ * a column that only exists in one of the tables. */
+static
+void flecs_table_move_column(
+    ecs_world_t *world,
+    ecs_entity_t dst_entity,
+    ecs_entity_t src_entity,
+    ecs_table_t *dst_table,
+    ecs_column_t *dst_column,
+    int32_t dst_index,
+    ecs_table_t *src_table,
+    ecs_column_t *src_column,
+    int32_t src_index,
+    bool construct,
+    bool use_move_dtor)
+{
+    if (dst_column && src_column) {
+        int32_t size = dst_column->size;
+
+        ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+        void *dst = ecs_vec_get(&dst_column->data, size, dst_index);
+        void *src = ecs_vec_get(&src_column->data, size, src_index);
+        ecs_type_info_t *ti = dst_column->ti;
+
+        /* If the source and destination entities are the same, move component 
+         * between tables. If the entities are not the same (like when cloning)
+         * use a copy. */
+        if (dst_entity == src_entity) {
+            ecs_move_t move = ti->hooks.move_ctor;
+            if (use_move_dtor || !move) {
+                /* Also use move_dtor if component doesn't have a move_ctor
+                 * registered, to ensure that the dtor gets called to 
+                 * cleanup resources. */
+                move = ti->hooks.ctor_move_dtor;
+            }
+
+            if (move) {
+                move(dst, src, 1, ti);
+            } else {
+                ecs_os_memcpy(dst, src, size);
+            }
+        } else {
+            ecs_copy_t copy = ti->hooks.copy_ctor;
+            if (copy) {
+                copy(dst, src, 1, ti);
+            } else {
+                ecs_os_memcpy(dst, src, size);
+            }
+        }
+    } else if (dst_column) {
+        flecs_table_invoke_add_hooks(world, dst_table,
+            dst_column, &dst_entity, dst_index, 1, construct);
+    } else {
+        flecs_table_invoke_remove_hooks(world, src_table,
+            src_column, &src_entity, src_index, 1, use_move_dtor);
+    }
+}
+
 /* Move entity from src to dst table */
 void flecs_table_move(
     ecs_world_t *world,
@@ -44205,7 +47178,8 @@ void flecs_table_move(
     int32_t dst_index,
     ecs_table_t *src_table,
     int32_t src_index,
-    bool construct)
+    bool construct,
+    const ecs_table_move_plan_t *plan)
 {
     ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -44219,7 +47193,12 @@ void flecs_table_move(
     flecs_table_check_sanity(src_table);
 
     if (!((dst_table->flags | src_table->flags) & EcsTableIsComplex)) {
-        flecs_table_fast_move(dst_table, dst_index, src_table, src_index);
+        if (plan) {
+            flecs_table_fast_move_w_plan(
+                dst_table, dst_index, src_table, src_index, plan);
+        } else {
+            flecs_table_fast_move(dst_table, dst_index, src_table, src_index);
+        }
         flecs_table_check_sanity(dst_table);
         flecs_table_check_sanity(src_table);
         return;
@@ -44228,68 +47207,45 @@ void flecs_table_move(
     flecs_table_move_switch_columns(dst_table, dst_index, src_table, src_index, 1, false);
     flecs_table_move_bitset_columns(dst_table, dst_index, src_table, src_index, 1, false);
 
-    /* If the source and destination entities are the same, move component 
-     * between tables. If the entities are not the same (like when cloning) use
-     * a copy. */
-    bool same_entity = dst_entity == src_entity;
-
     /* Call move_dtor for moved away from storage only if the entity is at the
      * last index in the source table. If it isn't the last entity, the last 
      * entity in the table will be moved to the src storage, which will take
      * care of cleaning up resources. */
     bool use_move_dtor = ecs_table_count(src_table) == (src_index + 1);
 
-    int32_t i_new = 0, dst_column_count = dst_table->column_count;
-    int32_t i_old = 0, src_column_count = src_table->column_count;
-
     ecs_column_t *src_columns = src_table->data.columns;
     ecs_column_t *dst_columns = dst_table->data.columns;
 
+    if (plan) {
+        const ecs_table_move_op_t *ops = plan->ops;
+        int32_t i, count = plan->count;
+        for (i = 0; i < count; i ++) {
+            const ecs_table_move_op_t *op = &ops[i];
+            flecs_table_move_column(world, dst_entity, src_entity, 
+                dst_table, op->dst != -1 ? &dst_columns[op->dst] : NULL,
+                dst_index,
+                src_table, op->src != -1 ? &src_columns[op->src] : NULL,
+                src_index, construct, use_move_dtor);
+        }
+
+        flecs_table_check_sanity(dst_table);
+        flecs_table_check_sanity(src_table);
+        return;
+    }
+
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+
     for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
         ecs_column_t *dst_column = &dst_columns[i_new];
         ecs_column_t *src_column = &src_columns[i_old];
         ecs_id_t dst_id = dst_column->id;
         ecs_id_t src_id = src_column->id;
 
-        if (dst_id == src_id) {
-            int32_t size = dst_column->size;
-
-            ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
-            void *dst = ecs_vec_get(&dst_column->data, size, dst_index);
-            void *src = ecs_vec_get(&src_column->data, size, src_index);
-            ecs_type_info_t *ti = dst_column->ti;
-
-            if (same_entity) {
-                ecs_move_t move = ti->hooks.move_ctor;
-                if (use_move_dtor || !move) {
-                    /* Also use move_dtor if component doesn't have a move_ctor
-                     * registered, to ensure that the dtor gets called to 
-                     * cleanup resources. */
-                    move = ti->hooks.ctor_move_dtor;
-                }
-
-                if (move) {
-                    move(dst, src, 1, ti);
-                } else {
-                    ecs_os_memcpy(dst, src, size);
-                }
-            } else {
-                ecs_copy_t copy = ti->hooks.copy_ctor;
-                if (copy) {
-                    copy(dst, src, 1, ti);
-                } else {
-                    ecs_os_memcpy(dst, src, size);
-                }
-            }
-        } else {
-            if (dst_id < src_id) {
-                flecs_table_invoke_add_hooks(world, dst_table,
-                    dst_column, &dst_entity, dst_index, 1, construct);
-            } else {
-                flecs_table_invoke_remove_hooks(world, src_table,
-                    src_column, &src_entity, src_index, 1, use_move_dtor);
-            }
-        }
+        flecs_table_move_column(world, dst_entity, src_entity, 
+            dst_table, dst_id <= src_id ? dst_column : NULL, dst_index,
+            src_table, dst_id >= src_id ? src_column : NULL, src_index,
+            construct, use_move_dtor);
 
         i_new += dst_id <= src_id;
         i_old += dst_id >= src_id;
@@ -44309,6 +47265,63 @@ void flecs_table_move(
     flecs_table_check_sanity(src_table);
 }
 
+ecs_table_move_plan_t* flecs_table_move_plan_init(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table)
+{
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+    int32_t count = 0, max_count = dst_column_count + src_column_count;
+
+    ecs_table_move_plan_t *plan = flecs_alloc(&world->allocator, 
+        ECS_SIZEOF(ecs_table_move_plan_t) + 
+            max_count * ECS_SIZEOF(ecs_table_move_op_t));
+    ecs_table_move_op_t *ops = plan->ops = 
+        ECS_OFFSET_T(plan, ecs_table_move_plan_t);
+    plan->size = max_count;
+
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+
+    /* Same iteration order as flecs_table_move, so that hooks are invoked in
+     * the same order when moving with a plan. */
+    for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
+        ecs_id_t dst_id = dst_columns[i_new].id;
+        ecs_id_t src_id = src_columns[i_old].id;
+        ops[count].dst = flecs_ito(int16_t, dst_id <= src_id ? i_new : -1);
+        ops[count].src = flecs_ito(int16_t, dst_id >= src_id ? i_old : -1);
+        count ++;
+        i_new += dst_id <= src_id;
+        i_old += dst_id >= src_id;
+    }
+
+    for (; (i_new < dst_column_count); i_new ++) {
+        ops[count].dst = flecs_ito(int16_t, i_new);
+        ops[count].src = -1;
+        count ++;
+    }
+
+    for (; (i_old < src_column_count); i_old ++) {
+        ops[count].dst = -1;
+        ops[count].src = flecs_ito(int16_t, i_old);
+        count ++;
+    }
+
+    ecs_assert(count <= max_count, ECS_INTERNAL_ERROR, NULL);
+    plan->count = count;
+
+    return plan;
+}
+
+void flecs_table_move_plan_fini(
+    ecs_world_t *world,
+    ecs_table_move_plan_t *plan)
+{
+    flecs_free(&world->allocator, ECS_SIZEOF(ecs_table_move_plan_t) + 
+        plan->size * ECS_SIZEOF(ecs_table_move_op_t), plan);
+}
+
 /* Append n entities to table */
 int32_t flecs_table_appendn(
     ecs_world_t *world,
@@ -44370,6 +47383,11 @@ bool flecs_table_shrink(
         ecs_vec_reclaim(&world->allocator, &column->data, column->size);
     }
 
+    if (data->entities.count) {
+        /* Restore padding of over-aligned columns */
+        flecs_table_ensure_min_size(world, table, data);
+    }
+
     return has_payload;
 }
 
@@ -44654,6 +47672,9 @@ void flecs_table_merge_data(
         ecs_vec_fini(a, &column->data, column->size);
     }    
 
+    /* Storage of source table may not be padded for over-aligned columns */
+    flecs_table_ensure_min_size(world, dst_table, dst_data);
+
     /* Mark entity column as dirty */
     flecs_table_mark_table_dirty(world, dst_table, 0); 
 }
@@ -44732,8 +47753,10 @@ void flecs_table_merge(
         }
         flecs_table_set_empty(world, src_table);
 
-        flecs_table_traversable_add(dst_table, src_table->_->traversable_count);
-        flecs_table_traversable_add(src_table, -src_table->_->traversable_count);
+        flecs_table_traversable_add(world, dst_table, 
+            src_table->_->traversable_count);
+        flecs_table_traversable_add(world, src_table, 
+            -src_table->_->traversable_count);
         ecs_assert(src_table->_->traversable_count == 0, ECS_INTERNAL_ERROR, NULL);
     }
 
@@ -44741,6 +47764,81 @@ void flecs_table_merge(
     flecs_table_check_sanity(dst_table);
 }
 
+/* Move all entities from one table to another. This is the same as a merge,
+ * except that the on_add and on_remove hooks of components that only exist in
+ * one of the tables are invoked, like when moving entities one by one. */
+int32_t flecs_table_move_all(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table)
+{
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != src_table, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t src_count = ecs_table_count(src_table);
+    int32_t dst_count = ecs_table_count(dst_table);
+    if (!src_count) {
+        return dst_count;
+    }
+
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+
+    /* Invoke on_remove hooks while the components still exist */
+    ecs_entity_t *entities = ecs_vec_first(&src_table->data.entities);
+    for (; i_old < src_column_count; ) {
+        ecs_column_t *src_column = &src_columns[i_old];
+        ecs_id_t src_id = src_column->id;
+        ecs_id_t dst_id = 0;
+        if (i_new < dst_column_count) {
+            dst_id = dst_columns[i_new].id;
+        }
+
+        if (!dst_id || (dst_id > src_id)) {
+            ecs_iter_action_t on_remove = src_column->ti->hooks.on_remove;
+            if (on_remove) {
+                flecs_table_invoke_hook(world, src_table, on_remove, 
+                    EcsOnRemove, src_column, entities, 0, src_count);
+            }
+        }
+
+        i_new += dst_id && (dst_id <= src_id);
+        i_old += !dst_id || (dst_id >= src_id);
+    }
+
+    flecs_table_merge(world, dst_table, src_table, 
+        &dst_table->data, &src_table->data);
+
+    /* Invoke on_add hooks for components that were constructed by the merge */
+    entities = ecs_vec_get_t(&dst_table->data.entities, ecs_entity_t, dst_count);
+    i_new = 0;
+    i_old = 0;
+    for (; i_new < dst_column_count; ) {
+        ecs_column_t *dst_column = &dst_columns[i_new];
+        ecs_id_t dst_id = dst_column->id;
+        ecs_id_t src_id = 0;
+        if (i_old < src_column_count) {
+            src_id = src_columns[i_old].id;
+        }
+
+        if (!src_id || (dst_id < src_id)) {
+            ecs_iter_action_t on_add = dst_column->ti->hooks.on_add;
+            if (on_add) {
+                flecs_table_invoke_hook(world, dst_table, on_add, 
+                    EcsOnAdd, dst_column, entities, dst_count, src_count);
+            }
+        }
+
+        i_old += src_id && (src_id <= dst_id);
+        i_new += !src_id || (src_id >= dst_id);
+    }
+
+    return dst_count;
+}
+
 /* Replace data with other data. Used by snapshots to restore previous state. */
 void flecs_table_replace_data(
     ecs_world_t *world,
@@ -45701,6 +48799,7 @@ void flecs_table_diff_build_noalloc(
         .array = builder->added.array, .count = builder->added.count };
     diff->removed = (ecs_type_t){
         .array = builder->removed.array, .count = builder->removed.count };
+    diff->edge = NULL;
 }
 
 static
@@ -45811,6 +48910,9 @@ void flecs_table_disconnect_edge(
     if (diff) {
         flecs_table_diff_free(world, diff);
     }
+    if (edge->plan) {
+        flecs_table_move_plan_fini(world, edge->plan);
+    }
 
     /* If edge id is low, clear it from fast lookup array */
     if (id < FLECS_HI_COMPONENT_ID) {
@@ -46418,6 +49520,7 @@ ecs_table_t* flecs_table_traverse_remove(
             diff->removed.array = id_ptr;
             diff->removed.count = 1;
         }
+        diff->edge = edge;
     }
 
     return to;
@@ -46458,6 +49561,7 @@ ecs_table_t* flecs_table_traverse_add(
             diff->added.count = 1;
             diff->removed.count = 0;
         }
+        diff->edge = edge;
     }
 
     return to;
@@ -46488,6 +49592,20 @@ void flecs_init_root_table(
     (void)new_id;
 }
 
+ecs_table_move_plan_t* flecs_table_edge_move_plan(
+    ecs_world_t *world,
+    ecs_graph_edge_t *edge)
+{
+    ecs_table_move_plan_t *plan = edge->plan;
+    if (!plan) {
+        ecs_assert(edge->from != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(edge->to != NULL, ECS_INTERNAL_ERROR, NULL);
+        plan = edge->plan = flecs_table_move_plan_init(
+            world, edge->to, edge->from);
+    }
+    return plan;
+}
+
 void flecs_table_clear_edges(
     ecs_world_t *world,
     ecs_table_t *table)
@@ -55896,6 +59014,107 @@ error:
     return 0;
 }
 
+static
+const ecs_member_t* flecs_meta_find_member(
+    const ecs_world_t *world,
+    ecs_entity_t type,
+    const char *name,
+    ecs_size_t len)
+{
+    const EcsStruct *st = ecs_get(world, type, EcsStruct);
+    if (!st) {
+        char *path = ecs_get_fullpath(world, type);
+        ecs_err("cannot resolve member '%.*s' for non-struct type '%s'", 
+            len, name, path);
+        ecs_os_free(path);
+        return NULL;
+    }
+
+    const ecs_member_t *members = ecs_vec_first_t(&st->members, ecs_member_t);
+    int32_t i, count = ecs_vec_count(&st->members);
+    for (i = 0; i < count; i ++) {
+        const char *member_name = members[i].name;
+        if (!ecs_os_strncmp(member_name, name, len) && !member_name[len]) {
+            return &members[i];
+        }
+    }
+
+    char *path = ecs_get_fullpath(world, type);
+    ecs_err("unknown member '%.*s' for type '%s'", len, name, path);
+    ecs_os_free(path);
+    return NULL;
+}
+
+ecs_member_ref_t ecs_meta_member_ref(
+    const ecs_world_t *world,
+    ecs_entity_t type,
+    const char *member)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(type != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(member != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    world = ecs_get_world(world);
+
+    /* Walk (nested) struct members, adding up the member offsets */
+    ecs_entity_t member_type = type;
+    ecs_size_t offset = 0;
+    const char *ptr = member;
+    do {
+        const char *dot = strchr(ptr, '.');
+        ecs_size_t len = dot ? flecs_ito(ecs_size_t, dot - ptr) : 
+            ecs_os_strlen(ptr);
+        const ecs_member_t *m = flecs_meta_find_member(
+            world, member_type, ptr, len);
+        if (!m) {
+            goto error;
+        }
+
+        offset += m->offset;
+        member_type = m->type;
+        ptr = dot ? dot + 1 : NULL;
+    } while (ptr);
+
+    const EcsComponent *comp = ecs_get(world, member_type, EcsComponent);
+    ecs_check(comp != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    return (ecs_member_ref_t){
+        .type = type,
+        .member_type = member_type,
+        .offset = offset,
+        .size = comp->size
+    };
+error:
+    return (ecs_member_ref_t){ 0 };
+}
+
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int32_t index,
+    const ecs_member_ref_t *member)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(member != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(member->member_type != 0, ECS_INVALID_PARAMETER, 
+        "member was not resolved");
+    ecs_check(!size || member->size == flecs_uto(ecs_size_t, size), 
+        ECS_INVALID_PARAMETER, "size mismatch for member");
+    (void)size;
+    ecs_assert(ecs_get_typeid(it->real_world, ecs_field_id(it, index)) == 
+        member->type, ECS_INVALID_PARAMETER, 
+            "member does not belong to field type");
+
+    void *ptr = ecs_field_w_size(it, 0, index);
+    if (!ptr) {
+        return NULL;
+    }
+
+    return ECS_OFFSET(ptr, member->offset);
+error:
+    return NULL;
+}
+
 double ecs_meta_ptr_to_float(
     ecs_primitive_kind_t type_kind,
     const void *ptr)
@@ -57688,6 +60907,12 @@ void ecs_meta_type_serialized_init(
  * @brief Builtin implementation for OS API.
  */
 
+/* Exposes syscall() and mremap(). This only has an effect if no system headers
+ * have been included yet, which is not the case in the amalgamated source. */
+#if defined(__linux__) && !defined(_GNU_SOURCE) && !defined(FLECS_PRIVATE_H)
+#define _GNU_SOURCE
+#endif
+
 
 #ifdef FLECS_OS_API_IMPL
 #ifdef ECS_TARGET_WINDOWS
@@ -57761,6 +60986,14 @@ int32_t win_adec(
     return InterlockedDecrement((volatile long*)count);
 }
 
+static
+int32_t win_aadd(
+    int32_t *count,
+    int32_t add) 
+{
+    return InterlockedExchangeAdd((volatile long*)count, add) + add;
+}
+
 static
 int64_t win_lainc(
     int64_t *count) 
@@ -57960,6 +61193,7 @@ void ecs_set_os_api_impl(void) {
     api.adec_ = win_adec;
     api.lainc_ = win_lainc;
     api.ladec_ = win_ladec;
+    api.aadd_ = win_aadd;
     api.mutex_new_ = win_mutex_new;
     api.mutex_free_ = win_mutex_free;
     api.mutex_lock_ = win_mutex_lock;
@@ -57998,6 +61232,23 @@ void ecs_set_os_api_impl(void) {
 #include <time.h>
 #endif
 
+/* The system headers only declare syscall() when GNU or default extensions are 
+ * enabled, which is not the case if the application requests strict POSIX. */
+#if defined(__linux__) && (defined(_GNU_SOURCE) || \
+    defined(_DEFAULT_SOURCE) || defined(_BSD_SOURCE))
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#if defined(SYS_futex) && defined(__GNUC__)
+#include <linux/futex.h>
+#include <limits.h>
+#define POSIX_HAS_FUTEX
+#endif
+
+#include <sys/mman.h>
+#define POSIX_HAS_PAGES
+#endif
+
 /* This mutex is used to emulate atomic operations when the gnu builtins are
  * not supported. This is probably not very fast but if the compiler doesn't
  * support the gnu built-ins, then speed is probably not a priority. */
@@ -58076,6 +61327,27 @@ int32_t posix_adec(
 #endif
 }
 
+static
+int32_t posix_aadd(
+    int32_t *count,
+    int32_t add)
+{
+    int32_t value;
+#ifdef __GNUC__
+    value = __sync_add_and_fetch (count, add);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = (*count) += add;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
 static
 int64_t posix_lainc(
     int64_t *count)
@@ -58206,6 +61478,194 @@ void posix_cond_wait(
     }
 }
 
+#ifdef POSIX_HAS_FUTEX
+
+/* Number of times a waiting thread checks a value before it parks. The spin 
+ * count adapts to how long threads typically wait: it grows when values change
+ * while spinning, and shrinks when threads end up parking anyway. */
+#define POSIX_FUTEX_SPIN_MIN (16)
+#define POSIX_FUTEX_SPIN_MAX (4096)
+
+static int32_t posix_futex_spin = 256;
+
+static
+void posix_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ __volatile__("pause");
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static
+void posix_futex_wait(
+    int32_t *value,
+    int32_t expected)
+{
+    int32_t i, spin = __atomic_load_n(&posix_futex_spin, __ATOMIC_RELAXED);
+    for (i = 0; i < spin; i ++) {
+        if (__atomic_load_n(value, __ATOMIC_ACQUIRE) != expected) {
+            if (spin < POSIX_FUTEX_SPIN_MAX) {
+                __atomic_store_n(&posix_futex_spin, spin * 2, __ATOMIC_RELAXED);
+            }
+            return;
+        }
+        posix_cpu_relax();
+    }
+
+    if (spin > POSIX_FUTEX_SPIN_MIN) {
+        __atomic_store_n(&posix_futex_spin, spin / 2, __ATOMIC_RELAXED);
+    }
+
+    while (__atomic_load_n(value, __ATOMIC_ACQUIRE) == expected) {
+        /* Returns immediately if value no longer equals expected */
+        syscall(SYS_futex, value, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+    }
+}
+
+static
+void posix_futex_wake(
+    int32_t *value)
+{
+    syscall(SYS_futex, value, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+#endif
+
+#ifdef POSIX_HAS_PAGES
+
+/* Mappings are aligned to the size of a transparent huge page, so that the 
+ * kernel can back as much of a mapping with huge pages as possible. */
+#define POSIX_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE (14)
+#endif
+
+static
+size_t posix_page_round(
+    size_t size,
+    size_t page_size)
+{
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+static
+bool posix_page_advise(
+    void *ptr,
+    size_t size)
+{
+    /* Fails if the kernel doesn't support transparent huge pages, in which 
+     * case the mapping uses regular pages */
+    return madvise(ptr, size, MADV_HUGEPAGE) == 0;
+}
+
+/* Map region of len bytes that starts on a huge page boundary */
+static
+void* posix_page_map_aligned(
+    size_t len)
+{
+    size_t map_len = len + POSIX_HUGE_PAGE_SIZE;
+    void *ptr = mmap(NULL, map_len, PROT_READ | PROT_WRITE, 
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+
+    /* Trim mapping so that it starts on a huge page boundary */
+    uintptr_t addr = (uintptr_t)ptr;
+    uintptr_t aligned = posix_page_round(addr, POSIX_HUGE_PAGE_SIZE);
+    size_t head = aligned - addr;
+    size_t tail = map_len - head - len;
+    if (head) {
+        munmap(ptr, head);
+    }
+    if (tail) {
+        munmap((void*)(aligned + len), tail);
+    }
+
+    return (void*)aligned;
+}
+
+static
+void* posix_page_alloc(
+    ecs_size_t size,
+    bool *huge)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t len = posix_page_round((size_t)size, page_size);
+    void *result = posix_page_map_aligned(len);
+    if (result) {
+        *huge = posix_page_advise(result, len);
+    }
+    return result;
+}
+
+static
+void posix_page_free(
+    void *ptr,
+    ecs_size_t size)
+{
+    munmap(ptr, (size_t)size);
+}
+
+/* Remap pages in place, or move them to dst if not NULL. Returns MAP_FAILED if
+ * that isn't possible, or if mremap is not available (requires _GNU_SOURCE). */
+static
+void* posix_page_remap(
+    void *ptr,
+    size_t old_len,
+    size_t len,
+    void *dst)
+{
+#ifdef MREMAP_FIXED
+    if (dst) {
+        return mremap(ptr, old_len, len, MREMAP_MAYMOVE | MREMAP_FIXED, dst);
+    }
+    return mremap(ptr, old_len, len, 0);
+#else
+    (void)ptr;
+    (void)old_len;
+    (void)len;
+    (void)dst;
+    return MAP_FAILED;
+#endif
+}
+
+static
+void* posix_page_realloc(
+    void *ptr,
+    ecs_size_t old_size,
+    ecs_size_t size,
+    bool *huge)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t old_len = posix_page_round((size_t)old_size, page_size);
+    size_t len = posix_page_round((size_t)size, page_size);
+
+    /* Resize in place, which keeps the huge page alignment */
+    void *result = posix_page_remap(ptr, old_len, len, NULL);
+    if (result == MAP_FAILED) {
+        /* Move pages to a new region that is aligned to a huge page boundary, 
+         * instead of letting the kernel pick an address, which may not be. */
+        result = posix_page_map_aligned(len);
+        if (!result) {
+            return NULL;
+        }
+
+        void *moved = posix_page_remap(ptr, old_len, len, result);
+        if (moved == MAP_FAILED) {
+            ecs_os_memcpy(result, ptr, ECS_MIN(old_size, size));
+            posix_page_free(ptr, old_size);
+        }
+    }
+
+    *huge = posix_page_advise(result, len);
+    return result;
+}
+
+#endif
+
 static bool posix_time_initialized;
 
 #if defined(__APPLE__) && defined(__MACH__)
@@ -58297,6 +61757,7 @@ void ecs_set_os_api_impl(void) {
     api.adec_ = posix_adec;
     api.lainc_ = posix_lainc;
     api.ladec_ = posix_ladec;
+    api.aadd_ = posix_aadd;
     api.mutex_new_ = posix_mutex_new;
     api.mutex_free_ = posix_mutex_free;
     api.mutex_lock_ = posix_mutex_lock;
@@ -58306,6 +61767,15 @@ void ecs_set_os_api_impl(void) {
     api.cond_signal_ = posix_cond_signal;
     api.cond_broadcast_ = posix_cond_broadcast;
     api.cond_wait_ = posix_cond_wait;
+#ifdef POSIX_HAS_FUTEX
+    api.futex_wait_ = posix_futex_wait;
+    api.futex_wake_ = posix_futex_wake;
+#endif
+#ifdef POSIX_HAS_PAGES
+    api.page_alloc_ = posix_page_alloc;
+    api.page_realloc_ = posix_page_realloc;
+    api.page_free_ = posix_page_free;
+#endif
     api.sleep_ = posix_sleep;
     api.now_ = posix_time_now;
 
@@ -58553,6 +62023,139 @@ bool flecs_pipeline_check_terms(
     return needs_merge;
 }
 
+typedef struct ecs_access_state_t {
+    bool barrier;
+    ecs_map_t reads;
+    ecs_map_t writes;
+} ecs_access_state_t;
+
+static
+bool flecs_pipeline_access_match(
+    ecs_map_t *ids,
+    ecs_id_t id)
+{
+    if (ecs_map_get(ids, id)) {
+        return true;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(ids);
+    while (ecs_map_next(&it)) {
+        ecs_id_t key = ecs_map_key(&it);
+        if (ecs_id_match(key, id) || ecs_id_match(id, key)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Get the components a term reads from or writes to. Uses the same rules for
+ * default inout kinds as flecs_pipeline_check_term. */
+static
+void flecs_pipeline_term_access(
+    ecs_term_t *term,
+    bool *read,
+    bool *write)
+{
+    *read = false;
+    *write = false;
+
+    ecs_inout_kind_t inout = term->inout;
+    if (inout == EcsInOutNone) {
+        return;
+    }
+
+    bool from_any = ecs_term_match_0(term);
+    bool from_this = ecs_term_match_this(term);
+    bool is_shared = !from_any && 
+        (!from_this || !(term->src.flags & EcsSelf));
+
+    if (inout == EcsInOutDefault) {
+        if (from_any) {
+            return;
+        } else if (is_shared) {
+            inout = EcsIn;
+        } else {
+            inout = EcsInOut;
+        }
+    }
+
+    if (term->oper == EcsNot && inout != EcsOut) {
+        /* Not terms only test whether a component is there */
+        return;
+    }
+
+    *read = inout == EcsIn || inout == EcsInOut;
+    *write = inout == EcsOut || inout == EcsInOut;
+}
+
+/* Test whether system can run in parallel with systems already in the state.
+ * Systems conflict if one of them writes a component the other one reads or
+ * writes. */
+static
+bool flecs_pipeline_access_conflicts(
+    ecs_access_state_t *as,
+    ecs_filter_t *filter)
+{
+    int32_t t, term_count = filter->term_count;
+    if (as->barrier || !term_count) {
+        return as->barrier || ecs_map_count(&as->reads) || 
+            ecs_map_count(&as->writes);
+    }
+
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &filter->terms[t];
+        bool read, write;
+        flecs_pipeline_term_access(term, &read, &write);
+        if (!read && !write) {
+            continue;
+        }
+
+        if (flecs_pipeline_access_match(&as->writes, term->id)) {
+            return true;
+        }
+        if (write && flecs_pipeline_access_match(&as->reads, term->id)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static
+void flecs_pipeline_add_access(
+    ecs_access_state_t *as,
+    ecs_filter_t *filter)
+{
+    int32_t t, term_count = filter->term_count;
+    if (!term_count) {
+        /* Can't tell what a system without terms accesses */
+        as->barrier = true;
+        return;
+    }
+
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &filter->terms[t];
+        bool read, write;
+        flecs_pipeline_term_access(term, &read, &write);
+        if (read) {
+            ecs_map_ensure(&as->reads, term->id)[0] = true;
+        }
+        if (write) {
+            ecs_map_ensure(&as->writes, term->id)[0] = true;
+        }
+    }
+}
+
+static
+void flecs_pipeline_reset_access(
+    ecs_access_state_t *as)
+{
+    ecs_map_clear(&as->reads);
+    ecs_map_clear(&as->writes);
+    as->barrier = false;
+}
+
 static
 EcsPoly* flecs_pipeline_term_system(
     ecs_iter_t *it)
@@ -58572,7 +62175,9 @@ bool flecs_pipeline_build(
 {
     ecs_iter_t it = ecs_query_iter(world, pq->query);
 
-    if (pq->match_count == pq->query->match_count) {
+    if (pq->match_count == pq->query->match_count && 
+        pq->parallel_systems == world->parallel_systems) 
+    {
         /* No need to rebuild the pipeline */
         ecs_iter_fini(&it);
         return false;
@@ -58586,6 +62191,9 @@ bool flecs_pipeline_build(
     ecs_write_state_t ws = {0};
     ecs_map_init(&ws.ids, a);
     ecs_map_init(&ws.wildcard_ids, a);
+    ecs_access_state_t as = {0};
+    ecs_map_init(&as.reads, a);
+    ecs_map_init(&as.writes, a);
 
     ecs_vec_reset_t(a, &pq->ops, ecs_pipeline_op_t);
     ecs_vec_reset_t(a, &pq->systems, ecs_entity_t);
@@ -58593,6 +62201,7 @@ bool flecs_pipeline_build(
     bool multi_threaded = false;
     bool no_readonly = false;
     bool first = true;
+    bool parallel = world->parallel_systems;
 
     /* Iterate systems in pipeline, add ops for running / merging */
     while (ecs_query_next(&it)) {
@@ -58655,6 +62264,24 @@ bool flecs_pipeline_build(
                 /* The component states were just reset, so if we conclude that
                  * another merge is needed something is wrong. */
                 ecs_assert(needs_merge == false, ECS_INTERNAL_ERROR, NULL);        
+
+                flecs_pipeline_reset_access(&as);
+            }
+
+            if (is_active && parallel && !multi_threaded && !no_readonly) {
+                if (flecs_pipeline_access_conflicts(&as, &q->filter)) {
+                    /* System accesses components that are written by a system
+                     * in the current operation (or vice versa). Insert a sync
+                     * point so the system runs after the operation has 
+                     * finished. Commands don't have to be merged, as the 
+                     * write state already inserts merges where needed. */
+                    if (op && op->count) {
+                        op->no_merge = true;
+                        op = NULL;
+                    }
+                    flecs_pipeline_reset_access(&as);
+                }
+                flecs_pipeline_add_access(&as, &q->filter);
             }
 
             if (!op) {
@@ -58663,6 +62290,8 @@ bool flecs_pipeline_build(
                 op->count = 0;
                 op->multi_threaded = false;
                 op->no_readonly = false;
+                op->parallel = false;
+                op->no_merge = false;
                 op->time_spent = 0;
                 op->commands_enqueued = 0;
             }
@@ -58675,6 +62304,7 @@ bool flecs_pipeline_build(
                 if (!op->count) {
                     op->multi_threaded = multi_threaded;
                     op->no_readonly = no_readonly;
+                    op->parallel = parallel && !multi_threaded && !no_readonly;
                 }
                 op->count ++;
             }
@@ -58687,9 +62317,19 @@ bool flecs_pipeline_build(
 
     ecs_map_fini(&ws.ids);
     ecs_map_fini(&ws.wildcard_ids);
+    ecs_map_fini(&as.reads);
+    ecs_map_fini(&as.writes);
 
     op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
 
+    /* Operations with a single system don't benefit from waking up workers */
+    int32_t o, op_count = ecs_vec_count(&pq->ops);
+    for (o = 0; o < op_count; o ++) {
+        if (op[o].count < 2) {
+            op[o].parallel = false;
+        }
+    }
+
     if (!op) {
         ecs_dbg("#[green]pipeline#[reset] is empty");
         return true;
@@ -58698,8 +62338,9 @@ bool flecs_pipeline_build(
         ecs_dbg("#[bold]pipeline rebuild");
         ecs_log_push_1();
 
-        ecs_dbg("#[green]schedule#[reset]: threading: %d, staging: %d:", 
-            op->multi_threaded, !op->no_readonly);
+        ecs_dbg("#[green]schedule#[reset]: threading: %d, staging: %d, "
+            "parallel: %d:", op->multi_threaded, !op->no_readonly, 
+            op->parallel);
         ecs_log_push_1();
 
         int32_t i, count = ecs_vec_count(&pq->systems);
@@ -58734,16 +62375,21 @@ bool flecs_pipeline_build(
 
             ran_since_merge ++;
             if (ran_since_merge == op[op_index].count) {
-                ecs_dbg("#[magenta]merge#[reset]");
+                if (op[op_index].no_merge) {
+                    ecs_dbg("#[magenta]sync#[reset]");
+                } else {
+                    ecs_dbg("#[magenta]merge#[reset]");
+                }
                 ecs_log_pop_1();
                 ran_since_merge = 0;
                 op_index ++;
                 if (op_index < ecs_vec_count(&pq->ops)) {
                     ecs_dbg(
                         "#[green]schedule#[reset]: "
-                        "threading: %d, staging: %d:",
+                        "threading: %d, staging: %d, parallel: %d:",
                         op[op_index].multi_threaded, 
-                        !op[op_index].no_readonly);
+                        !op[op_index].no_readonly,
+                        op[op_index].parallel);
                 }
                 ecs_log_push_1();
             }
@@ -58764,6 +62410,7 @@ bool flecs_pipeline_build(
     }
 
     pq->match_count = pq->query->match_count;
+    pq->parallel_systems = parallel;
 
     ecs_assert(pq->cur_op <= ecs_vec_last_t(&pq->ops, ecs_pipeline_op_t),
         ECS_INTERNAL_ERROR, NULL);
@@ -58858,13 +62505,25 @@ int32_t flecs_run_pipeline_ops(
     ecs_pipeline_op_t* op = pq->cur_op;
     int32_t i = pq->cur_i;
 
-    ecs_assert(!stage_index || op->multi_threaded, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!stage_index || op->multi_threaded || op->parallel, 
+        ECS_INTERNAL_ERROR, NULL);
 
     int32_t count = ecs_vec_count(&pq->systems);
     ecs_entity_t* systems = ecs_vec_first_t(&pq->systems, ecs_entity_t);
     int32_t ran_since_merge = i - op->offset;
 
     for (; i < count; i++) {
+        if (op->parallel && 
+            ((i - op->offset) % stage_count) != stage_index) 
+        {
+            /* System runs on another stage */
+            ran_since_merge++;
+            if (ran_since_merge == op->count) {
+                break;
+            }
+            continue;
+        }
+
         ecs_entity_t system = systems[i];
         const EcsPoly* poly = ecs_get_pair(world, system, EcsPoly, EcsSystem);
         ecs_poly_assert(poly->poly, ecs_system_t);
@@ -58883,9 +62542,13 @@ int32_t flecs_run_pipeline_ops(
         }
 
         ecs_run_intern(world, s, system, sys, stage_index,
-            stage_count, delta_time, 0, 0, NULL);
+            stage_count, world->worker_chunk_size, delta_time, 0, 0, NULL);
 
-        world->info.systems_ran_frame++;
+        if (op->parallel) {
+            ecs_os_linc(&world->info.systems_ran_frame);
+        } else {
+            world->info.systems_ran_frame++;
+        }
         ran_since_merge++;
 
         if (ran_since_merge == op->count) {
@@ -58897,6 +62560,26 @@ int32_t flecs_run_pipeline_ops(
     return i;
 }
 
+/* Reset chunk counters of systems in current operation before workers start
+ * claiming chunks */
+static
+void flecs_pipeline_reset_chunks(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_entity_t *systems = ecs_vec_first_t(&pq->systems, ecs_entity_t);
+    int32_t i, count = op->offset + op->count;
+
+    for (i = pq->cur_i; i < count; i ++) {
+        const EcsPoly *poly = ecs_get_pair(
+            world, systems[i], EcsPoly, EcsSystem);
+        ecs_poly_assert(poly->poly, ecs_system_t);
+        ecs_system_t *sys = (ecs_system_t*)poly->poly;
+        sys->worker_claimed = 0;
+    }
+}
+
 void flecs_run_pipeline(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -58914,6 +62597,7 @@ void flecs_run_pipeline(
     ecs_assert(!stage_index, ECS_INVALID_OPERATION, NULL);
 
     bool multi_threaded = ecs_get_stage_count(world) > 1;
+    bool readonly = false;
 
     // Update the pipeline the workers will execute
     world->pq = pq;
@@ -58930,18 +62614,24 @@ void flecs_run_pipeline(
         }
 
         bool no_readonly = pq->cur_op->no_readonly;
-        bool op_multi_threaded = multi_threaded && pq->cur_op->multi_threaded;
+        bool op_multi_threaded = multi_threaded && 
+            (pq->cur_op->multi_threaded || pq->cur_op->parallel);
+        bool no_merge = pq->cur_op->no_merge;
 
         pq->no_readonly = no_readonly;
 
-        if (!no_readonly) {
+        if (!no_readonly && !readonly) {
             ecs_readonly_begin(world);
+            readonly = true;
         }
 
         ECS_BIT_COND(world->flags, EcsWorldMultiThreaded, op_multi_threaded);
         ecs_assert(world->workers_waiting == 0, ECS_INTERNAL_ERROR, NULL);
 
         if (op_multi_threaded) {
+            if (world->worker_chunk_size) {
+                flecs_pipeline_reset_chunks(world, pq);
+            }
             flecs_signal_workers(world);
         }
 
@@ -58963,7 +62653,7 @@ void flecs_run_pipeline(
             flecs_wait_for_sync(world);
         }
 
-        if (!no_readonly) {
+        if (!no_readonly && !no_merge) {
             ecs_time_t mt = { 0 };
             if (measure_time) {
                 ecs_time_measure(&mt);
@@ -58976,6 +62666,7 @@ void flecs_run_pipeline(
             }
 
             ecs_readonly_end(world);
+            readonly = false;
             if (measure_time) {
                 pq->cur_op->time_spent += ecs_time_measure(&mt);
             }
@@ -58985,7 +62676,13 @@ void flecs_run_pipeline(
          * threads, to avoid race conditions. */
         pq->cur_i = i;
 
-        flecs_pipeline_update(world, pq, false);
+        if (readonly) {
+            /* Operation ended with a sync point without a merge. The world is
+             * still readonly, so the schedule can't have changed. */
+            flecs_pipeline_next_system(pq);
+        } else {
+            flecs_pipeline_update(world, pq, false);
+        }
     }
 }
 
@@ -59258,16 +62955,38 @@ void FlecsPipelineImport(
 
 #ifdef FLECS_PIPELINE
 
+/* Wait until main thread signals workers, futex version */
+static
+void flecs_wait_for_signal(
+    ecs_world_t *world,
+    int32_t *signal)
+{
+    ecs_os_futex_wait(&world->workers_signal, signal[0]);
+    signal[0] ++;
+}
+
 /* Synchronize workers */
 static
 void flecs_sync_worker(
-    ecs_world_t* world)
+    ecs_world_t* world,
+    int32_t *signal)
 {
     int32_t stage_count = ecs_get_stage_count(world);
     if (stage_count <= 1) {
         return;
     }
 
+    if (world->workers_use_futex) {
+        /* Last worker to reach the sync point wakes up the main thread */
+        if (!ecs_os_adec(&world->workers_pending)) {
+            ecs_os_ainc(&world->workers_synced);
+            ecs_os_futex_wake(&world->workers_synced);
+        }
+
+        flecs_wait_for_signal(world, signal);
+        return;
+    }
+
     /* Signal that thread is waiting */
     ecs_os_mutex_lock(world->sync_mutex);
     if (++world->workers_waiting == (stage_count - 1)) {
@@ -59280,6 +62999,55 @@ void flecs_sync_worker(
     ecs_os_mutex_unlock(world->sync_mutex);
 }
 
+/* Target number of bytes per chunk when no chunk size is provided */
+#define FLECS_PAR_EACH_CHUNK_BYTES (32 * 1024)
+
+/* Run job on stage. When the job runs on more than one thread, threads claim
+ * chunks (queries) or tables (rules) from the shared counter of the job. */
+static
+void flecs_run_worker_job(
+    ecs_stage_t *stage,
+    ecs_worker_job_t *job,
+    int32_t stage_count)
+{
+    if (job->action) {
+        job->action(stage, job->ctx);
+        return;
+    }
+
+#ifdef FLECS_RULES
+    if (job->rule) {
+        ecs_iter_t rit = ecs_rule_iter((ecs_world_t*)stage, job->rule);
+        rit.callback = job->callback;
+        rit.ctx = job->ctx;
+        if (stage_count > 1) {
+            ecs_rule_iter_set_partition(&rit, &job->claimed);
+        }
+
+        while (ecs_rule_next(&rit)) {
+            job->callback(&rit);
+        }
+        return;
+    }
+#endif
+
+    ecs_iter_t qit = ecs_query_iter((ecs_world_t*)stage, job->query);
+    qit.callback = job->callback;
+    qit.ctx = job->ctx;
+
+    if (stage_count <= 1) {
+        while (ecs_query_next(&qit)) {
+            job->callback(&qit);
+        }
+        return;
+    }
+
+    ecs_iter_t it = ecs_worker_chunk_iter(&qit, &job->claimed, job->chunk_size);
+    while (ecs_worker_chunk_next(&it)) {
+        job->callback(&it);
+    }
+}
+
 /* Worker thread */
 static
 void* flecs_worker(void *arg) {
@@ -59296,22 +63064,37 @@ void* flecs_worker(void *arg) {
     ecs_os_mutex_lock(world->sync_mutex);
     world->workers_running ++;
 
+    /* Main thread doesn't signal workers until all workers are running, so
+     * the signal counter can't change while the mutex is locked. */
+    int32_t signal = world->workers_signal;
+
     if (!(world->flags & EcsWorldQuitWorkers)) {
-        ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        if (!world->workers_use_futex) {
+            ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        }
     }
 
     ecs_os_mutex_unlock(world->sync_mutex);
 
+    if (world->workers_use_futex) {
+        flecs_wait_for_signal(world, &signal);
+    }
+
     while (!(world->flags & EcsWorldQuitWorkers)) {
         ecs_entity_t old_scope = ecs_set_scope((ecs_world_t*)stage, 0);
 
         ecs_dbg_3("worker %d: run", stage->id);
-        flecs_run_pipeline_ops(world, stage, stage->id, world->stage_count, 
-            world->info.delta_time);
+        ecs_worker_job_t *job = world->worker_job;
+        if (job) {
+            flecs_run_worker_job(stage, job, world->stage_count);
+        } else {
+            flecs_run_pipeline_ops(world, stage, stage->id, 
+                world->stage_count, world->info.delta_time);
+        }
 
         ecs_set_scope((ecs_world_t*)stage, old_scope);
 
-        flecs_sync_worker(world);
+        flecs_sync_worker(world, &signal);
     }
 
     ecs_dbg_2("worker %d: finalizing", stage->id);
@@ -59397,6 +63180,12 @@ void flecs_wait_for_sync(
 
     ecs_dbg_3("#[bold]pipeline: waiting for worker sync");
 
+    if (world->workers_use_futex) {
+        ecs_os_futex_wait(&world->workers_synced, 0);
+        ecs_dbg_3("#[bold]pipeline: workers synced");
+        return;
+    }
+
     ecs_os_mutex_lock(world->sync_mutex);
     if (world->workers_waiting != (stage_count - 1)) {
         ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
@@ -59422,6 +63211,18 @@ void flecs_signal_workers(
     }
 
     ecs_dbg_3("#[bold]pipeline: signal workers");
+
+    if (world->workers_use_futex) {
+        /* Workers are waiting for the signal, so it's safe to reset the sync
+         * state without atomics. The atomic increment of the signal counter
+         * ensures that workers see the new values. */
+        world->workers_pending = stage_count - 1;
+        world->workers_synced = 0;
+        ecs_os_ainc(&world->workers_signal);
+        ecs_os_futex_wake(&world->workers_signal);
+        return;
+    }
+
     ecs_os_mutex_lock(world->sync_mutex);
     ecs_os_cond_broadcast(world->worker_cond);
     ecs_os_mutex_unlock(world->sync_mutex);
@@ -59522,6 +63323,7 @@ void flecs_set_threads_internal(
         }
 
         world->workers_use_task_api = use_task_api;
+        world->workers_use_futex = ecs_os_has_futex();
 
         /* Start threads if number of threads > 1 */
         if (threads > 1) {
@@ -59555,6 +63357,182 @@ bool ecs_using_task_threads(
     return world->workers_use_task_api;
 }
 
+void ecs_set_worker_chunk_size(
+    ecs_world_t *world,
+    int32_t chunk_size)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_check(chunk_size >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot change chunk size while pipeline is running");
+    world->worker_chunk_size = chunk_size;
+error:
+    return;
+}
+
+int32_t ecs_get_worker_chunk_size(
+    const ecs_world_t *world)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    return world->worker_chunk_size;
+}
+
+/* Run job on the main thread and workers, and wait until it has finished */
+static
+void flecs_run_job(
+    ecs_world_t *world,
+    ecs_worker_job_t *job)
+{
+    /* Make sure the query cache is up to date before threads start iterating,
+     * as queries can't be rematched in readonly mode. */
+    ecs_run_aperiodic(world, 0);
+
+    bool task_threads = ecs_using_task_threads(world);
+    if (task_threads) {
+        flecs_create_worker_threads(world);
+    }
+
+    flecs_wait_for_workers(world);
+    ecs_readonly_begin(world);
+
+    world->worker_job = job;
+    flecs_signal_workers(world);
+
+    /* Run job on main thread */
+    ecs_world_t *stage = ecs_get_stage(world, 0);
+    ecs_entity_t old_scope = ecs_set_scope(stage, 0);
+    flecs_run_worker_job((ecs_stage_t*)stage, job, world->stage_count);
+    ecs_set_scope(stage, old_scope);
+
+    flecs_wait_for_sync(world);
+    world->worker_job = NULL;
+
+    ecs_readonly_end(world);
+
+    if (task_threads) {
+        flecs_join_worker_threads(world);
+    }
+}
+
+bool flecs_workers_run(
+    ecs_world_t *world,
+    ecs_worker_action_t action,
+    void *ctx)
+{
+    ecs_poly_assert(world, ecs_world_t);
+
+    /* Task threads only exist while a pipeline or job is running */
+    int32_t stage_count = world->stage_count;
+    if ((stage_count <= 1) || ecs_using_task_threads(world) || 
+        !world->stages[1].thread || world->worker_job) 
+    {
+        return false;
+    }
+
+    ecs_worker_job_t job = {
+        .action = action,
+        .ctx = ctx
+    };
+
+    flecs_wait_for_workers(world);
+
+    world->worker_job = &job;
+    flecs_signal_workers(world);
+    flecs_run_worker_job(&world->stages[0], &job, stage_count);
+    flecs_wait_for_sync(world);
+    world->worker_job = NULL;
+
+    return true;
+}
+
+/* Number of rows for which the data of all fields fits in a chunk */
+static
+int32_t flecs_par_each_chunk_size(
+    const ecs_query_t *query)
+{
+    const ecs_filter_t *filter = ecs_query_get_filter(query);
+    ecs_size_t row_size = ECS_SIZEOF(ecs_entity_t);
+    int32_t i;
+    for (i = 0; i < filter->field_count; i ++) {
+        row_size += filter->sizes[i];
+    }
+
+    int32_t result = FLECS_PAR_EACH_CHUNK_BYTES / row_size;
+    return result ? result : 1;
+}
+
+void ecs_query_par_each(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_iter_action_t callback,
+    void *ctx,
+    int32_t chunk_size)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_poly_assert(query, ecs_query_t);
+    ecs_check(callback != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunk_size >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot run par_each while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION, NULL);
+    ecs_check(world->worker_job == NULL, ECS_INVALID_OPERATION, NULL);
+
+    ecs_worker_job_t job = {
+        .query = query,
+        .callback = callback,
+        .ctx = ctx,
+        .chunk_size = chunk_size ? chunk_size : flecs_par_each_chunk_size(query)
+    };
+
+    flecs_run_job(world, &job);
+error:
+    return;
+}
+
+#ifdef FLECS_RULES
+void ecs_rule_par_each(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    ecs_iter_action_t callback,
+    void *ctx)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_poly_assert(rule, ecs_rule_t);
+    ecs_check(callback != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot run par_each while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION, NULL);
+    ecs_check(world->worker_job == NULL, ECS_INVALID_OPERATION, NULL);
+
+    ecs_worker_job_t job = {
+        .rule = rule,
+        .callback = callback,
+        .ctx = ctx
+    };
+
+    /* Creating an iterator updates the results of a cached rule, which can't 
+     * be updated in readonly mode. */
+    ecs_iter_t it = ecs_rule_iter(world, rule);
+    ecs_iter_fini(&it);
+
+    flecs_run_job(world, &job);
+error:
+    return;
+}
+#endif
+
+void ecs_set_parallel_systems(
+    ecs_world_t *world,
+    bool enable)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot enable parallel systems while pipeline is running");
+    world->parallel_systems = enable;
+error:
+    return;
+}
+
 #endif
 
  /**
@@ -59575,6 +63553,8 @@ typedef int16_t ecs_rule_lbl_t;
 typedef ecs_flags64_t ecs_write_flags_t;
 
 #define EcsRuleMaxVarCount      (64)
+#define EcsRuleJoinMaxTerms     (8)
+#define EcsRuleJoinMaxKeys      (8)
 #define EcsVarNone              ((ecs_var_id_t)-1)
 #define EcsThisName             "this"
 
@@ -59605,6 +63585,7 @@ typedef enum {
     EcsRuleWith,           /* Match id against fixed or variable source */
     EcsRuleAndAny,         /* And operator with support for matching Any src/id */
     EcsRuleTrav,           /* Support for transitive/reflexive queries */
+    EcsRuleJoin,           /* Hash join terms with same source on written variables */
     EcsRuleIdsRight,       /* Find ids in use that match (R, *) wildcard */
     EcsRuleIdsLeft,        /* Find ids in use that match (*, T) wildcard */
     EcsRuleEach,           /* Iterate entities in table, populate entity variable */
@@ -59659,12 +63640,36 @@ typedef struct ecs_rule_op_t {
     ecs_rule_lbl_t next;       /* Forwarding label. Must come after prev */
     ecs_rule_lbl_t other;      /* Misc register used for control flow */
     ecs_flags16_t match_flags; /* Flags that modify matching behavior */
+    int32_t est;               /* Estimated number of results (see planner) */
     ecs_rule_ref_t src;
     ecs_rule_ref_t first;
     ecs_rule_ref_t second;
     ecs_flags64_t written;     /* Bitset with variables written by op */
 } ecs_rule_op_t;
 
+/* Term of a hash join. The first and second element of the term are either
+ * entities or written entity variables that are used as join key. */
+typedef struct ecs_rule_join_term_t {
+    ecs_rule_ref_t first;
+    ecs_rule_ref_t second;
+    ecs_flags8_t flags;        /* Flags storing whether 1st/2nd are variables */
+    int8_t field_index;        /* Query field corresponding with term */
+    int8_t first_key;          /* Index of first in join keys, or -1 */
+    int8_t second_key;         /* Index of second in join keys, or -1 */
+} ecs_rule_join_term_t;
+
+/* Hash join, evaluated by an EcsRuleJoin operation. Instead of evaluating each
+ * term for each combination of key values, the operation matches the terms 
+ * against all tables once, and stores the matching tables in a hash table
+ * indexed by the key values. */
+typedef struct ecs_rule_join_t {
+    ecs_rule_join_term_t terms[EcsRuleJoinMaxTerms];
+    ecs_var_id_t keys[EcsRuleJoinMaxKeys]; /* Entity variables used as key */
+    int8_t term_count;
+    int8_t key_count;
+    ecs_size_t entry_size;     /* Size of a hash table entry */
+} ecs_rule_join_t;
+
  /* And context */
 typedef struct {
     ecs_id_record_t *idr;
@@ -59687,6 +63692,20 @@ typedef struct {
     bool up;
 } ecs_trav_cache_t;
 
+/* Transitive closure of an entity for a traversable relationship */
+typedef struct {
+    ecs_vec_t down;            /* Entity and entities that (indirectly) have it */
+    ecs_vec_t up;              /* Entities that entity (indirectly) has */
+    bool down_valid;
+    bool up_valid;
+} ecs_trav_closure_t;
+
+/* World level cache with closures for a traversable relationship */
+typedef struct {
+    int32_t generation;        /* Generation of (R, *) record for closures */
+    ecs_map_t closures;        /* map<entity, ecs_trav_closure_t*> */
+} ecs_trav_rel_cache_t;
+
 /* Trav context */
 typedef struct {
     ecs_rule_and_ctx_t and;
@@ -59697,6 +63716,14 @@ typedef struct {
     bool yield_reflexive;
 } ecs_rule_trav_ctx_t;
 
+/* Join context */
+typedef struct {
+    ecs_map_t index;           /* Hash of key values to first entry + 1 */
+    ecs_vec_t entries;         /* Tables matched by the joined terms */
+    int32_t cur;               /* Current entry */
+    bool built;                /* Was hash table built for iterator */
+} ecs_rule_join_ctx_t;
+
  /* Eq context */
 typedef struct {
     ecs_table_range_t range;
@@ -59734,6 +63761,7 @@ typedef struct ecs_rule_op_ctx_t {
     union {
         ecs_rule_and_ctx_t and;
         ecs_rule_trav_ctx_t trav;
+        ecs_rule_join_ctx_t join;
         ecs_rule_ids_ctx_t ids;
         ecs_rule_eq_ctx_t eq;
         ecs_rule_each_ctx_t each;
@@ -59766,6 +63794,8 @@ typedef struct {
     ecs_rule_compile_ctrlflow_t ctrlflow[FLECS_QUERY_SCOPE_NESTING_MAX];
     ecs_rule_compile_ctrlflow_t *cur; /* Current scope */
 
+    ecs_vec_t joins; /* Hash joins (ecs_rule_join_t) used by operations */
+
     int32_t scope; /* Nesting level of query scopes */
     ecs_flags32_t scope_is_not; /* Whether scope is prefixed with not */
 } ecs_rule_compile_ctx_t;    
@@ -59789,6 +63819,20 @@ typedef struct {
     const char *name;
 } ecs_rule_var_cache_t;
 
+/* Results of a cached rule (see EcsFilterCached). A result stores a header,
+ * the public variables, field ids, sources, source tables and columns. A $this
+ * variable with a table and a count of 0 matches all entities in the table. */
+typedef struct ecs_rule_cache_t {
+    ecs_vec_t results;            /* Result storage */
+    ecs_size_t elem_size;         /* Size of a result */
+    ecs_map_t tables;             /* Tables for which results are up to date */
+    ecs_vec_t pending;            /* Tables to match before next iteration */
+    ecs_vec_t observers;          /* Observers that keep cache up to date */
+    bool dirty;                   /* Are results out of date */
+    bool table_only;              /* Do results only depend on table types */
+    bool entity_refs;             /* Do results depend on individual entities */
+} ecs_rule_cache_t;
+
 struct ecs_rule_t {
     ecs_header_t hdr;             /* Poly header */
     ecs_filter_t filter;          /* Filter */
@@ -59807,6 +63851,11 @@ struct ecs_rule_t {
     ecs_rule_op_t *ops;           /* Operations */
     int32_t op_count;             /* Number of operations */
 
+    ecs_rule_join_t *joins;       /* Hash joins used by operations */
+    int32_t join_count;           /* Number of hash joins */
+
+    ecs_rule_cache_t *cache;      /* Cached results (optional) */
+
     /* Mixins */
     ecs_iterable_t iterable;
     ecs_poly_dtor_t dtor;
@@ -59825,6 +63874,10 @@ ecs_flags16_t flecs_rule_ref_flags(
     ecs_flags16_t flags,
     ecs_flags16_t kind);
 
+/* Check if term is a builtin predicate ($x == y, $x ~= y, lookup) */
+bool flecs_rule_is_builtin_pred(
+    const ecs_term_t *term);
+
 /* Check if variable is written */
 bool flecs_rule_is_written(
     ecs_var_id_t var_id,
@@ -59866,6 +63919,28 @@ void flecs_rule_trav_cache_fini(
     ecs_allocator_t *a,
     ecs_trav_cache_t *cache);
 
+/* Create iterator without using or updating the rule cache */
+ecs_iter_t flecs_rule_iter(
+    const ecs_world_t *world,
+    const ecs_rule_t *rule);
+
+/* Create cache for rule */
+void flecs_rule_cache_init(
+    ecs_world_t *world,
+    ecs_rule_t *rule);
+
+/* Free cache of rule */
+void flecs_rule_cache_fini(
+    ecs_rule_t *rule);
+
+/* Get up to date cache, returns NULL if cache can't be used */
+const ecs_rule_cache_t* flecs_rule_cache_get(
+    const ecs_rule_t *rule);
+
+/* Yield next result from cache */
+bool flecs_rule_cache_next(
+    ecs_iter_t *it);
+
 #endif
 
 #include <ctype.h>
@@ -59892,6 +63967,7 @@ const char* flecs_rule_op_str(
     case EcsRuleAndAny:       return "andany  ";
     case EcsRuleWith:         return "with    ";
     case EcsRuleTrav:         return "trav    ";
+    case EcsRuleJoin:         return "join    ";
     case EcsRuleIdsRight:     return "idsr    ";
     case EcsRuleIdsLeft:      return "idsl    ";
     case EcsRuleEach:         return "each    ";
@@ -59948,7 +64024,9 @@ void flecs_rule_fini(
         ecs_os_free(rule->vars);
     }
 
+    flecs_rule_cache_fini(rule);
     ecs_os_free(rule->ops);
+    ecs_os_free(rule->joins);
     ecs_os_free(rule->src_vars);
     flecs_name_index_fini(&rule->tvar_index);
     flecs_name_index_fini(&rule->evar_index);
@@ -59990,6 +64068,10 @@ ecs_rule_t* ecs_rule_init(
         goto error;
     }
 
+    if (result->filter.flags & EcsFilterCached) {
+        flecs_rule_cache_init(world, result);
+    }
+
     ecs_entity_t entity = const_desc->entity;
     result->dtor = (ecs_poly_dtor_t)flecs_rule_fini;
 
@@ -60052,6 +64134,68 @@ int32_t flecs_rule_op_ref_str(
     return color_chars;
 }
 
+/* Does operation have an estimated number of results from the planner */
+static
+bool flecs_rule_op_has_est(
+    const ecs_rule_op_t *op)
+{
+    if (op->field_index < 0) {
+        return false;
+    }
+
+    switch(op->kind) {
+    case EcsRuleAnd:
+    case EcsRuleAndId:
+    case EcsRuleWith:
+    case EcsRuleAndAny:
+    case EcsRuleTrav:
+    case EcsRuleJoin:
+    case EcsRuleIdsLeft:
+    case EcsRuleIdsRight:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* Append terms of hash join operation */
+static
+void flecs_rule_join_str(
+    const ecs_rule_t *rule,
+    const ecs_rule_op_t *op,
+    int32_t hidden_chars,
+    int32_t start,
+    ecs_strbuf_t *buf)
+{
+    const ecs_rule_join_t *join = &rule->joins[op->other];
+    int32_t i, written = ecs_strbuf_written(buf) - hidden_chars;
+    for (i = 0; i < (30 - (written - start)); i ++) {
+        ecs_strbuf_appendch(buf, ' ');
+    }
+
+    for (i = 0; i < join->term_count; i ++) {
+        const ecs_rule_join_term_t *term = &join->terms[i];
+        ecs_flags16_t first_flags = flecs_rule_ref_flags(
+            term->flags, EcsRuleFirst);
+        ecs_flags16_t second_flags = flecs_rule_ref_flags(
+            term->flags, EcsRuleSecond);
+        ecs_rule_ref_t first = term->first, second = term->second;
+
+        if (i) {
+            ecs_strbuf_appendstr(buf, ", ");
+        }
+        ecs_strbuf_appendstr(buf, "(");
+        flecs_rule_op_ref_str(rule, &first, first_flags, buf);
+        if (second_flags) {
+            ecs_strbuf_appendstr(buf, ", ");
+            flecs_rule_op_ref_str(rule, &second, second_flags, buf);
+        }
+        ecs_strbuf_appendch(buf, ')');
+    }
+
+    ecs_strbuf_append(buf, " #[grey]~%d#[reset]", op->est);
+}
+
 char* ecs_rule_str_w_profile(
     const ecs_rule_t *rule,
     const ecs_iter_t *it)
@@ -60108,6 +64252,11 @@ char* ecs_rule_str_w_profile(
             indent ++;
         }
 
+        if (op->kind == EcsRuleJoin) {
+            first_flags = second_flags = 0;
+            flecs_rule_join_str(rule, op, hidden_chars, start, &buf);
+        }
+
         if (!first_flags && !second_flags) {
             ecs_strbuf_appendstr(&buf, "\n");
             continue;
@@ -60150,6 +64299,10 @@ char* ecs_rule_str_w_profile(
 
         ecs_strbuf_appendch(&buf, ')');
 
+        if (flecs_rule_op_has_est(op)) {
+            ecs_strbuf_append(&buf, " #[grey]~%d#[reset]", op->est);
+        }
+
         ecs_strbuf_appendch(&buf, '\n');
     }
 
@@ -60270,6 +64423,526 @@ error:
     return NULL;
 }
 
+#endif
+
+/**
+ * @file addons/rules/cache.c
+ * @brief Cache that stores the results of a rule.
+ *
+ * A cached rule stores its results, so that iterating a rule that hasn't
+ * changed doesn't have to evaluate the rule program. The cache is kept up to
+ * date with observers for the ids the rule matches.
+ *
+ * When all terms of a rule match the $this table, the results of a table only
+ * depend on the table type. For these rules the cache is updated incrementally,
+ * by matching each table that becomes non-empty. For other rules the results
+ * depend on the components of individual entities, and the cache is recomputed
+ * after any of the matched ids is added to or removed from an entity.
+ *
+ * Results that point to individual entities also depend on where the entities
+ * are stored, which can change without changing a matched id. Before such a
+ * cache is used, it checks whether these entities are still in the same table
+ * and row, and recomputes the results if they are not.
+ */
+
+
+#ifdef FLECS_RULES
+
+/* Header of cached result. Results that don't contain an entire $this table
+ * depend on the order of entities in the table, and are checked before the
+ * cache is used. */
+typedef struct ecs_rule_cache_result_t {
+    ecs_entity_t entity;          /* First entity in $this range */
+    uint64_t table_id;            /* Id of $this table */
+    int32_t table_state;          /* Dirty state of $this table */
+} ecs_rule_cache_result_t;
+
+typedef struct ecs_rule_cache_watch_t {
+    ecs_id_t id;
+    bool entity_events;
+} ecs_rule_cache_watch_t;
+
+static
+void flecs_rule_cache_mark_dirty(
+    ecs_rule_cache_t *cache)
+{
+    cache->dirty = true;
+    ecs_vec_clear(&cache->pending);
+}
+
+static
+void flecs_rule_cache_on_event(
+    ecs_iter_t *it)
+{
+    ecs_rule_cache_t *cache = it->ctx;
+    if (!cache || cache->dirty) {
+        return;
+    }
+
+    ecs_allocator_t *a = &it->real_world->allocator;
+
+    if (it->event == EcsOnTableFill && cache->table_only) {
+        /* Table type didn't change, only match table if it wasn't matched */
+        ecs_table_t *table = it->table;
+        if (!ecs_map_get(&cache->tables, table->id)) {
+            ecs_map_insert(&cache->tables, table->id, 0);
+            ecs_vec_append_t(a, &cache->pending, ecs_table_t*)[0] = table;
+        }
+        return;
+    }
+
+    flecs_rule_cache_mark_dirty(cache);
+}
+
+static
+void flecs_rule_cache_watch(
+    ecs_allocator_t *a,
+    ecs_vec_t *watches,
+    ecs_id_t id,
+    bool entity_events)
+{
+    int32_t i, count = ecs_vec_count(watches);
+    ecs_rule_cache_watch_t *w = ecs_vec_first(watches);
+    for (i = 0; i < count; i ++) {
+        if (w[i].id == id) {
+            w[i].entity_events |= entity_events;
+            return;
+        }
+    }
+
+    ecs_rule_cache_watch_t *elem = ecs_vec_append_t(
+        a, watches, ecs_rule_cache_watch_t);
+    elem->id = id;
+    elem->entity_events = entity_events;
+}
+
+/* Get id to observe for term. Variables are replaced with wildcards. */
+static
+ecs_id_t flecs_rule_cache_watch_id(
+    const ecs_term_t *term)
+{
+    const ecs_term_id_t *first = &term->first, *second = &term->second;
+    if ((first->flags & EcsIsVariable) || ecs_id_is_wildcard(first->id)) {
+        return EcsWildcard;
+    }
+
+    if (!ECS_IS_PAIR(term->id)) {
+        return first->id;
+    }
+
+    ecs_entity_t tgt = second->id;
+    if ((second->flags & EcsIsVariable) ||
+        (term->flags & EcsTermTransitive) || ecs_id_is_wildcard(tgt))
+    {
+        /* Transitive terms also match targets of the relationship */
+        tgt = EcsWildcard;
+    }
+
+    return ecs_pair(first->id, tgt);
+}
+
+static
+bool flecs_rule_cache_is_this(
+    const ecs_term_id_t *term_id)
+{
+    return (term_id->flags & EcsIsVariable) && (term_id->id == EcsThis);
+}
+
+/* Find ids that the rule results depend on */
+static
+void flecs_rule_cache_find_watches(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    ecs_vec_t *watches)
+{
+    const ecs_filter_t *filter = &rule->filter;
+    int32_t i, count = filter->term_count;
+    ecs_term_t *terms = filter->terms;
+    ecs_allocator_t *a = &world->allocator;
+
+    /* If $this is used as entity, results can contain individual entities */
+    bool this_entity = !rule->has_table_this;
+    for (i = 0; i < count; i ++) {
+        ecs_term_t *term = &terms[i];
+        if (flecs_rule_cache_is_this(&term->first) ||
+            flecs_rule_cache_is_this(&term->second) ||
+            flecs_rule_is_builtin_pred(term))
+        {
+            this_entity = true;
+        }
+    }
+
+    for (i = 0; i < count; i ++) {
+        ecs_term_t *term = &terms[i];
+        ecs_entity_t first = term->first.id;
+        if (first == EcsScopeOpen || first == EcsScopeClose) {
+            continue;
+        }
+
+        if (flecs_rule_is_builtin_pred(term)) {
+            /* Predicates compare entities by name */
+            flecs_rule_cache_watch(a, watches,
+                ecs_pair(ecs_id(EcsIdentifier), EcsName), true);
+            if (first == EcsPredLookup) {
+                flecs_rule_cache_watch(a, watches,
+                    ecs_pair(EcsChildOf, EcsWildcard), true);
+            }
+            continue;
+        }
+
+        bool this_src = flecs_rule_cache_is_this(&term->src);
+        bool entity_events = !this_src || this_entity;
+
+        if (term->first.flags & EcsIsEntity &&
+            ecs_has_id(world, first, EcsUnion))
+        {
+            /* Union targets change without changing the table */
+            entity_events = true;
+        }
+
+        if (term->flags & EcsTermTransitive) {
+            /* Relationship graph can change without changing tables */
+            entity_events = true;
+        }
+
+        if (term->flags & EcsTermIdInherited) {
+            /* Matched tables can have any id that inherits from first */
+            flecs_rule_cache_watch(a, watches, EcsWildcard, false);
+            flecs_rule_cache_watch(a, watches, ecs_pair(EcsIsA, first), true);
+        }
+
+        flecs_rule_cache_watch(a, watches,
+            flecs_rule_cache_watch_id(term), entity_events);
+    }
+
+    if (!(filter->flags & EcsFilterMatchAnything)) {
+        /* Rule without positive terms can match any table */
+        flecs_rule_cache_watch(a, watches, EcsWildcard, false);
+    }
+}
+
+static
+void flecs_rule_cache_append(
+    ecs_world_t *world,
+    ecs_rule_cache_t *cache,
+    const ecs_rule_t *rule,
+    ecs_iter_t *it)
+{
+    ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    int32_t i, var_count = rule->var_pub_count;
+    int32_t field_count = rule->filter.field_count;
+
+    ecs_rule_cache_result_t *result = ecs_vec_append(
+        &world->allocator, &cache->results, cache->elem_size);
+    ecs_var_t *vars = ECS_OFFSET_T(result, ecs_rule_cache_result_t);
+    ecs_id_t *ids = ECS_ELEM_T(vars, ecs_var_t, var_count);
+    ecs_entity_t *sources = ECS_ELEM_T(ids, ecs_id_t, field_count);
+    ecs_table_t **src_tables = ECS_ELEM_T(sources, ecs_entity_t, field_count);
+    int32_t *columns = ECS_ELEM_T(src_tables, ecs_table_t*, field_count);
+
+    ecs_os_memcpy_n(vars, rit->vars, ecs_var_t, var_count);
+    ecs_os_memcpy_n(ids, it->ids, ecs_id_t, field_count);
+    ecs_os_memcpy_n(sources, it->sources, ecs_entity_t, field_count);
+    ecs_os_memcpy_n(columns, it->columns, int32_t, field_count);
+
+    /* Columns of fields with a source are only valid while the source stays
+     * in the same table */
+    for (i = 0; i < field_count; i ++) {
+        src_tables[i] = NULL;
+        if (sources[i]) {
+            src_tables[i] = ecs_get_table(world, sources[i]);
+            cache->entity_refs = true;
+        }
+    }
+
+    result->entity = 0;
+    result->table_id = 0;
+    result->table_state = 0;
+
+    ecs_table_t *table = vars[0].range.table;
+    if (rit->yield_table) {
+        /* Result matches all entities in table, including entities that are
+         * added to the table after the result was cached. */
+        vars[0].range.count = 0;
+    } else if (table && vars[0].range.count) {
+        result->entity = ecs_vec_get_t(&table->data.entities, ecs_entity_t, 
+            vars[0].range.offset)[0];
+        result->table_id = table->id;
+        result->table_state = flecs_table_get_dirty_state(world, table)[0];
+        cache->entity_refs = true;
+    }
+}
+
+/* Check if results that depend on individual entities are still valid */
+static
+bool flecs_rule_cache_is_valid(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    const ecs_rule_cache_t *cache)
+{
+    int32_t var_count = rule->var_pub_count;
+    int32_t field_count = rule->filter.field_count;
+    int32_t r, count = ecs_vec_count(&cache->results);
+
+    for (r = 0; r < count; r ++) {
+        const ecs_rule_cache_result_t *result = ecs_vec_get(
+            &cache->results, cache->elem_size, r);
+        const ecs_var_t *vars = ECS_OFFSET_T(result, ecs_rule_cache_result_t);
+        const ecs_id_t *ids = ECS_ELEM_T(vars, ecs_var_t, var_count);
+        const ecs_entity_t *sources = ECS_ELEM_T(ids, ecs_id_t, field_count);
+        ecs_table_t **src_tables = ECS_ELEM_T(sources, ecs_entity_t, field_count);
+
+        if (result->entity) {
+            const ecs_table_range_t *range = &vars[0].range;
+            ecs_record_t *rec = flecs_entities_get(world, result->entity);
+            if (!rec || rec->table != range->table || 
+                ECS_RECORD_TO_ROW(rec->row) != range->offset)
+            {
+                return false;
+            }
+
+            /* Entity is still in table, so table is alive */
+            if (range->table->id != result->table_id || 
+                range->table->dirty_state[0] != result->table_state) 
+            {
+                return false;
+            }
+        }
+
+        int32_t i;
+        for (i = 0; i < field_count; i ++) {
+            if (sources[i] && ecs_get_table(world, sources[i]) != src_tables[i]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/* Evaluate rule and append results to cache. If a table is provided, only
+ * results for that table are added. */
+static
+void flecs_rule_cache_populate(
+    ecs_world_t *world,
+    ecs_rule_t *rule,
+    ecs_table_t *table)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+    ecs_iter_t it = flecs_rule_iter(world, rule);
+    if (table) {
+        ecs_iter_set_var_as_table(&it, 0, table);
+    }
+
+    while (ecs_rule_next_instanced(&it)) {
+        flecs_rule_cache_append(world, cache, rule, &it);
+
+        ecs_table_t *result_table = it.table;
+        if (cache->table_only && result_table) {
+            ecs_map_ensure(&cache->tables, result_table->id)[0] = 0;
+        }
+    }
+}
+
+static
+void flecs_rule_cache_update(
+    ecs_world_t *world,
+    ecs_rule_t *rule)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+
+    if (cache->dirty) {
+        ecs_vec_clear(&cache->results);
+        cache->entity_refs = false;
+        ecs_map_clear(&cache->tables);
+        ecs_vec_clear(&cache->pending);
+        cache->dirty = false;
+        flecs_rule_cache_populate(world, rule, NULL);
+        return;
+    }
+
+    int32_t i, count = ecs_vec_count(&cache->pending);
+    ecs_table_t **tables = ecs_vec_first(&cache->pending);
+    for (i = 0; i < count; i ++) {
+        flecs_rule_cache_populate(world, rule, tables[i]);
+    }
+
+    ecs_vec_clear(&cache->pending);
+}
+
+void flecs_rule_cache_init(
+    ecs_world_t *world,
+    ecs_rule_t *rule)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_rule_cache_t *cache = rule->cache = flecs_calloc_t(a, ecs_rule_cache_t);
+    int32_t field_count = rule->filter.field_count;
+
+    cache->elem_size = ECS_SIZEOF(ecs_rule_cache_result_t) + 
+        ECS_SIZEOF(ecs_var_t) * rule->var_pub_count +
+        (ECS_SIZEOF(ecs_id_t) + ECS_SIZEOF(ecs_entity_t) + 
+            ECS_SIZEOF(ecs_table_t*) + ECS_SIZEOF(int32_t)) * field_count;
+    cache->elem_size = ECS_ALIGN(cache->elem_size, ECS_SIZEOF(ecs_var_t));
+    ecs_vec_init(a, &cache->results, cache->elem_size, 0);
+    ecs_vec_init_t(a, &cache->pending, ecs_table_t*, 0);
+    ecs_vec_init_t(a, &cache->observers, ecs_entity_t, 0);
+    ecs_map_init(&cache->tables, a);
+    cache->dirty = true;
+    cache->table_only = true;
+
+    ecs_vec_t watches;
+    ecs_vec_init_t(a, &watches, ecs_rule_cache_watch_t, 0);
+    flecs_rule_cache_find_watches(world, rule, &watches);
+
+    int32_t i, count = ecs_vec_count(&watches);
+    ecs_rule_cache_watch_t *w = ecs_vec_first(&watches);
+    for (i = 0; i < count; i ++) {
+        ecs_observer_desc_t desc = {
+            .filter.terms[0] = { .id = w[i].id, .src.flags = EcsSelf },
+            .filter.flags = EcsFilterNoData,
+            .events = { EcsOnTableFill, EcsOnTableDelete },
+            .callback = flecs_rule_cache_on_event,
+            .ctx = cache
+        };
+
+        if (w[i].entity_events) {
+            desc.events[2] = EcsOnAdd;
+            desc.events[3] = EcsOnRemove;
+            cache->table_only = false;
+        }
+
+        ecs_entity_t o = ecs_observer_init(world, &desc);
+        ecs_assert(o != 0, ECS_INTERNAL_ERROR, NULL);
+        ecs_vec_append_t(a, &cache->observers, ecs_entity_t)[0] = o;
+    }
+
+    ecs_vec_fini_t(a, &watches, ecs_rule_cache_watch_t);
+
+    if (!(world->flags & EcsWorldReadonly)) {
+        flecs_rule_cache_update(world, rule);
+    }
+}
+
+void flecs_rule_cache_fini(
+    ecs_rule_t *rule)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+    if (!cache) {
+        return;
+    }
+
+    ecs_world_t *world = rule->filter.world;
+    int32_t i, count = ecs_vec_count(&cache->observers);
+    ecs_entity_t *observers = ecs_vec_first(&cache->observers);
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t o = observers[i];
+        if (!ecs_is_alive(world, o)) {
+            continue;
+        }
+
+        /* Observer may outlive the rule if its deletion is deferred */
+        ecs_observer_t *observer = ecs_poly_get(world, o, ecs_observer_t);
+        if (observer) {
+            observer->ctx = NULL;
+        }
+
+        ecs_delete(world, o);
+    }
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_fini(a, &cache->results, cache->elem_size);
+    ecs_vec_fini_t(a, &cache->pending, ecs_table_t*);
+    ecs_vec_fini_t(a, &cache->observers, ecs_entity_t);
+    ecs_map_fini(&cache->tables);
+    flecs_free_t(a, ecs_rule_cache_t, cache);
+    rule->cache = NULL;
+}
+
+const ecs_rule_cache_t* flecs_rule_cache_get(
+    const ecs_rule_t *rule)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+    ecs_world_t *world = rule->filter.world;
+
+    bool valid = true;
+    if (!cache->dirty && cache->entity_refs) {
+        valid = flecs_rule_cache_is_valid(world, rule, cache);
+    }
+
+    if (!valid || cache->dirty || ecs_vec_count(&cache->pending)) {
+        if (world->flags & EcsWorldReadonly) {
+            /* Cache can't be updated while other threads can iterate it */
+            return NULL;
+        }
+
+        if (!valid) {
+            flecs_rule_cache_mark_dirty(cache);
+        }
+
+        flecs_rule_cache_update(world, ECS_CONST_CAST(ecs_rule_t*, rule));
+    }
+
+    return cache;
+}
+
+bool flecs_rule_cache_next(
+    ecs_iter_t *it)
+{
+    ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    const ecs_rule_t *rule = rit->rule;
+    const ecs_rule_cache_t *cache = rit->cache;
+    int32_t var_count = rule->var_pub_count;
+    int32_t field_count = rule->filter.field_count;
+    int32_t count = ecs_vec_count(&cache->results);
+
+    if (!(it->flags & EcsIterIsValid)) {
+        flecs_iter_validate(it);
+    }
+
+    while (true) {
+        /* Partitioned iterators claim results from the shared counter */
+        int32_t cur = rit->claimed ? 
+            (ecs_os_ainc(rit->claimed) - 1) : rit->cache_cur ++;
+        if (cur >= count) {
+            break;
+        }
+
+        const ecs_rule_cache_result_t *result = ecs_vec_get(
+            &cache->results, cache->elem_size, cur);
+        const ecs_var_t *vars = ECS_OFFSET_T(result, ecs_rule_cache_result_t);
+        ecs_table_range_t range = vars[0].range;
+        ecs_table_t *table = range.table;
+        if (table && !range.count) {
+            range.count = ecs_table_count(table);
+            if (!range.count) {
+                continue; /* Don't yield empty tables */
+            }
+        }
+
+        const ecs_id_t *ids = ECS_ELEM_T(vars, ecs_var_t, var_count);
+        const ecs_entity_t *sources = ECS_ELEM_T(ids, ecs_id_t, field_count);
+        ecs_table_t **src_tables = ECS_ELEM_T(sources, ecs_entity_t, field_count);
+        const int32_t *columns = ECS_ELEM_T(src_tables, ecs_table_t*, field_count);
+
+        ecs_os_memcpy_n(rit->vars, vars, ecs_var_t, var_count);
+        ecs_os_memcpy_n(it->ids, ids, ecs_id_t, field_count);
+        ecs_os_memcpy_n(it->sources, sources, ecs_entity_t, field_count);
+        ecs_os_memcpy_n(it->columns, columns, int32_t, field_count);
+        rit->vars[0].range.count = range.count;
+
+        flecs_iter_populate_data(it->real_world, it, table, range.offset,
+            range.count, it->ptrs);
+        if (!table && range.count == 1) {
+            it->count = 1;
+            it->entities = &rit->vars[0].entity;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
 #endif
 
  /**
@@ -60288,6 +64961,7 @@ static bool flecs_rule_op_is_test[] = {
     [EcsRuleAndId] = true,
     [EcsRuleWith] = true,
     [EcsRuleTrav] = true,
+    [EcsRuleJoin] = true,
     [EcsRuleContain] = true,
     [EcsRulePairEq] = true,
     [EcsRuleLookup] = true,
@@ -60314,9 +64988,8 @@ ecs_var_id_t flecs_utovar(uint64_t val) {
 #define flecs_set_var_label(var, lbl)
 #endif
 
-static
 bool flecs_rule_is_builtin_pred(
-    ecs_term_t *term)
+    const ecs_term_t *term)
 {
     if (term->first.flags & EcsIsEntity) {
         ecs_entity_t id = term->first.id;
@@ -61638,19 +66311,21 @@ int flecs_rule_compile_term(
     ecs_world_t *world,
     ecs_rule_t *rule,
     ecs_term_t *term,
+    ecs_term_t *prev,
+    int32_t est,
     ecs_rule_compile_ctx_t *ctx)
 {
-    bool first_term = term == rule->filter.terms;
+    bool first_term = prev == NULL;
     bool first_is_var = term->first.flags & EcsIsVariable;
     bool second_is_var = term->second.flags & EcsIsVariable;
     bool src_is_var = term->src.flags & EcsIsVariable;
     bool builtin_pred = flecs_rule_is_builtin_pred(term);
     bool is_not = (term->oper == EcsNot) && !builtin_pred;
-    bool is_or = (term->oper == EcsOr) || (!first_term && term[-1].oper == EcsOr);
+    bool is_or = (term->oper == EcsOr) || (!first_term && prev->oper == EcsOr);
     bool cond_write = term->oper == EcsOptional || is_or;
     ecs_rule_op_t op = {0};
 
-    if (is_or && (first_term || term[-1].oper != EcsOr)) {
+    if (is_or && (first_term || prev->oper != EcsOr)) {
         ctx->ctrlflow->cond_written_or = ctx->cond_written;
         ctx->ctrlflow->in_or = true;
     }
@@ -61681,6 +66356,7 @@ int flecs_rule_compile_term(
     op.kind = src_is_var ? EcsRuleAnd : EcsRuleWith;
     op.field_index = flecs_ito(int8_t, term->field_index);
     op.term_index = flecs_ito(int8_t, term - rule->filter.terms);
+    op.est = est;
 
     /* If rule is transitive, use Trav(ersal) instruction */
     if (term->flags & EcsTermTransitive) {
@@ -61835,8 +66511,8 @@ int flecs_rule_compile_term(
 
     /* If previous term was ScopeOpen with a Not operator, insert operation to
      * ensure that none of the results inside the scope should match. */
-    if (!first_term && term[-1].first.id == EcsScopeOpen) {
-        if (term[-1].oper == EcsNot) {
+    if (!first_term && prev->first.id == EcsScopeOpen) {
+        if (prev->oper == EcsNot) {
             flecs_rule_begin_none(ctx);
             flecs_rule_begin_not(ctx);
         }
@@ -61849,7 +66525,7 @@ int flecs_rule_compile_term(
     } else if (term->oper == EcsOptional) {
         flecs_rule_begin_option(ctx);
     } else if (term->oper == EcsOr) {
-        if (first_term || term[-1].oper != EcsOr) {
+        if (first_term || prev->oper != EcsOr) {
             if (!src_written) {
                 flecs_rule_begin_union(ctx);
             }
@@ -61934,7 +66610,7 @@ int flecs_rule_compile_term(
         if (ctx->cur->lbl_union != -1) {
             flecs_rule_next_or(ctx);
         } else {
-            if (first_term || term[-1].oper != EcsOr) {
+            if (first_term || prev->oper != EcsOr) {
                 if (ctx->cur->lbl_union == -1) {
                     flecs_rule_begin_or(ctx, lbl_start);
                 }
@@ -61943,7 +66619,7 @@ int flecs_rule_compile_term(
             }
         }
     } else if (term->oper == EcsAnd) {
-        if (!first_term && term[-1].oper == EcsOr) {
+        if (!first_term && prev->oper == EcsOr) {
             if (ctx->cur->lbl_union != -1) {
                 flecs_rule_end_union(ctx);
             } else {
@@ -61957,6 +66633,576 @@ error:
     return -1;
 }
 
+/* Canonical id of variable used by term id. Table and entity variables with
+ * the same name are the same variable for the planner. */
+static
+ecs_var_id_t flecs_rule_plan_var(
+    ecs_rule_t *rule,
+    ecs_term_id_t *term_id)
+{
+    if (flecs_term_id_is_wildcard(term_id)) {
+        return EcsVarNone;
+    }
+
+    const char *name = flecs_term_id_var_name(term_id);
+    if (!name) {
+        return EcsVarNone;
+    }
+
+    ecs_var_id_t var_id = flecs_rule_find_var_id(rule, name, EcsVarEntity);
+    if (var_id == EcsVarNone) {
+        var_id = flecs_rule_find_var_id(rule, name, EcsVarTable);
+    }
+    return var_id;
+}
+
+/* Variables used by term */
+static
+ecs_write_flags_t flecs_rule_plan_term_vars(
+    ecs_rule_t *rule,
+    ecs_term_t *term)
+{
+    ecs_write_flags_t result = 0;
+    ecs_var_id_t var_id;
+    if ((var_id = flecs_rule_plan_var(rule, &term->src)) != EcsVarNone) {
+        result |= (1ull << var_id);
+    }
+    if ((var_id = flecs_rule_plan_var(rule, &term->first)) != EcsVarNone) {
+        result |= (1ull << var_id);
+    }
+    if ((var_id = flecs_rule_plan_var(rule, &term->second)) != EcsVarNone) {
+        result |= (1ull << var_id);
+    }
+    return result;
+}
+
+/* Can the term be evaluated in a different position. Only plain And terms can
+ * be moved. Operators, scopes, predicates, lookups and transitive terms depend
+ * on the terms around them and keep their position. */
+static
+bool flecs_rule_plan_is_movable(
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    ecs_term_t *prev)
+{
+    if (term->oper != EcsAnd) {
+        return false;
+    }
+
+    /* Last term of an Or chain, first term of a scope */
+    if (prev && (prev->oper == EcsOr || prev->first.id == EcsScopeOpen)) {
+        return false;
+    }
+
+    /* Scope open/close */
+    if (!term->src.id && (term->src.flags & EcsIsEntity)) {
+        return false;
+    }
+
+    if (flecs_rule_is_builtin_pred(term)) {
+        return false;
+    }
+
+    if (term->flags & (EcsTermTransitive|EcsTermIdInherited|
+        EcsTermMatchAny|EcsTermMatchAnySrc)) 
+    {
+        return false;
+    }
+
+    ecs_term_id_t *ids[] = { &term->src, &term->first, &term->second };
+    int32_t i;
+    for (i = 0; i < 3; i ++) {
+        ecs_var_id_t var_id = flecs_rule_plan_var(rule, ids[i]);
+        if (var_id != EcsVarNone && rule->vars[var_id].lookup) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Can the term be evaluated after the terms that wrote the variables in 
+ * 'written'. A term with a source variable that has not been written yet
+ * writes the variable as table variable. Table variables are created for the
+ * order in which terms were written, so a term can't be evaluated before its
+ * source is written if no table variable exists for the source. */
+static
+bool flecs_rule_plan_can_eval(
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    ecs_write_flags_t written)
+{
+    ecs_var_id_t src_var = flecs_rule_plan_var(rule, &term->src);
+    if (src_var == EcsVarNone || flecs_rule_is_written(src_var, written)) {
+        return true;
+    }
+
+    const char *name = flecs_term_id_var_name(&term->src);
+    return flecs_rule_find_var_id(rule, name, EcsVarTable) != EcsVarNone;
+}
+
+/* Number of records in a list of pair id records, which is the number of 
+ * distinct relationships or targets for a wildcard pair. */
+static
+int32_t flecs_rule_plan_pair_count(
+    const ecs_id_record_t *idr,
+    bool second)
+{
+    int32_t result = 0;
+    const ecs_id_record_t *cur = second ? idr->second.next : idr->first.next;
+    while (cur) {
+        result ++;
+        cur = second ? cur->second.next : cur->first.next;
+    }
+    return result;
+}
+
+/* Estimate the number of results a term produces when it is evaluated after
+ * terms that wrote the variables in 'written'. Terms with a source that is not
+ * known yet produce the number of entities that have the id. Terms with a known
+ * source produce the average number of ids per table that match the term. The
+ * estimate is based on the entity and table counts of the id index at the time
+ * the rule is created. */
+static
+int32_t flecs_rule_plan_estimate(
+    const ecs_world_t *world,
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    ecs_write_flags_t written)
+{
+    ecs_var_id_t src_var = flecs_rule_plan_var(rule, &term->src);
+    ecs_var_id_t first_var = flecs_rule_plan_var(rule, &term->first);
+    ecs_var_id_t second_var = flecs_rule_plan_var(rule, &term->second);
+    bool has_second = ecs_term_id_is_set(&term->second);
+    bool first_wildcard = term->first.flags & EcsIsVariable;
+    bool second_wildcard = has_second && (term->second.flags & EcsIsVariable);
+    bool first_written = first_var != EcsVarNone && 
+        flecs_rule_is_written(first_var, written);
+    bool second_written = second_var != EcsVarNone && 
+        flecs_rule_is_written(second_var, written);
+
+    ecs_entity_t first = first_wildcard ? EcsWildcard : term->first.id;
+    ecs_id_t id = first;
+    if (has_second) {
+        ecs_entity_t second = second_wildcard ? EcsWildcard : term->second.id;
+        id = ecs_pair(first, second);
+    }
+
+    ecs_id_record_t *idr = flecs_query_id_record_get(world, id);
+    if (!idr) {
+        return 0;
+    }
+
+    int64_t entity_count = 0, id_count = 0, table_count = 0;
+    /* Iterate all tables, as the empty state of tables may not be up to date */
+    ecs_table_cache_iter_t it;
+    if (flecs_table_cache_all_iter(&idr->cache, &it)) {
+        const ecs_table_record_t *tr;
+        while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+            int32_t table_entities = ecs_table_count(tr->hdr.table);
+            if (table_entities) {
+                entity_count += table_entities;
+                id_count += tr->count;
+                table_count ++;
+            }
+        }
+    }
+
+    bool src_known = !(term->src.flags & EcsIsVariable) || 
+        (src_var != EcsVarNone && flecs_rule_is_written(src_var, written));
+    if (src_known) {
+        /* Test against known source. If the id has unknown parts, each matching
+         * id in the table is a result. */
+        bool unknown = (first_wildcard && !first_written) || 
+            (second_wildcard && !second_written);
+        if (!unknown || !table_count) {
+            return table_count ? 1 : 0;
+        }
+        return (int32_t)((id_count + table_count - 1) / table_count);
+    }
+
+    /* Find entities for id. Parts of the id that are known reduce the number
+     * of results by the number of distinct values for that part. */
+    if (has_second && id_count) {
+        int32_t div = 1;
+        if (second_wildcard && second_written && !first_wildcard) {
+            div = flecs_rule_plan_pair_count(idr, false);
+        } else if (first_wildcard && first_written && !second_wildcard) {
+            div = flecs_rule_plan_pair_count(idr, true);
+        }
+        if (div > 1) {
+            entity_count = (entity_count + div - 1) / div;
+        }
+    }
+
+    if (entity_count > INT32_MAX) {
+        entity_count = INT32_MAX;
+    }
+
+    return (int32_t)entity_count;
+}
+
+/* Determine the order in which terms are compiled. Consecutive terms that can
+ * be moved are greedily ordered by estimated number of results, so that the
+ * most selective term is evaluated first and intermediate results stay small.
+ * Ties keep the order in which the terms were written. */
+static
+void flecs_rule_plan(
+    const ecs_world_t *world,
+    ecs_rule_t *rule,
+    int32_t *order,
+    int32_t *est)
+{
+    ecs_filter_t *filter = &rule->filter;
+    ecs_term_t *terms = filter->terms;
+    ecs_write_flags_t written = 0;
+    int32_t i = 0, n = 0, count = filter->term_count;
+
+    while (i < count) {
+        ecs_term_t *prev = i ? &terms[i - 1] : NULL;
+        if (!flecs_rule_plan_is_movable(rule, &terms[i], prev)) {
+            est[n] = flecs_rule_plan_estimate(world, rule, &terms[i], written);
+            order[n ++] = i;
+            if (terms[i].oper != EcsNot) {
+                written |= flecs_rule_plan_term_vars(rule, &terms[i]);
+            }
+            i ++;
+            continue;
+        }
+
+        /* Find end of run of terms that can be moved */
+        int32_t end = i + 1;
+        while (end < count && 
+            flecs_rule_plan_is_movable(rule, &terms[end], &terms[end - 1])) 
+        {
+            end ++;
+        }
+
+        int32_t run_start = n, j, k;
+        for (j = i; j < end; j ++) {
+            order[n ++] = j;
+        }
+
+        for (j = run_start; j < n; j ++) {
+            int32_t best = -1, best_est = 0;
+            for (k = j; k < n; k ++) {
+                ecs_term_t *term = &terms[order[k]];
+                if (!flecs_rule_plan_can_eval(rule, term, written)) {
+                    continue;
+                }
+                int32_t cur_est = flecs_rule_plan_estimate(
+                    world, rule, term, written);
+                if (best == -1 || cur_est < best_est) {
+                    best = k;
+                    best_est = cur_est;
+                }
+            }
+
+            /* The first remaining term in the written order can always be
+             * evaluated, as all terms before it have been planned. */
+            ecs_assert(best != -1, ECS_INTERNAL_ERROR, NULL);
+
+            /* Move best term to current position, keep order of others */
+            int32_t best_term = order[best];
+            for (k = best; k > j; k --) {
+                order[k] = order[k - 1];
+            }
+            order[j] = best_term;
+            est[j] = best_est;
+            written |= flecs_rule_plan_term_vars(rule, &terms[best_term]);
+        }
+
+        i = end;
+    }
+}
+
+
+/* Minimum ratio between the estimated cost of a nested loop join and a hash
+ * join for the compiler to insert a hash join. */
+#define FlecsRuleJoinCostFactor (2.0)
+
+/* Get entity variable for variable term id that can be used as join key. 
+ * Returns EcsVarNone if the variable is not written before the join. */
+static
+ecs_var_id_t flecs_rule_join_key_var(
+    ecs_rule_t *rule,
+    ecs_term_id_t *term_id,
+    const char *src_name,
+    ecs_write_flags_t written)
+{
+    const char *name = flecs_term_id_var_name(term_id);
+    if (!name || flecs_term_id_is_wildcard(term_id) || !ecs_os_strcmp(name, src_name)) {
+        return EcsVarNone;
+    }
+
+    ecs_var_id_t var_id = flecs_rule_find_var_id(rule, name, EcsVarEntity);
+    if (var_id == EcsVarNone) {
+        return EcsVarNone;
+    }
+
+    ecs_rule_var_t *var = &rule->vars[var_id];
+    if (var->lookup) {
+        return EcsVarNone;
+    }
+
+    if (flecs_rule_is_written(var_id, written)) {
+        return var_id;
+    }
+
+    if (var->table_id != EcsVarNone && 
+        flecs_rule_is_written(var->table_id, written)) 
+    {
+        return var_id;
+    }
+
+    return EcsVarNone;
+}
+
+/* Can term be evaluated by a hash join on source with variable 'src_name' */
+static
+bool flecs_rule_join_term_is_valid(
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    const char *src_name,
+    ecs_write_flags_t written)
+{
+    ecs_term_t *prev = NULL;
+    if (term != rule->filter.terms) {
+        prev = &term[-1];
+    }
+
+    if (!flecs_rule_plan_is_movable(rule, term, prev)) {
+        return false;
+    }
+
+    const char *name = flecs_term_id_var_name(&term->src);
+    if (!name || ecs_os_strcmp(name, src_name)) {
+        return false;
+    }
+
+    bool has_second = ecs_term_id_is_set(&term->second);
+    if (term->first.flags & EcsIsVariable) {
+        /* A variable relationship can't be matched without a target */
+        if (!has_second || flecs_rule_join_key_var(
+            rule, &term->first, src_name, written) == EcsVarNone) 
+        {
+            return false;
+        }
+    }
+
+    if (has_second && (term->second.flags & EcsIsVariable)) {
+        if (flecs_rule_join_key_var(
+            rule, &term->second, src_name, written) == EcsVarNone) 
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Find run of terms starting at order[i] that should be evaluated with a hash 
+ * join. A run contains terms with the same source variable that hasn't been
+ * written yet, where the other variables of the terms are written by earlier 
+ * terms. Without a hash join, the terms in the run are evaluated for each 
+ * result of the earlier terms, which is expensive if the run matches many 
+ * tables. A run with a single term isn't joined, as the id index can already
+ * find the tables for the term when its variables are known.
+ * Returns the number of terms in the run, or 0 if no hash join is used. */
+static
+int32_t flecs_rule_join_find_run(
+    const ecs_world_t *world,
+    ecs_rule_t *rule,
+    const int32_t *order,
+    const int32_t *est,
+    int32_t i,
+    ecs_rule_compile_ctx_t *ctx)
+{
+    ecs_filter_t *filter = &rule->filter;
+    ecs_term_t *terms = filter->terms;
+    int32_t count = filter->term_count;
+
+    if (!i || ctx->scope || ctx->cond_written) {
+        return 0;
+    }
+
+    ecs_term_t *prev = &terms[order[i - 1]];
+    if (prev->oper == EcsOr || prev->first.id == EcsScopeOpen) {
+        return 0;
+    }
+
+    ecs_term_t *term = &terms[order[i]];
+    if (!(term->src.flags & EcsIsVariable)) {
+        return 0;
+    }
+
+    const char *src_name = flecs_term_id_var_name(&term->src);
+    if (!src_name || flecs_term_id_is_wildcard(&term->src)) {
+        return 0;
+    }
+
+    /* Source must be found by the join */
+    ecs_var_id_t tvar = flecs_rule_find_var_id(rule, src_name, EcsVarTable);
+    ecs_var_id_t evar = flecs_rule_find_var_id(rule, src_name, EcsVarEntity);
+    if (tvar == EcsVarNone || flecs_rule_is_written(tvar, ctx->written)) {
+        return 0;
+    }
+    if (evar != EcsVarNone && flecs_rule_is_written(evar, ctx->written)) {
+        return 0;
+    }
+
+    ecs_write_flags_t keys = 0;
+    int32_t n = 0;
+    while ((i + n) < count && n < EcsRuleJoinMaxTerms) {
+        ecs_term_t *cur = &terms[order[i + n]];
+        if (!flecs_rule_join_term_is_valid(rule, cur, src_name, ctx->written)) {
+            break;
+        }
+
+        ecs_write_flags_t cur_keys = keys, bits;
+        ecs_var_id_t key;
+        if ((key = flecs_rule_join_key_var(
+            rule, &cur->first, src_name, ctx->written)) != EcsVarNone) 
+        {
+            cur_keys |= 1ull << key;
+        }
+        if ((key = flecs_rule_join_key_var(
+            rule, &cur->second, src_name, ctx->written)) != EcsVarNone) 
+        {
+            cur_keys |= 1ull << key;
+        }
+
+        int32_t key_count = 0;
+        for (bits = cur_keys; bits; bits &= bits - 1) {
+            key_count ++;
+        }
+        if (key_count > EcsRuleJoinMaxKeys) {
+            break;
+        }
+
+        keys = cur_keys;
+        n ++;
+    }
+
+    if (n < 2 || !keys) {
+        return 0;
+    }
+
+    /* Nested loop evaluates the first term of the run for each result of the
+     * earlier terms. A hash join matches the first term once against all 
+     * tables, and does a lookup for each result of the earlier terms. */
+    double outer = 1;
+    int32_t j;
+    for (j = 0; j < i; j ++) {
+        outer *= (double)est[j];
+    }
+
+    double nested = outer * (double)est[i];
+    double build = (double)flecs_rule_plan_estimate(world, rule, term, 0);
+    if (nested <= FlecsRuleJoinCostFactor * (build + outer)) {
+        return 0;
+    }
+
+    return n;
+}
+
+/* Set join term element to entity or key variable */
+static
+void flecs_rule_join_term_id(
+    ecs_rule_t *rule,
+    ecs_rule_join_t *join,
+    ecs_term_id_t *term_id,
+    ecs_rule_ref_t *ref,
+    int8_t *key,
+    ecs_flags8_t ref_kind,
+    ecs_flags8_t *flags,
+    ecs_rule_compile_ctx_t *ctx)
+{
+    *key = -1;
+
+    if (!ecs_term_id_is_set(term_id)) {
+        return;
+    }
+
+    if (!(term_id->flags & EcsIsVariable)) {
+        *flags |= (ecs_flags8_t)(EcsRuleIsEntity << ref_kind);
+        ref->entity = term_id->id;
+        return;
+    }
+
+    const char *name = flecs_term_id_var_name(term_id);
+    ecs_var_id_t var_id = flecs_rule_find_var_id(rule, name, EcsVarEntity);
+    ecs_assert(var_id != EcsVarNone, ECS_INTERNAL_ERROR, NULL);
+    if (!flecs_rule_is_written(var_id, ctx->written)) {
+        /* Key variable was written as table, get entity from table */
+        flecs_rule_insert_each(
+            rule->vars[var_id].table_id, var_id, ctx, false);
+    }
+
+    *flags |= (ecs_flags8_t)(EcsRuleIsVar << ref_kind);
+    ref->var = var_id;
+
+    int8_t k;
+    for (k = 0; k < join->key_count; k ++) {
+        if (join->keys[k] == var_id) {
+            break;
+        }
+    }
+
+    if (k == join->key_count) {
+        ecs_assert(k < EcsRuleJoinMaxKeys, ECS_INTERNAL_ERROR, NULL);
+        join->keys[join->key_count ++] = var_id;
+    }
+
+    *key = k;
+}
+
+/* Insert hash join operation for run of terms */
+static
+void flecs_rule_compile_join(
+    ecs_rule_t *rule,
+    ecs_term_t **terms,
+    int32_t term_count,
+    int32_t est,
+    ecs_rule_compile_ctx_t *ctx)
+{
+    ecs_rule_join_t *join = ecs_vec_append_t(
+        NULL, &ctx->joins, ecs_rule_join_t);
+    ecs_os_zeromem(join);
+
+    int32_t i;
+    for (i = 0; i < term_count; i ++) {
+        ecs_term_t *term = terms[i];
+        ecs_rule_join_term_t *jterm = &join->terms[i];
+        jterm->field_index = flecs_ito(int8_t, term->field_index);
+        flecs_rule_join_term_id(rule, join, &term->first, &jterm->first,
+            &jterm->first_key, EcsRuleFirst, &jterm->flags, ctx);
+        flecs_rule_join_term_id(rule, join, &term->second, &jterm->second,
+            &jterm->second_key, EcsRuleSecond, &jterm->flags, ctx);
+    }
+
+    join->term_count = flecs_ito(int8_t, term_count);
+    join->entry_size = ECS_SIZEOF(ecs_table_t*) + ECS_SIZEOF(int32_t) * 2 +
+        ECS_SIZEOF(ecs_entity_t) * join->key_count + 
+        (ECS_SIZEOF(ecs_id_t) + ECS_SIZEOF(int32_t)) * term_count;
+    join->entry_size = ECS_ALIGN(join->entry_size, ECS_SIZEOF(ecs_id_t));
+
+    const char *src_name = flecs_term_id_var_name(&terms[0]->src);
+    ecs_var_id_t tvar = flecs_rule_find_var_id(rule, src_name, EcsVarTable);
+
+    ecs_rule_op_t op = {0};
+    op.kind = EcsRuleJoin;
+    op.field_index = flecs_ito(int8_t, terms[0]->field_index);
+    op.term_index = flecs_ito(int8_t, terms[0] - rule->filter.terms);
+    op.other = flecs_itolbl(ecs_vec_count(&ctx->joins) - 1);
+    op.est = est;
+    op.flags = (EcsRuleIsVar << EcsRuleSrc);
+    op.src.var = tvar;
+    flecs_rule_write(tvar, &op.written);
+    flecs_rule_op_insert(&op, ctx);
+    flecs_rule_write_ctx(tvar, ctx, false);
+}
+
 int flecs_rule_compile(
     ecs_world_t *world,
     ecs_stage_t *stage,
@@ -61975,6 +67221,7 @@ int flecs_rule_compile(
     ctx.cur->lbl_or = -1;
     ctx.cur->lbl_union = -1;
     ecs_vec_clear(ctx.ops);
+    ecs_vec_init_t(NULL, &ctx.joins, ecs_rule_join_t, 0);
 
     /* Find all variables defined in query */
     flecs_rule_discover_vars(stage, rule);
@@ -62004,14 +67251,43 @@ int flecs_rule_compile(
         }
     }
 
-    /* Compile query terms to instructions */
+    /* Compile query terms to instructions, in the order picked by planner */
+    int32_t *order = NULL, *est = NULL;
+    if (count) {
+        order = ecs_os_malloc_n(int32_t, count * 2);
+        est = &order[count];
+        flecs_rule_plan(world, rule, order, est);
+    }
+
+    ecs_term_t *prev = NULL;
     for (i = 0; i < count; i ++) {
-        ecs_term_t *term = &terms[i];
-        if (flecs_rule_compile_term(world, rule, term, &ctx)) {
+        ecs_term_t *term = &terms[order[i]];
+
+        /* Check if terms should be evaluated with a hash join */
+        int32_t join_count = flecs_rule_join_find_run(
+            world, rule, order, est, i, &ctx);
+        if (join_count) {
+            ecs_term_t *join_terms[EcsRuleJoinMaxTerms];
+            int32_t j;
+            for (j = 0; j < join_count; j ++) {
+                join_terms[j] = &terms[order[i + j]];
+            }
+            flecs_rule_compile_join(rule, join_terms, join_count, est[i], &ctx);
+            i += join_count - 1;
+            prev = join_terms[join_count - 1];
+            continue;
+        }
+
+        if (flecs_rule_compile_term(world, rule, term, prev, est[i], &ctx)) {
+            ecs_os_free(order);
+            ecs_vec_fini_t(NULL, &ctx.joins, ecs_rule_join_t);
             return -1;
         }
+        prev = term;
     }
 
+    ecs_os_free(order);
+
     /* If This variable has been written as entity, insert an operation to 
      * assign it to it.entities for consistency. */
     ecs_var_id_t this_id = flecs_rule_find_var_id(rule, "This", EcsVarEntity);
@@ -62115,6 +67391,14 @@ int flecs_rule_compile(
         ecs_os_memcpy_n(rule->ops, rule_ops, ecs_rule_op_t, op_count);
     }
 
+    int32_t join_count = ecs_vec_count(&ctx.joins);
+    if (join_count) {
+        rule->join_count = join_count;
+        rule->joins = ecs_os_memdup_n(
+            ecs_vec_first(&ctx.joins), ecs_rule_join_t, join_count);
+    }
+    ecs_vec_fini_t(NULL, &ctx.joins, ecs_rule_join_t);
+
     return 0;
 }
 
@@ -62493,6 +67777,27 @@ void flecs_rule_set_trav_match(
     flecs_rule_set_vars(op, matched, ctx);
 }
 
+/* Test if the next table of the partitioned operation is skipped because it
+ * was claimed by another iterator. Iterators that share a counter visit the
+ * tables of the operation in the same order. An iterator claims an index when
+ * it has passed its previous claim, and skips tables until it reaches it. */
+static
+bool flecs_rule_part_skip(
+    const ecs_rule_run_ctx_t *ctx)
+{
+    ecs_rule_iter_t *rit = &ctx->it->priv.iter.rule;
+    if (!rit->claimed || ctx->op_index != rit->part_op) {
+        return false;
+    }
+
+    int32_t index = rit->part_index ++;
+    if (rit->claim < index) {
+        rit->claim = ecs_os_ainc(rit->claimed) - 1;
+    }
+
+    return rit->claim != index;
+}
+
 static
 bool flecs_rule_select_w_id(
     const ecs_rule_op_t *op,
@@ -62519,10 +67824,12 @@ bool flecs_rule_select_w_id(
     }
 
     if (!redo || !op_ctx->remaining) {
-        tr = flecs_table_cache_next(&op_ctx->it, ecs_table_record_t);
-        if (!tr) {
-            return false;
-        }
+        do {
+            tr = flecs_table_cache_next(&op_ctx->it, ecs_table_record_t);
+            if (!tr) {
+                return false;
+            }
+        } while (flecs_rule_part_skip(ctx));
 
         op_ctx->column = flecs_ito(int16_t, tr->index);
         op_ctx->remaining = flecs_ito(int16_t, tr->count - 1);
@@ -62637,11 +67944,13 @@ bool flecs_rule_select_id(
         }
     }
 
-    const ecs_table_record_t *tr = flecs_table_cache_next(
-        &op_ctx->it, ecs_table_record_t);
-    if (!tr) {
-        return false;
-    }
+    const ecs_table_record_t *tr;
+    do {
+        tr = flecs_table_cache_next(&op_ctx->it, ecs_table_record_t);
+        if (!tr) {
+            return false;
+        }
+    } while (flecs_rule_part_skip(ctx));
 
     ecs_table_t *table = tr->hdr.table;
     flecs_rule_var_set_table(op, op->src.var, table, 0, 0, ctx);
@@ -62739,6 +68048,257 @@ bool flecs_rule_and_any(
     return result;
 }
 
+/* Header of hash join entry. The header is followed by the key values, and the
+ * matched ids and columns for each term. */
+typedef struct {
+    ecs_table_t *table;        /* Table matched by terms */
+    int32_t next;              /* Next entry with same hash, or -1 */
+    int32_t padding;
+} ecs_rule_join_entry_t;
+
+#define flecs_rule_join_keys(entry)\
+    ECS_OFFSET_T(entry, ecs_rule_join_entry_t)
+#define flecs_rule_join_ids(join, entry)\
+    ECS_ELEM_T(flecs_rule_join_keys(entry), ecs_entity_t, (join)->key_count)
+#define flecs_rule_join_columns(join, entry)\
+    ECS_ELEM_T(flecs_rule_join_ids(join, entry), ecs_id_t, (join)->term_count)
+
+/* Get id for join term element. Elements that use a key that isn't known yet
+ * are returned as wildcard. */
+static
+ecs_entity_t flecs_rule_join_entry_elem(
+    const ecs_rule_join_term_t *term,
+    const ecs_rule_ref_t *ref,
+    int8_t key,
+    ecs_flags16_t ref_kind,
+    const ecs_entity_t *keys)
+{
+    ecs_flags16_t flags = flecs_rule_ref_flags(term->flags, ref_kind);
+    if (flags & EcsRuleIsEntity) {
+        return ref->entity;
+    }
+
+    ecs_assert(key != -1, ECS_INTERNAL_ERROR, NULL);
+    if (keys[key]) {
+        return keys[key];
+    }
+
+    return EcsWildcard;
+}
+
+static
+ecs_id_t flecs_rule_join_entry_id(
+    const ecs_rule_join_term_t *term,
+    const ecs_entity_t *keys)
+{
+    ecs_entity_t first = flecs_rule_join_entry_elem(term, &term->first, 
+        term->first_key, EcsRuleFirst, keys);
+    if (!flecs_rule_ref_flags(term->flags, EcsRuleSecond)) {
+        return first;
+    }
+
+    ecs_entity_t second = flecs_rule_join_entry_elem(term, &term->second, 
+        term->second_key, EcsRuleSecond, keys);
+    return ecs_pair(first, second);
+}
+
+/* Set key from matched id, returns false if key already has different value */
+static
+bool flecs_rule_join_set_key(
+    ecs_entity_t *keys,
+    int8_t key,
+    ecs_entity_t value)
+{
+    if (key == -1) {
+        return true;
+    }
+    if (keys[key] && keys[key] != value) {
+        return false;
+    }
+    keys[key] = value;
+    return true;
+}
+
+static
+uint64_t flecs_rule_join_hash(
+    const ecs_rule_join_t *join,
+    const ecs_entity_t *keys)
+{
+    return flecs_hash(keys, ECS_SIZEOF(ecs_entity_t) * join->key_count);
+}
+
+/* Match join terms starting at term_index against table, and add an entry to
+ * the hash table for each combination of keys that matches all terms. */
+static
+void flecs_rule_join_build_table(
+    const ecs_rule_join_t *join,
+    ecs_rule_join_ctx_t *op_ctx,
+    ecs_allocator_t *a,
+    const ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t term_index,
+    ecs_entity_t *keys,
+    ecs_id_t *ids,
+    int32_t *columns)
+{
+    if (term_index == join->term_count) {
+        ecs_rule_join_entry_t *entry = ecs_vec_append(
+            a, &op_ctx->entries, join->entry_size);
+        int32_t index = ecs_vec_count(&op_ctx->entries) - 1;
+        entry->table = table;
+        ecs_os_memcpy_n(flecs_rule_join_keys(entry), keys, 
+            ecs_entity_t, join->key_count);
+        ecs_os_memcpy_n(flecs_rule_join_ids(join, entry), ids, 
+            ecs_id_t, join->term_count);
+        ecs_os_memcpy_n(flecs_rule_join_columns(join, entry), columns, 
+            int32_t, join->term_count);
+
+        ecs_map_val_t *head = ecs_map_ensure(
+            &op_ctx->index, flecs_rule_join_hash(join, keys));
+        entry->next = flecs_uto(int32_t, head[0]) - 1;
+        head[0] = flecs_ito(uint64_t, index + 1);
+        return;
+    }
+
+    const ecs_rule_join_term_t *term = &join->terms[term_index];
+    ecs_id_t id = flecs_rule_join_entry_id(term, keys), matched;
+    ecs_entity_t prev_keys[EcsRuleJoinMaxKeys];
+    ecs_os_memcpy_n(prev_keys, keys, ecs_entity_t, join->key_count);
+
+    int32_t column = -1;
+    while ((column = ecs_search_offset(
+        world, table, column + 1, id, &matched)) != -1)
+    {
+        bool valid = true;
+        if (ECS_IS_PAIR(matched)) {
+            valid = flecs_rule_join_set_key(keys, term->first_key, 
+                ecs_pair_first(world, matched));
+            valid = valid && flecs_rule_join_set_key(keys, term->second_key, 
+                ecs_pair_second(world, matched));
+        }
+
+        if (valid) {
+            ids[term_index] = matched;
+            columns[term_index] = column;
+            flecs_rule_join_build_table(join, op_ctx, a, world, table, 
+                term_index + 1, keys, ids, columns);
+        }
+
+        ecs_os_memcpy_n(keys, prev_keys, ecs_entity_t, join->key_count);
+    }
+}
+
+/* Build hash table with all tables that match the join terms */
+static
+void flecs_rule_join_build(
+    const ecs_rule_join_t *join,
+    ecs_rule_join_ctx_t *op_ctx,
+    const ecs_rule_run_ctx_t *ctx)
+{
+    ecs_allocator_t *a = flecs_rule_get_allocator(ctx->it);
+    ecs_map_init(&op_ctx->index, a);
+    ecs_vec_init(a, &op_ctx->entries, join->entry_size, 0);
+    op_ctx->built = true;
+
+    ecs_entity_t keys[EcsRuleJoinMaxKeys] = {0};
+    ecs_id_t ids[EcsRuleJoinMaxTerms];
+    int32_t columns[EcsRuleJoinMaxTerms];
+
+    /* Find tables for first term with unknown keys */
+    ecs_id_t id = flecs_rule_join_entry_id(&join->terms[0], keys);
+    ecs_id_record_t *idr = flecs_id_record_get(ctx->world, id);
+    if (!idr) {
+        return;
+    }
+
+    ecs_table_cache_iter_t it;
+    if (!flecs_table_cache_iter(&idr->cache, &it)) {
+        return;
+    }
+
+    const ecs_table_record_t *tr;
+    while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+        flecs_rule_join_build_table(join, op_ctx, a, ctx->world, 
+            tr->hdr.table, 0, keys, ids, columns);
+    }
+}
+
+static
+bool flecs_rule_join(
+    const ecs_rule_op_t *op,
+    bool redo,
+    const ecs_rule_run_ctx_t *ctx)
+{
+    ecs_rule_join_ctx_t *op_ctx = flecs_op_ctx(ctx, join);
+    const ecs_rule_join_t *join = &ctx->rule->joins[op->other];
+    ecs_entity_t keys[EcsRuleJoinMaxKeys];
+    int32_t i, key_count = join->key_count;
+
+    if (!op_ctx->built) {
+        flecs_rule_join_build(join, op_ctx, ctx);
+    }
+
+    for (i = 0; i < key_count; i ++) {
+        keys[i] = flecs_rule_var_get_entity(join->keys[i], ctx);
+    }
+
+    int32_t cur;
+    if (!redo) {
+        ecs_map_val_t *head = ecs_map_get(
+            &op_ctx->index, flecs_rule_join_hash(join, keys));
+        if (!head) {
+            return false;
+        }
+        cur = flecs_uto(int32_t, head[0]) - 1;
+    } else {
+        const ecs_rule_join_entry_t *entry = ecs_vec_get(
+            &op_ctx->entries, join->entry_size, op_ctx->cur);
+        cur = entry->next;
+    }
+
+    /* If source was constrained, only return entries for the same table */
+    ecs_table_t *src_table = NULL;
+    uint64_t written = ctx->written[ctx->op_index];
+    if (flecs_ref_is_written(op, &op->src, EcsRuleSrc, written)) {
+        src_table = flecs_rule_var_get_table(op->src.var, ctx);
+    }
+
+    const ecs_rule_join_entry_t *entry = NULL;
+    for (; cur != -1; cur = entry->next) {
+        entry = ecs_vec_get(&op_ctx->entries, join->entry_size, cur);
+        if (src_table && entry->table != src_table) {
+            continue;
+        }
+
+        /* Different keys can have the same hash */
+        if (!ecs_os_memcmp(flecs_rule_join_keys(entry), keys, 
+            ECS_SIZEOF(ecs_entity_t) * key_count)) 
+        {
+            break;
+        }
+    }
+
+    op_ctx->cur = cur;
+    if (cur == -1) {
+        return false;
+    }
+
+    if (!src_table) {
+        flecs_rule_var_set_table(op, op->src.var, entry->table, 0, 0, ctx);
+    }
+
+    ecs_iter_t *it = ctx->it;
+    const ecs_id_t *ids = flecs_rule_join_ids(join, entry);
+    const int32_t *columns = flecs_rule_join_columns(join, entry);
+    for (i = 0; i < join->term_count; i ++) {
+        int8_t field_index = join->terms[i].field_index;
+        it->ids[field_index] = ids[i];
+        flecs_rule_it_set_column(it, field_index, columns[i]);
+    }
+
+    return true;
+}
+
 static
 bool flecs_rule_trav_fixed_src_reflexive(
     const ecs_rule_op_t *op,
@@ -63821,6 +69381,7 @@ bool flecs_rule_run(
     case EcsRuleAndAny: return flecs_rule_and_any(op, redo, ctx);
     case EcsRuleWith: return flecs_rule_with(op, redo, ctx);
     case EcsRuleTrav: return flecs_rule_trav(op, redo, ctx);
+    case EcsRuleJoin: return flecs_rule_join(op, redo, ctx);
     case EcsRuleIdsRight: return flecs_rule_idsright(op, redo, ctx);
     case EcsRuleIdsLeft: return flecs_rule_idsleft(op, redo, ctx);
     case EcsRuleEach: return flecs_rule_each(op, redo, ctx);
@@ -63886,6 +69447,38 @@ void flecs_rule_iter_init(
     flecs_iter_validate(it);
 }
 
+/* Find operation that is split up between partitioned iterators. This is the
+ * first operation that selects tables for a variable source, if it is only
+ * preceded by operations that don't yield more than once. */
+static
+int16_t flecs_rule_part_op(
+    const ecs_rule_t *rule,
+    uint64_t written)
+{
+    int32_t i, count = rule->op_count;
+    for (i = 0; i < count; i ++) {
+        const ecs_rule_op_t *op = &rule->ops[i];
+        switch(op->kind) {
+        case EcsRuleSetIds:
+        case EcsRuleSetFixed:
+            continue;
+        case EcsRuleAnd:
+        case EcsRuleAndId:
+        case EcsRuleAndAny:
+            if ((flecs_rule_ref_flags(op->flags, EcsRuleSrc) & EcsRuleIsVar) &&
+                !flecs_ref_is_written(op, &op->src, EcsRuleSrc, written)) 
+            {
+                return flecs_ito(int16_t, i);
+            }
+            break;
+        default:
+            break;
+        }
+        break;
+    }
+    return -1;
+}
+
 bool ecs_rule_next(
     ecs_iter_t *it)
 {
@@ -63908,6 +69501,25 @@ bool ecs_rule_next_instanced(
     ecs_assert(it->next == ecs_rule_next, ECS_INVALID_PARAMETER, NULL);
 
     ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    if (rit->cache) {
+        /* Variables constrained by the application aren't stored in the cache,
+         * so evaluate the rule program instead. */
+        if (!it->constrained_vars) {
+            if (flecs_rule_cache_next(it)) {
+                return true;
+            }
+            goto done;
+        }
+        rit->cache = NULL;
+    }
+
+    if (rit->yield_table) {
+        /* Restore count of table range that was set for the previous result,
+         * so that operations see the same range as before the yield. */
+        rit->vars[0].range.count = 0;
+        rit->yield_table = false;
+    }
+
     bool redo = it->flags & EcsIterIsValid;
     ecs_rule_lbl_t next;
 
@@ -63928,6 +69540,16 @@ bool ecs_rule_next_instanced(
             goto done;
         }
         flecs_rule_iter_init(&ctx);
+
+        if (rit->claimed) {
+            rit->part_op = flecs_rule_part_op(ctx.rule, ctx.written[0]);
+            if (rit->part_op == -1) {
+                /* Rule can't be split up, first iterator returns all results */
+                if (ecs_os_ainc(rit->claimed) != 1) {
+                    goto done;
+                }
+            }
+        }
     }
 
     do {
@@ -63957,7 +69579,8 @@ bool ecs_rule_next_instanced(
         if (op->kind == EcsRuleYield) {
             ecs_table_range_t *range = &rit->vars[0].range;
             ecs_table_t *table = range->table;
-            if (table && !range->count) {
+            rit->yield_table = table && !range->count;
+            if (rit->yield_table) {
                 range->count = ecs_table_count(table);
             }
             flecs_iter_populate_data(ctx.world, it, range->table, range->offset,
@@ -63992,6 +69615,15 @@ void flecs_rule_iter_fini_ctx(
         case EcsRuleTrav:
             flecs_rule_trav_cache_fini(a, &ctx[i].is.trav.cache);
             break;
+        case EcsRuleJoin: {
+            ecs_rule_join_ctx_t *join_ctx = &ctx[i].is.join;
+            if (join_ctx->built) {
+                ecs_map_fini(&join_ctx->index);
+                ecs_vec_fini(a, &join_ctx->entries, 
+                    rule->joins[op->other].entry_size);
+            }
+            break;
+        }
         default:
             break;
         }
@@ -64028,7 +69660,7 @@ void flecs_rule_iter_fini(
     rit->rule = NULL;
 }
 
-ecs_iter_t ecs_rule_iter(
+ecs_iter_t flecs_rule_iter(
     const ecs_world_t *world,
     const ecs_rule_t *rule)
 {
@@ -64036,8 +69668,6 @@ ecs_iter_t ecs_rule_iter(
     ecs_rule_iter_t *rit = &it.priv.iter.rule;
     ecs_check(rule != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    ecs_run_aperiodic(rule->filter.world, EcsAperiodicEmptyTables);
-
     int32_t i, var_count = rule->var_count, op_count = rule->op_count;
     it.world = ECS_CONST_CAST(ecs_world_t*, world);
     it.real_world = rule->filter.world;
@@ -64081,11 +69711,59 @@ error:
     return it;
 }
 
+ecs_iter_t ecs_rule_iter(
+    const ecs_world_t *world,
+    const ecs_rule_t *rule)
+{
+    ecs_check(rule != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_run_aperiodic(rule->filter.world, EcsAperiodicEmptyTables);
+
+    ecs_iter_t it = flecs_rule_iter(world, rule);
+    if (rule->cache) {
+        it.priv.iter.rule.cache = flecs_rule_cache_get(rule);
+    }
+
+    return it;
+error:
+    return (ecs_iter_t){0};
+}
+
+void ecs_rule_iter_set_partition(
+    ecs_iter_t *it,
+    int32_t *claimed)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_rule_next, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(it->flags & EcsIterIsValid), ECS_INVALID_PARAMETER, NULL);
+    ecs_check(claimed != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_os_has_threading(), ECS_MISSING_OS_API, NULL);
+
+    ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    rit->claimed = claimed;
+    rit->claim = -1;
+    rit->part_index = 0;
+    rit->part_op = -1;
+error:
+    return;
+}
+
 #endif
 
 /**
  * @file addons/rules/trav_cache.c
  * @brief Cache that stores the result of graph traversal.
+ *
+ * The transitive closures of entities are stored in a world level cache, so
+ * that rules don't have to walk the graph of a relationship for each iterator.
+ * The closures for a relationship are discarded when the generation of its
+ * (R, *) id record changes, which happens when an entity that can be traversed
+ * enters or leaves a table with a pair for the relationship, and when a 
+ * (R, target) id record is created or deleted.
+ *
+ * Iterators copy closures into their own cache, so that the world level cache
+ * can be updated while iterators are alive. The world level cache is not used
+ * when the world is multithreaded, in which case iterators walk the graph.
  */
 
 
@@ -64105,14 +69783,14 @@ void flecs_rule_build_down_cache(
         return;
     }
 
-    ecs_trav_elem_t *elem = ecs_vec_append_t(a, &cache->entities, 
+    ecs_trav_elem_t *elem = ecs_vec_append_t(a, &cache->entities,
         ecs_trav_elem_t);
     elem->entity = entity;
     elem->idr = idr;
 
     ecs_table_cache_iter_t it;
     if (flecs_table_cache_iter(&idr->cache, &it)) {
-        ecs_table_record_t *tr; 
+        ecs_table_record_t *tr;
         while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
             ecs_assert(tr->count == 1, ECS_INTERNAL_ERROR, NULL);
             ecs_table_t *table = tr->hdr.table;
@@ -64155,7 +69833,7 @@ void flecs_rule_build_up_cache(
             root_column = i;
         }
 
-        ecs_trav_elem_t *el = ecs_vec_append_t(a, &cache->entities, 
+        ecs_trav_elem_t *el = ecs_vec_append_t(a, &cache->entities,
             ecs_trav_elem_t);
         el->entity = second;
         el->column = root_column;
@@ -64166,14 +69844,205 @@ void flecs_rule_build_up_cache(
             ecs_table_record_t *r_tr = flecs_id_record_get_table(
                 cache->idr, r->table);
             if (!r_tr) {
-                return;
+                continue;
             }
-            flecs_rule_build_up_cache(world, a, ctx, cache, trav, r->table, 
+            flecs_rule_build_up_cache(world, a, ctx, cache, trav, r->table,
                 r_tr, root_column);
         }
     }
 }
 
+static
+void flecs_rule_trav_closures_clear(
+    ecs_world_t *world,
+    ecs_trav_rel_cache_t *rel_cache)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_map_iter_t it = ecs_map_iter(&rel_cache->closures);
+    while (ecs_map_next(&it)) {
+        ecs_trav_closure_t *closure = ecs_map_ptr(&it);
+        if (closure->down_valid) {
+            ecs_vec_fini_t(a, &closure->down, ecs_entity_t);
+        }
+        if (closure->up_valid) {
+            ecs_vec_fini_t(a, &closure->up, ecs_entity_t);
+        }
+        ecs_os_free(closure);
+    }
+    ecs_map_clear(&rel_cache->closures);
+}
+
+static
+void flecs_rule_trav_cache_world_fini(
+    ecs_world_t *world,
+    void *ctx)
+{
+    (void)ctx;
+
+    ecs_map_iter_t it = ecs_map_iter(&world->trav_cache);
+    while (ecs_map_next(&it)) {
+        ecs_trav_rel_cache_t *rel_cache = ecs_map_ptr(&it);
+        flecs_rule_trav_closures_clear(world, rel_cache);
+        ecs_map_fini(&rel_cache->closures);
+        ecs_os_free(rel_cache);
+    }
+    ecs_map_fini(&world->trav_cache);
+}
+
+static
+ecs_trav_closure_t* flecs_rule_trav_closure_get(
+    ecs_world_t *world,
+    ecs_entity_t trav,
+    ecs_entity_t entity,
+    bool up);
+
+/* Entity, and entities that have the entity as target, and so on */
+static
+void flecs_rule_trav_closure_build_down(
+    ecs_world_t *world,
+    ecs_trav_closure_t *closure,
+    ecs_entity_t trav,
+    ecs_entity_t entity)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_clear(&closure->down);
+
+    ecs_id_record_t *idr = flecs_id_record_get(world, ecs_pair(trav, entity));
+    if (!idr) {
+        return;
+    }
+
+    ecs_vec_append_t(a, &closure->down, ecs_entity_t)[0] = entity;
+
+    ecs_table_cache_iter_t it;
+    if (!flecs_table_cache_iter(&idr->cache, &it)) {
+        return;
+    }
+
+    ecs_table_record_t *tr;
+    while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+        ecs_assert(tr->count == 1, ECS_INTERNAL_ERROR, NULL);
+        ecs_table_t *table = tr->hdr.table;
+        if (!table->_->traversable_count) {
+            continue;
+        }
+
+        int32_t i, count = ecs_table_count(table);
+        ecs_record_t **records = table->data.records.array;
+        ecs_entity_t *entities = table->data.entities.array;
+        for (i = 0; i < count; i ++) {
+            if (!(records[i]->row & EcsEntityIsTraversable)) {
+                continue;
+            }
+
+            ecs_trav_closure_t *child = flecs_rule_trav_closure_get(
+                world, trav, entities[i], false);
+            ecs_assert(child != NULL, ECS_INTERNAL_ERROR, NULL);
+            int32_t child_count = ecs_vec_count(&child->down);
+            if (child_count) {
+                ecs_os_memcpy_n(ecs_vec_grow_t(a, &closure->down,
+                    ecs_entity_t, child_count), ecs_vec_first(&child->down),
+                        ecs_entity_t, child_count);
+            }
+        }
+    }
+}
+
+/* Targets of entity, and targets of the targets, and so on */
+static
+void flecs_rule_trav_closure_build_up(
+    ecs_world_t *world,
+    ecs_trav_closure_t *closure,
+    ecs_entity_t trav,
+    ecs_entity_t entity)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_clear(&closure->up);
+
+    ecs_record_t *r = flecs_entities_get_any(world, entity);
+    if (!r || !r->table) {
+        return;
+    }
+
+    ecs_id_record_t *idr = flecs_id_record_get(world,
+        ecs_pair(trav, EcsWildcard));
+    ecs_table_record_t *tr = flecs_id_record_get_table(idr, r->table);
+    if (!tr) {
+        return;
+    }
+
+    ecs_id_t *ids = r->table->type.array;
+    int32_t i = tr->index, end = i + tr->count;
+    for (; i < end; i ++) {
+        ecs_entity_t tgt = ecs_pair_second(world, ids[i]);
+        ecs_vec_append_t(a, &closure->up, ecs_entity_t)[0] = tgt;
+
+        ecs_trav_closure_t *parent = flecs_rule_trav_closure_get(
+            world, trav, tgt, true);
+        ecs_assert(parent != NULL, ECS_INTERNAL_ERROR, NULL);
+        int32_t parent_count = ecs_vec_count(&parent->up);
+        if (parent_count) {
+            ecs_os_memcpy_n(ecs_vec_grow_t(a, &closure->up,
+                ecs_entity_t, parent_count), ecs_vec_first(&parent->up),
+                    ecs_entity_t, parent_count);
+        }
+    }
+}
+
+/* Get closure from world level cache. Returns NULL if the cache can't be
+ * used, in which case the caller has to traverse the graph. */
+static
+ecs_trav_closure_t* flecs_rule_trav_closure_get(
+    ecs_world_t *world,
+    ecs_entity_t trav,
+    ecs_entity_t entity,
+    bool up)
+{
+    /* Other threads could be reading the cache */
+    if (world->flags & (EcsWorldMultiThreaded | EcsWorldFini)) {
+        return NULL;
+    }
+
+    ecs_id_record_t *idr = flecs_id_record_get(world,
+        ecs_pair(trav, EcsWildcard));
+    if (!idr) {
+        return NULL;
+    }
+
+    if (!ecs_map_is_init(&world->trav_cache)) {
+        ecs_map_init(&world->trav_cache, &world->allocator);
+        ecs_atfini(world, flecs_rule_trav_cache_world_fini, NULL);
+    }
+
+    ecs_trav_rel_cache_t *rel_cache = ecs_map_ensure_alloc_t(
+        &world->trav_cache, ecs_trav_rel_cache_t, trav);
+    if (!ecs_map_is_init(&rel_cache->closures)) {
+        ecs_map_init(&rel_cache->closures, &world->allocator);
+        rel_cache->generation = idr->trav_generation;
+    } else if (rel_cache->generation != idr->trav_generation) {
+        flecs_rule_trav_closures_clear(world, rel_cache);
+        rel_cache->generation = idr->trav_generation;
+    }
+
+    ecs_trav_closure_t *closure = ecs_map_ensure_alloc_t(
+        &rel_cache->closures, ecs_trav_closure_t, entity);
+    if (up) {
+        if (!closure->up_valid) {
+            ecs_vec_init_t(&world->allocator, &closure->up, ecs_entity_t, 0);
+            flecs_rule_trav_closure_build_up(world, closure, trav, entity);
+            closure->up_valid = true;
+        }
+    } else {
+        if (!closure->down_valid) {
+            ecs_vec_init_t(&world->allocator, &closure->down, ecs_entity_t, 0);
+            flecs_rule_trav_closure_build_down(world, closure, trav, entity);
+            closure->down_valid = true;
+        }
+    }
+
+    return closure;
+}
+
 void flecs_rule_trav_cache_fini(
     ecs_allocator_t *a,
     ecs_trav_cache_t *cache)
@@ -64191,7 +70060,23 @@ void flecs_rule_get_down_cache(
         ecs_world_t *world = ctx->it->real_world;
         ecs_allocator_t *a = flecs_rule_get_allocator(ctx->it);
         ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
-        flecs_rule_build_down_cache(world, a, ctx, cache, trav, entity);
+
+        ecs_trav_closure_t *closure = flecs_rule_trav_closure_get(
+            world, trav, entity, false);
+        if (closure) {
+            int32_t i, count = ecs_vec_count(&closure->down);
+            ecs_entity_t *entities = ecs_vec_first(&closure->down);
+            for (i = 0; i < count; i ++) {
+                ecs_trav_elem_t *elem = ecs_vec_append_t(a, &cache->entities,
+                    ecs_trav_elem_t);
+                elem->entity = entities[i];
+                elem->idr = NULL; /* Looked up by select */
+                elem->column = 0;
+            }
+        } else {
+            flecs_rule_build_down_cache(world, a, ctx, cache, trav, entity);
+        }
+
         cache->id = ecs_pair(trav, entity);
         cache->up = false;
     }
@@ -64209,7 +70094,7 @@ void flecs_rule_get_up_cache(
 
     ecs_id_record_t *idr = cache->idr;
     if (!idr || idr->id != ecs_pair(trav, EcsWildcard)) {
-        idr = cache->idr = flecs_id_record_get(world, 
+        idr = cache->idr = flecs_id_record_get(world,
             ecs_pair(trav, EcsWildcard));
         if (!idr) {
             ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
@@ -64223,13 +70108,46 @@ void flecs_rule_get_up_cache(
         return;
     }
 
-    ecs_id_t id = table->type.array[tr->index];
+    ecs_id_t *ids = table->type.array;
+    ecs_id_t id = ids[tr->index];
 
-    if (cache->id != id || !cache->up) {
-        ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
-        flecs_rule_build_up_cache(world, a, ctx, cache, trav, table, tr, -1);
-        cache->id = id;
-        cache->up = true;
+    /* Tables with more than one pair can't be identified by the first pair */
+    if (cache->id == id && cache->up && tr->count == 1) {
+        return;
+    }
+
+    ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
+    cache->id = id;
+    cache->up = true;
+
+    int32_t column, end = tr->index + tr->count;
+    for (column = tr->index; column < end; column ++) {
+        ecs_entity_t tgt = ecs_pair_second(world, ids[column]);
+        ecs_trav_closure_t *closure = flecs_rule_trav_closure_get(
+            world, trav, tgt, true);
+        if (!closure) {
+            ecs_table_record_t tgt_tr = *tr;
+            tgt_tr.index = flecs_ito(int16_t, column);
+            tgt_tr.count = 1;
+            flecs_rule_build_up_cache(world, a, ctx, cache, trav, table,
+                &tgt_tr, column);
+            continue;
+        }
+
+        ecs_trav_elem_t *el = ecs_vec_append_t(a, &cache->entities,
+            ecs_trav_elem_t);
+        el->entity = tgt;
+        el->column = column;
+        el->idr = NULL;
+
+        int32_t i, count = ecs_vec_count(&closure->up);
+        ecs_entity_t *entities = ecs_vec_first(&closure->up);
+        for (i = 0; i < count; i ++) {
+            el = ecs_vec_append_t(a, &cache->entities, ecs_trav_elem_t);
+            el->entity = entities[i];
+            el->column = column;
+            el->idr = NULL;
+        }
     }
 }
 
@@ -64261,7 +70179,8 @@ ecs_entity_t ecs_run_intern(
     ecs_entity_t system,
     ecs_system_t *system_data,
     int32_t stage_index,
-    int32_t stage_count,    
+    int32_t stage_count,
+    int32_t chunk_size,
     ecs_ftime_t delta_time,
     int32_t offset,
     int32_t limit,
@@ -64334,7 +70253,14 @@ ecs_entity_t ecs_run_intern(
     }
 
     if (stage_count > 1 && system_data->multi_threaded) {
-        wit = ecs_worker_iter(it, stage_index, stage_count);
+        if (chunk_size) {
+            /* Workers claim chunks from a counter that the caller resets 
+             * before workers start running the system */
+            wit = ecs_worker_chunk_iter(it, 
+                &system_data->worker_claimed, chunk_size);
+        } else {
+            wit = ecs_worker_iter(it, stage_index, stage_count);
+        }
         it = &wit;
     }
 
@@ -64383,8 +70309,8 @@ ecs_entity_t ecs_run_w_filter(
     ecs_stage_t *stage = flecs_stage_from_world(&world);
     ecs_system_t *system_data = ecs_poly_get(world, system, ecs_system_t);
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
-    return ecs_run_intern(world, stage, system, system_data, 0, 0, delta_time, 
-        offset, limit, param);
+    return ecs_run_intern(world, stage, system, system_data, 0, 0, 0, 
+        delta_time, offset, limit, param);
 }
 
 ecs_entity_t ecs_run_worker(
@@ -64400,7 +70326,7 @@ ecs_entity_t ecs_run_worker(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
 
     return ecs_run_intern(
-        world, stage, system, system_data, stage_index, stage_count, 
+        world, stage, system, system_data, stage_index, stage_count, 0,
         delta_time, 0, 0, param);
 }
 
@@ -177,6 +177,7 @@
 #ifdef FLECS_LOW_FOOTPRINT
 #define FLECS_HI_COMPONENT_ID (16)
 #define FLECS_HI_ID_RECORD_ID (16)
+#define FLECS_HI_PAIR_INDEX_ID (256)
 #define FLECS_SPARSE_PAGE_BITS (6)
 #define FLECS_ENTITY_PAGE_BITS (6)
 #define FLECS_USE_OS_ALLOC
@@ -206,6 +207,16 @@
 #define FLECS_HI_ID_RECORD_ID (1024)
 #endif
 
+/** \def FLECS_HI_PAIR_INDEX_ID
+ * This constant can be used to balance between performance and memory 
+ * utilization. Pairs for which both the relationship and target are below this
+ * value are stored in a paged lookup array. Other pairs use a regular map
+ * lookup, which is slower but more memory efficient.
+ */
+#ifndef FLECS_HI_PAIR_INDEX_ID
+#define FLECS_HI_PAIR_INDEX_ID (65536)
+#endif
+
 /** \def FLECS_SPARSE_PAGE_BITS
  * This constant is used to determine the number of bits of an id that is used
  * to determine the page index when used with a sparse set. The number of bits
@@ -227,6 +238,35 @@
  * as memory will be freed more often, at the cost of decreased performance. */
 // #define FLECS_USE_OS_ALLOC
 
+/** \def FLECS_MAP_SWISS
+ * When enabled, ecs_map_t uses open addressing instead of chained buckets. Map
+ * elements are stored in a flat array, and lookups test the hashes of a group
+ * of 16 elements at a time (with SSE2 instructions where available). This
+ * avoids an allocation per element and reduces pointer chasing on lookups, at
+ * the cost of more memory for small maps. Pointers to map values are
+ * invalidated when an element is inserted. The layout of ecs_map_t does not
+ * change with this setting, so it only has to be defined when building Flecs
+ * and code that uses the map API doesn't have to be built with it. */
+// #define FLECS_MAP_SWISS
+
+/** \def FLECS_BALLOC_LARGE_SIZE
+ * Allocations of this size or larger are not served from a block allocator
+ * block, but are allocated directly from the OS allocator. This prevents 
+ * large buffers (like the columns of big tables) from being cached by the
+ * block allocator after they're freed, and lets the OS allocator grow them in
+ * place, which avoids copying when a buffer is resized. */
+#ifndef FLECS_BALLOC_LARGE_SIZE
+#define FLECS_BALLOC_LARGE_SIZE (64 * 1024)
+#endif
+
+/** \def FLECS_BALLOC_PAGE_ALLOC_SIZE
+ * Allocations of this size or larger are mapped with the page allocation
+ * functions of the OS API when available. The builtin POSIX implementation
+ * backs these allocations with transparent huge pages where supported. */
+#ifndef FLECS_BALLOC_PAGE_ALLOC_SIZE
+#define FLECS_BALLOC_PAGE_ALLOC_SIZE (2 * 1024 * 1024)
+#endif
+
 /** \def FLECS_ID_DESC_MAX
  * Maximum number of ids to add ecs_entity_desc_t / ecs_bulk_desc_t */
 #ifndef FLECS_ID_DESC_MAX
@@ -398,6 +438,7 @@ extern "C" {
 #define EcsFilterUnresolvedByName      (1u << 11u) /* Use by-name matching for unresolved entity identifiers */
 #define EcsFilterHasPred               (1u << 12u) /* Filter has equality predicates */
 #define EcsFilterHasScopes             (1u << 13u) /* Filter has query scopes */
+#define EcsFilterCached                (1u << 14u) /* Cache rule results (rules only) */
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Table flags (used by ecs_table_t::flags)
@@ -451,6 +492,8 @@ extern "C" {
 #define EcsQueryHasNonThisOutTerms     (1u << 5u)  /* Does query have non-this out terms */
 #define EcsQueryHasMonitor             (1u << 6u)  /* Does query track changes */
 #define EcsQueryTrivialIter            (1u << 7u)  /* Does the query require special features to iterate */
+#define EcsQueryPrefetch               (1u << 8u)  /* Prefetch data of next table during iteration */
+#define EcsQueryCompiledIter           (1u << 9u)  /* Can owned matches iterate with compiled plan */
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1332,6 +1375,14 @@ void* ecs_sparse_get(
 #define FLECS_BLOCK_ALLOCATOR_H
 
 
+/** Max alignment of chunks. Chunks are aligned to the largest power of two 
+ * that divides the chunk size, up to this value. */
+#define FLECS_BALLOC_MAX_ALIGN (64)
+
+/** Depot through which block allocators used by different threads can share 
+ * free chunks. */
+typedef struct ecs_block_allocator_depot_t ecs_block_allocator_depot_t;
+
 typedef struct ecs_block_allocator_block_t {
     void *memory;
     struct ecs_block_allocator_block_t *next;
@@ -1350,6 +1401,10 @@ typedef struct ecs_block_allocator_t {
     int32_t chunks_per_block;
     int32_t block_size;
     int32_t alloc_count;
+    int32_t page_count;             /* Chunks allocated with page functions */
+    int32_t huge_page_advised_count; /* Chunks for which huge pages were requested */
+    int32_t free_count;             /* Number of chunks in free list */
+    ecs_block_allocator_depot_t *depot; /* Depot to share free chunks with */
 } ecs_block_allocator_t;
 
 FLECS_API
@@ -1379,6 +1434,25 @@ FLECS_API
 void flecs_ballocator_free(
     ecs_block_allocator_t *ba);
 
+/** Create depot. Block allocators that have a depot return surplus free chunks
+ * to the depot, and take chunks from the depot before allocating new blocks. 
+ * When a block allocator with a depot is finalized, its blocks are moved to
+ * the depot, as chunks may be in use by other allocators. The depot must be 
+ * freed after all of its allocators are finalized. */
+FLECS_API
+ecs_block_allocator_depot_t* flecs_ballocator_depot_new(void);
+
+FLECS_API
+void flecs_ballocator_depot_free(
+    ecs_block_allocator_depot_t *depot);
+
+/** Free blocks of finalized allocators of which all chunks have been returned
+ * to the depot. Blocks with chunks that are still in use by other allocators
+ * are kept. */
+FLECS_API
+void flecs_ballocator_depot_trim(
+    ecs_block_allocator_depot_t *depot);
+
 FLECS_API
 void* flecs_balloc(
     ecs_block_allocator_t *allocator);
@@ -1433,6 +1507,9 @@ typedef struct ecs_bucket_t {
     ecs_bucket_entry_t *first;
 } ecs_bucket_t;
 
+/* The map has the same layout with and without FLECS_MAP_SWISS, so that
+ * applications don't need to be compiled with the same setting as Flecs. With
+ * FLECS_MAP_SWISS, buckets points to the storage of the open addressing map. */
 typedef struct ecs_map_t {
     uint8_t bucket_shift;
     bool shared_allocator;
@@ -1615,6 +1692,7 @@ FLECS_DBG_API extern int64_t ecs_stack_allocator_free_count;
 struct ecs_allocator_t {
     ecs_block_allocator_t chunks;
     struct ecs_sparse_t sizes; /* <size, block_allocator_t> */
+    ecs_block_allocator_depot_t *depot; /* Optional depot for block allocators */
 };
 
 FLECS_API
@@ -1630,6 +1708,14 @@ ecs_block_allocator_t* flecs_allocator_get(
     ecs_allocator_t *a, 
     ecs_size_t size);
 
+/* Returns the number of bytes allocated with page allocation functions. If huge
+ * is true, only bytes for which huge pages were requested are counted. Whether
+ * the OS actually backs them with huge pages is not known. */
+FLECS_API
+int64_t flecs_allocator_page_bytes(
+    ecs_allocator_t *a,
+    bool huge);
+
 FLECS_API
 char* flecs_strdup(
     ecs_allocator_t *a, 
@@ -2005,6 +2091,24 @@ typedef
 char* (*ecs_os_api_strdup_t)(
     const char *str);
 
+/* Page allocation */
+typedef
+void* (*ecs_os_api_page_alloc_t)(
+    ecs_size_t size,    /* Size of allocation */
+    bool *huge);        /* Set to true if huge pages were requested for memory */
+
+typedef
+void* (*ecs_os_api_page_realloc_t)(
+    void *ptr,          /* Memory returned by page_alloc_/page_realloc_ */
+    ecs_size_t old_size, /* Size of existing allocation */
+    ecs_size_t size,    /* New size of allocation */
+    bool *huge);        /* Set to true if huge pages were requested for memory */
+
+typedef
+void (*ecs_os_api_page_free_t)(
+    void *ptr,          /* Memory returned by page_alloc_/page_realloc_ */
+    ecs_size_t size);   /* Size of allocation */
+
 /* Threads */
 typedef
 void* (*ecs_os_thread_callback_t)(
@@ -2041,6 +2145,12 @@ typedef
 int64_t (*ecs_os_api_lainc_t)(
     int64_t *value);
 
+/* Atomic add, returns the new value */
+typedef
+int32_t (*ecs_os_api_aadd_t)(
+    int32_t *value,
+    int32_t add);
+
 /* Mutex */
 typedef
 ecs_os_mutex_t (*ecs_os_api_mutex_new_t)(
@@ -2080,6 +2190,16 @@ void (*ecs_os_api_cond_wait_t)(
     ecs_os_cond_t cond,
     ecs_os_mutex_t mutex);
 
+/* Futex-style wait / wake */
+typedef
+void (*ecs_os_api_futex_wait_t)(
+    int32_t *value,     /* Value to wait on */
+    int32_t expected);  /* Return when value no longer equals expected */
+
+typedef
+void (*ecs_os_api_futex_wake_t)(
+    int32_t *value);    /* Wake all threads waiting on value */
+
 typedef 
 void (*ecs_os_api_sleep_t)(
     int32_t sec,
@@ -2215,6 +2335,24 @@ typedef struct ecs_os_api_t {
 
     /* OS API flags */
     ecs_flags32_t flags_;
+
+    /* Futex-style wait / wake (optional). When provided, worker threads use 
+     * atomic counters to synchronize instead of mutex / condition variables.
+     * futex_wait_ must not return before the value has changed, and must 
+     * ensure that writes made before the change are visible to the caller. */
+    ecs_os_api_futex_wait_t futex_wait_;
+    ecs_os_api_futex_wake_t futex_wake_;
+
+    /* Page allocation (optional). When provided, buffers larger than
+     * FLECS_BALLOC_PAGE_ALLOC_SIZE (like the columns of big tables) are mapped 
+     * directly from the OS, which lets an implementation back them with huge
+     * pages to reduce TLB misses. Returned memory must be page aligned. */
+    ecs_os_api_page_alloc_t page_alloc_;
+    ecs_os_api_page_realloc_t page_realloc_;
+    ecs_os_api_page_free_t page_free_;
+
+    /* Atomic add (optional) */
+    ecs_os_api_aadd_t aadd_;
 } ecs_os_api_t;
 
 FLECS_API
@@ -2249,6 +2387,10 @@ void ecs_os_set_api_defaults(void);
 #ifndef ecs_os_calloc
 #define ecs_os_calloc(size) ecs_os_api.calloc_(size)
 #endif
+#define ecs_os_page_alloc(size, huge) ecs_os_api.page_alloc_(size, huge)
+#define ecs_os_page_realloc(ptr, old_size, size, huge)\
+    ecs_os_api.page_realloc_(ptr, old_size, size, huge)
+#define ecs_os_page_free(ptr, size) ecs_os_api.page_free_(ptr, size)
 #if defined(ECS_TARGET_WINDOWS)
 #define ecs_os_alloca(size) _alloca((size_t)(size))
 #else
@@ -2344,6 +2486,7 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_adec(value) ecs_os_api.adec_(value)
 #define ecs_os_lainc(value) ecs_os_api.lainc_(value)
 #define ecs_os_ladec(value) ecs_os_api.ladec_(value)
+#define ecs_os_aadd(value, add) ecs_os_api.aadd_(value, add)
 
 /* Mutex */
 #define ecs_os_mutex_new() ecs_os_api.mutex_new_()
@@ -2358,6 +2501,10 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_cond_broadcast(cond) ecs_os_api.cond_broadcast_(cond)
 #define ecs_os_cond_wait(cond, mutex) ecs_os_api.cond_wait_(cond, mutex)
 
+/* Futex */
+#define ecs_os_futex_wait(value, expected) ecs_os_api.futex_wait_(value, expected)
+#define ecs_os_futex_wake(value) ecs_os_api.futex_wake_(value)
+
 /* Time */
 #define ecs_os_sleep(sec, nanosec) ecs_os_api.sleep_(sec, nanosec)
 #define ecs_os_now() ecs_os_api.now_()
@@ -2449,6 +2596,10 @@ void* ecs_os_memdup(
 FLECS_API
 bool ecs_os_has_heap(void);
 
+/** Are page allocation functions available? */
+FLECS_API
+bool ecs_os_has_page_alloc(void);
+
 /** Are threading functions available? */
 FLECS_API
 bool ecs_os_has_threading(void);
@@ -2457,6 +2608,10 @@ bool ecs_os_has_threading(void);
 FLECS_API
 bool ecs_os_has_task_support(void);
 
+/** Are futex functions available? */
+FLECS_API
+bool ecs_os_has_futex(void);
+
 /** Are time functions available? */
 FLECS_API
 bool ecs_os_has_time(void);
@@ -3204,6 +3359,15 @@ typedef struct ecs_worker_iter_t {
     int32_t count;
 } ecs_worker_iter_t;
 
+/* Chunked worker-iterator specific data */
+typedef struct ecs_worker_chunk_iter_t {
+    int32_t *claimed;     /* Chunk counter shared between workers */
+    int32_t chunk_size;   /* Max number of rows per chunk */
+    int32_t first_chunk;  /* Index of first chunk of current result */
+    int32_t chunk_count;  /* Number of chunks in current result */
+    void **ptrs;          /* Field pointers of claimed chunk */
+} ecs_worker_chunk_iter_t;
+
 /* Convenience struct to iterate table array for id */
 typedef struct ecs_table_cache_iter_t {
     struct ecs_table_cache_hdr_t *cur, *next;
@@ -3286,6 +3450,15 @@ typedef struct ecs_rule_iter_t {
     ecs_rule_op_profile_t *profile;
 #endif
 
+    const struct ecs_rule_cache_t *cache; /* Results of cached rule */
+    int32_t cache_cur;                   /* Current cached result */
+    bool yield_table;                    /* Does result contain entire table */
+
+    int32_t *claimed;                    /* Counter shared by partitioned iterators */
+    int32_t claim;                       /* Last index claimed by iterator */
+    int32_t part_index;                  /* Index of table in partitioned op */
+    int16_t part_op;                     /* Partitioned operation */
+
     bool redo;
     int16_t op;
     int16_t sp;
@@ -3320,6 +3493,7 @@ typedef struct ecs_iter_private_t {
         ecs_snapshot_iter_t snapshot;
         ecs_page_iter_t page;
         ecs_worker_iter_t worker;
+        ecs_worker_chunk_iter_t worker_chunk;
     } iter;                       /* Iterator specific data */
 
     void *entity_iter;            /* Filter applied after matching a table */
@@ -3819,6 +3993,11 @@ typedef struct ecs_query_desc_t {
     /** Function to free group_by_ctx */
     ecs_ctx_free_t group_by_ctx_free;
 
+    /** If set, the iterator prefetches the entity array and component columns
+     * of the next table while the current table is being processed. This can
+     * reduce cache misses for queries that match many tables. */
+    bool prefetch;
+
     /** If set, the query will be created as a subquery. A subquery matches at
      * most a subset of its parent query. Subqueries do not directly receive
      * (table) notifications from the world. Instead parent queries forward
@@ -4005,6 +4184,7 @@ typedef struct ecs_world_info_t {
         int64_t discard_count;         /**< commands discarded, happens when entity is no longer alive when running the command */
         int64_t batched_entity_count;  /**< entities for which commands were batched */
         int64_t batched_command_count; /**< commands batched */
+        int64_t parallel_set_count;    /**< set/get_mut commands of which the value was copied by worker threads */
     } cmd;
 
     const char *name_prefix;          /**< Value set by ecs_set_name_prefix. Used
@@ -5284,6 +5464,66 @@ void ecs_remove_id(
     ecs_entity_t entity,
     ecs_id_t id);
 
+/** Add a (component) id to multiple entities.
+ * This operation has the same result as calling ecs_add_id() for each entity,
+ * but is faster when many entities are changed at once. Consecutive entities
+ * in the array that are stored in the same table are moved to the destination
+ * table as a group, and OnAdd observers are notified once per group. If the
+ * entities of a group are all entities in the table, in table order, the table
+ * storage is moved a column at a time.
+ *
+ * @param world The world.
+ * @param entities Array with alive entities.
+ * @param count The number of entities in the array.
+ * @param id The id to add.
+ */
+FLECS_API
+void ecs_add_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id);
+
+/** Remove a (component) id from multiple entities.
+ * Same as ecs_add_id_n(), but removes the id.
+ *
+ * @param world The world.
+ * @param entities Array with alive entities.
+ * @param count The number of entities in the array.
+ * @param id The id to remove.
+ */
+FLECS_API
+void ecs_remove_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id);
+
+/** Add a (component) id to all entities returned by an iterator.
+ * The operation iterates the iterator until it yields no more results, and then
+ * adds the id to the returned entities with ecs_add_id_n(). Entities are
+ * returned in table order, so that entire tables are moved at once when the
+ * iterator matches all entities in a table.
+ *
+ * @param it The iterator.
+ * @param id The id to add.
+ */
+FLECS_API
+void ecs_add_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id);
+
+/** Remove a (component) id from all entities returned by an iterator.
+ * Same as ecs_add_id_w_iter(), but removes the id.
+ *
+ * @param it The iterator.
+ * @param id The id to remove.
+ */
+FLECS_API
+void ecs_remove_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id);
+
 /** Add override for (component) id.
  * Adding an override to an entity ensures that when the entity is instantiated
  * (by adding an IsA relationship to it) the component with the override is
@@ -7785,6 +8025,47 @@ FLECS_API
 bool ecs_worker_next(
     ecs_iter_t *it);
 
+/** Create a chunked worker iterator.
+ * Chunked worker iterators divide matched entities across resources (usually 
+ * threads) in chunks of at most 'chunk_size' entities. Instead of assigning a
+ * fixed share of each result to each resource, resources claim chunks from a
+ * counter that is shared between all iterators. A resource that finishes its
+ * chunk early claims the next unprocessed chunk, which balances work across
+ * resources when results vary a lot in size.
+ * 
+ * All resources must iterate the same results in the same order, and the 
+ * shared counter must be set to 0 before any of the resources start 
+ * iterating. Each chunk is returned by exactly one resource. Results that do
+ * not have a table (for example, results of queries that do not match $this)
+ * are a single chunk.
+ * 
+ * The iterator must be iterated with ecs_worker_chunk_next.
+ * 
+ * A chunked worker iterator acts as a passthrough for data exposed by the 
+ * parent iterator, so that any data provided by the parent will also be 
+ * provided by the chunked worker iterator.
+ * 
+ * @param it The source iterator.
+ * @param claimed Chunk counter shared between resources.
+ * @param chunk_size The maximum number of entities per chunk.
+ * @return A chunked worker iterator.
+ */
+FLECS_API
+ecs_iter_t ecs_worker_chunk_iter(
+    const ecs_iter_t *it,
+    int32_t *claimed,
+    int32_t chunk_size);
+
+/** Progress a chunked worker iterator.
+ * Progresses an iterator created by ecs_worker_chunk_iter.
+ * 
+ * @param it The iterator.
+ * @return true if iterator has more results, false if not.
+ */
+FLECS_API
+bool ecs_worker_chunk_next(
+    ecs_iter_t *it);
+
 /** Obtain data for a query field.
  * This operation retrieves a pointer to an array of data that belongs to the
  * term in the query. The index refers to the location of the term in the query,
@@ -11030,6 +11311,125 @@ FLECS_API
 bool ecs_using_task_threads(
     ecs_world_t *world);
 
+/** Set number of entities per chunk claimed by worker threads.
+ * By default multithreaded systems evenly divide the entities of each matched
+ * table between worker threads. When one thread gets a slice of a large table
+ * and other threads don't have a lot of work, threads that finish early have
+ * to wait for the slowest thread.
+ * 
+ * When a chunk size is set, tables are split up in chunks of at most 
+ * chunk_size entities, and workers claim chunks until all chunks have been
+ * processed. Threads that finish early continue with chunks that would 
+ * otherwise have been processed by slower threads.
+ * 
+ * Setting the chunk size to 0 restores the default behavior. The operation
+ * must not be called while a pipeline is running.
+ * 
+ * @param world The world.
+ * @param chunk_size The maximum number of entities per chunk.
+ */
+FLECS_API
+void ecs_set_worker_chunk_size(
+    ecs_world_t *world,
+    int32_t chunk_size);
+
+/** Get number of entities per chunk claimed by worker threads.
+ * 
+ * @param world The world.
+ * @return The chunk size, or 0 if entities are divided evenly.
+ */
+FLECS_API
+int32_t ecs_get_worker_chunk_size(
+    const ecs_world_t *world);
+
+/** Iterate a query in parallel on the worker threads of the world.
+ * The matched entities are split up in chunks of at most chunk_size entities.
+ * The main thread and the workers claim chunks until all chunks have been
+ * processed, and invoke the callback for each claimed chunk. Because chunks
+ * are claimed dynamically, threads that get small tables continue with chunks
+ * of large tables that would otherwise wait for a single thread.
+ * 
+ * If chunk_size is 0, it is derived from the size of the query fields, so that
+ * the data of a chunk fits in the L1 cache of a typical CPU.
+ * 
+ * The operation uses the threads created by ecs_set_threads. When the world
+ * uses task threads (see ecs_set_task_threads), tasks are created for the
+ * duration of the operation with the task functions of the OS API. When the
+ * world has no workers, the query is iterated on the calling thread.
+ * 
+ * The world is in readonly mode while the callback is invoked. The world field
+ * of the iterator passed to the callback is the stage of the thread, which can
+ * be used to enqueue commands. Commands are merged before the operation 
+ * returns. The ctx field of the iterator is set to the ctx parameter.
+ * 
+ * The operation must not be called while a pipeline is running or while the
+ * world is deferred.
+ * 
+ * @param world The world.
+ * @param query The query to iterate.
+ * @param callback The function to invoke for each chunk.
+ * @param ctx Context passed to the callback.
+ * @param chunk_size The maximum number of entities per chunk (0 = auto).
+ */
+FLECS_API
+void ecs_query_par_each(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_iter_action_t callback,
+    void *ctx,
+    int32_t chunk_size);
+
+#ifdef FLECS_RULES
+/** Evaluate a rule in parallel on the worker threads of the world.
+ * The main thread and the workers each evaluate the rule on their own stage,
+ * and split up the tables matched by the first term of the rule (see 
+ * ecs_rule_iter_set_partition). The callback is invoked for each result on 
+ * the thread that found it. This is useful for expensive rules, where
+ * evaluating the rule takes more time than processing the results.
+ * 
+ * Results are not returned in the same order as ecs_rule_next, and are not
+ * split up further. Rules that don't start by selecting tables for a variable
+ * source are evaluated by a single thread.
+ * 
+ * Workers and readonly mode work the same as for ecs_query_par_each. The ctx 
+ * field of the iterator is set to the ctx parameter.
+ * 
+ * @param world The world.
+ * @param rule The rule to evaluate.
+ * @param callback The function to invoke for each result.
+ * @param ctx Context passed to the callback.
+ */
+FLECS_API
+void ecs_rule_par_each(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    ecs_iter_action_t callback,
+    void *ctx);
+#endif
+
+/** Run independent systems in parallel.
+ * By default systems that are not multi threaded run on the main thread, in
+ * the order of the pipeline. When parallel systems are enabled, the pipeline
+ * groups consecutive single threaded systems that don't access the same 
+ * components (as determined by the inout annotations of their terms) and 
+ * distributes them across worker threads. Systems that write a component 
+ * that another system in the group reads or writes start a new group, which
+ * runs after the previous group has finished.
+ * 
+ * Grouping does not change when commands are merged. A sync point between two
+ * groups only waits for the workers, it does not merge commands.
+ * 
+ * Systems without terms are never grouped with other systems. The operation 
+ * must not be called while a pipeline is running.
+ * 
+ * @param world The world.
+ * @param enable Whether to run independent systems in parallel.
+ */
+FLECS_API
+void ecs_set_parallel_systems(
+    ecs_world_t *world,
+    bool enable);
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Module
 ////////////////////////////////////////////////////////////////////////////////
@@ -11492,6 +11892,8 @@ typedef struct ecs_world_stats_t {
         ecs_metric_t stack_alloc_count;    /**< Page allocations per frame */
         ecs_metric_t stack_free_count;     /**< Page frees per frame */
         ecs_metric_t stack_outstanding_alloc_count; /**< Difference between allocs & frees */
+        ecs_metric_t page_bytes;           /**< World storage mapped with OS page allocation */
+        ecs_metric_t huge_page_advised_bytes; /**< World storage for which huge pages were requested */
     } memory;
 
     /* REST statistics */
@@ -13975,6 +14377,63 @@ FLECS_API
 ecs_entity_t ecs_meta_get_entity(
     const ecs_meta_cursor_t *cursor);
 
+/** Member of a reflected type, resolved by ecs_meta_member_ref(). */
+typedef struct ecs_member_ref_t {
+    ecs_entity_t type;         /**< Type that contains the member */
+    ecs_entity_t member_type;  /**< Type of the member */
+    ecs_size_t offset;         /**< Offset of the member in the type */
+    ecs_size_t size;           /**< Size of the member */
+} ecs_member_ref_t;
+
+/** Resolve member of reflected (struct) type.
+ * The returned reference stores the offset of the member, so that it can be
+ * passed to ecs_field_member() without looking up the member again. Resolve
+ * the member once, for example when the system is created, and store it in the
+ * system context. The member name may contain dots to access members of nested
+ * structs.
+ * 
+ * @param world The world.
+ * @param type The reflected type.
+ * @param member The member name.
+ * @return The member reference, with member_type set to 0 if not found.
+ */
+FLECS_API
+ecs_member_ref_t ecs_meta_member_ref(
+    const ecs_world_t *world,
+    ecs_entity_t type,
+    const char *member);
+
+/** Get pointer to member of field.
+ * This operation returns a pointer to a member of the first element of a field
+ * with a reflected (struct) type. Components are stored as arrays of structs,
+ * so this is a strided view and not a struct-of-arrays column: member values of
+ * subsequent elements are ecs_field_size() bytes apart:
+ * 
+ * @code
+ * ecs_member_ref_t *ref = it->ctx; // from ecs_meta_member_ref(world, T, "x")
+ * float *x = ecs_field_member(it, float, 1, ref);
+ * ecs_size_t stride = ecs_field_size(it, 1);
+ * for (int i = 0; i < it->count; i ++) {
+ *     *(float*)ECS_ELEM(x, stride, i) += 1;
+ * }
+ * @endcode
+ * 
+ * @param it The iterator.
+ * @param size The size of the member type (or 0 to skip the check).
+ * @param index The field index.
+ * @param member The member, resolved with ecs_meta_member_ref().
+ * @return Pointer to the member of the first element, or NULL if not set.
+ */
+FLECS_API
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int32_t index,
+    const ecs_member_ref_t *member);
+
+#define ecs_field_member(it, T, index, member)\
+    (ECS_CAST(T*, ecs_field_member_w_size(it, sizeof(T), index, member)))
+
 /** Convert pointer of primitive kind to float. */
 FLECS_API
 double ecs_meta_ptr_to_float(
@@ -14966,6 +15425,14 @@ extern "C" {
  * Different terms with the same variable name are automatically correlated by
  * the query engine.
  * 
+ * When the EcsFilterCached flag is set, the rule stores its results and reuses
+ * them for subsequent iterations. The results are updated when tables or 
+ * entities with the ids matched by the rule change. A cached rule is more
+ * expensive to create and adds overhead to changing the matched ids, so it 
+ * should only be used for rules that are iterated frequently. When variables 
+ * are set on the iterator, or the world is in readonly mode and the cache is 
+ * out of date, the rule is evaluated without the cache.
+ * 
  * A rule needs to be explicitly deleted with ecs_rule_fini.
  * 
  * @param world The world.
@@ -15057,6 +15524,36 @@ ecs_iter_t ecs_rule_iter(
     const ecs_world_t *world,
     const ecs_rule_t *rule);
 
+/** Partition the evaluation of a rule between iterators.
+ * Iterators that share the same counter split up the tables that are matched
+ * by the first term of the rule, and each iterator evaluates the remaining
+ * terms only for the tables it claimed. Together, the iterators return the
+ * same results as a single iterator. Tables are claimed while iterating, so
+ * iterators that are slowed down by expensive tables claim fewer of them.
+ * 
+ * This makes it possible to evaluate a rule on multiple threads, for example
+ * by creating an iterator for the stage of each thread while the world is in
+ * readonly mode. See ecs_rule_par_each for an operation that does this with 
+ * the worker threads of the world.
+ * 
+ * Only rules that start by selecting tables for a variable source (like $this)
+ * can be split up. For other rules, the iterator that claims first returns all
+ * results, and the other iterators return none. For cached rules the iterators
+ * split up the cached results.
+ * 
+ * The counter must be initialized to 0 before iteration starts, and must not
+ * be reused for another iteration. The world must not be modified while the
+ * iterators are running. This operation must be called before the first call 
+ * to ecs_rule_next.
+ * 
+ * @param it The rule iterator.
+ * @param claimed The counter shared between iterators.
+ */
+FLECS_API
+void ecs_rule_iter_set_partition(
+    ecs_iter_t *it,
+    int32_t *claimed);
+
 /** Progress rule iterator.
  * 
  * @param it The iterator.
@@ -15078,6 +15575,16 @@ bool ecs_rule_next_instanced(
  * This will convert the rule program to a string which can aid in debugging
  * the behavior of a rule.
  * 
+ * Operations that match a term are followed by the number of results that the
+ * rule compiler estimated for the term (for example "~10"). Terms are ordered
+ * so that the term with the smallest estimate is evaluated first. Estimates
+ * are computed when the rule is created.
+ * 
+ * Terms with the same source variable that match on variables found by earlier
+ * terms may be evaluated with a single "join" operation. A join matches its
+ * terms once against all tables and stores the results in a hash table, which
+ * is cheaper than evaluating the terms for each result of the earlier terms.
+ * 
  * The returned string must be freed with ecs_os_free.
  * 
  * @param rule The rule.
@@ -17465,6 +17972,7 @@ using f64_t = ecs_f64_t;
 using member_t = ecs_member_t;
 using enum_constant_t = ecs_enum_constant_t;
 using bitmask_constant_t = ecs_bitmask_constant_t;
+using member_ref_t = ecs_member_ref_t;
 
 /* Components */
 using MetaType = EcsMetaType;
@@ -20740,6 +21248,21 @@ void set_task_threads(int32_t task_threads) const;
  */
 bool using_task_threads() const;
 
+/** Set number of entities per chunk claimed by worker threads.
+ * @see ecs_set_worker_chunk_size
+ */
+void set_worker_chunk_size(int32_t chunk_size) const;
+
+/** Get number of entities per chunk claimed by worker threads.
+ * @see ecs_get_worker_chunk_size
+ */
+int32_t get_worker_chunk_size() const;
+
+/** Run independent systems in parallel.
+ * @see ecs_set_parallel_systems
+ */
+void set_parallel_systems(bool enable = true) const;
+
 /** @} */
 
 #   endif
@@ -20915,6 +21438,18 @@ flecs::cursor cursor(void *ptr) {
     return cursor(tid, ptr);
 }
 
+/** Resolve member of type, for use with iter::field_member */
+flecs::member_ref_t member_ref(flecs::entity_t tid, const char *member) const {
+    return ecs_meta_member_ref(m_world, tid, member);
+}
+
+/** Resolve member of type, for use with iter::field_member */
+template <typename T>
+flecs::member_ref_t member_ref(const char *member) const {
+    flecs::entity_t tid = _::cpp_type<T>::id(m_world);
+    return member_ref(tid, member);
+}
+
 /** Create primitive type */
 flecs::entity primitive(flecs::meta::primitive_kind_t kind);
 
@@ -21202,6 +21737,47 @@ protected:
     bool m_is_shared;
 };
 
+/** Wrapper class around a member of a column.
+ * Provides access to a single member of the elements in a component array.
+ * Elements are the component size apart.
+ * 
+ * @tparam T type of the member.
+ * 
+ * \ingroup cpp_iterator
+ */
+template <typename T>
+struct member_column {
+    member_column(T* array, size_t stride, size_t count, bool is_shared = false)
+        : m_array(array)
+        , m_stride(stride)
+        , m_count(count) 
+        , m_is_shared(is_shared) {}
+
+    /** Return member of element in component array.
+     * This operator may only be used if the column is not shared.
+     * 
+     * @param index Index of element.
+     * @return Reference to member.
+     */
+    T& operator[](size_t index) const {
+        ecs_assert(index < m_count, ECS_COLUMN_INDEX_OUT_OF_RANGE, NULL);
+        ecs_assert(!index || !m_is_shared, ECS_INVALID_PARAMETER, NULL);
+        ecs_assert(m_array != nullptr, ECS_COLUMN_INDEX_OUT_OF_RANGE, NULL);
+        return *static_cast<T*>(ECS_OFFSET(m_array, m_stride * index));
+    }
+
+    /** Return number of elements. */
+    size_t count() const {
+        return m_count;
+    }
+
+protected:
+    T* m_array;
+    size_t m_stride;
+    size_t m_count;
+    bool m_is_shared;
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -21455,6 +22031,34 @@ public:
         return get_unchecked_field(index);
     }
 
+#ifdef FLECS_META
+    /** Get access to a member of field data.
+     * The member is resolved with world::member_ref, which should be done once
+     * (for example when the system is created) and not for each iteration.
+     * The returned column strides over the component array by the size of the
+     * component, as component data is not stored as struct-of-arrays.
+     * 
+     * @tparam T Type of the member.
+     * @param index The field index.
+     * @param member The member.
+     * @return The member data.
+     */
+    template <typename T, typename A = actual_type_t<T>>
+    flecs::member_column<A> field_member(
+        int32_t index, const flecs::member_ref_t& member) const 
+    {
+        ecs_assert(std::is_const<T>::value || 
+            !ecs_field_is_readonly(m_iter, index), 
+                ECS_ACCESS_VIOLATION, NULL);
+        bool is_shared = !ecs_field_is_self(m_iter, index);
+        size_t count = is_shared ? 1 : static_cast<size_t>(m_iter->count);
+        return flecs::member_column<A>(
+            static_cast<A*>(ecs_field_member_w_size(
+                m_iter, sizeof(A), index, &member)),
+            ecs_field_size(m_iter, index), count, is_shared);
+    }
+#endif
+
     /** Get readonly access to entity ids.
      *
      * @return The entity ids.
@@ -28200,6 +28804,15 @@ public:
         return *this;
     }
 
+    /** Prefetch data of the next table while iterating the current table.
+     *
+     * @param value If true, enable prefetching.
+     */
+    Base& prefetch(bool value = true) {
+        m_desc->prefetch = value;
+        return *this;
+    }
+
     /** Specify parent query (creates subquery) */
     Base& observable(const query_base& parent);
     
@@ -28398,8 +29011,36 @@ private:
         return ecs_query_next_instanced;
     }
 
+#ifdef FLECS_PIPELINE
+    template <typename Invoker>
+    static void par_each_invoke(ecs_iter_t *it) {
+        static_cast<const Invoker*>(it->ctx)->invoke(it);
+    }
+#endif
+
 public:
     using query_base::query_base;
+
+#ifdef FLECS_PIPELINE
+    /** Iterate query in parallel on the worker threads of the world.
+     * The function has the same signature as the function passed to each().
+     * Matched entities are split up in chunks that are claimed by the threads
+     * until all chunks are processed. The function may be invoked from 
+     * multiple threads at the same time.
+     * 
+     * @param func The function to invoke for each entity.
+     * @param chunk_size The maximum number of entities per chunk (0 = auto).
+     * @see ecs_query_par_each
+     */
+    template <typename Func>
+    void par_each(Func&& func, int32_t chunk_size = 0) const {
+        using Invoker = _::each_invoker<
+            typename std::decay<Func>::type, Components...>;
+        Invoker invoker(FLECS_FWD(func));
+        ecs_query_par_each(m_world, m_query, par_each_invoke<Invoker>, 
+            &invoker, chunk_size);
+    }
+#endif
 };
 
 // Mixin implementation
@@ -29313,6 +29954,18 @@ inline bool world::using_task_threads() const {
     return ecs_using_task_threads(m_world);
 }
 
+inline void world::set_worker_chunk_size(int32_t chunk_size) const {
+    ecs_set_worker_chunk_size(m_world, chunk_size);
+}
+
+inline int32_t world::get_worker_chunk_size() const {
+    return ecs_get_worker_chunk_size(m_world);
+}
+
+inline void world::set_parallel_systems(bool enable) const {
+    ecs_set_parallel_systems(m_world, enable);
+}
+
 }
 
 #endif
@@ -29626,6 +30279,15 @@ struct rule_builder final : _::rule_builder_base<Components...> {
             this->m_desc.entity = ecs_entity_init(world, &entity_desc);
         }
     }
+
+    /** Cache rule results.
+     * Results are updated when the matched ids change, instead of being
+     * evaluated each time the rule is iterated.
+     */
+    rule_builder& cached() {
+        this->m_desc.flags |= EcsFilterCached;
+        return *this;
+    }
 };
 
 }
@@ -29740,12 +30402,39 @@ private:
         return ecs_rule_next_instanced;
     }
 
+#ifdef FLECS_PIPELINE
+    template <typename Invoker>
+    static void par_each_invoke(ecs_iter_t *it) {
+        static_cast<const Invoker*>(it->ctx)->invoke(it);
+    }
+#endif
+
 public:
     using rule_base::rule_base;
 
     int32_t find_var(const char *name) {
         return ecs_rule_find_var(m_rule, name);
     }
+
+#ifdef FLECS_PIPELINE
+    /** Evaluate rule in parallel on the worker threads of the world.
+     * The function has the same signature as the function passed to each().
+     * The tables matched by the first term of the rule are split up between
+     * the threads. The function may be invoked from multiple threads at the 
+     * same time.
+     * 
+     * @param func The function to invoke for each entity.
+     * @see ecs_rule_par_each
+     */
+    template <typename Func>
+    void par_each(Func&& func) const {
+        using Invoker = _::each_invoker<
+            typename std::decay<Func>::type, Components...>;
+        Invoker invoker(FLECS_FWD(func));
+        ecs_rule_par_each(m_world, m_rule, par_each_invoke<Invoker>, 
+            &invoker);
+    }
+#endif
 };
 
 // Mixin implementation
@@ -175,6 +175,7 @@
 #ifdef FLECS_LOW_FOOTPRINT
 #define FLECS_HI_COMPONENT_ID (16)
 #define FLECS_HI_ID_RECORD_ID (16)
+#define FLECS_HI_PAIR_INDEX_ID (256)
 #define FLECS_SPARSE_PAGE_BITS (6)
 #define FLECS_ENTITY_PAGE_BITS (6)
 #define FLECS_USE_OS_ALLOC
@@ -204,6 +205,16 @@
 #define FLECS_HI_ID_RECORD_ID (1024)
 #endif
 
+/** \def FLECS_HI_PAIR_INDEX_ID
+ * This constant can be used to balance between performance and memory 
+ * utilization. Pairs for which both the relationship and target are below this
+ * value are stored in a paged lookup array. Other pairs use a regular map
+ * lookup, which is slower but more memory efficient.
+ */
+#ifndef FLECS_HI_PAIR_INDEX_ID
+#define FLECS_HI_PAIR_INDEX_ID (65536)
+#endif
+
 /** \def FLECS_SPARSE_PAGE_BITS
  * This constant is used to determine the number of bits of an id that is used
  * to determine the page index when used with a sparse set. The number of bits
@@ -225,6 +236,35 @@
  * as memory will be freed more often, at the cost of decreased performance. */
 // #define FLECS_USE_OS_ALLOC
 
+/** \def FLECS_MAP_SWISS
+ * When enabled, ecs_map_t uses open addressing instead of chained buckets. Map
+ * elements are stored in a flat array, and lookups test the hashes of a group
+ * of 16 elements at a time (with SSE2 instructions where available). This
+ * avoids an allocation per element and reduces pointer chasing on lookups, at
+ * the cost of more memory for small maps. Pointers to map values are
+ * invalidated when an element is inserted. The layout of ecs_map_t does not
+ * change with this setting, so it only has to be defined when building Flecs
+ * and code that uses the map API doesn't have to be built with it. */
+// #define FLECS_MAP_SWISS
+
+/** \def FLECS_BALLOC_LARGE_SIZE
+ * Allocations of this size or larger are not served from a block allocator
+ * block, but are allocated directly from the OS allocator. This prevents 
+ * large buffers (like the columns of big tables) from being cached by the
+ * block allocator after they're freed, and lets the OS allocator grow them in
+ * place, which avoids copying when a buffer is resized. */
+#ifndef FLECS_BALLOC_LARGE_SIZE
+#define FLECS_BALLOC_LARGE_SIZE (64 * 1024)
+#endif
+
+/** \def FLECS_BALLOC_PAGE_ALLOC_SIZE
+ * Allocations of this size or larger are mapped with the page allocation
+ * functions of the OS API when available. The builtin POSIX implementation
+ * backs these allocations with transparent huge pages where supported. */
+#ifndef FLECS_BALLOC_PAGE_ALLOC_SIZE
+#define FLECS_BALLOC_PAGE_ALLOC_SIZE (2 * 1024 * 1024)
+#endif
+
 /** \def FLECS_ID_DESC_MAX
  * Maximum number of ids to add ecs_entity_desc_t / ecs_bulk_desc_t */
 #ifndef FLECS_ID_DESC_MAX
@@ -1039,6 +1079,11 @@ typedef struct ecs_query_desc_t {
     /** Function to free group_by_ctx */
     ecs_ctx_free_t group_by_ctx_free;
 
+    /** If set, the iterator prefetches the entity array and component columns
+     * of the next table while the current table is being processed. This can
+     * reduce cache misses for queries that match many tables. */
+    bool prefetch;
+
     /** If set, the query will be created as a subquery. A subquery matches at
      * most a subset of its parent query. Subqueries do not directly receive
      * (table) notifications from the world. Instead parent queries forward
@@ -1225,6 +1270,7 @@ typedef struct ecs_world_info_t {
         int64_t discard_count;         /**< commands discarded, happens when entity is no longer alive when running the command */
         int64_t batched_entity_count;  /**< entities for which commands were batched */
         int64_t batched_command_count; /**< commands batched */
+        int64_t parallel_set_count;    /**< set/get_mut commands of which the value was copied by worker threads */
     } cmd;
 
     const char *name_prefix;          /**< Value set by ecs_set_name_prefix. Used
@@ -2483,6 +2529,66 @@ void ecs_remove_id(
     ecs_entity_t entity,
     ecs_id_t id);
 
+/** Add a (component) id to multiple entities.
+ * This operation has the same result as calling ecs_add_id() for each entity,
+ * but is faster when many entities are changed at once. Consecutive entities
+ * in the array that are stored in the same table are moved to the destination
+ * table as a group, and OnAdd observers are notified once per group. If the
+ * entities of a group are all entities in the table, in table order, the table
+ * storage is moved a column at a time.
+ *
+ * @param world The world.
+ * @param entities Array with alive entities.
+ * @param count The number of entities in the array.
+ * @param id The id to add.
+ */
+FLECS_API
+void ecs_add_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id);
+
+/** Remove a (component) id from multiple entities.
+ * Same as ecs_add_id_n(), but removes the id.
+ *
+ * @param world The world.
+ * @param entities Array with alive entities.
+ * @param count The number of entities in the array.
+ * @param id The id to remove.
+ */
+FLECS_API
+void ecs_remove_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id);
+
+/** Add a (component) id to all entities returned by an iterator.
+ * The operation iterates the iterator until it yields no more results, and then
+ * adds the id to the returned entities with ecs_add_id_n(). Entities are
+ * returned in table order, so that entire tables are moved at once when the
+ * iterator matches all entities in a table.
+ *
+ * @param it The iterator.
+ * @param id The id to add.
+ */
+FLECS_API
+void ecs_add_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id);
+
+/** Remove a (component) id from all entities returned by an iterator.
+ * Same as ecs_add_id_w_iter(), but removes the id.
+ *
+ * @param it The iterator.
+ * @param id The id to remove.
+ */
+FLECS_API
+void ecs_remove_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id);
+
 /** Add override for (component) id.
  * Adding an override to an entity ensures that when the entity is instantiated
  * (by adding an IsA relationship to it) the component with the override is
@@ -4984,6 +5090,47 @@ FLECS_API
 bool ecs_worker_next(
     ecs_iter_t *it);
 
+/** Create a chunked worker iterator.
+ * Chunked worker iterators divide matched entities across resources (usually 
+ * threads) in chunks of at most 'chunk_size' entities. Instead of assigning a
+ * fixed share of each result to each resource, resources claim chunks from a
+ * counter that is shared between all iterators. A resource that finishes its
+ * chunk early claims the next unprocessed chunk, which balances work across
+ * resources when results vary a lot in size.
+ * 
+ * All resources must iterate the same results in the same order, and the 
+ * shared counter must be set to 0 before any of the resources start 
+ * iterating. Each chunk is returned by exactly one resource. Results that do
+ * not have a table (for example, results of queries that do not match $this)
+ * are a single chunk.
+ * 
+ * The iterator must be iterated with ecs_worker_chunk_next.
+ * 
+ * A chunked worker iterator acts as a passthrough for data exposed by the 
+ * parent iterator, so that any data provided by the parent will also be 
+ * provided by the chunked worker iterator.
+ * 
+ * @param it The source iterator.
+ * @param claimed Chunk counter shared between resources.
+ * @param chunk_size The maximum number of entities per chunk.
+ * @return A chunked worker iterator.
+ */
+FLECS_API
+ecs_iter_t ecs_worker_chunk_iter(
+    const ecs_iter_t *it,
+    int32_t *claimed,
+    int32_t chunk_size);
+
+/** Progress a chunked worker iterator.
+ * Progresses an iterator created by ecs_worker_chunk_iter.
+ * 
+ * @param it The iterator.
+ * @return true if iterator has more results, false if not.
+ */
+FLECS_API
+bool ecs_worker_chunk_next(
+    ecs_iter_t *it);
+
 /** Obtain data for a query field.
  * This operation retrieves a pointer to an array of data that belongs to the
  * term in the query. The index refers to the location of the term in the query,
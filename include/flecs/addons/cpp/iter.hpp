@@ -116,6 +116,47 @@ protected:
     bool m_is_shared;
 };
 
+/** Wrapper class around a member of a column.
+ * Provides access to a single member of the elements in a component array.
+ * Elements are the component size apart.
+ * 
+ * @tparam T type of the member.
+ * 
+ * \ingroup cpp_iterator
+ */
+template <typename T>
+struct member_column {
+    member_column(T* array, size_t stride, size_t count, bool is_shared = false)
+        : m_array(array)
+        , m_stride(stride)
+        , m_count(count) 
+        , m_is_shared(is_shared) {}
+
+    /** Return member of element in component array.
+     * This operator may only be used if the column is not shared.
+     * 
+     * @param index Index of element.
+     * @return Reference to member.
+     */
+    T& operator[](size_t index) const {
+        ecs_assert(index < m_count, ECS_COLUMN_INDEX_OUT_OF_RANGE, NULL);
+        ecs_assert(!index || !m_is_shared, ECS_INVALID_PARAMETER, NULL);
+        ecs_assert(m_array != nullptr, ECS_COLUMN_INDEX_OUT_OF_RANGE, NULL);
+        return *static_cast<T*>(ECS_OFFSET(m_array, m_stride * index));
+    }
+
+    /** Return number of elements. */
+    size_t count() const {
+        return m_count;
+    }
+
+protected:
+    T* m_array;
+    size_t m_stride;
+    size_t m_count;
+    bool m_is_shared;
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -369,6 +410,34 @@ public:
         return get_unchecked_field(index);
     }
 
+#ifdef FLECS_META
+    /** Get access to a member of field data.
+     * The member is resolved with world::member_ref, which should be done once
+     * (for example when the system is created) and not for each iteration.
+     * The returned column strides over the component array by the size of the
+     * component, as component data is not stored as struct-of-arrays.
+     * 
+     * @tparam T Type of the member.
+     * @param index The field index.
+     * @param member The member.
+     * @return The member data.
+     */
+    template <typename T, typename A = actual_type_t<T>>
+    flecs::member_column<A> field_member(
+        int32_t index, const flecs::member_ref_t& member) const 
+    {
+        ecs_assert(std::is_const<T>::value || 
+            !ecs_field_is_readonly(m_iter, index), 
+                ECS_ACCESS_VIOLATION, NULL);
+        bool is_shared = !ecs_field_is_self(m_iter, index);
+        size_t count = is_shared ? 1 : static_cast<size_t>(m_iter->count);
+        return flecs::member_column<A>(
+            static_cast<A*>(ecs_field_member_w_size(
+                m_iter, sizeof(A), index, &member)),
+            ecs_field_size(m_iter, index), count, is_shared);
+    }
+#endif
+
     /** Get readonly access to entity ids.
      *
      * @return The entity ids.
@@ -35,6 +35,7 @@ using f64_t = ecs_f64_t;
 using member_t = ecs_member_t;
 using enum_constant_t = ecs_enum_constant_t;
 using bitmask_constant_t = ecs_bitmask_constant_t;
+using member_ref_t = ecs_member_ref_t;
 
 /* Components */
 using MetaType = EcsMetaType;
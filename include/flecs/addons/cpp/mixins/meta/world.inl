@@ -35,6 +35,18 @@ flecs::cursor cursor(void *ptr) {
     return cursor(tid, ptr);
 }
 
+/** Resolve member of type, for use with iter::field_member */
+flecs::member_ref_t member_ref(flecs::entity_t tid, const char *member) const {
+    return ecs_meta_member_ref(m_world, tid, member);
+}
+
+/** Resolve member of type, for use with iter::field_member */
+template <typename T>
+flecs::member_ref_t member_ref(const char *member) const {
+    flecs::entity_t tid = _::cpp_type<T>::id(m_world);
+    return member_ref(tid, member);
+}
+
 /** Create primitive type */
 flecs::entity primitive(flecs::meta::primitive_kind_t kind);
 
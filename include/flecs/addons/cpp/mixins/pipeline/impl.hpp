@@ -89,4 +89,16 @@ inline bool world::using_task_threads() const {
     return ecs_using_task_threads(m_world);
 }
 
+inline void world::set_worker_chunk_size(int32_t chunk_size) const {
+    ecs_set_worker_chunk_size(m_world, chunk_size);
+}
+
+inline int32_t world::get_worker_chunk_size() const {
+    return ecs_get_worker_chunk_size(m_world);
+}
+
+inline void world::set_parallel_systems(bool enable) const {
+    ecs_set_parallel_systems(m_world, enable);
+}
+
 }
@@ -90,4 +90,19 @@ void set_task_threads(int32_t task_threads) const;
  */
 bool using_task_threads() const;
 
+/** Set number of entities per chunk claimed by worker threads.
+ * @see ecs_set_worker_chunk_size
+ */
+void set_worker_chunk_size(int32_t chunk_size) const;
+
+/** Get number of entities per chunk claimed by worker threads.
+ * @see ecs_get_worker_chunk_size
+ */
+int32_t get_worker_chunk_size() const;
+
+/** Run independent systems in parallel.
+ * @see ecs_set_parallel_systems
+ */
+void set_parallel_systems(bool enable = true) const;
+
 /** @} */
@@ -142,6 +142,15 @@ public:
         return *this;
     }
 
+    /** Prefetch data of the next table while iterating the current table.
+     *
+     * @param value If true, enable prefetching.
+     */
+    Base& prefetch(bool value = true) {
+        m_desc->prefetch = value;
+        return *this;
+    }
+
     /** Specify parent query (creates subquery) */
     Base& observable(const query_base& parent);
     
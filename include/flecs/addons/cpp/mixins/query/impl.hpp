@@ -157,8 +157,36 @@ private:
         return ecs_query_next_instanced;
     }
 
+#ifdef FLECS_PIPELINE
+    template <typename Invoker>
+    static void par_each_invoke(ecs_iter_t *it) {
+        static_cast<const Invoker*>(it->ctx)->invoke(it);
+    }
+#endif
+
 public:
     using query_base::query_base;
+
+#ifdef FLECS_PIPELINE
+    /** Iterate query in parallel on the worker threads of the world.
+     * The function has the same signature as the function passed to each().
+     * Matched entities are split up in chunks that are claimed by the threads
+     * until all chunks are processed. The function may be invoked from 
+     * multiple threads at the same time.
+     * 
+     * @param func The function to invoke for each entity.
+     * @param chunk_size The maximum number of entities per chunk (0 = auto).
+     * @see ecs_query_par_each
+     */
+    template <typename Func>
+    void par_each(Func&& func, int32_t chunk_size = 0) const {
+        using Invoker = _::each_invoker<
+            typename std::decay<Func>::type, Components...>;
+        Invoker invoker(FLECS_FWD(func));
+        ecs_query_par_each(m_world, m_query, par_each_invoke<Invoker>, 
+            &invoker, chunk_size);
+    }
+#endif
 };
 
 // Mixin implementation
@@ -33,6 +33,15 @@ struct rule_builder final : _::rule_builder_base<Components...> {
             this->m_desc.entity = ecs_entity_init(world, &entity_desc);
         }
     }
+
+    /** Cache rule results.
+     * Results are updated when the matched ids change, instead of being
+     * evaluated each time the rule is iterated.
+     */
+    rule_builder& cached() {
+        this->m_desc.flags |= EcsFilterCached;
+        return *this;
+    }
 };
 
 }
@@ -116,12 +116,39 @@ private:
         return ecs_rule_next_instanced;
     }
 
+#ifdef FLECS_PIPELINE
+    template <typename Invoker>
+    static void par_each_invoke(ecs_iter_t *it) {
+        static_cast<const Invoker*>(it->ctx)->invoke(it);
+    }
+#endif
+
 public:
     using rule_base::rule_base;
 
     int32_t find_var(const char *name) {
         return ecs_rule_find_var(m_rule, name);
     }
+
+#ifdef FLECS_PIPELINE
+    /** Evaluate rule in parallel on the worker threads of the world.
+     * The function has the same signature as the function passed to each().
+     * The tables matched by the first term of the rule are split up between
+     * the threads. The function may be invoked from multiple threads at the 
+     * same time.
+     * 
+     * @param func The function to invoke for each entity.
+     * @see ecs_rule_par_each
+     */
+    template <typename Func>
+    void par_each(Func&& func) const {
+        using Invoker = _::each_invoker<
+            typename std::decay<Func>::type, Components...>;
+        Invoker invoker(FLECS_FWD(func));
+        ecs_rule_par_each(m_world, m_rule, par_each_invoke<Invoker>, 
+            &invoker);
+    }
+#endif
 };
 
 // Mixin implementation
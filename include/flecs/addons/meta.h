@@ -712,6 +712,63 @@ FLECS_API
 ecs_entity_t ecs_meta_get_entity(
     const ecs_meta_cursor_t *cursor);
 
+/** Member of a reflected type, resolved by ecs_meta_member_ref(). */
+typedef struct ecs_member_ref_t {
+    ecs_entity_t type;         /**< Type that contains the member */
+    ecs_entity_t member_type;  /**< Type of the member */
+    ecs_size_t offset;         /**< Offset of the member in the type */
+    ecs_size_t size;           /**< Size of the member */
+} ecs_member_ref_t;
+
+/** Resolve member of reflected (struct) type.
+ * The returned reference stores the offset of the member, so that it can be
+ * passed to ecs_field_member() without looking up the member again. Resolve
+ * the member once, for example when the system is created, and store it in the
+ * system context. The member name may contain dots to access members of nested
+ * structs.
+ * 
+ * @param world The world.
+ * @param type The reflected type.
+ * @param member The member name.
+ * @return The member reference, with member_type set to 0 if not found.
+ */
+FLECS_API
+ecs_member_ref_t ecs_meta_member_ref(
+    const ecs_world_t *world,
+    ecs_entity_t type,
+    const char *member);
+
+/** Get pointer to member of field.
+ * This operation returns a pointer to a member of the first element of a field
+ * with a reflected (struct) type. Components are stored as arrays of structs,
+ * so this is a strided view and not a struct-of-arrays column: member values of
+ * subsequent elements are ecs_field_size() bytes apart:
+ * 
+ * @code
+ * ecs_member_ref_t *ref = it->ctx; // from ecs_meta_member_ref(world, T, "x")
+ * float *x = ecs_field_member(it, float, 1, ref);
+ * ecs_size_t stride = ecs_field_size(it, 1);
+ * for (int i = 0; i < it->count; i ++) {
+ *     *(float*)ECS_ELEM(x, stride, i) += 1;
+ * }
+ * @endcode
+ * 
+ * @param it The iterator.
+ * @param size The size of the member type (or 0 to skip the check).
+ * @param index The field index.
+ * @param member The member, resolved with ecs_meta_member_ref().
+ * @return Pointer to the member of the first element, or NULL if not set.
+ */
+FLECS_API
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int32_t index,
+    const ecs_member_ref_t *member);
+
+#define ecs_field_member(it, T, index, member)\
+    (ECS_CAST(T*, ecs_field_member_w_size(it, sizeof(T), index, member)))
+
 /** Convert pointer of primitive kind to float. */
 FLECS_API
 double ecs_meta_ptr_to_float(
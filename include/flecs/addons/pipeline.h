@@ -209,6 +209,125 @@ FLECS_API
 bool ecs_using_task_threads(
     ecs_world_t *world);
 
+/** Set number of entities per chunk claimed by worker threads.
+ * By default multithreaded systems evenly divide the entities of each matched
+ * table between worker threads. When one thread gets a slice of a large table
+ * and other threads don't have a lot of work, threads that finish early have
+ * to wait for the slowest thread.
+ * 
+ * When a chunk size is set, tables are split up in chunks of at most 
+ * chunk_size entities, and workers claim chunks until all chunks have been
+ * processed. Threads that finish early continue with chunks that would 
+ * otherwise have been processed by slower threads.
+ * 
+ * Setting the chunk size to 0 restores the default behavior. The operation
+ * must not be called while a pipeline is running.
+ * 
+ * @param world The world.
+ * @param chunk_size The maximum number of entities per chunk.
+ */
+FLECS_API
+void ecs_set_worker_chunk_size(
+    ecs_world_t *world,
+    int32_t chunk_size);
+
+/** Get number of entities per chunk claimed by worker threads.
+ * 
+ * @param world The world.
+ * @return The chunk size, or 0 if entities are divided evenly.
+ */
+FLECS_API
+int32_t ecs_get_worker_chunk_size(
+    const ecs_world_t *world);
+
+/** Iterate a query in parallel on the worker threads of the world.
+ * The matched entities are split up in chunks of at most chunk_size entities.
+ * The main thread and the workers claim chunks until all chunks have been
+ * processed, and invoke the callback for each claimed chunk. Because chunks
+ * are claimed dynamically, threads that get small tables continue with chunks
+ * of large tables that would otherwise wait for a single thread.
+ * 
+ * If chunk_size is 0, it is derived from the size of the query fields, so that
+ * the data of a chunk fits in the L1 cache of a typical CPU.
+ * 
+ * The operation uses the threads created by ecs_set_threads. When the world
+ * uses task threads (see ecs_set_task_threads), tasks are created for the
+ * duration of the operation with the task functions of the OS API. When the
+ * world has no workers, the query is iterated on the calling thread.
+ * 
+ * The world is in readonly mode while the callback is invoked. The world field
+ * of the iterator passed to the callback is the stage of the thread, which can
+ * be used to enqueue commands. Commands are merged before the operation 
+ * returns. The ctx field of the iterator is set to the ctx parameter.
+ * 
+ * The operation must not be called while a pipeline is running or while the
+ * world is deferred.
+ * 
+ * @param world The world.
+ * @param query The query to iterate.
+ * @param callback The function to invoke for each chunk.
+ * @param ctx Context passed to the callback.
+ * @param chunk_size The maximum number of entities per chunk (0 = auto).
+ */
+FLECS_API
+void ecs_query_par_each(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_iter_action_t callback,
+    void *ctx,
+    int32_t chunk_size);
+
+#ifdef FLECS_RULES
+/** Evaluate a rule in parallel on the worker threads of the world.
+ * The main thread and the workers each evaluate the rule on their own stage,
+ * and split up the tables matched by the first term of the rule (see 
+ * ecs_rule_iter_set_partition). The callback is invoked for each result on 
+ * the thread that found it. This is useful for expensive rules, where
+ * evaluating the rule takes more time than processing the results.
+ * 
+ * Results are not returned in the same order as ecs_rule_next, and are not
+ * split up further. Rules that don't start by selecting tables for a variable
+ * source are evaluated by a single thread.
+ * 
+ * Workers and readonly mode work the same as for ecs_query_par_each. The ctx 
+ * field of the iterator is set to the ctx parameter.
+ * 
+ * @param world The world.
+ * @param rule The rule to evaluate.
+ * @param callback The function to invoke for each result.
+ * @param ctx Context passed to the callback.
+ */
+FLECS_API
+void ecs_rule_par_each(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    ecs_iter_action_t callback,
+    void *ctx);
+#endif
+
+/** Run independent systems in parallel.
+ * By default systems that are not multi threaded run on the main thread, in
+ * the order of the pipeline. When parallel systems are enabled, the pipeline
+ * groups consecutive single threaded systems that don't access the same 
+ * components (as determined by the inout annotations of their terms) and 
+ * distributes them across worker threads. Systems that write a component 
+ * that another system in the group reads or writes start a new group, which
+ * runs after the previous group has finished.
+ * 
+ * Grouping does not change when commands are merged. A sync point between two
+ * groups only waits for the workers, it does not merge commands.
+ * 
+ * Systems without terms are never grouped with other systems. The operation 
+ * must not be called while a pipeline is running.
+ * 
+ * @param world The world.
+ * @param enable Whether to run independent systems in parallel.
+ */
+FLECS_API
+void ecs_set_parallel_systems(
+    ecs_world_t *world,
+    bool enable);
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Module
 ////////////////////////////////////////////////////////////////////////////////
@@ -71,6 +71,14 @@ extern "C" {
  * Different terms with the same variable name are automatically correlated by
  * the query engine.
  * 
+ * When the EcsFilterCached flag is set, the rule stores its results and reuses
+ * them for subsequent iterations. The results are updated when tables or 
+ * entities with the ids matched by the rule change. A cached rule is more
+ * expensive to create and adds overhead to changing the matched ids, so it 
+ * should only be used for rules that are iterated frequently. When variables 
+ * are set on the iterator, or the world is in readonly mode and the cache is 
+ * out of date, the rule is evaluated without the cache.
+ * 
  * A rule needs to be explicitly deleted with ecs_rule_fini.
  * 
  * @param world The world.
@@ -162,6 +170,36 @@ ecs_iter_t ecs_rule_iter(
     const ecs_world_t *world,
     const ecs_rule_t *rule);
 
+/** Partition the evaluation of a rule between iterators.
+ * Iterators that share the same counter split up the tables that are matched
+ * by the first term of the rule, and each iterator evaluates the remaining
+ * terms only for the tables it claimed. Together, the iterators return the
+ * same results as a single iterator. Tables are claimed while iterating, so
+ * iterators that are slowed down by expensive tables claim fewer of them.
+ * 
+ * This makes it possible to evaluate a rule on multiple threads, for example
+ * by creating an iterator for the stage of each thread while the world is in
+ * readonly mode. See ecs_rule_par_each for an operation that does this with 
+ * the worker threads of the world.
+ * 
+ * Only rules that start by selecting tables for a variable source (like $this)
+ * can be split up. For other rules, the iterator that claims first returns all
+ * results, and the other iterators return none. For cached rules the iterators
+ * split up the cached results.
+ * 
+ * The counter must be initialized to 0 before iteration starts, and must not
+ * be reused for another iteration. The world must not be modified while the
+ * iterators are running. This operation must be called before the first call 
+ * to ecs_rule_next.
+ * 
+ * @param it The rule iterator.
+ * @param claimed The counter shared between iterators.
+ */
+FLECS_API
+void ecs_rule_iter_set_partition(
+    ecs_iter_t *it,
+    int32_t *claimed);
+
 /** Progress rule iterator.
  * 
  * @param it The iterator.
@@ -183,6 +221,16 @@ bool ecs_rule_next_instanced(
  * This will convert the rule program to a string which can aid in debugging
  * the behavior of a rule.
  * 
+ * Operations that match a term are followed by the number of results that the
+ * rule compiler estimated for the term (for example "~10"). Terms are ordered
+ * so that the term with the smallest estimate is evaluated first. Estimates
+ * are computed when the rule is created.
+ * 
+ * Terms with the same source variable that match on variables found by earlier
+ * terms may be evaluated with a single "join" operation. A join matches its
+ * terms once against all tables and stores the results in a hash table, which
+ * is cheaper than evaluating the terms for each result of the earlier terms.
+ * 
  * The returned string must be freed with ecs_os_free.
  * 
  * @param rule The rule.
@@ -137,6 +137,8 @@ typedef struct ecs_world_stats_t {
         ecs_metric_t stack_alloc_count;    /**< Page allocations per frame */
         ecs_metric_t stack_free_count;     /**< Page frees per frame */
         ecs_metric_t stack_outstanding_alloc_count; /**< Difference between allocs & frees */
+        ecs_metric_t page_bytes;           /**< World storage mapped with OS page allocation */
+        ecs_metric_t huge_page_advised_bytes; /**< World storage for which huge pages were requested */
     } memory;
 
     /* REST statistics */
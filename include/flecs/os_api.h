@@ -90,6 +90,24 @@ typedef
 char* (*ecs_os_api_strdup_t)(
     const char *str);
 
+/* Page allocation */
+typedef
+void* (*ecs_os_api_page_alloc_t)(
+    ecs_size_t size,    /* Size of allocation */
+    bool *huge);        /* Set to true if huge pages were requested for memory */
+
+typedef
+void* (*ecs_os_api_page_realloc_t)(
+    void *ptr,          /* Memory returned by page_alloc_/page_realloc_ */
+    ecs_size_t old_size, /* Size of existing allocation */
+    ecs_size_t size,    /* New size of allocation */
+    bool *huge);        /* Set to true if huge pages were requested for memory */
+
+typedef
+void (*ecs_os_api_page_free_t)(
+    void *ptr,          /* Memory returned by page_alloc_/page_realloc_ */
+    ecs_size_t size);   /* Size of allocation */
+
 /* Threads */
 typedef
 void* (*ecs_os_thread_callback_t)(
@@ -126,6 +144,12 @@ typedef
 int64_t (*ecs_os_api_lainc_t)(
     int64_t *value);
 
+/* Atomic add, returns the new value */
+typedef
+int32_t (*ecs_os_api_aadd_t)(
+    int32_t *value,
+    int32_t add);
+
 /* Mutex */
 typedef
 ecs_os_mutex_t (*ecs_os_api_mutex_new_t)(
@@ -165,6 +189,16 @@ void (*ecs_os_api_cond_wait_t)(
     ecs_os_cond_t cond,
     ecs_os_mutex_t mutex);
 
+/* Futex-style wait / wake */
+typedef
+void (*ecs_os_api_futex_wait_t)(
+    int32_t *value,     /* Value to wait on */
+    int32_t expected);  /* Return when value no longer equals expected */
+
+typedef
+void (*ecs_os_api_futex_wake_t)(
+    int32_t *value);    /* Wake all threads waiting on value */
+
 typedef 
 void (*ecs_os_api_sleep_t)(
     int32_t sec,
@@ -300,6 +334,24 @@ typedef struct ecs_os_api_t {
 
     /* OS API flags */
     ecs_flags32_t flags_;
+
+    /* Futex-style wait / wake (optional). When provided, worker threads use 
+     * atomic counters to synchronize instead of mutex / condition variables.
+     * futex_wait_ must not return before the value has changed, and must 
+     * ensure that writes made before the change are visible to the caller. */
+    ecs_os_api_futex_wait_t futex_wait_;
+    ecs_os_api_futex_wake_t futex_wake_;
+
+    /* Page allocation (optional). When provided, buffers larger than
+     * FLECS_BALLOC_PAGE_ALLOC_SIZE (like the columns of big tables) are mapped 
+     * directly from the OS, which lets an implementation back them with huge
+     * pages to reduce TLB misses. Returned memory must be page aligned. */
+    ecs_os_api_page_alloc_t page_alloc_;
+    ecs_os_api_page_realloc_t page_realloc_;
+    ecs_os_api_page_free_t page_free_;
+
+    /* Atomic add (optional) */
+    ecs_os_api_aadd_t aadd_;
 } ecs_os_api_t;
 
 FLECS_API
@@ -334,6 +386,10 @@ void ecs_os_set_api_defaults(void);
 #ifndef ecs_os_calloc
 #define ecs_os_calloc(size) ecs_os_api.calloc_(size)
 #endif
+#define ecs_os_page_alloc(size, huge) ecs_os_api.page_alloc_(size, huge)
+#define ecs_os_page_realloc(ptr, old_size, size, huge)\
+    ecs_os_api.page_realloc_(ptr, old_size, size, huge)
+#define ecs_os_page_free(ptr, size) ecs_os_api.page_free_(ptr, size)
 #if defined(ECS_TARGET_WINDOWS)
 #define ecs_os_alloca(size) _alloca((size_t)(size))
 #else
@@ -429,6 +485,7 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_adec(value) ecs_os_api.adec_(value)
 #define ecs_os_lainc(value) ecs_os_api.lainc_(value)
 #define ecs_os_ladec(value) ecs_os_api.ladec_(value)
+#define ecs_os_aadd(value, add) ecs_os_api.aadd_(value, add)
 
 /* Mutex */
 #define ecs_os_mutex_new() ecs_os_api.mutex_new_()
@@ -443,6 +500,10 @@ void ecs_os_set_api_defaults(void);
 #define ecs_os_cond_broadcast(cond) ecs_os_api.cond_broadcast_(cond)
 #define ecs_os_cond_wait(cond, mutex) ecs_os_api.cond_wait_(cond, mutex)
 
+/* Futex */
+#define ecs_os_futex_wait(value, expected) ecs_os_api.futex_wait_(value, expected)
+#define ecs_os_futex_wake(value) ecs_os_api.futex_wake_(value)
+
 /* Time */
 #define ecs_os_sleep(sec, nanosec) ecs_os_api.sleep_(sec, nanosec)
 #define ecs_os_now() ecs_os_api.now_()
@@ -534,6 +595,10 @@ void* ecs_os_memdup(
 FLECS_API
 bool ecs_os_has_heap(void);
 
+/** Are page allocation functions available? */
+FLECS_API
+bool ecs_os_has_page_alloc(void);
+
 /** Are threading functions available? */
 FLECS_API
 bool ecs_os_has_threading(void);
@@ -542,6 +607,10 @@ bool ecs_os_has_threading(void);
 FLECS_API
 bool ecs_os_has_task_support(void);
 
+/** Are futex functions available? */
+FLECS_API
+bool ecs_os_has_futex(void);
+
 /** Are time functions available? */
 FLECS_API
 bool ecs_os_has_time(void);
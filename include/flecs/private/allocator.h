@@ -16,6 +16,7 @@ FLECS_DBG_API extern int64_t ecs_stack_allocator_free_count;
 struct ecs_allocator_t {
     ecs_block_allocator_t chunks;
     struct ecs_sparse_t sizes; /* <size, block_allocator_t> */
+    ecs_block_allocator_depot_t *depot; /* Optional depot for block allocators */
 };
 
 FLECS_API
@@ -31,6 +32,14 @@ ecs_block_allocator_t* flecs_allocator_get(
     ecs_allocator_t *a, 
     ecs_size_t size);
 
+/* Returns the number of bytes allocated with page allocation functions. If huge
+ * is true, only bytes for which huge pages were requested are counted. Whether
+ * the OS actually backs them with huge pages is not known. */
+FLECS_API
+int64_t flecs_allocator_page_bytes(
+    ecs_allocator_t *a,
+    bool huge);
+
 FLECS_API
 char* flecs_strdup(
     ecs_allocator_t *a, 
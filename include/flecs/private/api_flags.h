@@ -133,6 +133,7 @@ extern "C" {
 #define EcsFilterUnresolvedByName      (1u << 11u) /* Use by-name matching for unresolved entity identifiers */
 #define EcsFilterHasPred               (1u << 12u) /* Filter has equality predicates */
 #define EcsFilterHasScopes             (1u << 13u) /* Filter has query scopes */
+#define EcsFilterCached                (1u << 14u) /* Cache rule results (rules only) */
 
 ////////////////////////////////////////////////////////////////////////////////
 //// Table flags (used by ecs_table_t::flags)
@@ -186,6 +187,8 @@ extern "C" {
 #define EcsQueryHasNonThisOutTerms     (1u << 5u)  /* Does query have non-this out terms */
 #define EcsQueryHasMonitor             (1u << 6u)  /* Does query track changes */
 #define EcsQueryTrivialIter            (1u << 7u)  /* Does the query require special features to iterate */
+#define EcsQueryPrefetch               (1u << 8u)  /* Prefetch data of next table during iteration */
+#define EcsQueryCompiledIter           (1u << 9u)  /* Can owned matches iterate with compiled plan */
 
 
 ////////////////////////////////////////////////////////////////////////////////
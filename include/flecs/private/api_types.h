@@ -115,6 +115,15 @@ typedef struct ecs_worker_iter_t {
     int32_t count;
 } ecs_worker_iter_t;
 
+/* Chunked worker-iterator specific data */
+typedef struct ecs_worker_chunk_iter_t {
+    int32_t *claimed;     /* Chunk counter shared between workers */
+    int32_t chunk_size;   /* Max number of rows per chunk */
+    int32_t first_chunk;  /* Index of first chunk of current result */
+    int32_t chunk_count;  /* Number of chunks in current result */
+    void **ptrs;          /* Field pointers of claimed chunk */
+} ecs_worker_chunk_iter_t;
+
 /* Convenience struct to iterate table array for id */
 typedef struct ecs_table_cache_iter_t {
     struct ecs_table_cache_hdr_t *cur, *next;
@@ -197,6 +206,15 @@ typedef struct ecs_rule_iter_t {
     ecs_rule_op_profile_t *profile;
 #endif
 
+    const struct ecs_rule_cache_t *cache; /* Results of cached rule */
+    int32_t cache_cur;                   /* Current cached result */
+    bool yield_table;                    /* Does result contain entire table */
+
+    int32_t *claimed;                    /* Counter shared by partitioned iterators */
+    int32_t claim;                       /* Last index claimed by iterator */
+    int32_t part_index;                  /* Index of table in partitioned op */
+    int16_t part_op;                     /* Partitioned operation */
+
     bool redo;
     int16_t op;
     int16_t sp;
@@ -231,6 +249,7 @@ typedef struct ecs_iter_private_t {
         ecs_snapshot_iter_t snapshot;
         ecs_page_iter_t page;
         ecs_worker_iter_t worker;
+        ecs_worker_chunk_iter_t worker_chunk;
     } iter;                       /* Iterator specific data */
 
     void *entity_iter;            /* Filter applied after matching a table */
@@ -8,6 +8,14 @@
 
 #include "api_defines.h"
 
+/** Max alignment of chunks. Chunks are aligned to the largest power of two 
+ * that divides the chunk size, up to this value. */
+#define FLECS_BALLOC_MAX_ALIGN (64)
+
+/** Depot through which block allocators used by different threads can share 
+ * free chunks. */
+typedef struct ecs_block_allocator_depot_t ecs_block_allocator_depot_t;
+
 typedef struct ecs_block_allocator_block_t {
     void *memory;
     struct ecs_block_allocator_block_t *next;
@@ -26,6 +34,10 @@ typedef struct ecs_block_allocator_t {
     int32_t chunks_per_block;
     int32_t block_size;
     int32_t alloc_count;
+    int32_t page_count;             /* Chunks allocated with page functions */
+    int32_t huge_page_advised_count; /* Chunks for which huge pages were requested */
+    int32_t free_count;             /* Number of chunks in free list */
+    ecs_block_allocator_depot_t *depot; /* Depot to share free chunks with */
 } ecs_block_allocator_t;
 
 FLECS_API
@@ -55,6 +67,25 @@ FLECS_API
 void flecs_ballocator_free(
     ecs_block_allocator_t *ba);
 
+/** Create depot. Block allocators that have a depot return surplus free chunks
+ * to the depot, and take chunks from the depot before allocating new blocks. 
+ * When a block allocator with a depot is finalized, its blocks are moved to
+ * the depot, as chunks may be in use by other allocators. The depot must be 
+ * freed after all of its allocators are finalized. */
+FLECS_API
+ecs_block_allocator_depot_t* flecs_ballocator_depot_new(void);
+
+FLECS_API
+void flecs_ballocator_depot_free(
+    ecs_block_allocator_depot_t *depot);
+
+/** Free blocks of finalized allocators of which all chunks have been returned
+ * to the depot. Blocks with chunks that are still in use by other allocators
+ * are kept. */
+FLECS_API
+void flecs_ballocator_depot_trim(
+    ecs_block_allocator_depot_t *depot);
+
 FLECS_API
 void* flecs_balloc(
     ecs_block_allocator_t *allocator);
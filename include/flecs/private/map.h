@@ -27,6 +27,9 @@ typedef struct ecs_bucket_t {
     ecs_bucket_entry_t *first;
 } ecs_bucket_t;
 
+/* The map has the same layout with and without FLECS_MAP_SWISS, so that
+ * applications don't need to be compiled with the same setting as Flecs. With
+ * FLECS_MAP_SWISS, buckets points to the storage of the open addressing map. */
 typedef struct ecs_map_t {
     uint8_t bucket_shift;
     bool shared_allocator;
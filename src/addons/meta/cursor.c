@@ -1887,6 +1887,107 @@ error:
     return 0;
 }
 
+static
+const ecs_member_t* flecs_meta_find_member(
+    const ecs_world_t *world,
+    ecs_entity_t type,
+    const char *name,
+    ecs_size_t len)
+{
+    const EcsStruct *st = ecs_get(world, type, EcsStruct);
+    if (!st) {
+        char *path = ecs_get_fullpath(world, type);
+        ecs_err("cannot resolve member '%.*s' for non-struct type '%s'", 
+            len, name, path);
+        ecs_os_free(path);
+        return NULL;
+    }
+
+    const ecs_member_t *members = ecs_vec_first_t(&st->members, ecs_member_t);
+    int32_t i, count = ecs_vec_count(&st->members);
+    for (i = 0; i < count; i ++) {
+        const char *member_name = members[i].name;
+        if (!ecs_os_strncmp(member_name, name, len) && !member_name[len]) {
+            return &members[i];
+        }
+    }
+
+    char *path = ecs_get_fullpath(world, type);
+    ecs_err("unknown member '%.*s' for type '%s'", len, name, path);
+    ecs_os_free(path);
+    return NULL;
+}
+
+ecs_member_ref_t ecs_meta_member_ref(
+    const ecs_world_t *world,
+    ecs_entity_t type,
+    const char *member)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(type != 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(member != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    world = ecs_get_world(world);
+
+    /* Walk (nested) struct members, adding up the member offsets */
+    ecs_entity_t member_type = type;
+    ecs_size_t offset = 0;
+    const char *ptr = member;
+    do {
+        const char *dot = strchr(ptr, '.');
+        ecs_size_t len = dot ? flecs_ito(ecs_size_t, dot - ptr) : 
+            ecs_os_strlen(ptr);
+        const ecs_member_t *m = flecs_meta_find_member(
+            world, member_type, ptr, len);
+        if (!m) {
+            goto error;
+        }
+
+        offset += m->offset;
+        member_type = m->type;
+        ptr = dot ? dot + 1 : NULL;
+    } while (ptr);
+
+    const EcsComponent *comp = ecs_get(world, member_type, EcsComponent);
+    ecs_check(comp != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    return (ecs_member_ref_t){
+        .type = type,
+        .member_type = member_type,
+        .offset = offset,
+        .size = comp->size
+    };
+error:
+    return (ecs_member_ref_t){ 0 };
+}
+
+void* ecs_field_member_w_size(
+    const ecs_iter_t *it,
+    size_t size,
+    int32_t index,
+    const ecs_member_ref_t *member)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(member != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(member->member_type != 0, ECS_INVALID_PARAMETER, 
+        "member was not resolved");
+    ecs_check(!size || member->size == flecs_uto(ecs_size_t, size), 
+        ECS_INVALID_PARAMETER, "size mismatch for member");
+    (void)size;
+    ecs_assert(ecs_get_typeid(it->real_world, ecs_field_id(it, index)) == 
+        member->type, ECS_INVALID_PARAMETER, 
+            "member does not belong to field type");
+
+    void *ptr = ecs_field_w_size(it, 0, index);
+    if (!ptr) {
+        return NULL;
+    }
+
+    return ECS_OFFSET(ptr, member->offset);
+error:
+    return NULL;
+}
+
 double ecs_meta_ptr_to_float(
     ecs_primitive_kind_t type_kind,
     const void *ptr)
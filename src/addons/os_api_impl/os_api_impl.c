@@ -3,6 +3,12 @@
  * @brief Builtin implementation for OS API.
  */
 
+/* Exposes syscall() and mremap(). This only has an effect if no system headers
+ * have been included yet, which is not the case in the amalgamated source. */
+#if defined(__linux__) && !defined(_GNU_SOURCE) && !defined(FLECS_PRIVATE_H)
+#define _GNU_SOURCE
+#endif
+
 #include "../../private_api.h"
 
 #ifdef FLECS_OS_API_IMPL
@@ -13,6 +13,23 @@
 #include <time.h>
 #endif
 
+/* The system headers only declare syscall() when GNU or default extensions are 
+ * enabled, which is not the case if the application requests strict POSIX. */
+#if defined(__linux__) && (defined(_GNU_SOURCE) || \
+    defined(_DEFAULT_SOURCE) || defined(_BSD_SOURCE))
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#if defined(SYS_futex) && defined(__GNUC__)
+#include <linux/futex.h>
+#include <limits.h>
+#define POSIX_HAS_FUTEX
+#endif
+
+#include <sys/mman.h>
+#define POSIX_HAS_PAGES
+#endif
+
 /* This mutex is used to emulate atomic operations when the gnu builtins are
  * not supported. This is probably not very fast but if the compiler doesn't
  * support the gnu built-ins, then speed is probably not a priority. */
@@ -91,6 +108,27 @@ int32_t posix_adec(
 #endif
 }
 
+static
+int32_t posix_aadd(
+    int32_t *count,
+    int32_t add)
+{
+    int32_t value;
+#ifdef __GNUC__
+    value = __sync_add_and_fetch (count, add);
+    return value;
+#else
+    if (pthread_mutex_lock(&atomic_mutex)) {
+	    abort();
+    }
+    value = (*count) += add;
+    if (pthread_mutex_unlock(&atomic_mutex)) {
+	    abort();
+    }
+    return value;
+#endif
+}
+
 static
 int64_t posix_lainc(
     int64_t *count)
@@ -221,6 +259,194 @@ void posix_cond_wait(
     }
 }
 
+#ifdef POSIX_HAS_FUTEX
+
+/* Number of times a waiting thread checks a value before it parks. The spin 
+ * count adapts to how long threads typically wait: it grows when values change
+ * while spinning, and shrinks when threads end up parking anyway. */
+#define POSIX_FUTEX_SPIN_MIN (16)
+#define POSIX_FUTEX_SPIN_MAX (4096)
+
+static int32_t posix_futex_spin = 256;
+
+static
+void posix_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __asm__ __volatile__("pause");
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static
+void posix_futex_wait(
+    int32_t *value,
+    int32_t expected)
+{
+    int32_t i, spin = __atomic_load_n(&posix_futex_spin, __ATOMIC_RELAXED);
+    for (i = 0; i < spin; i ++) {
+        if (__atomic_load_n(value, __ATOMIC_ACQUIRE) != expected) {
+            if (spin < POSIX_FUTEX_SPIN_MAX) {
+                __atomic_store_n(&posix_futex_spin, spin * 2, __ATOMIC_RELAXED);
+            }
+            return;
+        }
+        posix_cpu_relax();
+    }
+
+    if (spin > POSIX_FUTEX_SPIN_MIN) {
+        __atomic_store_n(&posix_futex_spin, spin / 2, __ATOMIC_RELAXED);
+    }
+
+    while (__atomic_load_n(value, __ATOMIC_ACQUIRE) == expected) {
+        /* Returns immediately if value no longer equals expected */
+        syscall(SYS_futex, value, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+    }
+}
+
+static
+void posix_futex_wake(
+    int32_t *value)
+{
+    syscall(SYS_futex, value, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+#endif
+
+#ifdef POSIX_HAS_PAGES
+
+/* Mappings are aligned to the size of a transparent huge page, so that the 
+ * kernel can back as much of a mapping with huge pages as possible. */
+#define POSIX_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE (14)
+#endif
+
+static
+size_t posix_page_round(
+    size_t size,
+    size_t page_size)
+{
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+static
+bool posix_page_advise(
+    void *ptr,
+    size_t size)
+{
+    /* Fails if the kernel doesn't support transparent huge pages, in which 
+     * case the mapping uses regular pages */
+    return madvise(ptr, size, MADV_HUGEPAGE) == 0;
+}
+
+/* Map region of len bytes that starts on a huge page boundary */
+static
+void* posix_page_map_aligned(
+    size_t len)
+{
+    size_t map_len = len + POSIX_HUGE_PAGE_SIZE;
+    void *ptr = mmap(NULL, map_len, PROT_READ | PROT_WRITE, 
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return NULL;
+    }
+
+    /* Trim mapping so that it starts on a huge page boundary */
+    uintptr_t addr = (uintptr_t)ptr;
+    uintptr_t aligned = posix_page_round(addr, POSIX_HUGE_PAGE_SIZE);
+    size_t head = aligned - addr;
+    size_t tail = map_len - head - len;
+    if (head) {
+        munmap(ptr, head);
+    }
+    if (tail) {
+        munmap((void*)(aligned + len), tail);
+    }
+
+    return (void*)aligned;
+}
+
+static
+void* posix_page_alloc(
+    ecs_size_t size,
+    bool *huge)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t len = posix_page_round((size_t)size, page_size);
+    void *result = posix_page_map_aligned(len);
+    if (result) {
+        *huge = posix_page_advise(result, len);
+    }
+    return result;
+}
+
+static
+void posix_page_free(
+    void *ptr,
+    ecs_size_t size)
+{
+    munmap(ptr, (size_t)size);
+}
+
+/* Remap pages in place, or move them to dst if not NULL. Returns MAP_FAILED if
+ * that isn't possible, or if mremap is not available (requires _GNU_SOURCE). */
+static
+void* posix_page_remap(
+    void *ptr,
+    size_t old_len,
+    size_t len,
+    void *dst)
+{
+#ifdef MREMAP_FIXED
+    if (dst) {
+        return mremap(ptr, old_len, len, MREMAP_MAYMOVE | MREMAP_FIXED, dst);
+    }
+    return mremap(ptr, old_len, len, 0);
+#else
+    (void)ptr;
+    (void)old_len;
+    (void)len;
+    (void)dst;
+    return MAP_FAILED;
+#endif
+}
+
+static
+void* posix_page_realloc(
+    void *ptr,
+    ecs_size_t old_size,
+    ecs_size_t size,
+    bool *huge)
+{
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t old_len = posix_page_round((size_t)old_size, page_size);
+    size_t len = posix_page_round((size_t)size, page_size);
+
+    /* Resize in place, which keeps the huge page alignment */
+    void *result = posix_page_remap(ptr, old_len, len, NULL);
+    if (result == MAP_FAILED) {
+        /* Move pages to a new region that is aligned to a huge page boundary, 
+         * instead of letting the kernel pick an address, which may not be. */
+        result = posix_page_map_aligned(len);
+        if (!result) {
+            return NULL;
+        }
+
+        void *moved = posix_page_remap(ptr, old_len, len, result);
+        if (moved == MAP_FAILED) {
+            ecs_os_memcpy(result, ptr, ECS_MIN(old_size, size));
+            posix_page_free(ptr, old_size);
+        }
+    }
+
+    *huge = posix_page_advise(result, len);
+    return result;
+}
+
+#endif
+
 static bool posix_time_initialized;
 
 #if defined(__APPLE__) && defined(__MACH__)
@@ -312,6 +538,7 @@ void ecs_set_os_api_impl(void) {
     api.adec_ = posix_adec;
     api.lainc_ = posix_lainc;
     api.ladec_ = posix_ladec;
+    api.aadd_ = posix_aadd;
     api.mutex_new_ = posix_mutex_new;
     api.mutex_free_ = posix_mutex_free;
     api.mutex_lock_ = posix_mutex_lock;
@@ -321,6 +548,15 @@ void ecs_set_os_api_impl(void) {
     api.cond_signal_ = posix_cond_signal;
     api.cond_broadcast_ = posix_cond_broadcast;
     api.cond_wait_ = posix_cond_wait;
+#ifdef POSIX_HAS_FUTEX
+    api.futex_wait_ = posix_futex_wait;
+    api.futex_wake_ = posix_futex_wake;
+#endif
+#ifdef POSIX_HAS_PAGES
+    api.page_alloc_ = posix_page_alloc;
+    api.page_realloc_ = posix_page_realloc;
+    api.page_free_ = posix_page_free;
+#endif
     api.sleep_ = posix_sleep;
     api.now_ = posix_time_now;
 
@@ -68,6 +68,14 @@ int32_t win_adec(
     return InterlockedDecrement((volatile long*)count);
 }
 
+static
+int32_t win_aadd(
+    int32_t *count,
+    int32_t add) 
+{
+    return InterlockedExchangeAdd((volatile long*)count, add) + add;
+}
+
 static
 int64_t win_lainc(
     int64_t *count) 
@@ -267,6 +275,7 @@ void ecs_set_os_api_impl(void) {
     api.adec_ = win_adec;
     api.lainc_ = win_lainc;
     api.ladec_ = win_ladec;
+    api.aadd_ = win_aadd;
     api.mutex_new_ = win_mutex_new;
     api.mutex_free_ = win_mutex_free;
     api.mutex_lock_ = win_mutex_lock;
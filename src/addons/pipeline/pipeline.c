@@ -237,6 +237,139 @@ bool flecs_pipeline_check_terms(
     return needs_merge;
 }
 
+typedef struct ecs_access_state_t {
+    bool barrier;
+    ecs_map_t reads;
+    ecs_map_t writes;
+} ecs_access_state_t;
+
+static
+bool flecs_pipeline_access_match(
+    ecs_map_t *ids,
+    ecs_id_t id)
+{
+    if (ecs_map_get(ids, id)) {
+        return true;
+    }
+
+    ecs_map_iter_t it = ecs_map_iter(ids);
+    while (ecs_map_next(&it)) {
+        ecs_id_t key = ecs_map_key(&it);
+        if (ecs_id_match(key, id) || ecs_id_match(id, key)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Get the components a term reads from or writes to. Uses the same rules for
+ * default inout kinds as flecs_pipeline_check_term. */
+static
+void flecs_pipeline_term_access(
+    ecs_term_t *term,
+    bool *read,
+    bool *write)
+{
+    *read = false;
+    *write = false;
+
+    ecs_inout_kind_t inout = term->inout;
+    if (inout == EcsInOutNone) {
+        return;
+    }
+
+    bool from_any = ecs_term_match_0(term);
+    bool from_this = ecs_term_match_this(term);
+    bool is_shared = !from_any && 
+        (!from_this || !(term->src.flags & EcsSelf));
+
+    if (inout == EcsInOutDefault) {
+        if (from_any) {
+            return;
+        } else if (is_shared) {
+            inout = EcsIn;
+        } else {
+            inout = EcsInOut;
+        }
+    }
+
+    if (term->oper == EcsNot && inout != EcsOut) {
+        /* Not terms only test whether a component is there */
+        return;
+    }
+
+    *read = inout == EcsIn || inout == EcsInOut;
+    *write = inout == EcsOut || inout == EcsInOut;
+}
+
+/* Test whether system can run in parallel with systems already in the state.
+ * Systems conflict if one of them writes a component the other one reads or
+ * writes. */
+static
+bool flecs_pipeline_access_conflicts(
+    ecs_access_state_t *as,
+    ecs_filter_t *filter)
+{
+    int32_t t, term_count = filter->term_count;
+    if (as->barrier || !term_count) {
+        return as->barrier || ecs_map_count(&as->reads) || 
+            ecs_map_count(&as->writes);
+    }
+
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &filter->terms[t];
+        bool read, write;
+        flecs_pipeline_term_access(term, &read, &write);
+        if (!read && !write) {
+            continue;
+        }
+
+        if (flecs_pipeline_access_match(&as->writes, term->id)) {
+            return true;
+        }
+        if (write && flecs_pipeline_access_match(&as->reads, term->id)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static
+void flecs_pipeline_add_access(
+    ecs_access_state_t *as,
+    ecs_filter_t *filter)
+{
+    int32_t t, term_count = filter->term_count;
+    if (!term_count) {
+        /* Can't tell what a system without terms accesses */
+        as->barrier = true;
+        return;
+    }
+
+    for (t = 0; t < term_count; t ++) {
+        ecs_term_t *term = &filter->terms[t];
+        bool read, write;
+        flecs_pipeline_term_access(term, &read, &write);
+        if (read) {
+            ecs_map_ensure(&as->reads, term->id)[0] = true;
+        }
+        if (write) {
+            ecs_map_ensure(&as->writes, term->id)[0] = true;
+        }
+    }
+}
+
+static
+void flecs_pipeline_reset_access(
+    ecs_access_state_t *as)
+{
+    ecs_map_clear(&as->reads);
+    ecs_map_clear(&as->writes);
+    as->barrier = false;
+}
+
 static
 EcsPoly* flecs_pipeline_term_system(
     ecs_iter_t *it)
@@ -256,7 +389,9 @@ bool flecs_pipeline_build(
 {
     ecs_iter_t it = ecs_query_iter(world, pq->query);
 
-    if (pq->match_count == pq->query->match_count) {
+    if (pq->match_count == pq->query->match_count && 
+        pq->parallel_systems == world->parallel_systems) 
+    {
         /* No need to rebuild the pipeline */
         ecs_iter_fini(&it);
         return false;
@@ -270,6 +405,9 @@ bool flecs_pipeline_build(
     ecs_write_state_t ws = {0};
     ecs_map_init(&ws.ids, a);
     ecs_map_init(&ws.wildcard_ids, a);
+    ecs_access_state_t as = {0};
+    ecs_map_init(&as.reads, a);
+    ecs_map_init(&as.writes, a);
 
     ecs_vec_reset_t(a, &pq->ops, ecs_pipeline_op_t);
     ecs_vec_reset_t(a, &pq->systems, ecs_entity_t);
@@ -277,6 +415,7 @@ bool flecs_pipeline_build(
     bool multi_threaded = false;
     bool no_readonly = false;
     bool first = true;
+    bool parallel = world->parallel_systems;
 
     /* Iterate systems in pipeline, add ops for running / merging */
     while (ecs_query_next(&it)) {
@@ -339,6 +478,24 @@ bool flecs_pipeline_build(
                 /* The component states were just reset, so if we conclude that
                  * another merge is needed something is wrong. */
                 ecs_assert(needs_merge == false, ECS_INTERNAL_ERROR, NULL);        
+
+                flecs_pipeline_reset_access(&as);
+            }
+
+            if (is_active && parallel && !multi_threaded && !no_readonly) {
+                if (flecs_pipeline_access_conflicts(&as, &q->filter)) {
+                    /* System accesses components that are written by a system
+                     * in the current operation (or vice versa). Insert a sync
+                     * point so the system runs after the operation has 
+                     * finished. Commands don't have to be merged, as the 
+                     * write state already inserts merges where needed. */
+                    if (op && op->count) {
+                        op->no_merge = true;
+                        op = NULL;
+                    }
+                    flecs_pipeline_reset_access(&as);
+                }
+                flecs_pipeline_add_access(&as, &q->filter);
             }
 
             if (!op) {
@@ -347,6 +504,8 @@ bool flecs_pipeline_build(
                 op->count = 0;
                 op->multi_threaded = false;
                 op->no_readonly = false;
+                op->parallel = false;
+                op->no_merge = false;
                 op->time_spent = 0;
                 op->commands_enqueued = 0;
             }
@@ -359,6 +518,7 @@ bool flecs_pipeline_build(
                 if (!op->count) {
                     op->multi_threaded = multi_threaded;
                     op->no_readonly = no_readonly;
+                    op->parallel = parallel && !multi_threaded && !no_readonly;
                 }
                 op->count ++;
             }
@@ -371,9 +531,19 @@ bool flecs_pipeline_build(
 
     ecs_map_fini(&ws.ids);
     ecs_map_fini(&ws.wildcard_ids);
+    ecs_map_fini(&as.reads);
+    ecs_map_fini(&as.writes);
 
     op = ecs_vec_first_t(&pq->ops, ecs_pipeline_op_t);
 
+    /* Operations with a single system don't benefit from waking up workers */
+    int32_t o, op_count = ecs_vec_count(&pq->ops);
+    for (o = 0; o < op_count; o ++) {
+        if (op[o].count < 2) {
+            op[o].parallel = false;
+        }
+    }
+
     if (!op) {
         ecs_dbg("#[green]pipeline#[reset] is empty");
         return true;
@@ -382,8 +552,9 @@ bool flecs_pipeline_build(
         ecs_dbg("#[bold]pipeline rebuild");
         ecs_log_push_1();
 
-        ecs_dbg("#[green]schedule#[reset]: threading: %d, staging: %d:", 
-            op->multi_threaded, !op->no_readonly);
+        ecs_dbg("#[green]schedule#[reset]: threading: %d, staging: %d, "
+            "parallel: %d:", op->multi_threaded, !op->no_readonly, 
+            op->parallel);
         ecs_log_push_1();
 
         int32_t i, count = ecs_vec_count(&pq->systems);
@@ -418,16 +589,21 @@ bool flecs_pipeline_build(
 
             ran_since_merge ++;
             if (ran_since_merge == op[op_index].count) {
-                ecs_dbg("#[magenta]merge#[reset]");
+                if (op[op_index].no_merge) {
+                    ecs_dbg("#[magenta]sync#[reset]");
+                } else {
+                    ecs_dbg("#[magenta]merge#[reset]");
+                }
                 ecs_log_pop_1();
                 ran_since_merge = 0;
                 op_index ++;
                 if (op_index < ecs_vec_count(&pq->ops)) {
                     ecs_dbg(
                         "#[green]schedule#[reset]: "
-                        "threading: %d, staging: %d:",
+                        "threading: %d, staging: %d, parallel: %d:",
                         op[op_index].multi_threaded, 
-                        !op[op_index].no_readonly);
+                        !op[op_index].no_readonly,
+                        op[op_index].parallel);
                 }
                 ecs_log_push_1();
             }
@@ -448,6 +624,7 @@ bool flecs_pipeline_build(
     }
 
     pq->match_count = pq->query->match_count;
+    pq->parallel_systems = parallel;
 
     ecs_assert(pq->cur_op <= ecs_vec_last_t(&pq->ops, ecs_pipeline_op_t),
         ECS_INTERNAL_ERROR, NULL);
@@ -542,13 +719,25 @@ int32_t flecs_run_pipeline_ops(
     ecs_pipeline_op_t* op = pq->cur_op;
     int32_t i = pq->cur_i;
 
-    ecs_assert(!stage_index || op->multi_threaded, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(!stage_index || op->multi_threaded || op->parallel, 
+        ECS_INTERNAL_ERROR, NULL);
 
     int32_t count = ecs_vec_count(&pq->systems);
     ecs_entity_t* systems = ecs_vec_first_t(&pq->systems, ecs_entity_t);
     int32_t ran_since_merge = i - op->offset;
 
     for (; i < count; i++) {
+        if (op->parallel && 
+            ((i - op->offset) % stage_count) != stage_index) 
+        {
+            /* System runs on another stage */
+            ran_since_merge++;
+            if (ran_since_merge == op->count) {
+                break;
+            }
+            continue;
+        }
+
         ecs_entity_t system = systems[i];
         const EcsPoly* poly = ecs_get_pair(world, system, EcsPoly, EcsSystem);
         ecs_poly_assert(poly->poly, ecs_system_t);
@@ -567,9 +756,13 @@ int32_t flecs_run_pipeline_ops(
         }
 
         ecs_run_intern(world, s, system, sys, stage_index,
-            stage_count, delta_time, 0, 0, NULL);
+            stage_count, world->worker_chunk_size, delta_time, 0, 0, NULL);
 
-        world->info.systems_ran_frame++;
+        if (op->parallel) {
+            ecs_os_linc(&world->info.systems_ran_frame);
+        } else {
+            world->info.systems_ran_frame++;
+        }
         ran_since_merge++;
 
         if (ran_since_merge == op->count) {
@@ -581,6 +774,26 @@ int32_t flecs_run_pipeline_ops(
     return i;
 }
 
+/* Reset chunk counters of systems in current operation before workers start
+ * claiming chunks */
+static
+void flecs_pipeline_reset_chunks(
+    ecs_world_t *world,
+    ecs_pipeline_state_t *pq)
+{
+    ecs_pipeline_op_t *op = pq->cur_op;
+    ecs_entity_t *systems = ecs_vec_first_t(&pq->systems, ecs_entity_t);
+    int32_t i, count = op->offset + op->count;
+
+    for (i = pq->cur_i; i < count; i ++) {
+        const EcsPoly *poly = ecs_get_pair(
+            world, systems[i], EcsPoly, EcsSystem);
+        ecs_poly_assert(poly->poly, ecs_system_t);
+        ecs_system_t *sys = (ecs_system_t*)poly->poly;
+        sys->worker_claimed = 0;
+    }
+}
+
 void flecs_run_pipeline(
     ecs_world_t *world,
     ecs_pipeline_state_t *pq,
@@ -598,6 +811,7 @@ void flecs_run_pipeline(
     ecs_assert(!stage_index, ECS_INVALID_OPERATION, NULL);
 
     bool multi_threaded = ecs_get_stage_count(world) > 1;
+    bool readonly = false;
 
     // Update the pipeline the workers will execute
     world->pq = pq;
@@ -614,18 +828,24 @@ void flecs_run_pipeline(
         }
 
         bool no_readonly = pq->cur_op->no_readonly;
-        bool op_multi_threaded = multi_threaded && pq->cur_op->multi_threaded;
+        bool op_multi_threaded = multi_threaded && 
+            (pq->cur_op->multi_threaded || pq->cur_op->parallel);
+        bool no_merge = pq->cur_op->no_merge;
 
         pq->no_readonly = no_readonly;
 
-        if (!no_readonly) {
+        if (!no_readonly && !readonly) {
             ecs_readonly_begin(world);
+            readonly = true;
         }
 
         ECS_BIT_COND(world->flags, EcsWorldMultiThreaded, op_multi_threaded);
         ecs_assert(world->workers_waiting == 0, ECS_INTERNAL_ERROR, NULL);
 
         if (op_multi_threaded) {
+            if (world->worker_chunk_size) {
+                flecs_pipeline_reset_chunks(world, pq);
+            }
             flecs_signal_workers(world);
         }
 
@@ -647,7 +867,7 @@ void flecs_run_pipeline(
             flecs_wait_for_sync(world);
         }
 
-        if (!no_readonly) {
+        if (!no_readonly && !no_merge) {
             ecs_time_t mt = { 0 };
             if (measure_time) {
                 ecs_time_measure(&mt);
@@ -660,6 +880,7 @@ void flecs_run_pipeline(
             }
 
             ecs_readonly_end(world);
+            readonly = false;
             if (measure_time) {
                 pq->cur_op->time_spent += ecs_time_measure(&mt);
             }
@@ -669,7 +890,13 @@ void flecs_run_pipeline(
          * threads, to avoid race conditions. */
         pq->cur_i = i;
 
-        flecs_pipeline_update(world, pq, false);
+        if (readonly) {
+            /* Operation ended with a sync point without a merge. The world is
+             * still readonly, so the schedule can't have changed. */
+            flecs_pipeline_next_system(pq);
+        } else {
+            flecs_pipeline_update(world, pq, false);
+        }
     }
 }
 
@@ -17,6 +17,8 @@ typedef struct ecs_pipeline_op_t {
     int64_t commands_enqueued;  /* Number of commands enqueued for sync point */
     bool multi_threaded;        /* Whether systems can be ran multi threaded */
     bool no_readonly;           /* Whether systems are staged or not */
+    bool parallel;              /* Whether systems run in parallel with each other */
+    bool no_merge;              /* Sync after op without merging commands */
 } ecs_pipeline_op_t;
 
 struct ecs_pipeline_state_t {
@@ -28,6 +30,7 @@ struct ecs_pipeline_state_t {
     ecs_id_record_t *idr_inactive; /* Cached record for quick inactive test */
     int32_t match_count;        /* Used to track of rebuild is necessary */
     int32_t rebuild_count;      /* Number of pipeline rebuilds */
+    bool parallel_systems;      /* Was pipeline built for parallel systems */
     ecs_iter_t *iters;          /* Iterator for worker(s) */
     int32_t iter_count;
 
@@ -38,6 +41,18 @@ struct ecs_pipeline_state_t {
     bool no_readonly;           /* Is pipeline in readonly mode */
 };
 
+/** Job that is ran by the main thread and workers instead of the pipeline.
+ * Used by ecs_query_par_each, ecs_rule_par_each and stage merges. */
+struct ecs_worker_job_t {
+    ecs_query_t *query;         /* Query to iterate */
+    const ecs_rule_t *rule;     /* Rule to evaluate (if no query) */
+    ecs_worker_action_t action; /* Action to run (if no query or rule) */
+    ecs_iter_action_t callback; /* Function invoked for each chunk */
+    void *ctx;                  /* Context passed to callback */
+    int32_t chunk_size;         /* Max number of rows per chunk */
+    int32_t claimed;            /* Chunk/table counter shared between threads */
+};
+
 typedef struct EcsPipeline {
     /* Stable ptr so threads can safely access while entity/components move */
     ecs_pipeline_state_t *state;
@@ -9,16 +9,38 @@
 #ifdef FLECS_PIPELINE
 #include "pipeline.h"
 
+/* Wait until main thread signals workers, futex version */
+static
+void flecs_wait_for_signal(
+    ecs_world_t *world,
+    int32_t *signal)
+{
+    ecs_os_futex_wait(&world->workers_signal, signal[0]);
+    signal[0] ++;
+}
+
 /* Synchronize workers */
 static
 void flecs_sync_worker(
-    ecs_world_t* world)
+    ecs_world_t* world,
+    int32_t *signal)
 {
     int32_t stage_count = ecs_get_stage_count(world);
     if (stage_count <= 1) {
         return;
     }
 
+    if (world->workers_use_futex) {
+        /* Last worker to reach the sync point wakes up the main thread */
+        if (!ecs_os_adec(&world->workers_pending)) {
+            ecs_os_ainc(&world->workers_synced);
+            ecs_os_futex_wake(&world->workers_synced);
+        }
+
+        flecs_wait_for_signal(world, signal);
+        return;
+    }
+
     /* Signal that thread is waiting */
     ecs_os_mutex_lock(world->sync_mutex);
     if (++world->workers_waiting == (stage_count - 1)) {
@@ -31,6 +53,55 @@ void flecs_sync_worker(
     ecs_os_mutex_unlock(world->sync_mutex);
 }
 
+/* Target number of bytes per chunk when no chunk size is provided */
+#define FLECS_PAR_EACH_CHUNK_BYTES (32 * 1024)
+
+/* Run job on stage. When the job runs on more than one thread, threads claim
+ * chunks (queries) or tables (rules) from the shared counter of the job. */
+static
+void flecs_run_worker_job(
+    ecs_stage_t *stage,
+    ecs_worker_job_t *job,
+    int32_t stage_count)
+{
+    if (job->action) {
+        job->action(stage, job->ctx);
+        return;
+    }
+
+#ifdef FLECS_RULES
+    if (job->rule) {
+        ecs_iter_t rit = ecs_rule_iter((ecs_world_t*)stage, job->rule);
+        rit.callback = job->callback;
+        rit.ctx = job->ctx;
+        if (stage_count > 1) {
+            ecs_rule_iter_set_partition(&rit, &job->claimed);
+        }
+
+        while (ecs_rule_next(&rit)) {
+            job->callback(&rit);
+        }
+        return;
+    }
+#endif
+
+    ecs_iter_t qit = ecs_query_iter((ecs_world_t*)stage, job->query);
+    qit.callback = job->callback;
+    qit.ctx = job->ctx;
+
+    if (stage_count <= 1) {
+        while (ecs_query_next(&qit)) {
+            job->callback(&qit);
+        }
+        return;
+    }
+
+    ecs_iter_t it = ecs_worker_chunk_iter(&qit, &job->claimed, job->chunk_size);
+    while (ecs_worker_chunk_next(&it)) {
+        job->callback(&it);
+    }
+}
+
 /* Worker thread */
 static
 void* flecs_worker(void *arg) {
@@ -47,22 +118,37 @@ void* flecs_worker(void *arg) {
     ecs_os_mutex_lock(world->sync_mutex);
     world->workers_running ++;
 
+    /* Main thread doesn't signal workers until all workers are running, so
+     * the signal counter can't change while the mutex is locked. */
+    int32_t signal = world->workers_signal;
+
     if (!(world->flags & EcsWorldQuitWorkers)) {
-        ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        if (!world->workers_use_futex) {
+            ecs_os_cond_wait(world->worker_cond, world->sync_mutex);
+        }
     }
 
     ecs_os_mutex_unlock(world->sync_mutex);
 
+    if (world->workers_use_futex) {
+        flecs_wait_for_signal(world, &signal);
+    }
+
     while (!(world->flags & EcsWorldQuitWorkers)) {
         ecs_entity_t old_scope = ecs_set_scope((ecs_world_t*)stage, 0);
 
         ecs_dbg_3("worker %d: run", stage->id);
-        flecs_run_pipeline_ops(world, stage, stage->id, world->stage_count, 
-            world->info.delta_time);
+        ecs_worker_job_t *job = world->worker_job;
+        if (job) {
+            flecs_run_worker_job(stage, job, world->stage_count);
+        } else {
+            flecs_run_pipeline_ops(world, stage, stage->id, 
+                world->stage_count, world->info.delta_time);
+        }
 
         ecs_set_scope((ecs_world_t*)stage, old_scope);
 
-        flecs_sync_worker(world);
+        flecs_sync_worker(world, &signal);
     }
 
     ecs_dbg_2("worker %d: finalizing", stage->id);
@@ -148,6 +234,12 @@ void flecs_wait_for_sync(
 
     ecs_dbg_3("#[bold]pipeline: waiting for worker sync");
 
+    if (world->workers_use_futex) {
+        ecs_os_futex_wait(&world->workers_synced, 0);
+        ecs_dbg_3("#[bold]pipeline: workers synced");
+        return;
+    }
+
     ecs_os_mutex_lock(world->sync_mutex);
     if (world->workers_waiting != (stage_count - 1)) {
         ecs_os_cond_wait(world->sync_cond, world->sync_mutex);
@@ -173,6 +265,18 @@ void flecs_signal_workers(
     }
 
     ecs_dbg_3("#[bold]pipeline: signal workers");
+
+    if (world->workers_use_futex) {
+        /* Workers are waiting for the signal, so it's safe to reset the sync
+         * state without atomics. The atomic increment of the signal counter
+         * ensures that workers see the new values. */
+        world->workers_pending = stage_count - 1;
+        world->workers_synced = 0;
+        ecs_os_ainc(&world->workers_signal);
+        ecs_os_futex_wake(&world->workers_signal);
+        return;
+    }
+
     ecs_os_mutex_lock(world->sync_mutex);
     ecs_os_cond_broadcast(world->worker_cond);
     ecs_os_mutex_unlock(world->sync_mutex);
@@ -273,6 +377,7 @@ void flecs_set_threads_internal(
         }
 
         world->workers_use_task_api = use_task_api;
+        world->workers_use_futex = ecs_os_has_futex();
 
         /* Start threads if number of threads > 1 */
         if (threads > 1) {
@@ -306,4 +411,180 @@ bool ecs_using_task_threads(
     return world->workers_use_task_api;
 }
 
+void ecs_set_worker_chunk_size(
+    ecs_world_t *world,
+    int32_t chunk_size)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_check(chunk_size >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot change chunk size while pipeline is running");
+    world->worker_chunk_size = chunk_size;
+error:
+    return;
+}
+
+int32_t ecs_get_worker_chunk_size(
+    const ecs_world_t *world)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    return world->worker_chunk_size;
+}
+
+/* Run job on the main thread and workers, and wait until it has finished */
+static
+void flecs_run_job(
+    ecs_world_t *world,
+    ecs_worker_job_t *job)
+{
+    /* Make sure the query cache is up to date before threads start iterating,
+     * as queries can't be rematched in readonly mode. */
+    ecs_run_aperiodic(world, 0);
+
+    bool task_threads = ecs_using_task_threads(world);
+    if (task_threads) {
+        flecs_create_worker_threads(world);
+    }
+
+    flecs_wait_for_workers(world);
+    ecs_readonly_begin(world);
+
+    world->worker_job = job;
+    flecs_signal_workers(world);
+
+    /* Run job on main thread */
+    ecs_world_t *stage = ecs_get_stage(world, 0);
+    ecs_entity_t old_scope = ecs_set_scope(stage, 0);
+    flecs_run_worker_job((ecs_stage_t*)stage, job, world->stage_count);
+    ecs_set_scope(stage, old_scope);
+
+    flecs_wait_for_sync(world);
+    world->worker_job = NULL;
+
+    ecs_readonly_end(world);
+
+    if (task_threads) {
+        flecs_join_worker_threads(world);
+    }
+}
+
+bool flecs_workers_run(
+    ecs_world_t *world,
+    ecs_worker_action_t action,
+    void *ctx)
+{
+    ecs_poly_assert(world, ecs_world_t);
+
+    /* Task threads only exist while a pipeline or job is running */
+    int32_t stage_count = world->stage_count;
+    if ((stage_count <= 1) || ecs_using_task_threads(world) || 
+        !world->stages[1].thread || world->worker_job) 
+    {
+        return false;
+    }
+
+    ecs_worker_job_t job = {
+        .action = action,
+        .ctx = ctx
+    };
+
+    flecs_wait_for_workers(world);
+
+    world->worker_job = &job;
+    flecs_signal_workers(world);
+    flecs_run_worker_job(&world->stages[0], &job, stage_count);
+    flecs_wait_for_sync(world);
+    world->worker_job = NULL;
+
+    return true;
+}
+
+/* Number of rows for which the data of all fields fits in a chunk */
+static
+int32_t flecs_par_each_chunk_size(
+    const ecs_query_t *query)
+{
+    const ecs_filter_t *filter = ecs_query_get_filter(query);
+    ecs_size_t row_size = ECS_SIZEOF(ecs_entity_t);
+    int32_t i;
+    for (i = 0; i < filter->field_count; i ++) {
+        row_size += filter->sizes[i];
+    }
+
+    int32_t result = FLECS_PAR_EACH_CHUNK_BYTES / row_size;
+    return result ? result : 1;
+}
+
+void ecs_query_par_each(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_iter_action_t callback,
+    void *ctx,
+    int32_t chunk_size)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_poly_assert(query, ecs_query_t);
+    ecs_check(callback != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunk_size >= 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot run par_each while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION, NULL);
+    ecs_check(world->worker_job == NULL, ECS_INVALID_OPERATION, NULL);
+
+    ecs_worker_job_t job = {
+        .query = query,
+        .callback = callback,
+        .ctx = ctx,
+        .chunk_size = chunk_size ? chunk_size : flecs_par_each_chunk_size(query)
+    };
+
+    flecs_run_job(world, &job);
+error:
+    return;
+}
+
+#ifdef FLECS_RULES
+void ecs_rule_par_each(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    ecs_iter_action_t callback,
+    void *ctx)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_poly_assert(rule, ecs_rule_t);
+    ecs_check(callback != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot run par_each while world is in readonly mode");
+    ecs_check(!ecs_is_deferred(world), ECS_INVALID_OPERATION, NULL);
+    ecs_check(world->worker_job == NULL, ECS_INVALID_OPERATION, NULL);
+
+    ecs_worker_job_t job = {
+        .rule = rule,
+        .callback = callback,
+        .ctx = ctx
+    };
+
+    /* Creating an iterator updates the results of a cached rule, which can't 
+     * be updated in readonly mode. */
+    ecs_iter_t it = ecs_rule_iter(world, rule);
+    ecs_iter_fini(&it);
+
+    flecs_run_job(world, &job);
+error:
+    return;
+}
+#endif
+
+void ecs_set_parallel_systems(
+    ecs_world_t *world,
+    bool enable)
+{
+    ecs_poly_assert(world, ecs_world_t);
+    ecs_check(!(world->flags & EcsWorldReadonly), ECS_INVALID_OPERATION, 
+        "cannot enable parallel systems while pipeline is running");
+    world->parallel_systems = enable;
+error:
+    return;
+}
+
 #endif
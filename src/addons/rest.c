@@ -676,6 +676,8 @@ void flecs_world_stats_to_json(
     ECS_COUNTER_APPEND(reply, stats, memory.stack_alloc_count, "Pages allocated by stack allocators");
     ECS_COUNTER_APPEND(reply, stats, memory.stack_free_count, "Pages freed by stack allocators");
     ECS_GAUGE_APPEND(reply, stats, memory.stack_outstanding_alloc_count, "Outstanding page allocations");
+    ECS_GAUGE_APPEND(reply, stats, memory.page_bytes, "Bytes of world storage mapped with OS page allocation");
+    ECS_GAUGE_APPEND(reply, stats, memory.huge_page_advised_bytes, "Bytes of world storage advised to use huge pages");
 
     ECS_COUNTER_APPEND(reply, stats, rest.request_count, "Received requests");
     ECS_COUNTER_APPEND(reply, stats, rest.entity_count, "Received entity/ requests");
@@ -28,6 +28,7 @@ const char* flecs_rule_op_str(
     case EcsRuleAndAny:       return "andany  ";
     case EcsRuleWith:         return "with    ";
     case EcsRuleTrav:         return "trav    ";
+    case EcsRuleJoin:         return "join    ";
     case EcsRuleIdsRight:     return "idsr    ";
     case EcsRuleIdsLeft:      return "idsl    ";
     case EcsRuleEach:         return "each    ";
@@ -84,7 +85,9 @@ void flecs_rule_fini(
         ecs_os_free(rule->vars);
     }
 
+    flecs_rule_cache_fini(rule);
     ecs_os_free(rule->ops);
+    ecs_os_free(rule->joins);
     ecs_os_free(rule->src_vars);
     flecs_name_index_fini(&rule->tvar_index);
     flecs_name_index_fini(&rule->evar_index);
@@ -126,6 +129,10 @@ ecs_rule_t* ecs_rule_init(
         goto error;
     }
 
+    if (result->filter.flags & EcsFilterCached) {
+        flecs_rule_cache_init(world, result);
+    }
+
     ecs_entity_t entity = const_desc->entity;
     result->dtor = (ecs_poly_dtor_t)flecs_rule_fini;
 
@@ -188,6 +195,68 @@ int32_t flecs_rule_op_ref_str(
     return color_chars;
 }
 
+/* Does operation have an estimated number of results from the planner */
+static
+bool flecs_rule_op_has_est(
+    const ecs_rule_op_t *op)
+{
+    if (op->field_index < 0) {
+        return false;
+    }
+
+    switch(op->kind) {
+    case EcsRuleAnd:
+    case EcsRuleAndId:
+    case EcsRuleWith:
+    case EcsRuleAndAny:
+    case EcsRuleTrav:
+    case EcsRuleJoin:
+    case EcsRuleIdsLeft:
+    case EcsRuleIdsRight:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* Append terms of hash join operation */
+static
+void flecs_rule_join_str(
+    const ecs_rule_t *rule,
+    const ecs_rule_op_t *op,
+    int32_t hidden_chars,
+    int32_t start,
+    ecs_strbuf_t *buf)
+{
+    const ecs_rule_join_t *join = &rule->joins[op->other];
+    int32_t i, written = ecs_strbuf_written(buf) - hidden_chars;
+    for (i = 0; i < (30 - (written - start)); i ++) {
+        ecs_strbuf_appendch(buf, ' ');
+    }
+
+    for (i = 0; i < join->term_count; i ++) {
+        const ecs_rule_join_term_t *term = &join->terms[i];
+        ecs_flags16_t first_flags = flecs_rule_ref_flags(
+            term->flags, EcsRuleFirst);
+        ecs_flags16_t second_flags = flecs_rule_ref_flags(
+            term->flags, EcsRuleSecond);
+        ecs_rule_ref_t first = term->first, second = term->second;
+
+        if (i) {
+            ecs_strbuf_appendstr(buf, ", ");
+        }
+        ecs_strbuf_appendstr(buf, "(");
+        flecs_rule_op_ref_str(rule, &first, first_flags, buf);
+        if (second_flags) {
+            ecs_strbuf_appendstr(buf, ", ");
+            flecs_rule_op_ref_str(rule, &second, second_flags, buf);
+        }
+        ecs_strbuf_appendch(buf, ')');
+    }
+
+    ecs_strbuf_append(buf, " #[grey]~%d#[reset]", op->est);
+}
+
 char* ecs_rule_str_w_profile(
     const ecs_rule_t *rule,
     const ecs_iter_t *it)
@@ -244,6 +313,11 @@ char* ecs_rule_str_w_profile(
             indent ++;
         }
 
+        if (op->kind == EcsRuleJoin) {
+            first_flags = second_flags = 0;
+            flecs_rule_join_str(rule, op, hidden_chars, start, &buf);
+        }
+
         if (!first_flags && !second_flags) {
             ecs_strbuf_appendstr(&buf, "\n");
             continue;
@@ -286,6 +360,10 @@ char* ecs_rule_str_w_profile(
 
         ecs_strbuf_appendch(&buf, ')');
 
+        if (flecs_rule_op_has_est(op)) {
+            ecs_strbuf_append(&buf, " #[grey]~%d#[reset]", op->est);
+        }
+
         ecs_strbuf_appendch(&buf, '\n');
     }
 
@@ -0,0 +1,520 @@
+/**
+ * @file addons/rules/cache.c
+ * @brief Cache that stores the results of a rule.
+ *
+ * A cached rule stores its results, so that iterating a rule that hasn't
+ * changed doesn't have to evaluate the rule program. The cache is kept up to
+ * date with observers for the ids the rule matches.
+ *
+ * When all terms of a rule match the $this table, the results of a table only
+ * depend on the table type. For these rules the cache is updated incrementally,
+ * by matching each table that becomes non-empty. For other rules the results
+ * depend on the components of individual entities, and the cache is recomputed
+ * after any of the matched ids is added to or removed from an entity.
+ *
+ * Results that point to individual entities also depend on where the entities
+ * are stored, which can change without changing a matched id. Before such a
+ * cache is used, it checks whether these entities are still in the same table
+ * and row, and recomputes the results if they are not.
+ */
+
+#include "rules.h"
+
+#ifdef FLECS_RULES
+
+/* Header of cached result. Results that don't contain an entire $this table
+ * depend on the order of entities in the table, and are checked before the
+ * cache is used. */
+typedef struct ecs_rule_cache_result_t {
+    ecs_entity_t entity;          /* First entity in $this range */
+    uint64_t table_id;            /* Id of $this table */
+    int32_t table_state;          /* Dirty state of $this table */
+} ecs_rule_cache_result_t;
+
+typedef struct ecs_rule_cache_watch_t {
+    ecs_id_t id;
+    bool entity_events;
+} ecs_rule_cache_watch_t;
+
+static
+void flecs_rule_cache_mark_dirty(
+    ecs_rule_cache_t *cache)
+{
+    cache->dirty = true;
+    ecs_vec_clear(&cache->pending);
+}
+
+static
+void flecs_rule_cache_on_event(
+    ecs_iter_t *it)
+{
+    ecs_rule_cache_t *cache = it->ctx;
+    if (!cache || cache->dirty) {
+        return;
+    }
+
+    ecs_allocator_t *a = &it->real_world->allocator;
+
+    if (it->event == EcsOnTableFill && cache->table_only) {
+        /* Table type didn't change, only match table if it wasn't matched */
+        ecs_table_t *table = it->table;
+        if (!ecs_map_get(&cache->tables, table->id)) {
+            ecs_map_insert(&cache->tables, table->id, 0);
+            ecs_vec_append_t(a, &cache->pending, ecs_table_t*)[0] = table;
+        }
+        return;
+    }
+
+    flecs_rule_cache_mark_dirty(cache);
+}
+
+static
+void flecs_rule_cache_watch(
+    ecs_allocator_t *a,
+    ecs_vec_t *watches,
+    ecs_id_t id,
+    bool entity_events)
+{
+    int32_t i, count = ecs_vec_count(watches);
+    ecs_rule_cache_watch_t *w = ecs_vec_first(watches);
+    for (i = 0; i < count; i ++) {
+        if (w[i].id == id) {
+            w[i].entity_events |= entity_events;
+            return;
+        }
+    }
+
+    ecs_rule_cache_watch_t *elem = ecs_vec_append_t(
+        a, watches, ecs_rule_cache_watch_t);
+    elem->id = id;
+    elem->entity_events = entity_events;
+}
+
+/* Get id to observe for term. Variables are replaced with wildcards. */
+static
+ecs_id_t flecs_rule_cache_watch_id(
+    const ecs_term_t *term)
+{
+    const ecs_term_id_t *first = &term->first, *second = &term->second;
+    if ((first->flags & EcsIsVariable) || ecs_id_is_wildcard(first->id)) {
+        return EcsWildcard;
+    }
+
+    if (!ECS_IS_PAIR(term->id)) {
+        return first->id;
+    }
+
+    ecs_entity_t tgt = second->id;
+    if ((second->flags & EcsIsVariable) ||
+        (term->flags & EcsTermTransitive) || ecs_id_is_wildcard(tgt))
+    {
+        /* Transitive terms also match targets of the relationship */
+        tgt = EcsWildcard;
+    }
+
+    return ecs_pair(first->id, tgt);
+}
+
+static
+bool flecs_rule_cache_is_this(
+    const ecs_term_id_t *term_id)
+{
+    return (term_id->flags & EcsIsVariable) && (term_id->id == EcsThis);
+}
+
+/* Find ids that the rule results depend on */
+static
+void flecs_rule_cache_find_watches(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    ecs_vec_t *watches)
+{
+    const ecs_filter_t *filter = &rule->filter;
+    int32_t i, count = filter->term_count;
+    ecs_term_t *terms = filter->terms;
+    ecs_allocator_t *a = &world->allocator;
+
+    /* If $this is used as entity, results can contain individual entities */
+    bool this_entity = !rule->has_table_this;
+    for (i = 0; i < count; i ++) {
+        ecs_term_t *term = &terms[i];
+        if (flecs_rule_cache_is_this(&term->first) ||
+            flecs_rule_cache_is_this(&term->second) ||
+            flecs_rule_is_builtin_pred(term))
+        {
+            this_entity = true;
+        }
+    }
+
+    for (i = 0; i < count; i ++) {
+        ecs_term_t *term = &terms[i];
+        ecs_entity_t first = term->first.id;
+        if (first == EcsScopeOpen || first == EcsScopeClose) {
+            continue;
+        }
+
+        if (flecs_rule_is_builtin_pred(term)) {
+            /* Predicates compare entities by name */
+            flecs_rule_cache_watch(a, watches,
+                ecs_pair(ecs_id(EcsIdentifier), EcsName), true);
+            if (first == EcsPredLookup) {
+                flecs_rule_cache_watch(a, watches,
+                    ecs_pair(EcsChildOf, EcsWildcard), true);
+            }
+            continue;
+        }
+
+        bool this_src = flecs_rule_cache_is_this(&term->src);
+        bool entity_events = !this_src || this_entity;
+
+        if (term->first.flags & EcsIsEntity &&
+            ecs_has_id(world, first, EcsUnion))
+        {
+            /* Union targets change without changing the table */
+            entity_events = true;
+        }
+
+        if (term->flags & EcsTermTransitive) {
+            /* Relationship graph can change without changing tables */
+            entity_events = true;
+        }
+
+        if (term->flags & EcsTermIdInherited) {
+            /* Matched tables can have any id that inherits from first */
+            flecs_rule_cache_watch(a, watches, EcsWildcard, false);
+            flecs_rule_cache_watch(a, watches, ecs_pair(EcsIsA, first), true);
+        }
+
+        flecs_rule_cache_watch(a, watches,
+            flecs_rule_cache_watch_id(term), entity_events);
+    }
+
+    if (!(filter->flags & EcsFilterMatchAnything)) {
+        /* Rule without positive terms can match any table */
+        flecs_rule_cache_watch(a, watches, EcsWildcard, false);
+    }
+}
+
+static
+void flecs_rule_cache_append(
+    ecs_world_t *world,
+    ecs_rule_cache_t *cache,
+    const ecs_rule_t *rule,
+    ecs_iter_t *it)
+{
+    ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    int32_t i, var_count = rule->var_pub_count;
+    int32_t field_count = rule->filter.field_count;
+
+    ecs_rule_cache_result_t *result = ecs_vec_append(
+        &world->allocator, &cache->results, cache->elem_size);
+    ecs_var_t *vars = ECS_OFFSET_T(result, ecs_rule_cache_result_t);
+    ecs_id_t *ids = ECS_ELEM_T(vars, ecs_var_t, var_count);
+    ecs_entity_t *sources = ECS_ELEM_T(ids, ecs_id_t, field_count);
+    ecs_table_t **src_tables = ECS_ELEM_T(sources, ecs_entity_t, field_count);
+    int32_t *columns = ECS_ELEM_T(src_tables, ecs_table_t*, field_count);
+
+    ecs_os_memcpy_n(vars, rit->vars, ecs_var_t, var_count);
+    ecs_os_memcpy_n(ids, it->ids, ecs_id_t, field_count);
+    ecs_os_memcpy_n(sources, it->sources, ecs_entity_t, field_count);
+    ecs_os_memcpy_n(columns, it->columns, int32_t, field_count);
+
+    /* Columns of fields with a source are only valid while the source stays
+     * in the same table */
+    for (i = 0; i < field_count; i ++) {
+        src_tables[i] = NULL;
+        if (sources[i]) {
+            src_tables[i] = ecs_get_table(world, sources[i]);
+            cache->entity_refs = true;
+        }
+    }
+
+    result->entity = 0;
+    result->table_id = 0;
+    result->table_state = 0;
+
+    ecs_table_t *table = vars[0].range.table;
+    if (rit->yield_table) {
+        /* Result matches all entities in table, including entities that are
+         * added to the table after the result was cached. */
+        vars[0].range.count = 0;
+    } else if (table && vars[0].range.count) {
+        result->entity = ecs_vec_get_t(&table->data.entities, ecs_entity_t, 
+            vars[0].range.offset)[0];
+        result->table_id = table->id;
+        result->table_state = flecs_table_get_dirty_state(world, table)[0];
+        cache->entity_refs = true;
+    }
+}
+
+/* Check if results that depend on individual entities are still valid */
+static
+bool flecs_rule_cache_is_valid(
+    ecs_world_t *world,
+    const ecs_rule_t *rule,
+    const ecs_rule_cache_t *cache)
+{
+    int32_t var_count = rule->var_pub_count;
+    int32_t field_count = rule->filter.field_count;
+    int32_t r, count = ecs_vec_count(&cache->results);
+
+    for (r = 0; r < count; r ++) {
+        const ecs_rule_cache_result_t *result = ecs_vec_get(
+            &cache->results, cache->elem_size, r);
+        const ecs_var_t *vars = ECS_OFFSET_T(result, ecs_rule_cache_result_t);
+        const ecs_id_t *ids = ECS_ELEM_T(vars, ecs_var_t, var_count);
+        const ecs_entity_t *sources = ECS_ELEM_T(ids, ecs_id_t, field_count);
+        ecs_table_t **src_tables = ECS_ELEM_T(sources, ecs_entity_t, field_count);
+
+        if (result->entity) {
+            const ecs_table_range_t *range = &vars[0].range;
+            ecs_record_t *rec = flecs_entities_get(world, result->entity);
+            if (!rec || rec->table != range->table || 
+                ECS_RECORD_TO_ROW(rec->row) != range->offset)
+            {
+                return false;
+            }
+
+            /* Entity is still in table, so table is alive */
+            if (range->table->id != result->table_id || 
+                range->table->dirty_state[0] != result->table_state) 
+            {
+                return false;
+            }
+        }
+
+        int32_t i;
+        for (i = 0; i < field_count; i ++) {
+            if (sources[i] && ecs_get_table(world, sources[i]) != src_tables[i]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/* Evaluate rule and append results to cache. If a table is provided, only
+ * results for that table are added. */
+static
+void flecs_rule_cache_populate(
+    ecs_world_t *world,
+    ecs_rule_t *rule,
+    ecs_table_t *table)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+    ecs_iter_t it = flecs_rule_iter(world, rule);
+    if (table) {
+        ecs_iter_set_var_as_table(&it, 0, table);
+    }
+
+    while (ecs_rule_next_instanced(&it)) {
+        flecs_rule_cache_append(world, cache, rule, &it);
+
+        ecs_table_t *result_table = it.table;
+        if (cache->table_only && result_table) {
+            ecs_map_ensure(&cache->tables, result_table->id)[0] = 0;
+        }
+    }
+}
+
+static
+void flecs_rule_cache_update(
+    ecs_world_t *world,
+    ecs_rule_t *rule)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+
+    if (cache->dirty) {
+        ecs_vec_clear(&cache->results);
+        cache->entity_refs = false;
+        ecs_map_clear(&cache->tables);
+        ecs_vec_clear(&cache->pending);
+        cache->dirty = false;
+        flecs_rule_cache_populate(world, rule, NULL);
+        return;
+    }
+
+    int32_t i, count = ecs_vec_count(&cache->pending);
+    ecs_table_t **tables = ecs_vec_first(&cache->pending);
+    for (i = 0; i < count; i ++) {
+        flecs_rule_cache_populate(world, rule, tables[i]);
+    }
+
+    ecs_vec_clear(&cache->pending);
+}
+
+void flecs_rule_cache_init(
+    ecs_world_t *world,
+    ecs_rule_t *rule)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_rule_cache_t *cache = rule->cache = flecs_calloc_t(a, ecs_rule_cache_t);
+    int32_t field_count = rule->filter.field_count;
+
+    cache->elem_size = ECS_SIZEOF(ecs_rule_cache_result_t) + 
+        ECS_SIZEOF(ecs_var_t) * rule->var_pub_count +
+        (ECS_SIZEOF(ecs_id_t) + ECS_SIZEOF(ecs_entity_t) + 
+            ECS_SIZEOF(ecs_table_t*) + ECS_SIZEOF(int32_t)) * field_count;
+    cache->elem_size = ECS_ALIGN(cache->elem_size, ECS_SIZEOF(ecs_var_t));
+    ecs_vec_init(a, &cache->results, cache->elem_size, 0);
+    ecs_vec_init_t(a, &cache->pending, ecs_table_t*, 0);
+    ecs_vec_init_t(a, &cache->observers, ecs_entity_t, 0);
+    ecs_map_init(&cache->tables, a);
+    cache->dirty = true;
+    cache->table_only = true;
+
+    ecs_vec_t watches;
+    ecs_vec_init_t(a, &watches, ecs_rule_cache_watch_t, 0);
+    flecs_rule_cache_find_watches(world, rule, &watches);
+
+    int32_t i, count = ecs_vec_count(&watches);
+    ecs_rule_cache_watch_t *w = ecs_vec_first(&watches);
+    for (i = 0; i < count; i ++) {
+        ecs_observer_desc_t desc = {
+            .filter.terms[0] = { .id = w[i].id, .src.flags = EcsSelf },
+            .filter.flags = EcsFilterNoData,
+            .events = { EcsOnTableFill, EcsOnTableDelete },
+            .callback = flecs_rule_cache_on_event,
+            .ctx = cache
+        };
+
+        if (w[i].entity_events) {
+            desc.events[2] = EcsOnAdd;
+            desc.events[3] = EcsOnRemove;
+            cache->table_only = false;
+        }
+
+        ecs_entity_t o = ecs_observer_init(world, &desc);
+        ecs_assert(o != 0, ECS_INTERNAL_ERROR, NULL);
+        ecs_vec_append_t(a, &cache->observers, ecs_entity_t)[0] = o;
+    }
+
+    ecs_vec_fini_t(a, &watches, ecs_rule_cache_watch_t);
+
+    if (!(world->flags & EcsWorldReadonly)) {
+        flecs_rule_cache_update(world, rule);
+    }
+}
+
+void flecs_rule_cache_fini(
+    ecs_rule_t *rule)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+    if (!cache) {
+        return;
+    }
+
+    ecs_world_t *world = rule->filter.world;
+    int32_t i, count = ecs_vec_count(&cache->observers);
+    ecs_entity_t *observers = ecs_vec_first(&cache->observers);
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t o = observers[i];
+        if (!ecs_is_alive(world, o)) {
+            continue;
+        }
+
+        /* Observer may outlive the rule if its deletion is deferred */
+        ecs_observer_t *observer = ecs_poly_get(world, o, ecs_observer_t);
+        if (observer) {
+            observer->ctx = NULL;
+        }
+
+        ecs_delete(world, o);
+    }
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_fini(a, &cache->results, cache->elem_size);
+    ecs_vec_fini_t(a, &cache->pending, ecs_table_t*);
+    ecs_vec_fini_t(a, &cache->observers, ecs_entity_t);
+    ecs_map_fini(&cache->tables);
+    flecs_free_t(a, ecs_rule_cache_t, cache);
+    rule->cache = NULL;
+}
+
+const ecs_rule_cache_t* flecs_rule_cache_get(
+    const ecs_rule_t *rule)
+{
+    ecs_rule_cache_t *cache = rule->cache;
+    ecs_world_t *world = rule->filter.world;
+
+    bool valid = true;
+    if (!cache->dirty && cache->entity_refs) {
+        valid = flecs_rule_cache_is_valid(world, rule, cache);
+    }
+
+    if (!valid || cache->dirty || ecs_vec_count(&cache->pending)) {
+        if (world->flags & EcsWorldReadonly) {
+            /* Cache can't be updated while other threads can iterate it */
+            return NULL;
+        }
+
+        if (!valid) {
+            flecs_rule_cache_mark_dirty(cache);
+        }
+
+        flecs_rule_cache_update(world, ECS_CONST_CAST(ecs_rule_t*, rule));
+    }
+
+    return cache;
+}
+
+bool flecs_rule_cache_next(
+    ecs_iter_t *it)
+{
+    ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    const ecs_rule_t *rule = rit->rule;
+    const ecs_rule_cache_t *cache = rit->cache;
+    int32_t var_count = rule->var_pub_count;
+    int32_t field_count = rule->filter.field_count;
+    int32_t count = ecs_vec_count(&cache->results);
+
+    if (!(it->flags & EcsIterIsValid)) {
+        flecs_iter_validate(it);
+    }
+
+    while (true) {
+        /* Partitioned iterators claim results from the shared counter */
+        int32_t cur = rit->claimed ? 
+            (ecs_os_ainc(rit->claimed) - 1) : rit->cache_cur ++;
+        if (cur >= count) {
+            break;
+        }
+
+        const ecs_rule_cache_result_t *result = ecs_vec_get(
+            &cache->results, cache->elem_size, cur);
+        const ecs_var_t *vars = ECS_OFFSET_T(result, ecs_rule_cache_result_t);
+        ecs_table_range_t range = vars[0].range;
+        ecs_table_t *table = range.table;
+        if (table && !range.count) {
+            range.count = ecs_table_count(table);
+            if (!range.count) {
+                continue; /* Don't yield empty tables */
+            }
+        }
+
+        const ecs_id_t *ids = ECS_ELEM_T(vars, ecs_var_t, var_count);
+        const ecs_entity_t *sources = ECS_ELEM_T(ids, ecs_id_t, field_count);
+        ecs_table_t **src_tables = ECS_ELEM_T(sources, ecs_entity_t, field_count);
+        const int32_t *columns = ECS_ELEM_T(src_tables, ecs_table_t*, field_count);
+
+        ecs_os_memcpy_n(rit->vars, vars, ecs_var_t, var_count);
+        ecs_os_memcpy_n(it->ids, ids, ecs_id_t, field_count);
+        ecs_os_memcpy_n(it->sources, sources, ecs_entity_t, field_count);
+        ecs_os_memcpy_n(it->columns, columns, int32_t, field_count);
+        rit->vars[0].range.count = range.count;
+
+        flecs_iter_populate_data(it->real_world, it, table, range.offset,
+            range.count, it->ptrs);
+        if (!table && range.count == 1) {
+            it->count = 1;
+            it->entities = &rit->vars[0].entity;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+#endif
@@ -15,6 +15,7 @@ static bool flecs_rule_op_is_test[] = {
     [EcsRuleAndId] = true,
     [EcsRuleWith] = true,
     [EcsRuleTrav] = true,
+    [EcsRuleJoin] = true,
     [EcsRuleContain] = true,
     [EcsRulePairEq] = true,
     [EcsRuleLookup] = true,
@@ -41,9 +42,8 @@ ecs_var_id_t flecs_utovar(uint64_t val) {
 #define flecs_set_var_label(var, lbl)
 #endif
 
-static
 bool flecs_rule_is_builtin_pred(
-    ecs_term_t *term)
+    const ecs_term_t *term)
 {
     if (term->first.flags & EcsIsEntity) {
         ecs_entity_t id = term->first.id;
@@ -1365,19 +1365,21 @@ int flecs_rule_compile_term(
     ecs_world_t *world,
     ecs_rule_t *rule,
     ecs_term_t *term,
+    ecs_term_t *prev,
+    int32_t est,
     ecs_rule_compile_ctx_t *ctx)
 {
-    bool first_term = term == rule->filter.terms;
+    bool first_term = prev == NULL;
     bool first_is_var = term->first.flags & EcsIsVariable;
     bool second_is_var = term->second.flags & EcsIsVariable;
     bool src_is_var = term->src.flags & EcsIsVariable;
     bool builtin_pred = flecs_rule_is_builtin_pred(term);
     bool is_not = (term->oper == EcsNot) && !builtin_pred;
-    bool is_or = (term->oper == EcsOr) || (!first_term && term[-1].oper == EcsOr);
+    bool is_or = (term->oper == EcsOr) || (!first_term && prev->oper == EcsOr);
     bool cond_write = term->oper == EcsOptional || is_or;
     ecs_rule_op_t op = {0};
 
-    if (is_or && (first_term || term[-1].oper != EcsOr)) {
+    if (is_or && (first_term || prev->oper != EcsOr)) {
         ctx->ctrlflow->cond_written_or = ctx->cond_written;
         ctx->ctrlflow->in_or = true;
     }
@@ -1408,6 +1410,7 @@ int flecs_rule_compile_term(
     op.kind = src_is_var ? EcsRuleAnd : EcsRuleWith;
     op.field_index = flecs_ito(int8_t, term->field_index);
     op.term_index = flecs_ito(int8_t, term - rule->filter.terms);
+    op.est = est;
 
     /* If rule is transitive, use Trav(ersal) instruction */
     if (term->flags & EcsTermTransitive) {
@@ -1562,8 +1565,8 @@ int flecs_rule_compile_term(
 
     /* If previous term was ScopeOpen with a Not operator, insert operation to
      * ensure that none of the results inside the scope should match. */
-    if (!first_term && term[-1].first.id == EcsScopeOpen) {
-        if (term[-1].oper == EcsNot) {
+    if (!first_term && prev->first.id == EcsScopeOpen) {
+        if (prev->oper == EcsNot) {
             flecs_rule_begin_none(ctx);
             flecs_rule_begin_not(ctx);
         }
@@ -1576,7 +1579,7 @@ int flecs_rule_compile_term(
     } else if (term->oper == EcsOptional) {
         flecs_rule_begin_option(ctx);
     } else if (term->oper == EcsOr) {
-        if (first_term || term[-1].oper != EcsOr) {
+        if (first_term || prev->oper != EcsOr) {
             if (!src_written) {
                 flecs_rule_begin_union(ctx);
             }
@@ -1661,7 +1664,7 @@ int flecs_rule_compile_term(
         if (ctx->cur->lbl_union != -1) {
             flecs_rule_next_or(ctx);
         } else {
-            if (first_term || term[-1].oper != EcsOr) {
+            if (first_term || prev->oper != EcsOr) {
                 if (ctx->cur->lbl_union == -1) {
                     flecs_rule_begin_or(ctx, lbl_start);
                 }
@@ -1670,7 +1673,7 @@ int flecs_rule_compile_term(
             }
         }
     } else if (term->oper == EcsAnd) {
-        if (!first_term && term[-1].oper == EcsOr) {
+        if (!first_term && prev->oper == EcsOr) {
             if (ctx->cur->lbl_union != -1) {
                 flecs_rule_end_union(ctx);
             } else {
@@ -1684,6 +1687,576 @@ error:
     return -1;
 }
 
+/* Canonical id of variable used by term id. Table and entity variables with
+ * the same name are the same variable for the planner. */
+static
+ecs_var_id_t flecs_rule_plan_var(
+    ecs_rule_t *rule,
+    ecs_term_id_t *term_id)
+{
+    if (flecs_term_id_is_wildcard(term_id)) {
+        return EcsVarNone;
+    }
+
+    const char *name = flecs_term_id_var_name(term_id);
+    if (!name) {
+        return EcsVarNone;
+    }
+
+    ecs_var_id_t var_id = flecs_rule_find_var_id(rule, name, EcsVarEntity);
+    if (var_id == EcsVarNone) {
+        var_id = flecs_rule_find_var_id(rule, name, EcsVarTable);
+    }
+    return var_id;
+}
+
+/* Variables used by term */
+static
+ecs_write_flags_t flecs_rule_plan_term_vars(
+    ecs_rule_t *rule,
+    ecs_term_t *term)
+{
+    ecs_write_flags_t result = 0;
+    ecs_var_id_t var_id;
+    if ((var_id = flecs_rule_plan_var(rule, &term->src)) != EcsVarNone) {
+        result |= (1ull << var_id);
+    }
+    if ((var_id = flecs_rule_plan_var(rule, &term->first)) != EcsVarNone) {
+        result |= (1ull << var_id);
+    }
+    if ((var_id = flecs_rule_plan_var(rule, &term->second)) != EcsVarNone) {
+        result |= (1ull << var_id);
+    }
+    return result;
+}
+
+/* Can the term be evaluated in a different position. Only plain And terms can
+ * be moved. Operators, scopes, predicates, lookups and transitive terms depend
+ * on the terms around them and keep their position. */
+static
+bool flecs_rule_plan_is_movable(
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    ecs_term_t *prev)
+{
+    if (term->oper != EcsAnd) {
+        return false;
+    }
+
+    /* Last term of an Or chain, first term of a scope */
+    if (prev && (prev->oper == EcsOr || prev->first.id == EcsScopeOpen)) {
+        return false;
+    }
+
+    /* Scope open/close */
+    if (!term->src.id && (term->src.flags & EcsIsEntity)) {
+        return false;
+    }
+
+    if (flecs_rule_is_builtin_pred(term)) {
+        return false;
+    }
+
+    if (term->flags & (EcsTermTransitive|EcsTermIdInherited|
+        EcsTermMatchAny|EcsTermMatchAnySrc)) 
+    {
+        return false;
+    }
+
+    ecs_term_id_t *ids[] = { &term->src, &term->first, &term->second };
+    int32_t i;
+    for (i = 0; i < 3; i ++) {
+        ecs_var_id_t var_id = flecs_rule_plan_var(rule, ids[i]);
+        if (var_id != EcsVarNone && rule->vars[var_id].lookup) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Can the term be evaluated after the terms that wrote the variables in 
+ * 'written'. A term with a source variable that has not been written yet
+ * writes the variable as table variable. Table variables are created for the
+ * order in which terms were written, so a term can't be evaluated before its
+ * source is written if no table variable exists for the source. */
+static
+bool flecs_rule_plan_can_eval(
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    ecs_write_flags_t written)
+{
+    ecs_var_id_t src_var = flecs_rule_plan_var(rule, &term->src);
+    if (src_var == EcsVarNone || flecs_rule_is_written(src_var, written)) {
+        return true;
+    }
+
+    const char *name = flecs_term_id_var_name(&term->src);
+    return flecs_rule_find_var_id(rule, name, EcsVarTable) != EcsVarNone;
+}
+
+/* Number of records in a list of pair id records, which is the number of 
+ * distinct relationships or targets for a wildcard pair. */
+static
+int32_t flecs_rule_plan_pair_count(
+    const ecs_id_record_t *idr,
+    bool second)
+{
+    int32_t result = 0;
+    const ecs_id_record_t *cur = second ? idr->second.next : idr->first.next;
+    while (cur) {
+        result ++;
+        cur = second ? cur->second.next : cur->first.next;
+    }
+    return result;
+}
+
+/* Estimate the number of results a term produces when it is evaluated after
+ * terms that wrote the variables in 'written'. Terms with a source that is not
+ * known yet produce the number of entities that have the id. Terms with a known
+ * source produce the average number of ids per table that match the term. The
+ * estimate is based on the entity and table counts of the id index at the time
+ * the rule is created. */
+static
+int32_t flecs_rule_plan_estimate(
+    const ecs_world_t *world,
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    ecs_write_flags_t written)
+{
+    ecs_var_id_t src_var = flecs_rule_plan_var(rule, &term->src);
+    ecs_var_id_t first_var = flecs_rule_plan_var(rule, &term->first);
+    ecs_var_id_t second_var = flecs_rule_plan_var(rule, &term->second);
+    bool has_second = ecs_term_id_is_set(&term->second);
+    bool first_wildcard = term->first.flags & EcsIsVariable;
+    bool second_wildcard = has_second && (term->second.flags & EcsIsVariable);
+    bool first_written = first_var != EcsVarNone && 
+        flecs_rule_is_written(first_var, written);
+    bool second_written = second_var != EcsVarNone && 
+        flecs_rule_is_written(second_var, written);
+
+    ecs_entity_t first = first_wildcard ? EcsWildcard : term->first.id;
+    ecs_id_t id = first;
+    if (has_second) {
+        ecs_entity_t second = second_wildcard ? EcsWildcard : term->second.id;
+        id = ecs_pair(first, second);
+    }
+
+    ecs_id_record_t *idr = flecs_query_id_record_get(world, id);
+    if (!idr) {
+        return 0;
+    }
+
+    int64_t entity_count = 0, id_count = 0, table_count = 0;
+    /* Iterate all tables, as the empty state of tables may not be up to date */
+    ecs_table_cache_iter_t it;
+    if (flecs_table_cache_all_iter(&idr->cache, &it)) {
+        const ecs_table_record_t *tr;
+        while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+            int32_t table_entities = ecs_table_count(tr->hdr.table);
+            if (table_entities) {
+                entity_count += table_entities;
+                id_count += tr->count;
+                table_count ++;
+            }
+        }
+    }
+
+    bool src_known = !(term->src.flags & EcsIsVariable) || 
+        (src_var != EcsVarNone && flecs_rule_is_written(src_var, written));
+    if (src_known) {
+        /* Test against known source. If the id has unknown parts, each matching
+         * id in the table is a result. */
+        bool unknown = (first_wildcard && !first_written) || 
+            (second_wildcard && !second_written);
+        if (!unknown || !table_count) {
+            return table_count ? 1 : 0;
+        }
+        return (int32_t)((id_count + table_count - 1) / table_count);
+    }
+
+    /* Find entities for id. Parts of the id that are known reduce the number
+     * of results by the number of distinct values for that part. */
+    if (has_second && id_count) {
+        int32_t div = 1;
+        if (second_wildcard && second_written && !first_wildcard) {
+            div = flecs_rule_plan_pair_count(idr, false);
+        } else if (first_wildcard && first_written && !second_wildcard) {
+            div = flecs_rule_plan_pair_count(idr, true);
+        }
+        if (div > 1) {
+            entity_count = (entity_count + div - 1) / div;
+        }
+    }
+
+    if (entity_count > INT32_MAX) {
+        entity_count = INT32_MAX;
+    }
+
+    return (int32_t)entity_count;
+}
+
+/* Determine the order in which terms are compiled. Consecutive terms that can
+ * be moved are greedily ordered by estimated number of results, so that the
+ * most selective term is evaluated first and intermediate results stay small.
+ * Ties keep the order in which the terms were written. */
+static
+void flecs_rule_plan(
+    const ecs_world_t *world,
+    ecs_rule_t *rule,
+    int32_t *order,
+    int32_t *est)
+{
+    ecs_filter_t *filter = &rule->filter;
+    ecs_term_t *terms = filter->terms;
+    ecs_write_flags_t written = 0;
+    int32_t i = 0, n = 0, count = filter->term_count;
+
+    while (i < count) {
+        ecs_term_t *prev = i ? &terms[i - 1] : NULL;
+        if (!flecs_rule_plan_is_movable(rule, &terms[i], prev)) {
+            est[n] = flecs_rule_plan_estimate(world, rule, &terms[i], written);
+            order[n ++] = i;
+            if (terms[i].oper != EcsNot) {
+                written |= flecs_rule_plan_term_vars(rule, &terms[i]);
+            }
+            i ++;
+            continue;
+        }
+
+        /* Find end of run of terms that can be moved */
+        int32_t end = i + 1;
+        while (end < count && 
+            flecs_rule_plan_is_movable(rule, &terms[end], &terms[end - 1])) 
+        {
+            end ++;
+        }
+
+        int32_t run_start = n, j, k;
+        for (j = i; j < end; j ++) {
+            order[n ++] = j;
+        }
+
+        for (j = run_start; j < n; j ++) {
+            int32_t best = -1, best_est = 0;
+            for (k = j; k < n; k ++) {
+                ecs_term_t *term = &terms[order[k]];
+                if (!flecs_rule_plan_can_eval(rule, term, written)) {
+                    continue;
+                }
+                int32_t cur_est = flecs_rule_plan_estimate(
+                    world, rule, term, written);
+                if (best == -1 || cur_est < best_est) {
+                    best = k;
+                    best_est = cur_est;
+                }
+            }
+
+            /* The first remaining term in the written order can always be
+             * evaluated, as all terms before it have been planned. */
+            ecs_assert(best != -1, ECS_INTERNAL_ERROR, NULL);
+
+            /* Move best term to current position, keep order of others */
+            int32_t best_term = order[best];
+            for (k = best; k > j; k --) {
+                order[k] = order[k - 1];
+            }
+            order[j] = best_term;
+            est[j] = best_est;
+            written |= flecs_rule_plan_term_vars(rule, &terms[best_term]);
+        }
+
+        i = end;
+    }
+}
+
+
+/* Minimum ratio between the estimated cost of a nested loop join and a hash
+ * join for the compiler to insert a hash join. */
+#define FlecsRuleJoinCostFactor (2.0)
+
+/* Get entity variable for variable term id that can be used as join key. 
+ * Returns EcsVarNone if the variable is not written before the join. */
+static
+ecs_var_id_t flecs_rule_join_key_var(
+    ecs_rule_t *rule,
+    ecs_term_id_t *term_id,
+    const char *src_name,
+    ecs_write_flags_t written)
+{
+    const char *name = flecs_term_id_var_name(term_id);
+    if (!name || flecs_term_id_is_wildcard(term_id) || !ecs_os_strcmp(name, src_name)) {
+        return EcsVarNone;
+    }
+
+    ecs_var_id_t var_id = flecs_rule_find_var_id(rule, name, EcsVarEntity);
+    if (var_id == EcsVarNone) {
+        return EcsVarNone;
+    }
+
+    ecs_rule_var_t *var = &rule->vars[var_id];
+    if (var->lookup) {
+        return EcsVarNone;
+    }
+
+    if (flecs_rule_is_written(var_id, written)) {
+        return var_id;
+    }
+
+    if (var->table_id != EcsVarNone && 
+        flecs_rule_is_written(var->table_id, written)) 
+    {
+        return var_id;
+    }
+
+    return EcsVarNone;
+}
+
+/* Can term be evaluated by a hash join on source with variable 'src_name' */
+static
+bool flecs_rule_join_term_is_valid(
+    ecs_rule_t *rule,
+    ecs_term_t *term,
+    const char *src_name,
+    ecs_write_flags_t written)
+{
+    ecs_term_t *prev = NULL;
+    if (term != rule->filter.terms) {
+        prev = &term[-1];
+    }
+
+    if (!flecs_rule_plan_is_movable(rule, term, prev)) {
+        return false;
+    }
+
+    const char *name = flecs_term_id_var_name(&term->src);
+    if (!name || ecs_os_strcmp(name, src_name)) {
+        return false;
+    }
+
+    bool has_second = ecs_term_id_is_set(&term->second);
+    if (term->first.flags & EcsIsVariable) {
+        /* A variable relationship can't be matched without a target */
+        if (!has_second || flecs_rule_join_key_var(
+            rule, &term->first, src_name, written) == EcsVarNone) 
+        {
+            return false;
+        }
+    }
+
+    if (has_second && (term->second.flags & EcsIsVariable)) {
+        if (flecs_rule_join_key_var(
+            rule, &term->second, src_name, written) == EcsVarNone) 
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Find run of terms starting at order[i] that should be evaluated with a hash 
+ * join. A run contains terms with the same source variable that hasn't been
+ * written yet, where the other variables of the terms are written by earlier 
+ * terms. Without a hash join, the terms in the run are evaluated for each 
+ * result of the earlier terms, which is expensive if the run matches many 
+ * tables. A run with a single term isn't joined, as the id index can already
+ * find the tables for the term when its variables are known.
+ * Returns the number of terms in the run, or 0 if no hash join is used. */
+static
+int32_t flecs_rule_join_find_run(
+    const ecs_world_t *world,
+    ecs_rule_t *rule,
+    const int32_t *order,
+    const int32_t *est,
+    int32_t i,
+    ecs_rule_compile_ctx_t *ctx)
+{
+    ecs_filter_t *filter = &rule->filter;
+    ecs_term_t *terms = filter->terms;
+    int32_t count = filter->term_count;
+
+    if (!i || ctx->scope || ctx->cond_written) {
+        return 0;
+    }
+
+    ecs_term_t *prev = &terms[order[i - 1]];
+    if (prev->oper == EcsOr || prev->first.id == EcsScopeOpen) {
+        return 0;
+    }
+
+    ecs_term_t *term = &terms[order[i]];
+    if (!(term->src.flags & EcsIsVariable)) {
+        return 0;
+    }
+
+    const char *src_name = flecs_term_id_var_name(&term->src);
+    if (!src_name || flecs_term_id_is_wildcard(&term->src)) {
+        return 0;
+    }
+
+    /* Source must be found by the join */
+    ecs_var_id_t tvar = flecs_rule_find_var_id(rule, src_name, EcsVarTable);
+    ecs_var_id_t evar = flecs_rule_find_var_id(rule, src_name, EcsVarEntity);
+    if (tvar == EcsVarNone || flecs_rule_is_written(tvar, ctx->written)) {
+        return 0;
+    }
+    if (evar != EcsVarNone && flecs_rule_is_written(evar, ctx->written)) {
+        return 0;
+    }
+
+    ecs_write_flags_t keys = 0;
+    int32_t n = 0;
+    while ((i + n) < count && n < EcsRuleJoinMaxTerms) {
+        ecs_term_t *cur = &terms[order[i + n]];
+        if (!flecs_rule_join_term_is_valid(rule, cur, src_name, ctx->written)) {
+            break;
+        }
+
+        ecs_write_flags_t cur_keys = keys, bits;
+        ecs_var_id_t key;
+        if ((key = flecs_rule_join_key_var(
+            rule, &cur->first, src_name, ctx->written)) != EcsVarNone) 
+        {
+            cur_keys |= 1ull << key;
+        }
+        if ((key = flecs_rule_join_key_var(
+            rule, &cur->second, src_name, ctx->written)) != EcsVarNone) 
+        {
+            cur_keys |= 1ull << key;
+        }
+
+        int32_t key_count = 0;
+        for (bits = cur_keys; bits; bits &= bits - 1) {
+            key_count ++;
+        }
+        if (key_count > EcsRuleJoinMaxKeys) {
+            break;
+        }
+
+        keys = cur_keys;
+        n ++;
+    }
+
+    if (n < 2 || !keys) {
+        return 0;
+    }
+
+    /* Nested loop evaluates the first term of the run for each result of the
+     * earlier terms. A hash join matches the first term once against all 
+     * tables, and does a lookup for each result of the earlier terms. */
+    double outer = 1;
+    int32_t j;
+    for (j = 0; j < i; j ++) {
+        outer *= (double)est[j];
+    }
+
+    double nested = outer * (double)est[i];
+    double build = (double)flecs_rule_plan_estimate(world, rule, term, 0);
+    if (nested <= FlecsRuleJoinCostFactor * (build + outer)) {
+        return 0;
+    }
+
+    return n;
+}
+
+/* Set join term element to entity or key variable */
+static
+void flecs_rule_join_term_id(
+    ecs_rule_t *rule,
+    ecs_rule_join_t *join,
+    ecs_term_id_t *term_id,
+    ecs_rule_ref_t *ref,
+    int8_t *key,
+    ecs_flags8_t ref_kind,
+    ecs_flags8_t *flags,
+    ecs_rule_compile_ctx_t *ctx)
+{
+    *key = -1;
+
+    if (!ecs_term_id_is_set(term_id)) {
+        return;
+    }
+
+    if (!(term_id->flags & EcsIsVariable)) {
+        *flags |= (ecs_flags8_t)(EcsRuleIsEntity << ref_kind);
+        ref->entity = term_id->id;
+        return;
+    }
+
+    const char *name = flecs_term_id_var_name(term_id);
+    ecs_var_id_t var_id = flecs_rule_find_var_id(rule, name, EcsVarEntity);
+    ecs_assert(var_id != EcsVarNone, ECS_INTERNAL_ERROR, NULL);
+    if (!flecs_rule_is_written(var_id, ctx->written)) {
+        /* Key variable was written as table, get entity from table */
+        flecs_rule_insert_each(
+            rule->vars[var_id].table_id, var_id, ctx, false);
+    }
+
+    *flags |= (ecs_flags8_t)(EcsRuleIsVar << ref_kind);
+    ref->var = var_id;
+
+    int8_t k;
+    for (k = 0; k < join->key_count; k ++) {
+        if (join->keys[k] == var_id) {
+            break;
+        }
+    }
+
+    if (k == join->key_count) {
+        ecs_assert(k < EcsRuleJoinMaxKeys, ECS_INTERNAL_ERROR, NULL);
+        join->keys[join->key_count ++] = var_id;
+    }
+
+    *key = k;
+}
+
+/* Insert hash join operation for run of terms */
+static
+void flecs_rule_compile_join(
+    ecs_rule_t *rule,
+    ecs_term_t **terms,
+    int32_t term_count,
+    int32_t est,
+    ecs_rule_compile_ctx_t *ctx)
+{
+    ecs_rule_join_t *join = ecs_vec_append_t(
+        NULL, &ctx->joins, ecs_rule_join_t);
+    ecs_os_zeromem(join);
+
+    int32_t i;
+    for (i = 0; i < term_count; i ++) {
+        ecs_term_t *term = terms[i];
+        ecs_rule_join_term_t *jterm = &join->terms[i];
+        jterm->field_index = flecs_ito(int8_t, term->field_index);
+        flecs_rule_join_term_id(rule, join, &term->first, &jterm->first,
+            &jterm->first_key, EcsRuleFirst, &jterm->flags, ctx);
+        flecs_rule_join_term_id(rule, join, &term->second, &jterm->second,
+            &jterm->second_key, EcsRuleSecond, &jterm->flags, ctx);
+    }
+
+    join->term_count = flecs_ito(int8_t, term_count);
+    join->entry_size = ECS_SIZEOF(ecs_table_t*) + ECS_SIZEOF(int32_t) * 2 +
+        ECS_SIZEOF(ecs_entity_t) * join->key_count + 
+        (ECS_SIZEOF(ecs_id_t) + ECS_SIZEOF(int32_t)) * term_count;
+    join->entry_size = ECS_ALIGN(join->entry_size, ECS_SIZEOF(ecs_id_t));
+
+    const char *src_name = flecs_term_id_var_name(&terms[0]->src);
+    ecs_var_id_t tvar = flecs_rule_find_var_id(rule, src_name, EcsVarTable);
+
+    ecs_rule_op_t op = {0};
+    op.kind = EcsRuleJoin;
+    op.field_index = flecs_ito(int8_t, terms[0]->field_index);
+    op.term_index = flecs_ito(int8_t, terms[0] - rule->filter.terms);
+    op.other = flecs_itolbl(ecs_vec_count(&ctx->joins) - 1);
+    op.est = est;
+    op.flags = (EcsRuleIsVar << EcsRuleSrc);
+    op.src.var = tvar;
+    flecs_rule_write(tvar, &op.written);
+    flecs_rule_op_insert(&op, ctx);
+    flecs_rule_write_ctx(tvar, ctx, false);
+}
+
 int flecs_rule_compile(
     ecs_world_t *world,
     ecs_stage_t *stage,
@@ -1702,6 +2275,7 @@ int flecs_rule_compile(
     ctx.cur->lbl_or = -1;
     ctx.cur->lbl_union = -1;
     ecs_vec_clear(ctx.ops);
+    ecs_vec_init_t(NULL, &ctx.joins, ecs_rule_join_t, 0);
 
     /* Find all variables defined in query */
     flecs_rule_discover_vars(stage, rule);
@@ -1731,14 +2305,43 @@ int flecs_rule_compile(
         }
     }
 
-    /* Compile query terms to instructions */
+    /* Compile query terms to instructions, in the order picked by planner */
+    int32_t *order = NULL, *est = NULL;
+    if (count) {
+        order = ecs_os_malloc_n(int32_t, count * 2);
+        est = &order[count];
+        flecs_rule_plan(world, rule, order, est);
+    }
+
+    ecs_term_t *prev = NULL;
     for (i = 0; i < count; i ++) {
-        ecs_term_t *term = &terms[i];
-        if (flecs_rule_compile_term(world, rule, term, &ctx)) {
+        ecs_term_t *term = &terms[order[i]];
+
+        /* Check if terms should be evaluated with a hash join */
+        int32_t join_count = flecs_rule_join_find_run(
+            world, rule, order, est, i, &ctx);
+        if (join_count) {
+            ecs_term_t *join_terms[EcsRuleJoinMaxTerms];
+            int32_t j;
+            for (j = 0; j < join_count; j ++) {
+                join_terms[j] = &terms[order[i + j]];
+            }
+            flecs_rule_compile_join(rule, join_terms, join_count, est[i], &ctx);
+            i += join_count - 1;
+            prev = join_terms[join_count - 1];
+            continue;
+        }
+
+        if (flecs_rule_compile_term(world, rule, term, prev, est[i], &ctx)) {
+            ecs_os_free(order);
+            ecs_vec_fini_t(NULL, &ctx.joins, ecs_rule_join_t);
             return -1;
         }
+        prev = term;
     }
 
+    ecs_os_free(order);
+
     /* If This variable has been written as entity, insert an operation to 
      * assign it to it.entities for consistency. */
     ecs_var_id_t this_id = flecs_rule_find_var_id(rule, "This", EcsVarEntity);
@@ -1842,6 +2445,14 @@ int flecs_rule_compile(
         ecs_os_memcpy_n(rule->ops, rule_ops, ecs_rule_op_t, op_count);
     }
 
+    int32_t join_count = ecs_vec_count(&ctx.joins);
+    if (join_count) {
+        rule->join_count = join_count;
+        rule->joins = ecs_os_memdup_n(
+            ecs_vec_first(&ctx.joins), ecs_rule_join_t, join_count);
+    }
+    ecs_vec_fini_t(NULL, &ctx.joins, ecs_rule_join_t);
+
     return 0;
 }
 
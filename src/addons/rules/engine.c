@@ -372,6 +372,27 @@ void flecs_rule_set_trav_match(
     flecs_rule_set_vars(op, matched, ctx);
 }
 
+/* Test if the next table of the partitioned operation is skipped because it
+ * was claimed by another iterator. Iterators that share a counter visit the
+ * tables of the operation in the same order. An iterator claims an index when
+ * it has passed its previous claim, and skips tables until it reaches it. */
+static
+bool flecs_rule_part_skip(
+    const ecs_rule_run_ctx_t *ctx)
+{
+    ecs_rule_iter_t *rit = &ctx->it->priv.iter.rule;
+    if (!rit->claimed || ctx->op_index != rit->part_op) {
+        return false;
+    }
+
+    int32_t index = rit->part_index ++;
+    if (rit->claim < index) {
+        rit->claim = ecs_os_ainc(rit->claimed) - 1;
+    }
+
+    return rit->claim != index;
+}
+
 static
 bool flecs_rule_select_w_id(
     const ecs_rule_op_t *op,
@@ -398,10 +419,12 @@ bool flecs_rule_select_w_id(
     }
 
     if (!redo || !op_ctx->remaining) {
-        tr = flecs_table_cache_next(&op_ctx->it, ecs_table_record_t);
-        if (!tr) {
-            return false;
-        }
+        do {
+            tr = flecs_table_cache_next(&op_ctx->it, ecs_table_record_t);
+            if (!tr) {
+                return false;
+            }
+        } while (flecs_rule_part_skip(ctx));
 
         op_ctx->column = flecs_ito(int16_t, tr->index);
         op_ctx->remaining = flecs_ito(int16_t, tr->count - 1);
@@ -516,11 +539,13 @@ bool flecs_rule_select_id(
         }
     }
 
-    const ecs_table_record_t *tr = flecs_table_cache_next(
-        &op_ctx->it, ecs_table_record_t);
-    if (!tr) {
-        return false;
-    }
+    const ecs_table_record_t *tr;
+    do {
+        tr = flecs_table_cache_next(&op_ctx->it, ecs_table_record_t);
+        if (!tr) {
+            return false;
+        }
+    } while (flecs_rule_part_skip(ctx));
 
     ecs_table_t *table = tr->hdr.table;
     flecs_rule_var_set_table(op, op->src.var, table, 0, 0, ctx);
@@ -618,6 +643,257 @@ bool flecs_rule_and_any(
     return result;
 }
 
+/* Header of hash join entry. The header is followed by the key values, and the
+ * matched ids and columns for each term. */
+typedef struct {
+    ecs_table_t *table;        /* Table matched by terms */
+    int32_t next;              /* Next entry with same hash, or -1 */
+    int32_t padding;
+} ecs_rule_join_entry_t;
+
+#define flecs_rule_join_keys(entry)\
+    ECS_OFFSET_T(entry, ecs_rule_join_entry_t)
+#define flecs_rule_join_ids(join, entry)\
+    ECS_ELEM_T(flecs_rule_join_keys(entry), ecs_entity_t, (join)->key_count)
+#define flecs_rule_join_columns(join, entry)\
+    ECS_ELEM_T(flecs_rule_join_ids(join, entry), ecs_id_t, (join)->term_count)
+
+/* Get id for join term element. Elements that use a key that isn't known yet
+ * are returned as wildcard. */
+static
+ecs_entity_t flecs_rule_join_entry_elem(
+    const ecs_rule_join_term_t *term,
+    const ecs_rule_ref_t *ref,
+    int8_t key,
+    ecs_flags16_t ref_kind,
+    const ecs_entity_t *keys)
+{
+    ecs_flags16_t flags = flecs_rule_ref_flags(term->flags, ref_kind);
+    if (flags & EcsRuleIsEntity) {
+        return ref->entity;
+    }
+
+    ecs_assert(key != -1, ECS_INTERNAL_ERROR, NULL);
+    if (keys[key]) {
+        return keys[key];
+    }
+
+    return EcsWildcard;
+}
+
+static
+ecs_id_t flecs_rule_join_entry_id(
+    const ecs_rule_join_term_t *term,
+    const ecs_entity_t *keys)
+{
+    ecs_entity_t first = flecs_rule_join_entry_elem(term, &term->first, 
+        term->first_key, EcsRuleFirst, keys);
+    if (!flecs_rule_ref_flags(term->flags, EcsRuleSecond)) {
+        return first;
+    }
+
+    ecs_entity_t second = flecs_rule_join_entry_elem(term, &term->second, 
+        term->second_key, EcsRuleSecond, keys);
+    return ecs_pair(first, second);
+}
+
+/* Set key from matched id, returns false if key already has different value */
+static
+bool flecs_rule_join_set_key(
+    ecs_entity_t *keys,
+    int8_t key,
+    ecs_entity_t value)
+{
+    if (key == -1) {
+        return true;
+    }
+    if (keys[key] && keys[key] != value) {
+        return false;
+    }
+    keys[key] = value;
+    return true;
+}
+
+static
+uint64_t flecs_rule_join_hash(
+    const ecs_rule_join_t *join,
+    const ecs_entity_t *keys)
+{
+    return flecs_hash(keys, ECS_SIZEOF(ecs_entity_t) * join->key_count);
+}
+
+/* Match join terms starting at term_index against table, and add an entry to
+ * the hash table for each combination of keys that matches all terms. */
+static
+void flecs_rule_join_build_table(
+    const ecs_rule_join_t *join,
+    ecs_rule_join_ctx_t *op_ctx,
+    ecs_allocator_t *a,
+    const ecs_world_t *world,
+    ecs_table_t *table,
+    int32_t term_index,
+    ecs_entity_t *keys,
+    ecs_id_t *ids,
+    int32_t *columns)
+{
+    if (term_index == join->term_count) {
+        ecs_rule_join_entry_t *entry = ecs_vec_append(
+            a, &op_ctx->entries, join->entry_size);
+        int32_t index = ecs_vec_count(&op_ctx->entries) - 1;
+        entry->table = table;
+        ecs_os_memcpy_n(flecs_rule_join_keys(entry), keys, 
+            ecs_entity_t, join->key_count);
+        ecs_os_memcpy_n(flecs_rule_join_ids(join, entry), ids, 
+            ecs_id_t, join->term_count);
+        ecs_os_memcpy_n(flecs_rule_join_columns(join, entry), columns, 
+            int32_t, join->term_count);
+
+        ecs_map_val_t *head = ecs_map_ensure(
+            &op_ctx->index, flecs_rule_join_hash(join, keys));
+        entry->next = flecs_uto(int32_t, head[0]) - 1;
+        head[0] = flecs_ito(uint64_t, index + 1);
+        return;
+    }
+
+    const ecs_rule_join_term_t *term = &join->terms[term_index];
+    ecs_id_t id = flecs_rule_join_entry_id(term, keys), matched;
+    ecs_entity_t prev_keys[EcsRuleJoinMaxKeys];
+    ecs_os_memcpy_n(prev_keys, keys, ecs_entity_t, join->key_count);
+
+    int32_t column = -1;
+    while ((column = ecs_search_offset(
+        world, table, column + 1, id, &matched)) != -1)
+    {
+        bool valid = true;
+        if (ECS_IS_PAIR(matched)) {
+            valid = flecs_rule_join_set_key(keys, term->first_key, 
+                ecs_pair_first(world, matched));
+            valid = valid && flecs_rule_join_set_key(keys, term->second_key, 
+                ecs_pair_second(world, matched));
+        }
+
+        if (valid) {
+            ids[term_index] = matched;
+            columns[term_index] = column;
+            flecs_rule_join_build_table(join, op_ctx, a, world, table, 
+                term_index + 1, keys, ids, columns);
+        }
+
+        ecs_os_memcpy_n(keys, prev_keys, ecs_entity_t, join->key_count);
+    }
+}
+
+/* Build hash table with all tables that match the join terms */
+static
+void flecs_rule_join_build(
+    const ecs_rule_join_t *join,
+    ecs_rule_join_ctx_t *op_ctx,
+    const ecs_rule_run_ctx_t *ctx)
+{
+    ecs_allocator_t *a = flecs_rule_get_allocator(ctx->it);
+    ecs_map_init(&op_ctx->index, a);
+    ecs_vec_init(a, &op_ctx->entries, join->entry_size, 0);
+    op_ctx->built = true;
+
+    ecs_entity_t keys[EcsRuleJoinMaxKeys] = {0};
+    ecs_id_t ids[EcsRuleJoinMaxTerms];
+    int32_t columns[EcsRuleJoinMaxTerms];
+
+    /* Find tables for first term with unknown keys */
+    ecs_id_t id = flecs_rule_join_entry_id(&join->terms[0], keys);
+    ecs_id_record_t *idr = flecs_id_record_get(ctx->world, id);
+    if (!idr) {
+        return;
+    }
+
+    ecs_table_cache_iter_t it;
+    if (!flecs_table_cache_iter(&idr->cache, &it)) {
+        return;
+    }
+
+    const ecs_table_record_t *tr;
+    while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+        flecs_rule_join_build_table(join, op_ctx, a, ctx->world, 
+            tr->hdr.table, 0, keys, ids, columns);
+    }
+}
+
+static
+bool flecs_rule_join(
+    const ecs_rule_op_t *op,
+    bool redo,
+    const ecs_rule_run_ctx_t *ctx)
+{
+    ecs_rule_join_ctx_t *op_ctx = flecs_op_ctx(ctx, join);
+    const ecs_rule_join_t *join = &ctx->rule->joins[op->other];
+    ecs_entity_t keys[EcsRuleJoinMaxKeys];
+    int32_t i, key_count = join->key_count;
+
+    if (!op_ctx->built) {
+        flecs_rule_join_build(join, op_ctx, ctx);
+    }
+
+    for (i = 0; i < key_count; i ++) {
+        keys[i] = flecs_rule_var_get_entity(join->keys[i], ctx);
+    }
+
+    int32_t cur;
+    if (!redo) {
+        ecs_map_val_t *head = ecs_map_get(
+            &op_ctx->index, flecs_rule_join_hash(join, keys));
+        if (!head) {
+            return false;
+        }
+        cur = flecs_uto(int32_t, head[0]) - 1;
+    } else {
+        const ecs_rule_join_entry_t *entry = ecs_vec_get(
+            &op_ctx->entries, join->entry_size, op_ctx->cur);
+        cur = entry->next;
+    }
+
+    /* If source was constrained, only return entries for the same table */
+    ecs_table_t *src_table = NULL;
+    uint64_t written = ctx->written[ctx->op_index];
+    if (flecs_ref_is_written(op, &op->src, EcsRuleSrc, written)) {
+        src_table = flecs_rule_var_get_table(op->src.var, ctx);
+    }
+
+    const ecs_rule_join_entry_t *entry = NULL;
+    for (; cur != -1; cur = entry->next) {
+        entry = ecs_vec_get(&op_ctx->entries, join->entry_size, cur);
+        if (src_table && entry->table != src_table) {
+            continue;
+        }
+
+        /* Different keys can have the same hash */
+        if (!ecs_os_memcmp(flecs_rule_join_keys(entry), keys, 
+            ECS_SIZEOF(ecs_entity_t) * key_count)) 
+        {
+            break;
+        }
+    }
+
+    op_ctx->cur = cur;
+    if (cur == -1) {
+        return false;
+    }
+
+    if (!src_table) {
+        flecs_rule_var_set_table(op, op->src.var, entry->table, 0, 0, ctx);
+    }
+
+    ecs_iter_t *it = ctx->it;
+    const ecs_id_t *ids = flecs_rule_join_ids(join, entry);
+    const int32_t *columns = flecs_rule_join_columns(join, entry);
+    for (i = 0; i < join->term_count; i ++) {
+        int8_t field_index = join->terms[i].field_index;
+        it->ids[field_index] = ids[i];
+        flecs_rule_it_set_column(it, field_index, columns[i]);
+    }
+
+    return true;
+}
+
 static
 bool flecs_rule_trav_fixed_src_reflexive(
     const ecs_rule_op_t *op,
@@ -1700,6 +1976,7 @@ bool flecs_rule_run(
     case EcsRuleAndAny: return flecs_rule_and_any(op, redo, ctx);
     case EcsRuleWith: return flecs_rule_with(op, redo, ctx);
     case EcsRuleTrav: return flecs_rule_trav(op, redo, ctx);
+    case EcsRuleJoin: return flecs_rule_join(op, redo, ctx);
     case EcsRuleIdsRight: return flecs_rule_idsright(op, redo, ctx);
     case EcsRuleIdsLeft: return flecs_rule_idsleft(op, redo, ctx);
     case EcsRuleEach: return flecs_rule_each(op, redo, ctx);
@@ -1765,6 +2042,38 @@ void flecs_rule_iter_init(
     flecs_iter_validate(it);
 }
 
+/* Find operation that is split up between partitioned iterators. This is the
+ * first operation that selects tables for a variable source, if it is only
+ * preceded by operations that don't yield more than once. */
+static
+int16_t flecs_rule_part_op(
+    const ecs_rule_t *rule,
+    uint64_t written)
+{
+    int32_t i, count = rule->op_count;
+    for (i = 0; i < count; i ++) {
+        const ecs_rule_op_t *op = &rule->ops[i];
+        switch(op->kind) {
+        case EcsRuleSetIds:
+        case EcsRuleSetFixed:
+            continue;
+        case EcsRuleAnd:
+        case EcsRuleAndId:
+        case EcsRuleAndAny:
+            if ((flecs_rule_ref_flags(op->flags, EcsRuleSrc) & EcsRuleIsVar) &&
+                !flecs_ref_is_written(op, &op->src, EcsRuleSrc, written)) 
+            {
+                return flecs_ito(int16_t, i);
+            }
+            break;
+        default:
+            break;
+        }
+        break;
+    }
+    return -1;
+}
+
 bool ecs_rule_next(
     ecs_iter_t *it)
 {
@@ -1787,6 +2096,25 @@ bool ecs_rule_next_instanced(
     ecs_assert(it->next == ecs_rule_next, ECS_INVALID_PARAMETER, NULL);
 
     ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    if (rit->cache) {
+        /* Variables constrained by the application aren't stored in the cache,
+         * so evaluate the rule program instead. */
+        if (!it->constrained_vars) {
+            if (flecs_rule_cache_next(it)) {
+                return true;
+            }
+            goto done;
+        }
+        rit->cache = NULL;
+    }
+
+    if (rit->yield_table) {
+        /* Restore count of table range that was set for the previous result,
+         * so that operations see the same range as before the yield. */
+        rit->vars[0].range.count = 0;
+        rit->yield_table = false;
+    }
+
     bool redo = it->flags & EcsIterIsValid;
     ecs_rule_lbl_t next;
 
@@ -1807,6 +2135,16 @@ bool ecs_rule_next_instanced(
             goto done;
         }
         flecs_rule_iter_init(&ctx);
+
+        if (rit->claimed) {
+            rit->part_op = flecs_rule_part_op(ctx.rule, ctx.written[0]);
+            if (rit->part_op == -1) {
+                /* Rule can't be split up, first iterator returns all results */
+                if (ecs_os_ainc(rit->claimed) != 1) {
+                    goto done;
+                }
+            }
+        }
     }
 
     do {
@@ -1836,7 +2174,8 @@ bool ecs_rule_next_instanced(
         if (op->kind == EcsRuleYield) {
             ecs_table_range_t *range = &rit->vars[0].range;
             ecs_table_t *table = range->table;
-            if (table && !range->count) {
+            rit->yield_table = table && !range->count;
+            if (rit->yield_table) {
                 range->count = ecs_table_count(table);
             }
             flecs_iter_populate_data(ctx.world, it, range->table, range->offset,
@@ -1871,6 +2210,15 @@ void flecs_rule_iter_fini_ctx(
         case EcsRuleTrav:
             flecs_rule_trav_cache_fini(a, &ctx[i].is.trav.cache);
             break;
+        case EcsRuleJoin: {
+            ecs_rule_join_ctx_t *join_ctx = &ctx[i].is.join;
+            if (join_ctx->built) {
+                ecs_map_fini(&join_ctx->index);
+                ecs_vec_fini(a, &join_ctx->entries, 
+                    rule->joins[op->other].entry_size);
+            }
+            break;
+        }
         default:
             break;
         }
@@ -1907,7 +2255,7 @@ void flecs_rule_iter_fini(
     rit->rule = NULL;
 }
 
-ecs_iter_t ecs_rule_iter(
+ecs_iter_t flecs_rule_iter(
     const ecs_world_t *world,
     const ecs_rule_t *rule)
 {
@@ -1915,8 +2263,6 @@ ecs_iter_t ecs_rule_iter(
     ecs_rule_iter_t *rit = &it.priv.iter.rule;
     ecs_check(rule != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    ecs_run_aperiodic(rule->filter.world, EcsAperiodicEmptyTables);
-
     int32_t i, var_count = rule->var_count, op_count = rule->op_count;
     it.world = ECS_CONST_CAST(ecs_world_t*, world);
     it.real_world = rule->filter.world;
@@ -1960,4 +2306,41 @@ error:
     return it;
 }
 
+ecs_iter_t ecs_rule_iter(
+    const ecs_world_t *world,
+    const ecs_rule_t *rule)
+{
+    ecs_check(rule != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ecs_run_aperiodic(rule->filter.world, EcsAperiodicEmptyTables);
+
+    ecs_iter_t it = flecs_rule_iter(world, rule);
+    if (rule->cache) {
+        it.priv.iter.rule.cache = flecs_rule_cache_get(rule);
+    }
+
+    return it;
+error:
+    return (ecs_iter_t){0};
+}
+
+void ecs_rule_iter_set_partition(
+    ecs_iter_t *it,
+    int32_t *claimed)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_rule_next, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(it->flags & EcsIterIsValid), ECS_INVALID_PARAMETER, NULL);
+    ecs_check(claimed != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_os_has_threading(), ECS_MISSING_OS_API, NULL);
+
+    ecs_rule_iter_t *rit = &it->priv.iter.rule;
+    rit->claimed = claimed;
+    rit->claim = -1;
+    rit->part_index = 0;
+    rit->part_op = -1;
+error:
+    return;
+}
+
 #endif
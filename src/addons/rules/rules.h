@@ -12,6 +12,8 @@ typedef int16_t ecs_rule_lbl_t;
 typedef ecs_flags64_t ecs_write_flags_t;
 
 #define EcsRuleMaxVarCount      (64)
+#define EcsRuleJoinMaxTerms     (8)
+#define EcsRuleJoinMaxKeys      (8)
 #define EcsVarNone              ((ecs_var_id_t)-1)
 #define EcsThisName             "this"
 
@@ -42,6 +44,7 @@ typedef enum {
     EcsRuleWith,           /* Match id against fixed or variable source */
     EcsRuleAndAny,         /* And operator with support for matching Any src/id */
     EcsRuleTrav,           /* Support for transitive/reflexive queries */
+    EcsRuleJoin,           /* Hash join terms with same source on written variables */
     EcsRuleIdsRight,       /* Find ids in use that match (R, *) wildcard */
     EcsRuleIdsLeft,        /* Find ids in use that match (*, T) wildcard */
     EcsRuleEach,           /* Iterate entities in table, populate entity variable */
@@ -96,12 +99,36 @@ typedef struct ecs_rule_op_t {
     ecs_rule_lbl_t next;       /* Forwarding label. Must come after prev */
     ecs_rule_lbl_t other;      /* Misc register used for control flow */
     ecs_flags16_t match_flags; /* Flags that modify matching behavior */
+    int32_t est;               /* Estimated number of results (see planner) */
     ecs_rule_ref_t src;
     ecs_rule_ref_t first;
     ecs_rule_ref_t second;
     ecs_flags64_t written;     /* Bitset with variables written by op */
 } ecs_rule_op_t;
 
+/* Term of a hash join. The first and second element of the term are either
+ * entities or written entity variables that are used as join key. */
+typedef struct ecs_rule_join_term_t {
+    ecs_rule_ref_t first;
+    ecs_rule_ref_t second;
+    ecs_flags8_t flags;        /* Flags storing whether 1st/2nd are variables */
+    int8_t field_index;        /* Query field corresponding with term */
+    int8_t first_key;          /* Index of first in join keys, or -1 */
+    int8_t second_key;         /* Index of second in join keys, or -1 */
+} ecs_rule_join_term_t;
+
+/* Hash join, evaluated by an EcsRuleJoin operation. Instead of evaluating each
+ * term for each combination of key values, the operation matches the terms 
+ * against all tables once, and stores the matching tables in a hash table
+ * indexed by the key values. */
+typedef struct ecs_rule_join_t {
+    ecs_rule_join_term_t terms[EcsRuleJoinMaxTerms];
+    ecs_var_id_t keys[EcsRuleJoinMaxKeys]; /* Entity variables used as key */
+    int8_t term_count;
+    int8_t key_count;
+    ecs_size_t entry_size;     /* Size of a hash table entry */
+} ecs_rule_join_t;
+
  /* And context */
 typedef struct {
     ecs_id_record_t *idr;
@@ -124,6 +151,20 @@ typedef struct {
     bool up;
 } ecs_trav_cache_t;
 
+/* Transitive closure of an entity for a traversable relationship */
+typedef struct {
+    ecs_vec_t down;            /* Entity and entities that (indirectly) have it */
+    ecs_vec_t up;              /* Entities that entity (indirectly) has */
+    bool down_valid;
+    bool up_valid;
+} ecs_trav_closure_t;
+
+/* World level cache with closures for a traversable relationship */
+typedef struct {
+    int32_t generation;        /* Generation of (R, *) record for closures */
+    ecs_map_t closures;        /* map<entity, ecs_trav_closure_t*> */
+} ecs_trav_rel_cache_t;
+
 /* Trav context */
 typedef struct {
     ecs_rule_and_ctx_t and;
@@ -134,6 +175,14 @@ typedef struct {
     bool yield_reflexive;
 } ecs_rule_trav_ctx_t;
 
+/* Join context */
+typedef struct {
+    ecs_map_t index;           /* Hash of key values to first entry + 1 */
+    ecs_vec_t entries;         /* Tables matched by the joined terms */
+    int32_t cur;               /* Current entry */
+    bool built;                /* Was hash table built for iterator */
+} ecs_rule_join_ctx_t;
+
  /* Eq context */
 typedef struct {
     ecs_table_range_t range;
@@ -171,6 +220,7 @@ typedef struct ecs_rule_op_ctx_t {
     union {
         ecs_rule_and_ctx_t and;
         ecs_rule_trav_ctx_t trav;
+        ecs_rule_join_ctx_t join;
         ecs_rule_ids_ctx_t ids;
         ecs_rule_eq_ctx_t eq;
         ecs_rule_each_ctx_t each;
@@ -203,6 +253,8 @@ typedef struct {
     ecs_rule_compile_ctrlflow_t ctrlflow[FLECS_QUERY_SCOPE_NESTING_MAX];
     ecs_rule_compile_ctrlflow_t *cur; /* Current scope */
 
+    ecs_vec_t joins; /* Hash joins (ecs_rule_join_t) used by operations */
+
     int32_t scope; /* Nesting level of query scopes */
     ecs_flags32_t scope_is_not; /* Whether scope is prefixed with not */
 } ecs_rule_compile_ctx_t;    
@@ -226,6 +278,20 @@ typedef struct {
     const char *name;
 } ecs_rule_var_cache_t;
 
+/* Results of a cached rule (see EcsFilterCached). A result stores a header,
+ * the public variables, field ids, sources, source tables and columns. A $this
+ * variable with a table and a count of 0 matches all entities in the table. */
+typedef struct ecs_rule_cache_t {
+    ecs_vec_t results;            /* Result storage */
+    ecs_size_t elem_size;         /* Size of a result */
+    ecs_map_t tables;             /* Tables for which results are up to date */
+    ecs_vec_t pending;            /* Tables to match before next iteration */
+    ecs_vec_t observers;          /* Observers that keep cache up to date */
+    bool dirty;                   /* Are results out of date */
+    bool table_only;              /* Do results only depend on table types */
+    bool entity_refs;             /* Do results depend on individual entities */
+} ecs_rule_cache_t;
+
 struct ecs_rule_t {
     ecs_header_t hdr;             /* Poly header */
     ecs_filter_t filter;          /* Filter */
@@ -244,6 +310,11 @@ struct ecs_rule_t {
     ecs_rule_op_t *ops;           /* Operations */
     int32_t op_count;             /* Number of operations */
 
+    ecs_rule_join_t *joins;       /* Hash joins used by operations */
+    int32_t join_count;           /* Number of hash joins */
+
+    ecs_rule_cache_t *cache;      /* Cached results (optional) */
+
     /* Mixins */
     ecs_iterable_t iterable;
     ecs_poly_dtor_t dtor;
@@ -262,6 +333,10 @@ ecs_flags16_t flecs_rule_ref_flags(
     ecs_flags16_t flags,
     ecs_flags16_t kind);
 
+/* Check if term is a builtin predicate ($x == y, $x ~= y, lookup) */
+bool flecs_rule_is_builtin_pred(
+    const ecs_term_t *term);
+
 /* Check if variable is written */
 bool flecs_rule_is_written(
     ecs_var_id_t var_id,
@@ -303,4 +378,26 @@ void flecs_rule_trav_cache_fini(
     ecs_allocator_t *a,
     ecs_trav_cache_t *cache);
 
+/* Create iterator without using or updating the rule cache */
+ecs_iter_t flecs_rule_iter(
+    const ecs_world_t *world,
+    const ecs_rule_t *rule);
+
+/* Create cache for rule */
+void flecs_rule_cache_init(
+    ecs_world_t *world,
+    ecs_rule_t *rule);
+
+/* Free cache of rule */
+void flecs_rule_cache_fini(
+    ecs_rule_t *rule);
+
+/* Get up to date cache, returns NULL if cache can't be used */
+const ecs_rule_cache_t* flecs_rule_cache_get(
+    const ecs_rule_t *rule);
+
+/* Yield next result from cache */
+bool flecs_rule_cache_next(
+    ecs_iter_t *it);
+
 #endif
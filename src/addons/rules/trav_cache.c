@@ -1,6 +1,17 @@
 /**
  * @file addons/rules/trav_cache.c
  * @brief Cache that stores the result of graph traversal.
+ *
+ * The transitive closures of entities are stored in a world level cache, so
+ * that rules don't have to walk the graph of a relationship for each iterator.
+ * The closures for a relationship are discarded when the generation of its
+ * (R, *) id record changes, which happens when an entity that can be traversed
+ * enters or leaves a table with a pair for the relationship, and when a 
+ * (R, target) id record is created or deleted.
+ *
+ * Iterators copy closures into their own cache, so that the world level cache
+ * can be updated while iterators are alive. The world level cache is not used
+ * when the world is multithreaded, in which case iterators walk the graph.
  */
 
 #include "rules.h"
@@ -21,14 +32,14 @@ void flecs_rule_build_down_cache(
         return;
     }
 
-    ecs_trav_elem_t *elem = ecs_vec_append_t(a, &cache->entities, 
+    ecs_trav_elem_t *elem = ecs_vec_append_t(a, &cache->entities,
         ecs_trav_elem_t);
     elem->entity = entity;
     elem->idr = idr;
 
     ecs_table_cache_iter_t it;
     if (flecs_table_cache_iter(&idr->cache, &it)) {
-        ecs_table_record_t *tr; 
+        ecs_table_record_t *tr;
         while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
             ecs_assert(tr->count == 1, ECS_INTERNAL_ERROR, NULL);
             ecs_table_t *table = tr->hdr.table;
@@ -71,7 +82,7 @@ void flecs_rule_build_up_cache(
             root_column = i;
         }
 
-        ecs_trav_elem_t *el = ecs_vec_append_t(a, &cache->entities, 
+        ecs_trav_elem_t *el = ecs_vec_append_t(a, &cache->entities,
             ecs_trav_elem_t);
         el->entity = second;
         el->column = root_column;
@@ -82,14 +93,205 @@ void flecs_rule_build_up_cache(
             ecs_table_record_t *r_tr = flecs_id_record_get_table(
                 cache->idr, r->table);
             if (!r_tr) {
-                return;
+                continue;
             }
-            flecs_rule_build_up_cache(world, a, ctx, cache, trav, r->table, 
+            flecs_rule_build_up_cache(world, a, ctx, cache, trav, r->table,
                 r_tr, root_column);
         }
     }
 }
 
+static
+void flecs_rule_trav_closures_clear(
+    ecs_world_t *world,
+    ecs_trav_rel_cache_t *rel_cache)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_map_iter_t it = ecs_map_iter(&rel_cache->closures);
+    while (ecs_map_next(&it)) {
+        ecs_trav_closure_t *closure = ecs_map_ptr(&it);
+        if (closure->down_valid) {
+            ecs_vec_fini_t(a, &closure->down, ecs_entity_t);
+        }
+        if (closure->up_valid) {
+            ecs_vec_fini_t(a, &closure->up, ecs_entity_t);
+        }
+        ecs_os_free(closure);
+    }
+    ecs_map_clear(&rel_cache->closures);
+}
+
+static
+void flecs_rule_trav_cache_world_fini(
+    ecs_world_t *world,
+    void *ctx)
+{
+    (void)ctx;
+
+    ecs_map_iter_t it = ecs_map_iter(&world->trav_cache);
+    while (ecs_map_next(&it)) {
+        ecs_trav_rel_cache_t *rel_cache = ecs_map_ptr(&it);
+        flecs_rule_trav_closures_clear(world, rel_cache);
+        ecs_map_fini(&rel_cache->closures);
+        ecs_os_free(rel_cache);
+    }
+    ecs_map_fini(&world->trav_cache);
+}
+
+static
+ecs_trav_closure_t* flecs_rule_trav_closure_get(
+    ecs_world_t *world,
+    ecs_entity_t trav,
+    ecs_entity_t entity,
+    bool up);
+
+/* Entity, and entities that have the entity as target, and so on */
+static
+void flecs_rule_trav_closure_build_down(
+    ecs_world_t *world,
+    ecs_trav_closure_t *closure,
+    ecs_entity_t trav,
+    ecs_entity_t entity)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_clear(&closure->down);
+
+    ecs_id_record_t *idr = flecs_id_record_get(world, ecs_pair(trav, entity));
+    if (!idr) {
+        return;
+    }
+
+    ecs_vec_append_t(a, &closure->down, ecs_entity_t)[0] = entity;
+
+    ecs_table_cache_iter_t it;
+    if (!flecs_table_cache_iter(&idr->cache, &it)) {
+        return;
+    }
+
+    ecs_table_record_t *tr;
+    while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+        ecs_assert(tr->count == 1, ECS_INTERNAL_ERROR, NULL);
+        ecs_table_t *table = tr->hdr.table;
+        if (!table->_->traversable_count) {
+            continue;
+        }
+
+        int32_t i, count = ecs_table_count(table);
+        ecs_record_t **records = table->data.records.array;
+        ecs_entity_t *entities = table->data.entities.array;
+        for (i = 0; i < count; i ++) {
+            if (!(records[i]->row & EcsEntityIsTraversable)) {
+                continue;
+            }
+
+            ecs_trav_closure_t *child = flecs_rule_trav_closure_get(
+                world, trav, entities[i], false);
+            ecs_assert(child != NULL, ECS_INTERNAL_ERROR, NULL);
+            int32_t child_count = ecs_vec_count(&child->down);
+            if (child_count) {
+                ecs_os_memcpy_n(ecs_vec_grow_t(a, &closure->down,
+                    ecs_entity_t, child_count), ecs_vec_first(&child->down),
+                        ecs_entity_t, child_count);
+            }
+        }
+    }
+}
+
+/* Targets of entity, and targets of the targets, and so on */
+static
+void flecs_rule_trav_closure_build_up(
+    ecs_world_t *world,
+    ecs_trav_closure_t *closure,
+    ecs_entity_t trav,
+    ecs_entity_t entity)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_clear(&closure->up);
+
+    ecs_record_t *r = flecs_entities_get_any(world, entity);
+    if (!r || !r->table) {
+        return;
+    }
+
+    ecs_id_record_t *idr = flecs_id_record_get(world,
+        ecs_pair(trav, EcsWildcard));
+    ecs_table_record_t *tr = flecs_id_record_get_table(idr, r->table);
+    if (!tr) {
+        return;
+    }
+
+    ecs_id_t *ids = r->table->type.array;
+    int32_t i = tr->index, end = i + tr->count;
+    for (; i < end; i ++) {
+        ecs_entity_t tgt = ecs_pair_second(world, ids[i]);
+        ecs_vec_append_t(a, &closure->up, ecs_entity_t)[0] = tgt;
+
+        ecs_trav_closure_t *parent = flecs_rule_trav_closure_get(
+            world, trav, tgt, true);
+        ecs_assert(parent != NULL, ECS_INTERNAL_ERROR, NULL);
+        int32_t parent_count = ecs_vec_count(&parent->up);
+        if (parent_count) {
+            ecs_os_memcpy_n(ecs_vec_grow_t(a, &closure->up,
+                ecs_entity_t, parent_count), ecs_vec_first(&parent->up),
+                    ecs_entity_t, parent_count);
+        }
+    }
+}
+
+/* Get closure from world level cache. Returns NULL if the cache can't be
+ * used, in which case the caller has to traverse the graph. */
+static
+ecs_trav_closure_t* flecs_rule_trav_closure_get(
+    ecs_world_t *world,
+    ecs_entity_t trav,
+    ecs_entity_t entity,
+    bool up)
+{
+    /* Other threads could be reading the cache */
+    if (world->flags & (EcsWorldMultiThreaded | EcsWorldFini)) {
+        return NULL;
+    }
+
+    ecs_id_record_t *idr = flecs_id_record_get(world,
+        ecs_pair(trav, EcsWildcard));
+    if (!idr) {
+        return NULL;
+    }
+
+    if (!ecs_map_is_init(&world->trav_cache)) {
+        ecs_map_init(&world->trav_cache, &world->allocator);
+        ecs_atfini(world, flecs_rule_trav_cache_world_fini, NULL);
+    }
+
+    ecs_trav_rel_cache_t *rel_cache = ecs_map_ensure_alloc_t(
+        &world->trav_cache, ecs_trav_rel_cache_t, trav);
+    if (!ecs_map_is_init(&rel_cache->closures)) {
+        ecs_map_init(&rel_cache->closures, &world->allocator);
+        rel_cache->generation = idr->trav_generation;
+    } else if (rel_cache->generation != idr->trav_generation) {
+        flecs_rule_trav_closures_clear(world, rel_cache);
+        rel_cache->generation = idr->trav_generation;
+    }
+
+    ecs_trav_closure_t *closure = ecs_map_ensure_alloc_t(
+        &rel_cache->closures, ecs_trav_closure_t, entity);
+    if (up) {
+        if (!closure->up_valid) {
+            ecs_vec_init_t(&world->allocator, &closure->up, ecs_entity_t, 0);
+            flecs_rule_trav_closure_build_up(world, closure, trav, entity);
+            closure->up_valid = true;
+        }
+    } else {
+        if (!closure->down_valid) {
+            ecs_vec_init_t(&world->allocator, &closure->down, ecs_entity_t, 0);
+            flecs_rule_trav_closure_build_down(world, closure, trav, entity);
+            closure->down_valid = true;
+        }
+    }
+
+    return closure;
+}
+
 void flecs_rule_trav_cache_fini(
     ecs_allocator_t *a,
     ecs_trav_cache_t *cache)
@@ -107,7 +309,23 @@ void flecs_rule_get_down_cache(
         ecs_world_t *world = ctx->it->real_world;
         ecs_allocator_t *a = flecs_rule_get_allocator(ctx->it);
         ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
-        flecs_rule_build_down_cache(world, a, ctx, cache, trav, entity);
+
+        ecs_trav_closure_t *closure = flecs_rule_trav_closure_get(
+            world, trav, entity, false);
+        if (closure) {
+            int32_t i, count = ecs_vec_count(&closure->down);
+            ecs_entity_t *entities = ecs_vec_first(&closure->down);
+            for (i = 0; i < count; i ++) {
+                ecs_trav_elem_t *elem = ecs_vec_append_t(a, &cache->entities,
+                    ecs_trav_elem_t);
+                elem->entity = entities[i];
+                elem->idr = NULL; /* Looked up by select */
+                elem->column = 0;
+            }
+        } else {
+            flecs_rule_build_down_cache(world, a, ctx, cache, trav, entity);
+        }
+
         cache->id = ecs_pair(trav, entity);
         cache->up = false;
     }
@@ -125,7 +343,7 @@ void flecs_rule_get_up_cache(
 
     ecs_id_record_t *idr = cache->idr;
     if (!idr || idr->id != ecs_pair(trav, EcsWildcard)) {
-        idr = cache->idr = flecs_id_record_get(world, 
+        idr = cache->idr = flecs_id_record_get(world,
             ecs_pair(trav, EcsWildcard));
         if (!idr) {
             ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
@@ -139,13 +357,46 @@ void flecs_rule_get_up_cache(
         return;
     }
 
-    ecs_id_t id = table->type.array[tr->index];
+    ecs_id_t *ids = table->type.array;
+    ecs_id_t id = ids[tr->index];
 
-    if (cache->id != id || !cache->up) {
-        ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
-        flecs_rule_build_up_cache(world, a, ctx, cache, trav, table, tr, -1);
-        cache->id = id;
-        cache->up = true;
+    /* Tables with more than one pair can't be identified by the first pair */
+    if (cache->id == id && cache->up && tr->count == 1) {
+        return;
+    }
+
+    ecs_vec_reset_t(a, &cache->entities, ecs_trav_elem_t);
+    cache->id = id;
+    cache->up = true;
+
+    int32_t column, end = tr->index + tr->count;
+    for (column = tr->index; column < end; column ++) {
+        ecs_entity_t tgt = ecs_pair_second(world, ids[column]);
+        ecs_trav_closure_t *closure = flecs_rule_trav_closure_get(
+            world, trav, tgt, true);
+        if (!closure) {
+            ecs_table_record_t tgt_tr = *tr;
+            tgt_tr.index = flecs_ito(int16_t, column);
+            tgt_tr.count = 1;
+            flecs_rule_build_up_cache(world, a, ctx, cache, trav, table,
+                &tgt_tr, column);
+            continue;
+        }
+
+        ecs_trav_elem_t *el = ecs_vec_append_t(a, &cache->entities,
+            ecs_trav_elem_t);
+        el->entity = tgt;
+        el->column = column;
+        el->idr = NULL;
+
+        int32_t i, count = ecs_vec_count(&closure->up);
+        ecs_entity_t *entities = ecs_vec_first(&closure->up);
+        for (i = 0; i < count; i ++) {
+            el = ecs_vec_append_t(a, &cache->entities, ecs_trav_elem_t);
+            el->entity = entities[i];
+            el->column = column;
+            el->idr = NULL;
+        }
     }
 }
 
@@ -332,6 +332,10 @@ void ecs_world_stats_get(
     ECS_COUNTER_RECORD(&s->memory.stack_free_count, t, ecs_stack_allocator_free_count);
     ECS_GAUGE_RECORD(&s->memory.stack_outstanding_alloc_count, t, outstanding_allocs);
 
+    ecs_allocator_t *a = (ecs_allocator_t*)&world->allocator;
+    ECS_GAUGE_RECORD(&s->memory.page_bytes, t, flecs_allocator_page_bytes(a, false));
+    ECS_GAUGE_RECORD(&s->memory.huge_page_advised_bytes, t, flecs_allocator_page_bytes(a, true));
+
 #ifdef FLECS_REST
     ECS_COUNTER_RECORD(&s->rest.request_count, t, ecs_rest_request_count);
     ECS_COUNTER_RECORD(&s->rest.entity_count, t, ecs_rest_entity_count);
@@ -27,7 +27,8 @@ ecs_entity_t ecs_run_intern(
     ecs_entity_t system,
     ecs_system_t *system_data,
     int32_t stage_index,
-    int32_t stage_count,    
+    int32_t stage_count,
+    int32_t chunk_size,
     ecs_ftime_t delta_time,
     int32_t offset,
     int32_t limit,
@@ -100,7 +101,14 @@ ecs_entity_t ecs_run_intern(
     }
 
     if (stage_count > 1 && system_data->multi_threaded) {
-        wit = ecs_worker_iter(it, stage_index, stage_count);
+        if (chunk_size) {
+            /* Workers claim chunks from a counter that the caller resets 
+             * before workers start running the system */
+            wit = ecs_worker_chunk_iter(it, 
+                &system_data->worker_claimed, chunk_size);
+        } else {
+            wit = ecs_worker_iter(it, stage_index, stage_count);
+        }
         it = &wit;
     }
 
@@ -149,8 +157,8 @@ ecs_entity_t ecs_run_w_filter(
     ecs_stage_t *stage = flecs_stage_from_world(&world);
     ecs_system_t *system_data = ecs_poly_get(world, system, ecs_system_t);
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
-    return ecs_run_intern(world, stage, system, system_data, 0, 0, delta_time, 
-        offset, limit, param);
+    return ecs_run_intern(world, stage, system, system_data, 0, 0, 0, 
+        delta_time, offset, limit, param);
 }
 
 ecs_entity_t ecs_run_worker(
@@ -166,7 +174,7 @@ ecs_entity_t ecs_run_worker(
     ecs_assert(system_data != NULL, ECS_INVALID_PARAMETER, NULL);
 
     return ecs_run_intern(
-        world, stage, system, system_data, stage_index, stage_count, 
+        world, stage, system, system_data, stage_index, stage_count, 0,
         delta_time, 0, 0, param);
 }
 
@@ -33,6 +33,7 @@ typedef struct ecs_system_t {
     ecs_ftime_t time_spent;         /* Time spent on running system */
     ecs_ftime_t time_passed;        /* Time passed since last invocation */
     int64_t last_frame;             /* Last frame for which the system was considered */
+    int32_t worker_claimed;         /* Chunks claimed by workers in current run */
 
     void *ctx;                      /* Userdata for system */
     void *binding_ctx;              /* Optional language binding context */
@@ -61,6 +62,7 @@ ecs_entity_t ecs_run_intern(
     ecs_system_t *system_data,
     int32_t stage_current,
     int32_t stage_count,
+    int32_t chunk_size,
     ecs_ftime_t delta_time,
     int32_t offset,
     int32_t limit,
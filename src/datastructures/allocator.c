@@ -27,6 +27,7 @@ void flecs_allocator_init(
     flecs_ballocator_init_n(&a->chunks, ecs_block_allocator_t,
         FLECS_SPARSE_PAGE_SIZE);
     flecs_sparse_init_t(&a->sizes, NULL, &a->chunks, ecs_block_allocator_t);
+    a->depot = NULL;
 }
 
 void flecs_allocator_fini(
@@ -62,6 +63,7 @@ ecs_block_allocator_t* flecs_allocator_get(
         result = flecs_sparse_ensure_fast_t(&a->sizes, 
             ecs_block_allocator_t, (uint32_t)hash);
         flecs_ballocator_init(result, size);
+        result->depot = a->depot;
     }
 
     ecs_assert(result->data_size == size, ECS_INTERNAL_ERROR, NULL);
@@ -69,6 +71,21 @@ ecs_block_allocator_t* flecs_allocator_get(
     return result;
 }
 
+int64_t flecs_allocator_page_bytes(
+    ecs_allocator_t *a,
+    bool huge)
+{
+    int64_t result = 0;
+    int32_t i, count = flecs_sparse_count(&a->sizes);
+    for (i = 0; i < count; i ++) {
+        ecs_block_allocator_t *ba = flecs_sparse_get_dense_t(
+            &a->sizes, ecs_block_allocator_t, i);
+        int32_t page_count = huge ? ba->huge_page_advised_count : ba->page_count;
+        result += (int64_t)page_count * ba->data_size;
+    }
+    return result;
+}
+
 char* flecs_strdup(
     ecs_allocator_t *a, 
     const char* str)
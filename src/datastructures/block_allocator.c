@@ -15,6 +15,37 @@
 int64_t ecs_block_allocator_alloc_count = 0;
 int64_t ecs_block_allocator_free_count = 0;
 
+/* Alignment of the first chunk in a block. Since all chunks in a block are 
+ * chunk_size apart, this is also the alignment of all other chunks. This makes
+ * it possible to get aligned memory by requesting a multiple of the alignment,
+ * which is used by table columns for over-aligned components. */
+static
+ecs_size_t flecs_balloc_align(
+    ecs_block_allocator_t *allocator)
+{
+    ecs_size_t align = allocator->chunk_size & -allocator->chunk_size;
+    return ECS_MIN(align, FLECS_BALLOC_MAX_ALIGN);
+}
+
+#ifdef FLECS_SANITIZE
+/* Size of the header that stores the chunk size in sanitized builds. Aligned 
+ * allocations (like table columns of over-aligned components) store at least
+ * two elements, so if the data is at least twice the alignment the header is as
+ * large as the alignment, which gives the data the same alignment as in regular
+ * builds. */
+static
+ecs_size_t flecs_balloc_header(
+    ecs_size_t data_size)
+{
+    ecs_size_t size = ECS_ALIGN(data_size, 16);
+    ecs_size_t align = ECS_MIN(size & -size, FLECS_BALLOC_MAX_ALIGN);
+    if (size >= (align * 2)) {
+        return align;
+    }
+    return 16;
+}
+#endif
+
 static
 ecs_block_allocator_chunk_header_t* flecs_balloc_block(
     ecs_block_allocator_t *allocator)
@@ -23,11 +54,22 @@ ecs_block_allocator_chunk_header_t* flecs_balloc_block(
         return NULL;
     }
 
+    ecs_size_t align = flecs_balloc_align(allocator);
+    ecs_size_t padding = 0;
+    if (align > 16) {
+        padding = align;
+    }
+
     ecs_block_allocator_block_t *block = 
         ecs_os_malloc(ECS_SIZEOF(ecs_block_allocator_block_t) +
-            allocator->block_size);
+            allocator->block_size + padding);
     ecs_block_allocator_chunk_header_t *first_chunk = ECS_OFFSET(block, 
         ECS_SIZEOF(ecs_block_allocator_block_t));
+    if (padding) {
+        uintptr_t addr = (uintptr_t)first_chunk;
+        addr = (addr + (uintptr_t)(align - 1)) & ~(uintptr_t)(align - 1);
+        first_chunk = (ecs_block_allocator_chunk_header_t*)addr;
+    }
 
     block->memory = first_chunk;
     if (!allocator->block_tail) {
@@ -54,6 +96,383 @@ ecs_block_allocator_chunk_header_t* flecs_balloc_block(
     return first_chunk;
 }
 
+/* Chunks of FLECS_BALLOC_LARGE_SIZE or larger are allocated individually with
+ * the OS allocator, or with the OS page allocation functions if the chunk is
+ * larger than FLECS_BALLOC_PAGE_ALLOC_SIZE. The chunk is aligned the same way 
+ * chunks in a block are. The distance between the chunk and the start of the 
+ * allocation is stored in the byte that precedes the chunk, and the byte before
+ * that stores how the chunk was allocated. */
+#define FLECS_BALLOC_PAGES (1)
+#define FLECS_BALLOC_HUGE_PAGES_ADVISED (2)
+
+static
+bool flecs_balloc_is_large(
+    ecs_block_allocator_t *allocator)
+{
+    return allocator->chunk_size >= FLECS_BALLOC_LARGE_SIZE;
+}
+
+static
+bool flecs_balloc_use_pages(
+    ecs_block_allocator_t *allocator)
+{
+    return (allocator->chunk_size >= FLECS_BALLOC_PAGE_ALLOC_SIZE) &&
+        ecs_os_has_page_alloc();
+}
+
+static
+ecs_size_t flecs_balloc_large_size(
+    ecs_block_allocator_t *allocator)
+{
+    return allocator->chunk_size + flecs_balloc_align(allocator);
+}
+
+static
+void flecs_balloc_large_count(
+    ecs_block_allocator_t *allocator,
+    uint8_t flags,
+    int32_t count)
+{
+    if (flags & FLECS_BALLOC_PAGES) {
+        allocator->page_count += count;
+    }
+    if (flags & FLECS_BALLOC_HUGE_PAGES_ADVISED) {
+        allocator->huge_page_advised_count += count;
+    }
+}
+
+static
+void flecs_bfree_large(
+    ecs_block_allocator_t *allocator,
+    void *chunk)
+{
+    ecs_size_t offset = ((uint8_t*)chunk)[-1];
+    uint8_t flags = ((uint8_t*)chunk)[-2];
+    void *memory = ECS_OFFSET(chunk, -offset);
+    if (flags & FLECS_BALLOC_PAGES) {
+        ecs_os_page_free(memory, flecs_balloc_large_size(allocator));
+    } else {
+        ecs_os_free(memory);
+    }
+    flecs_balloc_large_count(allocator, flags, -1);
+    ecs_os_linc(&ecs_block_allocator_free_count);
+}
+
+static
+void* flecs_balloc_large(
+    ecs_block_allocator_t *dst,
+    ecs_block_allocator_t *src,
+    void *chunk)
+{
+    ecs_size_t align = flecs_balloc_align(dst);
+    ecs_size_t size = flecs_balloc_large_size(dst);
+    bool use_pages = flecs_balloc_use_pages(dst);
+    ecs_size_t offset = 0;
+    uint8_t flags = 0;
+    void *memory = NULL;
+
+    if (chunk) {
+        offset = ((uint8_t*)chunk)[-1];
+        flags = ((uint8_t*)chunk)[-2];
+        memory = ECS_OFFSET(chunk, -offset);
+
+        if (use_pages != ((flags & FLECS_BALLOC_PAGES) != 0)) {
+            /* Memory can't be resized across allocation functions */
+            void *result = flecs_balloc_large(dst, NULL, NULL);
+            ecs_os_memcpy(result, chunk, 
+                ECS_MIN(src->chunk_size, dst->chunk_size));
+            flecs_bfree_large(src, chunk);
+            return result;
+        }
+
+        flecs_balloc_large_count(src, flags, -1);
+    } else {
+        ecs_os_linc(&ecs_block_allocator_alloc_count);
+    }
+
+    if (use_pages) {
+        bool huge = false;
+        if (memory) {
+            memory = ecs_os_page_realloc(
+                memory, flecs_balloc_large_size(src), size, &huge);
+        } else {
+            memory = ecs_os_page_alloc(size, &huge);
+        }
+        ecs_assert(memory != NULL, ECS_OUT_OF_MEMORY, NULL);
+        flags = FLECS_BALLOC_PAGES;
+        if (huge) {
+            flags |= FLECS_BALLOC_HUGE_PAGES_ADVISED;
+        }
+    } else {
+        memory = ecs_os_realloc(memory, size);
+        flags = 0;
+    }
+
+    flecs_balloc_large_count(dst, flags, 1);
+
+    uintptr_t addr = (uintptr_t)memory + 2;
+    addr = (addr + (uintptr_t)(align - 1)) & ~(uintptr_t)(align - 1);
+    void *result = (void*)addr;
+    ecs_size_t new_offset = (ecs_size_t)(addr - (uintptr_t)memory);
+
+    /* If the OS allocator moved the memory to an address with a different
+     * alignment, move the chunk to its new aligned position */
+    if (chunk && (new_offset != offset)) {
+        ecs_os_memmove(result, ECS_OFFSET(memory, offset), 
+            ECS_MIN(src->chunk_size, dst->chunk_size));
+    }
+
+    ((uint8_t*)result)[-1] = (uint8_t)new_offset;
+    ((uint8_t*)result)[-2] = flags;
+    return result;
+}
+
+/* Free chunks are exchanged with the depot in magazines, which are lists of 
+ * chunks. Magazines are linked to each other through the first chunk, which is
+ * large enough to store two pointers since chunks are at least 16 bytes. */
+typedef struct ecs_block_allocator_magazine_t {
+    ecs_block_allocator_chunk_header_t chunks;
+    struct ecs_block_allocator_magazine_t *next;
+} ecs_block_allocator_magazine_t;
+
+/* Free chunks and blocks of finalized allocators for a single chunk size */
+typedef struct ecs_block_allocator_depot_size_t {
+    ecs_block_allocator_magazine_t *magazines;
+    ecs_block_allocator_block_t *blocks; /* Blocks of finalized allocators */
+    int32_t chunk_size;
+    int32_t chunks_per_block;
+} ecs_block_allocator_depot_size_t;
+
+struct ecs_block_allocator_depot_t {
+    ecs_os_mutex_t lock;
+    ecs_map_t sizes;    /* <chunk size, ecs_block_allocator_depot_size_t*> */
+};
+
+ecs_block_allocator_depot_t* flecs_ballocator_depot_new(void) {
+    ecs_block_allocator_depot_t *result = 
+        ecs_os_calloc_t(ecs_block_allocator_depot_t);
+    result->lock = ecs_os_mutex_new();
+    ecs_map_init(&result->sizes, NULL);
+    return result;
+}
+
+static
+void flecs_balloc_depot_free_blocks(
+    ecs_block_allocator_block_t *block)
+{
+    while (block) {
+        ecs_block_allocator_block_t *next = block->next;
+        ecs_os_free(block);
+        ecs_os_linc(&ecs_block_allocator_free_count);
+        block = next;
+    }
+}
+
+void flecs_ballocator_depot_free(
+    ecs_block_allocator_depot_t *depot)
+{
+    ecs_map_iter_t it = ecs_map_iter(&depot->sizes);
+    while (ecs_map_next(&it)) {
+        ecs_block_allocator_depot_size_t *ds = ecs_map_ptr(&it);
+        flecs_balloc_depot_free_blocks(ds->blocks);
+        ecs_os_free(ds);
+    }
+    ecs_map_fini(&depot->sizes);
+    ecs_os_mutex_free(depot->lock);
+    ecs_os_free(depot);
+}
+
+/* Must be called while the depot is locked */
+static
+ecs_block_allocator_depot_size_t* flecs_balloc_depot_ensure(
+    ecs_block_allocator_t *ba)
+{
+    ecs_block_allocator_depot_size_t **ref = ecs_map_ensure_ref(
+        &ba->depot->sizes, ecs_block_allocator_depot_size_t, 
+            (ecs_map_key_t)ba->chunk_size);
+    if (!*ref) {
+        *ref = ecs_os_calloc_t(ecs_block_allocator_depot_size_t);
+        (*ref)->chunk_size = ba->chunk_size;
+        (*ref)->chunks_per_block = ba->chunks_per_block;
+    }
+    return *ref;
+}
+
+static
+void flecs_balloc_depot_put(
+    ecs_block_allocator_t *ba,
+    ecs_block_allocator_chunk_header_t *chunks)
+{
+    ecs_block_allocator_depot_t *depot = ba->depot;
+    ecs_block_allocator_magazine_t *magazine = 
+        (ecs_block_allocator_magazine_t*)chunks;
+
+    ecs_os_mutex_lock(depot->lock);
+    ecs_block_allocator_depot_size_t *ds = flecs_balloc_depot_ensure(ba);
+    magazine->next = ds->magazines;
+    ds->magazines = magazine;
+    ecs_os_mutex_unlock(depot->lock);
+}
+
+static
+ecs_block_allocator_chunk_header_t* flecs_balloc_depot_get(
+    ecs_block_allocator_t *ba)
+{
+    ecs_block_allocator_depot_t *depot = ba->depot;
+    ecs_block_allocator_magazine_t *magazine = NULL;
+
+    ecs_os_mutex_lock(depot->lock);
+    ecs_block_allocator_depot_size_t *ds = ecs_map_get_deref(
+        &depot->sizes, ecs_block_allocator_depot_size_t, 
+            (ecs_map_key_t)ba->chunk_size);
+    if (ds && ds->magazines) {
+        magazine = ds->magazines;
+        ds->magazines = magazine->next;
+    }
+    ecs_os_mutex_unlock(depot->lock);
+
+    if (!magazine) {
+        return NULL;
+    }
+
+    ecs_block_allocator_chunk_header_t *chunk;
+    for (chunk = &magazine->chunks; chunk; chunk = chunk->next) {
+        ba->free_count ++;
+    }
+
+    return &magazine->chunks;
+}
+
+/* Returns whether all chunks of a block are in the set of free chunks */
+static
+bool flecs_balloc_block_is_free(
+    ecs_block_allocator_depot_size_t *ds,
+    ecs_block_allocator_block_t *block,
+    ecs_map_t *free_chunks)
+{
+    int32_t i;
+    for (i = 0; i < ds->chunks_per_block; i ++) {
+        void *chunk = ECS_OFFSET(block->memory, i * ds->chunk_size);
+        if (!ecs_map_get(free_chunks, (ecs_map_key_t)(uintptr_t)chunk)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Free blocks of finalized allocators of which all chunks are in the depot. 
+ * The remaining free chunks are redistributed over new magazines. */
+static
+void flecs_balloc_depot_trim_size(
+    ecs_block_allocator_depot_size_t *ds)
+{
+    if (!ds->blocks) {
+        return;
+    }
+
+    ecs_map_t free_chunks;
+    ecs_map_init(&free_chunks, NULL);
+
+    ecs_block_allocator_magazine_t *magazine;
+    ecs_block_allocator_chunk_header_t *chunk;
+    for (magazine = ds->magazines; magazine; magazine = magazine->next) {
+        for (chunk = &magazine->chunks; chunk; chunk = chunk->next) {
+            ecs_map_insert(&free_chunks, (ecs_map_key_t)(uintptr_t)chunk, 1);
+        }
+    }
+
+    /* Unlink blocks of which all chunks are free. Chunks of unlinked blocks
+     * are marked so they can be removed from the magazines. */
+    ecs_block_allocator_block_t *block, *freed = NULL, **prev = &ds->blocks;
+    int32_t i;
+    for (block = ds->blocks; block; block = *prev) {
+        if (!flecs_balloc_block_is_free(ds, block, &free_chunks)) {
+            prev = &block->next;
+            continue;
+        }
+
+        for (i = 0; i < ds->chunks_per_block; i ++) {
+            void *ptr = ECS_OFFSET(block->memory, i * ds->chunk_size);
+            ecs_map_ensure(&free_chunks, (ecs_map_key_t)(uintptr_t)ptr)[0] = 0;
+        }
+
+        *prev = block->next;
+        block->next = freed;
+        freed = block;
+    }
+
+    if (freed) {
+        /* Rebuild magazines from chunks that remain. The next pointer of a 
+         * chunk is read before the chunk is relinked. */
+        ecs_block_allocator_magazine_t *magazines = ds->magazines;
+        ecs_block_allocator_chunk_header_t *last = NULL;
+        int32_t count = 0;
+        ds->magazines = NULL;
+        while (magazines) {
+            ecs_block_allocator_magazine_t *next_magazine = magazines->next;
+            for (chunk = &magazines->chunks; chunk;) {
+                ecs_block_allocator_chunk_header_t *next = chunk->next;
+                if (ecs_map_get(&free_chunks, 
+                    (ecs_map_key_t)(uintptr_t)chunk)[0]) 
+                {
+                    if (!count) {
+                        magazine = (ecs_block_allocator_magazine_t*)chunk;
+                        chunk->next = NULL;
+                        magazine->next = ds->magazines;
+                        ds->magazines = magazine;
+                    } else {
+                        chunk->next = NULL;
+                        last->next = chunk;
+                    }
+                    last = chunk;
+                    count = (count + 1) % ds->chunks_per_block;
+                }
+                chunk = next;
+            }
+            magazines = next_magazine;
+        }
+
+        flecs_balloc_depot_free_blocks(freed);
+    }
+
+    ecs_map_fini(&free_chunks);
+}
+
+void flecs_ballocator_depot_trim(
+    ecs_block_allocator_depot_t *depot)
+{
+    ecs_os_mutex_lock(depot->lock);
+    ecs_map_iter_t it = ecs_map_iter(&depot->sizes);
+    while (ecs_map_next(&it)) {
+        flecs_balloc_depot_trim_size(ecs_map_ptr(&it));
+    }
+    ecs_os_mutex_unlock(depot->lock);
+}
+
+/* Return a magazine to the depot when an allocator has more than two 
+ * magazines worth of free chunks, so that chunks freed by one thread can be 
+ * reused by others. */
+static
+void flecs_bfree_to_depot(
+    ecs_block_allocator_t *ba)
+{
+    int32_t i, count = ba->chunks_per_block;
+    if (ba->free_count < (count * 2)) {
+        return;
+    }
+
+    ecs_block_allocator_chunk_header_t *first = ba->head, *last = first;
+    for (i = 1; i < count; i ++) {
+        last = last->next;
+    }
+
+    ba->head = last->next;
+    ba->free_count -= count;
+    last->next = NULL;
+
+    flecs_balloc_depot_put(ba, first);
+}
+
 void flecs_ballocator_init(
     ecs_block_allocator_t *ba,
     ecs_size_t size)
@@ -62,7 +481,7 @@ void flecs_ballocator_init(
     ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
     ba->data_size = size;
 #ifdef FLECS_SANITIZE
-    size += ECS_SIZEOF(int64_t);
+    size += flecs_balloc_header(size);
 #endif
     ba->chunk_size = ECS_ALIGN(size, 16);
     ba->chunks_per_block = ECS_MAX(4096 / ba->chunk_size, 1);
@@ -70,6 +489,11 @@ void flecs_ballocator_init(
     ba->head = NULL;
     ba->block_head = NULL;
     ba->block_tail = NULL;
+    ba->alloc_count = 0;
+    ba->page_count = 0;
+    ba->huge_page_advised_count = 0;
+    ba->free_count = 0;
+    ba->depot = NULL;
 }
 
 ecs_block_allocator_t* flecs_ballocator_new(
@@ -90,14 +514,29 @@ void flecs_ballocator_fini(
         "(size = %u)", (uint32_t)ba->data_size);
 #endif
 
-    ecs_block_allocator_block_t *block;
-    for (block = ba->block_head; block;) {
-        ecs_block_allocator_block_t *next = block->next;
-        ecs_os_free(block);
-        ecs_os_linc(&ecs_block_allocator_free_count);
-        block = next;
+    ecs_block_allocator_depot_t *depot = ba->depot;
+    if (depot) {
+        /* Chunks of this allocator may be in use by other allocators of the
+         * depot, so transfer ownership of blocks & free chunks to the depot */
+        if (ba->head) {
+            flecs_balloc_depot_put(ba, ba->head);
+        }
+        if (ba->block_head) {
+            ecs_os_mutex_lock(depot->lock);
+            ecs_block_allocator_depot_size_t *ds = 
+                flecs_balloc_depot_ensure(ba);
+            ba->block_tail->next = ds->blocks;
+            ds->blocks = ba->block_head;
+            ecs_os_mutex_unlock(depot->lock);
+        }
+    } else {
+        flecs_balloc_depot_free_blocks(ba->block_head);
     }
+
+    ba->head = NULL;
     ba->block_head = NULL;
+    ba->block_tail = NULL;
+    ba->free_count = 0;
 }
 
 void flecs_ballocator_free(
@@ -117,18 +556,29 @@ void* flecs_balloc(
 
     if (!ba) return NULL;
 
-    if (!ba->head) {
-        ba->head = flecs_balloc_block(ba);
-    }
+    if (flecs_balloc_is_large(ba)) {
+        result = flecs_balloc_large(ba, NULL, NULL);
+    } else {
+        if (!ba->head) {
+            if (ba->depot) {
+                ba->head = flecs_balloc_depot_get(ba);
+            }
+            if (!ba->head) {
+                ba->head = flecs_balloc_block(ba);
+                ba->free_count += ba->chunks_per_block;
+            }
+        }
 
-    result = ba->head;
-    ba->head = ba->head->next;
+        result = ba->head;
+        ba->head = ba->head->next;
+        ba->free_count --;
+    }
 
 #ifdef FLECS_SANITIZE
     ecs_assert(ba->alloc_count >= 0, ECS_INTERNAL_ERROR, "corrupted allocator");
     ba->alloc_count ++;
     *(int64_t*)result = ba->chunk_size;
-    result = ECS_OFFSET(result, ECS_SIZEOF(int64_t));
+    result = ECS_OFFSET(result, flecs_balloc_header(ba->data_size));
 #endif
 #endif
 
@@ -170,7 +620,7 @@ void flecs_bfree(
     }
 
 #ifdef FLECS_SANITIZE
-    memory = ECS_OFFSET(memory, -ECS_SIZEOF(int64_t));
+    memory = ECS_OFFSET(memory, -flecs_balloc_header(ba->data_size));
     if (*(int64_t*)memory != ba->chunk_size) {
         ecs_err("chunk %p returned to wrong allocator "
             "(chunk = %ub, allocator = %ub)",
@@ -181,9 +631,19 @@ void flecs_bfree(
     ba->alloc_count --;
 #endif
 
+    if (flecs_balloc_is_large(ba)) {
+        flecs_bfree_large(ba, memory);
+        return;
+    }
+
     ecs_block_allocator_chunk_header_t *chunk = memory;
     chunk->next = ba->head;
     ba->head = chunk;
+    ba->free_count ++;
+
+    if (ba->depot) {
+        flecs_bfree_to_depot(ba);
+    }
     ecs_assert(ba->alloc_count >= 0, ECS_INTERNAL_ERROR, "corrupted allocator");
 }
 
@@ -200,6 +660,32 @@ void* flecs_brealloc(
         return memory;
     }
 
+    if (memory && dst && src && 
+        flecs_balloc_is_large(dst) && flecs_balloc_is_large(src)) 
+    {
+        /* Let the OS allocator resize the chunk, which can avoid a copy */
+#ifdef FLECS_SANITIZE
+        memory = ECS_OFFSET(memory, -flecs_balloc_header(src->data_size));
+        ecs_assert(*(int64_t*)memory == src->chunk_size, 
+            ECS_INTERNAL_ERROR, NULL);
+        src->alloc_count --;
+        dst->alloc_count ++;
+#endif
+        result = flecs_balloc_large(dst, src, memory);
+#ifdef FLECS_SANITIZE
+        *(int64_t*)result = dst->chunk_size;
+        ecs_size_t src_header = flecs_balloc_header(src->data_size);
+        ecs_size_t dst_header = flecs_balloc_header(dst->data_size);
+        if (src_header != dst_header) {
+            ecs_os_memmove(ECS_OFFSET(result, dst_header), 
+                ECS_OFFSET(result, src_header), 
+                    ECS_MIN(src->data_size, dst->data_size));
+        }
+        result = ECS_OFFSET(result, dst_header);
+#endif
+        return result;
+    }
+
     result = flecs_balloc(dst);
     if (result && src) {
         ecs_size_t size = src->data_size;
@@ -7,11 +7,6 @@
 
 #include "../private_api.h"
 
-/* The ratio used to determine whether the map should flecs_map_rehash. If
- * (element_count * ECS_LOAD_FACTOR) > bucket_count, bucket count is increased. */
-#define ECS_LOAD_FACTOR (12)
-#define ECS_BUCKET_END(b, c) ECS_ELEM_T(b, ecs_bucket_t, c)
-
 static
 uint8_t flecs_log2(uint32_t v) {
     static const uint8_t log2table[32] = 
@@ -26,6 +21,475 @@ uint8_t flecs_log2(uint32_t v) {
     return log2table[(uint32_t)(v * 0x07C4ACDDU) >> 27];
 }
 
+#ifdef FLECS_MAP_SWISS
+
+/* Open addressing map. The control bytes of a map are probed a group of
+ * FLECS_MAP_GROUP_SIZE slots at a time. A control byte is either empty, deleted
+ * or contains 7 bits of the hash of the key in the slot. Only keys of slots
+ * with a matching control byte are compared, so that most lookups only load a
+ * single key. A probe sequence ends at the first group with an empty slot.
+ *
+ * The group index is determined by the upper bits of the key hash (fibonacci
+ * hashing), the control byte by the bits below it. Maps with less slots than
+ * the group size pad the control bytes with empty slots. */
+
+#define FLECS_MAP_GROUP_SIZE (16)
+#define FLECS_MAP_MIN_CAPACITY (4)
+#define FLECS_MAP_EMPTY ((int8_t)-128)
+#define FLECS_MAP_DELETED ((int8_t)-2)
+
+/* Max number of used (full or deleted) slots before the map is rehashed */
+#define FLECS_MAP_MAX_LOAD(capacity) ((capacity) - ((capacity) >> 3))
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLECS_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+/* Get bitmask of slots in group with control byte equal to h */
+static
+uint32_t flecs_map_match(
+    const int8_t *ctrl,
+    int8_t h)
+{
+#ifdef FLECS_MAP_SSE2
+    __m128i group = _mm_loadu_si128((const __m128i*)(const void*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(group, _mm_set1_epi8(h)));
+#else
+    uint32_t result = 0;
+    int32_t i;
+    for (i = 0; i < FLECS_MAP_GROUP_SIZE; i ++) {
+        result |= (uint32_t)(ctrl[i] == h) << i;
+    }
+    return result;
+#endif
+}
+
+/* Get bitmask of empty or deleted slots in group */
+static
+uint32_t flecs_map_match_free(
+    const int8_t *ctrl)
+{
+#ifdef FLECS_MAP_SSE2
+    /* Empty and deleted are the only control bytes with the sign bit set */
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_loadu_si128((const __m128i*)(const void*)ctrl));
+#else
+    uint32_t result = 0;
+    int32_t i;
+    for (i = 0; i < FLECS_MAP_GROUP_SIZE; i ++) {
+        result |= (uint32_t)(ctrl[i] < 0) << i;
+    }
+    return result;
+#endif
+}
+
+/* Index of lowest set bit in group mask */
+static
+int32_t flecs_map_ctz(
+    uint32_t mask)
+{
+    ecs_assert(mask != 0, ECS_INTERNAL_ERROR, NULL);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int32_t result = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        result ++;
+    }
+    return result;
+#endif
+}
+
+static
+uint64_t flecs_map_hash(
+    ecs_map_key_t key)
+{
+    return 11400714819323198485ull * key;
+}
+
+/* Get index of first group in probe sequence. The shift is 64 for maps with a
+ * single group, so shift in two steps to avoid undefined behavior. */
+static
+int32_t flecs_map_get_group(
+    uint8_t bucket_shift,
+    uint64_t hash)
+{
+    return (int32_t)((hash >> (bucket_shift - 1)) >> 1);
+}
+
+/* Get control byte for hash */
+static
+int8_t flecs_map_get_h2(
+    uint8_t bucket_shift,
+    uint64_t hash)
+{
+    return (int8_t)((hash >> (bucket_shift - 8)) & 0x7F);
+}
+
+/* Control bytes of maps without slots, so lookups don't have to test for it */
+static const int8_t flecs_map_empty_group[FLECS_MAP_GROUP_SIZE] = {
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY,
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY,
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY,
+    FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY, FLECS_MAP_EMPTY
+};
+
+static
+int32_t flecs_map_group_count(
+    int32_t capacity)
+{
+    return ECS_MAX(1, capacity / FLECS_MAP_GROUP_SIZE);
+}
+
+/* Storage of a map contains the slots, followed by the control bytes, followed
+ * by the number of deleted slots. The storage is kept in the buckets member, so
+ * that ecs_map_t has the same layout as without FLECS_MAP_SWISS. */
+static
+ecs_size_t flecs_map_storage_size(
+    int32_t capacity)
+{
+    return capacity * 2 * ECS_SIZEOF(ecs_map_data_t) +
+        ECS_MAX(capacity, FLECS_MAP_GROUP_SIZE) + ECS_SIZEOF(int32_t);
+}
+
+static
+ecs_map_data_t* flecs_map_slots(
+    const ecs_map_t *map)
+{
+    return (ecs_map_data_t*)(void*)map->buckets;
+}
+
+static
+int8_t* flecs_map_ctrl(
+    const ecs_map_t *map)
+{
+    if (!map->buckets) {
+        return ECS_CONST_CAST(int8_t*, flecs_map_empty_group);
+    }
+    return ECS_OFFSET(map->buckets, 
+        map->bucket_count * 2 * ECS_SIZEOF(ecs_map_data_t));
+}
+
+/* Only valid for maps with storage */
+static
+int32_t* flecs_map_deleted(
+    const ecs_map_t *map)
+{
+    ecs_assert(map->buckets != NULL, ECS_INTERNAL_ERROR, NULL);
+    return ECS_OFFSET(flecs_map_ctrl(map), 
+        ECS_MAX(map->bucket_count, FLECS_MAP_GROUP_SIZE));
+}
+
+/* Find slot with key, return pointer to key/value pair */
+static
+ecs_map_data_t* flecs_map_find(
+    const ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_assert(map != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(map->bucket_shift != 0, ECS_INVALID_PARAMETER, NULL);
+
+    uint64_t hash = flecs_map_hash(key);
+    uint8_t shift = map->bucket_shift;
+    int8_t h2 = flecs_map_get_h2(shift, hash);
+    int32_t group = flecs_map_get_group(shift, hash);
+    int32_t probe = 0, mask = 0;
+    const int8_t *map_ctrl = flecs_map_ctrl(map);
+    ecs_map_data_t *slots = flecs_map_slots(map);
+
+    for (;;) {
+        int32_t first = group * FLECS_MAP_GROUP_SIZE;
+        const int8_t *ctrl = &map_ctrl[first];
+        uint32_t match = flecs_map_match(ctrl, h2);
+        while (match) {
+            ecs_map_data_t *kv = &slots[
+                (first + flecs_map_ctz(match)) * 2];
+            if (kv[0] == key) {
+                return kv;
+            }
+            match &= match - 1;
+        }
+
+        if (flecs_map_match(ctrl, FLECS_MAP_EMPTY)) {
+            return NULL;
+        }
+
+        if (!probe) {
+            mask = flecs_map_group_count(map->bucket_count) - 1;
+        }
+        if (++ probe > mask) {
+            return NULL;
+        }
+
+        /* Triangular probing visits all groups for power of 2 counts */
+        group = (group + probe) & mask;
+    }
+}
+
+/* Find empty or deleted slot for hash */
+static
+int32_t flecs_map_find_free(
+    const ecs_map_t *map,
+    uint64_t hash)
+{
+    int32_t capacity = map->bucket_count;
+    int32_t group = flecs_map_get_group(map->bucket_shift, hash);
+    int32_t probe, mask = flecs_map_group_count(capacity) - 1;
+    uint32_t valid = 0xFFFF;
+    if (capacity < FLECS_MAP_GROUP_SIZE) {
+        valid = (1u << capacity) - 1;
+    }
+
+    const int8_t *ctrl = flecs_map_ctrl(map);
+    for (probe = 0; probe <= mask; probe ++) {
+        int32_t first = group * FLECS_MAP_GROUP_SIZE;
+        uint32_t match = flecs_map_match_free(&ctrl[first]) & valid;
+        if (match) {
+            return first + flecs_map_ctz(match);
+        }
+        group = (group + probe + 1) & mask;
+    }
+
+    ecs_abort(ECS_INTERNAL_ERROR, NULL);
+}
+
+/* Reallocate slots, reinsert elements & drop deleted slots */
+static
+void flecs_map_rehash(
+    ecs_map_t *map,
+    int32_t capacity)
+{
+    ecs_assert(capacity >= map->count, ECS_INTERNAL_ERROR, NULL);
+    ecs_allocator_t *a = map->allocator;
+    int32_t i, old_capacity = map->bucket_count;
+    ecs_map_data_t *old_slots = flecs_map_slots(map);
+    int8_t *old_ctrl = flecs_map_ctrl(map);
+
+    ecs_size_t size = flecs_map_storage_size(capacity);
+    if (a) {
+        map->buckets = flecs_alloc(a, size);
+    } else {
+        map->buckets = ecs_os_malloc(size);
+    }
+    map->bucket_count = capacity;
+    map->bucket_shift = (uint8_t)(64u - flecs_log2(
+        (uint32_t)flecs_map_group_count(capacity)));
+
+    ecs_map_data_t *slots = flecs_map_slots(map);
+    int8_t *ctrl = flecs_map_ctrl(map);
+    ecs_os_memset(ctrl, FLECS_MAP_EMPTY,
+        ECS_MAX(capacity, FLECS_MAP_GROUP_SIZE));
+    flecs_map_deleted(map)[0] = 0;
+
+    for (i = 0; i < old_capacity; i ++) {
+        if (old_ctrl[i] < 0) {
+            continue;
+        }
+
+        ecs_map_data_t *kv = &old_slots[i * 2];
+        uint64_t hash = flecs_map_hash(kv[0]);
+        int32_t slot = flecs_map_find_free(map, hash);
+        ctrl[slot] = flecs_map_get_h2(map->bucket_shift, hash);
+        slots[slot * 2] = kv[0];
+        slots[slot * 2 + 1] = kv[1];
+    }
+
+    if (old_slots) {
+        if (a) {
+            flecs_free(a, flecs_map_storage_size(old_capacity), old_slots);
+        } else {
+            ecs_os_free(old_slots);
+        }
+    }
+}
+
+/* Add slot for key that is not yet in the map */
+static
+ecs_map_data_t* flecs_map_add(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    int32_t capacity = map->bucket_count;
+    int32_t deleted = map->buckets ? flecs_map_deleted(map)[0] : 0;
+    if ((map->count + deleted + 1) > FLECS_MAP_MAX_LOAD(capacity)) {
+        /* Grow if the map is more than half full, otherwise only clean up
+         * deleted slots */
+        capacity = ECS_MAX(capacity, FLECS_MAP_MIN_CAPACITY);
+        if (((map->count + 1) * 2) > FLECS_MAP_MAX_LOAD(capacity)) {
+            capacity *= 2;
+        }
+        flecs_map_rehash(map, capacity);
+    }
+
+    uint64_t hash = flecs_map_hash(key);
+    int32_t slot = flecs_map_find_free(map, hash);
+    int8_t *ctrl = flecs_map_ctrl(map);
+    if (ctrl[slot] == FLECS_MAP_DELETED) {
+        flecs_map_deleted(map)[0] --;
+    }
+    ctrl[slot] = flecs_map_get_h2(map->bucket_shift, hash);
+    map->count ++;
+
+    ecs_map_data_t *kv = &flecs_map_slots(map)[slot * 2];
+    kv[0] = key;
+    return kv;
+}
+
+static
+void flecs_map_free_slots(
+    ecs_map_t *map)
+{
+    if (!map->buckets) {
+        return;
+    }
+
+    if (map->allocator) {
+        flecs_free(map->allocator,
+            flecs_map_storage_size(map->bucket_count), map->buckets);
+    } else {
+        ecs_os_free(map->buckets);
+    }
+
+    map->buckets = NULL;
+    map->bucket_count = 0;
+    map->bucket_shift = 64;
+    map->count = 0;
+}
+
+void ecs_map_init_w_params(
+    ecs_map_t *result,
+    ecs_map_params_t *params)
+{
+    /* Slots are allocated on the first insert */
+    *result = (ecs_map_t){
+        .bucket_shift = 64,
+        .allocator = params->allocator
+    };
+}
+
+void ecs_map_fini(
+    ecs_map_t *map)
+{
+    if (!ecs_map_is_init(map)) {
+        return;
+    }
+
+    flecs_map_free_slots(map);
+    map->bucket_shift = 0;
+}
+
+ecs_map_val_t* ecs_map_get(
+    const ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_data_t *kv = flecs_map_find(map, key);
+    if (kv) {
+        return &kv[1];
+    }
+    return NULL;
+}
+
+void ecs_map_insert(
+    ecs_map_t *map,
+    ecs_map_key_t key,
+    ecs_map_val_t value)
+{
+    ecs_assert(ecs_map_get(map, key) == NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_map_add(map, key)[1] = value;
+}
+
+ecs_map_val_t* ecs_map_ensure(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_data_t *kv = flecs_map_find(map, key);
+    if (!kv) {
+        kv = flecs_map_add(map, key);
+        kv[1] = 0;
+    }
+    return &kv[1];
+}
+
+ecs_map_val_t ecs_map_remove(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_data_t *kv = flecs_map_find(map, key);
+    if (!kv) {
+        return 0;
+    }
+
+    int32_t slot = (int32_t)(kv - flecs_map_slots(map)) / 2;
+    int32_t first = slot - (slot % FLECS_MAP_GROUP_SIZE);
+    int8_t *ctrl = flecs_map_ctrl(map);
+
+    /* If the group has an empty slot no probe sequence continues past it, so
+     * the slot can be marked empty instead of deleted. */
+    if (flecs_map_match(&ctrl[first], FLECS_MAP_EMPTY)) {
+        ctrl[slot] = FLECS_MAP_EMPTY;
+    } else {
+        ctrl[slot] = FLECS_MAP_DELETED;
+        flecs_map_deleted(map)[0] ++;
+    }
+
+    map->count --;
+    return kv[1];
+}
+
+void ecs_map_clear(
+    ecs_map_t *map)
+{
+    ecs_assert(map != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_map_free_slots(map);
+}
+
+ecs_map_iter_t ecs_map_iter(
+    const ecs_map_t *map)
+{
+    if (ecs_map_is_init(map)) {
+        return (ecs_map_iter_t){
+            .map = map
+        };
+    } else {
+        return (ecs_map_iter_t){ 0 };
+    }
+}
+
+bool ecs_map_next(
+    ecs_map_iter_t *iter)
+{
+    const ecs_map_t *map = iter->map;
+    if (!map) {
+        return false;
+    }
+
+    /* Continue after the slot of the last returned element */
+    const int8_t *ctrl = flecs_map_ctrl(map);
+    ecs_map_data_t *slots = flecs_map_slots(map);
+    int32_t i, count = map->bucket_count;
+    i = iter->res ? (int32_t)(iter->res - slots) / 2 + 1 : 0;
+    for (; i < count; i ++) {
+        if (ctrl[i] >= 0) {
+            iter->res = &slots[i * 2];
+            return true;
+        }
+    }
+
+    iter->map = NULL;
+    return false;
+}
+
+#else
+
+/* The ratio used to determine whether the map should flecs_map_rehash. If
+ * (element_count * ECS_LOAD_FACTOR) > bucket_count, bucket count is increased. */
+#define ECS_LOAD_FACTOR (12)
+#define ECS_BUCKET_END(b, c) ECS_ELEM_T(b, ecs_bucket_t, c)
+
 /* Get bucket count for number of elements */
 static
 int32_t flecs_map_get_bucket_count(
@@ -176,20 +640,6 @@ void flecs_map_rehash(
     }
 }
 
-void ecs_map_params_init(
-    ecs_map_params_t *params,
-    ecs_allocator_t *allocator)
-{
-    params->allocator = allocator;
-    flecs_ballocator_init_t(&params->entry_allocator, ecs_bucket_entry_t);
-}
-
-void ecs_map_params_fini(
-    ecs_map_params_t *params)
-{
-    flecs_ballocator_fini(&params->entry_allocator);
-}
-
 void ecs_map_init_w_params(
     ecs_map_t *result,
     ecs_map_params_t *params)
@@ -208,33 +658,6 @@ void ecs_map_init_w_params(
     flecs_map_rehash(result, 0);
 }
 
-void ecs_map_init_w_params_if(
-    ecs_map_t *result,
-    ecs_map_params_t *params)
-{
-    if (!ecs_map_is_init(result)) {
-        ecs_map_init_w_params(result, params);
-    }
-}
-
-void ecs_map_init(
-    ecs_map_t *result,
-    ecs_allocator_t *allocator)
-{
-    ecs_map_init_w_params(result, &(ecs_map_params_t) {
-        .allocator = allocator
-    });
-}
-
-void ecs_map_init_if(
-    ecs_map_t *result,
-    ecs_allocator_t *allocator)
-{
-    if (!ecs_map_is_init(result)) {
-        ecs_map_init(result, allocator);
-    }   
-}
-
 void ecs_map_fini(
     ecs_map_t *map)
 {
@@ -279,18 +702,6 @@ ecs_map_val_t* ecs_map_get(
     return flecs_map_bucket_get(flecs_map_get_bucket(map, key), key);
 }
 
-void* ecs_map_get_deref_(
-    const ecs_map_t *map,
-    ecs_map_key_t key)
-{
-    ecs_map_val_t* ptr = flecs_map_bucket_get(
-        flecs_map_get_bucket(map, key), key);
-    if (ptr) {
-        return (void*)(uintptr_t)ptr[0];
-    }
-    return NULL;
-}
-
 void ecs_map_insert(
     ecs_map_t *map,
     ecs_map_key_t key,
@@ -308,16 +719,6 @@ void ecs_map_insert(
     flecs_map_bucket_add(map->entry_allocator, bucket, key)[0] = value;
 }
 
-void* ecs_map_insert_alloc(
-    ecs_map_t *map,
-    ecs_size_t elem_size,
-    ecs_map_key_t key)
-{
-    void *elem = ecs_os_calloc(elem_size);
-    ecs_map_insert_ptr(map, key, (uintptr_t)elem);
-    return elem;
-}
-
 ecs_map_val_t* ecs_map_ensure(
     ecs_map_t *map,
     ecs_map_key_t key)
@@ -341,21 +742,6 @@ ecs_map_val_t* ecs_map_ensure(
     return v;
 }
 
-void* ecs_map_ensure_alloc(
-    ecs_map_t *map,
-    ecs_size_t elem_size,
-    ecs_map_key_t key)
-{
-    ecs_map_val_t *val = ecs_map_ensure(map, key);
-    if (!*val) {
-        void *elem = ecs_os_calloc(elem_size);
-        *val = (ecs_map_val_t)(uintptr_t)elem;
-        return elem;
-    } else {
-        return (void*)(uintptr_t)*val;
-    }
-}
-
 ecs_map_val_t ecs_map_remove(
     ecs_map_t *map,
     ecs_map_key_t key)
@@ -363,16 +749,6 @@ ecs_map_val_t ecs_map_remove(
     return flecs_map_bucket_remove(map, flecs_map_get_bucket(map, key), key);
 }
 
-void ecs_map_remove_free(
-    ecs_map_t *map,
-    ecs_map_key_t key)
-{
-    ecs_map_val_t val = ecs_map_remove(map, key);
-    if (val) {
-        ecs_os_free((void*)(uintptr_t)val);
-    }
-}
-
 void ecs_map_clear(
     ecs_map_t *map)
 {
@@ -446,6 +822,95 @@ bool ecs_map_next(
     return true;
 }
 
+#endif
+
+void ecs_map_params_init(
+    ecs_map_params_t *params,
+    ecs_allocator_t *allocator)
+{
+    params->allocator = allocator;
+    flecs_ballocator_init_t(&params->entry_allocator, ecs_bucket_entry_t);
+}
+
+void ecs_map_params_fini(
+    ecs_map_params_t *params)
+{
+    flecs_ballocator_fini(&params->entry_allocator);
+}
+
+void ecs_map_init_w_params_if(
+    ecs_map_t *result,
+    ecs_map_params_t *params)
+{
+    if (!ecs_map_is_init(result)) {
+        ecs_map_init_w_params(result, params);
+    }
+}
+
+void ecs_map_init(
+    ecs_map_t *result,
+    ecs_allocator_t *allocator)
+{
+    ecs_map_init_w_params(result, &(ecs_map_params_t) {
+        .allocator = allocator
+    });
+}
+
+void ecs_map_init_if(
+    ecs_map_t *result,
+    ecs_allocator_t *allocator)
+{
+    if (!ecs_map_is_init(result)) {
+        ecs_map_init(result, allocator);
+    }   
+}
+
+void* ecs_map_get_deref_(
+    const ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_val_t* ptr = ecs_map_get(map, key);
+    if (ptr) {
+        return (void*)(uintptr_t)ptr[0];
+    }
+    return NULL;
+}
+
+void* ecs_map_insert_alloc(
+    ecs_map_t *map,
+    ecs_size_t elem_size,
+    ecs_map_key_t key)
+{
+    void *elem = ecs_os_calloc(elem_size);
+    ecs_map_insert_ptr(map, key, (uintptr_t)elem);
+    return elem;
+}
+
+void* ecs_map_ensure_alloc(
+    ecs_map_t *map,
+    ecs_size_t elem_size,
+    ecs_map_key_t key)
+{
+    ecs_map_val_t *val = ecs_map_ensure(map, key);
+    if (!*val) {
+        void *elem = ecs_os_calloc(elem_size);
+        *val = (ecs_map_val_t)(uintptr_t)elem;
+        return elem;
+    } else {
+        return (void*)(uintptr_t)*val;
+    }
+}
+
+void ecs_map_remove_free(
+    ecs_map_t *map,
+    ecs_map_key_t key)
+{
+    ecs_map_val_t val = ecs_map_remove(map, key);
+    if (val) {
+        ecs_os_free((void*)(uintptr_t)val);
+    }
+}
+
 void ecs_map_copy(
     ecs_map_t *dst,
     const ecs_map_t *src)
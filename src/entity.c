@@ -662,9 +662,16 @@ void flecs_move_entity(
     flecs_notify_on_remove(
         world, src_table, dst_table, src_row, 1, &diff->removed);
 
-    /* Copy entity & components from src_table to dst_table */
+    /* Copy entity & components from src_table to dst_table. If the tables
+     * were found by traversing a single edge, use the edge's move plan. */
+    ecs_table_move_plan_t *plan = NULL;
+    ecs_graph_edge_t *edge = diff->edge;
+    if (edge && (edge->from == src_table) && (edge->to == dst_table)) {
+        plan = flecs_table_edge_move_plan(world, edge);
+    }
+
     flecs_table_move(world, entity, entity, dst_table, dst_row, 
-        src_table, src_row, ctor);
+        src_table, src_row, ctor, plan);
 
     /* Update entity index & delete old data after running remove actions */
     record->table = dst_table;
@@ -703,6 +710,7 @@ void flecs_delete_entity(
 static
 void flecs_update_component_monitor_w_array(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_type_t *ids)
 {
     if (!ids) {
@@ -713,22 +721,24 @@ void flecs_update_component_monitor_w_array(
     for (i = 0; i < ids->count; i ++) {
         ecs_entity_t id = ids->array[i];
         if (ECS_HAS_ID_FLAG(id, PAIR)) {
-            flecs_monitor_mark_dirty(world, 
+            flecs_monitor_mark_dirty(world, entity,
                 ecs_pair(ECS_PAIR_FIRST(id), EcsWildcard));
+            flecs_id_record_trav_changed(world, ECS_PAIR_FIRST(id));
         }
 
-        flecs_monitor_mark_dirty(world, id);
+        flecs_monitor_mark_dirty(world, entity, id);
     }
 }
 
 static
 void flecs_update_component_monitors(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_type_t *added,
     ecs_type_t *removed)
 {
-    flecs_update_component_monitor_w_array(world, added);
-    flecs_update_component_monitor_w_array(world, removed);
+    flecs_update_component_monitor_w_array(world, entity, added);
+    flecs_update_component_monitor_w_array(world, entity, removed);
 }
 
 static
@@ -766,7 +776,7 @@ void flecs_commit(
 
     if (src_table) {
         ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecs_table_traversable_add(dst_table, is_trav);
+        flecs_table_traversable_add(world, dst_table, is_trav);
 
         if (dst_table->type.count) { 
             flecs_move_entity(world, entity, record, dst_table, diff, 
@@ -776,9 +786,9 @@ void flecs_commit(
             record->table = NULL;
         }
 
-        flecs_table_traversable_add(src_table, -is_trav);
+        flecs_table_traversable_add(world, src_table, -is_trav);
     } else {        
-        flecs_table_traversable_add(dst_table, is_trav);
+        flecs_table_traversable_add(world, dst_table, is_trav);
         if (dst_table->type.count) {
             flecs_new_entity(world, entity, record, dst_table, diff, 
                 construct, evt_flags);
@@ -791,7 +801,8 @@ void flecs_commit(
      * update the matched tables when the application adds or removes a 
      * component from, for example, a container. */
     if (is_trav) {
-        flecs_update_component_monitors(world, &diff->added, &diff->removed);
+        flecs_update_component_monitors(world, entity, 
+            &diff->added, &diff->removed);
     }
 
     if ((!src_table || !src_table->type.count) && world->range_check_enabled) {
@@ -844,14 +855,8 @@ const ecs_entity_t* flecs_bulk_new(
     int32_t row = flecs_table_appendn(world, table, data, count, entities);
 
     /* Update entity index. */
-    int i;
-    ecs_record_t **records = ecs_vec_first(&data->records);
-    for (i = 0; i < count; i ++) {
-        ecs_record_t *r = flecs_entities_get(world, entities[i]);
-        r->table = table;
-        r->row = ECS_ROW_TO_RECORD(row + i, 0);
-        records[row + i] = r;
-    }
+    ecs_record_t **records = ecs_vec_get_t(&data->records, ecs_record_t*, row);
+    flecs_entities_set_table(world, entities, count, table, row, records);
 
     flecs_defer_begin(world, &world->stages[0]);
     flecs_notify_on_add(world, table, NULL, row, count, &diff->added, 
@@ -1115,6 +1120,7 @@ void flecs_notify_on_set(
 }
 
 void flecs_record_add_flag(
+    ecs_world_t *world,
     ecs_record_t *record,
     uint32_t flag)
 {
@@ -1122,7 +1128,7 @@ void flecs_record_add_flag(
         if (!(record->row & flag)) {
             ecs_table_t *table = record->table;
             if (table) {
-                flecs_table_traversable_add(table, 1);
+                flecs_table_traversable_add(world, table, 1);
             }
         }
     }
@@ -1136,7 +1142,7 @@ void flecs_add_flag(
 {
     ecs_record_t *record = flecs_entities_get_any(world, entity);
     ecs_assert(record != NULL, ECS_INTERNAL_ERROR, NULL);
-    flecs_record_add_flag(record, flag);
+    flecs_record_add_flag(world, record, flag);
 }
 
 /* -- Public functions -- */
@@ -1219,11 +1225,10 @@ ecs_entity_t ecs_new_id(
          * sure OS API has threading functions initialized */
         ecs_assert(ecs_os_has_threading(), ECS_INVALID_OPERATION, NULL);
 
-        /* Can't atomically increase number above max int */
-        ecs_assert(flecs_entities_max_id(unsafe_world) < UINT_MAX, 
-            ECS_INVALID_OPERATION, NULL);
-        entity = (ecs_entity_t)ecs_os_ainc(
-            (int32_t*)&flecs_entities_max_id(unsafe_world));
+        /* Stages create ids from a reserved range, so that the merge can
+         * tell them apart from ids that were never created */
+        entity = flecs_stage_new_id(unsafe_world, 
+            ECS_CONST_CAST(ecs_stage_t*, stage));
     } else {
         entity = flecs_entities_new_id(unsafe_world);
     }
@@ -1239,6 +1244,16 @@ error:
     return 0;
 }
 
+ecs_entity_t flecs_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (world->flags & EcsWorldMultiThreaded) {
+        return ecs_new_id((ecs_world_t*)stage);
+    }
+    return ecs_new_id(world);
+}
+
 ecs_entity_t ecs_new_low_id(
     ecs_world_t *world)
 {
@@ -1285,7 +1300,7 @@ ecs_entity_t ecs_new_w_id(
     ecs_check(!id || ecs_id_is_valid(world, id), ECS_INVALID_PARAMETER, NULL);
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);    
-    ecs_entity_t entity = ecs_new_id(world);
+    ecs_entity_t entity = flecs_new_id(world, stage);
 
     ecs_id_t ids[3];
     ecs_type_t to_add = { .array = ids, .count = 0 };
@@ -1349,8 +1364,8 @@ ecs_entity_t ecs_new_w_table(
 {
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
 
-    flecs_stage_from_world(&world);    
-    ecs_entity_t entity = ecs_new_id(world);
+    ecs_stage_t *stage = flecs_stage_from_world(&world);    
+    ecs_entity_t entity = flecs_new_id(world, stage);
     ecs_record_t *r = flecs_entities_get(world, entity);
 
     ecs_table_diff_t table_diff = { .added = table->type };
@@ -1746,7 +1761,7 @@ ecs_entity_t ecs_entity_init(
             if (desc->use_low_id) {
                 result = ecs_new_low_id(world);
             } else {
-                result = ecs_new_id(world);
+                result = flecs_new_id(world, stage);
             }
             flecs_new_entity = true;
             ecs_assert(ecs_get_type(world, result) == NULL,
@@ -1908,6 +1923,8 @@ ecs_entity_t ecs_component_init(
     ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_check(desc != NULL, ECS_INVALID_PARAMETER, NULL);
     ecs_check(desc->_canary == 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!(desc->type.alignment & (desc->type.alignment - 1)),
+        ECS_INVALID_COMPONENT_ALIGNMENT, "alignment must be a power of 2");
 
     /* If existing entity is provided, check if it is already registered as a
      * component and matches the size/alignment. This can prevent having to
@@ -2036,7 +2053,7 @@ void ecs_clear(
         r->table = NULL;
 
         if (r->row & EcsEntityIsTraversable) {
-            flecs_table_traversable_add(table, -1);
+            flecs_table_traversable_add(world, table, -1);
         }
     }    
 
@@ -2192,7 +2209,7 @@ void flecs_update_monitors_for_delete(
     ecs_world_t *world,
     ecs_id_t id)
 {
-    flecs_update_component_monitors(world, NULL, &(ecs_type_t){
+    flecs_update_component_monitors(world, 0, NULL, &(ecs_type_t){
         .array = (ecs_id_t[]){id},
         .count = 1
     });
@@ -2588,7 +2605,7 @@ void ecs_delete(
             if (row_flags & EcsEntityIsTraversable) {
                 table = r->table;
                 if (table) {
-                    flecs_table_traversable_add(table, -1);
+                    flecs_table_traversable_add(world, table, -1);
                 }
             }
             /* Merge operations before deleting entity */
@@ -2646,6 +2663,278 @@ error:
     return;
 }
 
+/* Move entities that are all stored in src_table to dst_table. OnAdd observers
+ * are notified once for the range of rows the entities are moved to. */
+static
+void flecs_commit_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_table_t *src_table,
+    ecs_table_t *dst_table,
+    ecs_table_diff_t *diff)
+{
+    ecs_assert(!(world->flags & EcsWorldReadonly), ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t dst_row = ecs_table_count(dst_table);
+    int32_t src_count = ecs_table_count(src_table);
+    bool is_trav = false;
+    int32_t i;
+
+    if (!src_table->type.count && world->range_check_enabled) {
+        /* Entities get their first components, check that they're in range */
+        for (i = 0; i < count; i ++) {
+            ecs_check(!world->info.max_id || 
+                entities[i] <= world->info.max_id, ECS_OUT_OF_RANGE, 0);
+            ecs_check(entities[i] >= world->info.min_id, 
+                ECS_OUT_OF_RANGE, 0);
+        }
+    }
+
+    if ((count == src_count) && !ecs_os_memcmp(entities, 
+        ecs_vec_first(&src_table->data.entities), 
+            ECS_SIZEOF(ecs_entity_t) * count))
+    {
+        /* Entities are all entities in the table, move storage of the entire
+         * table at once. */
+        for (i = 0; i < count; i ++) {
+            flecs_journal(world, EcsJournalMove, entities[i], 
+                &diff->added, &diff->removed);
+        }
+
+        flecs_notify_on_remove(
+            world, src_table, dst_table, 0, count, &diff->removed);
+        is_trav = src_table->_->traversable_count != 0;
+        flecs_table_move_all(world, dst_table, src_table);
+    } else {
+        ecs_table_move_plan_t *plan = NULL;
+        ecs_graph_edge_t *edge = diff->edge;
+        if (edge && (edge->from == src_table) && (edge->to == dst_table)) {
+            plan = flecs_table_edge_move_plan(world, edge);
+        }
+
+        flecs_table_set_size(world, dst_table, &dst_table->data, 
+            dst_row + count);
+
+        for (i = 0; i < count; i ++) {
+            ecs_entity_t e = entities[i];
+            ecs_record_t *r = flecs_entities_get(world, e);
+            if (r->table != src_table) {
+                /* Entity was already moved (it's in the array twice) */
+                continue;
+            }
+
+            flecs_journal(world, EcsJournalMove, e, 
+                &diff->added, &diff->removed);
+
+            int32_t src_row = ECS_RECORD_TO_ROW(r->row);
+            int32_t trav = (r->row & EcsEntityIsTraversable) != 0;
+            flecs_table_traversable_add(world, dst_table, trav);
+            is_trav |= trav;
+
+            int32_t row = flecs_table_append(world, dst_table, e, r, 
+                false, false);
+            flecs_notify_on_remove(
+                world, src_table, dst_table, src_row, 1, &diff->removed);
+            flecs_table_move(world, e, e, dst_table, row, 
+                src_table, src_row, true, plan);
+
+            r->table = dst_table;
+            r->row = ECS_ROW_TO_RECORD(row, r->row & ECS_ROW_FLAGS_MASK);
+            flecs_table_delete(world, src_table, src_row, false);
+            flecs_table_traversable_add(world, src_table, -trav);
+        }
+    }
+
+    /* Moved entities are stored in consecutive rows of the destination */
+    int32_t moved = ecs_table_count(dst_table) - dst_row;
+    if (moved) {
+        flecs_notify_on_add(world, dst_table, src_table, dst_row, moved, 
+            &diff->added, 0);
+        flecs_update_name_index(world, src_table, dst_table, dst_row, moved);
+    }
+
+    if (is_trav) {
+        /* Pass each traversable entity so that queries only rematch tables
+         * that traverse the moved entities. Observers may have modified the
+         * entities, so look up records instead of reading the moved rows. */
+        for (i = 0; i < count; i ++) {
+            ecs_record_t *r = flecs_entities_try(world, entities[i]);
+            if (r && (r->row & EcsEntityIsTraversable)) {
+                flecs_update_component_monitors(world, entities[i], 
+                    &diff->added, &diff->removed);
+            }
+        }
+    }
+error:
+    return;
+}
+
+/* Add or remove id for multiple entities. Entities are grouped by consecutive
+ * runs that are stored in the same table, which are moved together. */
+static
+void flecs_add_remove_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id,
+    bool add)
+{
+    int32_t i = 0;
+    while (i < count) {
+        ecs_record_t *r = flecs_entities_get(world, entities[i]);
+        ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_table_t *src_table = r->table;
+
+        int32_t end = i + 1;
+        while ((end < count) && 
+            (flecs_entities_get(world, entities[end])->table == src_table))
+        {
+            end ++;
+        }
+
+        ecs_table_diff_t diff = ECS_TABLE_DIFF_INIT;
+        ecs_table_t *dst_table;
+        if (add) {
+            dst_table = flecs_table_traverse_add(world, src_table, &id, &diff);
+        } else {
+            dst_table = flecs_table_traverse_remove(
+                world, src_table, &id, &diff);
+        }
+
+        if (src_table && dst_table->type.count && (src_table != dst_table)) {
+            flecs_commit_n(world, &entities[i], end - i, src_table, 
+                dst_table, &diff);
+        } else if (!src_table || (src_table != dst_table) ||
+            (src_table->flags & EcsTableHasUnion))
+        {
+            /* Entities that don't have a table yet, lose all their components
+             * or for which a union relationship could have changed use the
+             * regular commit, which handles these cases. */
+            int32_t j;
+            for (j = i; j < end; j ++) {
+                ecs_entity_t e = entities[j];
+                r = flecs_entities_get(world, e);
+                ecs_table_diff_t e_diff = ECS_TABLE_DIFF_INIT;
+                if (add) {
+                    dst_table = flecs_table_traverse_add(
+                        world, r->table, &id, &e_diff);
+                } else {
+                    dst_table = flecs_table_traverse_remove(
+                        world, r->table, &id, &e_diff);
+                }
+                flecs_commit(world, e, r, dst_table, &e_diff, true, 0);
+            }
+        }
+
+        i = end;
+    }
+}
+
+static
+void flecs_add_remove_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id,
+    bool add)
+{
+    ecs_allocator_t *a = &it->real_world->allocator;
+
+    /* Collect entities first, as moving entities while iterating could cause
+     * the iterator to skip or revisit entities. */
+    ecs_vec_t entities;
+    ecs_vec_init_t(a, &entities, ecs_entity_t, 0);
+
+    while (ecs_iter_next(it)) {
+        if (it->count) {
+            ecs_os_memcpy_n(ecs_vec_grow_t(a, &entities, ecs_entity_t, 
+                it->count), it->entities, ecs_entity_t, it->count);
+        }
+    }
+
+    if (add) {
+        ecs_add_id_n(it->world, ecs_vec_first(&entities), 
+            ecs_vec_count(&entities), id);
+    } else {
+        ecs_remove_id_n(it->world, ecs_vec_first(&entities), 
+            ecs_vec_count(&entities), id);
+    }
+
+    ecs_vec_fini_t(a, &entities, ecs_entity_t);
+}
+
+void ecs_add_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || entities != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_id_is_valid(world, id), ECS_INVALID_PARAMETER, NULL);
+
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    if (flecs_defer_cmd(stage)) {
+        int32_t i;
+        for (i = 0; i < count; i ++) {
+            flecs_defer_add(stage, entities[i], id);
+        }
+        return;
+    }
+
+    flecs_add_remove_id_n(world, entities, count, id, true);
+    flecs_defer_end(world, stage);
+error:
+    return;
+}
+
+void ecs_remove_id_n(
+    ecs_world_t *world,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_id_t id)
+{
+    ecs_check(world != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(!count || entities != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_id_is_valid(world, id) || ecs_id_is_wildcard(id), 
+        ECS_INVALID_PARAMETER, NULL);
+
+    ecs_stage_t *stage = flecs_stage_from_world(&world);
+    if (flecs_defer_cmd(stage)) {
+        int32_t i;
+        for (i = 0; i < count; i ++) {
+            flecs_defer_remove(stage, entities[i], id);
+        }
+        return;
+    }
+
+    flecs_add_remove_id_n(world, entities, count, id, false);
+    flecs_defer_end(world, stage);
+error:
+    return;
+}
+
+void ecs_add_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_add_remove_id_w_iter(it, id, true);
+error:
+    return;
+}
+
+void ecs_remove_id_w_iter(
+    ecs_iter_t *it,
+    ecs_id_t id)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    flecs_add_remove_id_w_iter(it, id, false);
+error:
+    return;
+}
+
 void ecs_override_id(
     ecs_world_t *world,
     ecs_entity_t entity,
@@ -2670,7 +2959,7 @@ ecs_entity_t ecs_clone(
 
     ecs_stage_t *stage = flecs_stage_from_world(&world);
     if (!dst) {
-        dst = ecs_new_id(world);
+        dst = flecs_new_id(world, stage);
     }
 
     if (flecs_defer_clone(stage, dst, src, copy_value)) {
@@ -2692,7 +2981,7 @@ ecs_entity_t ecs_clone(
 
     if (copy_value) {
         flecs_table_move(world, dst, src, src_table,
-            row, src_table, ECS_RECORD_TO_ROW(src_r->row), true);
+            row, src_table, ECS_RECORD_TO_ROW(src_r->row), true, NULL);
         int32_t i, count = src_table->column_count;
         for (i = 0; i < count; i ++) {
             ecs_type_t type = {
@@ -3211,7 +3500,7 @@ ecs_entity_t ecs_set_id(
     ecs_stage_t *stage = flecs_stage_from_world(&world);
 
     if (!entity) {
-        entity = ecs_new_id(world);
+        entity = flecs_new_id(world, stage);
         ecs_entity_t scope = stage->scope;
         if (scope) {
             ecs_add_pair(world, entity, EcsChildOf, scope);
@@ -4510,6 +4799,118 @@ bool flecs_remove_invalid(
     return true;
 }
 
+/* Collect value of set command if it only writes a component that the entity
+ * already has, without running hooks or observers. The value is copied when
+ * the collected writes are flushed. */
+static
+bool flecs_cmd_collect_write(
+    ecs_world_t *world,
+    ecs_cmd_t *cmd)
+{
+    ecs_record_t *r = flecs_entities_get(world, cmd->entity);
+    ecs_assert(r != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_table_t *table = r->table;
+    if (!table) {
+        return false;
+    }
+
+    bool is_set = cmd->kind == EcsOpSet;
+    if (is_set && (table->flags & EcsTableHasOnSet)) {
+        return false;
+    }
+
+    const ecs_table_record_t *tr = flecs_table_record_get(
+        world, table, cmd->id);
+    if (!tr || (tr->column == -1)) {
+        return false;
+    }
+
+    const ecs_column_t *column = &table->data.columns[tr->column];
+    const ecs_type_info_t *ti = column->ti;
+    ecs_assert(ti != NULL, ECS_INTERNAL_ERROR, NULL);
+    if (ti->hooks.move_dtor || (is_set && ti->hooks.on_set)) {
+        return false;
+    }
+
+    ecs_assert(cmd->is._1.size == column->size, ECS_INTERNAL_ERROR, NULL);
+    flecs_table_mark_dirty(world, table, cmd->id);
+    flecs_merge_writes_append(world, cmd->entity, r, tr->column, 
+        cmd->is._1.value, column->size);
+
+    return true;
+}
+
+/* Test if command runs without invoking hooks or observers, and without moving
+ * entities, so that collected writes don't have to be copied before it runs */
+static
+bool flecs_cmd_is_quiet(
+    ecs_world_t *world,
+    const ecs_cmd_t *cmd,
+    bool is_alive)
+{
+    switch(cmd->kind) {
+    case EcsOpSkip:
+        /* Discarded value could have a destructor */
+        return cmd->is._1.value == NULL;
+    case EcsOpModified: {
+        if (!is_alive) {
+            return true;
+        }
+
+        ecs_record_t *r = flecs_entities_get(world, cmd->entity);
+        ecs_table_t *table = r->table;
+        if (!table || (table->flags & EcsTableHasOnSet)) {
+            return false;
+        }
+
+        const ecs_table_record_t *tr = flecs_table_record_get(
+            world, table, cmd->id);
+        if (!tr || (tr->column == -1)) {
+            return false;
+        }
+
+        return table->data.columns[tr->column].ti->hooks.on_set == NULL;
+    }
+    case EcsOpAdd:
+    case EcsOpRemove:
+    case EcsOpSet:
+    case EcsOpEmplace:
+    case EcsOpMut:
+    case EcsOpAddModified:
+    case EcsOpClone:
+    case EcsOpBulkNew:
+    case EcsOpPath:
+    case EcsOpDelete:
+    case EcsOpClear:
+    case EcsOpOnDeleteAction:
+    case EcsOpEnable:
+    case EcsOpDisable:
+        break;
+    }
+
+    return false;
+}
+
+/* Test if moving an entity between tables runs hooks or observers */
+static
+bool flecs_cmd_move_has_actions(
+    const ecs_record_t *r,
+    const ecs_table_t *src,
+    const ecs_table_t *dst)
+{
+    ecs_flags32_t actions = EcsTableHasAddActions | EcsTableHasRemoveActions |
+        EcsTableHasMove;
+    if (src && (src->flags & actions)) {
+        return true;
+    }
+    if (dst && (dst->flags & actions)) {
+        return true;
+    }
+
+    /* Entity is used by relationships, moving it can update queries */
+    return r && ECS_RECORD_TO_ROW_FLAGS(r->row);
+}
+
 static
 void flecs_cmd_batch_for_entity(
     ecs_world_t *world,
@@ -4556,6 +4957,7 @@ void flecs_cmd_batch_for_entity(
             } else {
                 /* Id was no longer valid and had a Delete policy */
                 cmd->kind = EcsOpSkip;
+                flecs_merge_writes_flush(world);
                 ecs_delete(world, entity);
                 flecs_table_diff_builder_clear(diff);
                 return;
@@ -4589,6 +4991,7 @@ void flecs_cmd_batch_for_entity(
                     const ecs_type_info_t *ti = ptr.ti;
                     ecs_iter_action_t on_set;
                     if ((on_set = ti->hooks.on_set)) {
+                        flecs_merge_writes_flush(world);
                         flecs_invoke_hook(world, start_table, 1, row, &entity,
                             ptr.ptr, cmd->id, ptr.ti, EcsOnSet, on_set);
                     }
@@ -4637,6 +5040,12 @@ void flecs_cmd_batch_for_entity(
         }
     } while ((cur = next_for_entity));
 
+    /* Values of collected writes must be copied before running code that
+     * could read them */
+    if (flecs_cmd_move_has_actions(r, start_table, table)) {
+        flecs_merge_writes_flush(world);
+    }
+
     /* Move entity to destination table in single operation */
     flecs_table_diff_build_noalloc(diff, &table_diff);
     flecs_defer_begin(world, &world->stages[0]);
@@ -4733,10 +5142,24 @@ bool flecs_defer_end(
             flecs_table_diff_builder_init(world, &diff);
             flecs_sparse_clear(&stage->cmd_entries);
 
+            /* Collect plain component writes while stages are merged */
+            bool collect_writes = merge_to_world && 
+                world->merge_writes.collect;
+
             for (i = 0; i < count; i ++) {
                 ecs_cmd_t *cmd = &cmds[i];
                 ecs_entity_t e = cmd->entity;
                 bool is_alive = flecs_entities_is_alive(world, e);
+                if (!is_alive && e && !flecs_entities_exists(world, e) &&
+                    flecs_stage_owns_id(stage, e)) 
+                {
+                    /* Entity was created by this stage while multithreaded.
+                     * The id is reserved but the entity doesn't have a record 
+                     * yet, so publish it before applying its commands. Other
+                     * ids that were never created are discarded. */
+                    flecs_entities_ensure(world, e);
+                    is_alive = true;
+                }
 
                 /* A negative index indicates the first command for an entity */
                 if (merge_to_world && (cmd->next_for_entity < 0)) {
@@ -4748,10 +5171,29 @@ bool flecs_defer_end(
                     }
                 }
 
+                ecs_cmd_kind_t kind = cmd->kind;
+                if (collect_writes) {
+                    if ((kind == EcsOpSet || kind == EcsOpMut) && is_alive &&
+                        flecs_cmd_collect_write(world, cmd))
+                    {
+                        if (kind == EcsOpSet) {
+                            world->info.cmd.set_count ++;
+                        } else {
+                            world->info.cmd.get_mut_count ++;
+                        }
+                        continue;
+                    }
+
+                    /* Other commands can run hooks and observers, or move
+                     * entities with collected writes to another table */
+                    if (!flecs_cmd_is_quiet(world, cmd, is_alive)) {
+                        flecs_merge_writes_flush(world);
+                    }
+                }
+
                 /* If entity is no longer alive, this could be because the queue
                  * contained both a delete and a subsequent add/remove/set which
                  * should be ignored. */
-                ecs_cmd_kind_t kind = cmd->kind;
                 if ((kind != EcsOpPath) && ((kind == EcsOpSkip) || (e && !is_alive))) {
                     world->info.cmd.discard_count ++;
                     flecs_discard_cmd(world, cmd);
@@ -4858,6 +5300,11 @@ bool flecs_defer_end(
                 }
             }
 
+            /* Values of collected writes are stored in the defer stack */
+            if (collect_writes) {
+                flecs_merge_writes_flush(world);
+            }
+
             ecs_vec_fini_t(&stage->allocator, &stage->commands, ecs_cmd_t);
 
             /* Restore defer queue */
@@ -1104,3 +1104,148 @@ bool ecs_worker_next(
 error:
     return false;
 }
+
+static
+void flecs_worker_chunk_iter_fini(
+    ecs_iter_t *it)
+{
+    ecs_worker_chunk_iter_t *iter = &it->priv.iter.worker_chunk;
+    if (iter->ptrs) {
+        ecs_os_free(iter->ptrs);
+        iter->ptrs = NULL;
+        it->ptrs = NULL;
+    }
+
+    if (it->chain_it) {
+        ecs_chained_iter_fini(it);
+    }
+}
+
+ecs_iter_t ecs_worker_chunk_iter(
+    const ecs_iter_t *it,
+    int32_t *claimed,
+    int32_t chunk_size)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(claimed != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(chunk_size > 0, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(ecs_os_has_threading(), ECS_MISSING_OS_API, NULL);
+
+    ecs_iter_t result = *it;
+    result.priv.cache.stack_cursor = NULL; /* Don't copy allocator cursor */
+
+    result.priv.iter.worker_chunk = (ecs_worker_chunk_iter_t){
+        .claimed = claimed,
+        .chunk_size = chunk_size
+    };
+    result.next = ecs_worker_chunk_next;
+    result.fini = flecs_worker_chunk_iter_fini;
+    result.chain_it = ECS_CONST_CAST(ecs_iter_t*, it);
+
+    return result;
+error:
+    return (ecs_iter_t){ 0 };
+}
+
+static
+bool ecs_worker_chunk_next_instanced(
+    ecs_iter_t *it)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_worker_chunk_next, ECS_INVALID_PARAMETER, NULL);
+
+    bool instanced = ECS_BIT_IS_SET(it->flags, EcsIterIsInstanced);
+
+    ecs_iter_t *chain_it = it->chain_it;
+    ecs_worker_chunk_iter_t *iter = &it->priv.iter.worker_chunk;
+    int32_t chunk_size = iter->chunk_size;
+
+    /* Claim the next chunk. Claims only ever increase, so chunks that were
+     * claimed by other workers can be skipped by moving forward through the
+     * results of the chained iterator. */
+    int32_t claim = ecs_os_ainc(iter->claimed) - 1;
+
+    while (claim >= (iter->first_chunk + iter->chunk_count)) {
+        iter->first_chunk += iter->chunk_count;
+        iter->chunk_count = 0;
+
+        if (!ecs_iter_next(chain_it)) {
+            if (iter->ptrs) {
+                ecs_os_free(iter->ptrs);
+                iter->ptrs = NULL;
+                it->ptrs = NULL;
+            }
+            return false;
+        }
+
+        if (!chain_it->table) {
+            /* Results without a table can't be split */
+            iter->chunk_count = 1;
+        } else {
+            iter->chunk_count = (chain_it->count + chunk_size - 1) / chunk_size;
+        }
+    }
+
+    /* Copy everything up to the private iterator data */
+    ecs_os_memcpy(it, chain_it, offsetof(ecs_iter_t, priv));
+
+    /* Keep instancing setting from original iterator */
+    ECS_BIT_COND(it->flags, EcsIterIsInstanced, instanced);
+
+    if (!it->table) {
+        return true;
+    }
+
+    int32_t first = (claim - iter->first_chunk) * chunk_size;
+    int32_t count = it->count - first;
+    if (count > chunk_size) {
+        count = chunk_size;
+    }
+
+    it->frame_offset += first;
+
+    /* Field pointers are advanced in place while iterating the rows of a 
+     * non-instanced result, so each chunk gets its own copy of the pointers 
+     * of the chained iterator before offsetting them. */
+    if (chain_it->ptrs && it->field_count) {
+        if (!iter->ptrs) {
+            iter->ptrs = ecs_os_malloc_n(void*, it->field_count);
+        }
+        ecs_os_memcpy_n(iter->ptrs, chain_it->ptrs, void*, it->field_count);
+        it->ptrs = iter->ptrs;
+    }
+
+    flecs_offset_iter(it, it->offset + first);
+    it->count = count;
+
+    if (ECS_BIT_IS_SET(it->flags, EcsIterIsInstanced)) {
+        it->offset += first;
+    } else {
+        it->offset = 0;
+    }
+
+    return true;
+error:
+    return false;
+}
+
+bool ecs_worker_chunk_next(
+    ecs_iter_t *it)
+{
+    ecs_check(it != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->next == ecs_worker_chunk_next, ECS_INVALID_PARAMETER, NULL);
+    ecs_check(it->chain_it != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    ECS_BIT_SET(it->chain_it->flags, EcsIterIsInstanced);
+
+    if (flecs_iter_next_row(it)) {
+        return true;
+    }
+
+    return flecs_iter_next_instanced(it, 
+        ecs_worker_chunk_next_instanced(it));
+error:
+    return false;
+}
@@ -463,6 +463,13 @@ bool ecs_os_has_heap(void) {
         (ecs_os_api.free_ != NULL);
 }
 
+bool ecs_os_has_page_alloc(void) {
+    return
+        (ecs_os_api.page_alloc_ != NULL) &&
+        (ecs_os_api.page_realloc_ != NULL) &&
+        (ecs_os_api.page_free_ != NULL);
+}
+
 bool ecs_os_has_threading(void) {
     return
         (ecs_os_api.mutex_new_ != NULL) &&
@@ -494,6 +501,14 @@ bool ecs_os_has_task_support(void) {
         (ecs_os_api.task_join_ != NULL);
 }
 
+bool ecs_os_has_futex(void) {
+    return
+        (ecs_os_api.ainc_ != NULL) &&
+        (ecs_os_api.adec_ != NULL) &&
+        (ecs_os_api.futex_wait_ != NULL) &&
+        (ecs_os_api.futex_wake_ != NULL);
+}
+
 bool ecs_os_has_time(void) {
     return 
         (ecs_os_api.get_time_ != NULL) &&
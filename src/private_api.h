@@ -56,6 +56,7 @@ void flecs_add_flag(
     uint32_t flag);
 
 void flecs_record_add_flag(
+    ecs_world_t *world,
     ecs_record_t *record,
     uint32_t flag);
 
@@ -63,6 +64,12 @@ ecs_entity_t flecs_get_oneof(
     const ecs_world_t *world,
     ecs_entity_t e);
 
+/* Create new id for operation on stage. While the world is multithreaded the
+ * id is taken from the range reserved by the stage. */
+ecs_entity_t flecs_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
 void flecs_notify_on_remove(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -110,6 +117,16 @@ void flecs_invoke_hook(
     ecs_entity_t event,
     ecs_iter_action_t hook);
 
+#ifdef FLECS_PIPELINE
+/* Run action on the main thread and on the worker threads, and wait until all
+ * threads are done. Returns false if there are no worker threads to run the
+ * action on, in which case the action isn't ran. */
+bool flecs_workers_run(
+    ecs_world_t *world,
+    ecs_worker_action_t action,
+    void *ctx);
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Query API
 ////////////////////////////////////////////////////////////////////////////////
@@ -219,6 +236,16 @@ uint64_t flecs_ito_(
 #define flecs_itoi16(value) flecs_ito(int16_t, (value))
 #define flecs_itoi32(value) flecs_ito(int32_t, (value))
 
+/* Hint to the CPU that memory at ptr will be read soon */
+#if defined(__GNUC__) || defined(__clang__)
+#define flecs_prefetch(ptr) __builtin_prefetch(ptr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define flecs_prefetch(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#else
+#define flecs_prefetch(ptr) (void)(ptr)
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 //// Entity filter
 ////////////////////////////////////////////////////////////////////////////////
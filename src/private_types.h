@@ -210,6 +210,16 @@ typedef struct ecs_query_allocators_t {
     ecs_block_allocator_t monitors;
 } ecs_query_allocators_t;
 
+/** Compiled iteration plan. Trivial queries with only And terms have the same
+ * data and written fields for each matched table, so these are resolved once 
+ * when the query is created. */
+typedef struct ecs_query_plan_t {
+    int8_t data_fields[FLECS_TERM_DESC_MAX]; /* Fields with component data */
+    int8_t out_fields[FLECS_TERM_DESC_MAX];  /* Fields written by query */
+    int8_t data_count;
+    int8_t out_count;
+} ecs_query_plan_t;
+
 /** Query that is automatically matched against tables */
 struct ecs_query_t {
     ecs_header_t hdr;
@@ -248,6 +258,9 @@ struct ecs_query_t {
     /* Flags for query properties */
     ecs_flags32_t flags;
 
+    /* Iteration plan, valid if query has EcsQueryCompiledIter */
+    ecs_query_plan_t plan;
+
     /* Monitor generation */
     int32_t monitor_generation;
 
@@ -395,6 +408,12 @@ struct ecs_stage_t {
     ecs_entity_t base;               /* Currently instantiated top-level base */
     const ecs_entity_t *lookup_path; /* Search path used by lookup operations */
 
+    /* Entity ids reserved for creating entities while multithreaded */
+    ecs_entity_t id_next;            /* Next reserved id */
+    ecs_entity_t id_end;             /* End of reserved id range */
+    int32_t id_block_size;           /* Number of ids to reserve next */
+    ecs_vec_t id_ranges;             /* Reserved [first, end) ranges, not yet merged */
+
     /* Properties */
     bool auto_merge;                 /* Should this stage automatically merge? */
     bool async;                      /* Is stage asynchronous? (write only) */
@@ -417,6 +436,9 @@ typedef struct ecs_monitor_t {
 /* Component monitors */
 typedef struct ecs_monitor_set_t {
     ecs_map_t monitors;              /* map<id, ecs_monitor_t> */
+    ecs_vec_t entities;              /* vector<ecs_entity_t>, changed entities */
+    ecs_vec_t tables;                /* vector<ecs_table_t*>, tables to rematch */
+    bool rematch_all;                /* Should queries rematch all tables? */
     bool is_dirty;                   /* Should monitors be evaluated? */
 } ecs_monitor_set_t;
 
@@ -459,6 +481,58 @@ typedef struct ecs_action_elem_t {
 } ecs_action_elem_t;
 
 typedef struct ecs_pipeline_state_t ecs_pipeline_state_t;
+typedef struct ecs_worker_job_t ecs_worker_job_t;
+
+/* Function that the main thread and workers run for a worker job */
+typedef void (*ecs_worker_action_t)(
+    ecs_stage_t *stage,
+    void *ctx);
+
+/* Component value that a merge copies to storage. The destination is looked
+ * up when the value is copied, as the row of the entity can change when other
+ * entities are moved in or out of its table. */
+typedef struct ecs_merge_write_t {
+    ecs_record_t *record;
+    int32_t column;
+    ecs_size_t size;
+    void *src;
+} ecs_merge_write_t;
+
+/* Component values collected while merging stages. Writes don't run hooks or
+ * observers, so they can be applied by multiple threads. Writes are sharded by
+ * entity id range, so that writes for the same entity are applied in order by
+ * the same thread. */
+typedef struct ecs_merge_writes_t {
+    ecs_vec_t *shards;               /* vec<ecs_merge_write_t>[shard_count] */
+    int32_t shard_count;             /* Number of shards (one per stage) */
+    int32_t count;                   /* Number of writes in all shards */
+    bool collect;                    /* Collect writes (set while merging) */
+} ecs_merge_writes_t;
+
+/* Pair id records are stored in a two level index, by relationship and then by
+ * target. Both levels are arrays of pages that are allocated on demand, and
+ * freed when they no longer contain id records. */
+#define FLECS_PAIR_INDEX_PAGE_BITS (8)
+#define FLECS_PAIR_INDEX_PAGE_SIZE (1 << FLECS_PAIR_INDEX_PAGE_BITS)
+#define FLECS_PAIR_INDEX_PAGE_MASK (FLECS_PAIR_INDEX_PAGE_SIZE - 1)
+
+/* Id records for pairs with the same relationship */
+typedef struct ecs_pair_index_t {
+    ecs_vec_t pages;                 /* vec<ecs_pair_index_page_t*> */
+    int32_t count;                   /* Number of allocated pages */
+} ecs_pair_index_t;
+
+/* Page with id records for targets of a relationship */
+typedef struct ecs_pair_index_page_t {
+    ecs_id_record_t *records[FLECS_PAIR_INDEX_PAGE_SIZE];
+    int32_t count;                   /* Number of id records in page */
+} ecs_pair_index_page_t;
+
+/* Page with relationships */
+typedef struct ecs_pair_index_rel_page_t {
+    ecs_pair_index_t rels[FLECS_PAIR_INDEX_PAGE_SIZE];
+    int32_t count;                   /* Number of relationships with pages */
+} ecs_pair_index_rel_page_t;
 
 /** The world stores and manages all ECS data. An application can have more than
  * one world, but data is not shared between worlds. */
@@ -468,6 +542,7 @@ struct ecs_world_t {
     /* --  Type metadata -- */
     ecs_id_record_t *id_index_lo;
     ecs_map_t id_index_hi;           /* map<id, ecs_id_record_t*> */
+    ecs_vec_t id_index_pairs;        /* vec<ecs_pair_index_rel_page_t*> */
     ecs_sparse_t type_info;          /* sparse<type_id, type_info_t> */
 
     /* -- Cached handle to id records -- */
@@ -500,6 +575,10 @@ struct ecs_world_t {
     /* Used to track when cache needs to be updated */
     ecs_monitor_set_t monitors;      /* map<id, ecs_monitor_t> */
 
+    /* -- Traversal cache -- */
+    ecs_map_t trav_cache;            /* map<relationship, ecs_trav_rel_cache_t*> (rules) */
+    int32_t trav_generation;         /* Last generation assigned to (R, *) record */
+
     /* -- Systems -- */
     ecs_entity_t pipeline;           /* Current pipeline */
 
@@ -510,6 +589,8 @@ struct ecs_world_t {
     /* -- Staging -- */
     ecs_stage_t *stages;             /* Stages */
     int32_t stage_count;             /* Number of stages */
+    ecs_block_allocator_depot_t *stage_depot; /* Shared by stage allocators */
+    ecs_merge_writes_t merge_writes; /* Writes collected by stage merge */
 
     /* -- Multithreading -- */
     ecs_os_cond_t worker_cond;       /* Signal that worker threads can start */
@@ -517,8 +598,15 @@ struct ecs_world_t {
     ecs_os_mutex_t sync_mutex;       /* Mutex for job_cond */
     int32_t workers_running;         /* Number of threads running */
     int32_t workers_waiting;         /* Number of workers waiting on sync */
+    int32_t workers_signal;          /* Incremented when workers can resume (futex) */
+    int32_t workers_pending;         /* Workers that haven't reached sync (futex) */
+    int32_t workers_synced;          /* Set when all workers reached sync (futex) */
+    bool workers_use_futex;          /* Sync workers with futex instead of cond */
     ecs_pipeline_state_t* pq;        /* Pointer to the pipeline for the workers to execute */
     bool workers_use_task_api;       /* Workers are short-lived tasks, not long-running threads */
+    int32_t worker_chunk_size;       /* Rows per chunk claimed by workers (0 = even split) */
+    ecs_worker_job_t *worker_job;    /* Job that workers run instead of pipeline */
+    bool parallel_systems;           /* Run independent systems in parallel */
 
     /* -- Time management -- */
     ecs_time_t world_start_time;     /* Timestamp of simulation start */
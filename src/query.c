@@ -911,10 +911,10 @@ void flecs_query_set_table_match(
             table, qm->ids, qm->columns);
 
         if (qm->entity_filter) {
-            query->flags &= ~EcsQueryTrivialIter;
+            query->flags &= ~(EcsQueryTrivialIter|EcsQueryCompiledIter);
         }
         if (table->flags & EcsTableHasUnion) {
-            query->flags &= ~EcsQueryTrivialIter;
+            query->flags &= ~(EcsQueryTrivialIter|EcsQueryCompiledIter);
         }
     }
 
@@ -1596,6 +1596,95 @@ void flecs_query_unmatch_table(
     }
 }
 
+/* Rematch a single table. Existing matches are updated in place, so that
+ * matches that don't change keep their position in the iteration list. */
+static
+void flecs_query_rematch_table(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_table_t *table,
+    int32_t var_id,
+    int32_t rematch_count)
+{
+    ecs_query_table_t *qt = ecs_table_cache_get(&query->cache, table);
+    ecs_query_table_match_t *qm = NULL;
+
+    ecs_iter_t it = flecs_filter_iter_w_flags(world, &query->filter, 
+        EcsIterMatchVar|EcsIterIsInstanced|EcsIterNoData|
+        EcsIterEntityOptional);
+    ecs_iter_set_var_as_table(&it, var_id, table);
+
+    while (ecs_filter_next(&it)) {
+        ecs_assert(it.table == table, ECS_INTERNAL_ERROR, NULL);
+        if (!qt) {
+            qt = flecs_query_table_insert(world, query, table);
+        }
+
+        if (!qm) {
+            qm = qt->first;
+        } else {
+            qm = qm->next_match;
+        }
+        if (!qm) {
+            qm = flecs_query_add_table_match(query, qt, table);
+        }
+
+        flecs_query_set_table_match(world, query, qm, table, &it);
+
+        if (ecs_table_count(table) && query->group_by) {
+            if (flecs_query_get_group_id(query, table) != qm->group_id) {
+                /* Update table group */
+                flecs_query_remove_table_node(query, qm);
+                flecs_query_insert_table_node(query, qm);
+            }
+        }
+    }
+
+    if (!qm) {
+        /* Table no longer matches */
+        if (qt) {
+            flecs_query_unmatch_table(query, table, qt);
+        }
+        return;
+    }
+
+    if (qm->next_match) {
+        flecs_query_table_match_free(query, qt, qm->next_match);
+        qm->next_match = NULL;
+    }
+
+    qt->rematch_count = rematch_count;
+}
+
+/* Test whether query can be rematched for the tables collected by the 
+ * component monitors, instead of with all tables. This requires that all terms
+ * match the This variable, as changes to other sources aren't tracked. */
+static
+int32_t flecs_query_rematch_var(
+    ecs_world_t *world,
+    ecs_query_t *query,
+    ecs_query_t *parent_query)
+{
+    if (parent_query || world->monitors.rematch_all) {
+        return -1;
+    }
+
+    ecs_filter_t *filter = &query->filter;
+    int32_t var_id = ecs_filter_find_this_var(filter);
+    if (var_id == -1) {
+        return -1;
+    }
+
+    int32_t i, count = filter->term_count;
+    for (i = 0; i < count; i ++) {
+        if (!ecs_term_match_this(&filter->terms[i])) {
+            return -1;
+        }
+    }
+
+    return var_id;
+}
+
 /* Rematch system with tables after a change happened to a watched entity */
 static
 void flecs_query_rematch_tables(
@@ -1614,6 +1703,26 @@ void flecs_query_rematch_tables(
 
     query->monitor_generation = world->monitor_generation;
 
+    world->info.rematch_count_total ++;
+    int32_t rematch_count = ++ query->rematch_count;
+
+    ecs_time_t t = {0};
+    if (world->flags & EcsWorldMeasureFrameTime) {
+        ecs_time_measure(&t);
+    }
+
+    int32_t var_id = flecs_query_rematch_var(world, query, parent_query);
+    if (var_id != -1) {
+        /* Only rematch tables that traverse one of the changed entities */
+        int32_t i, count = ecs_vec_count(&world->monitors.tables);
+        ecs_table_t **tables = ecs_vec_first(&world->monitors.tables);
+        for (i = 0; i < count; i ++) {
+            flecs_query_rematch_table(
+                world, query, tables[i], var_id, rematch_count);
+        }
+        goto done;
+    }
+
     if (parent_query) {
         parent_it = ecs_query_iter(world, parent_query);
         it = ecs_filter_chain_iter(&parent_it, &query->filter);
@@ -1625,14 +1734,6 @@ void flecs_query_rematch_tables(
     ECS_BIT_SET(it.flags, EcsIterNoData);
     ECS_BIT_SET(it.flags, EcsIterEntityOptional);
 
-    world->info.rematch_count_total ++;
-    int32_t rematch_count = ++ query->rematch_count;
-
-    ecs_time_t t = {0};
-    if (world->flags & EcsWorldMeasureFrameTime) {
-        ecs_time_measure(&t);
-    }
-
     while (ecs_filter_next(&it)) {
         if ((table != it.table) || (!it.table && !qt)) {
             if (qm && qm->next_match) {
@@ -1686,6 +1787,7 @@ void flecs_query_rematch_tables(
         }
     }
 
+done:
     if (world->flags & EcsWorldMeasureFrameTime) {
         world->info.rematch_time_total += (ecs_ftime_t)ecs_time_measure(&t);
     }
@@ -1796,7 +1898,7 @@ void flecs_query_order_by(
         flecs_query_build_sorted_tables(query);
     }
 
-    query->flags &= ~EcsQueryTrivialIter;
+    query->flags &= ~(EcsQueryTrivialIter|EcsQueryCompiledIter);
 error:
     return;
 }
@@ -2006,6 +2108,47 @@ void flecs_query_fini(
     ecs_poly_free(query, ecs_query_t);
 }
 
+/* Compile iteration plan for trivial queries with only And terms. For matches
+ * without refs all fields are owned by the table, so iteration can go straight
+ * to the table columns of the fields that have data or are written. */
+static
+void flecs_query_compile(
+    ecs_query_t *query)
+{
+    ecs_filter_t *filter = &query->filter;
+    ecs_query_plan_t *plan = &query->plan;
+    int32_t i, count = filter->term_count;
+
+    if (!(query->flags & EcsQueryTrivialIter)) {
+        return;
+    }
+    if (count != filter->field_count || count > FLECS_TERM_DESC_MAX) {
+        return;
+    }
+
+    plan->data_count = 0;
+    plan->out_count = 0;
+
+    for (i = 0; i < count; i ++) {
+        ecs_term_t *term = &filter->terms[i];
+        if (term->oper != EcsAnd || ecs_id_is_wildcard(term->id)) {
+            return;
+        }
+
+        ecs_inout_kind_t inout = term->inout;
+        if (!filter->sizes[i] || inout == EcsInOutNone) {
+            continue;
+        }
+
+        plan->data_fields[plan->data_count ++] = flecs_ito(int8_t, i);
+        if (inout != EcsIn) {
+            plan->out_fields[plan->out_count ++] = flecs_ito(int8_t, i);
+        }
+    }
+
+    query->flags |= EcsQueryCompiledIter;
+}
+
 /* -- Public API -- */
 
 ecs_query_t* ecs_query_init(
@@ -2031,6 +2174,8 @@ ecs_query_t* ecs_query_init(
 
     ECS_BIT_COND(result->flags, EcsQueryTrivialIter, 
         !!(result->filter.flags & EcsFilterMatchOnlyThis));
+    ECS_BIT_COND(result->flags, EcsQueryPrefetch, desc->prefetch);
+    flecs_query_compile(result);
 
     flecs_query_allocators_init(result);
 
@@ -2376,6 +2521,24 @@ void flecs_query_mark_columns_dirty(
 {
     ecs_table_t *table = qm->table;
     ecs_filter_t *filter = &query->filter;
+
+    if ((query->flags & EcsQueryCompiledIter) && !ecs_vec_count(&qm->refs)) {
+        /* All written fields are owned by the table, mark their columns dirty
+         * without looking up the column for each term. */
+        int32_t *dirty_state = table->dirty_state;
+        if (dirty_state) {
+            const ecs_query_plan_t *plan = &query->plan;
+            const int32_t *storage_columns = qm->storage_columns;
+            int32_t i, count = plan->out_count;
+            for (i = 0; i < count; i ++) {
+                int32_t column = storage_columns[plan->out_fields[i]];
+                ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+                dirty_state[column + 1] ++;
+            }
+        }
+        return;
+    }
+
     if ((table && table->dirty_state) || (query->flags & EcsQueryHasNonThisOutTerms)) {
         ecs_term_t *terms = filter->terms;
         int32_t i, count = filter->term_count;
@@ -2456,6 +2619,7 @@ error:
 static
 void flecs_query_populate_trivial(
     ecs_iter_t *it,
+    const ecs_query_t *query,
     ecs_query_table_match_t *match)
 {;
     ecs_table_t *table = match->table;
@@ -2476,8 +2640,29 @@ void flecs_query_populate_trivial(
     it->references = ecs_vec_first(&match->refs);
 
     if (!it->references) {
+        /* All fields are owned by the table. Clear the flag in case it was set
+         * by a previous match with shared fields, so that the table isn't
+         * iterated one entity at a time. */
+        ECS_BIT_CLEAR(it->flags, EcsIterHasShared);
+
         ecs_data_t *data = &table->data;
-        if (!(it->flags & EcsIterNoData)) {
+        if (it->flags & EcsIterNoData) {
+            /* No component data requested */
+        } else if (query->flags & EcsQueryCompiledIter) {
+            /* Only visit fields with data. Fields without data never get a
+             * pointer assigned, so they remain NULL. */
+            const ecs_query_plan_t *plan = &query->plan;
+            const int32_t *storage_columns = match->storage_columns;
+            ecs_column_t *columns = data->columns;
+            int32_t i, data_count = plan->data_count;
+            for (i = 0; i < data_count; i ++) {
+                int8_t field = plan->data_fields[i];
+                int32_t column = storage_columns[field];
+                ecs_assert(column >= 0, ECS_INTERNAL_ERROR, NULL);
+                it->ptrs[field] = ECS_ELEM(columns[column].data.array,
+                    it->sizes[field], offset);
+            }
+        } else {
             int32_t i;
             for (i = 0; i < it->field_count; i ++) {
                 int32_t column = match->storage_columns[i];
@@ -2499,13 +2684,45 @@ void flecs_query_populate_trivial(
 
         it->frame_offset += it->table ? ecs_table_count(it->table) : 0;
         it->table = table;
-        it->entities = ecs_vec_get_t(&data->entities, ecs_entity_t, offset);
+        it->entities = ECS_ELEM_T(data->entities.array, ecs_entity_t, offset);
     } else {
         flecs_iter_populate_data(
             it->real_world, it, table, offset, count, it->ptrs);
     }
 }
 
+/* Prefetch the entity array and columns of the next match, so that they are
+ * (partially) loaded by the time the application finishes the current table. */
+static
+void flecs_query_prefetch(
+    const ecs_iter_t *it,
+    const ecs_query_table_match_t *next,
+    const ecs_query_table_match_t *last)
+{
+    if (next == last) {
+        return;
+    }
+
+    flecs_prefetch(next->next);
+
+    ecs_table_t *table = next->table;
+    flecs_prefetch(table->data.entities.array);
+
+    if (it->flags & EcsIterNoData) {
+        return;
+    }
+
+    const int32_t *storage_columns = next->storage_columns;
+    ecs_column_t *columns = table->data.columns;
+    int32_t i, count = it->field_count;
+    for (i = 0; i < count; i ++) {
+        int32_t column = storage_columns[i];
+        if (column >= 0) {
+            flecs_prefetch(columns[column].data.array);
+        }
+    }
+}
+
 int ecs_query_populate(
     ecs_iter_t *it,
     bool when_changed)
@@ -2520,7 +2737,7 @@ int ecs_query_populate(
     ecs_query_table_match_t *match = iter->prev;
     ecs_assert(match != NULL, ECS_INVALID_OPERATION, NULL);
     if (query->flags & EcsQueryTrivialIter) {
-        flecs_query_populate_trivial(it, match);
+        flecs_query_populate_trivial(it, query, match);
         return EcsIterNextYield;
     }
 
@@ -2644,7 +2861,10 @@ bool ecs_query_next_instanced(
         }
         iter->node = cur->next;
         iter->prev = cur;
-        flecs_query_populate_trivial(it, cur);
+        if (flags & EcsQueryPrefetch) {
+            flecs_query_prefetch(it, cur->next, last);
+        }
+        flecs_query_populate_trivial(it, query, cur);
         return true;
     }
 
@@ -17,6 +17,16 @@
 
 #include "private_api.h"
 
+/* Min and max number of entity ids a stage reserves at a time */
+#define FLECS_STAGE_ID_BLOCK_MIN (64)
+#define FLECS_STAGE_ID_BLOCK_MAX (4096)
+
+/* Min number of collected writes for which worker threads are used */
+#define FLECS_MERGE_WRITES_PAR_MIN (1024)
+
+/* Number of consecutive entity ids (as bits) assigned to the same shard */
+#define FLECS_MERGE_WRITES_SHARD_BITS (6)
+
 static
 ecs_cmd_t* flecs_cmd_alloc(
     ecs_stage_t *stage)
@@ -74,6 +84,133 @@ ecs_cmd_t* flecs_cmd_new(
     return flecs_cmd_alloc(stage);
 }
 
+void flecs_merge_writes_append(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_record_t *record,
+    int32_t column,
+    void *src,
+    ecs_size_t size)
+{
+    ecs_merge_writes_t *writes = &world->merge_writes;
+    int32_t i, shard_count = world->stage_count;
+    if (writes->shard_count != shard_count) {
+        ecs_assert(!writes->count, ECS_INTERNAL_ERROR, NULL);
+        flecs_merge_writes_fini(world);
+        writes->shards = flecs_alloc_n(
+            &world->allocator, ecs_vec_t, shard_count);
+        for (i = 0; i < shard_count; i ++) {
+            ecs_vec_init_t(NULL, &writes->shards[i], ecs_merge_write_t, 0);
+        }
+        writes->shard_count = shard_count;
+    }
+
+    uint32_t shard = (uint32_t)entity >> FLECS_MERGE_WRITES_SHARD_BITS;
+    shard %= flecs_ito(uint32_t, shard_count);
+
+    ecs_merge_write_t *w = ecs_vec_append_t(&world->allocator, 
+        &writes->shards[shard], ecs_merge_write_t);
+    w->record = record;
+    w->column = column;
+    w->size = size;
+    w->src = src;
+    writes->count ++;
+}
+
+static
+void flecs_merge_writes_apply(
+    ecs_vec_t *shard)
+{
+    ecs_merge_write_t *writes = ecs_vec_first_t(shard, ecs_merge_write_t);
+    int32_t i, count = ecs_vec_count(shard);
+    for (i = 0; i < count; i ++) {
+        ecs_merge_write_t *w = &writes[i];
+        ecs_table_t *table = w->record->table;
+        ecs_assert(table != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(w->column < table->column_count, ECS_INTERNAL_ERROR, NULL);
+        void *dst = ecs_vec_get(&table->data.columns[w->column].data, 
+            w->size, ECS_RECORD_TO_ROW(w->record->row));
+        ecs_os_memcpy(dst, w->src, w->size);
+    }
+}
+
+#ifdef FLECS_PIPELINE
+/* Each thread applies the writes of the shard with the same index as its stage.
+ * Shards don't share entities, so threads never write the same component. The
+ * storage isn't modified while writes are applied, so looking up destinations
+ * from multiple threads is safe. */
+static
+void flecs_merge_writes_run(
+    ecs_stage_t *stage,
+    void *ctx)
+{
+    ecs_merge_writes_t *writes = ctx;
+    ecs_assert(stage->id < writes->shard_count, ECS_INTERNAL_ERROR, NULL);
+    flecs_merge_writes_apply(&writes->shards[stage->id]);
+}
+#endif
+
+void flecs_merge_writes_flush(
+    ecs_world_t *world)
+{
+    ecs_merge_writes_t *writes = &world->merge_writes;
+    if (!writes->count) {
+        return;
+    }
+
+    ecs_assert(writes->shard_count == world->stage_count, 
+        ECS_INTERNAL_ERROR, NULL);
+
+    bool applied = false;
+#ifdef FLECS_PIPELINE
+    if (writes->count >= FLECS_MERGE_WRITES_PAR_MIN) {
+        applied = flecs_workers_run(world, flecs_merge_writes_run, writes);
+        if (applied) {
+            world->info.cmd.parallel_set_count += writes->count;
+        }
+    }
+#endif
+
+    int32_t i, s;
+    for (s = 0; s < writes->shard_count; s ++) {
+        ecs_vec_t *shard = &writes->shards[s];
+        if (!applied) {
+            flecs_merge_writes_apply(shard);
+        }
+
+        ecs_merge_write_t *w = ecs_vec_first_t(shard, ecs_merge_write_t);
+        int32_t count = ecs_vec_count(shard);
+        for (i = 0; i < count; i ++) {
+            flecs_stack_free(w[i].src, w[i].size);
+        }
+
+        ecs_vec_clear(shard);
+    }
+
+    writes->count = 0;
+}
+
+void flecs_merge_writes_fini(
+    ecs_world_t *world)
+{
+    ecs_merge_writes_t *writes = &world->merge_writes;
+    ecs_assert(!writes->count, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t i;
+    for (i = 0; i < writes->shard_count; i ++) {
+        ecs_vec_fini_t(&world->allocator, &writes->shards[i], 
+            ecs_merge_write_t);
+    }
+
+    if (writes->shards) {
+        flecs_free_n(&world->allocator, ecs_vec_t, writes->shard_count, 
+            writes->shards);
+    }
+
+    writes->shards = NULL;
+    writes->shard_count = 0;
+}
+
 static
 void flecs_stages_merge(
     ecs_world_t *world,
@@ -101,18 +238,34 @@ void flecs_stages_merge(
             ecs_assert(stage->defer == 1, ECS_INVALID_OPERATION, 
                 "mismatching defer_begin/defer_end detected");
             flecs_defer_end(world, stage);
+            ecs_vec_clear(&stage->id_ranges);
         }
     } else {
-        /* Merge stages. Only merge if the stage has auto_merging turned on, or 
-         * if this is a forced merge (like when ecs_merge is called) */
+        /* Merge stages. Only merge if the stage has auto_merging turned on, or
+         * if this is a forced merge (like when ecs_merge is called)
+         *
+         * Stages are merged one after another, in stage order. Applying a
+         * command can run hooks and observers, create tables and graph edges,
+         * and enqueue new commands, so those commands are applied serially.
+         * Set commands that only write the value of a component the entity
+         * already has are collected instead, and copied by the worker threads
+         * before anything that could observe the values runs, or before the
+         * entity is moved. This keeps the result the same as that of a serial
+         * merge. */
         int32_t i, count = ecs_get_stage_count(world);
+        world->merge_writes.collect = count > 1;
         for (i = 0; i < count; i ++) {
             ecs_stage_t *s = (ecs_stage_t*)ecs_get_stage(world, i);
             ecs_poly_assert(s, ecs_stage_t);
             if (force_merge || s->auto_merge) {
                 flecs_defer_end(world, s);
+
+                /* Ids reserved by the stage that weren't published by its
+                 * commands are no longer treated as created */
+                ecs_vec_clear(&s->id_ranges);
             }
         }
+        world->merge_writes.collect = false;
     }
 
     flecs_eval_component_monitors(world);
@@ -295,10 +448,10 @@ bool flecs_defer_bulk_new(
     if (flecs_defer_cmd(stage)) {
         ecs_entity_t *ids = ecs_os_malloc(count * ECS_SIZEOF(ecs_entity_t));
 
-        /* Use ecs_new_id as this is thread safe */
+        /* Use flecs_new_id as this is thread safe */
         int i;
         for (i = 0; i < count; i ++) {
-            ids[i] = ecs_new_id(world);
+            ids[i] = flecs_new_id(world, stage);
         }
 
         *ids_out = ids;
@@ -412,10 +565,11 @@ void* flecs_defer_set(
     void *existing = NULL;
     ecs_table_t *table = NULL;
     if (idr) {
-        /* Entity can only have existing component if id record exists */
-        ecs_record_t *r = flecs_entities_get(world, entity);
-        table = r->table;
-        if (r && table) {
+        /* Entity can only have existing component if id record exists. The
+         * entity may not exist yet if it was created while multithreaded. */
+        ecs_record_t *r = flecs_entities_try(world, entity);
+        table = r ? r->table : NULL;
+        if (table) {
             const ecs_table_record_t *tr = flecs_id_record_get_table(
                 idr, table);
             if (tr) {
@@ -533,6 +687,93 @@ error:
     return NULL;
 }
 
+/* Add range to ids reserved by stage. Ranges are added in increasing order, as
+ * the max id of the entity index only increases. */
+static
+void flecs_stage_add_id_range(
+    ecs_stage_t *stage,
+    ecs_entity_t first,
+    ecs_entity_t end)
+{
+    ecs_vec_t *ranges = &stage->id_ranges;
+    if (ecs_vec_count(ranges)) {
+        ecs_entity_t *last_end = ecs_vec_last_t(ranges, ecs_entity_t);
+        if (last_end[0] == first) {
+            last_end[0] = end;
+            return;
+        }
+    }
+
+    ecs_entity_t *range = ecs_vec_grow_t(
+        &stage->allocator, ranges, ecs_entity_t, 2);
+    range[0] = first;
+    range[1] = end;
+}
+
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (stage->async || !ecs_os_api.aadd_) {
+        /* Can't atomically increase number above max int */
+        ecs_assert(flecs_entities_max_id(world) < UINT_MAX, 
+            ECS_INVALID_OPERATION, NULL);
+        ecs_entity_t entity = (ecs_entity_t)ecs_os_ainc(
+            (int32_t*)&flecs_entities_max_id(world));
+        flecs_stage_add_id_range(stage, entity, entity + 1);
+        return entity;
+    }
+
+    if (stage->id_next == stage->id_end) {
+        /* Reserve ids in blocks so threads don't contend on the max id for
+         * each new entity. Double the block size while the stage keeps creating
+         * entities, until the ids are released at the end of readonly mode. */
+        int32_t count = stage->id_block_size;
+        stage->id_next = flecs_entities_reserve_ids(world, count);
+        stage->id_end = stage->id_next + (uint64_t)count;
+        flecs_stage_add_id_range(stage, stage->id_next, stage->id_end);
+        if (count < FLECS_STAGE_ID_BLOCK_MAX) {
+            stage->id_block_size = count * 2;
+        }
+    }
+
+    return stage->id_next ++;
+}
+
+bool flecs_stage_owns_id(
+    const ecs_stage_t *stage,
+    ecs_entity_t id)
+{
+    const ecs_entity_t *ranges = ecs_vec_first_t(
+        &stage->id_ranges, ecs_entity_t);
+    int32_t lo = 0, hi = ecs_vec_count(&stage->id_ranges) / 2;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (id < ranges[mid * 2]) {
+            hi = mid;
+        } else if (id >= ranges[mid * 2 + 1]) {
+            lo = mid + 1;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+void flecs_stage_release_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage)
+{
+    if (stage->id_next != stage->id_end) {
+        flecs_entities_release_ids(world, stage->id_next, 
+            (int32_t)(stage->id_end - stage->id_next));
+    }
+
+    stage->id_next = 0;
+    stage->id_end = 0;
+    stage->id_block_size = FLECS_STAGE_ID_BLOCK_MIN;
+}
+
 void flecs_stage_merge_post_frame(
     ecs_world_t *world,
     ecs_stage_t *stage)
@@ -558,6 +799,7 @@ void flecs_stage_init(
     stage->thread_ctx = world;
     stage->auto_merge = true;
     stage->async = false;
+    stage->id_block_size = FLECS_STAGE_ID_BLOCK_MIN;
 
     flecs_stack_init(&stage->defer_stack);
     flecs_stack_init(&stage->allocators.iter_stack);
@@ -566,6 +808,10 @@ void flecs_stage_init(
     flecs_ballocator_init_n(&stage->allocators.cmd_entry_chunk, ecs_cmd_entry_t,
         FLECS_SPARSE_PAGE_SIZE);
 
+    /* Allocators of stages used by different threads share free memory */
+    stage->allocator.depot = world->stage_depot;
+    stage->allocators.cmd_entry_chunk.depot = world->stage_depot;
+
     ecs_allocator_t *a = &stage->allocator;
     ecs_vec_init_t(a, &stage->commands, ecs_cmd_t, 0);
     ecs_vec_init_t(a, &stage->post_frame_actions, ecs_action_elem_t, 0);
@@ -591,6 +837,7 @@ void flecs_stage_fini(
     ecs_allocator_t *a = &stage->allocator;
     ecs_vec_fini_t(a, &stage->commands, ecs_cmd_t);
     ecs_vec_fini_t(a, &stage->post_frame_actions, ecs_action_elem_t);
+    ecs_vec_fini_t(a, &stage->id_ranges, ecs_entity_t);
     ecs_vec_fini(NULL, &stage->variables, 0);
     ecs_vec_fini(NULL, &stage->operations, 0);
     flecs_stack_fini(&stage->defer_stack);
@@ -635,6 +882,21 @@ void ecs_set_stage_count(
         }
 
         ecs_os_free(world->stages);
+
+        /* Release blocks of finalized stage allocators that are no longer in
+         * use by any other allocator */
+        if (world->stage_depot) {
+            flecs_ballocator_depot_trim(world->stage_depot);
+        }
+    }
+
+    if (!stage_count && world->stage_depot) {
+        flecs_ballocator_depot_free(world->stage_depot);
+        world->stage_depot = NULL;
+    } else if (stage_count > 1 && !world->stage_depot && 
+        ecs_os_has_threading()) 
+    {
+        world->stage_depot = flecs_ballocator_depot_new();
     }
 
     if (stage_count) {
@@ -753,6 +1015,12 @@ void ecs_readonly_end(
     ECS_BIT_CLEAR(world->flags, EcsWorldReadonly);
     ECS_BIT_CLEAR(world->flags, EcsWorldMultiThreaded);
 
+    /* Return ids that stages reserved but didn't use */
+    int32_t i, count = ecs_get_stage_count(world);
+    for (i = 0; i < count; i ++) {
+        flecs_stage_release_ids(world, &world->stages[i]);
+    }
+
     ecs_log_pop_3();
 
     flecs_stage_auto_merge(world);
@@ -843,7 +1111,11 @@ void ecs_async_stage_free(
     ecs_poly_assert(world, ecs_stage_t);
     ecs_stage_t *stage = (ecs_stage_t*)world;
     ecs_check(stage->async == true, ECS_INVALID_PARAMETER, NULL);
+    ecs_block_allocator_depot_t *depot = stage->world->stage_depot;
     flecs_stage_fini(stage->world, stage);
+    if (depot) {
+        flecs_ballocator_depot_trim(depot);
+    }
     ecs_os_free(stage);
 error:
     return;
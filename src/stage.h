@@ -21,6 +21,40 @@ void flecs_stage_merge_post_frame(
     ecs_world_t *world,
     ecs_stage_t *stage);  
 
+/* Create new entity id from range reserved by stage (thread safe) */
+ecs_entity_t flecs_stage_new_id(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* Test if id was reserved by stage and its commands have not been merged */
+bool flecs_stage_owns_id(
+    const ecs_stage_t *stage,
+    ecs_entity_t id);
+
+/* Make unused ids reserved by stage available for recycling */
+void flecs_stage_release_ids(
+    ecs_world_t *world,
+    ecs_stage_t *stage);
+
+/* Collect component value that is copied to storage when writes are flushed */
+void flecs_merge_writes_append(
+    ecs_world_t *world,
+    ecs_entity_t entity,
+    ecs_record_t *record,
+    int32_t column,
+    void *src,
+    ecs_size_t size);
+
+/* Copy collected component values to storage. Must be called before running
+ * code that can read component values, and before moving entities with
+ * collected writes to another table. */
+void flecs_merge_writes_flush(
+    ecs_world_t *world);
+
+/* Free storage for collected component values */
+void flecs_merge_writes_fini(
+    ecs_world_t *world);
+
 bool flecs_defer_cmd(
     ecs_stage_t *stage);
 
@@ -39,13 +39,14 @@ void flecs_entity_index_fini(
     ecs_entity_index_t *index)
 {
     ecs_vec_fini_t(index->allocator, &index->dense, uint64_t);
-#if defined(FLECS_SANITIZE) || defined(FLECS_USE_OS_ALLOC)
+
+    /* Pages can be larger than FLECS_BALLOC_LARGE_SIZE, in which case they are
+     * not part of a block and aren't freed by flecs_ballocator_fini. */
     int32_t i, count = ecs_vec_count(&index->pages);
     ecs_entity_index_page_t **pages = ecs_vec_first(&index->pages);
     for (i = 0; i < count; i ++) {
         flecs_bfree(&index->page_allocator, pages[i]);
     }
-#endif
     ecs_vec_fini_t(index->allocator, &index->pages, ecs_entity_index_page_t*);
     flecs_ballocator_fini(&index->page_allocator);
 }
@@ -274,23 +275,100 @@ uint64_t* flecs_entity_index_new_ids(
         return ecs_vec_get_t(&index->dense, uint64_t, alive_count);
     }
 
-    /* Allocate new ids */
+    /* Allocate new ids. New ids are consecutive, so records can be initialized
+     * a page at a time. */
     ecs_vec_set_count_t(index->allocator, &index->dense, uint64_t, new_count);
-    int32_t i, to_add = new_count - dense_count;
-    for (i = 0; i < to_add; i ++) {
-        uint32_t id = (uint32_t)++ index->max_id;
-        int32_t dense = dense_count + i;
-        ecs_vec_get_t(&index->dense, uint64_t, dense)[0] = id;
+    uint64_t *ids = ecs_vec_first_t(&index->dense, uint64_t);
+    int32_t dense = dense_count;
+    while (dense < new_count) {
+        uint32_t id = (uint32_t)index->max_id + 1;
         ecs_entity_index_page_t *page = flecs_entity_index_ensure_page(index, id);
         ecs_assert(page != NULL, ECS_INTERNAL_ERROR, NULL);
-        ecs_record_t *r = &page->records[id & FLECS_ENTITY_PAGE_MASK];
-        r->dense = dense;
+
+        int32_t offset = (int32_t)(id & FLECS_ENTITY_PAGE_MASK);
+        int32_t i, to_add = FLECS_ENTITY_PAGE_SIZE - offset;
+        if (to_add > (new_count - dense)) {
+            to_add = new_count - dense;
+        }
+
+        ecs_record_t *r = &page->records[offset];
+        for (i = 0; i < to_add; i ++) {
+            ids[dense + i] = id + (uint32_t)i;
+            r[i].dense = dense + i;
+        }
+
+        index->max_id += (uint32_t)to_add;
+        dense += to_add;
     }
 
     index->alive_count = new_count;
     return ecs_vec_get_t(&index->dense, uint64_t, alive_count);
 }
 
+void flecs_entity_index_set_table(
+    ecs_entity_index_t *index,
+    const uint64_t *ids,
+    int32_t count,
+    ecs_table_t *table,
+    int32_t row,
+    ecs_record_t **records)
+{
+    int32_t i = 0;
+    while (i < count) {
+        uint32_t id = (uint32_t)ids[i];
+        int32_t page_index = (int32_t)(id >> FLECS_ENTITY_PAGE_BITS);
+        ecs_entity_index_page_t *page = ecs_vec_get_t(&index->pages, 
+            ecs_entity_index_page_t*, page_index)[0];
+        int32_t offset = (int32_t)(id & FLECS_ENTITY_PAGE_MASK);
+
+        /* Ids created in bulk are consecutive, so don't look up the page again
+         * until the ids are no longer consecutive or the page ends. */
+        do {
+            ecs_record_t *r = &page->records[offset];
+            ecs_assert(flecs_entity_index_is_alive(index, ids[i]), 
+                ECS_INVALID_PARAMETER, NULL);
+            r->table = table;
+            r->row = ECS_ROW_TO_RECORD(row + i, 0);
+            records[i] = r;
+            i ++;
+            offset ++;
+        } while ((i < count) && (offset < FLECS_ENTITY_PAGE_SIZE) && 
+            ((uint32_t)ids[i] == ((uint32_t)ids[i - 1] + 1)));
+    }
+}
+
+uint64_t flecs_entity_index_reserve_ids(
+    ecs_entity_index_t *index,
+    int32_t count)
+{
+    /* Can't atomically increase number above max int */
+    ecs_assert(index->max_id < (UINT_MAX - (uint32_t)count), 
+        ECS_INVALID_OPERATION, NULL);
+    uint32_t last = (uint32_t)ecs_os_aadd((int32_t*)&index->max_id, count);
+    return last - (uint32_t)count + 1;
+}
+
+void flecs_entity_index_release_ids(
+    ecs_entity_index_t *index,
+    uint64_t first,
+    int32_t count)
+{
+    int32_t i;
+    for (i = 0; i < count; i ++) {
+        uint32_t id = (uint32_t)first + (uint32_t)i;
+        ecs_entity_index_page_t *page = flecs_entity_index_ensure_page(index, id);
+        ecs_record_t *r = &page->records[id & FLECS_ENTITY_PAGE_MASK];
+        if (r->dense) {
+            /* Id was explicitly created by the application */
+            continue;
+        }
+
+        /* Add id to the not alive part of the dense array so it's recycled */
+        ecs_vec_append_t(index->allocator, &index->dense, uint64_t)[0] = id;
+        r->dense = ecs_vec_count(&index->dense) - 1;
+    }
+}
+
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
     int32_t size)
@@ -97,6 +97,28 @@ uint64_t* flecs_entity_index_new_ids(
     ecs_entity_index_t *index,
     int32_t count);
 
+/* Set table and row for entities that were appended to consecutive rows of
+ * the same table, and store their records in records. */
+void flecs_entity_index_set_table(
+    ecs_entity_index_t *index,
+    const uint64_t *ids,
+    int32_t count,
+    ecs_table_t *table,
+    int32_t row,
+    ecs_record_t **records);
+
+/* Reserve a range of new entity ids. Thread safe, ids in the range are not
+ * alive until they are ensured. Returns the first id of the range. */
+uint64_t flecs_entity_index_reserve_ids(
+    ecs_entity_index_t *index,
+    int32_t count);
+
+/* Make reserved ids that were not used available for recycling */
+void flecs_entity_index_release_ids(
+    ecs_entity_index_t *index,
+    uint64_t first,
+    int32_t count);
+
 /* Set size of index */
 void flecs_entity_index_set_size(
     ecs_entity_index_t *index,
@@ -145,6 +167,9 @@ void flecs_entity_index_restore(
 #define flecs_entities_exists(world, entity) flecs_entity_index_exists(ecs_eis(world), entity)
 #define flecs_entities_new_id(world) flecs_entity_index_new_id(ecs_eis(world))
 #define flecs_entities_new_ids(world, count) flecs_entity_index_new_ids(ecs_eis(world), count)
+#define flecs_entities_set_table(world, ids, count, table, row, records) flecs_entity_index_set_table(ecs_eis(world), ids, count, table, row, records)
+#define flecs_entities_reserve_ids(world, count) flecs_entity_index_reserve_ids(ecs_eis(world), count)
+#define flecs_entities_release_ids(world, first, count) flecs_entity_index_release_ids(ecs_eis(world), first, count)
 #define flecs_entities_max_id(world) (ecs_eis(world)->max_id)
 #define flecs_entities_set_size(world, size) flecs_entity_index_set_size(ecs_eis(world), size)
 #define flecs_entities_count(world) flecs_entity_index_count(ecs_eis(world))
@@ -128,6 +128,167 @@ ecs_id_t flecs_id_record_hash(
     return id;
 }
 
+/* Get page of pair index for relationship or target, or NULL if the page has
+ * not been allocated yet. */
+static
+void* flecs_pair_index_get_page(
+    const ecs_vec_t *pages,
+    uint32_t index)
+{
+    int32_t page_index = (int32_t)(index >> FLECS_PAIR_INDEX_PAGE_BITS);
+    if (page_index >= ecs_vec_count(pages)) {
+        return NULL;
+    }
+    return ecs_vec_get_t(pages, void*, page_index)[0];
+}
+
+static
+void* flecs_pair_index_ensure_page(
+    ecs_world_t *world,
+    ecs_vec_t *pages,
+    uint32_t index,
+    ecs_size_t page_size,
+    bool *created)
+{
+    int32_t page_index = (int32_t)(index >> FLECS_PAIR_INDEX_PAGE_BITS);
+    if (page_index >= ecs_vec_count(pages)) {
+        ecs_vec_init_if_t(pages, void*);
+        ecs_vec_set_min_count_zeromem_t(&world->allocator, pages, void*,
+            page_index + 1);
+    }
+
+    void **page_ptr = ecs_vec_get_t(pages, void*, page_index);
+    if (!page_ptr[0]) {
+        page_ptr[0] = flecs_calloc(&world->allocator, page_size);
+        *created = true;
+    }
+
+    return page_ptr[0];
+}
+
+static
+void flecs_pair_index_free_page(
+    ecs_world_t *world,
+    ecs_vec_t *pages,
+    uint32_t index,
+    ecs_size_t page_size)
+{
+    int32_t page_index = (int32_t)(index >> FLECS_PAIR_INDEX_PAGE_BITS);
+    void **page_ptr = ecs_vec_get_t(pages, void*, page_index);
+    flecs_free(&world->allocator, page_size, page_ptr[0]);
+    page_ptr[0] = NULL;
+}
+
+/* Pairs without id flags other than ECS_PAIR are stored in the pair index if
+ * both the relationship and target are in the range of the index. */
+static
+bool flecs_id_record_is_indexed_pair(
+    ecs_id_t hash)
+{
+    return ((hash & ECS_ID_FLAGS_MASK) == ECS_PAIR) &&
+        (ECS_PAIR_FIRST(hash) < FLECS_HI_PAIR_INDEX_ID) &&
+        (ECS_PAIR_SECOND(hash) < FLECS_HI_PAIR_INDEX_ID);
+}
+
+/* Get element in pair index for pair id. Pair lookups don't hash the id, but
+ * index the relationship and target pages. */
+static
+ecs_id_record_t** flecs_pair_index_get(
+    const ecs_world_t *world,
+    ecs_id_t pair)
+{
+    uint32_t rel = (uint32_t)ECS_PAIR_FIRST(pair);
+    uint32_t tgt = (uint32_t)ECS_PAIR_SECOND(pair);
+
+    ecs_pair_index_rel_page_t *rels = flecs_pair_index_get_page(
+        &world->id_index_pairs, rel);
+    if (!rels) {
+        return NULL;
+    }
+
+    ecs_pair_index_page_t *tgts = flecs_pair_index_get_page(
+        &rels->rels[rel & FLECS_PAIR_INDEX_PAGE_MASK].pages, tgt);
+    if (!tgts) {
+        return NULL;
+    }
+
+    return &tgts->records[tgt & FLECS_PAIR_INDEX_PAGE_MASK];
+}
+
+static
+void flecs_pair_index_insert(
+    ecs_world_t *world,
+    ecs_id_t pair,
+    ecs_id_record_t *idr)
+{
+    uint32_t rel = (uint32_t)ECS_PAIR_FIRST(pair);
+    uint32_t tgt = (uint32_t)ECS_PAIR_SECOND(pair);
+    bool rels_created = false, tgts_created = false;
+
+    ecs_pair_index_rel_page_t *rels = flecs_pair_index_ensure_page(world,
+        &world->id_index_pairs, rel, ECS_SIZEOF(ecs_pair_index_rel_page_t),
+        &rels_created);
+    ecs_pair_index_t *index = &rels->rels[rel & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_pair_index_page_t *tgts = flecs_pair_index_ensure_page(world,
+        &index->pages, tgt, ECS_SIZEOF(ecs_pair_index_page_t), 
+        &tgts_created);
+
+    if (tgts_created) {
+        if (!index->count) {
+            rels->count ++;
+        }
+        index->count ++;
+    }
+
+    ecs_id_record_t **ptr = &tgts->records[tgt & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_assert(ptr[0] == NULL, ECS_INTERNAL_ERROR, NULL);
+    ptr[0] = idr;
+    tgts->count ++;
+}
+
+/* Remove id record from pair index. Pages that no longer contain id records
+ * are freed, except during world cleanup which frees the index at the end. */
+static
+void flecs_pair_index_remove(
+    ecs_world_t *world,
+    ecs_id_t pair,
+    ecs_id_record_t *idr)
+{
+    uint32_t rel = (uint32_t)ECS_PAIR_FIRST(pair);
+    uint32_t tgt = (uint32_t)ECS_PAIR_SECOND(pair);
+
+    ecs_pair_index_rel_page_t *rels = flecs_pair_index_get_page(
+        &world->id_index_pairs, rel);
+    ecs_assert(rels != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_pair_index_t *index = &rels->rels[rel & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_pair_index_page_t *tgts = flecs_pair_index_get_page(
+        &index->pages, tgt);
+    ecs_assert(tgts != NULL, ECS_INTERNAL_ERROR, NULL);
+
+    ecs_id_record_t **ptr = &tgts->records[tgt & FLECS_PAIR_INDEX_PAGE_MASK];
+    ecs_assert(ptr[0] == idr, ECS_INTERNAL_ERROR, NULL);
+    (void)idr;
+    ptr[0] = NULL;
+
+    if (-- tgts->count || (world->flags & EcsWorldFini)) {
+        return;
+    }
+
+    flecs_pair_index_free_page(world, &index->pages, tgt, 
+        ECS_SIZEOF(ecs_pair_index_page_t));
+    if (-- index->count) {
+        return;
+    }
+
+    ecs_vec_fini_t(&world->allocator, &index->pages, ecs_pair_index_page_t*);
+    if (-- rels->count) {
+        return;
+    }
+
+    flecs_pair_index_free_page(world, &world->id_index_pairs, rel, 
+        ECS_SIZEOF(ecs_pair_index_rel_page_t));
+}
+
 static
 ecs_id_record_t* flecs_id_record_new(
     ecs_world_t *world,
@@ -135,7 +296,10 @@ ecs_id_record_t* flecs_id_record_new(
 {
     ecs_id_record_t *idr, *idr_t = NULL;
     ecs_id_t hash = flecs_id_record_hash(id);
-    if (hash >= FLECS_HI_ID_RECORD_ID) {
+    if (flecs_id_record_is_indexed_pair(hash)) {
+        idr = flecs_bcalloc(&world->allocators.id_record);
+        flecs_pair_index_insert(world, hash, idr);
+    } else if (hash >= FLECS_HI_ID_RECORD_ID) {
         idr = flecs_bcalloc(&world->allocators.id_record);
         ecs_map_insert_ptr(&world->id_index_hi, hash, idr);
     } else {
@@ -162,6 +326,12 @@ ecs_id_record_t* flecs_id_record_new(
          * relationship are added to the (ChildOf, 0) id record */
         tgt = ECS_PAIR_SECOND(id);
 
+        /* Generations are unique for the world, so that a cache can't confuse
+         * a recreated (R, *) record with the record it was built for */
+        if (tgt == EcsWildcard) {
+            idr->trav_generation = ++ world->trav_generation;
+        }
+
 #ifdef FLECS_DEBUG
         /* Check constraints */
         if (tgt) {
@@ -203,6 +373,11 @@ ecs_id_record_t* flecs_id_record_new(
             if (rel == EcsUnion) {
                 idr->flags |= EcsIdUnion;
             }
+
+            /* Entities that were not a target can now be traversed */
+            if (idr->flags & EcsIdTraversable) {
+                idr_r->trav_generation = ++ world->trav_generation;
+            }
         }
     } else {
         rel = id & ECS_COMPONENT_MASK;
@@ -230,11 +405,11 @@ ecs_id_record_t* flecs_id_record_new(
         /* Flag for OnDeleteTarget policies */
         ecs_record_t *tgt_r = flecs_entities_get_any(world, tgt);
         ecs_assert(tgt_r != NULL, ECS_INTERNAL_ERROR, NULL);
-        flecs_record_add_flag(tgt_r, EcsEntityIsTarget);
+        flecs_record_add_flag(world, tgt_r, EcsEntityIsTarget);
         if (idr->flags & EcsIdTraversable) {
             /* Flag used to determine if object should be traversed when
              * propagating events or with super/subset queries */
-            flecs_record_add_flag(tgt_r, EcsEntityIsTraversable);
+            flecs_record_add_flag(world, tgt_r, EcsEntityIsTraversable);
 
             /* Add reference to (*, tgt) id record to entity record */
             tgt_r->idr = idr_t;
@@ -314,6 +489,10 @@ void flecs_id_record_free(
         ecs_entity_t tgt = ECS_PAIR_SECOND(id);
         if (!ecs_id_is_wildcard(id)) {
             if (ECS_PAIR_FIRST(id) != EcsFlag) {
+                if (idr->flags & EcsIdTraversable) {
+                    flecs_id_record_trav_changed(world, rel);
+                }
+
                 /* If id is not a wildcard, remove it from the wildcard lists */
                 flecs_remove_id_elem(idr, ecs_pair(rel, EcsWildcard));
                 flecs_remove_id_elem(idr, ecs_pair(EcsWildcard, tgt));
@@ -372,7 +551,10 @@ void flecs_id_record_free(
     ecs_vec_fini_t(&world->allocator, &idr->reachable.ids, ecs_reachable_elem_t);
 
     ecs_id_t hash = flecs_id_record_hash(id);
-    if (hash >= FLECS_HI_ID_RECORD_ID) {
+    if (flecs_id_record_is_indexed_pair(hash)) {
+        flecs_pair_index_remove(world, hash, idr);
+        flecs_bfree(&world->allocators.id_record, idr);
+    } else if (hash >= FLECS_HI_ID_RECORD_ID) {
         ecs_map_remove(&world->id_index_hi, hash);
         flecs_bfree(&world->allocators.id_record, idr);
     } else {
@@ -386,6 +568,17 @@ void flecs_id_record_free(
     }
 }
 
+void flecs_id_record_trav_changed(
+    ecs_world_t *world,
+    ecs_entity_t rel)
+{
+    ecs_id_record_t *idr = flecs_id_record_get(world, 
+        ecs_pair(rel, EcsWildcard));
+    if (idr && (idr->flags & EcsIdTraversable)) {
+        idr->trav_generation = ++ world->trav_generation;
+    }
+}
+
 ecs_id_record_t* flecs_id_record_ensure(
     ecs_world_t *world,
     ecs_id_t id)
@@ -412,7 +605,12 @@ ecs_id_record_t* flecs_id_record_get(
 
     ecs_id_t hash = flecs_id_record_hash(id);
     ecs_id_record_t *idr = NULL;
-    if (hash >= FLECS_HI_ID_RECORD_ID) {
+    if (flecs_id_record_is_indexed_pair(hash)) {
+        ecs_id_record_t **ptr = flecs_pair_index_get(world, hash);
+        if (ptr) {
+            idr = ptr[0];
+        }
+    } else if (hash >= FLECS_HI_ID_RECORD_ID) {
         idr = ecs_map_get_deref(&world->id_index_hi, ecs_id_record_t, hash);
     } else {
         idr = &world->id_index_lo[hash];
@@ -586,9 +784,76 @@ void flecs_init_id_records(
         ecs_pair(EcsIsA, EcsWildcard));
 }
 
+/* Release pair id records & free the pages of the pair index */
+static
+void flecs_fini_pair_id_records(
+    ecs_world_t *world)
+{
+    ecs_allocator_t *a = &world->allocator;
+    ecs_vec_t *rel_pages = &world->id_index_pairs;
+    int32_t p, r, t, i, count = ecs_vec_count(rel_pages);
+
+    /* Releasing an id record can release other id records, which clears their
+     * element in the index. Pages are not freed while the world is being
+     * deleted, so the index can be iterated while it's modified. */
+    for (p = 0; p < count; p ++) {
+        ecs_pair_index_rel_page_t *rels = ecs_vec_get_t(
+            rel_pages, ecs_pair_index_rel_page_t*, p)[0];
+        if (!rels) {
+            continue;
+        }
+
+        for (r = 0; r < FLECS_PAIR_INDEX_PAGE_SIZE; r ++) {
+            ecs_vec_t *tgt_pages = &rels->rels[r].pages;
+            int32_t tgt_count = ecs_vec_count(tgt_pages);
+            for (t = 0; t < tgt_count; t ++) {
+                ecs_pair_index_page_t *tgts = ecs_vec_get_t(
+                    tgt_pages, ecs_pair_index_page_t*, t)[0];
+                if (!tgts) {
+                    continue;
+                }
+
+                for (i = 0; i < FLECS_PAIR_INDEX_PAGE_SIZE; i ++) {
+                    ecs_id_record_t *idr;
+                    while ((idr = tgts->records[i])) {
+                        flecs_id_record_release(world, idr);
+                    }
+                }
+            }
+        }
+    }
+
+    for (p = 0; p < count; p ++) {
+        ecs_pair_index_rel_page_t *rels = ecs_vec_get_t(
+            rel_pages, ecs_pair_index_rel_page_t*, p)[0];
+        if (!rels) {
+            continue;
+        }
+
+        for (r = 0; r < FLECS_PAIR_INDEX_PAGE_SIZE; r ++) {
+            ecs_vec_t *tgt_pages = &rels->rels[r].pages;
+            int32_t tgt_count = ecs_vec_count(tgt_pages);
+            for (t = 0; t < tgt_count; t ++) {
+                ecs_pair_index_page_t *tgts = ecs_vec_get_t(
+                    tgt_pages, ecs_pair_index_page_t*, t)[0];
+                if (tgts) {
+                    flecs_free_t(a, ecs_pair_index_page_t, tgts);
+                }
+            }
+            ecs_vec_fini_t(a, tgt_pages, ecs_pair_index_page_t*);
+        }
+
+        flecs_free_t(a, ecs_pair_index_rel_page_t, rels);
+    }
+
+    ecs_vec_fini_t(a, rel_pages, ecs_pair_index_rel_page_t*);
+}
+
 void flecs_fini_id_records(
     ecs_world_t *world)
 {
+    flecs_fini_pair_id_records(world);
+
     /* Loop & delete first element until there are no elements left. Id records
      * can recursively delete each other, this ensures we always have a
      * valid iterator. */
@@ -71,6 +71,10 @@ struct ecs_id_record_t {
 
     /* Cache invalidation counter */
     ecs_reachable_cache_t reachable;
+
+    /* Changes when entities are added to or removed from the graph of a 
+     * traversable relationship. Only used by (R, *) records. */
+    int32_t trav_generation;
 };
 
 /* Get id record for id */
@@ -85,6 +89,11 @@ ecs_id_record_t* flecs_query_id_record_get(
     const ecs_world_t *world,
     ecs_id_t id);
 
+/* Signal that graph of traversable relationship has changed */
+void flecs_id_record_trav_changed(
+    ecs_world_t *world,
+    ecs_entity_t rel);
+
 /* Ensure id record for id */
 ecs_id_record_t* flecs_id_record_ensure(
     ecs_world_t *world,
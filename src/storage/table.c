@@ -131,12 +131,34 @@ ecs_flags32_t flecs_type_info_flags(
     return flags;  
 }
 
+/* Number of elements for which the storage size of a column is a multiple of
+ * the component alignment. The block allocator aligns chunks to the largest 
+ * power of two that divides the chunk size, so if a column is allocated in 
+ * multiples of this number, its storage starts on an aligned address and is 
+ * padded to a whole number of SIMD lanes. The number is doubled so that column
+ * storage is never smaller than twice the alignment, which sanitized builds of
+ * the block allocator rely on to keep chunks aligned. */
+static
+int32_t flecs_table_column_lane(
+    const ecs_type_info_t *ti)
+{
+    ecs_size_t align = ECS_MIN(ti->alignment, FLECS_BALLOC_MAX_ALIGN);
+    if (align <= 16) {
+        /* Allocator already guarantees 16 byte alignment */
+        return 1;
+    }
+
+    ecs_size_t size_align = ti->size & -ti->size;
+    return 2 * align / ECS_MIN(size_align, align);
+}
+
 static
 void flecs_table_init_columns(
     ecs_world_t *world,
     ecs_table_t *table,
     int32_t column_count)
 {
+    table->_->min_size = 1;
     if (!column_count) {
         return;
     }
@@ -166,6 +188,8 @@ void flecs_table_init_columns(
         columns[cur].ti = ECS_CONST_CAST(ecs_type_info_t*, ti);
         columns[cur].id = ids[i];
         columns[cur].size = ti->size;
+        table->_->min_size = ECS_MAX(table->_->min_size, 
+            flecs_table_column_lane(ti));
 
         if (ECS_IS_PAIR(ids[i])) {
             ecs_table_record_t *wc_tr = flecs_id_record_get_table(
@@ -590,6 +614,8 @@ void flecs_table_init(
     }
 
     if (table->flags & EcsTableHasOnTableCreate) {
+        /* Observers could read values of writes collected by a merge */
+        flecs_merge_writes_flush(world);
         flecs_emit(world, world, &(ecs_event_desc_t) {
             .ids = &table->type,
             .event = EcsOnTableCreate,
@@ -874,6 +900,35 @@ void flecs_table_dtor_all(
     }
 }
 
+/* Invalidate the traversal caches of the relationships in a table. Called when
+ * traversable entities are added to or removed from the table, as that changes
+ * which entities can be reached through the table's pairs. */
+static
+void flecs_table_traversable_changed(
+    ecs_world_t *world,
+    ecs_table_t *table)
+{
+    if (!(table->flags & EcsTableHasPairs)) {
+        return;
+    }
+
+    int32_t i, count = table->_->record_count;
+    ecs_table_record_t *records = table->_->records;
+    for (i = 0; i < count; i ++) {
+        ecs_id_record_t *idr = (ecs_id_record_t*)records[i].hdr.cache;
+        if (!(idr->flags & EcsIdTraversable)) {
+            continue;
+        }
+
+        ecs_id_t id = idr->id;
+        if (ECS_IS_PAIR(id) && (ECS_PAIR_SECOND(id) == EcsWildcard) &&
+            (ECS_PAIR_FIRST(id) != EcsWildcard))
+        {
+            idr->trav_generation = ++ world->trav_generation;
+        }
+    }
+}
+
 /* Cleanup table storage */
 static
 void flecs_table_fini_data(
@@ -947,6 +1002,10 @@ void flecs_table_fini_data(
         flecs_table_set_empty(world, table);
     }
 
+    if (table->_->traversable_count) {
+        flecs_table_traversable_changed(world, table);
+    }
+
     table->_->traversable_count = 0;
     table->flags &= ~EcsTableHasTraversable;
 }
@@ -1094,9 +1153,14 @@ void flecs_table_reset(
  * traversable count and flag are used by code to early out of mechanisms like
  * event propagation and recursive cleanup. */
 void flecs_table_traversable_add(
+    ecs_world_t *world,
     ecs_table_t *table,
     int32_t value)
 {
+    if (value) {
+        flecs_table_traversable_changed(world, table);
+    }
+
     int32_t result = table->_->traversable_count += value;
     ecs_assert(result >= 0, ECS_INTERNAL_ERROR, NULL);
     if (result == 0) {
@@ -1355,7 +1419,7 @@ void flecs_table_grow_column(
         /* Move (and construct) existing elements to new vector */
         move_ctor(dst_buffer, src_buffer, count, ti);
 
-        if (construct) {
+        if (construct && to_add) {
             /* Construct new element(s) */
             result = ECS_ELEM(dst_buffer, size, count);
             ctor(result, to_add, ti);
@@ -1371,19 +1435,54 @@ void flecs_table_grow_column(
             ecs_vec_set_size(&world->allocator, &column->data, size, dst_size);
         }
 
-        result = ecs_vec_grow(&world->allocator, &column->data, size, to_add);
+        if (to_add) {
+            result = ecs_vec_grow(
+                &world->allocator, &column->data, size, to_add);
 
-        ecs_xtor_t ctor;
-        if (construct && (ctor = ti->hooks.ctor)) {
-            /* If new elements need to be constructed and component has a
-             * constructor, construct */
-            ctor(result, to_add, ti);
+            ecs_xtor_t ctor;
+            if (construct && (ctor = ti->hooks.ctor)) {
+                /* If new elements need to be constructed and component has a
+                 * constructor, construct */
+                ctor(result, to_add, ti);
+            }
         }
     }
 
     ecs_assert(column->data.size == dst_size, ECS_INTERNAL_ERROR, NULL);
 }
 
+/* Make sure table storage is large enough for the columns of over-aligned
+ * components to be aligned (see flecs_table_column_lane). */
+static
+void flecs_table_ensure_min_size(
+    ecs_world_t *world,
+    ecs_table_t *table,
+    ecs_data_t *data)
+{
+    int32_t min_size = table->_->min_size;
+    if (min_size <= 1) {
+        return;
+    }
+
+    int32_t i, size = data->entities.size;
+    if (size < min_size || (size % min_size)) {
+        /* Vectors grow to the next power of two, which for sizes that aren't
+         * a multiple of min_size (also a power of two) is a multiple. */
+        ecs_allocator_t *a = &world->allocator;
+        size = ECS_MAX(size + 1, min_size);
+        ecs_vec_set_size_t(a, &data->entities, ecs_entity_t, size);
+        ecs_vec_set_size_t(a, &data->records, ecs_record_t*, size);
+        size = data->entities.size;
+    }
+
+    for (i = 0; i < table->column_count; i ++) {
+        ecs_column_t *column = &data->columns[i];
+        if (column->data.size != size) {
+            flecs_table_grow_column(world, column, 0, size, false);
+        }
+    }
+}
+
 /* Grow all data structures in a table */
 static
 int32_t flecs_table_grow_data(
@@ -1400,6 +1499,10 @@ int32_t flecs_table_grow_data(
     int32_t cur_count = flecs_table_data_count(data);
     int32_t column_count = table->column_count;
 
+    if (size < table->_->min_size) {
+        size = table->_->min_size;
+    }
+
     /* Add record to record ptr array */
     ecs_vec_set_size_t(&world->allocator, &data->records, ecs_record_t*, size);
     ecs_record_t **r = ecs_vec_last_t(&data->records, ecs_record_t*) + 1;
@@ -1499,6 +1602,10 @@ int32_t flecs_table_append(
     int32_t column_count = table->column_count;
     ecs_column_t *columns = table->data.columns;
 
+    if (data->entities.size < table->_->min_size) {
+        flecs_table_ensure_min_size(world, table, data);
+    }
+
     /* Grow buffer with entity ids, set new element to new entity */
     ecs_entity_t *e = ecs_vec_append_t(&world->allocator, 
         &data->entities, ecs_entity_t);
@@ -1772,6 +1879,92 @@ void flecs_table_fast_move(
     }
 }
 
+/* Move operation for tables that don't have any complex logic, with columns
+ * that were matched in advance */
+static
+void flecs_table_fast_move_w_plan(
+    ecs_table_t *dst_table,
+    int32_t dst_index,
+    ecs_table_t *src_table,
+    int32_t src_index,
+    const ecs_table_move_plan_t *plan)
+{
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+    const ecs_table_move_op_t *ops = plan->ops;
+
+    int32_t i, count = plan->count;
+    for (i = 0; i < count; i ++) {
+        const ecs_table_move_op_t *op = &ops[i];
+        if ((op->dst != -1) && (op->src != -1)) {
+            ecs_column_t *dst_column = &dst_columns[op->dst];
+            ecs_column_t *src_column = &src_columns[op->src];
+            int32_t size = dst_column->size;
+            void *dst = ecs_vec_get(&dst_column->data, size, dst_index);
+            void *src = ecs_vec_get(&src_column->data, size, src_index);
+            ecs_os_memcpy(dst, src, size);
+        }
+    }
+}
+
+/* Move component in a column that exists in both tables, or invoke hooks for
+ * a column that only exists in one of the tables. */
+static
+void flecs_table_move_column(
+    ecs_world_t *world,
+    ecs_entity_t dst_entity,
+    ecs_entity_t src_entity,
+    ecs_table_t *dst_table,
+    ecs_column_t *dst_column,
+    int32_t dst_index,
+    ecs_table_t *src_table,
+    ecs_column_t *src_column,
+    int32_t src_index,
+    bool construct,
+    bool use_move_dtor)
+{
+    if (dst_column && src_column) {
+        int32_t size = dst_column->size;
+
+        ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
+        void *dst = ecs_vec_get(&dst_column->data, size, dst_index);
+        void *src = ecs_vec_get(&src_column->data, size, src_index);
+        ecs_type_info_t *ti = dst_column->ti;
+
+        /* If the source and destination entities are the same, move component 
+         * between tables. If the entities are not the same (like when cloning)
+         * use a copy. */
+        if (dst_entity == src_entity) {
+            ecs_move_t move = ti->hooks.move_ctor;
+            if (use_move_dtor || !move) {
+                /* Also use move_dtor if component doesn't have a move_ctor
+                 * registered, to ensure that the dtor gets called to 
+                 * cleanup resources. */
+                move = ti->hooks.ctor_move_dtor;
+            }
+
+            if (move) {
+                move(dst, src, 1, ti);
+            } else {
+                ecs_os_memcpy(dst, src, size);
+            }
+        } else {
+            ecs_copy_t copy = ti->hooks.copy_ctor;
+            if (copy) {
+                copy(dst, src, 1, ti);
+            } else {
+                ecs_os_memcpy(dst, src, size);
+            }
+        }
+    } else if (dst_column) {
+        flecs_table_invoke_add_hooks(world, dst_table,
+            dst_column, &dst_entity, dst_index, 1, construct);
+    } else {
+        flecs_table_invoke_remove_hooks(world, src_table,
+            src_column, &src_entity, src_index, 1, use_move_dtor);
+    }
+}
+
 /* Move entity from src to dst table */
 void flecs_table_move(
     ecs_world_t *world,
@@ -1781,7 +1974,8 @@ void flecs_table_move(
     int32_t dst_index,
     ecs_table_t *src_table,
     int32_t src_index,
-    bool construct)
+    bool construct,
+    const ecs_table_move_plan_t *plan)
 {
     ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
     ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
@@ -1795,7 +1989,12 @@ void flecs_table_move(
     flecs_table_check_sanity(src_table);
 
     if (!((dst_table->flags | src_table->flags) & EcsTableIsComplex)) {
-        flecs_table_fast_move(dst_table, dst_index, src_table, src_index);
+        if (plan) {
+            flecs_table_fast_move_w_plan(
+                dst_table, dst_index, src_table, src_index, plan);
+        } else {
+            flecs_table_fast_move(dst_table, dst_index, src_table, src_index);
+        }
         flecs_table_check_sanity(dst_table);
         flecs_table_check_sanity(src_table);
         return;
@@ -1804,68 +2003,45 @@ void flecs_table_move(
     flecs_table_move_switch_columns(dst_table, dst_index, src_table, src_index, 1, false);
     flecs_table_move_bitset_columns(dst_table, dst_index, src_table, src_index, 1, false);
 
-    /* If the source and destination entities are the same, move component 
-     * between tables. If the entities are not the same (like when cloning) use
-     * a copy. */
-    bool same_entity = dst_entity == src_entity;
-
     /* Call move_dtor for moved away from storage only if the entity is at the
      * last index in the source table. If it isn't the last entity, the last 
      * entity in the table will be moved to the src storage, which will take
      * care of cleaning up resources. */
     bool use_move_dtor = ecs_table_count(src_table) == (src_index + 1);
 
-    int32_t i_new = 0, dst_column_count = dst_table->column_count;
-    int32_t i_old = 0, src_column_count = src_table->column_count;
-
     ecs_column_t *src_columns = src_table->data.columns;
     ecs_column_t *dst_columns = dst_table->data.columns;
 
+    if (plan) {
+        const ecs_table_move_op_t *ops = plan->ops;
+        int32_t i, count = plan->count;
+        for (i = 0; i < count; i ++) {
+            const ecs_table_move_op_t *op = &ops[i];
+            flecs_table_move_column(world, dst_entity, src_entity, 
+                dst_table, op->dst != -1 ? &dst_columns[op->dst] : NULL,
+                dst_index,
+                src_table, op->src != -1 ? &src_columns[op->src] : NULL,
+                src_index, construct, use_move_dtor);
+        }
+
+        flecs_table_check_sanity(dst_table);
+        flecs_table_check_sanity(src_table);
+        return;
+    }
+
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+
     for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
         ecs_column_t *dst_column = &dst_columns[i_new];
         ecs_column_t *src_column = &src_columns[i_old];
         ecs_id_t dst_id = dst_column->id;
         ecs_id_t src_id = src_column->id;
 
-        if (dst_id == src_id) {
-            int32_t size = dst_column->size;
-
-            ecs_assert(size != 0, ECS_INTERNAL_ERROR, NULL);
-            void *dst = ecs_vec_get(&dst_column->data, size, dst_index);
-            void *src = ecs_vec_get(&src_column->data, size, src_index);
-            ecs_type_info_t *ti = dst_column->ti;
-
-            if (same_entity) {
-                ecs_move_t move = ti->hooks.move_ctor;
-                if (use_move_dtor || !move) {
-                    /* Also use move_dtor if component doesn't have a move_ctor
-                     * registered, to ensure that the dtor gets called to 
-                     * cleanup resources. */
-                    move = ti->hooks.ctor_move_dtor;
-                }
-
-                if (move) {
-                    move(dst, src, 1, ti);
-                } else {
-                    ecs_os_memcpy(dst, src, size);
-                }
-            } else {
-                ecs_copy_t copy = ti->hooks.copy_ctor;
-                if (copy) {
-                    copy(dst, src, 1, ti);
-                } else {
-                    ecs_os_memcpy(dst, src, size);
-                }
-            }
-        } else {
-            if (dst_id < src_id) {
-                flecs_table_invoke_add_hooks(world, dst_table,
-                    dst_column, &dst_entity, dst_index, 1, construct);
-            } else {
-                flecs_table_invoke_remove_hooks(world, src_table,
-                    src_column, &src_entity, src_index, 1, use_move_dtor);
-            }
-        }
+        flecs_table_move_column(world, dst_entity, src_entity, 
+            dst_table, dst_id <= src_id ? dst_column : NULL, dst_index,
+            src_table, dst_id >= src_id ? src_column : NULL, src_index,
+            construct, use_move_dtor);
 
         i_new += dst_id <= src_id;
         i_old += dst_id >= src_id;
@@ -1885,6 +2061,63 @@ void flecs_table_move(
     flecs_table_check_sanity(src_table);
 }
 
+ecs_table_move_plan_t* flecs_table_move_plan_init(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table)
+{
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+    int32_t count = 0, max_count = dst_column_count + src_column_count;
+
+    ecs_table_move_plan_t *plan = flecs_alloc(&world->allocator, 
+        ECS_SIZEOF(ecs_table_move_plan_t) + 
+            max_count * ECS_SIZEOF(ecs_table_move_op_t));
+    ecs_table_move_op_t *ops = plan->ops = 
+        ECS_OFFSET_T(plan, ecs_table_move_plan_t);
+    plan->size = max_count;
+
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+
+    /* Same iteration order as flecs_table_move, so that hooks are invoked in
+     * the same order when moving with a plan. */
+    for (; (i_new < dst_column_count) && (i_old < src_column_count); ) {
+        ecs_id_t dst_id = dst_columns[i_new].id;
+        ecs_id_t src_id = src_columns[i_old].id;
+        ops[count].dst = flecs_ito(int16_t, dst_id <= src_id ? i_new : -1);
+        ops[count].src = flecs_ito(int16_t, dst_id >= src_id ? i_old : -1);
+        count ++;
+        i_new += dst_id <= src_id;
+        i_old += dst_id >= src_id;
+    }
+
+    for (; (i_new < dst_column_count); i_new ++) {
+        ops[count].dst = flecs_ito(int16_t, i_new);
+        ops[count].src = -1;
+        count ++;
+    }
+
+    for (; (i_old < src_column_count); i_old ++) {
+        ops[count].dst = -1;
+        ops[count].src = flecs_ito(int16_t, i_old);
+        count ++;
+    }
+
+    ecs_assert(count <= max_count, ECS_INTERNAL_ERROR, NULL);
+    plan->count = count;
+
+    return plan;
+}
+
+void flecs_table_move_plan_fini(
+    ecs_world_t *world,
+    ecs_table_move_plan_t *plan)
+{
+    flecs_free(&world->allocator, ECS_SIZEOF(ecs_table_move_plan_t) + 
+        plan->size * ECS_SIZEOF(ecs_table_move_op_t), plan);
+}
+
 /* Append n entities to table */
 int32_t flecs_table_appendn(
     ecs_world_t *world,
@@ -1946,6 +2179,11 @@ bool flecs_table_shrink(
         ecs_vec_reclaim(&world->allocator, &column->data, column->size);
     }
 
+    if (data->entities.count) {
+        /* Restore padding of over-aligned columns */
+        flecs_table_ensure_min_size(world, table, data);
+    }
+
     return has_payload;
 }
 
@@ -2230,6 +2468,9 @@ void flecs_table_merge_data(
         ecs_vec_fini(a, &column->data, column->size);
     }    
 
+    /* Storage of source table may not be padded for over-aligned columns */
+    flecs_table_ensure_min_size(world, dst_table, dst_data);
+
     /* Mark entity column as dirty */
     flecs_table_mark_table_dirty(world, dst_table, 0); 
 }
@@ -2308,8 +2549,10 @@ void flecs_table_merge(
         }
         flecs_table_set_empty(world, src_table);
 
-        flecs_table_traversable_add(dst_table, src_table->_->traversable_count);
-        flecs_table_traversable_add(src_table, -src_table->_->traversable_count);
+        flecs_table_traversable_add(world, dst_table, 
+            src_table->_->traversable_count);
+        flecs_table_traversable_add(world, src_table, 
+            -src_table->_->traversable_count);
         ecs_assert(src_table->_->traversable_count == 0, ECS_INTERNAL_ERROR, NULL);
     }
 
@@ -2317,6 +2560,81 @@ void flecs_table_merge(
     flecs_table_check_sanity(dst_table);
 }
 
+/* Move all entities from one table to another. This is the same as a merge,
+ * except that the on_add and on_remove hooks of components that only exist in
+ * one of the tables are invoked, like when moving entities one by one. */
+int32_t flecs_table_move_all(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table)
+{
+    ecs_assert(dst_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(src_table != NULL, ECS_INTERNAL_ERROR, NULL);
+    ecs_assert(dst_table != src_table, ECS_INTERNAL_ERROR, NULL);
+
+    int32_t src_count = ecs_table_count(src_table);
+    int32_t dst_count = ecs_table_count(dst_table);
+    if (!src_count) {
+        return dst_count;
+    }
+
+    ecs_column_t *src_columns = src_table->data.columns;
+    ecs_column_t *dst_columns = dst_table->data.columns;
+    int32_t i_new = 0, dst_column_count = dst_table->column_count;
+    int32_t i_old = 0, src_column_count = src_table->column_count;
+
+    /* Invoke on_remove hooks while the components still exist */
+    ecs_entity_t *entities = ecs_vec_first(&src_table->data.entities);
+    for (; i_old < src_column_count; ) {
+        ecs_column_t *src_column = &src_columns[i_old];
+        ecs_id_t src_id = src_column->id;
+        ecs_id_t dst_id = 0;
+        if (i_new < dst_column_count) {
+            dst_id = dst_columns[i_new].id;
+        }
+
+        if (!dst_id || (dst_id > src_id)) {
+            ecs_iter_action_t on_remove = src_column->ti->hooks.on_remove;
+            if (on_remove) {
+                flecs_table_invoke_hook(world, src_table, on_remove, 
+                    EcsOnRemove, src_column, entities, 0, src_count);
+            }
+        }
+
+        i_new += dst_id && (dst_id <= src_id);
+        i_old += !dst_id || (dst_id >= src_id);
+    }
+
+    flecs_table_merge(world, dst_table, src_table, 
+        &dst_table->data, &src_table->data);
+
+    /* Invoke on_add hooks for components that were constructed by the merge */
+    entities = ecs_vec_get_t(&dst_table->data.entities, ecs_entity_t, dst_count);
+    i_new = 0;
+    i_old = 0;
+    for (; i_new < dst_column_count; ) {
+        ecs_column_t *dst_column = &dst_columns[i_new];
+        ecs_id_t dst_id = dst_column->id;
+        ecs_id_t src_id = 0;
+        if (i_old < src_column_count) {
+            src_id = src_columns[i_old].id;
+        }
+
+        if (!src_id || (dst_id < src_id)) {
+            ecs_iter_action_t on_add = dst_column->ti->hooks.on_add;
+            if (on_add) {
+                flecs_table_invoke_hook(world, dst_table, on_add, 
+                    EcsOnAdd, dst_column, entities, dst_count, src_count);
+            }
+        }
+
+        i_old += src_id && (src_id <= dst_id);
+        i_new += !src_id || (src_id >= dst_id);
+    }
+
+    return dst_count;
+}
+
 /* Replace data with other data. Used by snapshots to restore previous state. */
 void flecs_table_replace_data(
     ecs_world_t *world,
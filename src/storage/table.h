@@ -49,8 +49,25 @@ typedef struct ecs_table__t {
     int16_t bs_count;
     int16_t bs_offset;
     int16_t ft_offset;
+    int32_t min_size;                /* Minimum storage size (in elements) */
 } ecs_table__t;
 
+/** Column operation of a move plan. A column index of -1 means that the column
+ * only exists in the other table, in which case hooks are invoked instead of
+ * moving the component. */
+typedef struct ecs_table_move_op_t {
+    int16_t dst;                     /* Column in destination table */
+    int16_t src;                     /* Column in source table */
+} ecs_table_move_op_t;
+
+/** Column operations for moving a row between two tables, in the order in
+ * which the columns would be matched by flecs_table_move. */
+struct ecs_table_move_plan_t {
+    ecs_table_move_op_t *ops;
+    int32_t count;
+    int32_t size;                    /* Number of allocated ops */
+};
+
 /** Table column */
 typedef struct ecs_column_t {
     ecs_vec_t data;                  /* Vector with component data */
@@ -159,7 +176,8 @@ void flecs_table_delete(
 bool flecs_table_records_update_empty(
     ecs_table_t *table);
 
-/* Move a row from one table to another */
+/* Move a row from one table to another. If plan is not NULL it must have been
+ * created for the same destination and source table. */
 void flecs_table_move(
     ecs_world_t *world,
     ecs_entity_t dst_entity,
@@ -168,7 +186,19 @@ void flecs_table_move(
     int32_t new_index,
     ecs_table_t *old_table,
     int32_t old_index,
-    bool construct);
+    bool construct,
+    const ecs_table_move_plan_t *plan);
+
+/* Create move plan for moving rows from the src to the dst table */
+ecs_table_move_plan_t* flecs_table_move_plan_init(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table);
+
+/* Free move plan */
+void flecs_table_move_plan_fini(
+    ecs_world_t *world,
+    ecs_table_move_plan_t *plan);
 
 /* Grow table with specified number of records. Populate table with entities,
  * starting from specified entity id. */
@@ -229,6 +259,13 @@ void flecs_table_merge(
     ecs_data_t *new_data,
     ecs_data_t *old_data);
 
+/* Move all entities of one table to another table, invoking hooks for added
+ * and removed components. Returns the row of the first moved entity. */
+int32_t flecs_table_move_all(
+    ecs_world_t *world,
+    ecs_table_t *dst_table,
+    ecs_table_t *src_table);
+
 void flecs_table_swap(
     ecs_world_t *world,
     ecs_table_t *table,
@@ -253,8 +290,9 @@ int32_t flecs_table_column_to_union_index(
     const ecs_table_t *table,
     int32_t column);
 
-/* Increase observer count of table */
+/* Increase traversable entity count of table */
 void flecs_table_traversable_add(
+    ecs_world_t *world,
     ecs_table_t *table,
     int32_t value);
 
@@ -350,6 +350,7 @@ void flecs_table_diff_build_noalloc(
         .array = builder->added.array, .count = builder->added.count };
     diff->removed = (ecs_type_t){
         .array = builder->removed.array, .count = builder->removed.count };
+    diff->edge = NULL;
 }
 
 static
@@ -460,6 +461,9 @@ void flecs_table_disconnect_edge(
     if (diff) {
         flecs_table_diff_free(world, diff);
     }
+    if (edge->plan) {
+        flecs_table_move_plan_fini(world, edge->plan);
+    }
 
     /* If edge id is low, clear it from fast lookup array */
     if (id < FLECS_HI_COMPONENT_ID) {
@@ -1067,6 +1071,7 @@ ecs_table_t* flecs_table_traverse_remove(
             diff->removed.array = id_ptr;
             diff->removed.count = 1;
         }
+        diff->edge = edge;
     }
 
     return to;
@@ -1107,6 +1112,7 @@ ecs_table_t* flecs_table_traverse_add(
             diff->added.count = 1;
             diff->removed.count = 0;
         }
+        diff->edge = edge;
     }
 
     return to;
@@ -1137,6 +1143,20 @@ void flecs_init_root_table(
     (void)new_id;
 }
 
+ecs_table_move_plan_t* flecs_table_edge_move_plan(
+    ecs_world_t *world,
+    ecs_graph_edge_t *edge)
+{
+    ecs_table_move_plan_t *plan = edge->plan;
+    if (!plan) {
+        ecs_assert(edge->from != NULL, ECS_INTERNAL_ERROR, NULL);
+        ecs_assert(edge->to != NULL, ECS_INTERNAL_ERROR, NULL);
+        plan = edge->plan = flecs_table_move_plan_init(
+            world, edge->to, edge->from);
+    }
+    return plan;
+}
+
 void flecs_table_clear_edges(
     ecs_world_t *world,
     ecs_table_t *table)
@@ -20,8 +20,12 @@ typedef struct ecs_table_diff_builder_t {
 typedef struct ecs_table_diff_t {
     ecs_type_t added;                /* Components added between tables */
     ecs_type_t removed;              /* Components removed between tables */
+    struct ecs_graph_edge_t *edge;   /* Edge diff was obtained from, if any */
 } ecs_table_diff_t;
 
+/** Precomputed column mapping for moving entities between tables */
+typedef struct ecs_table_move_plan_t ecs_table_move_plan_t;
+
 /** Edge linked list (used to keep track of incoming edges) */
 typedef struct ecs_graph_edge_hdr_t {
     struct ecs_graph_edge_hdr_t *prev;
@@ -35,6 +39,7 @@ typedef struct ecs_graph_edge_t {
     ecs_table_t *to;                 /* Edge destination table */
     ecs_table_diff_t *diff;          /* Index into diff vector, if non trivial edge */
     ecs_id_t id;                     /* Id associated with edge */
+    ecs_table_move_plan_t *plan;     /* Move plan, created on first move */
 } ecs_graph_edge_t;
 
 /* Edges to other tables. */
@@ -67,6 +72,12 @@ ecs_table_t *flecs_table_traverse_remove(
     ecs_id_t *id_ptr,
     ecs_table_diff_t *diff);
 
+/* Get move plan for the tables of an edge. The plan is created on first use
+ * and is deleted together with the edge. */
+ecs_table_move_plan_t* flecs_table_edge_move_plan(
+    ecs_world_t *world,
+    ecs_graph_edge_t *edge);
+
 /* Cleanup incoming and outgoing edges for table */
 void flecs_table_clear_edges(
     ecs_world_t *world,
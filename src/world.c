@@ -420,6 +420,81 @@ void flecs_resume_readonly(
     }
 }
 
+/* Collect tables that (transitively) traverse one of the changed entities. A
+ * table can only get a different match for a query with up traversal if one of
+ * the entities on its traversal path changed, so queries only need to rematch
+ * these tables. Tables are found by walking the (*, entity) records of
+ * traversable relationships, which also yields the traversable entities in the
+ * next level of the hierarchy. */
+static
+void flecs_monitor_collect_tables(
+    ecs_world_t *world)
+{
+    ecs_monitor_set_t *ms = &world->monitors;
+    ecs_vec_clear(&ms->tables);
+    if (ms->rematch_all) {
+        return;
+    }
+
+    ecs_allocator_t *a = &world->allocator;
+    ecs_map_t visited;
+    ecs_map_init(&visited, a);
+    ecs_vec_t stack;
+    ecs_vec_init_t(a, &stack, ecs_id_record_t*, 0);
+
+    int32_t i, count = ecs_vec_count(&ms->entities);
+    ecs_entity_t *entities = ecs_vec_first(&ms->entities);
+    for (i = 0; i < count; i ++) {
+        ecs_id_record_t *idr = flecs_id_record_get(world, 
+            ecs_pair(EcsWildcard, entities[i]));
+        if (idr) {
+            ecs_vec_append_t(a, &stack, ecs_id_record_t*)[0] = idr;
+        }
+    }
+
+    while ((count = ecs_vec_count(&stack))) {
+        ecs_id_record_t *cur = ecs_vec_get_t(
+            &stack, ecs_id_record_t*, count - 1)[0];
+        ecs_vec_remove_last(&stack);
+
+        while ((cur = cur->trav.next)) {
+            ecs_table_cache_iter_t it;
+            if (!flecs_table_cache_all_iter(&cur->cache, &it)) {
+                continue;
+            }
+
+            const ecs_table_record_t *tr;
+            while ((tr = flecs_table_cache_next(&it, ecs_table_record_t))) {
+                ecs_table_t *table = tr->hdr.table;
+                ecs_map_val_t *v = ecs_map_ensure(&visited, table->id);
+                if (v[0]) {
+                    continue;
+                }
+
+                v[0] = 1;
+                ecs_vec_append_t(a, &ms->tables, ecs_table_t*)[0] = table;
+
+                if (!table->_->traversable_count) {
+                    continue;
+                }
+
+                int32_t e, entity_count = ecs_table_count(table);
+                ecs_record_t **records = ecs_vec_first(&table->data.records);
+                for (e = 0; e < entity_count; e ++) {
+                    ecs_record_t *r = records[e];
+                    if ((r->row & EcsEntityIsTraversable) && r->idr) {
+                        ecs_vec_append_t(a, &stack, ecs_id_record_t*)[0] = 
+                            r->idr;
+                    }
+                }
+            }
+        }
+    }
+
+    ecs_vec_fini_t(a, &stack, ecs_id_record_t*);
+    ecs_map_fini(&visited);
+}
+
 /* Evaluate component monitor. If a monitored entity changed it will have set a
  * flag in one of the world's component monitors. Queries can register 
  * themselves with component monitors to determine whether they need to rematch
@@ -436,6 +511,8 @@ void flecs_eval_component_monitor(
 
     world->monitors.is_dirty = false;
 
+    flecs_monitor_collect_tables(world);
+
     ecs_map_iter_t it = ecs_map_iter(&world->monitors.monitors);
     while (ecs_map_next(&it)) {
         ecs_monitor_t *m = ecs_map_ptr(&it);
@@ -454,10 +531,38 @@ void flecs_eval_component_monitor(
             });
         }
     }
+
+    ecs_vec_clear(&world->monitors.tables);
+}
+
+/* Add changed entity. An entity of 0 means that the change can't be attributed
+ * to a single entity, in which case queries rematch all tables. */
+static
+void flecs_monitor_add_entity(
+    ecs_world_t *world,
+    ecs_entity_t entity)
+{
+    ecs_monitor_set_t *ms = &world->monitors;
+    if (!entity) {
+        ms->rematch_all = true;
+        return;
+    }
+
+    /* Entity is typically marked for multiple (monitored) ids in a row */
+    int32_t count = ecs_vec_count(&ms->entities);
+    if (count && ecs_vec_get_t(
+        &ms->entities, ecs_entity_t, count - 1)[0] == entity) 
+    {
+        return;
+    }
+
+    ecs_vec_append_t(&world->allocator, &ms->entities, ecs_entity_t)[0] = 
+        entity;
 }
 
 void flecs_monitor_mark_dirty(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_entity_t id)
 {
     ecs_map_t *monitors = &world->monitors.monitors;
@@ -469,9 +574,12 @@ void flecs_monitor_mark_dirty(
         if (m) {
             if (!world->monitors.is_dirty) {
                 world->monitor_generation ++;
+                world->monitors.rematch_all = false;
+                ecs_vec_clear(&world->monitors.entities);
             }
             m->is_dirty = true;
             world->monitors.is_dirty = true;
+            flecs_monitor_add_entity(world, entity);
         }
     }
 }
@@ -906,6 +1014,9 @@ ecs_world_t *ecs_mini(void) {
         &world->allocators.sparse_chunk, ecs_type_info_t);
     ecs_map_init_w_params(&world->id_index_hi, &world->allocators.ptr);
     world->id_index_lo = ecs_os_calloc_n(ecs_id_record_t, FLECS_HI_ID_RECORD_ID);
+    ecs_vec_init_t(a, &world->id_index_pairs, ecs_pair_index_rel_page_t*, 0);
+    ecs_vec_init_t(a, &world->monitors.entities, ecs_entity_t, 0);
+    ecs_vec_init_t(a, &world->monitors.tables, ecs_table_t*, 0);
     flecs_observable_init(&world->observable);
     world->iterable.init = flecs_world_iter_init;
 
@@ -1411,6 +1522,8 @@ int ecs_fini(
     /* All queries are cleaned up, so monitors should've been cleaned up too */
     ecs_assert(!ecs_map_is_init(&world->monitors.monitors), 
         ECS_INTERNAL_ERROR, NULL);
+    ecs_vec_fini_t(&world->allocator, &world->monitors.entities, ecs_entity_t);
+    ecs_vec_fini_t(&world->allocator, &world->monitors.tables, ecs_table_t*);
 
     /* Cleanup world ctx and binding_ctx */
     if (world->ctx_free) {
@@ -1435,6 +1548,7 @@ int ecs_fini(
     flecs_name_index_fini(&world->aliases);
     flecs_name_index_fini(&world->symbols);
     ecs_set_stage_count(world, 0);
+    flecs_merge_writes_fini(world);
     ecs_log_pop_1();
 
     flecs_world_allocators_fini(world);
@@ -47,6 +47,7 @@ void flecs_eval_component_monitors(
 
 void flecs_monitor_mark_dirty(
     ecs_world_t *world,
+    ecs_entity_t entity,
     ecs_entity_t id);
 
 void flecs_monitor_register(
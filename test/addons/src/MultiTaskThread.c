@@ -1382,3 +1382,42 @@ void MultiTaskThread_run_single_thread_on_main(void) {
 
     ecs_fini(world);
 }
+
+static void ParEachProgress(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 1);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+}
+
+void MultiTaskThread_par_each(void) {
+    ecs_world_t *world = init_world();
+
+    int i, ENTITIES = 100;
+    ecs_entity_t handles[100];
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_set(world, 0, Position, {0});
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_set_task_threads(world, 4);
+
+    ecs_query_par_each(world, q, ParEachProgress, NULL, 8);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    /* Pipeline still runs with task threads */
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_fini(world);
+}
@@ -1,6 +1,7 @@
 #include <addons.h>
 
 static ECS_COMPONENT_DECLARE(Position);
+static ECS_COMPONENT_DECLARE(Velocity);
 static ECS_DECLARE(Tag);
 
 void MultiThread_setup(void) {
@@ -1382,3 +1383,1203 @@ void MultiThread_run_single_thread_on_main(void) {
 
     ecs_fini(world);
 }
+
+void MultiThread_2_thread_10_entity_w_chunks(void) {
+    ecs_world_t *world = init_world();
+
+    int i, ENTITIES = 10, THREADS = 2;
+    ecs_entity_t *handles = ecs_os_alloca(sizeof(ecs_entity_t) * ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new(world, Position);
+        ecs_set(world, handles[i], Position, {0});
+    }
+
+    ecs_set_threads(world, THREADS);
+    ecs_set_worker_chunk_size(world, 3);
+    test_int(ecs_get_worker_chunk_size(world), 3);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+static void MoveShared(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 1);
+    Velocity *v = ecs_field(it, Velocity, 2);
+    test_assert(!ecs_field_is_self(it, 2));
+
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x += v->x;
+        p[i].y += v->y;
+    }
+}
+
+void MultiThread_2_thread_w_chunks_shared_field(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, {.add = {ecs_dependson(EcsOnUpdate)}}),
+        .callback = MoveShared,
+        .query.filter.expr = "Position, Velocity(up(IsA))",
+        .multi_threaded = true
+    });
+
+    ecs_entity_t base = ecs_new_w_id(world, EcsPrefab);
+    ecs_set(world, base, Velocity, {1, 2});
+
+    int i, ENTITIES = 100, THREADS = 2;
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new_w_pair(world, EcsIsA, base);
+        ecs_set(world, handles[i], Position, {0, 0});
+    }
+
+    /* Multiple chunks per table, each of which is iterated per row */
+    ecs_set_threads(world, THREADS);
+    ecs_set_worker_chunk_size(world, 7);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        const Position *p = ecs_get(world, handles[i], Position);
+        test_int(p->x, 2);
+        test_int(p->y, 4);
+    }
+
+    ecs_os_free(handles);
+    ecs_fini(world);
+}
+
+void MultiThread_6_thread_uneven_tables_w_chunks(void) {
+    ecs_world_t *world = init_world();
+
+    int i, t, THREADS = 6, TABLES = 4, ENTITIES = 0;
+    int table_sizes[] = { 1, 500, 7, 2000 };
+
+    for (t = 0; t < TABLES; t ++) {
+        ENTITIES += table_sizes[t];
+    }
+
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+
+    int e = 0;
+    for (t = 0; t < TABLES; t ++) {
+        ecs_entity_t tag = ecs_new_id(world);
+        for (i = 0; i < table_sizes[t]; i ++) {
+            handles[e] = ecs_new(world, Position);
+            ecs_set(world, handles[e], Position, {0});
+            ecs_add_id(world, handles[e], tag);
+            e ++;
+        }
+    }
+
+    ecs_set_threads(world, THREADS);
+    ecs_set_worker_chunk_size(world, 16);
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    /* Restore even distribution */
+    ecs_set_worker_chunk_size(world, 0);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 3);
+    }
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+static int chunk_singleton_invoked = 0;
+
+static void ChunkSingleton(ecs_iter_t *it) {
+    test_int(it->count, 0);
+    ecs_os_ainc(&chunk_singleton_invoked);
+}
+
+void MultiThread_2_thread_singleton_w_chunks(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_singleton_set(world, Position, {10, 20});
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) }}),
+        .query.filter.terms = {{ ecs_id(Position), .src.id = ecs_id(Position) }},
+        .multi_threaded = true,
+        .callback = ChunkSingleton
+    });
+
+    ecs_set_threads(world, 2);
+    ecs_set_worker_chunk_size(world, 4);
+
+    ecs_progress(world, 0);
+    test_int(chunk_singleton_invoked, 1);
+
+    ecs_progress(world, 0);
+    test_int(chunk_singleton_invoked, 2);
+
+    ecs_fini(world);
+}
+
+void MultiThread_4_thread_10_entity_no_futex(void) {
+    ecs_world_t *world = init_world();
+
+    /* Force fallback to mutex / condition variable synchronization */
+    ecs_os_api_futex_wait_t futex_wait = ecs_os_api.futex_wait_;
+    ecs_os_api.futex_wait_ = NULL;
+    test_bool(ecs_os_has_futex(), false);
+
+    int i, ENTITIES = 10, THREADS = 4;
+    ecs_entity_t *handles = ecs_os_alloca(sizeof(ecs_entity_t) * ENTITIES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new(world, Position);
+        ecs_set(world, handles[i], Position, {0});
+    }
+
+    ecs_set_threads(world, THREADS);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_progress(world, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_fini(world);
+
+    ecs_os_api.futex_wait_ = futex_wait;
+}
+
+static
+void SpawnFromWorker(ecs_iter_t *it) {
+    int32_t *spawn_count = it->ctx;
+    int i, j;
+    for (i = 0; i < it->count; i ++) {
+        for (j = 0; j < *spawn_count; j ++) {
+            ecs_set(it->world, 0, Velocity, {(float)i, (float)j});
+        }
+    }
+}
+
+static
+ecs_world_t* init_spawn_world(
+    int32_t *spawn_count,
+    int32_t spawner_count)
+{
+    ecs_world_t *world = ecs_init();
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) }}),
+        .query.filter.terms = {{ ecs_id(Position) }},
+        .callback = SpawnFromWorker,
+        .multi_threaded = true,
+        .ctx = spawn_count
+    });
+
+    int i;
+    for (i = 0; i < spawner_count; i ++) {
+        ecs_new(world, Position);
+    }
+
+    return world;
+}
+
+static
+void test_spawn_unique(
+    ecs_world_t *world,
+    int32_t expect)
+{
+    test_int(ecs_count(world, Velocity), expect);
+
+    ecs_map_t ids;
+    ecs_map_init(&ids, NULL);
+
+    ecs_filter_t *f = ecs_filter(world, { .terms = {{ ecs_id(Velocity) }}});
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    while (ecs_filter_next(&it)) {
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            ecs_entity_t e = it.entities[i];
+            test_assert(ecs_is_alive(world, e));
+            test_assert(ecs_map_get(&ids, e) == NULL);
+            ecs_map_insert(&ids, e, 1);
+        }
+    }
+    ecs_filter_fini(f);
+
+    test_int(ecs_map_count(&ids), expect);
+    ecs_map_fini(&ids);
+}
+
+void MultiThread_new_from_workers(void) {
+    int32_t spawn_count = 100;
+    ecs_world_t *world = init_spawn_world(&spawn_count, 100);
+
+    ecs_set_threads(world, 4);
+    ecs_progress(world, 0);
+    test_spawn_unique(world, 100 * 100);
+
+    ecs_progress(world, 0);
+    test_spawn_unique(world, 2 * 100 * 100);
+
+    ecs_fini(world);
+}
+
+void MultiThread_new_from_workers_no_aadd(void) {
+    /* Without atomic add, ids are created one at a time */
+    ecs_os_api_aadd_t aadd = ecs_os_api.aadd_;
+    ecs_os_api.aadd_ = NULL;
+
+    int32_t spawn_count = 100;
+    ecs_world_t *world = init_spawn_world(&spawn_count, 100);
+
+    ecs_set_threads(world, 4);
+    ecs_progress(world, 0);
+    test_spawn_unique(world, 100 * 100);
+
+    ecs_fini(world);
+
+    ecs_os_api.aadd_ = aadd;
+}
+
+void MultiThread_new_from_workers_recycle_unused(void) {
+    int32_t spawn_count = 1;
+    ecs_world_t *world = init_spawn_world(&spawn_count, 4);
+
+    ecs_set_threads(world, 4);
+    ecs_progress(world, 0);
+    test_spawn_unique(world, 4);
+
+    ecs_entity_t max_spawned = 0;
+    ecs_filter_t *f = ecs_filter(world, { .terms = {{ ecs_id(Velocity) }}});
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    while (ecs_filter_next(&it)) {
+        int i;
+        for (i = 0; i < it.count; i ++) {
+            if (it.entities[i] > max_spawned) {
+                max_spawned = it.entities[i];
+            }
+        }
+    }
+    ecs_filter_fini(f);
+
+    /* Ids that stages reserved but didn't use are recycled. Stages reserve at
+     * least 64 ids at a time, so without recycling the new id would be 
+     * created after the reserved ranges. */
+    ecs_entity_t e = ecs_new_id(world);
+    test_assert(e < max_spawned + 64);
+
+    int i;
+    for (i = 0; i < 1000; i ++) {
+        e = ecs_new_id(world);
+        test_assert(ecs_is_alive(world, e));
+        test_assert(!ecs_has(world, e, Velocity));
+        ecs_add(world, e, Velocity);
+    }
+
+    test_int(ecs_count(world, Velocity), 1000 + 4);
+
+    ecs_fini(world);
+}
+
+static void ParEachProgress(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 1);
+    int32_t *invoked = it->ctx;
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+    ecs_os_ainc(invoked);
+}
+
+void MultiThread_par_each_2_thread(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int i, ENTITIES = 100;
+    ecs_entity_t handles[100];
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_set(world, 0, Position, {0});
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_set_threads(world, 2);
+
+    int32_t invoked = 0;
+    ecs_query_par_each(world, q, ParEachProgress, &invoked, 10);
+    test_int(invoked, 10);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    /* Workers can still run the pipeline after a par_each */
+    ecs_progress(world, 0);
+
+    invoked = 0;
+    ecs_query_par_each(world, q, ParEachProgress, &invoked, 10);
+    test_int(invoked, 10);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_par_each_w_shared_field(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t base = ecs_new_w_id(world, EcsPrefab);
+    ecs_set(world, base, Velocity, {1, 2});
+
+    int i, ENTITIES = 1000;
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_new_w_pair(world, EcsIsA, base);
+        ecs_set(world, handles[i], Position, {0, 0});
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.expr = "Position, Velocity(up(IsA))"
+    });
+
+    ecs_set_threads(world, 4);
+
+    ecs_query_par_each(world, q, MoveShared, NULL, 64);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        const Position *p = ecs_get(world, handles[i], Position);
+        test_int(p->x, 1);
+        test_int(p->y, 2);
+    }
+
+    ecs_os_free(handles);
+    ecs_fini(world);
+}
+
+void MultiThread_par_each_6_thread_uneven_tables(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int i, t, TABLES = 4, ENTITIES = 0;
+    int table_sizes[] = { 1, 500, 7, 2000 };
+
+    for (t = 0; t < TABLES; t ++) {
+        ENTITIES += table_sizes[t];
+    }
+
+    ecs_entity_t *handles = ecs_os_malloc_n(ecs_entity_t, ENTITIES);
+
+    int e = 0;
+    for (t = 0; t < TABLES; t ++) {
+        ecs_entity_t tag = ecs_new_id(world);
+        for (i = 0; i < table_sizes[t]; i ++) {
+            handles[e] = ecs_set(world, 0, Position, {0});
+            ecs_add_id(world, handles[e], tag);
+            e ++;
+        }
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_set_threads(world, 6);
+
+    int32_t invoked = 0;
+    ecs_query_par_each(world, q, ParEachProgress, &invoked, 16);
+    test_int(invoked, 1 + 32 + 1 + 125);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    /* Automatic chunk size */
+    ecs_query_par_each(world, q, ParEachProgress, &invoked, 0);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_os_free(handles);
+
+    ecs_fini(world);
+}
+
+void MultiThread_par_each_no_threads(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {0});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {0});
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }}
+    });
+
+    /* Results are not split up when iterating on the calling thread */
+    int32_t invoked = 0;
+    ecs_query_par_each(world, q, ParEachProgress, &invoked, 1);
+    test_int(invoked, 1);
+
+    test_int(ecs_get(world, e1, Position)->x, 1);
+    test_int(ecs_get(world, e2, Position)->x, 1);
+
+    ecs_fini(world);
+}
+
+static void ParEachAddTag(ecs_iter_t *it) {
+    ecs_entity_t tag = *(ecs_entity_t*)it->ctx;
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_add_id(it->world, it->entities[i], tag);
+    }
+}
+
+void MultiThread_par_each_w_commands(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG(world, Foo);
+
+    int i, ENTITIES = 50;
+    ecs_entity_t handles[50];
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_set(world, 0, Position, {0});
+    }
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_set_threads(world, 4);
+
+    ecs_query_par_each(world, q, ParEachAddTag, &Foo, 4);
+    test_assert(!ecs_stage_is_readonly(world));
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_assert(ecs_has(world, handles[i], Foo));
+    }
+
+    ecs_fini(world);
+}
+
+void MultiThread_par_each_after_table_create(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_set_threads(world, 2);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {0});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {0});
+    ecs_add(world, e2, Foo);
+
+    int32_t invoked = 0;
+    ecs_query_par_each(world, q, ParEachProgress, &invoked, 0);
+    test_int(invoked, 2);
+
+    test_int(ecs_get(world, e1, Position)->x, 1);
+    test_int(ecs_get(world, e2, Position)->x, 1);
+
+    ecs_fini(world);
+}
+
+static void RuleParEachProgress(ecs_iter_t *it) {
+    Position *p = ecs_field(it, Position, 1);
+    int32_t *invoked = it->ctx;
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        p[i].x ++;
+    }
+    ecs_os_ainc(invoked);
+}
+
+void MultiThread_rule_par_each_2_thread(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    int i, ENTITIES = 100, TABLES = 10;
+    ecs_entity_t handles[100];
+    ecs_entity_t tags[10];
+    for (i = 0; i < TABLES; i ++) {
+        tags[i] = ecs_new_id(world);
+    }
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_set(world, 0, Position, {0});
+        ecs_set(world, handles[i], Velocity, {0});
+        ecs_add_id(world, handles[i], tags[i % TABLES]);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position, Velocity"
+    });
+    test_assert(r != NULL);
+
+    ecs_set_threads(world, 2);
+
+    int32_t invoked = 0;
+    ecs_rule_par_each(world, r, RuleParEachProgress, &invoked);
+    test_int(invoked, TABLES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    /* Workers can still run the pipeline after a par_each */
+    ecs_progress(world, 0);
+
+    invoked = 0;
+    ecs_rule_par_each(world, r, RuleParEachProgress, &invoked);
+    test_int(invoked, TABLES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 2);
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+static void RuleParEachCountVar(ecs_iter_t *it) {
+    int32_t *count = it->ctx;
+    ecs_entity_t x = ecs_pair_second(it->real_world, ecs_field_id(it, 1));
+    test_assert(ecs_has(it->real_world, x, Position));
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        test_assert(ecs_has_pair(it->real_world, it->entities[i], Tag, x));
+        ecs_os_ainc(&count[0]);
+    }
+}
+
+void MultiThread_rule_par_each_w_var(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG_DEFINE(world, Tag);
+
+    int i, TARGETS = 20, ENTITIES = 200;
+    ecs_entity_t targets[20];
+    for (i = 0; i < TARGETS; i ++) {
+        targets[i] = ecs_new_id(world);
+        if (i % 2) {
+            ecs_set(world, targets[i], Position, {0});
+        }
+    }
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_new_w_pair(world, Tag, targets[i % TARGETS]);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Tag($this, $x), Position($x)"
+    });
+    test_assert(r != NULL);
+
+    ecs_set_threads(world, 4);
+
+    int32_t count = 0;
+    ecs_rule_par_each(world, r, RuleParEachCountVar, &count);
+    test_int(count, ENTITIES / 2);
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+static void RuleParEachCount(ecs_iter_t *it) {
+    int32_t *count = it->ctx;
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_os_ainc(&count[0]);
+    }
+}
+
+void MultiThread_rule_par_each_no_partition(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t x = ecs_new_entity(world, "x");
+    ecs_entity_t a = ecs_new_w_pair(world, LocatedIn, x);
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, x);
+    ecs_new_w_pair(world, LocatedIn, a);
+    ecs_new_w_pair(world, LocatedIn, a);
+    ecs_new_w_pair(world, LocatedIn, b);
+
+    /* First operation traverses, rule is evaluated by a single thread */
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, x)"
+    });
+    test_assert(r != NULL);
+
+    ecs_set_threads(world, 4);
+
+    int32_t count = 0;
+    ecs_rule_par_each(world, r, RuleParEachCount, &count);
+    test_int(count, 5);
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void MultiThread_rule_par_each_cached(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int i, ENTITIES = 100, TABLES = 10;
+    ecs_entity_t handles[100];
+    ecs_entity_t tags[10];
+    for (i = 0; i < TABLES; i ++) {
+        tags[i] = ecs_new_id(world);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    /* Tables are created after the rule, so cache is out of date */
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_set(world, 0, Position, {0});
+        ecs_add_id(world, handles[i], tags[i % TABLES]);
+    }
+
+    ecs_set_threads(world, 4);
+
+    int32_t invoked = 0;
+    ecs_rule_par_each(world, r, RuleParEachProgress, &invoked);
+    test_int(invoked, TABLES);
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_int(ecs_get(world, handles[i], Position)->x, 1);
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void MultiThread_rule_par_each_no_threads(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {0});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {0});
+    ecs_add(world, e2, Foo);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position"
+    });
+    test_assert(r != NULL);
+
+    int32_t invoked = 0;
+    ecs_rule_par_each(world, r, RuleParEachProgress, &invoked);
+    test_int(invoked, 2);
+
+    test_int(ecs_get(world, e1, Position)->x, 1);
+    test_int(ecs_get(world, e2, Position)->x, 1);
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+static void RuleParEachAddTag(ecs_iter_t *it) {
+    ecs_entity_t tag = *(ecs_entity_t*)it->ctx;
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_add_id(it->world, it->entities[i], tag);
+    }
+}
+
+void MultiThread_rule_par_each_w_commands(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_TAG(world, Foo);
+
+    int i, ENTITIES = 50;
+    ecs_entity_t handles[50];
+    for (i = 0; i < ENTITIES; i ++) {
+        handles[i] = ecs_set(world, 0, Position, {0});
+        ecs_add_id(world, handles[i], ecs_new_id(world));
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position"
+    });
+    test_assert(r != NULL);
+
+    ecs_set_threads(world, 4);
+
+    ecs_rule_par_each(world, r, RuleParEachAddTag, &Foo);
+    test_assert(!ecs_stage_is_readonly(world));
+
+    for (i = 0; i < ENTITIES; i ++) {
+        test_assert(ecs_has(world, handles[i], Foo));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+static void AddToNotCreated(ecs_iter_t *it) {
+    ecs_entity_t e = *(ecs_entity_t*)it->ctx;
+    ecs_enable_id(it->world, e, ecs_id(Velocity), true);
+}
+
+void MultiThread_add_to_not_created_from_worker(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    /* Id that is outside of the ranges reserved by stages */
+    ecs_entity_t not_created = ecs_new_id(world) + 100000;
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) }}),
+        .query.filter.terms = {{ ecs_id(Position) }},
+        .callback = AddToNotCreated,
+        .multi_threaded = true,
+        .ctx = &not_created
+    });
+
+    int i;
+    for (i = 0; i < 4; i ++) {
+        ecs_new(world, Position);
+    }
+
+    ecs_set_threads(world, 4);
+    ecs_progress(world, 0);
+
+    /* Command for id that was never created is discarded */
+    test_assert(!ecs_exists(world, not_created));
+    test_int(ecs_count(world, Velocity), 0);
+
+    ecs_fini(world);
+}
+
+static void SpawnThenAddToNotCreated(ecs_iter_t *it) {
+    ecs_entity_t e = *(ecs_entity_t*)it->ctx;
+    ecs_new(it->world, Velocity);
+
+    /* Id is not in the range that was reserved by the stage */
+    ecs_enable_id(it->world, e, ecs_id(Velocity), true);
+}
+
+void MultiThread_add_to_not_created_after_new_from_worker(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_entity_t not_created = ecs_new_id(world) + 100000;
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) }}),
+        .query.filter.terms = {{ ecs_id(Position) }},
+        .callback = SpawnThenAddToNotCreated,
+        .multi_threaded = true,
+        .ctx = &not_created
+    });
+
+    int i;
+    for (i = 0; i < 4; i ++) {
+        ecs_new(world, Position);
+    }
+
+    ecs_set_threads(world, 4);
+    ecs_progress(world, 0);
+
+    /* Entities created by the workers are published, the other id isn't */
+    test_int(ecs_count(world, Velocity), 4);
+    test_assert(!ecs_exists(world, not_created));
+
+    ecs_fini(world);
+}
+
+static void SetFromMass(ecs_iter_t *it) {
+    Mass *m = ecs_field(it, Mass, 1);
+    int i;
+    for (i = 0; i < it->count; i ++) {
+        ecs_set(it->world, it->entities[i], Position, {m[i], 1});
+        ecs_set(it->world, it->entities[i], Velocity, {1, m[i]});
+    }
+}
+
+void MultiThread_merge_set_from_workers(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) }}),
+        .query.filter.terms = {{ ecs_id(Mass) }},
+        .callback = SetFromMass,
+        .multi_threaded = true
+    });
+
+    int i, count = 8192;
+    ecs_entity_t *ents = ecs_os_malloc_n(ecs_entity_t, count);
+    for (i = 0; i < count; i ++) {
+        ents[i] = ecs_set(world, 0, Mass, {i});
+    }
+
+    ecs_set_threads(world, 4);
+    ecs_progress(world, 0);
+
+    for (i = 0; i < count; i ++) {
+        const Position *p = ecs_get(world, ents[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+        test_int(p->y, 1);
+        const Velocity *v = ecs_get(world, ents[i], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, 1);
+        test_int(v->y, i);
+    }
+
+    test_assert(ecs_get_world_info(world)->cmd.parallel_set_count != 0);
+
+    ecs_os_free(ents);
+    ecs_fini(world);
+}
+
+void MultiThread_merge_set_in_stage_order(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    int i, s, count = 4096;
+    ecs_entity_t *ents = ecs_os_malloc_n(ecs_entity_t, count);
+    for (i = 0; i < count; i ++) {
+        ents[i] = ecs_new_id(world);
+    }
+
+    ecs_set_threads(world, 4);
+
+    ecs_readonly_begin(world);
+    for (s = 0; s < 4; s ++) {
+        ecs_world_t *stage = ecs_get_stage(world, s);
+        for (i = 0; i < count; i ++) {
+            /* Every stage writes every entity */
+            ecs_set(stage, ents[i], Position, {s, i});
+            ecs_set(stage, ents[i], Velocity, {i, s});
+        }
+    }
+    ecs_readonly_end(world);
+
+    /* Last stage is merged last */
+    for (i = 0; i < count; i ++) {
+        const Position *p = ecs_get(world, ents[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 3);
+        test_int(p->y, i);
+        const Velocity *v = ecs_get(world, ents[i], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, i);
+        test_int(v->y, 3);
+    }
+
+    test_assert(ecs_get_world_info(world)->cmd.parallel_set_count != 0);
+
+    ecs_os_free(ents);
+    ecs_fini(world);
+}
+
+void MultiThread_merge_set_w_structural_changes(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TAG_DEFINE(world, Tag);
+
+    int i, count = 4096;
+    ecs_entity_t *ents = ecs_os_malloc_n(ecs_entity_t, count);
+    for (i = 0; i < count; i ++) {
+        ents[i] = ecs_new_id(world);
+    }
+
+    ecs_set_threads(world, 4);
+
+    ecs_readonly_begin(world);
+    ecs_world_t *s0 = ecs_get_stage(world, 0);
+    ecs_world_t *s1 = ecs_get_stage(world, 1);
+    ecs_world_t *s2 = ecs_get_stage(world, 2);
+    ecs_world_t *s3 = ecs_get_stage(world, 3);
+    for (i = 0; i < count; i ++) {
+        ecs_set(s0, ents[i], Position, {1, i});
+        ecs_set(s0, ents[i], Mass, {1});
+    }
+    for (i = 0; i < count; i ++) {
+        ecs_set(s1, ents[i], Position, {2, i});
+        if (!(i % 2)) {
+            ecs_add(s1, ents[i], Tag);
+        }
+        if (!(i % 3)) {
+            ecs_remove(s1, ents[i], Mass);
+        }
+    }
+    for (i = 0; i < count; i ++) {
+        if (!(i % 7)) {
+            ecs_delete(s2, ents[i]);
+        }
+    }
+    for (i = 0; i < count; i ++) {
+        if (i % 2) {
+            /* Entity doesn't have the component yet while enqueueing */
+            ecs_set(s3, ents[i], Position, {4, i});
+        } else {
+            ecs_set(s3, ents[i], Velocity, {4, i});
+        }
+    }
+    ecs_readonly_end(world);
+
+    for (i = 0; i < count; i ++) {
+        if (!(i % 7)) {
+            test_assert(!ecs_is_alive(world, ents[i]));
+            continue;
+        }
+
+        const Position *p = ecs_get(world, ents[i], Position);
+        test_assert(p != NULL);
+        test_int(p->y, i);
+        if (i % 2) {
+            test_int(p->x, 4);
+            test_assert(!ecs_has(world, ents[i], Tag));
+            test_assert(!ecs_has(world, ents[i], Velocity));
+        } else {
+            test_int(p->x, 2);
+            test_assert(ecs_has(world, ents[i], Tag));
+            const Velocity *v = ecs_get(world, ents[i], Velocity);
+            test_assert(v != NULL);
+            test_int(v->x, 4);
+            test_int(v->y, i);
+        }
+
+        const Mass *m = ecs_get(world, ents[i], Mass);
+        if (!(i % 3)) {
+            test_assert(m == NULL);
+        } else {
+            test_assert(m != NULL);
+            test_int(*m, 1);
+        }
+    }
+
+    ecs_os_free(ents);
+    ecs_fini(world);
+}
+
+static int merge_on_set_invoked = 0;
+
+static void MergeOnSetHook(ecs_iter_t *it) {
+    Velocity *v = ecs_field(it, Velocity, 1);
+    test_int(v->x, 1);
+    merge_on_set_invoked ++;
+}
+
+void MultiThread_merge_set_w_on_set_hook(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    ecs_set_hooks(world, Velocity, {
+        .on_set = MergeOnSetHook
+    });
+
+    int i, s, count = 4096;
+    ecs_entity_t *ents = ecs_os_malloc_n(ecs_entity_t, count);
+    for (i = 0; i < count; i ++) {
+        ents[i] = ecs_new_id(world);
+    }
+
+    ecs_set_threads(world, 4);
+
+    ecs_readonly_begin(world);
+    for (s = 0; s < 4; s ++) {
+        ecs_world_t *stage = ecs_get_stage(world, s);
+        for (i = 0; i < count; i ++) {
+            ecs_set(stage, ents[i], Position, {s, i});
+            ecs_set(stage, ents[i], Velocity, {1, s});
+        }
+    }
+    ecs_readonly_end(world);
+
+    /* Writes of components with hooks are applied by the main thread */
+    test_int(merge_on_set_invoked, count * 4);
+
+    for (i = 0; i < count; i ++) {
+        const Position *p = ecs_get(world, ents[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, 3);
+        const Velocity *v = ecs_get(world, ents[i], Velocity);
+        test_assert(v != NULL);
+        test_int(v->x, 1);
+        test_int(v->y, 3);
+    }
+
+    ecs_os_free(ents);
+    ecs_fini(world);
+}
+
+static int merge_read_invoked = 0;
+
+static void MergeReadOnAdd(ecs_iter_t *it) {
+    ecs_entity_t *e = it->ctx;
+    const Position *p = ecs_get(it->world, *e, Position);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    merge_read_invoked ++;
+}
+
+void MultiThread_merge_set_read_by_observer(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT(world, Mass);
+    ECS_TAG_DEFINE(world, Tag);
+
+    ecs_entity_t e1 = ecs_new_id(world);
+    ecs_entity_t e2 = ecs_new_id(world);
+
+    ecs_observer(world, {
+        .filter.terms = {{ Tag }},
+        .events = { EcsOnAdd },
+        .callback = MergeReadOnAdd,
+        .ctx = &e1
+    });
+
+    ecs_set_threads(world, 2);
+
+    ecs_readonly_begin(world);
+    ecs_world_t *s1 = ecs_get_stage(world, 1);
+    ecs_set(s1, e1, Position, {10, 20});
+    ecs_set(s1, e1, Mass, {1});
+
+    /* Observer reads value written by previous command */
+    ecs_add(s1, e2, Tag);
+    ecs_readonly_end(world);
+
+    test_int(merge_read_invoked, 1);
+    test_int(ecs_count(world, Tag), 1);
+
+    ecs_fini(world);
+}
+
+static
+void SetFromStages(
+    ecs_world_t *world,
+    ecs_entity_t *entities,
+    int32_t count)
+{
+    ecs_set_threads(world, 4);
+
+    ecs_readonly_begin(world);
+    int32_t i, s, stage_count = ecs_get_stage_count(world);
+    for (s = 0; s < stage_count; s ++) {
+        ecs_world_t *stage = ecs_get_stage(world, s);
+        for (i = 0; i < count; i ++) {
+            ecs_set(stage, entities[i], Position, {i, s});
+        }
+    }
+    ecs_readonly_end(world);
+
+    ecs_set_threads(world, 2);
+}
+
+void MultiThread_set_threads_releases_stage_memory(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+
+    int32_t i, count = 10000;
+    ecs_entity_t *entities = ecs_os_malloc_n(ecs_entity_t, count);
+    for (i = 0; i < count; i ++) {
+        entities[i] = ecs_set(world, 0, Position, {0, 0});
+    }
+
+    SetFromStages(world, entities, 10);
+    SetFromStages(world, entities, 10);
+    int64_t outstanding = ecs_block_allocator_alloc_count - 
+        ecs_block_allocator_free_count;
+
+    /* Blocks used by finalized stages are released by ecs_set_threads */
+    SetFromStages(world, entities, count);
+    test_assert((ecs_block_allocator_alloc_count - 
+        ecs_block_allocator_free_count) <= outstanding);
+
+    for (i = 0; i < count; i ++) {
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_assert(p != NULL);
+        test_int(p->x, i);
+    }
+
+    ecs_os_free(entities);
+    ecs_fini(world);
+}
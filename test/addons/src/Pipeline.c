@@ -3206,3 +3206,181 @@ void Pipeline_pipeline_init_no_system_term(void) {
         .query.filter.terms = {{ ecs_id(Position) }}
     });
 }
+
+static int32_t sys_stage[3];
+static int32_t sys_order[3];
+static int32_t sys_order_count;
+
+static void SysStage(ecs_iter_t *it) {
+    int32_t *index = it->ctx;
+    sys_stage[*index] = ecs_get_stage_id(it->world);
+    sys_order[*index] = ecs_os_ainc(&sys_order_count);
+}
+
+void Pipeline_parallel_systems_no_conflict(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity(world, { .add = { ecs_id(Position), ecs_id(Velocity) } });
+
+    static int32_t index[] = {0, 1};
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {{ ecs_id(Position), .inout = EcsInOut }},
+        .callback = SysStage,
+        .ctx = &index[0]
+    });
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {{ ecs_id(Velocity), .inout = EcsInOut }},
+        .callback = SysStage,
+        .ctx = &index[1]
+    });
+
+    ecs_set_threads(world, 2);
+    ecs_set_parallel_systems(world, true);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+    sys_order_count = 0;
+    int64_t ran = info->systems_ran_frame;
+    ecs_progress(world, 1);
+
+    test_int(info->systems_ran_frame - ran, 2);
+    test_int(sys_order_count, 2);
+    test_int(sys_stage[0], 0);
+    test_int(sys_stage[1], 1);
+
+    ecs_set_parallel_systems(world, false);
+
+    sys_order_count = 0;
+    ran = info->systems_ran_frame;
+    ecs_progress(world, 1);
+
+    test_int(info->systems_ran_frame - ran, 2);
+    test_int(sys_order_count, 2);
+    test_int(sys_stage[0], 0);
+    test_int(sys_stage[1], 0);
+    test_int(sys_order[0], 1);
+    test_int(sys_order[1], 2);
+
+    ecs_fini(world);
+}
+
+void Pipeline_parallel_systems_conflict(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity(world, { .add = { ecs_id(Position), ecs_id(Velocity) } });
+
+    static int32_t index[] = {0, 1, 2};
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {{ ecs_id(Position), .inout = EcsOut }},
+        .callback = SysStage,
+        .ctx = &index[0]
+    });
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {
+            { ecs_id(Velocity), .inout = EcsOut },
+            { ecs_id(Position), .inout = EcsIn }
+        },
+        .callback = SysStage,
+        .ctx = &index[1]
+    });
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {{ ecs_id(Position), .inout = EcsIn }},
+        .callback = SysStage,
+        .ctx = &index[2]
+    });
+
+    ecs_set_threads(world, 2);
+    ecs_set_parallel_systems(world, true);
+
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+    sys_order_count = 0;
+    int64_t merge_count = info->merge_count_total;
+    int64_t ran = info->systems_ran_frame;
+    ecs_progress(world, 1);
+
+    test_int(info->systems_ran_frame - ran, 3);
+    test_int(sys_order_count, 3);
+
+    /* Second system reads Position, so it runs after the first system */
+    test_int(sys_stage[0], 0);
+    test_int(sys_order[0], 1);
+    test_assert(sys_order[1] > sys_order[0]);
+    test_assert(sys_order[2] > sys_order[0]);
+
+    /* Second and third system only share a read, so they run in parallel */
+    test_int(sys_stage[1], 0);
+    test_int(sys_stage[2], 1);
+
+    /* Sync point between systems doesn't merge */
+    test_int(info->merge_count_total - merge_count, 1);
+
+    ecs_fini(world);
+}
+
+static void SysSetVelocity(ecs_iter_t *it) {
+    ecs_entity_t *e = it->ctx;
+    ecs_set(it->world, *e, Velocity, {10, 20});
+}
+
+static void SysGetVelocity(ecs_iter_t *it) {
+    ecs_entity_t *e = it->ctx;
+    const Velocity *v = ecs_get(it->world, *e, Velocity);
+    test_assert(v != NULL);
+    test_int(v->x, 10);
+    test_int(v->y, 20);
+    sys_b_invoked ++;
+}
+
+void Pipeline_parallel_systems_merge(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT_DEFINE(world, Position);
+    ECS_COMPONENT_DEFINE(world, Velocity);
+
+    static ecs_entity_t e;
+    e = ecs_new(world, Position);
+
+    static int32_t index[] = {0};
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {{ ecs_id(Velocity), .inout = EcsOut, .src.flags = EcsIsEntity }},
+        .callback = SysSetVelocity,
+        .ctx = &e
+    });
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {{ ecs_id(Position), .inout = EcsInOut }},
+        .callback = SysStage,
+        .ctx = &index[0]
+    });
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) } }),
+        .query.filter.terms = {{ ecs_id(Velocity), .inout = EcsIn, .src.flags = EcsIsEntity }},
+        .callback = SysGetVelocity,
+        .ctx = &e
+    });
+
+    ecs_set_threads(world, 2);
+    ecs_set_parallel_systems(world, true);
+
+    sys_b_invoked = 0;
+    sys_order_count = 0;
+    ecs_progress(world, 1);
+
+    test_int(sys_order_count, 1);
+    test_int(sys_stage[0], 1);
+    test_int(sys_b_invoked, 1);
+    test_assert(ecs_has(world, e, Velocity));
+
+    ecs_fini(world);
+}
@@ -4004,3 +4004,475 @@ void RulesBasic_this_var_w_empty_entity(void) {
 
     ecs_fini(world);
 }
+
+void RulesBasic_plan_most_selective_first(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Common);
+    ECS_TAG(world, Rare);
+
+    ecs_entity_t rare = 0;
+    for (int i = 0; i < 100; i ++) {
+        ecs_entity_t e = ecs_new(world, Common);
+        if (i == 50) {
+            ecs_add(world, e, Rare);
+            rare = e;
+        }
+    }
+
+    ecs_rule_t *r = ecs_rule(world, { .expr = "Common, Rare" });
+    test_assert(r != NULL);
+
+    char *str = ecs_rule_str(r);
+    test_assert(str != NULL);
+    char *common = strstr(str, "Common");
+    char *rare_str = strstr(str, "Rare");
+    test_assert(common != NULL);
+    test_assert(rare_str != NULL);
+    test_assert(rare_str < common);
+    test_assert(strstr(str, "~1") != NULL);
+    ecs_os_free(str);
+
+    /* Field order is not affected by plan */
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    test_bool(true, ecs_rule_next(&it));
+    test_int(1, it.count);
+    test_uint(rare, it.entities[0]);
+    test_uint(Common, ecs_field_id(&it, 1));
+    test_uint(Rare, ecs_field_id(&it, 2));
+    test_bool(false, ecs_rule_next(&it));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_plan_equal_estimates_keep_order(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_entity_t e = ecs_new(world, TagA);
+    ecs_add(world, e, TagB);
+
+    ecs_rule_t *r = ecs_rule(world, { .expr = "TagB, TagA" });
+    test_assert(r != NULL);
+
+    char *str = ecs_rule_str(r);
+    test_assert(str != NULL);
+    test_assert(strstr(str, "TagB") < strstr(str, "TagA"));
+    ecs_os_free(str);
+
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    test_bool(true, ecs_rule_next(&it));
+    test_int(1, it.count);
+    test_uint(e, it.entities[0]);
+    test_uint(TagB, ecs_field_id(&it, 1));
+    test_uint(TagA, ecs_field_id(&it, 2));
+    test_bool(false, ecs_rule_next(&it));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_plan_w_var_join(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Likes);
+    ECS_TAG(world, Rare);
+
+    ecs_entity_t rare = 0, rare_tgt = 0;
+    for (int i = 0; i < 20; i ++) {
+        ecs_entity_t e = ecs_new_id(world);
+        ecs_entity_t t = ecs_new_id(world);
+        ecs_add_pair(world, e, Likes, t);
+        if (i == 10) {
+            ecs_add(world, e, Rare);
+            rare = e;
+            rare_tgt = t;
+        }
+    }
+
+    ecs_rule_t *r = ecs_rule(world, { .expr = "Likes($x, $y), Rare($x)" });
+    test_assert(r != NULL);
+
+    int x_var = ecs_rule_find_var(r, "x");
+    test_assert(x_var != -1);
+    int y_var = ecs_rule_find_var(r, "y");
+    test_assert(y_var != -1);
+
+    char *str = ecs_rule_str(r);
+    test_assert(str != NULL);
+    test_assert(strstr(str, "Rare") < strstr(str, "Likes"));
+    ecs_os_free(str);
+
+    int32_t count = 0;
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    while (ecs_rule_next(&it)) {
+        test_uint(ecs_pair(Likes, rare_tgt), ecs_field_id(&it, 1));
+        test_uint(Rare, ecs_field_id(&it, 2));
+        test_uint(rare, ecs_field_src(&it, 1));
+        test_uint(rare, ecs_field_src(&it, 2));
+        test_uint(rare, ecs_iter_get_var(&it, x_var));
+        test_uint(rare_tgt, ecs_iter_get_var(&it, y_var));
+        count ++;
+    }
+    test_int(count, 1);
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_plan_not_keeps_position(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Common);
+    ECS_TAG(world, Rare);
+    ECS_TAG(world, Excluded);
+
+    ecs_entity_t e1 = 0;
+    for (int i = 0; i < 50; i ++) {
+        ecs_entity_t e = ecs_new(world, Common);
+        if (i == 10) {
+            ecs_add(world, e, Rare);
+            e1 = e;
+        }
+        if (i == 20) {
+            ecs_add(world, e, Rare);
+            ecs_add(world, e, Excluded);
+        }
+    }
+
+    ecs_rule_t *r = ecs_rule(world, { .expr = "Common, !Excluded, Rare" });
+    test_assert(r != NULL);
+
+    char *str = ecs_rule_str(r);
+    test_assert(str != NULL);
+    test_assert(strstr(str, "Common") < strstr(str, "Excluded"));
+    test_assert(strstr(str, "Excluded") < strstr(str, "Rare"));
+    ecs_os_free(str);
+
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    test_bool(true, ecs_rule_next(&it));
+    test_int(1, it.count);
+    test_uint(e1, it.entities[0]);
+    test_bool(false, ecs_rule_next(&it));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+/* Entities i and j match each other's Likes and Owns targets if i % 6 equals 
+ * j % 6, so each entity has 5 matches including itself. */
+static
+void RulesBasic_join_populate(
+    ecs_world_t *world,
+    ecs_entity_t Likes,
+    ecs_entity_t Owns,
+    ecs_entity_t *ents,
+    int32_t count)
+{
+    ecs_entity_t tgts[3], items[2];
+    for (int i = 0; i < 3; i ++) {
+        tgts[i] = ecs_new_id(world);
+    }
+    for (int i = 0; i < 2; i ++) {
+        items[i] = ecs_new_id(world);
+    }
+
+    for (int i = 0; i < count; i ++) {
+        ents[i] = ecs_new_id(world);
+        ecs_add_pair(world, ents[i], Likes, tgts[i % 3]);
+        ecs_add_pair(world, ents[i], Owns, items[i % 2]);
+    }
+}
+
+void RulesBasic_join_same_src_terms(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Likes);
+    ECS_TAG(world, Owns);
+
+    ecs_entity_t ents[30];
+    RulesBasic_join_populate(world, Likes, Owns, ents, 30);
+
+    ecs_rule_t *r = ecs_rule(world, { 
+        .expr = "Likes($this, $x), Owns($this, $y), Likes($z, $x), Owns($z, $y)"
+    });
+    test_assert(r != NULL);
+
+    char *str = ecs_rule_str(r);
+    test_assert(str != NULL);
+    test_assert(strstr(str, "join") != NULL);
+    ecs_os_free(str);
+
+    int32_t x_var = ecs_rule_find_var(r, "x");
+    int32_t y_var = ecs_rule_find_var(r, "y");
+    int32_t z_var = ecs_rule_find_var(r, "z");
+    test_assert(x_var != -1);
+    test_assert(y_var != -1);
+    test_assert(z_var != -1);
+
+    int32_t count = 0;
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    while (ecs_rule_next(&it)) {
+        ecs_entity_t x = ecs_iter_get_var(&it, x_var);
+        ecs_entity_t y = ecs_iter_get_var(&it, y_var);
+        ecs_entity_t z = ecs_iter_get_var(&it, z_var);
+        test_uint(ecs_pair(Likes, x), ecs_field_id(&it, 1));
+        test_uint(ecs_pair(Owns, y), ecs_field_id(&it, 2));
+        test_uint(ecs_pair(Likes, x), ecs_field_id(&it, 3));
+        test_uint(ecs_pair(Owns, y), ecs_field_id(&it, 4));
+        test_uint(z, ecs_field_src(&it, 3));
+        test_uint(z, ecs_field_src(&it, 4));
+        test_assert(ecs_has_pair(world, z, Likes, x));
+        test_assert(ecs_has_pair(world, z, Owns, y));
+        for (int i = 0; i < it.count; i ++) {
+            test_assert(ecs_has_pair(world, it.entities[i], Likes, x));
+            test_assert(ecs_has_pair(world, it.entities[i], Owns, y));
+        }
+        count += it.count;
+    }
+    test_int(count, 30 * 5);
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_join_w_constrained_var(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Likes);
+    ECS_TAG(world, Owns);
+
+    ecs_entity_t ents[30];
+    RulesBasic_join_populate(world, Likes, Owns, ents, 30);
+
+    ecs_rule_t *r = ecs_rule(world, { 
+        .expr = "Likes($this, $x), Owns($this, $y), Likes($z, $x), Owns($z, $y)"
+    });
+    test_assert(r != NULL);
+
+    char *str = ecs_rule_str(r);
+    test_assert(str != NULL);
+    test_assert(strstr(str, "join") != NULL);
+    ecs_os_free(str);
+
+    int32_t z_var = ecs_rule_find_var(r, "z");
+    test_assert(z_var != -1);
+
+    int32_t count = 0;
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    ecs_iter_set_var(&it, z_var, ents[7]);
+    while (ecs_rule_next(&it)) {
+        test_uint(ents[7], ecs_iter_get_var(&it, z_var));
+        test_uint(ents[7], ecs_field_src(&it, 3));
+        test_uint(ents[7], ecs_field_src(&it, 4));
+        for (int i = 0; i < it.count; i ++) {
+            int32_t j;
+            for (j = 0; j < 30; j ++) {
+                if (ents[j] == it.entities[i]) {
+                    break;
+                }
+            }
+            test_assert(j < 30);
+            test_int(j % 6, 7 % 6);
+        }
+        count += it.count;
+    }
+    test_int(count, 5);
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_join_no_match(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Likes);
+    ECS_TAG(world, Owns);
+    ECS_TAG(world, Wants);
+    ECS_TAG(world, Has);
+
+    ecs_entity_t ents[30];
+    RulesBasic_join_populate(world, Likes, Owns, ents, 30);
+
+    /* Entities want the same targets, but have an item nobody owns */
+    ecs_entity_t item = ecs_new_id(world);
+    for (int i = 0; i < 30; i ++) {
+        ecs_entity_t e = ecs_new_id(world);
+        ecs_add_pair(world, e, Wants, ecs_get_target(world, ents[i], Likes, 0));
+        ecs_add_pair(world, e, Has, item);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, { 
+        .expr = "Likes($this, $x), Owns($this, $y), Wants($z, $x), Has($z, $y)"
+    });
+    test_assert(r != NULL);
+
+    char *str = ecs_rule_str(r);
+    test_assert(str != NULL);
+    test_assert(strstr(str, "join") != NULL);
+    ecs_os_free(str);
+
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    test_bool(false, ecs_rule_next(&it));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_iter_partition(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    int i, ENTITIES = 20;
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_entity_t e = ecs_set(world, 0, Position, {0});
+        ecs_add_id(world, e, ecs_new_id(world));
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position"
+    });
+    test_assert(r != NULL);
+
+    int32_t claimed = 0;
+    ecs_iter_t it_1 = ecs_rule_iter(world, r);
+    ecs_iter_t it_2 = ecs_rule_iter(world, r);
+    ecs_rule_iter_set_partition(&it_1, &claimed);
+    ecs_rule_iter_set_partition(&it_2, &claimed);
+
+    /* Alternate between iterators, each table is returned once */
+    int32_t count_1 = 0, count_2 = 0;
+    bool more_1 = true, more_2 = true;
+    while (more_1 || more_2) {
+        if (more_1 && (more_1 = ecs_rule_next(&it_1))) {
+            Position *p = ecs_field(&it_1, Position, 1);
+            for (i = 0; i < it_1.count; i ++) {
+                p[i].x ++;
+            }
+            count_1 += it_1.count;
+        }
+        if (more_2 && (more_2 = ecs_rule_next(&it_2))) {
+            Position *p = ecs_field(&it_2, Position, 1);
+            for (i = 0; i < it_2.count; i ++) {
+                p[i].x ++;
+            }
+            count_2 += it_2.count;
+        }
+    }
+
+    test_int(count_1 + count_2, ENTITIES);
+    test_int(count_1, ENTITIES / 2);
+    test_int(count_2, ENTITIES / 2);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        while (ecs_rule_next(&it)) {
+            Position *p = ecs_field(&it, Position, 1);
+            for (i = 0; i < it.count; i ++) {
+                test_int(p[i].x, 1);
+            }
+        }
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_iter_partition_w_var(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, Tag);
+
+    int i, TARGETS = 8, ENTITIES = 32;
+    ecs_entity_t targets[8];
+    for (i = 0; i < TARGETS; i ++) {
+        targets[i] = ecs_new_id(world);
+        if (i % 2) {
+            ecs_add(world, targets[i], Tag);
+        }
+    }
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_new_w_pair(world, Rel, targets[i % TARGETS]);
+    }
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Rel($this, $x), Tag($x)"
+    });
+    test_assert(r != NULL);
+
+    int32_t claimed = 0;
+    ecs_iter_t it_1 = ecs_rule_iter(world, r);
+    ecs_iter_t it_2 = ecs_rule_iter(world, r);
+    ecs_iter_t it_3 = ecs_rule_iter(world, r);
+    ecs_rule_iter_set_partition(&it_1, &claimed);
+    ecs_rule_iter_set_partition(&it_2, &claimed);
+    ecs_rule_iter_set_partition(&it_3, &claimed);
+
+    int32_t count = 0;
+    while (ecs_rule_next(&it_2)) {
+        count += it_2.count;
+    }
+    while (ecs_rule_next(&it_1)) {
+        count += it_1.count;
+    }
+    while (ecs_rule_next(&it_3)) {
+        count += it_3.count;
+    }
+
+    test_int(count, ENTITIES / 2);
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesBasic_iter_partition_fixed_src(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Rel);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e = ecs_new_entity(world, "e");
+    ecs_entity_t t1 = ecs_new_id(world);
+    ecs_entity_t t2 = ecs_new_id(world);
+    ecs_add_pair(world, e, Rel, t1);
+    ecs_add_pair(world, e, Rel, t2);
+
+    /* Rule doesn't start by selecting tables, so it can't be split up */
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Rel(e, $x)"
+    });
+    test_assert(r != NULL);
+
+    int32_t claimed = 0;
+    ecs_iter_t it_1 = ecs_rule_iter(world, r);
+    ecs_iter_t it_2 = ecs_rule_iter(world, r);
+    ecs_rule_iter_set_partition(&it_1, &claimed);
+    ecs_rule_iter_set_partition(&it_2, &claimed);
+
+    test_bool(true, ecs_rule_next(&it_2));
+    test_uint(e, ecs_field_src(&it_2, 1));
+    test_uint(ecs_pair(Rel, t1), ecs_field_id(&it_2, 1));
+    test_bool(true, ecs_rule_next(&it_2));
+    test_uint(ecs_pair(Rel, t2), ecs_field_id(&it_2, 1));
+    test_bool(false, ecs_rule_next(&it_2));
+
+    test_bool(false, ecs_rule_next(&it_1));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
@@ -0,0 +1,627 @@
+#include <addons.h>
+
+void RulesCached_this_tables(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        Position *p = ecs_field(&it, Position, 1);
+        test_int(p[0].x, 10);
+        test_int(p[0].y, 20);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    /* Entity added to matched table */
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(2, it.count);
+        test_uint(e1, it.entities[0]);
+        test_uint(e2, it.entities[1]);
+        Position *p = ecs_field(&it, Position, 1);
+        test_int(p[0].x, 10);
+        test_int(p[1].x, 30);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    /* Entity added to new table */
+    ecs_entity_t e3 = ecs_set(world, 0, Position, {50, 60});
+    ecs_add(world, e3, TagA);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(2, it.count);
+        test_uint(e1, it.entities[0]);
+        test_uint(e2, it.entities[1]);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e3, it.entities[0]);
+        Position *p = ecs_field(&it, Position, 1);
+        test_int(p[0].x, 50);
+        test_int(p[0].y, 60);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_empty_table(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_entity_t e1 = ecs_new(world, TagA);
+    ecs_entity_t e2 = ecs_new(world, TagA);
+    ecs_add(world, e2, TagB);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "TagA",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    ecs_delete(world, e2);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_entity_t e3 = ecs_new(world, TagA);
+    ecs_add(world, e3, TagB);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e3, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_table_filled_after_create(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "TagA, !TagB",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_entity_t e1 = ecs_new(world, TagA);
+    ecs_entity_t e2 = ecs_new(world, TagA);
+    ecs_add(world, e2, TagB);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    /* Table is empty, then filled again */
+    ecs_remove(world, e1, TagA);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_add(world, e1, TagA);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_this_w_var(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Likes);
+    ECS_TAG(world, Apples);
+    ECS_TAG(world, Pears);
+
+    ecs_entity_t e1 = ecs_new_w_pair(world, Likes, Apples);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Likes($this, $x)",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    int x_var = ecs_rule_find_var(r, "x");
+    test_assert(x_var != -1);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_uint(ecs_pair(Likes, Apples), ecs_field_id(&it, 1));
+        test_uint(Apples, ecs_iter_get_var(&it, x_var));
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_entity_t e2 = ecs_new_w_pair(world, Likes, Pears);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_uint(ecs_pair(Likes, Apples), ecs_field_id(&it, 1));
+        test_uint(Apples, ecs_iter_get_var(&it, x_var));
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e2, it.entities[0]);
+        test_uint(ecs_pair(Likes, Pears), ecs_field_id(&it, 1));
+        test_uint(Pears, ecs_iter_get_var(&it, x_var));
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_entity_var_changed(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Unit);
+    ECS_TAG(world, Faction);
+    ECS_TAG(world, AlliedWith);
+    ECS_TAG(world, Player);
+
+    ecs_entity_t f1 = ecs_new_id(world);
+    ecs_entity_t f2 = ecs_new_id(world);
+    ecs_add_pair(world, f1, AlliedWith, Player);
+
+    ecs_entity_t u1 = ecs_new(world, Unit);
+    ecs_add_pair(world, u1, Faction, f1);
+    ecs_entity_t u2 = ecs_new(world, Unit);
+    ecs_add_pair(world, u2, Faction, f2);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Unit, Faction($this, $f), AlliedWith($f, Player)",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    int f_var = ecs_rule_find_var(r, "f");
+    test_assert(f_var != -1);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(u1, it.entities[0]);
+        test_uint(f1, ecs_iter_get_var(&it, f_var));
+        test_uint(f1, ecs_field_src(&it, 3));
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    /* Change alliance of factions without changing the unit tables */
+    ecs_remove_pair(world, f1, AlliedWith, Player);
+    ecs_add_pair(world, f2, AlliedWith, Player);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(u2, it.entities[0]);
+        test_uint(f2, ecs_iter_get_var(&it, f_var));
+        test_uint(f2, ecs_field_src(&it, 3));
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_transitive(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+    ECS_TAG(world, Earth);
+    ECS_TAG(world, Europe);
+    ECS_TAG(world, Amsterdam);
+
+    ecs_add_pair(world, Europe, LocatedIn, Earth);
+
+    ecs_entity_t e1 = ecs_new_w_pair(world, LocatedIn, Amsterdam);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, Earth)",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(Europe, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    /* Adding a link to the relationship graph doesn't create a table that
+     * matches the rule */
+    ecs_add_pair(world, Amsterdam, LocatedIn, Europe);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        bool e1_found = false, amsterdam_found = false, europe_found = false;
+        while (ecs_rule_next(&it)) {
+            for (int i = 0; i < it.count; i ++) {
+                e1_found |= it.entities[i] == e1;
+                amsterdam_found |= it.entities[i] == Amsterdam;
+                europe_found |= it.entities[i] == Europe;
+            }
+        }
+        test_bool(true, e1_found);
+        test_bool(true, amsterdam_found);
+        test_bool(true, europe_found);
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_constrained_var(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, Likes);
+    ECS_TAG(world, Apples);
+    ECS_TAG(world, Pears);
+
+    ecs_new_w_pair(world, Likes, Apples);
+    ecs_entity_t e2 = ecs_new_w_pair(world, Likes, Pears);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Likes($this, $x)",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    int x_var = ecs_rule_find_var(r, "x");
+    test_assert(x_var != -1);
+
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    ecs_iter_set_var(&it, x_var, Pears);
+    test_bool(true, ecs_rule_next(&it));
+    test_int(1, it.count);
+    test_uint(e2, it.entities[0]);
+    test_uint(ecs_pair(Likes, Pears), ecs_field_id(&it, 1));
+    test_uint(Pears, ecs_iter_get_var(&it, x_var));
+    test_bool(false, ecs_rule_next(&it));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_readonly(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_entity_t e1 = ecs_new(world, TagA);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "TagA",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    ecs_entity_t e2 = ecs_new(world, TagA);
+    ecs_add(world, e2, TagB);
+
+    /* Cache can't be updated in readonly mode, rule is evaluated instead */
+    ecs_readonly_begin(world);
+    {
+        ecs_world_t *stage = ecs_get_stage(world, 0);
+        ecs_iter_t it = ecs_rule_iter(stage, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e2, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+    ecs_readonly_end(world);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e2, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_delete_empty_tables(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_entity_t e1 = ecs_new(world, TagA);
+    ecs_entity_t e2 = ecs_new(world, TagA);
+    ecs_add(world, e2, TagB);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "TagA",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    ecs_remove(world, e2, TagA);
+    ecs_run_aperiodic(world, 0);
+    test_int(0, ecs_delete_empty_tables(world, 0, 0, 1, 0, 0));
+    test_assert(ecs_delete_empty_tables(world, 0, 0, 1, 0, 0) != 0);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_rule_w_entity(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_new(world, TagA);
+    ecs_entity_t re = ecs_new_entity(world, "r");
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .entity = re,
+        .expr = "TagA",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(e1, it.entities[0]);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_delete(world, re);
+
+    /* Observers of deleted rule no longer run */
+    ecs_entity_t e2 = ecs_new(world, TagA);
+    ecs_add_id(world, e2, ecs_new_id(world));
+    ecs_run_aperiodic(world, 0);
+
+    ecs_fini(world);
+}
+
+void RulesCached_fini_in_deferred(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "TagA",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    ecs_defer_begin(world);
+    ecs_rule_fini(r);
+    ecs_entity_t e1 = ecs_new(world, TagA);
+    ecs_add(world, e1, TagB);
+    ecs_defer_end(world);
+
+    ecs_run_aperiodic(world, 0);
+
+    ecs_fini(world);
+}
+
+void RulesCached_entity_moved(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Likes);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t t1 = ecs_new(world, Tag);
+    ecs_entity_t t2 = ecs_new(world, Tag);
+    ecs_entity_t x = ecs_new_id(world);
+    ecs_set(world, x, Velocity, {1, 2});
+    ecs_set(world, x, Position, {10, 20});
+    ecs_add_pair(world, x, Likes, t2);
+
+    /* Makes sure the table x moves to is not empty, so no events are emitted
+     * for the watched ids */
+    ecs_entity_t y = ecs_new_id(world);
+    ecs_set(world, y, Position, {30, 40});
+    ecs_add_pair(world, y, Likes, t2);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position($x), Likes($x, $this)",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    int x_var = ecs_rule_find_var(r, "x");
+    test_assert(x_var != -1);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(t2, it.entities[0]);
+        test_uint(x, ecs_iter_get_var(&it, x_var));
+        Position *p = ecs_field(&it, Position, 1);
+        test_assert(p != NULL);
+        test_int(10, p->x);
+        test_int(20, p->y);
+
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(t2, it.entities[0]);
+        test_uint(y, ecs_iter_get_var(&it, x_var));
+        p = ecs_field(&it, Position, 1);
+        test_assert(p != NULL);
+        test_int(30, p->x);
+        test_int(40, p->y);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    /* Moves t2 to the row of t1, and x to a table with a different column
+     * for Position */
+    ecs_delete(world, t1);
+    ecs_remove(world, x, Velocity);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(t2, it.entities[0]);
+        test_uint(y, ecs_iter_get_var(&it, x_var));
+        Position *p = ecs_field(&it, Position, 1);
+        test_assert(p != NULL);
+        test_int(30, p->x);
+        test_int(40, p->y);
+
+        test_bool(true, ecs_rule_next(&it));
+        test_int(1, it.count);
+        test_uint(t2, it.entities[0]);
+        test_uint(x, ecs_iter_get_var(&it, x_var));
+        p = ecs_field(&it, Position, 1);
+        test_assert(p != NULL);
+        test_int(10, p->x);
+        test_int(20, p->y);
+        test_bool(false, ecs_rule_next(&it));
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesCached_iter_partition(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "Position",
+        .flags = EcsFilterCached
+    });
+    test_assert(r != NULL);
+
+    int i, ENTITIES = 10;
+    for (i = 0; i < ENTITIES; i ++) {
+        ecs_entity_t e = ecs_set(world, 0, Position, {0});
+        ecs_add_id(world, e, ecs_new_id(world));
+    }
+
+    int32_t claimed = 0;
+    ecs_iter_t it_1 = ecs_rule_iter(world, r);
+    ecs_iter_t it_2 = ecs_rule_iter(world, r);
+    ecs_rule_iter_set_partition(&it_1, &claimed);
+    ecs_rule_iter_set_partition(&it_2, &claimed);
+
+    int32_t count_1 = 0, count_2 = 0;
+    while (ecs_rule_next(&it_1)) {
+        Position *p = ecs_field(&it_1, Position, 1);
+        p[0].x ++;
+        count_1 += it_1.count;
+
+        if (ecs_rule_next(&it_2)) {
+            p = ecs_field(&it_2, Position, 1);
+            p[0].x ++;
+            count_2 += it_2.count;
+        }
+    }
+    while (ecs_rule_next(&it_2)) {
+        count_2 += it_2.count;
+    }
+
+    test_int(count_1, ENTITIES / 2);
+    test_int(count_2, ENTITIES / 2);
+
+    {
+        ecs_iter_t it = ecs_rule_iter(world, r);
+        while (ecs_rule_next(&it)) {
+            Position *p = ecs_field(&it, Position, 1);
+            test_int(p[0].x, 1);
+        }
+    }
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
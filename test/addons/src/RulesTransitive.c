@@ -5099,3 +5099,372 @@ void RulesTransitive_any_target(void) {
 
     ecs_fini(world);
 }
+
+static
+bool rule_has_entity(
+    ecs_world_t *world,
+    ecs_rule_t *r,
+    int32_t var,
+    ecs_entity_t e)
+{
+    bool result = false;
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    while (ecs_rule_next(&it)) {
+        if (var != -1) {
+            if (ecs_iter_get_var(&it, var) == e) {
+                result = true;
+            }
+        } else {
+            int32_t i;
+            for (i = 0; i < it.count; i ++) {
+                if (it.entities[i] == e) {
+                    result = true;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static
+int32_t rule_count_results(
+    ecs_world_t *world,
+    ecs_rule_t *r)
+{
+    int32_t result = 0;
+    ecs_iter_t it = ecs_rule_iter(world, r);
+    while (ecs_rule_next(&it)) {
+        result += it.count ? it.count : 1;
+    }
+    return result;
+}
+
+void RulesTransitive_trav_cache_add_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t x = ecs_new_entity(world, "x");
+    ecs_entity_t a = ecs_new_w_pair(world, LocatedIn, x);
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, x)"
+    });
+    test_assert(r != NULL);
+
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, a));
+    test_bool(true, rule_has_entity(world, r, -1, b));
+
+    /* Creates the (LocatedIn, b) id record */
+    ecs_entity_t c = ecs_new_w_pair(world, LocatedIn, b);
+    test_int(3, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    /* Existing id record, entity moves to table of b */
+    ecs_entity_t d = ecs_new_w_pair(world, LocatedIn, c);
+    test_int(4, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, d));
+
+    /* Iterating again returns the same result */
+    test_int(4, rule_count_results(world, r));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_remove_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t x = ecs_new_entity(world, "x");
+    ecs_entity_t a = ecs_new_w_pair(world, LocatedIn, x);
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+    ecs_entity_t c = ecs_new_w_pair(world, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, x)"
+    });
+    test_assert(r != NULL);
+
+    test_int(3, rule_count_results(world, r));
+
+    ecs_remove_pair(world, b, LocatedIn, a);
+    test_int(1, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, a));
+    test_bool(false, rule_has_entity(world, r, -1, b));
+    test_bool(false, rule_has_entity(world, r, -1, c));
+
+    ecs_add_pair(world, b, LocatedIn, a);
+    test_int(3, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_delete_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t x = ecs_new_entity(world, "x");
+    ecs_entity_t a = ecs_new_w_pair(world, LocatedIn, x);
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+    ecs_entity_t c = ecs_new_w_pair(world, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, x)"
+    });
+    test_assert(r != NULL);
+
+    test_int(3, rule_count_results(world, r));
+
+    ecs_delete(world, b);
+    test_int(1, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, a));
+    test_bool(false, rule_has_entity(world, r, -1, c));
+
+    ecs_add_pair(world, c, LocatedIn, a);
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_clear_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t a = ecs_new_entity(world, "a");
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+    ecs_entity_t c = ecs_new_w_pair(world, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, a)"
+    });
+    test_assert(r != NULL);
+
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    /* Clearing b removes its pair without deleting (LocatedIn, b) */
+    ecs_clear(world, b);
+    test_int(0, rule_count_results(world, r));
+    test_bool(false, rule_has_entity(world, r, -1, b));
+    test_bool(false, rule_has_entity(world, r, -1, c));
+
+    ecs_add_pair(world, b, LocatedIn, a);
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_clear_deferred_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t a = ecs_new_entity(world, "a");
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+    ecs_entity_t c = ecs_new_w_pair(world, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, a)"
+    });
+    test_assert(r != NULL);
+
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    /* Clear is applied when the deferred commands are merged */
+    ecs_defer_begin(world);
+    ecs_clear(world, b);
+    ecs_defer_end(world);
+    test_int(0, rule_count_results(world, r));
+    test_bool(false, rule_has_entity(world, r, -1, b));
+    test_bool(false, rule_has_entity(world, r, -1, c));
+
+    ecs_add_pair(world, b, LocatedIn, a);
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_remove_all_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t a = ecs_new_entity(world, "a");
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+    ecs_entity_t c = ecs_new_w_pair(world, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, a)"
+    });
+    test_assert(r != NULL);
+
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    /* Pair is removed from b by moving the table of b */
+    ecs_remove_all(world, ecs_pair(LocatedIn, a));
+    test_int(0, rule_count_results(world, r));
+    test_bool(false, rule_has_entity(world, r, -1, b));
+    test_bool(false, rule_has_entity(world, r, -1, c));
+
+    ecs_add_pair(world, b, LocatedIn, a);
+    test_int(2, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, -1, c));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_delete_with_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t a = ecs_new_entity(world, "a");
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+    ecs_add(world, b, Tag);
+    ecs_entity_t c = ecs_new_w_pair(world, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn($this, a)"
+    });
+    test_assert(r != NULL);
+
+    test_int(2, rule_count_results(world, r));
+
+    /* Entities of table are deleted by deleting the table storage */
+    ecs_delete_with(world, Tag);
+    test_assert(!ecs_is_alive(world, b));
+    test_int(0, rule_count_results(world, r));
+    test_bool(false, rule_has_entity(world, r, -1, c));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_up_after_iter(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t x = ecs_new_id(world);
+    ecs_entity_t y = ecs_new_id(world);
+    ecs_entity_t a = ecs_new_w_pair(world, LocatedIn, x);
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, a);
+    ecs_entity_t c = ecs_new_entity(world, "c");
+    ecs_add_pair(world, c, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn(c, $x)"
+    });
+    test_assert(r != NULL);
+
+    int x_var = ecs_rule_find_var(r, "x");
+    test_assert(x_var != -1);
+
+    test_int(3, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, x_var, b));
+    test_bool(true, rule_has_entity(world, r, x_var, a));
+    test_bool(true, rule_has_entity(world, r, x_var, x));
+
+    ecs_add_pair(world, a, LocatedIn, y);
+    test_int(4, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, x_var, y));
+
+    ecs_remove_pair(world, b, LocatedIn, a);
+    test_int(1, rule_count_results(world, r));
+    test_bool(true, rule_has_entity(world, r, x_var, b));
+    test_bool(false, rule_has_entity(world, r, x_var, x));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_multiple_targets(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_ENTITY(world, LocatedIn, Transitive);
+
+    ecs_entity_t x = ecs_new_id(world);
+    ecs_entity_t y = ecs_new_id(world);
+    ecs_entity_t z = ecs_new_id(world);
+    ecs_entity_t a = ecs_new_w_pair(world, LocatedIn, x);
+    ecs_add_pair(world, a, LocatedIn, y);
+    ecs_entity_t b = ecs_new_w_pair(world, LocatedIn, z);
+    ecs_entity_t c = ecs_new_entity(world, "c");
+    ecs_add_pair(world, c, LocatedIn, a);
+    ecs_add_pair(world, c, LocatedIn, b);
+
+    ecs_rule_t *r = ecs_rule(world, {
+        .expr = "LocatedIn(c, $x)"
+    });
+    test_assert(r != NULL);
+
+    int x_var = ecs_rule_find_var(r, "x");
+    test_assert(x_var != -1);
+
+    test_bool(true, rule_has_entity(world, r, x_var, a));
+    test_bool(true, rule_has_entity(world, r, x_var, b));
+    test_bool(true, rule_has_entity(world, r, x_var, x));
+    test_bool(true, rule_has_entity(world, r, x_var, y));
+    test_bool(true, rule_has_entity(world, r, x_var, z));
+
+    ecs_rule_fini(r);
+
+    ecs_fini(world);
+}
+
+void RulesTransitive_trav_cache_two_worlds(void) {
+    ecs_world_t *world_1 = ecs_init();
+    ecs_world_t *world_2 = ecs_init();
+
+    ecs_entity_t rel_1 = ecs_new_entity(world_1, "LocatedIn");
+    ecs_add_id(world_1, rel_1, EcsTransitive);
+    ecs_entity_t rel_2 = ecs_new_entity(world_2, "LocatedIn");
+    ecs_add_id(world_2, rel_2, EcsTransitive);
+
+    ecs_entity_t x_1 = ecs_new_entity(world_1, "x");
+    ecs_entity_t a_1 = ecs_new_w_pair(world_1, rel_1, x_1);
+    ecs_new_w_pair(world_1, rel_1, a_1);
+
+    ecs_entity_t x_2 = ecs_new_entity(world_2, "x");
+    ecs_new_w_pair(world_2, rel_2, x_2);
+
+    ecs_rule_t *r_1 = ecs_rule(world_1, { .expr = "LocatedIn($this, x)" });
+    ecs_rule_t *r_2 = ecs_rule(world_2, { .expr = "LocatedIn($this, x)" });
+    test_assert(r_1 != NULL);
+    test_assert(r_2 != NULL);
+
+    test_int(2, rule_count_results(world_1, r_1));
+    test_int(1, rule_count_results(world_2, r_2));
+
+    ecs_rule_fini(r_1);
+    ecs_rule_fini(r_2);
+
+    ecs_fini(world_1);
+    ecs_fini(world_2);
+}
@@ -312,3 +312,43 @@ void Stats_get_not_alive_entity_count(void) {
 
     ecs_fini(world);
 }
+
+void Stats_get_page_bytes(void) {
+    ecs_world_t *world = ecs_init();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_world_stats_t stats = {0};
+    ecs_world_stats_get(world, &stats);
+    test_int(stats.memory.page_bytes.gauge.avg[stats.t], 0);
+    test_int(stats.memory.huge_page_advised_bytes.gauge.avg[stats.t], 0);
+
+    /* Position column is large enough to be mapped with page allocation */
+    int32_t count = FLECS_BALLOC_PAGE_ALLOC_SIZE / ECS_SIZEOF(Position);
+    ecs_bulk_new(world, Position, count);
+
+    ecs_world_stats_get(world, &stats);
+    float page_bytes = stats.memory.page_bytes.gauge.avg[stats.t];
+    float huge_page_advised_bytes = stats.memory.huge_page_advised_bytes.gauge.avg[stats.t];
+    if (ecs_os_has_page_alloc()) {
+        test_assert(page_bytes >= FLECS_BALLOC_PAGE_ALLOC_SIZE);
+    } else {
+        test_int(page_bytes, 0);
+    }
+    test_assert(huge_page_advised_bytes <= page_bytes);
+
+    ecs_delete_with(world, ecs_id(Position));
+    ecs_run_aperiodic(world, EcsAperiodicEmptyTables);
+    ecs_delete_empty_tables(world, 0, 0, 1, 0, 0); /* Increase to 1 */
+    ecs_delete_empty_tables(world, 0, 0, 1, 0, 0); /* Delete */
+
+    /* Table storage is freed, storage for entity ids isn't */
+    ecs_world_stats_get(world, &stats);
+    if (ecs_os_has_page_alloc()) {
+        test_assert(stats.memory.page_bytes.gauge.avg[stats.t] < page_bytes);
+    }
+    test_assert(stats.memory.huge_page_advised_bytes.gauge.avg[stats.t] <= 
+        stats.memory.page_bytes.gauge.avg[stats.t]);
+
+    ecs_fini(world);
+}
@@ -570,6 +570,9 @@ void Pipeline_run_pipeline_multithreaded(void);
 void Pipeline_run_pipeline_multithreaded_tasks(void);
 void Pipeline_pipeline_init_no_terms(void);
 void Pipeline_pipeline_init_no_system_term(void);
+void Pipeline_parallel_systems_no_conflict(void);
+void Pipeline_parallel_systems_conflict(void);
+void Pipeline_parallel_systems_merge(void);
 
 // Testsuite 'SystemMisc'
 void SystemMisc_invalid_not_without_id(void);
@@ -732,6 +735,16 @@ void RulesBasic_find_this_tgt_uppercase(void);
 void RulesBasic_get_filter(void);
 void RulesBasic_iter_empty_source(void);
 void RulesBasic_this_var_w_empty_entity(void);
+void RulesBasic_plan_most_selective_first(void);
+void RulesBasic_plan_equal_estimates_keep_order(void);
+void RulesBasic_plan_w_var_join(void);
+void RulesBasic_plan_not_keeps_position(void);
+void RulesBasic_join_same_src_terms(void);
+void RulesBasic_join_w_constrained_var(void);
+void RulesBasic_join_no_match(void);
+void RulesBasic_iter_partition(void);
+void RulesBasic_iter_partition_w_var(void);
+void RulesBasic_iter_partition_fixed_src(void);
 
 // Testsuite 'RulesVariables'
 void RulesVariables_1_ent_src_w_var(void);
@@ -1015,6 +1028,16 @@ void RulesTransitive_optional_transitive_var_tgt_written(void);
 void RulesTransitive_2_var_src_w_same_tgt_ent(void);
 void RulesTransitive_self_target(void);
 void RulesTransitive_any_target(void);
+void RulesTransitive_trav_cache_add_after_iter(void);
+void RulesTransitive_trav_cache_remove_after_iter(void);
+void RulesTransitive_trav_cache_delete_after_iter(void);
+void RulesTransitive_trav_cache_up_after_iter(void);
+void RulesTransitive_trav_cache_multiple_targets(void);
+void RulesTransitive_trav_cache_two_worlds(void);
+void RulesTransitive_trav_cache_clear_after_iter(void);
+void RulesTransitive_trav_cache_clear_deferred_after_iter(void);
+void RulesTransitive_trav_cache_remove_all_after_iter(void);
+void RulesTransitive_trav_cache_delete_with_after_iter(void);
 
 // Testsuite 'RulesComponentInheritance'
 void RulesComponentInheritance_1_ent_0_lvl(void);
@@ -1055,6 +1078,21 @@ void RulesRecycled_recycled_pair_vars(void);
 void RulesRecycled_recycled_this_ent_var(void);
 void RulesRecycled_has_recycled_id_from_pair(void);
 
+// Testsuite 'RulesCached'
+void RulesCached_this_tables(void);
+void RulesCached_empty_table(void);
+void RulesCached_table_filled_after_create(void);
+void RulesCached_this_w_var(void);
+void RulesCached_entity_var_changed(void);
+void RulesCached_transitive(void);
+void RulesCached_constrained_var(void);
+void RulesCached_readonly(void);
+void RulesCached_delete_empty_tables(void);
+void RulesCached_rule_w_entity(void);
+void RulesCached_fini_in_deferred(void);
+void RulesCached_entity_moved(void);
+void RulesCached_iter_partition(void);
+
 // Testsuite 'RulesBuiltinPredicates'
 void RulesBuiltinPredicates_this_eq_id(void);
 void RulesBuiltinPredicates_this_eq_name(void);
@@ -1276,6 +1314,7 @@ void Stats_get_pipeline_stats_after_progress_2_systems_one_merge(void);
 void Stats_get_entity_count(void);
 void Stats_get_pipeline_stats_w_task_system(void);
 void Stats_get_not_alive_entity_count(void);
+void Stats_get_page_bytes(void);
 
 // Testsuite 'Run'
 void Run_setup(void);
@@ -1353,6 +1392,34 @@ void MultiThread_bulk_new_in_no_readonly_w_multithread(void);
 void MultiThread_bulk_new_in_no_readonly_w_multithread_2(void);
 void MultiThread_run_first_worker_on_main(void);
 void MultiThread_run_single_thread_on_main(void);
+void MultiThread_2_thread_10_entity_w_chunks(void);
+void MultiThread_6_thread_uneven_tables_w_chunks(void);
+void MultiThread_2_thread_singleton_w_chunks(void);
+void MultiThread_4_thread_10_entity_no_futex(void);
+void MultiThread_new_from_workers(void);
+void MultiThread_new_from_workers_no_aadd(void);
+void MultiThread_new_from_workers_recycle_unused(void);
+void MultiThread_par_each_2_thread(void);
+void MultiThread_par_each_6_thread_uneven_tables(void);
+void MultiThread_par_each_no_threads(void);
+void MultiThread_par_each_w_commands(void);
+void MultiThread_par_each_after_table_create(void);
+void MultiThread_rule_par_each_2_thread(void);
+void MultiThread_rule_par_each_w_var(void);
+void MultiThread_rule_par_each_no_partition(void);
+void MultiThread_rule_par_each_cached(void);
+void MultiThread_rule_par_each_no_threads(void);
+void MultiThread_rule_par_each_w_commands(void);
+void MultiThread_add_to_not_created_from_worker(void);
+void MultiThread_add_to_not_created_after_new_from_worker(void);
+void MultiThread_merge_set_from_workers(void);
+void MultiThread_merge_set_in_stage_order(void);
+void MultiThread_merge_set_w_structural_changes(void);
+void MultiThread_merge_set_w_on_set_hook(void);
+void MultiThread_merge_set_read_by_observer(void);
+void MultiThread_set_threads_releases_stage_memory(void);
+void MultiThread_2_thread_w_chunks_shared_field(void);
+void MultiThread_par_each_w_shared_field(void);
 
 // Testsuite 'MultiThreadStaging'
 void MultiThreadStaging_setup(void);
@@ -1423,6 +1490,7 @@ void MultiTaskThread_bulk_new_in_no_readonly_w_multithread(void);
 void MultiTaskThread_bulk_new_in_no_readonly_w_multithread_2(void);
 void MultiTaskThread_run_first_worker_on_main(void);
 void MultiTaskThread_run_single_thread_on_main(void);
+void MultiTaskThread_par_each(void);
 
 // Testsuite 'MultiTaskThreadStaging'
 void MultiTaskThreadStaging_setup(void);
@@ -3819,6 +3887,18 @@ bake_test_case Pipeline_testcases[] = {
     {
         "pipeline_init_no_system_term",
         Pipeline_pipeline_init_no_system_term
+    },
+    {
+        "parallel_systems_no_conflict",
+        Pipeline_parallel_systems_no_conflict
+    },
+    {
+        "parallel_systems_conflict",
+        Pipeline_parallel_systems_conflict
+    },
+    {
+        "parallel_systems_merge",
+        Pipeline_parallel_systems_merge
     }
 };
 
@@ -4457,6 +4537,46 @@ bake_test_case RulesBasic_testcases[] = {
     {
         "this_var_w_empty_entity",
         RulesBasic_this_var_w_empty_entity
+    },
+    {
+        "plan_most_selective_first",
+        RulesBasic_plan_most_selective_first
+    },
+    {
+        "plan_equal_estimates_keep_order",
+        RulesBasic_plan_equal_estimates_keep_order
+    },
+    {
+        "plan_w_var_join",
+        RulesBasic_plan_w_var_join
+    },
+    {
+        "plan_not_keeps_position",
+        RulesBasic_plan_not_keeps_position
+    },
+    {
+        "join_same_src_terms",
+        RulesBasic_join_same_src_terms
+    },
+    {
+        "join_w_constrained_var",
+        RulesBasic_join_w_constrained_var
+    },
+    {
+        "join_no_match",
+        RulesBasic_join_no_match
+    },
+    {
+        "iter_partition",
+        RulesBasic_iter_partition
+    },
+    {
+        "iter_partition_w_var",
+        RulesBasic_iter_partition_w_var
+    },
+    {
+        "iter_partition_fixed_src",
+        RulesBasic_iter_partition_fixed_src
     }
 };
 
@@ -5574,6 +5694,46 @@ bake_test_case RulesTransitive_testcases[] = {
     {
         "any_target",
         RulesTransitive_any_target
+    },
+    {
+        "trav_cache_add_after_iter",
+        RulesTransitive_trav_cache_add_after_iter
+    },
+    {
+        "trav_cache_remove_after_iter",
+        RulesTransitive_trav_cache_remove_after_iter
+    },
+    {
+        "trav_cache_delete_after_iter",
+        RulesTransitive_trav_cache_delete_after_iter
+    },
+    {
+        "trav_cache_up_after_iter",
+        RulesTransitive_trav_cache_up_after_iter
+    },
+    {
+        "trav_cache_multiple_targets",
+        RulesTransitive_trav_cache_multiple_targets
+    },
+    {
+        "trav_cache_two_worlds",
+        RulesTransitive_trav_cache_two_worlds
+    },
+    {
+        "trav_cache_clear_after_iter",
+        RulesTransitive_trav_cache_clear_after_iter
+    },
+    {
+        "trav_cache_clear_deferred_after_iter",
+        RulesTransitive_trav_cache_clear_deferred_after_iter
+    },
+    {
+        "trav_cache_remove_all_after_iter",
+        RulesTransitive_trav_cache_remove_all_after_iter
+    },
+    {
+        "trav_cache_delete_with_after_iter",
+        RulesTransitive_trav_cache_delete_with_after_iter
     }
 };
 
@@ -5723,6 +5883,61 @@ bake_test_case RulesRecycled_testcases[] = {
     }
 };
 
+bake_test_case RulesCached_testcases[] = {
+    {
+        "this_tables",
+        RulesCached_this_tables
+    },
+    {
+        "empty_table",
+        RulesCached_empty_table
+    },
+    {
+        "table_filled_after_create",
+        RulesCached_table_filled_after_create
+    },
+    {
+        "this_w_var",
+        RulesCached_this_w_var
+    },
+    {
+        "entity_var_changed",
+        RulesCached_entity_var_changed
+    },
+    {
+        "transitive",
+        RulesCached_transitive
+    },
+    {
+        "constrained_var",
+        RulesCached_constrained_var
+    },
+    {
+        "readonly",
+        RulesCached_readonly
+    },
+    {
+        "delete_empty_tables",
+        RulesCached_delete_empty_tables
+    },
+    {
+        "rule_w_entity",
+        RulesCached_rule_w_entity
+    },
+    {
+        "fini_in_deferred",
+        RulesCached_fini_in_deferred
+    },
+    {
+        "entity_moved",
+        RulesCached_entity_moved
+    },
+    {
+        "iter_partition",
+        RulesCached_iter_partition
+    }
+};
+
 bake_test_case RulesBuiltinPredicates_testcases[] = {
     {
         "this_eq_id",
@@ -6540,6 +6755,10 @@ bake_test_case Stats_testcases[] = {
     {
         "get_not_alive_entity_count",
         Stats_get_not_alive_entity_count
+    },
+    {
+        "get_page_bytes",
+        Stats_get_page_bytes
     }
 };
 
@@ -6830,6 +7049,118 @@ bake_test_case MultiThread_testcases[] = {
     {
         "run_single_thread_on_main",
         MultiThread_run_single_thread_on_main
+    },
+    {
+        "2_thread_10_entity_w_chunks",
+        MultiThread_2_thread_10_entity_w_chunks
+    },
+    {
+        "6_thread_uneven_tables_w_chunks",
+        MultiThread_6_thread_uneven_tables_w_chunks
+    },
+    {
+        "2_thread_singleton_w_chunks",
+        MultiThread_2_thread_singleton_w_chunks
+    },
+    {
+        "4_thread_10_entity_no_futex",
+        MultiThread_4_thread_10_entity_no_futex
+    },
+    {
+        "new_from_workers",
+        MultiThread_new_from_workers
+    },
+    {
+        "new_from_workers_no_aadd",
+        MultiThread_new_from_workers_no_aadd
+    },
+    {
+        "new_from_workers_recycle_unused",
+        MultiThread_new_from_workers_recycle_unused
+    },
+    {
+        "par_each_2_thread",
+        MultiThread_par_each_2_thread
+    },
+    {
+        "par_each_6_thread_uneven_tables",
+        MultiThread_par_each_6_thread_uneven_tables
+    },
+    {
+        "par_each_no_threads",
+        MultiThread_par_each_no_threads
+    },
+    {
+        "par_each_w_commands",
+        MultiThread_par_each_w_commands
+    },
+    {
+        "par_each_after_table_create",
+        MultiThread_par_each_after_table_create
+    },
+    {
+        "rule_par_each_2_thread",
+        MultiThread_rule_par_each_2_thread
+    },
+    {
+        "rule_par_each_w_var",
+        MultiThread_rule_par_each_w_var
+    },
+    {
+        "rule_par_each_no_partition",
+        MultiThread_rule_par_each_no_partition
+    },
+    {
+        "rule_par_each_cached",
+        MultiThread_rule_par_each_cached
+    },
+    {
+        "rule_par_each_no_threads",
+        MultiThread_rule_par_each_no_threads
+    },
+    {
+        "rule_par_each_w_commands",
+        MultiThread_rule_par_each_w_commands
+    },
+    {
+        "add_to_not_created_from_worker",
+        MultiThread_add_to_not_created_from_worker
+    },
+    {
+        "add_to_not_created_after_new_from_worker",
+        MultiThread_add_to_not_created_after_new_from_worker
+    },
+    {
+        "merge_set_from_workers",
+        MultiThread_merge_set_from_workers
+    },
+    {
+        "merge_set_in_stage_order",
+        MultiThread_merge_set_in_stage_order
+    },
+    {
+        "merge_set_w_structural_changes",
+        MultiThread_merge_set_w_structural_changes
+    },
+    {
+        "merge_set_w_on_set_hook",
+        MultiThread_merge_set_w_on_set_hook
+    },
+    {
+        "merge_set_read_by_observer",
+        MultiThread_merge_set_read_by_observer
+    },
+    {
+        "set_threads_releases_stage_memory",
+        MultiThread_set_threads_releases_stage_memory
+    },
+    {
+        "2_thread_w_chunks_shared_field",
+        MultiThread_2_thread_w_chunks_shared_field
+    },
+    {
+        "par_each_w_shared_field",
+        MultiThread_par_each_w_shared_field
     }
 };
 
@@ -7092,6 +7423,10 @@ bake_test_case MultiTaskThread_testcases[] = {
     {
         "run_single_thread_on_main",
         MultiTaskThread_run_single_thread_on_main
+    },
+    {
+        "par_each",
+        MultiTaskThread_par_each
     }
 };
 
@@ -7737,7 +8072,7 @@ static bake_test_suite suites[] = {
         "Pipeline",
         NULL,
         NULL,
-        82,
+        85,
         Pipeline_testcases
     },
     {
@@ -7751,7 +8086,7 @@ static bake_test_suite suites[] = {
         "RulesBasic",
         NULL,
         NULL,
-        90,
+        100,
         RulesBasic_testcases
     },
     {
@@ -7772,7 +8107,7 @@ static bake_test_suite suites[] = {
         "RulesTransitive",
         NULL,
         NULL,
-        64,
+        74,
         RulesTransitive_testcases
     },
     {
@@ -7789,6 +8124,13 @@ static bake_test_suite suites[] = {
         4,
         RulesRecycled_testcases
     },
+    {
+        "RulesCached",
+        NULL,
+        NULL,
+        13,
+        RulesCached_testcases
+    },
     {
         "RulesBuiltinPredicates",
         NULL,
@@ -7870,7 +8212,7 @@ static bake_test_suite suites[] = {
         "Stats",
         NULL,
         NULL,
-        11,
+        12,
         Stats_testcases
     },
     {
@@ -7884,7 +8226,7 @@ static bake_test_suite suites[] = {
         "MultiThread",
         MultiThread_setup,
         NULL,
-        50,
+        78,
         MultiThread_testcases
     },
     {
@@ -7898,7 +8240,7 @@ static bake_test_suite suites[] = {
         "MultiTaskThread",
         MultiTaskThread_setup,
         NULL,
-        50,
+        51,
         MultiTaskThread_testcases
     },
     {
@@ -7960,5 +8302,5 @@ static bake_test_suite suites[] = {
 };
 
 int main(int argc, char *argv[]) {
-    return bake_test_run("addons", argc, argv, suites, 35);
+    return bake_test_run("addons", argc, argv, suites, 36);
 }
@@ -411,3 +411,275 @@ void Add_add_random_id(void) {
 
     ecs_fini(world);
 }
+
+static int add_n_invoked = 0;
+static int add_n_count = 0;
+
+static
+void add_n_observer(ecs_iter_t *it) {
+    add_n_invoked ++;
+    add_n_count += it->count;
+}
+
+void Add_add_n_tag(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_entity_t e3 = ecs_set(world, 0, Position, {50, 60});
+    ecs_entity_t e4 = ecs_set(world, 0, Velocity, {1, 2});
+
+    ecs_entity_t entities[] = {e1, e3, e4};
+    ecs_add_id_n(world, entities, 3, Tag);
+
+    test_assert(ecs_has(world, e1, Tag));
+    test_assert(!ecs_has(world, e2, Tag));
+    test_assert(ecs_has(world, e3, Tag));
+    test_assert(ecs_has(world, e4, Tag));
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+    p = ecs_get(world, e2, Position);
+    test_int(p->x, 30); test_int(p->y, 40);
+    p = ecs_get(world, e3, Position);
+    test_int(p->x, 50); test_int(p->y, 60);
+    const Velocity *v = ecs_get(world, e4, Velocity);
+    test_int(v->x, 1); test_int(v->y, 2);
+
+    test_assert(ecs_get_table(world, e1) == ecs_get_table(world, e3));
+
+    ecs_fini(world);
+}
+
+void Add_add_n_component_w_observer(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Tag);
+
+    ecs_observer(world, {
+        .filter.terms = {{ ecs_id(Velocity) }},
+        .events = { EcsOnAdd },
+        .callback = add_n_observer
+    });
+
+    add_n_invoked = 0;
+    add_n_count = 0;
+
+    const ecs_entity_t *ids = ecs_bulk_new(world, Position, 10);
+    ecs_entity_t entities[10];
+    ecs_os_memcpy_n(entities, ids, ecs_entity_t, 10);
+
+    /* Move part of the table */
+    ecs_add_id_n(world, &entities[2], 5, ecs_id(Velocity));
+    test_int(add_n_invoked, 1);
+    test_int(add_n_count, 5);
+
+    int i;
+    for (i = 0; i < 10; i ++) {
+        test_bool(ecs_has(world, entities[i], Velocity), i >= 2 && i < 7);
+        test_assert(ecs_has(world, entities[i], Position));
+    }
+
+    ecs_fini(world);
+}
+
+void Add_add_n_whole_table(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_set_hooks(world, Velocity, {
+        .ctor = ecs_default_ctor,
+        .on_add = add_n_observer
+    });
+
+    add_n_invoked = 0;
+    add_n_count = 0;
+
+    ecs_entity_t entities[10];
+    int i;
+    for (i = 0; i < 10; i ++) {
+        entities[i] = ecs_set(world, 0, Position, {i, i * 2});
+    }
+
+    ecs_table_t *table = ecs_get_table(world, entities[0]);
+    test_int(ecs_table_count(table), 10);
+
+    ecs_add_id_n(world, entities, 10, ecs_id(Velocity));
+    test_int(ecs_table_count(table), 0);
+    test_int(add_n_invoked, 1);
+    test_int(add_n_count, 10);
+
+    ecs_table_t *dst = ecs_get_table(world, entities[0]);
+    test_assert(dst != table);
+    test_int(ecs_table_count(dst), 10);
+
+    for (i = 0; i < 10; i ++) {
+        test_assert(ecs_get_table(world, entities[i]) == dst);
+        test_int(ECS_RECORD_TO_ROW(ecs_record_find(world, entities[i])->row), i);
+        const Position *p = ecs_get(world, entities[i], Position);
+        test_int(p->x, i);
+        test_int(p->y, i * 2);
+        const Velocity *v = ecs_get(world, entities[i], Velocity);
+        test_int(v->x, 0);
+        test_int(v->y, 0);
+    }
+
+    ecs_fini(world);
+}
+
+void Add_add_n_duplicate(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+
+    ecs_entity_t entities[] = {e1, e1};
+    ecs_add_id_n(world, entities, 2, Tag);
+
+    test_assert(ecs_has(world, e1, Tag));
+    test_assert(!ecs_has(world, e2, Tag));
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+    p = ecs_get(world, e2, Position);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    ecs_fini(world);
+}
+
+void Add_add_n_empty_entities(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_new_id(world);
+    ecs_entity_t e2 = ecs_new_id(world);
+
+    ecs_entity_t entities[] = {e1, e2};
+    ecs_add_id_n(world, entities, 2, Tag);
+
+    test_assert(ecs_has(world, e1, Tag));
+    test_assert(ecs_has(world, e2, Tag));
+
+    ecs_fini(world);
+}
+
+void Add_add_n_deferred(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_new_id(world);
+    ecs_entity_t e2 = ecs_new_id(world);
+
+    ecs_entity_t entities[] = {e1, e2};
+
+    ecs_defer_begin(world);
+    ecs_add_id_n(world, entities, 2, Tag);
+    test_assert(!ecs_has(world, e1, Tag));
+    test_assert(!ecs_has(world, e2, Tag));
+    ecs_defer_end(world);
+
+    test_assert(ecs_has(world, e1, Tag));
+    test_assert(ecs_has(world, e2, Tag));
+
+    ecs_fini(world);
+}
+
+void Add_remove_n(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_add(world, e1, Tag);
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_add(world, e2, Tag);
+    ecs_entity_t e3 = ecs_new(world, Tag);
+
+    ecs_entity_t entities[] = {e1, e2, e3};
+    ecs_remove_id_n(world, entities, 3, Tag);
+
+    test_assert(!ecs_has(world, e1, Tag));
+    test_assert(!ecs_has(world, e2, Tag));
+    test_assert(!ecs_has(world, e3, Tag));
+    test_assert(ecs_is_alive(world, e3));
+    test_assert(ecs_get_table(world, e3) == NULL);
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+    p = ecs_get(world, e2, Position);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    ecs_fini(world);
+}
+
+void Add_add_w_iter(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_set(world, e2, Velocity, {1, 2});
+    ecs_entity_t e3 = ecs_set(world, 0, Velocity, {3, 4});
+
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    ecs_add_id_w_iter(&it, Tag);
+
+    test_assert(ecs_has(world, e1, Tag));
+    test_assert(ecs_has(world, e2, Tag));
+    test_assert(!ecs_has(world, e3, Tag));
+
+    const Position *p = ecs_get(world, e1, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+    p = ecs_get(world, e2, Position);
+    test_int(p->x, 30); test_int(p->y, 40);
+
+    it = ecs_filter_iter(world, f);
+    ecs_remove_id_w_iter(&it, Tag);
+
+    test_assert(!ecs_has(world, e1, Tag));
+    test_assert(!ecs_has(world, e2, Tag));
+    test_assert(!ecs_has(world, e3, Tag));
+
+    ecs_filter_fini(f);
+    ecs_fini(world);
+}
+
+void Add_add_n_childof_w_name(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ecs_entity_t p = ecs_new_entity(world, "p");
+    ecs_entity_t e1 = ecs_new_entity(world, "e1");
+    ecs_entity_t e2 = ecs_new_entity(world, "e2");
+
+    ecs_entity_t entities[] = {e1, e2};
+    ecs_add_id_n(world, entities, 2, ecs_childof(p));
+
+    test_assert(ecs_has_pair(world, e1, EcsChildOf, p));
+    test_assert(ecs_has_pair(world, e2, EcsChildOf, p));
+    test_uint(ecs_lookup_fullpath(world, "p.e1"), e1);
+    test_uint(ecs_lookup_fullpath(world, "p.e2"), e2);
+    test_uint(ecs_lookup_fullpath(world, "e1"), 0);
+
+    ecs_fini(world);
+}
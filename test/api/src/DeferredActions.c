@@ -3572,3 +3572,26 @@ void DeferredActions_on_remove_hook_while_defer_suspended(void) {
 
     ecs_fini(world);
 }
+
+void DeferredActions_add_to_not_created(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    /* Id that was never created. Commands for it are discarded. */
+    ecs_entity_t e = ecs_new_id(world) + 1000;
+    test_assert(!ecs_exists(world, e));
+
+    ecs_defer_begin(world);
+    ecs_enable_id(world, e, Tag, true);
+    ecs_enable_id(world, e, ecs_id(Position), false);
+    ecs_defer_end(world);
+
+    test_assert(!ecs_exists(world, e));
+    test_assert(!ecs_is_alive(world, e));
+    test_int(ecs_count(world, Tag), 0);
+    test_int(ecs_count(world, Position), 0);
+
+    ecs_fini(world);
+}
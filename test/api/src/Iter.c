@@ -2226,3 +2226,190 @@ void Iter_to_str(void) {
 
     ecs_fini(world);
 }
+
+void Iter_worker_chunk_iter_1(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+
+    ecs_entity_t e1 = ecs_new_id(world); ecs_set(world, e1, Self, {e1});
+    ecs_entity_t e2 = ecs_new_id(world); ecs_set(world, e2, Self, {e2});
+    ecs_entity_t e3 = ecs_new_id(world); ecs_set(world, e3, Self, {e3});
+    ecs_entity_t e4 = ecs_new_id(world); ecs_set(world, e4, Self, {e4});
+    ecs_entity_t e5 = ecs_new_id(world); ecs_set(world, e5, Self, {e5});
+
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {{ ecs_id(Self) }}
+    });
+
+    int32_t claimed = 0;
+    ecs_iter_t it_1 = ecs_filter_iter(world, f);
+    ecs_iter_t pit_1 = ecs_worker_chunk_iter(&it_1, &claimed, 2);
+    ecs_iter_t it_2 = ecs_filter_iter(world, f);
+    ecs_iter_t pit_2 = ecs_worker_chunk_iter(&it_2, &claimed, 2);
+
+    test_bool(ecs_worker_chunk_next(&pit_1), true);
+    test_int(pit_1.count, 2);
+    test_int(pit_1.entities[0], e1);
+    test_int(pit_1.entities[1], e2);
+    {
+        Self *ptr = ecs_field(&pit_1, Self, 1);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e1);
+        test_int(ptr[1].value, e2);
+    }
+
+    test_bool(ecs_worker_chunk_next(&pit_1), true);
+    test_int(pit_1.count, 2);
+    test_int(pit_1.entities[0], e3);
+    test_int(pit_1.entities[1], e4);
+    {
+        Self *ptr = ecs_field(&pit_1, Self, 1);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e3);
+        test_int(ptr[1].value, e4);
+    }
+
+    test_bool(ecs_worker_chunk_next(&pit_2), true);
+    test_int(pit_2.count, 1);
+    test_int(pit_2.entities[0], e5);
+    {
+        Self *ptr = ecs_field(&pit_2, Self, 1);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e5);
+    }
+
+    test_bool(ecs_worker_chunk_next(&pit_1), false);
+    test_bool(ecs_worker_chunk_next(&pit_2), false);
+
+    ecs_filter_fini(f);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_chunk_iter_w_multiple_tables(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_TAG(world, TagA);
+
+    ecs_entity_t e1 = ecs_new_id(world); ecs_set(world, e1, Self, {e1});
+    ecs_entity_t e2 = ecs_new_id(world); ecs_set(world, e2, Self, {e2});
+    ecs_entity_t e3 = ecs_new_id(world); ecs_set(world, e3, Self, {e3});
+    ecs_entity_t e4 = ecs_new_id(world); ecs_set(world, e4, Self, {e4});
+
+    ecs_add(world, e4, TagA);
+
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {{ ecs_id(Self) }}
+    });
+
+    int32_t claimed = 0;
+    ecs_iter_t it_1 = ecs_filter_iter(world, f);
+    ecs_iter_t pit_1 = ecs_worker_chunk_iter(&it_1, &claimed, 2);
+    ecs_iter_t it_2 = ecs_filter_iter(world, f);
+    ecs_iter_t pit_2 = ecs_worker_chunk_iter(&it_2, &claimed, 2);
+
+    test_bool(ecs_worker_chunk_next(&pit_2), true);
+    test_int(pit_2.count, 2);
+    test_int(pit_2.entities[0], e1);
+    test_int(pit_2.entities[1], e2);
+
+    test_bool(ecs_worker_chunk_next(&pit_1), true);
+    test_int(pit_1.count, 1);
+    test_int(pit_1.entities[0], e3);
+    {
+        Self *ptr = ecs_field(&pit_1, Self, 1);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e3);
+    }
+
+    test_bool(ecs_worker_chunk_next(&pit_2), true);
+    test_int(pit_2.count, 1);
+    test_int(pit_2.entities[0], e4);
+    {
+        Self *ptr = ecs_field(&pit_2, Self, 1);
+        test_assert(ptr != NULL);
+        test_int(ptr[0].value, e4);
+    }
+
+    test_bool(ecs_worker_chunk_next(&pit_1), false);
+    test_bool(ecs_worker_chunk_next(&pit_2), false);
+
+    ecs_filter_fini(f);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_chunk_iter_w_shared_field(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Self);
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t base = ecs_set(world, 0, Position, {10, 20});
+
+    int32_t i, count = 10;
+    ecs_entity_t entities[10];
+    for (i = 0; i < count; i ++) {
+        entities[i] = ecs_new_w_pair(world, EcsIsA, base);
+        ecs_set(world, entities[i], Self, {entities[i]});
+    }
+
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {{ ecs_id(Self) }, { ecs_id(Position) }}
+    });
+
+    /* Non-instanced iteration advances field pointers per row, which must not
+     * affect the pointers of the next chunk claimed from the same table */
+    int32_t claimed = 0;
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    ecs_iter_t pit = ecs_worker_chunk_iter(&it, &claimed, 3);
+
+    int32_t row = 0;
+    while (ecs_worker_chunk_next(&pit)) {
+        test_int(pit.count, 1);
+        Self *s = ecs_field(&pit, Self, 1);
+        Position *p = ecs_field(&pit, Position, 2);
+        test_assert(!ecs_field_is_self(&pit, 2));
+        test_uint(pit.entities[0], entities[row]);
+        test_uint(s[0].value, entities[row]);
+        test_int(p->x, 10);
+        test_int(p->y, 20);
+        row ++;
+    }
+
+    test_int(row, count);
+    test_int(claimed, 5);
+
+    ecs_filter_fini(f);
+
+    ecs_fini(world);
+}
+
+void Iter_worker_chunk_iter_w_fini(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Foo);
+
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {{ ecs_id(Position) }}
+    });
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {20, 30});
+    ecs_add(world, e2, Foo);
+
+    int32_t claimed = 0;
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    ecs_iter_t pit = ecs_worker_chunk_iter(&it, &claimed, 8);
+    test_bool(true, ecs_worker_chunk_next(&pit));
+    test_int(pit.count, 1);
+    test_int(pit.entities[0], e1);
+    ecs_iter_fini(&pit);
+
+    ecs_filter_fini(f);
+
+    ecs_fini(world);
+}
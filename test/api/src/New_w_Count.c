@@ -687,3 +687,58 @@ void New_w_Count_bulk_init_w_table(void) {
 
     ecs_fini(world);
 }
+
+void New_w_Count_bulk_new_multiple_pages(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    int32_t i, count = 3 * (1 << FLECS_ENTITY_PAGE_BITS) + 10;
+    const ecs_entity_t *ids = ecs_bulk_new(world, Position, count);
+    test_assert(ids != NULL);
+    test_int(count, ecs_count(world, Position));
+
+    ecs_table_t *table = ecs_get_table(world, ids[0]);
+    test_assert(table != NULL);
+    int32_t offset = ecs_table_count(table) - count;
+
+    for (i = 0; i < count; i ++) {
+        test_assert(ecs_is_alive(world, ids[i]));
+        test_assert(ecs_get_table(world, ids[i]) == table);
+        test_int(ECS_RECORD_TO_ROW(ecs_record_find(world, ids[i])->row), 
+            offset + i);
+        test_assert(ecs_has(world, ids[i], Position));
+    }
+
+    ecs_fini(world);
+}
+
+void New_w_Count_bulk_new_recycle_multiple_pages(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_new_id(world);
+    ecs_entity_t e2 = ecs_new_id(world);
+    ecs_delete(world, e1);
+    ecs_delete(world, e2);
+
+    int32_t i, count = 2 * (1 << FLECS_ENTITY_PAGE_BITS);
+    const ecs_entity_t *ids = ecs_bulk_new(world, Tag, count);
+    test_assert(ids != NULL);
+    test_int(count, ecs_count(world, Tag));
+    test_assert((uint32_t)ids[0] == (uint32_t)e2);
+    test_assert((uint32_t)ids[1] == (uint32_t)e1);
+
+    ecs_table_t *table = ecs_get_table(world, ids[0]);
+    for (i = 0; i < count; i ++) {
+        test_assert(ecs_is_alive(world, ids[i]));
+        test_assert(ecs_get_table(world, ids[i]) == table);
+        test_assert(ecs_has(world, ids[i], Tag));
+    }
+
+    ecs_delete_with(world, Tag);
+    test_int(0, ecs_count(world, Tag));
+
+    ecs_fini(world);
+}
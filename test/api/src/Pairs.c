@@ -2985,3 +2985,107 @@ void Pairs_oneof_other_rel_parent_constraint_violated(void) {
     test_expect_abort();
     ecs_add_pair(world, e, Rel, ObjC);
 }
+
+void Pairs_pair_w_ids_on_different_pages(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ecs_entity_t rel_lo = ecs_new_id(world);
+    ecs_entity_t rel_hi = 70000;
+    ecs_entity_t tgt_lo = ecs_new_id(world);
+    ecs_entity_t tgt_hi = 100000;
+    ecs_ensure(world, rel_hi);
+    ecs_ensure(world, tgt_hi);
+
+    ecs_entity_t e1 = ecs_new_w_pair(world, rel_lo, tgt_lo);
+    ecs_entity_t e2 = ecs_new_w_pair(world, rel_lo, tgt_hi);
+    ecs_entity_t e3 = ecs_new_w_pair(world, rel_hi, tgt_lo);
+    ecs_entity_t e4 = ecs_new_w_pair(world, rel_hi, tgt_hi);
+
+    test_assert(ecs_has_pair(world, e1, rel_lo, tgt_lo));
+    test_assert(ecs_has_pair(world, e2, rel_lo, tgt_hi));
+    test_assert(ecs_has_pair(world, e3, rel_hi, tgt_lo));
+    test_assert(ecs_has_pair(world, e4, rel_hi, tgt_hi));
+
+    test_int(ecs_count_id(world, ecs_pair(rel_lo, tgt_lo)), 1);
+    test_int(ecs_count_id(world, ecs_pair(rel_lo, tgt_hi)), 1);
+    test_int(ecs_count_id(world, ecs_pair(rel_hi, tgt_lo)), 1);
+    test_int(ecs_count_id(world, ecs_pair(rel_hi, tgt_hi)), 1);
+    test_int(ecs_count_id(world, ecs_pair(rel_hi, EcsWildcard)), 2);
+    test_int(ecs_count_id(world, ecs_pair(EcsWildcard, tgt_hi)), 2);
+
+    ecs_delete(world, tgt_hi);
+    test_assert(ecs_has_pair(world, e1, rel_lo, tgt_lo));
+    test_assert(!ecs_has_pair(world, e2, rel_lo, tgt_hi));
+    test_assert(ecs_has_pair(world, e3, rel_hi, tgt_lo));
+    test_assert(!ecs_has_pair(world, e4, rel_hi, tgt_hi));
+    test_int(ecs_count_id(world, ecs_pair(rel_hi, EcsWildcard)), 1);
+    test_assert(!ecs_id_in_use(world, ecs_pair(rel_hi, tgt_hi)));
+
+    ecs_delete(world, rel_hi);
+    test_assert(ecs_has_pair(world, e1, rel_lo, tgt_lo));
+    test_assert(!ecs_has_pair(world, e3, rel_hi, tgt_lo));
+    test_assert(!ecs_id_in_use(world, ecs_pair(rel_hi, tgt_lo)));
+
+    ecs_fini(world);
+}
+
+void Pairs_pair_w_ids_above_pair_index_range(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ecs_entity_t tgt_lo = ecs_new_id(world);
+    ecs_set_entity_range(world, 16000000, 0);
+
+    ecs_entity_t rel = ecs_new_id(world);
+    ecs_entity_t tgt = ecs_new_id(world);
+    test_assert(rel >= 16000000);
+    test_assert(tgt >= 16000000);
+
+    ecs_entity_t e1 = ecs_new_w_pair(world, rel, tgt);
+    ecs_entity_t e2 = ecs_new_w_pair(world, rel, tgt_lo);
+    test_assert(ecs_has_pair(world, e1, rel, tgt));
+    test_assert(ecs_has_pair(world, e2, rel, tgt_lo));
+    test_uint(ecs_get_target(world, e1, rel, 0), tgt);
+    test_int(ecs_count_id(world, ecs_pair(rel, EcsWildcard)), 2);
+    test_int(ecs_count_id(world, ecs_pair(EcsWildcard, tgt)), 1);
+
+    ecs_delete(world, tgt);
+    test_assert(!ecs_has_pair(world, e1, rel, tgt));
+    test_assert(ecs_has_pair(world, e2, rel, tgt_lo));
+    test_assert(!ecs_id_in_use(world, ecs_pair(rel, tgt)));
+
+    ecs_fini(world);
+}
+
+void Pairs_recreate_pair_after_last_in_page_deleted(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ecs_entity_t rel = ecs_new_id(world);
+    ecs_entity_t tgt_a = ecs_new_id(world);
+    ecs_entity_t tgt_b = ecs_new_id(world);
+
+    ecs_entity_t e1 = ecs_new_w_pair(world, rel, tgt_a);
+    ecs_entity_t e2 = ecs_new_w_pair(world, rel, tgt_b);
+
+    ecs_delete(world, e1);
+    ecs_delete(world, e2);
+    ecs_delete(world, tgt_a);
+    ecs_delete(world, tgt_b);
+    test_assert(!ecs_id_in_use(world, ecs_pair(rel, tgt_a)));
+    test_assert(!ecs_id_in_use(world, ecs_pair(rel, tgt_b)));
+
+    ecs_entity_t tgt_c = ecs_new_id(world);
+    ecs_entity_t e3 = ecs_new_w_pair(world, rel, tgt_c);
+    test_assert(ecs_has_pair(world, e3, rel, tgt_c));
+    test_uint(ecs_get_target(world, e3, rel, 0), tgt_c);
+    test_int(ecs_count_id(world, ecs_pair(rel, tgt_c)), 1);
+    test_int(ecs_count_id(world, ecs_pair(rel, EcsWildcard)), 1);
+
+    ecs_delete(world, rel);
+    test_assert(!ecs_has_pair(world, e3, rel, tgt_c));
+
+    ecs_entity_t rel_2 = ecs_new_id(world);
+    ecs_add_pair(world, e3, rel_2, tgt_c);
+    test_assert(ecs_has_pair(world, e3, rel_2, tgt_c));
+
+    ecs_fini(world);
+}
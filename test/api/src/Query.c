@@ -8668,6 +8668,371 @@ void Query_rematch_empty_table_w_superset(void) {
     ecs_fini(world);
 }
 
+void Query_rematch_reparent_subtree(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t p1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t p2 = ecs_new_id(world);
+    ecs_entity_t c = ecs_new_w_pair(world, EcsChildOf, p1);
+    ecs_entity_t gc = ecs_new_w_pair(world, EcsChildOf, c);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position), 
+            .src = { .flags = EcsUp, .trav = EcsChildOf } 
+        }}
+    });
+    test_assert(q != NULL);
+    test_int(2, ecs_query_table_count(q));
+
+    ecs_add_pair(world, c, EcsChildOf, p2);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_set(world, p2, Position, {30, 40});
+
+    it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], c);
+    test_uint(it.sources[0], p2);
+    Position *p = ecs_field(&it, Position, 1);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], gc);
+    test_uint(it.sources[0], p2);
+    p = ecs_field(&it, Position, 1);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_rematch_reparent_keep_unrelated(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t p1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t p2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_entity_t p3 = ecs_new_id(world);
+    ecs_entity_t c1 = ecs_new_w_pair(world, EcsChildOf, p1);
+    ecs_entity_t c2 = ecs_new_w_pair(world, EcsChildOf, p2);
+    ecs_entity_t gc1 = ecs_new_w_pair(world, EcsChildOf, c1);
+    ecs_entity_t gc2 = ecs_new_w_pair(world, EcsChildOf, c2);
+
+    ecs_query_t *q = ecs_query_new(world, "Position(up(ChildOf))");
+    test_assert(q != NULL);
+    test_int(4, ecs_query_table_count(q));
+
+    /* Reparent c1, the matches of the p2 subtree should not change */
+    ecs_add_pair(world, c1, EcsChildOf, p3);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], c2);
+    test_uint(it.sources[0], p2);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], gc2);
+    test_uint(it.sources[0], p2);
+    test_bool(false, ecs_query_next(&it));
+
+    /* Moves c1 to the same table as c2 */
+    ecs_add_pair(world, c1, EcsChildOf, p2);
+
+    it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], c2);
+    test_uint(it.sources[0], p2);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], c1);
+    test_uint(it.sources[0], p2);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], gc2);
+    test_uint(it.sources[0], p2);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], gc1);
+    test_uint(it.sources[0], p2);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_rematch_cascade_after_reparent(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t p1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t p2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_entity_t c1 = ecs_new_w_pair(world, EcsChildOf, p1);
+    ecs_set(world, c1, Position, {50, 60});
+    ecs_entity_t gc1 = ecs_new_w_pair(world, EcsChildOf, c1);
+    ecs_set(world, gc1, Position, {70, 80});
+    ecs_entity_t c2 = ecs_new_w_pair(world, EcsChildOf, p2);
+    ecs_set(world, c2, Position, {90, 100});
+
+    ecs_query_t *q = ecs_query_new(world, "Position, ?Position(parent|cascade)");
+    test_assert(q != NULL);
+
+    /* Move p1 subtree under c2, which increases its depth */
+    ecs_add_pair(world, p1, EcsChildOf, c2);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], p2);
+    test_uint(it.sources[1], 0);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], c2);
+    test_uint(it.sources[1], p2);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], p1);
+    test_uint(it.sources[1], c2);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], c1);
+    test_uint(it.sources[1], p1);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], gc1);
+    test_uint(it.sources[1], c1);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_rematch_after_add_id_n_to_parents(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    ecs_entity_t parents[2] = { ecs_new_id(world), ecs_new_id(world) };
+    ecs_entity_t c1 = ecs_new_w_pair(world, EcsChildOf, parents[0]);
+    ecs_entity_t c2 = ecs_new_w_pair(world, EcsChildOf, parents[1]);
+
+    ecs_query_t *q = ecs_query_new(world, "Position(up(ChildOf))");
+    test_assert(q != NULL);
+    test_int(0, ecs_query_table_count(q));
+
+    ecs_add_id_n(world, parents, 2, ecs_id(Position));
+
+    /* Tables are added in the order in which they're rematched */
+    int32_t count = 0;
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        test_int(it.count, 1);
+        if (it.entities[0] == c1) {
+            test_uint(it.sources[0], parents[0]);
+        } else {
+            test_uint(it.entities[0], c2);
+            test_uint(it.sources[0], parents[1]);
+        }
+        count ++;
+    }
+    test_int(count, 2);
+
+    ecs_fini(world);
+}
+
+void Query_rematch_w_fixed_src_after_reparent(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t p1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_entity_t p2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_entity_t c = ecs_new_w_pair(world, EcsChildOf, p1);
+    ecs_entity_t gc = ecs_new_w_pair(world, EcsChildOf, c);
+    ecs_entity_t game = ecs_new_entity(world, "Game");
+    ecs_add(world, game, Tag);
+
+    ecs_query_t *q = ecs_query_new(world, "Position(up(ChildOf)), Tag(Game)");
+    test_assert(q != NULL);
+    test_int(2, ecs_query_table_count(q));
+
+    ecs_add_pair(world, c, EcsChildOf, p2);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], gc);
+    test_uint(it.sources[0], p2);
+    test_uint(it.sources[1], game);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], c);
+    test_uint(it.sources[0], p2);
+    test_uint(it.sources[1], game);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_trivial_query_w_tag_and_inout_none(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Tag);
+    ECS_TAG(world, Foo);
+
+    ecs_entity_t e1 = ecs_new(world, Tag);
+    ecs_set(world, e1, Position, {10, 20});
+    ecs_set(world, e1, Velocity, {1, 2});
+    ecs_entity_t e2 = ecs_new(world, Tag);
+    ecs_set(world, e2, Position, {30, 40});
+    ecs_set(world, e2, Velocity, {3, 4});
+    ecs_add(world, e2, Foo);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {
+            { ecs_id(Position) },
+            { Tag },
+            { ecs_id(Velocity), .inout = EcsInOutNone }
+        }
+    });
+    test_assert(q != NULL);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e1);
+    Position *p = ecs_field(&it, Position, 1);
+    test_assert(p != NULL);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    test_assert(ecs_field_w_size(&it, 0, 2) == NULL);
+    test_assert(ecs_field_w_size(&it, 0, 3) == NULL);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e2);
+    p = ecs_field(&it, Position, 1);
+    test_assert(p != NULL);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+    test_assert(ecs_field_w_size(&it, 0, 2) == NULL);
+    test_assert(ecs_field_w_size(&it, 0, 3) == NULL);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_trivial_query_owned_after_shared(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    /* Create query first, so tables are iterated in creation order */
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity) }}
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t base = ecs_new_w_id(world, EcsPrefab);
+    ecs_set(world, base, Position, {10, 20});
+    ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, base);
+    ecs_set(world, inst, Velocity, {1, 2});
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {30, 40});
+    ecs_set(world, e1, Velocity, {3, 4});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {50, 60});
+    ecs_set(world, e2, Velocity, {5, 6});
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], inst);
+    test_uint(it.sources[0], base);
+    test_uint(it.sources[1], 0);
+    Position *p = ecs_field(&it, Position, 1);
+    Velocity *v = ecs_field(&it, Velocity, 2);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+
+    /* Owned table is not split up in individual entities */
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 2);
+    test_uint(it.entities[0], e1);
+    test_uint(it.entities[1], e2);
+    test_uint(it.sources[0], 0);
+    test_uint(it.sources[1], 0);
+    p = ecs_field(&it, Position, 1);
+    v = ecs_field(&it, Velocity, 2);
+    test_int(p[0].x, 30);
+    test_int(p[0].y, 40);
+    test_int(p[1].x, 50);
+    test_int(p[1].y, 60);
+    test_int(v[0].x, 3);
+    test_int(v[0].y, 4);
+    test_int(v[1].x, 5);
+    test_int(v[1].y, 6);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_trivial_query_changed_w_in_term(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_set(world, 0, Position, {10, 20});
+    ecs_set(world, e, Velocity, {1, 2});
+
+    ecs_query_t *q_p = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position), .inout = EcsIn }}
+    });
+    ecs_query_t *q_v = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Velocity), .inout = EcsIn }}
+    });
+    ecs_query_t *q_write = ecs_query(world, {
+        .filter.terms = {
+            { ecs_id(Position) }, 
+            { ecs_id(Velocity), .inout = EcsIn }
+        }
+    });
+
+    test_bool(true, ecs_query_changed(q_p, NULL));
+    test_bool(true, ecs_query_changed(q_v, NULL));
+    ecs_iter_t it = ecs_query_iter(world, q_p);
+    while (ecs_query_next(&it)) { }
+    it = ecs_query_iter(world, q_v);
+    while (ecs_query_next(&it)) { }
+    test_bool(false, ecs_query_changed(q_p, NULL));
+    test_bool(false, ecs_query_changed(q_v, NULL));
+
+    it = ecs_query_iter(world, q_write);
+    test_bool(true, ecs_query_next(&it));
+    Position *p = ecs_field(&it, Position, 1);
+    p->x ++;
+    test_bool(false, ecs_query_next(&it));
+
+    test_bool(true, ecs_query_changed(q_p, NULL));
+    test_bool(false, ecs_query_changed(q_v, NULL));
+
+    ecs_fini(world);
+}
+
 void Query_query_w_short_notation(void) {
     ecs_world_t *world = ecs_mini();
 
@@ -9569,3 +9934,233 @@ void Query_set_this_w_wildcard(void) {
 
     ecs_fini(ecs);
 }
+
+void Query_prefetch_query(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity) }},
+        .prefetch = true
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_set(world, e1, Velocity, {1, 2});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_set(world, e2, Velocity, {3, 4});
+    ecs_add(world, e2, TagA);
+    ecs_entity_t e3 = ecs_set(world, 0, Position, {50, 60});
+    ecs_set(world, e3, Velocity, {5, 6});
+    ecs_add(world, e3, TagB);
+
+    ecs_entity_t expect[] = {e1, e2, e3};
+    int32_t i = 0;
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    while (ecs_query_next(&it)) {
+        test_int(it.count, 1);
+        test_assert(i < 3);
+        test_uint(it.entities[0], expect[i]);
+        Position *p = ecs_field(&it, Position, 1);
+        Velocity *v = ecs_field(&it, Velocity, 2);
+        test_int(p->x, 10 + i * 20);
+        test_int(p->y, 20 + i * 20);
+        test_int(v->x, 1 + i * 2);
+        test_int(v->y, 2 + i * 2);
+        i ++;
+    }
+    test_int(i, 3);
+
+    ecs_fini(world);
+}
+
+void Query_prefetch_query_w_shared(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ ecs_id(Position) }, { ecs_id(Velocity) }},
+        .prefetch = true
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t base = ecs_new_w_id(world, EcsPrefab);
+    ecs_set(world, base, Position, {10, 20});
+    ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, base);
+    ecs_set(world, inst, Velocity, {1, 2});
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {30, 40});
+    ecs_set(world, e1, Velocity, {3, 4});
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], inst);
+    test_uint(it.sources[0], base);
+    Position *p = ecs_field(&it, Position, 1);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e1);
+    test_uint(it.sources[0], 0);
+    p = ecs_field(&it, Position, 1);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_prefetch_query_no_data(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_TAG(world, TagA);
+    ECS_TAG(world, TagB);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {{ TagA }},
+        .prefetch = true
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t e1 = ecs_new(world, TagA);
+    ecs_entity_t e2 = ecs_new(world, TagA);
+    ecs_add(world, e2, TagB);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e1);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e2);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_compiled_iter_w_shared_and_no_data(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+    ECS_TAG(world, TagA);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {
+            { ecs_id(Position) }, 
+            { ecs_id(Velocity) }, 
+            { TagA }, 
+            { ecs_id(Mass), .inout = EcsInOutNone }
+        }
+    });
+    test_assert(q != NULL);
+
+    ecs_entity_t base = ecs_new_w_id(world, EcsPrefab);
+    ecs_set(world, base, Position, {10, 20});
+    ecs_set(world, base, Mass, {1});
+    ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, base);
+    ecs_set(world, inst, Velocity, {1, 2});
+    ecs_add(world, inst, TagA);
+
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {30, 40});
+    ecs_set(world, e1, Velocity, {3, 4});
+    ecs_set(world, e1, Mass, {2});
+    ecs_add(world, e1, TagA);
+
+    ecs_iter_t it = ecs_query_iter(world, q);
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], inst);
+    test_uint(it.sources[0], base);
+    Position *p = ecs_field(&it, Position, 1);
+    test_int(p->x, 10);
+    test_int(p->y, 20);
+    Velocity *v = ecs_field(&it, Velocity, 2);
+    test_int(v->x, 1);
+    test_int(v->y, 2);
+    test_assert(it.ptrs[2] == NULL);
+    test_assert(it.ptrs[3] == NULL);
+
+    test_bool(true, ecs_query_next(&it));
+    test_int(it.count, 1);
+    test_uint(it.entities[0], e1);
+    test_uint(it.sources[0], 0);
+    p = ecs_field(&it, Position, 1);
+    test_int(p->x, 30);
+    test_int(p->y, 40);
+    v = ecs_field(&it, Velocity, 2);
+    test_int(v->x, 3);
+    test_int(v->y, 4);
+    test_assert(it.ptrs[2] == NULL);
+    test_assert(it.ptrs[3] == NULL);
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
+
+void Query_compiled_iter_mark_dirty(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, TagA);
+
+    ecs_new(world, TagA);
+    ecs_entity_t e1 = ecs_set(world, 0, Position, {10, 20});
+    ecs_set(world, e1, Velocity, {1, 2});
+    ecs_entity_t e2 = ecs_set(world, 0, Position, {30, 40});
+    ecs_set(world, e2, Velocity, {3, 4});
+    ecs_add(world, e2, TagA);
+
+    ecs_query_t *q = ecs_query(world, {
+        .filter.terms = {
+            { ecs_id(Position) }, 
+            { ecs_id(Velocity), .inout = EcsIn }
+        }
+    });
+    test_assert(q != NULL);
+
+    ecs_query_t *q_p = ecs_query_new(world, "[in] Position");
+    test_assert(q_p != NULL);
+    ecs_query_t *q_v = ecs_query_new(world, "[in] Velocity");
+    test_assert(q_v != NULL);
+    test_bool(true, ecs_query_changed(q_p, NULL));
+    test_bool(true, ecs_query_changed(q_v, NULL));
+
+    ecs_iter_t it = ecs_query_iter(world, q_p);
+    while (ecs_query_next(&it)) { }
+    it = ecs_query_iter(world, q_v);
+    while (ecs_query_next(&it)) { }
+    test_bool(false, ecs_query_changed(q_p, NULL));
+    test_bool(false, ecs_query_changed(q_v, NULL));
+
+    it = ecs_query_iter(world, q);
+    int32_t count = 0;
+    while (ecs_query_next(&it)) {
+        count += it.count;
+    }
+    test_int(count, 2);
+
+    test_bool(true, ecs_query_changed(q_p, NULL));
+    test_bool(false, ecs_query_changed(q_v, NULL));
+
+    it = ecs_query_iter(world, q_p);
+    test_bool(true, ecs_query_next(&it));
+    test_bool(true, ecs_query_changed(NULL, &it));
+    test_bool(true, ecs_query_next(&it));
+    test_bool(true, ecs_query_changed(NULL, &it));
+    test_bool(false, ecs_query_next(&it));
+
+    ecs_fini(world);
+}
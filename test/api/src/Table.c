@@ -377,3 +377,240 @@ void Table_get_column_size(void) {
 
     ecs_fini(world);
 }
+
+void Table_aligned_column(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ecs_entity_t c = ecs_component_init(world, &(ecs_component_desc_t){
+        .entity = ecs_entity(world, { .name = "Mass" }),
+        .type.size = ECS_SIZEOF(float),
+        .type.alignment = 32
+    });
+    test_assert(c != 0);
+
+    ECS_COMPONENT(world, Position);
+
+    int i;
+    for (i = 0; i < 40; i ++) {
+        ecs_entity_t e = ecs_new_id(world);
+        ecs_add(world, e, Position);
+        float *v = ecs_get_mut_id(world, e, c);
+        *v = (float)i;
+
+        ecs_table_t *table = ecs_get_table(world, e);
+        float *ptr = ecs_table_get_id(world, table, c, 0);
+        test_assert(ptr != NULL);
+        test_int((uintptr_t)ptr % 32, 0);
+        test_int(ptr[i], (float)i);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_aligned_column_bulk(void) {
+    ecs_world_t *world = ecs_mini();
+
+    typedef struct { float x, y, z; } Vec3;
+
+    ecs_entity_t c = ecs_component_init(world, &(ecs_component_desc_t){
+        .entity = ecs_entity(world, { .name = "Vec3" }),
+        .type.size = ECS_SIZEOF(Vec3),
+        .type.alignment = 64
+    });
+    test_assert(c != 0);
+
+    const ecs_entity_t *ids = ecs_bulk_new_w_id(world, c, 3);
+    test_assert(ids != NULL);
+
+    ecs_table_t *table = ecs_get_table(world, ids[0]);
+    Vec3 *ptr = ecs_table_get_id(world, table, c, 0);
+    test_int((uintptr_t)ptr % 64, 0);
+
+    ids = ecs_bulk_new_w_id(world, c, 100);
+    test_assert(ids != NULL);
+    ptr = ecs_table_get_id(world, table, c, 0);
+    test_int((uintptr_t)ptr % 64, 0);
+    test_int(ecs_table_count(table), 103);
+
+    ecs_fini(world);
+}
+
+void Table_invalid_component_alignment(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_mini();
+
+    test_expect_abort();
+    ecs_component_init(world, &(ecs_component_desc_t){
+        .entity = ecs_entity(world, { .name = "Foo" }),
+        .type.size = 4,
+        .type.alignment = 12
+    });
+}
+
+void Table_grow_large_column(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+
+    typedef struct { float x, y, z; } Vec3;
+
+    ecs_entity_t c = ecs_component_init(world, &(ecs_component_desc_t){
+        .entity = ecs_entity(world, { .name = "Vec3" }),
+        .type.size = ECS_SIZEOF(Vec3),
+        .type.alignment = 64
+    });
+    test_assert(c != 0);
+
+    /* Columns this large are allocated directly from the OS allocator */
+    int32_t i, count = FLECS_BALLOC_LARGE_SIZE / ECS_SIZEOF(Position) * 4;
+    ecs_entity_t first = 0;
+    for (i = 0; i < count; i ++) {
+        ecs_entity_t e = ecs_new(world, Position);
+        ecs_set(world, e, Position, {i, i * 2});
+        ecs_set_id(world, e, c, sizeof(Vec3), &(Vec3){i, 0, 0});
+        if (!first) {
+            first = e;
+        }
+    }
+
+    ecs_table_t *table = ecs_get_table(world, first);
+    test_int(ecs_table_count(table), count);
+
+    Position *p = ecs_table_get_id(world, table, ecs_id(Position), 0);
+    Vec3 *v = ecs_table_get_id(world, table, c, 0);
+    test_int((uintptr_t)v % 64, 0);
+    for (i = 0; i < count; i ++) {
+        test_int(p[i].x, i);
+        test_int(p[i].y, i * 2);
+        test_int(v[i].x, i);
+    }
+
+    ecs_delete_with(world, ecs_id(Position));
+    test_int(ecs_table_count(table), 0);
+
+    ecs_fini(world);
+}
+
+void Table_move_plan_add_remove_tag(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t e1 = ecs_new_id(world);
+    ecs_set(world, e1, Position, {10, 20});
+    ecs_set(world, e1, Velocity, {1, 2});
+    ecs_entity_t e2 = ecs_new_id(world);
+    ecs_set(world, e2, Position, {30, 40});
+    ecs_set(world, e2, Velocity, {3, 4});
+
+    ecs_table_t *table = ecs_get_table(world, e1);
+
+    int32_t i;
+    for (i = 0; i < 3; i ++) {
+        ecs_add(world, e1, Tag);
+        ecs_add(world, e2, Tag);
+        test_assert(ecs_get_table(world, e1) != table);
+        test_assert(ecs_get_table(world, e1) == ecs_get_table(world, e2));
+
+        ecs_remove(world, e1, Tag);
+        test_assert(ecs_get_table(world, e1) == table);
+
+        const Position *p = ecs_get(world, e1, Position);
+        test_int(p->x, 10); test_int(p->y, 20);
+        const Velocity *v = ecs_get(world, e1, Velocity);
+        test_int(v->x, 1); test_int(v->y, 2);
+
+        p = ecs_get(world, e2, Position);
+        test_int(p->x, 30); test_int(p->y, 40);
+        v = ecs_get(world, e2, Velocity);
+        test_int(v->x, 3); test_int(v->y, 4);
+
+        ecs_remove(world, e2, Tag);
+    }
+
+    ecs_fini(world);
+}
+
+static int move_plan_added = 0;
+static int move_plan_removed = 0;
+
+static
+void move_plan_on_add(ecs_iter_t *it) {
+    move_plan_added += it->count;
+}
+
+static
+void move_plan_on_remove(ecs_iter_t *it) {
+    move_plan_removed += it->count;
+}
+
+void Table_move_plan_w_hooks(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+    ECS_COMPONENT(world, Mass);
+
+    ecs_set_hooks(world, Velocity, {
+        .ctor = ecs_default_ctor,
+        .on_add = move_plan_on_add,
+        .on_remove = move_plan_on_remove
+    });
+
+    move_plan_added = 0;
+    move_plan_removed = 0;
+
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set(world, e, Position, {10, 20});
+    ecs_set(world, e, Mass, {30});
+
+    int32_t i;
+    for (i = 0; i < 3; i ++) {
+        ecs_set(world, e, Velocity, {1, 2});
+        test_int(move_plan_added, i + 1);
+        test_int(move_plan_removed, i);
+
+        ecs_remove(world, e, Velocity);
+        test_int(move_plan_added, i + 1);
+        test_int(move_plan_removed, i + 1);
+
+        const Position *p = ecs_get(world, e, Position);
+        test_int(p->x, 10); test_int(p->y, 20);
+        const Mass *m = ecs_get(world, e, Mass);
+        test_int(m[0], 30);
+    }
+
+    ecs_fini(world);
+}
+
+void Table_move_plan_after_table_delete(void) {
+    ecs_world_t *world = ecs_mini();
+
+    ECS_COMPONENT(world, Position);
+    ECS_COMPONENT(world, Velocity);
+
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set(world, e, Position, {10, 20});
+
+    ecs_entity_t tag = ecs_new_id(world);
+    ecs_add_id(world, e, tag);
+    ecs_remove_id(world, e, tag);
+
+    /* Deletes the table with the tag and its edges */
+    ecs_delete(world, tag);
+
+    tag = ecs_new_id(world);
+    ecs_add_id(world, e, tag);
+    ecs_set(world, e, Velocity, {1, 2});
+    ecs_remove_id(world, e, tag);
+
+    const Position *p = ecs_get(world, e, Position);
+    test_int(p->x, 10); test_int(p->y, 20);
+    const Velocity *v = ecs_get(world, e, Velocity);
+    test_int(v->x, 1); test_int(v->y, 2);
+
+    ecs_fini(world);
+}
@@ -234,6 +234,8 @@ void New_w_Count_recycle_1_of_2(void);
 void New_w_Count_recycle_1_of_3(void);
 void New_w_Count_recycle_2_of_3(void);
 void New_w_Count_bulk_init_w_table(void);
+void New_w_Count_bulk_new_multiple_pages(void);
+void New_w_Count_bulk_new_recycle_multiple_pages(void);
 
 // Testsuite 'Add'
 void Add_zero(void);
@@ -262,6 +264,15 @@ void Add_invalid_pair_w_0(void);
 void Add_invalid_pair_w_0_rel(void);
 void Add_invalid_pair_w_0_obj(void);
 void Add_add_random_id(void);
+void Add_add_n_tag(void);
+void Add_add_n_component_w_observer(void);
+void Add_add_n_whole_table(void);
+void Add_add_n_duplicate(void);
+void Add_add_n_empty_entities(void);
+void Add_add_n_deferred(void);
+void Add_remove_n(void);
+void Add_add_w_iter(void);
+void Add_add_n_childof_w_name(void);
 
 // Testsuite 'Switch'
 void Switch_get_case_no_switch(void);
@@ -1606,6 +1617,19 @@ void Query_set_this(void);
 void Query_set_this_no_match(void);
 void Query_set_this_is_true(void);
 void Query_set_this_w_wildcard(void);
+void Query_rematch_reparent_subtree(void);
+void Query_rematch_reparent_keep_unrelated(void);
+void Query_rematch_cascade_after_reparent(void);
+void Query_rematch_after_add_id_n_to_parents(void);
+void Query_rematch_w_fixed_src_after_reparent(void);
+void Query_trivial_query_w_tag_and_inout_none(void);
+void Query_trivial_query_owned_after_shared(void);
+void Query_trivial_query_changed_w_in_term(void);
+void Query_prefetch_query(void);
+void Query_prefetch_query_w_shared(void);
+void Query_prefetch_query_no_data(void);
+void Query_compiled_iter_w_shared_and_no_data(void);
+void Query_compiled_iter_mark_dirty(void);
 
 // Testsuite 'Iter'
 void Iter_page_iter_0_0(void);
@@ -1653,6 +1677,10 @@ void Iter_rule_page_iter_w_fini(void);
 void Iter_rule_worker_iter_w_fini(void);
 void Iter_to_str_before_next(void);
 void Iter_to_str(void);
+void Iter_worker_chunk_iter_1(void);
+void Iter_worker_chunk_iter_w_multiple_tables(void);
+void Iter_worker_chunk_iter_w_fini(void);
+void Iter_worker_chunk_iter_w_shared_field(void);
 
 // Testsuite 'Pairs'
 void Pairs_type_w_one_pair(void);
@@ -1770,6 +1798,9 @@ void Pairs_oneof_other(void);
 void Pairs_oneof_self_constraint_violated(void);
 void Pairs_oneof_other_constraint_violated(void);
 void Pairs_oneof_other_rel_parent_constraint_violated(void);
+void Pairs_pair_w_ids_on_different_pages(void);
+void Pairs_pair_w_ids_above_pair_index_range(void);
+void Pairs_recreate_pair_after_last_in_page_deleted(void);
 
 // Testsuite 'Trigger'
 void Trigger_on_add_trigger_before_table(void);
@@ -2466,6 +2497,7 @@ void DeferredActions_observer_while_defer_suspended(void);
 void DeferredActions_on_add_hook_while_defer_suspended(void);
 void DeferredActions_on_set_hook_while_defer_suspended(void);
 void DeferredActions_on_remove_hook_while_defer_suspended(void);
+void DeferredActions_add_to_not_created(void);
 
 // Testsuite 'SingleThreadStaging'
 void SingleThreadStaging_setup(void);
@@ -2570,6 +2602,13 @@ void Table_get_depth(void);
 void Table_get_depth_non_acyclic(void);
 void Table_get_depth_2_paths(void);
 void Table_get_column_size(void);
+void Table_aligned_column(void);
+void Table_aligned_column_bulk(void);
+void Table_invalid_component_alignment(void);
+void Table_grow_large_column(void);
+void Table_move_plan_add_remove_tag(void);
+void Table_move_plan_w_hooks(void);
+void Table_move_plan_after_table_delete(void);
 
 // Testsuite 'Poly'
 void Poly_iter_query(void);
@@ -3501,6 +3540,14 @@ bake_test_case New_w_Count_testcases[] = {
     {
         "bulk_init_w_table",
         New_w_Count_bulk_init_w_table
+    },
+    {
+        "bulk_new_multiple_pages",
+        New_w_Count_bulk_new_multiple_pages
+    },
+    {
+        "bulk_new_recycle_multiple_pages",
+        New_w_Count_bulk_new_recycle_multiple_pages
     }
 };
 
@@ -3608,6 +3655,42 @@ bake_test_case Add_testcases[] = {
     {
         "add_random_id",
         Add_add_random_id
+    },
+    {
+        "add_n_tag",
+        Add_add_n_tag
+    },
+    {
+        "add_n_component_w_observer",
+        Add_add_n_component_w_observer
+    },
+    {
+        "add_n_whole_table",
+        Add_add_n_whole_table
+    },
+    {
+        "add_n_duplicate",
+        Add_add_n_duplicate
+    },
+    {
+        "add_n_empty_entities",
+        Add_add_n_empty_entities
+    },
+    {
+        "add_n_deferred",
+        Add_add_n_deferred
+    },
+    {
+        "remove_n",
+        Add_remove_n
+    },
+    {
+        "add_w_iter",
+        Add_add_w_iter
+    },
+    {
+        "add_n_childof_w_name",
+        Add_add_n_childof_w_name
     }
 };
 
@@ -8845,6 +8928,58 @@ bake_test_case Query_testcases[] = {
     {
         "set_this_w_wildcard",
         Query_set_this_w_wildcard
+    },
+    {
+        "rematch_reparent_subtree",
+        Query_rematch_reparent_subtree
+    },
+    {
+        "rematch_reparent_keep_unrelated",
+        Query_rematch_reparent_keep_unrelated
+    },
+    {
+        "rematch_cascade_after_reparent",
+        Query_rematch_cascade_after_reparent
+    },
+    {
+        "rematch_after_add_id_n_to_parents",
+        Query_rematch_after_add_id_n_to_parents
+    },
+    {
+        "rematch_w_fixed_src_after_reparent",
+        Query_rematch_w_fixed_src_after_reparent
+    },
+    {
+        "trivial_query_w_tag_and_inout_none",
+        Query_trivial_query_w_tag_and_inout_none
+    },
+    {
+        "trivial_query_owned_after_shared",
+        Query_trivial_query_owned_after_shared
+    },
+    {
+        "trivial_query_changed_w_in_term",
+        Query_trivial_query_changed_w_in_term
+    },
+    {
+        "prefetch_query",
+        Query_prefetch_query
+    },
+    {
+        "prefetch_query_w_shared",
+        Query_prefetch_query_w_shared
+    },
+    {
+        "prefetch_query_no_data",
+        Query_prefetch_query_no_data
+    },
+    {
+        "compiled_iter_w_shared_and_no_data",
+        Query_compiled_iter_w_shared_and_no_data
+    },
+    {
+        "compiled_iter_mark_dirty",
+        Query_compiled_iter_mark_dirty
     }
 };
 
@@ -9028,6 +9163,22 @@ bake_test_case Iter_testcases[] = {
     {
         "to_str",
         Iter_to_str
+    },
+    {
+        "worker_chunk_iter_1",
+        Iter_worker_chunk_iter_1
+    },
+    {
+        "worker_chunk_iter_w_multiple_tables",
+        Iter_worker_chunk_iter_w_multiple_tables
+    },
+    {
+        "worker_chunk_iter_w_fini",
+        Iter_worker_chunk_iter_w_fini
+    },
+    {
+        "worker_chunk_iter_w_shared_field",
+        Iter_worker_chunk_iter_w_shared_field
     }
 };
 
@@ -9491,6 +9642,18 @@ bake_test_case Pairs_testcases[] = {
     {
         "oneof_other_rel_parent_constraint_violated",
         Pairs_oneof_other_rel_parent_constraint_violated
+    },
+    {
+        "pair_w_ids_on_different_pages",
+        Pairs_pair_w_ids_on_different_pages
+    },
+    {
+        "pair_w_ids_above_pair_index_range",
+        Pairs_pair_w_ids_above_pair_index_range
+    },
+    {
+        "recreate_pair_after_last_in_page_deleted",
+        Pairs_recreate_pair_after_last_in_page_deleted
     }
 };
 
@@ -12199,6 +12362,10 @@ bake_test_case DeferredActions_testcases[] = {
     {
         "on_remove_hook_while_defer_suspended",
         DeferredActions_on_remove_hook_while_defer_suspended
+    },
+    {
+        "add_to_not_created",
+        DeferredActions_add_to_not_created
     }
 };
 
@@ -12592,6 +12759,34 @@ bake_test_case Table_testcases[] = {
     {
         "get_column_size",
         Table_get_column_size
+    },
+    {
+        "aligned_column",
+        Table_aligned_column
+    },
+    {
+        "aligned_column_bulk",
+        Table_aligned_column_bulk
+    },
+    {
+        "invalid_component_alignment",
+        Table_invalid_component_alignment
+    },
+    {
+        "grow_large_column",
+        Table_grow_large_column
+    },
+    {
+        "move_plan_add_remove_tag",
+        Table_move_plan_add_remove_tag
+    },
+    {
+        "move_plan_w_hooks",
+        Table_move_plan_w_hooks
+    },
+    {
+        "move_plan_after_table_delete",
+        Table_move_plan_after_table_delete
     }
 };
 
@@ -12843,14 +13038,14 @@ static bake_test_suite suites[] = {
         "New_w_Count",
         NULL,
         NULL,
-        20,
+        22,
         New_w_Count_testcases
     },
     {
         "Add",
         NULL,
         NULL,
-        26,
+        35,
         Add_testcases
     },
     {
@@ -13011,21 +13206,21 @@ static bake_test_suite suites[] = {
         "Query",
         NULL,
         NULL,
-        235,
+        248,
         Query_testcases
     },
     {
         "Iter",
         NULL,
         NULL,
-        45,
+        49,
         Iter_testcases
     },
     {
         "Pairs",
         NULL,
         NULL,
-        115,
+        118,
         Pairs_testcases
     },
     {
@@ -13109,7 +13304,7 @@ static bake_test_suite suites[] = {
         "DeferredActions",
         NULL,
         NULL,
-        120,
+        121,
         DeferredActions_testcases
     },
     {
@@ -13130,7 +13325,7 @@ static bake_test_suite suites[] = {
         "Table",
         NULL,
         NULL,
-        14,
+        21,
         Table_testcases
     },
     {
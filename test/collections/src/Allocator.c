@@ -0,0 +1,470 @@
+#include <collections.h>
+#include <stdlib.h>
+
+static int32_t malloc_count;
+static int32_t realloc_count;
+static int32_t free_count;
+
+static
+void *test_malloc(ecs_size_t size) {
+    malloc_count ++;
+    return malloc(size);
+}
+
+static
+void *test_realloc(void *old_ptr, ecs_size_t size) {
+    realloc_count ++;
+    return realloc(old_ptr, size);
+}
+
+static
+void test_free(void *ptr) {
+    free_count ++;
+    free(ptr);
+}
+
+void Allocator_setup(void) {
+    ecs_os_set_api_defaults();
+    ecs_os_api_t os_api = ecs_os_api;
+    os_api.malloc_ = test_malloc;
+    os_api.realloc_ = test_realloc;
+    os_api.free_ = test_free;
+    ecs_os_set_api(&os_api);
+}
+
+void Allocator_alloc_small(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    int32_t *ptr = flecs_alloc_n(&a, int32_t, 4);
+    test_assert(ptr != NULL);
+    ptr[0] = 10; ptr[3] = 20;
+
+    /* Small chunks are returned to the block, not the OS */
+    int32_t frees = free_count;
+    flecs_free_n(&a, int32_t, 4, ptr);
+    test_int(free_count, frees);
+
+    int32_t *ptr2 = flecs_alloc_n(&a, int32_t, 4);
+    test_assert(ptr2 == ptr);
+    flecs_free_n(&a, int32_t, 4, ptr2);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_alloc_large(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    int32_t count = FLECS_BALLOC_LARGE_SIZE / ECS_SIZEOF(int32_t);
+    int32_t *ptr = flecs_alloc_n(&a, int32_t, count);
+    test_assert(ptr != NULL);
+    test_assert(((uintptr_t)ptr % 16) == 0);
+    ptr[0] = 10; ptr[count - 1] = 20;
+
+    /* Large chunks are returned to the OS */
+    int32_t frees = free_count;
+    flecs_free_n(&a, int32_t, count, ptr);
+    test_int(free_count, frees + 1);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_realloc_large(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    int32_t i, count = FLECS_BALLOC_LARGE_SIZE / ECS_SIZEOF(int32_t);
+    int32_t *ptr = flecs_alloc_n(&a, int32_t, count);
+    test_assert(ptr != NULL);
+    for (i = 0; i < count; i ++) {
+        ptr[i] = i;
+    }
+
+    /* Growing a large chunk resizes the allocation instead of allocating a
+     * new chunk */
+    flecs_allocator_get(&a, ECS_SIZEOF(int32_t) * count * 2);
+    int32_t mallocs = malloc_count, reallocs = realloc_count;
+    ptr = flecs_realloc_n(&a, int32_t, count * 2, count, ptr);
+    test_assert(ptr != NULL);
+    test_int(malloc_count, mallocs);
+    test_int(realloc_count, reallocs + 1);
+    for (i = 0; i < count; i ++) {
+        test_int(ptr[i], i);
+    }
+    for (i = count; i < count * 2; i ++) {
+        ptr[i] = i;
+    }
+
+    ptr = flecs_realloc_n(&a, int32_t, count * 4, count * 2, ptr);
+    test_assert(ptr != NULL);
+    for (i = 0; i < count * 2; i ++) {
+        test_int(ptr[i], i);
+    }
+
+    flecs_free_n(&a, int32_t, count * 4, ptr);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_realloc_large_to_small(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    int32_t i, count = 16;
+    int32_t *ptr = flecs_alloc_n(&a, int32_t, count);
+    for (i = 0; i < count; i ++) {
+        ptr[i] = i;
+    }
+
+    int32_t large = FLECS_BALLOC_LARGE_SIZE / ECS_SIZEOF(int32_t);
+    ptr = flecs_realloc_n(&a, int32_t, large, count, ptr);
+    test_assert(ptr != NULL);
+    for (i = 0; i < count; i ++) {
+        test_int(ptr[i], i);
+    }
+
+    ptr = flecs_realloc_n(&a, int32_t, count, large, ptr);
+    test_assert(ptr != NULL);
+    for (i = 0; i < count; i ++) {
+        test_int(ptr[i], i);
+    }
+
+    flecs_free_n(&a, int32_t, count, ptr);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_realloc_large_aligned(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    /* Large chunk sizes are a multiple of 64, so the chunk must be aligned to
+     * FLECS_BALLOC_MAX_ALIGN, also after it's been resized */
+    ecs_size_t size = FLECS_BALLOC_LARGE_SIZE;
+    int32_t i, j;
+    uint8_t *ptr = flecs_alloc(&a, size);
+    test_assert(((uintptr_t)ptr % FLECS_BALLOC_MAX_ALIGN) == 0);
+    ecs_os_memset(ptr, 1, size);
+
+    for (i = 2; i < 8; i ++) {
+        ptr = flecs_realloc(&a, size * i, size * (i - 1), ptr);
+        test_assert(((uintptr_t)ptr % FLECS_BALLOC_MAX_ALIGN) == 0);
+        for (j = 0; j < size * (i - 1); j ++) {
+            test_int(ptr[j], 1);
+        }
+        ecs_os_memset(ptr, 1, size * i);
+    }
+
+    flecs_free(&a, size * 7, ptr);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_alloc_pages(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    ecs_size_t size = FLECS_BALLOC_PAGE_ALLOC_SIZE;
+    ecs_block_allocator_t *ba = flecs_allocator_get(&a, size);
+    uint8_t *ptr = flecs_balloc(ba);
+    test_assert(ptr != NULL);
+    test_assert(((uintptr_t)ptr % FLECS_BALLOC_MAX_ALIGN) == 0);
+    ecs_os_memset(ptr, 1, size);
+
+    if (ecs_os_has_page_alloc()) {
+        test_int(ba->page_count, 1);
+        test_assert(ba->huge_page_advised_count <= 1);
+        test_int(flecs_allocator_page_bytes(&a, false), size);
+    } else {
+        test_int(ba->page_count, 0);
+        test_int(flecs_allocator_page_bytes(&a, false), 0);
+    }
+
+    flecs_bfree(ba, ptr);
+    test_int(ba->page_count, 0);
+    test_int(ba->huge_page_advised_count, 0);
+    test_int(flecs_allocator_page_bytes(&a, false), 0);
+    test_int(flecs_allocator_page_bytes(&a, true), 0);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_realloc_pages(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    ecs_size_t size = FLECS_BALLOC_PAGE_ALLOC_SIZE;
+    int32_t i, count = size / ECS_SIZEOF(int32_t);
+    int32_t *ptr = flecs_alloc(&a, size);
+    for (i = 0; i < count; i ++) {
+        ptr[i] = i;
+    }
+
+    ptr = flecs_realloc(&a, size * 2, size, ptr);
+    test_assert(ptr != NULL);
+    test_assert(((uintptr_t)ptr % FLECS_BALLOC_MAX_ALIGN) == 0);
+    for (i = 0; i < count; i ++) {
+        test_int(ptr[i], i);
+    }
+
+    if (ecs_os_has_page_alloc()) {
+        test_int(flecs_allocator_get(&a, size)->page_count, 0);
+        test_int(flecs_allocator_get(&a, size * 2)->page_count, 1);
+        test_int(flecs_allocator_page_bytes(&a, false), size * 2);
+    }
+
+    flecs_free(&a, size * 2, ptr);
+    test_int(flecs_allocator_page_bytes(&a, false), 0);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_realloc_pages_to_large(void) {
+    ecs_allocator_t a;
+    flecs_allocator_init(&a);
+
+    ecs_size_t size = FLECS_BALLOC_LARGE_SIZE;
+    ecs_size_t page_size = FLECS_BALLOC_PAGE_ALLOC_SIZE;
+    int32_t i, count = size / ECS_SIZEOF(int32_t);
+    int32_t *ptr = flecs_alloc(&a, size);
+    for (i = 0; i < count; i ++) {
+        ptr[i] = i;
+    }
+
+    ptr = flecs_realloc(&a, page_size, size, ptr);
+    test_assert(ptr != NULL);
+    for (i = 0; i < count; i ++) {
+        test_int(ptr[i], i);
+    }
+
+    ptr = flecs_realloc(&a, size, page_size, ptr);
+    test_assert(ptr != NULL);
+    for (i = 0; i < count; i ++) {
+        test_int(ptr[i], i);
+    }
+    test_int(flecs_allocator_page_bytes(&a, false), 0);
+
+    flecs_free(&a, size, ptr);
+
+    flecs_allocator_fini(&a);
+}
+
+void Allocator_depot_reuse(void) {
+    ecs_block_allocator_depot_t *depot = flecs_ballocator_depot_new();
+
+    ecs_block_allocator_t a, b;
+    flecs_ballocator_init_t(&a, uint64_t);
+    flecs_ballocator_init_t(&b, uint64_t);
+    a.depot = depot;
+    b.depot = depot;
+
+    int32_t i, count = a.chunks_per_block * 4;
+    void **ptrs = ecs_os_malloc_n(void*, count);
+    for (i = 0; i < count; i ++) {
+        ptrs[i] = flecs_balloc(&a);
+    }
+    for (i = 0; i < count; i ++) {
+        flecs_bfree(&a, ptrs[i]);
+    }
+
+    /* Surplus chunks freed by a are returned to the depot */
+    test_assert(a.free_count < (a.chunks_per_block * 2));
+
+    /* b takes chunks from the depot instead of allocating new blocks */
+    int64_t block_count = ecs_block_allocator_alloc_count;
+    for (i = 0; i < a.chunks_per_block; i ++) {
+        ptrs[i] = flecs_balloc(&b);
+        test_assert(ptrs[i] != NULL);
+    }
+    test_assert(ecs_block_allocator_alloc_count == block_count);
+    test_assert(b.block_head == NULL);
+
+    for (i = 0; i < a.chunks_per_block; i ++) {
+        flecs_bfree(&b, ptrs[i]);
+    }
+
+    ecs_os_free(ptrs);
+    flecs_ballocator_fini(&a);
+    flecs_ballocator_fini(&b);
+    flecs_ballocator_depot_free(depot);
+}
+
+void Allocator_depot_fini(void) {
+    ecs_block_allocator_depot_t *depot = flecs_ballocator_depot_new();
+
+    ecs_block_allocator_t a, b;
+    flecs_ballocator_init_t(&a, uint64_t);
+    flecs_ballocator_init_t(&b, uint64_t);
+    a.depot = depot;
+    b.depot = depot;
+
+    int32_t i, count = a.chunks_per_block * 4;
+    uint64_t **ptrs = ecs_os_malloc_n(uint64_t*, count);
+    for (i = 0; i < count; i ++) {
+        ptrs[i] = flecs_balloc(&a);
+    }
+    for (i = 0; i < count; i ++) {
+        flecs_bfree(&a, ptrs[i]);
+    }
+
+    /* b holds chunks from blocks of a */
+    for (i = 0; i < count; i ++) {
+        ptrs[i] = flecs_balloc(&b);
+        *ptrs[i] = (uint64_t)i;
+    }
+
+    /* Blocks of a are moved to the depot, so chunks held by b remain valid */
+    int64_t free_count = ecs_block_allocator_free_count;
+    flecs_ballocator_fini(&a);
+    test_assert(ecs_block_allocator_free_count == free_count);
+
+    for (i = 0; i < count; i ++) {
+        test_int(*ptrs[i], i);
+        flecs_bfree(&b, ptrs[i]);
+    }
+
+    ecs_os_free(ptrs);
+    flecs_ballocator_fini(&b);
+    flecs_ballocator_depot_free(depot);
+    test_assert(ecs_block_allocator_free_count > free_count);
+}
+
+void Allocator_depot_trim(void) {
+    ecs_block_allocator_depot_t *depot = flecs_ballocator_depot_new();
+
+    ecs_block_allocator_t a;
+    flecs_ballocator_init_t(&a, uint64_t);
+    a.depot = depot;
+
+    int32_t i, count = a.chunks_per_block * 4;
+    void **ptrs = ecs_os_malloc_n(void*, count);
+    for (i = 0; i < count; i ++) {
+        ptrs[i] = flecs_balloc(&a);
+    }
+    for (i = 0; i < count; i ++) {
+        flecs_bfree(&a, ptrs[i]);
+    }
+
+    int64_t free_count = ecs_block_allocator_free_count;
+    flecs_ballocator_fini(&a);
+    test_assert(ecs_block_allocator_free_count == free_count);
+
+    /* All chunks of a are in the depot, so its blocks can be freed. Blocks
+     * that are allocated during the trim are also freed during the trim. */
+    int64_t alloc_count = ecs_block_allocator_alloc_count;
+    flecs_ballocator_depot_trim(depot);
+    test_int(ecs_block_allocator_free_count - free_count, 
+        (ecs_block_allocator_alloc_count - alloc_count) + 4);
+
+    /* Freed chunks are no longer handed out by the depot */
+    ecs_block_allocator_t b;
+    flecs_ballocator_init_t(&b, uint64_t);
+    b.depot = depot;
+    alloc_count = ecs_block_allocator_alloc_count;
+    void *ptr = flecs_balloc(&b);
+    test_assert(ptr != NULL);
+    test_assert(ecs_block_allocator_alloc_count == (alloc_count + 1));
+    flecs_bfree(&b, ptr);
+
+    ecs_os_free(ptrs);
+    flecs_ballocator_fini(&b);
+    flecs_ballocator_depot_free(depot);
+}
+
+void Allocator_depot_trim_w_chunks_in_use(void) {
+    ecs_block_allocator_depot_t *depot = flecs_ballocator_depot_new();
+
+    ecs_block_allocator_t a, b;
+    flecs_ballocator_init_t(&a, uint64_t);
+    flecs_ballocator_init_t(&b, uint64_t);
+    a.depot = depot;
+    b.depot = depot;
+
+    int32_t i, count = a.chunks_per_block * 4;
+    uint64_t **ptrs = ecs_os_malloc_n(uint64_t*, count);
+    for (i = 0; i < count; i ++) {
+        ptrs[i] = flecs_balloc(&a);
+    }
+    for (i = 0; i < count; i ++) {
+        flecs_bfree(&a, ptrs[i]);
+    }
+
+    /* b holds chunks from blocks of a */
+    for (i = 0; i < a.chunks_per_block; i ++) {
+        ptrs[i] = flecs_balloc(&b);
+        *ptrs[i] = (uint64_t)i;
+    }
+    test_assert(b.block_head == NULL);
+
+    int64_t free_count = ecs_block_allocator_free_count;
+    flecs_ballocator_fini(&a);
+
+    /* Blocks with chunks that are in use by b are kept */
+    int64_t alloc_count = ecs_block_allocator_alloc_count;
+    flecs_ballocator_depot_trim(depot);
+    int64_t freed = (ecs_block_allocator_free_count - free_count) - 
+        (ecs_block_allocator_alloc_count - alloc_count);
+    test_assert(freed > 0);
+    test_assert(freed < 4);
+
+    for (i = 0; i < a.chunks_per_block; i ++) {
+        test_int(*ptrs[i], i);
+        flecs_bfree(&b, ptrs[i]);
+    }
+
+    /* Remaining chunks of b can be allocated again after the trim */
+    for (i = 0; i < count; i ++) {
+        ptrs[i] = flecs_balloc(&b);
+        *ptrs[i] = (uint64_t)i;
+    }
+    for (i = 0; i < count; i ++) {
+        test_int(*ptrs[i], i);
+        flecs_bfree(&b, ptrs[i]);
+    }
+
+    ecs_os_free(ptrs);
+    flecs_ballocator_fini(&b);
+    flecs_ballocator_depot_trim(depot);
+    flecs_ballocator_depot_free(depot);
+}
+
+void Allocator_os_page_realloc_keeps_alignment(void) {
+    if (!ecs_os_has_page_alloc()) {
+        return;
+    }
+
+    /* The default OS API aligns mappings to the size of a huge page */
+    ecs_size_t huge_size = 2 * 1024 * 1024;
+    bool huge = false;
+    int32_t i, j, count = 8;
+    void *others[8];
+
+    ecs_size_t size = huge_size;
+    uint8_t *ptr = ecs_os_page_alloc(size, &huge);
+    test_assert(ptr != NULL);
+    test_assert(((uintptr_t)ptr % (uintptr_t)huge_size) == 0);
+    ecs_os_memset(ptr, 1, size);
+
+    for (i = 0; i < count; i ++) {
+        /* Allocate other mappings so that growing can't always happen in
+         * place, and the mapping has to move */
+        others[i] = ecs_os_page_alloc(huge_size, &huge);
+        test_assert(others[i] != NULL);
+
+        ptr = ecs_os_page_realloc(ptr, size, size + huge_size, &huge);
+        test_assert(ptr != NULL);
+        test_assert(((uintptr_t)ptr % (uintptr_t)huge_size) == 0);
+        for (j = 0; j < size; j ++) {
+            test_int(ptr[j], 1);
+        }
+
+        size += huge_size;
+        ecs_os_memset(ptr, 1, size);
+    }
+
+    ecs_os_page_free(ptr, size);
+    for (i = 0; i < count; i ++) {
+        ecs_os_page_free(others[i], huge_size);
+    }
+}
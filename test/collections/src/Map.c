@@ -497,3 +497,49 @@ void Map_randomized_after_clear(void) {
 
     ecs_os_free(keys);
 }
+
+void Map_remove_while_iterating(void) {
+    uint64_t *keys = generate_random_keys(100);
+    ecs_map_t map = populate_map(keys, 100);
+
+    int i = 0;
+    ecs_map_iter_t it = ecs_map_iter(&map);
+    while (ecs_map_next(&it)) {
+        ecs_map_key_t key = ecs_map_key(&it);
+        test_assert(key == ecs_map_value(&it));
+        test_assert(ecs_map_remove(&map, key) == key);
+        test_assert(ecs_map_get(&map, key) == NULL);
+        i ++;
+    }
+
+    test_int(i, 100);
+    test_int(ecs_map_count(&map), 0);
+
+    ecs_os_free(keys);
+    ecs_map_fini(&map);
+}
+
+void Map_randomized_remove_insert(void) {
+    uint64_t *keys = generate_random_keys(1000);
+    ecs_map_t map = populate_map(keys, 500);
+
+    /* Replace keys in the map with keys that are not yet in the map */
+    for (int i = 0; i < 5000; i ++) {
+        int out = i % 500 + ((i / 500) % 2) * 500;
+        int in = (out + 500) % 1000;
+        test_assert(ecs_map_remove(&map, keys[out]) == keys[out]);
+        test_assert(ecs_map_get(&map, keys[in]) == NULL);
+        ecs_map_insert(&map, keys[in], keys[in]);
+        test_int(ecs_map_count(&map), 500);
+    }
+
+    for (int i = 0; i < 500; i ++) {
+        uint64_t *v = ecs_map_get(&map, keys[i]);
+        test_assert(v != NULL);
+        test_assert(v[0] == keys[i]);
+        test_assert(ecs_map_get(&map, keys[i + 500]) == NULL);
+    }
+
+    ecs_os_free(keys);
+    ecs_map_fini(&map);
+}
@@ -39,6 +39,8 @@ void Map_randomized_remove(void);
 void Map_randomized_insert_large(void);
 void Map_randomized_remove_large(void);
 void Map_randomized_after_clear(void);
+void Map_remove_while_iterating(void);
+void Map_randomized_remove_insert(void);
 
 // Testsuite 'Sparse'
 void Sparse_setup(void);
@@ -90,6 +92,22 @@ void Strbuf_append_inf(void);
 void Strbuf_append_nan_delim(void);
 void Strbuf_append_inf_delim(void);
 
+// Testsuite 'Allocator'
+void Allocator_setup(void);
+void Allocator_alloc_small(void);
+void Allocator_alloc_large(void);
+void Allocator_realloc_large(void);
+void Allocator_realloc_large_to_small(void);
+void Allocator_realloc_large_aligned(void);
+void Allocator_alloc_pages(void);
+void Allocator_realloc_pages(void);
+void Allocator_realloc_pages_to_large(void);
+void Allocator_depot_reuse(void);
+void Allocator_depot_fini(void);
+void Allocator_os_page_realloc_keeps_alignment(void);
+void Allocator_depot_trim(void);
+void Allocator_depot_trim_w_chunks_in_use(void);
+
 bake_test_case Map_testcases[] = {
     {
         "count",
@@ -206,6 +224,14 @@ bake_test_case Map_testcases[] = {
     {
         "randomized_after_clear",
         Map_randomized_after_clear
+    },
+    {
+        "remove_while_iterating",
+        Map_remove_while_iterating
+    },
+    {
+        "randomized_remove_insert",
+        Map_randomized_remove_insert
     }
 };
 
@@ -391,12 +417,67 @@ bake_test_case Strbuf_testcases[] = {
     }
 };
 
+bake_test_case Allocator_testcases[] = {
+    {
+        "alloc_small",
+        Allocator_alloc_small
+    },
+    {
+        "alloc_large",
+        Allocator_alloc_large
+    },
+    {
+        "realloc_large",
+        Allocator_realloc_large
+    },
+    {
+        "realloc_large_to_small",
+        Allocator_realloc_large_to_small
+    },
+    {
+        "realloc_large_aligned",
+        Allocator_realloc_large_aligned
+    },
+    {
+        "alloc_pages",
+        Allocator_alloc_pages
+    },
+    {
+        "realloc_pages",
+        Allocator_realloc_pages
+    },
+    {
+        "realloc_pages_to_large",
+        Allocator_realloc_pages_to_large
+    },
+    {
+        "depot_reuse",
+        Allocator_depot_reuse
+    },
+    {
+        "depot_fini",
+        Allocator_depot_fini
+    },
+    {
+        "os_page_realloc_keeps_alignment",
+        Allocator_os_page_realloc_keeps_alignment
+    },
+    {
+        "depot_trim",
+        Allocator_depot_trim
+    },
+    {
+        "depot_trim_w_chunks_in_use",
+        Allocator_depot_trim_w_chunks_in_use
+    }
+};
+
 static bake_test_suite suites[] = {
     {
         "Map",
         Map_setup,
         NULL,
-        29,
+        31,
         Map_testcases
     },
     {
@@ -412,9 +493,16 @@ static bake_test_suite suites[] = {
         NULL,
         23,
         Strbuf_testcases
+    },
+    {
+        "Allocator",
+        Allocator_setup,
+        NULL,
+        13,
+        Allocator_testcases
     }
 };
 
 int main(int argc, char *argv[]) {
-    return bake_test_run("collections", argc, argv, suites, 3);
+    return bake_test_run("collections", argc, argv, suites, 4);
 }
@@ -1355,3 +1355,77 @@ void Meta_struct_member_ptr_packed_struct(void) {
         test_uint(cm->offset, offsetof(PackedStruct, c));
     }
 }
+
+void Meta_field_member(void) {
+    flecs::world ecs;
+
+    struct Point {
+        float x;
+        float y;
+    };
+
+    ecs.component<Point>()
+        .member<float>("x")
+        .member<float>("y");
+
+    ecs.entity().set<Point>({10, 20});
+    ecs.entity().set<Point>({30, 40});
+
+    flecs::member_ref_t y_ref = ecs.member_ref<Point>("y");
+    test_int(y_ref.offset, offsetof(Point, y));
+
+    auto f = ecs.filter<Point>();
+
+    int32_t count = 0;
+    f.iter([&](flecs::iter& it) {
+        auto y = it.field_member<float>(1, y_ref);
+        test_int(y.count(), 2);
+        test_flt(y[0], 20);
+        test_flt(y[1], 40);
+        for (auto i : it) {
+            y[i] += 1;
+            count ++;
+        }
+    });
+    test_int(count, 2);
+
+    f.each([](const Point& p) {
+        test_assert(p.y == 21 || p.y == 41);
+    });
+}
+
+void Meta_field_member_nested(void) {
+    flecs::world ecs;
+
+    struct Point {
+        float x;
+        float y;
+    };
+
+    struct Line {
+        Point start;
+        Point stop;
+    };
+
+    ecs.component<Point>()
+        .member<float>("x")
+        .member<float>("y");
+
+    ecs.component<Line>()
+        .member<Point>("start")
+        .member<Point>("stop");
+
+    ecs.entity().set<Line>({{1, 2}, {3, 4}});
+
+    flecs::member_ref_t x_ref = ecs.member_ref<Line>("stop.x");
+    test_int(x_ref.offset, offsetof(Line, stop.x));
+
+    int32_t count = 0;
+    ecs.filter<const Line>().iter([&](flecs::iter& it) {
+        auto x = it.field_member<const float>(1, x_ref);
+        test_int(x.count(), 1);
+        test_flt(x[0], 3);
+        count ++;
+    });
+    test_int(count, 1);
+}
@@ -2332,3 +2332,56 @@ void Query_find_w_entity(void) {
 
     test_assert(r == e2);
 }
+
+void Query_par_each(void) {
+    flecs::world ecs;
+
+    ecs.set_threads(4);
+
+    flecs::entity tag = ecs.entity();
+    for (int i = 0; i < 100; i ++) {
+        flecs::entity e = ecs.entity().set<Position>({0, 0});
+        if (i % 2) {
+            e.add(tag);
+        }
+    }
+
+    auto q = ecs.query<Position>();
+
+    int32_t count = 0;
+    q.par_each([&](flecs::entity e, Position& p) {
+        test_assert(e.has<Position>());
+        p.x ++;
+        ecs_os_ainc(&count);
+    }, 7);
+
+    test_int(count, 100);
+
+    q.each([](Position& p) {
+        test_int(p.x, 1);
+    });
+}
+
+void Query_par_each_w_commands(void) {
+    flecs::world ecs;
+
+    ecs.component<Velocity>();
+    ecs.set_threads(2);
+
+    for (int i = 0; i < 10; i ++) {
+        ecs.entity().set<Position>({0, 0});
+    }
+
+    auto q = ecs.query<Position>();
+
+    q.par_each([](flecs::iter& it, size_t i, Position&) {
+        it.entity(i).mut(it).add<Velocity>();
+    });
+
+    int32_t count = 0;
+    ecs.each([&](flecs::entity, Position&, Velocity&) {
+        count ++;
+    });
+
+    test_int(count, 10);
+}
@@ -2034,3 +2034,28 @@ void QueryBuilder_iter_w_stage(void) {
 
     test_int(count, 1);
 }
+
+void QueryBuilder_prefetch(void) {
+    flecs::world ecs;
+
+    auto e1 = ecs.entity().set<Position>({10, 20});
+    auto e2 = ecs.entity().set<Position>({30, 40}).add<Velocity>();
+
+    auto q = ecs.query_builder<Position>()
+        .prefetch()
+        .build();
+
+    int32_t count = 0;
+    q.each([&](flecs::entity e, Position& p) {
+        if (count == 0) {
+            test_assert(e == e1);
+            test_int(p.x, 10);
+        } else {
+            test_assert(e == e2);
+            test_int(p.x, 30);
+        }
+        count ++;
+    });
+
+    test_int(count, 2);
+}
@@ -867,3 +867,71 @@ void RuleBuilder_find_w_entity(void) {
 
     q.destruct();
 }
+
+void RuleBuilder_cached(void) {
+    flecs::world ecs;
+
+    auto e1 = ecs.entity().set<Position>({10, 20});
+    ecs.entity().set<Position>({20, 30}).add<Velocity>();
+
+    auto q = ecs.rule_builder<Position>()
+        .without<Velocity>()
+        .cached()
+        .build();
+
+    const flecs::filter_t *f = ecs_rule_get_filter(q);
+    test_assert(f->flags & EcsFilterCached);
+
+    int32_t count = 0;
+    q.each([&](flecs::entity e, Position& p) {
+        test_assert(e == e1);
+        test_int(p.x, 10);
+        test_int(p.y, 20);
+        count ++;
+    });
+    test_int(count, 1);
+
+    auto e3 = ecs.entity().set<Position>({30, 40});
+
+    count = 0;
+    q.each([&](flecs::entity e, Position& p) {
+        test_assert(e == e1 || e == e3);
+        count ++;
+    });
+    test_int(count, 2);
+
+    q.destruct();
+}
+
+void RuleBuilder_par_each(void) {
+    flecs::world ecs;
+
+    ecs.set_threads(4);
+
+    for (int i = 0; i < 100; i ++) {
+        flecs::entity e = ecs.entity().set<Position>({0, 0});
+        e.add(ecs.entity());
+        if (i % 2) {
+            e.add<Velocity>();
+        }
+    }
+
+    auto r = ecs.rule_builder<Position>()
+        .with<Velocity>()
+        .build();
+
+    int32_t count = 0;
+    r.par_each([&](flecs::entity e, Position& p) {
+        test_assert(e.has<Velocity>());
+        p.x ++;
+        ecs_os_ainc(&count);
+    });
+
+    test_int(count, 50);
+
+    r.each([](Position& p) {
+        test_int(p.x, 1);
+    });
+
+    r.destruct();
+}
@@ -574,6 +574,8 @@ void Query_iter_get_pair_w_id(void);
 void Query_find(void);
 void Query_find_not_found(void);
 void Query_find_w_entity(void);
+void Query_par_each(void);
+void Query_par_each_w_commands(void);
 
 // Testsuite 'QueryBuilder'
 void QueryBuilder_builder_assign_same_type(void);
@@ -644,6 +646,7 @@ void QueryBuilder_named_query(void);
 void QueryBuilder_term_w_write(void);
 void QueryBuilder_term_w_read(void);
 void QueryBuilder_iter_w_stage(void);
+void QueryBuilder_prefetch(void);
 
 // Testsuite 'FilterBuilder'
 void FilterBuilder_builder_assign_same_type(void);
@@ -789,6 +792,8 @@ void RuleBuilder_inspect_terms_w_expr(void);
 void RuleBuilder_find(void);
 void RuleBuilder_find_not_found(void);
 void RuleBuilder_find_w_entity(void);
+void RuleBuilder_cached(void);
+void RuleBuilder_par_each(void);
 
 // Testsuite 'SystemBuilder'
 void SystemBuilder_builder_assign_same_type(void);
@@ -1265,6 +1270,8 @@ void Meta_warning_range(void);
 void Meta_error_range(void);
 void Meta_struct_member_ptr(void);
 void Meta_struct_member_ptr_packed_struct(void);
+void Meta_field_member(void);
+void Meta_field_member_nested(void);
 
 // Testsuite 'Table'
 void Table_each(void);
@@ -3522,6 +3529,14 @@ bake_test_case Query_testcases[] = {
     {
         "find_w_entity",
         Query_find_w_entity
+    },
+    {
+        "par_each",
+        Query_par_each
+    },
+    {
+        "par_each_w_commands",
+        Query_par_each_w_commands
     }
 };
 
@@ -3797,6 +3812,10 @@ bake_test_case QueryBuilder_testcases[] = {
     {
         "iter_w_stage",
         QueryBuilder_iter_w_stage
+    },
+    {
+        "prefetch",
+        QueryBuilder_prefetch
     }
 };
 
@@ -4367,6 +4386,14 @@ bake_test_case RuleBuilder_testcases[] = {
     {
         "find_w_entity",
         RuleBuilder_find_w_entity
+    },
+    {
+        "cached",
+        RuleBuilder_cached
+    },
+    {
+        "par_each",
+        RuleBuilder_par_each
     }
 };
 
@@ -6202,6 +6229,14 @@ bake_test_case Meta_testcases[] = {
     {
         "struct_member_ptr_packed_struct",
         Meta_struct_member_ptr_packed_struct
+    },
+    {
+        "field_member",
+        Meta_field_member
+    },
+    {
+        "field_member_nested",
+        Meta_field_member_nested
     }
 };
 
@@ -6427,14 +6462,14 @@ static bake_test_suite suites[] = {
         "Query",
         NULL,
         NULL,
-        84,
+        86,
         Query_testcases
     },
     {
         "QueryBuilder",
         NULL,
         NULL,
-        68,
+        69,
         QueryBuilder_testcases
     },
     {
@@ -6448,7 +6483,7 @@ static bake_test_suite suites[] = {
         "RuleBuilder",
         NULL,
         NULL,
-        33,
+        35,
         RuleBuilder_testcases
     },
     {
@@ -6539,7 +6574,7 @@ static bake_test_suite suites[] = {
         "Meta",
         NULL,
         NULL,
-        54,
+        56,
         Meta_testcases
     },
     {
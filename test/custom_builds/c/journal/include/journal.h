@@ -0,0 +1,16 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+/* This generated file contains includes for project dependencies */
+#include "journal/bake_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,59 @@
+#include <journal.h>
+#include <string.h>
+
+typedef struct {
+    int32_t x, y;
+} Position;
+
+static int32_t add_count = 0;
+
+static
+void journal_log(
+    int32_t level, 
+    const char *file, 
+    int32_t line, 
+    const char *msg)
+{
+    (void)level;
+    (void)file;
+    (void)line;
+
+    if (strstr(msg, "// add(") && strstr(msg, ", Tag)")) {
+        add_count ++;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ecs_world_t *world = ecs_init_w_args(argc, argv);
+
+    ECS_COMPONENT(world, Position);
+    ECS_TAG(world, Tag);
+
+    ecs_entity_t entities[4];
+    for (int i = 0; i < 4; i ++) {
+        entities[i] = ecs_set(world, 0, Position, {i, i});
+    }
+
+    ecs_os_api.log_ = journal_log;
+    ecs_log_enable_colors(false);
+    ecs_log_set_level(FLECS_JOURNAL_LOG_LEVEL);
+
+    /* Moves entire table */
+    ecs_add_id_n(world, entities, 4, Tag);
+    assert(add_count == 4);
+
+    ecs_remove_id_n(world, entities, 4, Tag);
+
+    /* Moves entities one by one */
+    add_count = 0;
+    ecs_add_id_n(world, &entities[1], 2, Tag);
+    assert(add_count == 2);
+
+    ecs_log_set_level(-1);
+
+    assert(ecs_has(world, entities[1], Tag));
+    assert(ecs_has(world, entities[2], Tag));
+    assert(!ecs_has(world, entities[3], Tag));
+
+    return ecs_fini(world);
+}
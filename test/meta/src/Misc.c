@@ -684,3 +684,199 @@ void Misc_quantity_from_suspend_defer(void) {
 
     ecs_fini(world);
 }
+
+typedef struct {
+    float x;
+    float y;
+} Misc_Position;
+
+typedef struct {
+    int32_t id;
+    Misc_Position pos;
+} Misc_Agent;
+
+void Misc_field_member(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t t = ecs_struct(world, {
+        .members = {
+            {"x", ecs_id(ecs_f32_t)},
+            {"y", ecs_id(ecs_f32_t)}
+        }
+    });
+    test_assert(t != 0);
+
+    ecs_entity_t e1 = ecs_new_id(world);
+    ecs_entity_t e2 = ecs_new_id(world);
+    ecs_set_id(world, e1, t, sizeof(Misc_Position), &(Misc_Position){10, 20});
+    ecs_set_id(world, e2, t, sizeof(Misc_Position), &(Misc_Position){30, 40});
+
+    ecs_member_ref_t y_ref = ecs_meta_member_ref(world, t, "y");
+    test_uint(y_ref.type, t);
+    test_uint(y_ref.member_type, ecs_id(ecs_f32_t));
+    test_int(y_ref.offset, offsetof(Misc_Position, y));
+    test_int(y_ref.size, ECS_SIZEOF(float));
+
+    ecs_filter_t *f = ecs_filter(world, { .terms = {{ t }} });
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    test_bool(true, ecs_filter_next(&it));
+    test_int(it.count, 2);
+
+    float *y = ecs_field_member(&it, float, 1, &y_ref);
+    test_assert(y != NULL);
+    ecs_size_t stride = ecs_field_size(&it, 1);
+    test_int(stride, ECS_SIZEOF(Misc_Position));
+    test_flt(*(float*)ECS_ELEM(y, stride, 0), 20);
+    test_flt(*(float*)ECS_ELEM(y, stride, 1), 40);
+
+    *(float*)ECS_ELEM(y, stride, 1) = 50;
+    test_bool(false, ecs_filter_next(&it));
+
+    const Misc_Position *p = ecs_get_id(world, e2, t);
+    test_flt(p->x, 30);
+    test_flt(p->y, 50);
+
+    ecs_filter_fini(f);
+    ecs_fini(world);
+}
+
+void Misc_field_member_nested(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t pos = ecs_struct(world, {
+        .members = {
+            {"x", ecs_id(ecs_f32_t)},
+            {"y", ecs_id(ecs_f32_t)}
+        }
+    });
+
+    ecs_entity_t t = ecs_struct(world, {
+        .members = {
+            {"id", ecs_id(ecs_i32_t)},
+            {"pos", pos}
+        }
+    });
+    test_assert(t != 0);
+
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set_id(world, e, t, sizeof(Misc_Agent), 
+        &(Misc_Agent){1, {10, 20}});
+
+    ecs_member_ref_t x_ref = ecs_meta_member_ref(world, t, "pos.x");
+    ecs_member_ref_t y_ref = ecs_meta_member_ref(world, t, "pos.y");
+    ecs_member_ref_t id_ref = ecs_meta_member_ref(world, t, "id");
+    test_int(x_ref.offset, offsetof(Misc_Agent, pos.x));
+    test_int(y_ref.offset, offsetof(Misc_Agent, pos.y));
+    test_int(id_ref.offset, offsetof(Misc_Agent, id));
+
+    ecs_log_set_level(-4);
+    ecs_member_ref_t z_ref = ecs_meta_member_ref(world, t, "pos.z");
+    test_uint(z_ref.member_type, 0);
+
+    ecs_filter_t *f = ecs_filter(world, { .terms = {{ t }} });
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    test_bool(true, ecs_filter_next(&it));
+    test_int(it.count, 1);
+
+    float *x = ecs_field_member(&it, float, 1, &x_ref);
+    test_assert(x != NULL);
+    test_flt(*x, 10);
+    float *y = ecs_field_member(&it, float, 1, &y_ref);
+    test_assert(y != NULL);
+    test_flt(*y, 20);
+    int32_t *id = ecs_field_member(&it, int32_t, 1, &id_ref);
+    test_assert(id != NULL);
+    test_int(*id, 1);
+    test_bool(false, ecs_filter_next(&it));
+
+    ecs_filter_fini(f);
+    ecs_fini(world);
+}
+
+void Misc_field_member_size_mismatch(void) {
+    install_test_abort();
+
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t t = ecs_struct(world, {
+        .members = {
+            {"x", ecs_id(ecs_f32_t)},
+            {"y", ecs_id(ecs_f32_t)}
+        }
+    });
+
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set_id(world, e, t, sizeof(Misc_Position), &(Misc_Position){10, 20});
+
+    ecs_member_ref_t x_ref = ecs_meta_member_ref(world, t, "x");
+
+    ecs_filter_t *f = ecs_filter(world, { .terms = {{ t }} });
+    ecs_iter_t it = ecs_filter_iter(world, f);
+    test_bool(true, ecs_filter_next(&it));
+
+    test_expect_abort();
+    ecs_field_member(&it, double, 1, &x_ref);
+}
+
+static void IncY(ecs_iter_t *it) {
+    ecs_member_ref_t *y_ref = it->ctx;
+    float *y = ecs_field_member(it, float, 1, y_ref);
+    ecs_size_t stride = ecs_field_size(it, 1);
+    for (int i = 0; i < it->count; i ++) {
+        *(float*)ECS_ELEM(y, stride, i) += 1;
+    }
+}
+
+void Misc_field_member_from_system(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t t = ecs_struct(world, {
+        .members = {
+            {"x", ecs_id(ecs_f32_t)},
+            {"y", ecs_id(ecs_f32_t)}
+        }
+    });
+
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set_id(world, e, t, sizeof(Misc_Position), &(Misc_Position){10, 20});
+
+    /* Resolve member once, when the system is created */
+    ecs_member_ref_t y_ref = ecs_meta_member_ref(world, t, "y");
+    ecs_system(world, {
+        .entity = ecs_entity(world, { .add = { ecs_dependson(EcsOnUpdate) }}),
+        .query.filter.terms = {{ t }},
+        .callback = IncY,
+        .ctx = &y_ref
+    });
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+
+    const Misc_Position *p = ecs_get_id(world, e, t);
+    test_flt(p->x, 10);
+    test_flt(p->y, 22);
+
+    ecs_fini(world);
+}
+
+void Misc_field_member_non_struct(void) {
+    ecs_world_t *world = ecs_init();
+
+    ecs_entity_t t = ecs_struct(world, {
+        .members = {
+            {"x", ecs_id(ecs_f32_t)},
+            {"y", ecs_id(ecs_f32_t)}
+        }
+    });
+    test_assert(t != 0);
+
+    ecs_log_set_level(-4);
+    ecs_member_ref_t ref = ecs_meta_member_ref(world, ecs_id(ecs_f32_t), "x");
+    test_uint(ref.member_type, 0);
+    ref = ecs_meta_member_ref(world, t, "x.y");
+    test_uint(ref.member_type, 0);
+    ref = ecs_meta_member_ref(world, t, "");
+    test_uint(ref.member_type, 0);
+
+    ecs_fini(world);
+}
@@ -1027,6 +1027,11 @@ void Misc_opaque_from_suspend_defer(void);
 void Misc_unit_from_suspend_defer(void);
 void Misc_unit_prefix_from_suspend_defer(void);
 void Misc_quantity_from_suspend_defer(void);
+void Misc_field_member(void);
+void Misc_field_member_nested(void);
+void Misc_field_member_size_mismatch(void);
+void Misc_field_member_from_system(void);
+void Misc_field_member_non_struct(void);
 
 bake_test_case PrimitiveTypes_testcases[] = {
     {
@@ -4995,6 +5000,26 @@ bake_test_case Misc_testcases[] = {
     {
         "quantity_from_suspend_defer",
         Misc_quantity_from_suspend_defer
+    },
+    {
+        "field_member",
+        Misc_field_member
+    },
+    {
+        "field_member_nested",
+        Misc_field_member_nested
+    },
+    {
+        "field_member_size_mismatch",
+        Misc_field_member_size_mismatch
+    },
+    {
+        "field_member_from_system",
+        Misc_field_member_from_system
+    },
+    {
+        "field_member_non_struct",
+        Misc_field_member_non_struct
     }
 };
 
@@ -5150,7 +5175,7 @@ static bake_test_suite suites[] = {
         "Misc",
         NULL,
         NULL,
-        40,
+        45,
         Misc_testcases
     }
 };